@@ -0,0 +1,23 @@
+# VRBSharedOutput.cmake - Shared-memory binaural output bus
+# The engine publishes into it; other local processes link the same library to read it.
+# No logger or engine dependencies, so a sidecar needs nothing else from the tree.
+
+if(NOT TARGET vrb_shared_output)
+    set(VRB_SHARED_OUTPUT_DIR "${CMAKE_CURRENT_LIST_DIR}/../modules/audio")
+
+    add_library(vrb_shared_output STATIC
+        ${VRB_SHARED_OUTPUT_DIR}/shared_output.cpp
+    )
+
+    target_include_directories(vrb_shared_output PUBLIC
+        ${VRB_SHARED_OUTPUT_DIR}
+    )
+
+    target_compile_features(vrb_shared_output PUBLIC cxx_std_17)
+    set_target_properties(vrb_shared_output PROPERTIES POSITION_INDEPENDENT_CODE ON)
+
+    # shm_open lives in librt before glibc 2.34
+    if(UNIX AND NOT APPLE)
+        target_link_libraries(vrb_shared_output PUBLIC rt)
+    endif()
+endif()
@@ -0,0 +1,44 @@
+# VRBSimd.cmake - Runtime-dispatched SIMD kernel library
+# Each kernel file is compiled for exactly one instruction set; simd_dispatch.cpp picks
+# the best table the CPU supports at startup, so no target needs -march=native.
+
+if(NOT TARGET vrb_simd)
+    set(VRB_SIMD_DIR "${CMAKE_CURRENT_LIST_DIR}/../modules/common/simd")
+
+    add_library(vrb_simd STATIC
+        ${VRB_SIMD_DIR}/simd_dispatch.cpp
+        ${VRB_SIMD_DIR}/simd_kernels_scalar.cpp
+        ${VRB_SIMD_DIR}/simd_kernels_sse2.cpp
+        ${VRB_SIMD_DIR}/simd_kernels_avx2.cpp
+        ${VRB_SIMD_DIR}/simd_kernels_avx512.cpp
+    )
+
+    target_include_directories(vrb_simd PUBLIC
+        ${VRB_SIMD_DIR}/..
+        ${VRB_SIMD_DIR}
+    )
+
+    target_compile_features(vrb_simd PUBLIC cxx_std_17)
+    set_target_properties(vrb_simd PROPERTIES POSITION_INDEPENDENT_CODE ON)
+
+    if(CMAKE_SYSTEM_PROCESSOR MATCHES "x86_64|AMD64|amd64|i[3-6]86|x86")
+        if(MSVC)
+            set_source_files_properties(${VRB_SIMD_DIR}/simd_kernels_avx2.cpp
+                PROPERTIES COMPILE_OPTIONS "/arch:AVX2")
+            set_source_files_properties(${VRB_SIMD_DIR}/simd_kernels_avx512.cpp
+                PROPERTIES COMPILE_OPTIONS "/arch:AVX512")
+        else()
+            set_source_files_properties(${VRB_SIMD_DIR}/simd_kernels_sse2.cpp
+                PROPERTIES COMPILE_OPTIONS "-msse2")
+            set_source_files_properties(${VRB_SIMD_DIR}/simd_kernels_avx2.cpp
+                PROPERTIES COMPILE_OPTIONS "-mavx2;-mfma")
+            set(VRB_SIMD_AVX512_OPTIONS -mavx512f -mfma)
+            if(CMAKE_CXX_COMPILER_ID STREQUAL "GNU")
+                # GCC's own AVX-512 intrinsic headers trip -Wmaybe-uninitialized (__Y = __Y)
+                list(APPEND VRB_SIMD_AVX512_OPTIONS -Wno-uninitialized -Wno-maybe-uninitialized)
+            endif()
+            set_source_files_properties(${VRB_SIMD_DIR}/simd_kernels_avx512.cpp
+                PROPERTIES COMPILE_OPTIONS "${VRB_SIMD_AVX512_OPTIONS}")
+        endif()
+    endif()
+endif()
@@ -0,0 +1,41 @@
+# VRBSimdLinkageCheck.cmake - Fails when a SIMD kernel object shares a helper with another
+# The helpers in simd_kernels_common.h must stay local to each kernel object: a global or weak
+# copy lets the linker keep one of them for every instruction set, so the scalar and SSE2
+# kernels could run a VEX-encoded helper built for AVX2 or AVX-512.
+#
+# Usage: cmake -DNM=<nm> -DLIBRARY=<libvrb_simd.a> -P VRBSimdLinkageCheck.cmake
+
+if(NOT NM OR NOT LIBRARY)
+    message(FATAL_ERROR "Usage: cmake -DNM=<nm> -DLIBRARY=<vrb_simd archive> -P VRBSimdLinkageCheck.cmake")
+endif()
+
+execute_process(
+    COMMAND ${NM} -A -C ${LIBRARY}
+    OUTPUT_VARIABLE VRB_SIMD_SYMBOLS
+    ERROR_VARIABLE VRB_SIMD_NM_ERROR
+    RESULT_VARIABLE VRB_SIMD_NM_RESULT
+)
+if(NOT VRB_SIMD_NM_RESULT EQUAL 0)
+    message(FATAL_ERROR "${NM} failed on ${LIBRARY}: ${VRB_SIMD_NM_ERROR}")
+endif()
+
+set(VRB_SIMD_HELPERS "fadeStep|roundToInt|loadInt24|storeInt24|nextDither|triangularDither")
+
+# One entry per helper symbol in a kernel object: <object>:<address> <type> vrb::simd::<helper>(
+string(REGEX MATCHALL "simd_kernels_[a-z0-9]+[^:\n]*:[0-9a-fA-F ]* [A-Za-z] vrb::simd::(${VRB_SIMD_HELPERS})\\("
+       VRB_SIMD_HELPER_SYMBOLS "${VRB_SIMD_SYMBOLS}")
+
+set(VRB_SIMD_SHARED "")
+foreach(symbol IN LISTS VRB_SIMD_HELPER_SYMBOLS)
+    # Only a local text symbol ('t') is private to its object; W, T and U all resolve across objects
+    if(NOT symbol MATCHES " t vrb::simd::")
+        string(APPEND VRB_SIMD_SHARED "\n  ${symbol}")
+    endif()
+endforeach()
+
+if(VRB_SIMD_SHARED)
+    message(FATAL_ERROR "SIMD kernel helpers with external linkage (make them static):${VRB_SIMD_SHARED}")
+endif()
+
+list(LENGTH VRB_SIMD_HELPER_SYMBOLS VRB_SIMD_LOCAL_COUNT)
+message(STATUS "SIMD kernel helpers are local to their objects (${VRB_SIMD_LOCAL_COUNT} out-of-line copies)")
@@ -18,7 +18,7 @@ add_compile_definitions(
 # MSVC-specific optimizations
 if(MSVC)
     # Enable all CPU optimizations
-    set(CMAKE_CXX_FLAGS_RELEASE "${CMAKE_CXX_FLAGS_RELEASE} /O2 /Ob2 /Oi /Ot /GL /arch:AVX2")
+    set(CMAKE_CXX_FLAGS_RELEASE "${CMAKE_CXX_FLAGS_RELEASE} /O2 /Ob2 /Oi /Ot /GL")
     set(CMAKE_EXE_LINKER_FLAGS_RELEASE "${CMAKE_EXE_LINKER_FLAGS_RELEASE} /LTCG /OPT:REF /OPT:ICF")
 
     # Enable whole program optimization
@@ -43,7 +43,7 @@ if(MSVC)
 
 elseif(MINGW)
     # MinGW-specific optimizations
-    add_compile_options(-march=native -mtune=native)
+    # No -march=native: SIMD kernels are selected at runtime (cmake/VRBSimd.cmake)
     set(CMAKE_CXX_FLAGS_RELEASE "${CMAKE_CXX_FLAGS_RELEASE} -O3 -flto -ffast-math")
     set(CMAKE_EXE_LINKER_FLAGS_RELEASE "${CMAKE_EXE_LINKER_FLAGS_RELEASE} -flto -s")
 
@@ -59,7 +59,31 @@ public:
         return (ch == "auto") ? 0 : std::stoi(ch);
     }
     int GetOutputChannels() const { return getInt("audio.channels.output", 2); }
+    bool GetOutputDither() const { return getBool("audio.format.dither", true); }  // TPDF dither on 16/24-bit output
     bool GetPriorityBoost() const { return getBool("audio.priorityBoost", true); }
+    std::string GetPipelineMode() const { return getString("audio.pipeline.mode", "inline"); }  // "inline" or "worker"
+    int GetPipelineLookahead() const { return getInt("audio.pipeline.lookaheadBlocks", 2); }
+    int GetDSPWorkerCPU() const { return getInt("audio.pipeline.workerCpu", -1); }  // -1: not pinned
+    bool GetAdaptiveLatency() const { return getBool("audio.pipeline.adaptiveLatency", true); }  // Worker queue follows jitter and xruns
+    int GetProcessingSampleRate() const {  // Rate HRTF runs at; 0 follows audio.sampleRate
+        int rate = getInt("audio.pipeline.sampleRate", 0);
+        return rate > 0 ? rate : GetSampleRate();
+    }
+    std::string GetResamplerQuality() const { return getString("audio.pipeline.resamplerQuality", "balanced"); }  // "fast", "balanced" or "high"
+    std::string GetDeviceCachePath() const { return getString("audio.deviceCachePath", ""); }  // Probed device capabilities; empty: probe at every start
+    std::string GetAudioBackend() const { return getString("audio.backend", "auto"); }  // "auto" (JACK when a server runs), "jack", "portaudio" or "simulated"
+    std::string GetJackClientName() const { return getString("audio.jack.clientName", ""); }  // Empty: audio.virtualOutputName
+    bool GetJackConnectInputs() const { return getBool("audio.jack.connectInputs", true); }  // Physical capture -> in_N
+    bool GetJackConnectOutputs() const { return getBool("audio.jack.connectOutputs", false); }  // binaural_L/R -> physical playback
+    bool GetSharedOutputEnabled() const { return getBool("audio.sharedOutput.enabled", false); }  // Replaces the pactl virtual sink
+    std::string GetSharedOutputName() const { return getString("audio.sharedOutput.name", "/vrb_binaural"); }
+    int GetSharedOutputBufferMs() const { return getInt("audio.sharedOutput.bufferMs", 250); }  // Ring length; rounded up to a power of two
+    std::string GetSimulationClock() const { return getString("audio.simulation.clock", "realtime"); }  // Mock backend: "realtime" or "free" (as fast as it renders)
+    int GetSimulationSeed() const { return getInt("audio.simulation.seed", 1); }  // Same seed, same input and faults
+    float GetSimulationJitterUs() const { return getFloat("audio.simulation.jitterUs", 0.0f); }  // Callbacks arrive up to this late
+    float GetSimulationLateProbability() const { return getFloat("audio.simulation.lateProbability", 0.0f); }
+    float GetSimulationLateUs() const { return getFloat("audio.simulation.lateUs", 0.0f); }  // Extra delay of a late callback
+    float GetSimulationDropProbability() const { return getFloat("audio.simulation.dropProbability", 0.0f); }  // Periods lost outright
 
     // HRTF configuration getters
     std::string GetHRTFDataPath() const { return getString("hrtf.dataPath", "./hrtf_data"); }
@@ -72,7 +96,13 @@ public:
     float GetRolloffFactor() const { return getFloat("hrtf.rolloffFactor", 1.0f); }
     bool GetNearFieldCompensation() const { return getBool("hrtf.nearFieldCompensation", true); }
     bool GetMinimumPhase() const { return getBool("hrtf.minimumPhase", true); }
+    int GetMinimumPhaseTaps() const { return getInt("hrtf.minimumPhaseTaps", 128); }
     int GetFFTSize() const { return getInt("hrtf.fftSize", 1024); }
+    bool GetHRTFInterpolation() const { return getBool("hrtf.interpolation", true); }
+    int GetHRTFFilterCacheSize() const { return getInt("hrtf.filterCacheSize", 256); }
+    int GetHRTFMaxSources() const { return getInt("hrtf.maxSources", 32); }
+    std::string GetHRTFDatasetConfigPath() const { return getString("hrtf.datasetConfigPath", "./config/hrtf_datasets_config.json"); }
+    std::string GetHRTFCachePath() const { return getString("hrtf.cachePath", ""); }  // Empty: always build the dataset
 
     // VR configuration getters
     int GetTrackingRate() const { return getInt("vr.trackingRate", 90); }
@@ -146,10 +176,20 @@ public:
     float GetReverbDamping() const { return getFloat("experimental.reverb.damping", 0.5f); }
     bool GetEnableHandTracking() const { return getBool("experimental.enableHandTracking", false); }
 
+    // Recording configuration getters
+    std::string GetRecordingDirectory() const { return getString("recording.directory", "./recordings"); }
+    std::string GetRecordingFormat() const { return getString("recording.format", "24"); }  // "16", "24", "32" or "float"
+    float GetRecordingBufferSeconds() const { return getFloat("recording.bufferSeconds", 4.0f); }  // Ring ahead of the disk writer
+    int GetRecordingPreallocateMB() const { return getInt("recording.preallocateMB", 256); }  // Reserved ahead of the write position
+    bool GetRecordingDirectIO() const { return getBool("recording.directIO", true); }  // Bypass the page cache where supported
+    float GetRecordingHeaderInterval() const { return getFloat("recording.headerIntervalSeconds", 2.0f); }  // Crash-safe length updates
+    bool GetRecordingCaptureDry() const { return getBool("recording.captureDry", true); }  // Pre-HRTF input as <take>.dry.wav
+    bool GetRecordingCapturePoses() const { return getBool("recording.capturePoses", true); }  // Tracking stream as <take>.vrbpose
+
     // Automation configuration
     bool GetEnableAutomation() const { return getBool("automation.enableAutomation", false); }
     std::string GetRecordPath() const { return getString("automation.recordPath", "./automation"); }
-    std::string GetRecordFormat() const { return getString("automation.recordFormat", "json"); }
+    std::string GetRecordFormat() const { return getString("automation.recordFormat", "binary"); }  // binary, or json for an extra JSON export
     float GetPlaybackSpeed() const { return getFloat("automation.playbackSpeed", 1.0f); }
     bool GetLoopPlayback() const { return getBool("automation.loop", false); }
 
@@ -324,7 +364,28 @@ private:
         m_root["audio"]["wasapiExclusive"] = false;
         m_root["audio"]["channels"]["input"] = "auto";
         m_root["audio"]["channels"]["output"] = 2;
+        m_root["audio"]["format"]["dither"] = true;
         m_root["audio"]["priorityBoost"] = true;
+        m_root["audio"]["pipeline"]["mode"] = "inline";
+        m_root["audio"]["pipeline"]["lookaheadBlocks"] = 2;
+        m_root["audio"]["pipeline"]["workerCpu"] = -1;
+        m_root["audio"]["pipeline"]["adaptiveLatency"] = true;
+        m_root["audio"]["pipeline"]["sampleRate"] = 0;
+        m_root["audio"]["pipeline"]["resamplerQuality"] = "balanced";
+        m_root["audio"]["deviceCachePath"] = "";
+        m_root["audio"]["backend"] = "auto";
+        m_root["audio"]["jack"]["clientName"] = "";
+        m_root["audio"]["jack"]["connectInputs"] = true;
+        m_root["audio"]["jack"]["connectOutputs"] = false;
+        m_root["audio"]["sharedOutput"]["enabled"] = false;
+        m_root["audio"]["sharedOutput"]["name"] = "/vrb_binaural";
+        m_root["audio"]["sharedOutput"]["bufferMs"] = 250;
+        m_root["audio"]["simulation"]["clock"] = "realtime";
+        m_root["audio"]["simulation"]["seed"] = 1;
+        m_root["audio"]["simulation"]["jitterUs"] = 0.0;
+        m_root["audio"]["simulation"]["lateProbability"] = 0.0;
+        m_root["audio"]["simulation"]["lateUs"] = 0.0;
+        m_root["audio"]["simulation"]["dropProbability"] = 0.0;
 
         // HRTF settings - spatial audio magic
         m_root["hrtf"]["dataPath"] = "./hrtf_data";
@@ -337,7 +398,13 @@ private:
         m_root["hrtf"]["rolloffFactor"] = 1.0f;
         m_root["hrtf"]["nearFieldCompensation"] = true;
         m_root["hrtf"]["minimumPhase"] = true;
+        m_root["hrtf"]["minimumPhaseTaps"] = 128;
         m_root["hrtf"]["fftSize"] = 1024;
+        m_root["hrtf"]["interpolation"] = true;
+        m_root["hrtf"]["filterCacheSize"] = 256;
+        m_root["hrtf"]["maxSources"] = 32;
+        m_root["hrtf"]["datasetConfigPath"] = "./config/hrtf_datasets_config.json";
+        m_root["hrtf"]["cachePath"] = "";
 
         // VR settings - ASMRtist-friendly defaults
         m_root["vr"]["trackingRate"] = 90;
@@ -358,6 +425,23 @@ private:
         m_root["performance"]["preallocateBuffers"] = true;
         m_root["performance"]["ringBufferSize"] = 4096;
 
+        // Session recording
+        m_root["recording"]["directory"] = "./recordings";
+        m_root["recording"]["format"] = "24";
+        m_root["recording"]["bufferSeconds"] = 4.0f;
+        m_root["recording"]["preallocateMB"] = 256;
+        m_root["recording"]["directIO"] = true;
+        m_root["recording"]["headerIntervalSeconds"] = 2.0f;
+        m_root["recording"]["captureDry"] = true;
+        m_root["recording"]["capturePoses"] = true;
+
+        // Spatial automation, recorded next to each take and played back from .vrba files
+        m_root["automation"]["enableAutomation"] = false;
+        m_root["automation"]["recordPath"] = "./automation";
+        m_root["automation"]["recordFormat"] = "binary";
+        m_root["automation"]["playbackSpeed"] = 1.0f;
+        m_root["automation"]["loop"] = false;
+
         // Logging for debugging
         m_root["logging"]["level"] = "info";
         m_root["logging"]["path"] = "./logs";
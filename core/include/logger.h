@@ -6,6 +6,7 @@
 #include <spdlog/sinks/stdout_color_sinks.h>
 #include <spdlog/sinks/rotating_file_sink.h>
 #include <spdlog/async.h>
+#include "rt_log.h"
 #include <memory>
 #include <string>
 #include <mutex>
@@ -65,6 +66,14 @@ public:
 
             // Set log level
             s_logger->set_level(StringToLevel(level));
+            rtlog::SetLevel(StringToLevel(level));
+
+            // Drain real-time log records into the same sinks, stamped with their original time
+            rtlog::GetDrainer().Start([logger = s_logger](const rtlog::Site& site,
+                                                          rtlog::Drainer::Clock::time_point time,
+                                                          std::string_view message) {
+                logger->log(time, spdlog::source_loc{site.file, site.line, site.function}, site.level, message);
+            });
 
             // Register as default logger
             spdlog::set_default_logger(s_logger);
@@ -84,6 +93,7 @@ public:
     static void Shutdown() {
         std::lock_guard<std::mutex> lock(s_mutex);
         if (s_logger) {
+            rtlog::GetDrainer().Stop();
             s_logger->flush();
             spdlog::drop_all();
             spdlog::shutdown();
@@ -108,6 +118,7 @@ public:
     static void SetLevel(const std::string& level) {
         if (s_logger) {
             s_logger->set_level(StringToLevel(level));
+            rtlog::SetLevel(StringToLevel(level));
         }
     }
 
@@ -116,6 +127,7 @@ public:
      */
     static void Flush() {
         if (s_logger) {
+            rtlog::GetDrainer().Drain(true);
             s_logger->flush();
         }
     }
@@ -5,7 +5,6 @@
 #include <vector>
 #include <cstring>
 #include <algorithm>
-#include <immintrin.h>  // For SIMD optimizations
 #include <memory>
 
 namespace vrb {
@@ -242,39 +241,14 @@ private:
     }
 
 private:
-    // SIMD-optimized memory operations for float buffers
+    // Plain library copies: libc selects its SSE2/AVX/AVX-512 variant for the running CPU at load time,
+    // so this header needs no instruction-set flags of its own (builds no longer use -march=native)
     static void copyFloatsSIMD(const float* src, float* dst, size_t count) {
-        if constexpr (std::is_same_v<T, float>) {
-            const size_t simdCount = count & ~7;  // Process 8 floats at a time
-
-            for (size_t i = 0; i < simdCount; i += 8) {
-                __m256 data = _mm256_loadu_ps(&src[i]);
-                _mm256_storeu_ps(&dst[i], data);
-            }
-
-            // Handle remaining elements
-            for (size_t i = simdCount; i < count; ++i) {
-                dst[i] = src[i];
-            }
-        } else {
-            std::memcpy(dst, src, count * sizeof(T));
-        }
+        std::memcpy(dst, src, count * sizeof(float));
     }
 
     static void clearFloatsSIMD(float* data, size_t count) {
-        if constexpr (std::is_same_v<T, float>) {
-            const size_t simdCount = count & ~7;
-            const __m256 zero = _mm256_setzero_ps();
-
-            for (size_t i = 0; i < simdCount; i += 8) {
-                _mm256_storeu_ps(&data[i], zero);
-            }
-
-            // Handle remaining elements
-            for (size_t i = simdCount; i < count; ++i) {
-                data[i] = 0.0f;
-            }
-        }
+        std::fill(data, data + count, 0.0f);
     }
 
 private:
@@ -299,28 +273,14 @@ public:
         : RingBuffer<float>(capacity) {}
 
     /**
-     * @brief Write interleaved stereo data with SIMD optimization
+     * @brief Write interleaved stereo data
      */
     size_t writeStereo(const float* left, const float* right, size_t frames) {
         thread_local std::vector<float> interleaved;
         interleaved.resize(frames * 2);
 
-        // SIMD-optimized interleaving
-        const size_t simdFrames = frames & ~7;  // Process 8 frames at a time
-
-        for (size_t i = 0; i < simdFrames; i += 8) {
-            __m256 leftData = _mm256_loadu_ps(&left[i]);
-            __m256 rightData = _mm256_loadu_ps(&right[i]);
-
-            __m256 lo = _mm256_unpacklo_ps(leftData, rightData);
-            __m256 hi = _mm256_unpackhi_ps(leftData, rightData);
-
-            _mm256_storeu_ps(&interleaved[i * 2], _mm256_permute2f128_ps(lo, hi, 0x20));
-            _mm256_storeu_ps(&interleaved[i * 2 + 8], _mm256_permute2f128_ps(lo, hi, 0x31));
-        }
-
-        // Handle remaining frames
-        for (size_t i = simdFrames; i < frames; ++i) {
+        // Plain loop: vectorized for whatever baseline the build targets, no AVX required
+        for (size_t i = 0; i < frames; ++i) {
             interleaved[i * 2] = left[i];
             interleaved[i * 2 + 1] = right[i];
         }
@@ -329,7 +289,7 @@ public:
     }
 
     /**
-     * @brief Read interleaved stereo data with SIMD optimization
+     * @brief Read interleaved stereo data
      */
     size_t readStereo(float* left, float* right, size_t frames) {
         thread_local std::vector<float> interleaved;
@@ -337,25 +297,7 @@ public:
 
         size_t framesRead = read(interleaved.data(), frames * 2) / 2;
 
-        // SIMD-optimized deinterleaving
-        const size_t simdFrames = framesRead & ~7;
-
-        for (size_t i = 0; i < simdFrames; i += 8) {
-            __m256 data1 = _mm256_loadu_ps(&interleaved[i * 2]);
-            __m256 data2 = _mm256_loadu_ps(&interleaved[i * 2 + 8]);
-
-            __m256 leftData = _mm256_shuffle_ps(data1, data2, 0x88);
-            __m256 rightData = _mm256_shuffle_ps(data1, data2, 0xDD);
-
-            leftData = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(leftData), 0xD8));
-            rightData = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(rightData), 0xD8));
-
-            _mm256_storeu_ps(&left[i], leftData);
-            _mm256_storeu_ps(&right[i], rightData);
-        }
-
-        // Handle remaining frames
-        for (size_t i = simdFrames; i < framesRead; ++i) {
+        for (size_t i = 0; i < framesRead; ++i) {
             left[i] = interleaved[i * 2];
             right[i] = interleaved[i * 2 + 1];
         }
@@ -364,58 +306,21 @@ public:
     }
 
     /**
-     * @brief Apply fade in/out to prevent clicks with SIMD optimization
+     * @brief Apply fade in/out to prevent clicks
      */
     void applyFade(float* buffer, size_t frames, bool fadeIn) {
         const size_t fadeLength = std::min(frames, size_t(64));
 
         if (fadeLength == 0) return;
 
-        // Generate fade curve using SIMD
-        alignas(32) float fadeGains[64];
         const float step = 1.0f / fadeLength;
-
-        const size_t simdLength = fadeLength & ~7;
-
-        for (size_t i = 0; i < simdLength; i += 8) {
-            __m256 indices = _mm256_setr_ps(i, i+1, i+2, i+3, i+4, i+5, i+6, i+7);
-            __m256 gains = _mm256_mul_ps(indices, _mm256_set1_ps(step));
-
-            if (!fadeIn) {
-                gains = _mm256_sub_ps(_mm256_set1_ps(1.0f), gains);
-            }
-
-            _mm256_store_ps(&fadeGains[i], gains);
-        }
-
-        // Handle remaining samples
-        for (size_t i = simdLength; i < fadeLength; ++i) {
-            fadeGains[i] = fadeIn ? (float(i) * step) : (1.0f - float(i) * step);
-        }
-
-        // Apply fade with SIMD
-        for (size_t i = 0; i < simdLength; i += 8) {
-            __m256 bufferData = _mm256_loadu_ps(&buffer[i]);
-            __m256 gains = _mm256_load_ps(&fadeGains[i]);
-            __m256 result = _mm256_mul_ps(bufferData, gains);
-            _mm256_storeu_ps(&buffer[i], result);
+        for (size_t i = 0; i < fadeLength; ++i) {
+            const float gain = fadeIn ? (float(i) * step) : (1.0f - float(i) * step);
+            buffer[i] *= gain;
 
             // Apply fade out to end of buffer if needed
             if (!fadeIn && frames > fadeLength) {
-                size_t endIdx = frames - 1 - i;
-                if (endIdx >= 8) {
-                    __m256 endData = _mm256_loadu_ps(&buffer[endIdx - 7]);
-                    __m256 endResult = _mm256_mul_ps(endData, gains);
-                    _mm256_storeu_ps(&buffer[endIdx - 7], endResult);
-                }
-            }
-        }
-
-        // Handle remaining samples
-        for (size_t i = simdLength; i < fadeLength; ++i) {
-            buffer[i] *= fadeGains[i];
-            if (!fadeIn && frames > fadeLength) {
-                buffer[frames - 1 - i] *= fadeGains[i];
+                buffer[frames - 1 - i] *= gain;
             }
         }
     }
@@ -0,0 +1,433 @@
+// rt_log.h - Deferred logging for real-time threads
+// Audio and tracker threads queue raw records; a background thread formats, coalesces and emits them
+#pragma once
+
+#include <spdlog/spdlog.h>
+#include <fmt/args.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+
+namespace vrb {
+namespace rtlog {
+
+constexpr size_t MAX_ARGS = 6;
+constexpr size_t CHANNEL_CAPACITY = 256;       // Records per thread; power of two
+constexpr size_t MAX_CHANNELS = 16;
+constexpr size_t MAX_NAME_LENGTH = 24;
+
+/**
+ * @brief Static description of one RT_LOG_* call site
+ *
+ * Lives in static storage, so a record only carries a pointer to it; the
+ * format string is not touched until the drain thread formats the record.
+ */
+struct Site {
+    spdlog::level::level_enum level;
+    const char* format;
+    const char* file;
+    int line;
+    const char* function;
+};
+
+struct Arg {
+    enum class Type : uint8_t { Int, UInt, Float, Bool };
+    Type type = Type::Int;
+    union {
+        int64_t i;
+        uint64_t u;
+        double f;
+        bool b;
+    };
+    Arg() : i(0) {}
+};
+
+struct Record {
+    const Site* site = nullptr;
+    int64_t timestampNs = 0;                    // system_clock, matches spdlog's clock
+    uint8_t argCount = 0;
+    std::array<Arg, MAX_ARGS> args;
+};
+
+template <typename T>
+constexpr bool IsLoggable = std::is_arithmetic_v<T> || std::is_enum_v<T>;
+
+template <typename T>
+Arg MakeArg(T value) {
+    Arg arg;
+    if constexpr (std::is_same_v<T, bool>) {
+        arg.type = Arg::Type::Bool;
+        arg.b = value;
+    } else if constexpr (std::is_enum_v<T>) {
+        arg.type = Arg::Type::Int;
+        arg.i = static_cast<int64_t>(value);
+    } else if constexpr (std::is_floating_point_v<T>) {
+        arg.type = Arg::Type::Float;
+        arg.f = static_cast<double>(value);
+    } else if constexpr (std::is_signed_v<T>) {
+        arg.type = Arg::Type::Int;
+        arg.i = static_cast<int64_t>(value);
+    } else {
+        arg.type = Arg::Type::UInt;
+        arg.u = static_cast<uint64_t>(value);
+    }
+    return arg;
+}
+
+/**
+ * @brief Single-producer single-consumer ring of records owned by one thread
+ *
+ * A thread claims a free channel once and keeps it until it exits. Push never
+ * blocks: a full ring drops the record and counts it, and the drain thread
+ * reports the loss.
+ */
+class Channel {
+public:
+    bool TryClaim(const char* name) {
+        bool expected = false;
+        if (!m_claimed.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+            return false;
+        }
+        // Published to the consumer by the release store in the first Push
+        const size_t length = std::min(std::strlen(name), MAX_NAME_LENGTH - 1);
+        std::memcpy(m_name.data(), name, length);
+        m_name[length] = '\0';
+        return true;
+    }
+
+    void Release() { m_claimed.store(false, std::memory_order_release); }
+
+    bool Push(const Record& record) {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        if (head - m_tail.load(std::memory_order_acquire) >= CHANNEL_CAPACITY) {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        m_records[head & (CHANNEL_CAPACITY - 1)] = record;
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool Pop(Record& record) {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail == m_head.load(std::memory_order_acquire)) {
+            return false;
+        }
+        record = m_records[tail & (CHANNEL_CAPACITY - 1)];
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    const char* GetName() const { return m_name.data(); }
+    uint64_t GetDropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<bool> m_claimed{false};
+    std::atomic<size_t> m_head{0};
+    std::atomic<size_t> m_tail{0};
+    std::atomic<uint64_t> m_dropped{0};
+    std::array<char, MAX_NAME_LENGTH> m_name{};
+    std::array<Record, CHANNEL_CAPACITY> m_records{};
+};
+
+inline std::array<Channel, MAX_CHANNELS> g_channels;
+inline std::atomic<int> g_level{spdlog::level::info};
+inline std::atomic<uint64_t> g_unclaimedDrops{0};      // Records from threads that found no free channel
+
+// Releases the thread's channel when the thread exits
+struct ThreadChannel {
+    Channel* channel = nullptr;
+    ~ThreadChannel() {
+        if (channel) {
+            channel->Release();
+        }
+    }
+};
+
+inline ThreadChannel& CurrentThreadChannel() {
+    thread_local ThreadChannel handle;
+    return handle;
+}
+
+/**
+ * @brief Claim a channel for the calling thread ahead of its first deadline
+ *
+ * Call once when a real-time thread starts. Logging from an unregistered
+ * thread claims a channel on first use, which also registers the thread-exit
+ * hook and may allocate once, so do it here rather than inside a callback.
+ * @return false when all channels are taken; the thread's records are then dropped
+ */
+inline bool RegisterThread(const char* name) {
+    ThreadChannel& handle = CurrentThreadChannel();
+    if (handle.channel) {
+        return true;
+    }
+    for (auto& channel : g_channels) {
+        if (channel.TryClaim(name)) {
+            handle.channel = &channel;
+            return true;
+        }
+    }
+    return false;
+}
+
+inline bool IsEnabled(spdlog::level::level_enum level) {
+    return static_cast<int>(level) >= g_level.load(std::memory_order_relaxed);
+}
+
+inline void SetLevel(spdlog::level::level_enum level) {
+    g_level.store(static_cast<int>(level), std::memory_order_relaxed);
+}
+
+/**
+ * @brief Queue a record for the drain thread
+ *
+ * Real-time safe once the thread is registered: no locks, no allocation and
+ * no formatting, just a clock read and a copy into the thread's ring.
+ * Arguments must be numbers, bools or enums; strings would need copying.
+ */
+template <typename... Args>
+void Log(const Site& site, Args... args) {
+    static_assert(sizeof...(Args) <= MAX_ARGS, "Too many arguments for a real-time log record");
+    static_assert((IsLoggable<Args> && ...), "Real-time log arguments must be arithmetic or enum values");
+
+    if (!IsEnabled(site.level)) {
+        return;
+    }
+    ThreadChannel& handle = CurrentThreadChannel();
+    if (!handle.channel && !RegisterThread("rt")) {
+        g_unclaimedDrops.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    Record record;
+    record.site = &site;
+    record.timestampNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    record.argCount = static_cast<uint8_t>(sizeof...(Args));
+    size_t index = 0;
+    ((record.args[index++] = MakeArg(args)), ...);
+    (void)index;
+    handle.channel->Push(record);
+}
+
+/**
+ * @brief Consumer side: drains every channel, formats and coalesces records
+ *
+ * Repeats of one call site inside the rate-limit window are folded into a
+ * single "(repeated N times)" line emitted when the window closes, so an
+ * xrun storm costs one message per second instead of one per callback.
+ */
+class Drainer {
+public:
+    using Clock = std::chrono::system_clock;
+    using Sink = std::function<void(const Site& site, Clock::time_point time, std::string_view message)>;
+
+    static constexpr auto DRAIN_INTERVAL = std::chrono::milliseconds(20);
+
+    ~Drainer() {
+        // Static teardown: stop the thread without touching a sink that may already be gone
+        {
+            std::lock_guard<std::mutex> lock(m_threadMutex);
+            m_running = false;
+        }
+        m_wake.notify_all();
+        if (m_thread.joinable()) {
+            m_thread.join();
+        }
+    }
+
+    void Start(Sink sink) {
+        Stop();
+        {
+            std::lock_guard<std::mutex> lock(m_drainMutex);
+            m_sink = std::move(sink);
+        }
+        std::lock_guard<std::mutex> lock(m_threadMutex);
+        m_running = true;
+        // Runs at normal priority; it only competes with the UI, never with the audio threads
+        m_thread = std::thread([this] { Run(); });
+    }
+
+    // Emits everything still queued, including pending repeat summaries, then detaches the sink
+    void Stop() {
+        {
+            std::lock_guard<std::mutex> lock(m_threadMutex);
+            m_running = false;
+        }
+        m_wake.notify_all();
+        if (m_thread.joinable()) {
+            m_thread.join();
+        }
+        std::lock_guard<std::mutex> lock(m_drainMutex);
+        DrainLocked(true);
+        m_sink = nullptr;
+    }
+
+    void SetSink(Sink sink) {
+        std::lock_guard<std::mutex> lock(m_drainMutex);
+        m_sink = std::move(sink);
+    }
+
+    void SetRateLimit(std::chrono::milliseconds window) {
+        std::lock_guard<std::mutex> lock(m_drainMutex);
+        m_rateLimit = window;
+    }
+
+    /**
+     * @brief Drain all channels now
+     * @param flushRepeats Also emit repeat summaries whose window is still open
+     */
+    void Drain(bool flushRepeats = false) {
+        std::lock_guard<std::mutex> lock(m_drainMutex);
+        DrainLocked(flushRepeats);
+    }
+
+private:
+    struct SiteState {
+        Clock::time_point windowStart;
+        uint64_t repeats = 0;
+        Record last;
+        std::string thread;
+    };
+
+    void Run() {
+        std::unique_lock<std::mutex> lock(m_threadMutex);
+        while (m_running) {
+            m_wake.wait_for(lock, DRAIN_INTERVAL, [this] { return !m_running; });
+            lock.unlock();
+            Drain();
+            lock.lock();
+        }
+    }
+
+    void DrainLocked(bool flushRepeats) {
+        Record record;
+        for (size_t i = 0; i < MAX_CHANNELS; ++i) {
+            Channel& channel = g_channels[i];
+            while (channel.Pop(record)) {
+                Accept(record, channel.GetName());
+            }
+
+            const uint64_t dropped = channel.GetDropped();
+            if (dropped != m_reportedDrops[i]) {
+                Emit(s_dropSite, Clock::now(), fmt::format("[{}] real-time log ring full, dropped {} records",
+                                                           channel.GetName(), dropped - m_reportedDrops[i]));
+                m_reportedDrops[i] = dropped;
+            }
+        }
+
+        const uint64_t unclaimed = g_unclaimedDrops.load(std::memory_order_relaxed);
+        if (unclaimed != m_reportedUnclaimed) {
+            Emit(s_dropSite, Clock::now(), fmt::format("No free real-time log channel, dropped {} records",
+                                                       unclaimed - m_reportedUnclaimed));
+            m_reportedUnclaimed = unclaimed;
+        }
+
+        const auto now = Clock::now();
+        for (auto& [site, state] : m_sites) {
+            if (state.repeats > 0 && (flushRepeats || now - state.windowStart >= m_rateLimit)) {
+                EmitRepeats(state);
+            }
+        }
+    }
+
+    void Accept(const Record& record, const char* thread) {
+        const auto time = Clock::time_point(std::chrono::duration_cast<Clock::duration>(
+            std::chrono::nanoseconds(record.timestampNs)));
+        auto found = m_sites.find(record.site);
+        if (found != m_sites.end() && time - found->second.windowStart < m_rateLimit) {
+            SiteState& state = found->second;
+            state.repeats++;
+            state.last = record;
+            state.thread = thread;
+            return;
+        }
+
+        if (found != m_sites.end() && found->second.repeats > 0) {
+            EmitRepeats(found->second);
+        }
+        SiteState& state = m_sites[record.site];
+        state.windowStart = time;
+        state.repeats = 0;
+        Emit(*record.site, time, fmt::format("[{}] {}", thread, Format(record)));
+    }
+
+    void EmitRepeats(SiteState& state) {
+        const auto time = Clock::time_point(std::chrono::duration_cast<Clock::duration>(
+            std::chrono::nanoseconds(state.last.timestampNs)));
+        Emit(*state.last.site, time, fmt::format("[{}] {} (repeated {} times)",
+                                                 state.thread, Format(state.last), state.repeats));
+        state.repeats = 0;
+        state.windowStart = time;
+    }
+
+    void Emit(const Site& site, Clock::time_point time, std::string_view message) {
+        if (m_sink) {
+            m_sink(site, time, message);
+        }
+    }
+
+    static std::string Format(const Record& record) {
+        fmt::dynamic_format_arg_store<fmt::format_context> store;
+        for (size_t i = 0; i < record.argCount; ++i) {
+            const Arg& arg = record.args[i];
+            switch (arg.type) {
+                case Arg::Type::Int:   store.push_back(arg.i); break;
+                case Arg::Type::UInt:  store.push_back(arg.u); break;
+                case Arg::Type::Float: store.push_back(arg.f); break;
+                case Arg::Type::Bool:  store.push_back(arg.b); break;
+            }
+        }
+        try {
+            return fmt::vformat(record.site->format, store);
+        } catch (const fmt::format_error& e) {
+            return fmt::format("{} [format error: {}]", record.site->format, e.what());
+        }
+    }
+
+    static constexpr Site s_dropSite{spdlog::level::warn, "", __FILE__, __LINE__, ""};
+
+    std::mutex m_drainMutex;                    // Serializes consumers: drain thread, Flush, tests
+    Sink m_sink;
+    std::chrono::milliseconds m_rateLimit{1000};
+    std::unordered_map<const Site*, SiteState> m_sites;
+    std::array<uint64_t, MAX_CHANNELS> m_reportedDrops{};
+    uint64_t m_reportedUnclaimed = 0;
+
+    std::mutex m_threadMutex;
+    std::condition_variable m_wake;
+    std::thread m_thread;
+    bool m_running = false;
+};
+
+inline Drainer& GetDrainer() {
+    static Drainer drainer;
+    return drainer;
+}
+
+} // namespace rtlog
+} // namespace vrb
+
+// Real-time-safe logging: arguments are captured raw and formatted later on the drain thread
+#define VRB_RT_LOG(lvl, format, ...) do { \
+        static constexpr vrb::rtlog::Site vrb_rt_log_site{lvl, format, __FILE__, __LINE__, __func__}; \
+        vrb::rtlog::Log(vrb_rt_log_site, ##__VA_ARGS__); \
+    } while (0)
+
+#define RT_LOG_TRACE(format, ...) VRB_RT_LOG(spdlog::level::trace, format, ##__VA_ARGS__)
+#define RT_LOG_DEBUG(format, ...) VRB_RT_LOG(spdlog::level::debug, format, ##__VA_ARGS__)
+#define RT_LOG_INFO(format, ...) VRB_RT_LOG(spdlog::level::info, format, ##__VA_ARGS__)
+#define RT_LOG_WARN(format, ...) VRB_RT_LOG(spdlog::level::warn, format, ##__VA_ARGS__)
+#define RT_LOG_ERROR(format, ...) VRB_RT_LOG(spdlog::level::err, format, ##__VA_ARGS__)
@@ -0,0 +1,77 @@
+// snapshot_channel.h - Wait-free latest-value handoff between two threads
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace vrb {
+
+/**
+ * @brief Single-producer single-consumer triple buffer
+ *
+ * The writer fills the back buffer and publishes it; the reader swaps in the
+ * most recent complete snapshot. Both sides are a single atomic exchange, so
+ * neither ever waits on the other, and the reader can never observe a
+ * half-written value. Intermediate snapshots the reader did not pick up are
+ * dropped, which is the wanted behaviour for state (poses, parameters) rather
+ * than events.
+ *
+ * The back buffer is recycled from an older snapshot, so a writer that only
+ * changes part of T must refill the whole value before publishing.
+ */
+template<typename T>
+class SnapshotChannel {
+public:
+    SnapshotChannel() = default;
+    SnapshotChannel(const SnapshotChannel&) = delete;
+    SnapshotChannel& operator=(const SnapshotChannel&) = delete;
+
+    /**
+     * @brief Set every buffer to value and drop any unread snapshot
+     *
+     * Not thread-safe: only while neither side is running.
+     */
+    void reset(const T& value) {
+        for (auto& buffer : m_buffers) {
+            buffer = value;
+        }
+        m_back = 0;
+        m_front = 1;
+        m_middle.store(2, std::memory_order_relaxed);
+    }
+
+    // Writer side: fill back(), then publish()
+    T& back() { return m_buffers[m_back]; }
+
+    void publish() {
+        const uint8_t previous = m_middle.exchange(static_cast<uint8_t>(m_back | FRESH), std::memory_order_acq_rel);
+        m_back = previous & INDEX_MASK;
+    }
+
+    /**
+     * @brief Reader side: move to the latest published snapshot
+     * @return true if front() changed since the previous call
+     */
+    bool acquire() {
+        if ((m_middle.load(std::memory_order_relaxed) & FRESH) == 0) {
+            return false;
+        }
+        const uint8_t previous = m_middle.exchange(m_front, std::memory_order_acq_rel);
+        m_front = previous & INDEX_MASK;
+        return true;
+    }
+
+    const T& front() const { return m_buffers[m_front]; }
+
+private:
+    static constexpr uint8_t INDEX_MASK = 0x3;
+    static constexpr uint8_t FRESH = 0x4;   // Middle buffer holds a snapshot the reader has not taken
+
+    std::array<T, 3> m_buffers{};
+    uint8_t m_back{0};      // Writer-owned
+    uint8_t m_front{1};     // Reader-owned
+    alignas(64) std::atomic<uint8_t> m_middle{2};
+};
+
+} // namespace vrb
@@ -1,5 +1,6 @@
 // application.cpp - Enhanced application management implementation
 #include "application.h"
+#include "simd/simd_dispatch.h"
 #include <thread>
 #include <chrono>
 #include <iostream>
@@ -255,6 +256,21 @@ InitResult Application::initializeConfig() {
         // Update logger level if specified in config
         Logger::SetLevel(m_config->GetLogLevel());
 
+        // Select SIMD kernels before any audio component touches them
+        const std::string requestedSIMD = m_config->GetSIMDLevel();
+        simd::Level parsedSIMD = simd::Level::Scalar;
+        bool automaticSIMD = false;
+        const bool knownSIMD = simd::parseLevel(requestedSIMD, parsedSIMD, automaticSIMD);
+        const simd::Level selectedSIMD = simd::initialize(requestedSIMD);
+        if (!knownSIMD) {
+            LOG_WARN("Unknown performance.simdLevel '{}', using auto", requestedSIMD);
+        } else if (parsedSIMD > selectedSIMD) {
+            LOG_WARN("performance.simdLevel '{}' not supported by this CPU, capped to {}",
+                     requestedSIMD, simd::levelName(selectedSIMD));
+        }
+        LOG_INFO("SIMD kernels: {} (CPU supports {}): {}", simd::levelName(selectedSIMD),
+                 simd::levelName(simd::detectLevel()), simd::describeKernels());
+
         return InitResult(true, "Config");
     } catch (const std::exception& e) {
         return InitResult(false, "Config", e.what());
@@ -267,7 +283,7 @@ InitResult Application::initializeHRTF() {
     try {
         m_hrtf = std::make_unique<HRTFProcessor>();
 
-        if (!m_hrtf->Initialize(m_config->GetHRTFDataPath())) {
+        if (!m_hrtf->Initialize(*m_config)) {
             return InitResult(false, "HRTF", "Failed to initialize HRTF processor");
         }
 
@@ -337,11 +353,16 @@ InitResult Application::initializeOverlayUI() {
         m_vrTracker->SetTrackingCallback([this](const VRPose& hmd, const std::vector<VRPose>& controllers) {
             // This is where the 90Hz VR tracking feeds into both audio processing and UI!
 
-            // Update HRTF processor for spatial audio processing
-            if (m_hrtf) {
+            // Update HRTF processor for spatial audio processing, unless automation is driving it
+            if (m_hrtf && !(m_audioEngine && m_audioEngine->IsPlayingAutomation())) {
                 m_hrtf->UpdateSpatialPosition(hmd, controllers);
             }
 
+            // Session pose track and mic automation, stamped against the audio sample clock
+            if (m_audioEngine) {
+                m_audioEngine->RecordPose(hmd, controllers);
+            }
+
             // Update Audio Cockpit for gesture detection and orb manipulation
             if (m_audioCockpit) {
                 // Real-time updates from Veteran Engineer's perfect 90Hz tracking thread!
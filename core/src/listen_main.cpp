@@ -0,0 +1,132 @@
+// listen_main.cpp - Reference consumer of the recorder's shared-memory output
+// Follows a running vr_binaural_recorder (audio.sharedOutput.enabled) and optionally writes what it hears to a WAV
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../../modules/audio/shared_output.h"
+#include "../../modules/audio/wav_file.h"
+
+namespace {
+    std::atomic<bool> g_stop{false};
+
+    void handleSignal(int) {
+        g_stop = true;
+    }
+
+    void printUsage(const char* programName) {
+        std::cout << "Usage: " << programName << " [options]\n"
+                  << "\nVR Binaural Recorder - Shared-memory output listener\n"
+                  << "\nOptions:\n"
+                  << "  --help, -h          Show this help message\n"
+                  << "  --name <name>       Shared output to follow (default " << vrb::SharedOutputFormat::DEFAULT_NAME << ")\n"
+                  << "  --seconds <s>       Stop after this long (default: until Ctrl+C)\n"
+                  << "  --output <file>     Also write the stream to a 32-bit float WAV\n"
+                  << "\nThe recorder publishes while audio.sharedOutput.enabled is true in its configuration.\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::string name = vrb::SharedOutputFormat::DEFAULT_NAME;
+    std::string outputPath;
+    double seconds = 0.0;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg(argv[i]);
+        const bool hasValue = i + 1 < argc;
+
+        if (arg == "--help" || arg == "-h") {
+            printUsage(argv[0]);
+            return 0;
+        } else if (arg == "--name" && hasValue) {
+            name = argv[++i];
+        } else if (arg == "--output" && hasValue) {
+            outputPath = argv[++i];
+        } else if (arg == "--seconds" && hasValue) {
+            char* end = nullptr;
+            seconds = std::strtod(argv[++i], &end);
+            if (*end != '\0' || seconds < 0.0) {
+                std::cerr << "Expected a duration after --seconds\n";
+                return 1;
+            }
+        } else {
+            std::cerr << "Unknown option: " << arg << "\n";
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    std::signal(SIGINT, handleSignal);
+    std::signal(SIGTERM, handleSignal);
+
+    vrb::SharedOutputReader reader;
+    std::string error;
+    if (!reader.Attach(name, error)) {
+        std::cerr << "❌ " << error << "\n";
+        return 1;
+    }
+    const int sampleRate = reader.GetSampleRate();
+    std::cout << "Listening to " << name << " (" << sampleRate << " Hz, " << reader.GetChannels() << " ch, "
+              << reader.GetCapacity() << " frame ring)...\n";
+
+    vrb::WavWriter wav;
+    if (!outputPath.empty()) {
+        if (!wav.Open(outputPath, sampleRate, reader.GetChannels(), vrb::WavSampleFormat::Float32, error)) {
+            std::cerr << "❌ " << error << "\n";
+            return 1;
+        }
+    }
+
+    const uint64_t xrunsAtStart = reader.GetSourceXruns();
+    const uint64_t frameLimit = seconds > 0.0 ? static_cast<uint64_t>(seconds * sampleRate) : 0;
+    std::vector<float> block(1024 * vrb::SharedOutputFormat::CHANNELS);
+    uint64_t frames = 0;
+    float peak = 0.0f;
+    bool producerGone = false;
+
+    while (!g_stop && (frameLimit == 0 || frames < frameLimit)) {
+        if (reader.Wait(std::chrono::milliseconds(200)) == 0) {
+            // Timeouts are the only time the segment's identity is checked
+            if (reader.IsProducerGone()) {
+                producerGone = true;
+                break;
+            }
+            continue;
+        }
+        size_t want = block.size() / vrb::SharedOutputFormat::CHANNELS;
+        if (frameLimit != 0) {
+            want = static_cast<size_t>(std::min<uint64_t>(want, frameLimit - frames));
+        }
+        const size_t got = reader.Read(block.data(), want);
+        for (size_t i = 0; i < got * vrb::SharedOutputFormat::CHANNELS; ++i) {
+            peak = std::max(peak, std::abs(block[i]));
+        }
+        if (!outputPath.empty() && !wav.Write(block.data(), got)) {
+            std::cerr << "❌ Failed to write " << outputPath << "\n";
+            return 1;
+        }
+        frames += got;
+    }
+
+    if (!outputPath.empty()) {
+        wav.Close();
+    }
+
+    std::cout << (producerGone ? "⚠️  Producer went away\n" : "")
+              << "✅ Received " << frames << " frames (" << std::fixed << std::setprecision(2)
+              << static_cast<double>(frames) / sampleRate << " s)\n"
+              << "   Peak:       " << std::setprecision(3) << peak << "\n"
+              << "   Overruns:   " << reader.GetOverrunFrames() << " frames skipped by this listener\n"
+              << "   Xruns:      " << reader.GetSourceXruns() - xrunsAtStart << " in the recorder\n";
+    if (!outputPath.empty()) {
+        std::cout << "   Wrote:      " << outputPath << "\n";
+    }
+    return producerGone ? 2 : 0;
+}
@@ -8,6 +8,7 @@
 #include <thread>
 #include "application.h"
 #include "../../modules/audio/audio_engine.h"
+#include "../../modules/audio/hrtf_processor.h"
 #include "../../modules/vr/vr_tracker.h"
 
 namespace {
@@ -102,6 +103,7 @@ namespace {
                   << "  --version, -v       Show version information\n"
                   << "  --config <file>     Use custom configuration file\n"
                   << "  --list-devices      List available audio devices\n"
+                  << "  --compile-hrtf <file> Precompile the HRTF dataset for hrtf.cachePath and exit\n"
                   << "  --vr-overlay        Force SteamVR overlay mode (default)\n"
                   << "  --desktop-mode      Force desktop GUI mode (fallback)\n"
                   << "  --no-vr             Run without VR support (headless)\n"
@@ -285,6 +287,25 @@ namespace {
         }
     }
 
+    // Builds the dataset the configuration selects and writes it as a mappable cache file
+    int compileHRTFCache(const std::string& configPath, const std::string& outputPath) {
+        std::cout << "Compiling HRTF dataset to " << outputPath << "...\n";
+
+        try {
+            vrb::Config config(configPath);
+            vrb::HRTFProcessor processor;
+            if (!processor.Initialize(config) || !processor.CompileCache(outputPath)) {
+                std::cout << "❌ HRTF compilation failed\n";
+                return 1;
+            }
+            std::cout << "✅ HRTF dataset compiled for " << config.GetProcessingSampleRate() << " Hz\n";
+            return 0;
+        } catch (const std::exception& e) {
+            std::cout << "❌ HRTF compilation failed: " << e.what() << "\n";
+            return 1;
+        }
+    }
+
     int testUISystem() {
         std::cout << "Testing UI system (Audio Cockpit)...\n";
 
@@ -329,6 +350,8 @@ int main(int argc, char* argv[]) {
     bool shouldExit = false;
     bool testMode = false;
     int testResult = 0;
+    std::string configPath = "vr_binaural_config.json";
+    std::string hrtfCacheOutput;
 
     for (int i = 1; i < argc; ++i) {
         const std::string arg(argv[i]);
@@ -342,6 +365,8 @@ int main(int argc, char* argv[]) {
         } else if (arg == "--list-devices") {
             listAudioDevices();
             return 0;
+        } else if (arg == "--compile-hrtf" && i + 1 < argc) {
+            hrtfCacheOutput = argv[++i];
         } else if (arg == "--exit") {
             shouldExit = true;
         } else if (arg == "--test-vr-init") {
@@ -396,8 +421,9 @@ int main(int argc, char* argv[]) {
         } else if (arg == "--no-vr" || arg == "--no-vr-required" || arg == "--no-headset-required") {
             std::cout << "VR support disabled - running in headless mode\n";
         } else if (arg == "--config" && i + 1 < argc) {
-            // TODO: Set custom config file
-            std::cout << "Using config file: " << argv[++i] << "\n";
+            // TODO: Set custom config file for the application
+            configPath = argv[++i];
+            std::cout << "Using config file: " << configPath << "\n";
         } else if (arg.find("--duration=") == 0 || arg.find("--") == 0) {
             // Skip parameter arguments and unknown test options
             continue;
@@ -408,6 +434,11 @@ int main(int argc, char* argv[]) {
         }
     }
 
+    // Runs after parsing so --config applies wherever it appears
+    if (!hrtfCacheOutput.empty()) {
+        return compileHRTFCache(configPath, hrtfCacheOutput);
+    }
+
     // If we ran tests and should exit, return test results
     if (testMode && shouldExit) {
         return testResult;
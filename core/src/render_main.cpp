@@ -0,0 +1,142 @@
+// render_main.cpp - VR Binaural Recorder offline renderer entry point
+// Renders a recorded WAV along a pose trajectory as fast as the CPU allows
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include "config.h"
+#include "logger.h"
+#include "../../modules/audio/offline_renderer.h"
+
+namespace {
+    void printUsage(const char* programName) {
+        std::cout << "Usage: " << programName << " --input <file.wav> --output <file.wav> [options]\n"
+                  << "\nVR Binaural Recorder - Offline binaural rendering\n"
+                  << "\nOptions:\n"
+                  << "  --help, -h          Show this help message\n"
+                  << "  --config <file>     Use custom configuration file\n"
+                  << "  --input <file>      Mono or stereo WAV to render\n"
+                  << "  --output <file>     Binaural stereo WAV to write\n"
+                  << "  --trajectory <file> CSV of timed poses or a recorded .vrbpose track\n"
+                  << "                      (default: static source ahead)\n"
+                  << "  --format <f>        Output samples: 16, 24, 32 or float (default float)\n"
+                  << "  --threads <n>       Worker threads (default: all cores)\n"
+                  << "  --segments <n>      Segments rendered in parallel (default: one per thread)\n"
+                  << "  --block <frames>    Frames per processing block and pose update (default 256)\n"
+                  << "  --no-dither         Truncate 16/24-bit output without TPDF dither\n"
+                  << "  --verbose           Enable verbose logging\n"
+                  << "\nTrajectory rows: time, head x,y,z, head qw,qx,qy,qz, mic x,y,z, mic qw,qx,qy,qz\n"
+                  << "             or: time, mic x,y,z (head at the origin)\n";
+    }
+
+    bool parseCount(const std::string& text, size_t& value) {
+        char* end = nullptr;
+        const unsigned long long parsed = std::strtoull(text.c_str(), &end, 10);
+        if (text.empty() || *end != '\0') {
+            return false;
+        }
+        value = static_cast<size_t>(parsed);
+        return true;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::string configPath = "vr_binaural_config.json";
+    std::string inputPath;
+    std::string outputPath;
+    std::string trajectoryPath;
+    std::string logLevel = "warn";
+    vrb::OfflineRenderOptions options;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg(argv[i]);
+        const bool hasValue = i + 1 < argc;
+
+        if (arg == "--help" || arg == "-h") {
+            printUsage(argv[0]);
+            return 0;
+        } else if (arg == "--config" && hasValue) {
+            configPath = argv[++i];
+        } else if (arg == "--input" && hasValue) {
+            inputPath = argv[++i];
+        } else if (arg == "--output" && hasValue) {
+            outputPath = argv[++i];
+        } else if (arg == "--trajectory" && hasValue) {
+            trajectoryPath = argv[++i];
+        } else if (arg == "--format" && hasValue) {
+            if (!vrb::ParseWavSampleFormat(argv[++i], options.outputFormat)) {
+                std::cerr << "Unknown output format: " << argv[i] << "\n";
+                return 1;
+            }
+        } else if ((arg == "--threads" || arg == "--segments" || arg == "--block") && hasValue) {
+            size_t value = 0;
+            if (!parseCount(argv[++i], value)) {
+                std::cerr << "Expected a number after " << arg << "\n";
+                return 1;
+            }
+            (arg == "--threads" ? options.threads : arg == "--segments" ? options.segments : options.blockFrames) = value;
+        } else if (arg == "--no-dither") {
+            options.dither = false;
+        } else if (arg == "--verbose") {
+            logLevel = "debug";
+        } else {
+            std::cerr << "Unknown option: " << arg << "\n";
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (inputPath.empty() || outputPath.empty()) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    try {
+        vrb::Logger::Initialize(logLevel);
+
+        vrb::PoseTrajectory trajectory;
+        std::string error;
+        if (!trajectoryPath.empty() && !trajectory.Load(trajectoryPath, error)) {
+            std::cerr << "❌ " << error << "\n";
+            return 1;
+        }
+
+        // HRTF runs at the file's rate so nothing is resampled on the way through
+        vrb::WavReader probe;
+        if (!probe.Open(inputPath, error)) {
+            std::cerr << "❌ " << error << "\n";
+            return 1;
+        }
+        const vrb::WavInfo info = probe.GetInfo();
+        probe.Close();
+
+        vrb::Config config(configPath);
+        config.Set("audio.pipeline.sampleRate", info.sampleRate);
+
+        std::cout << "Rendering " << inputPath << " (" << info.frames << " frames, " << info.channels
+                  << " ch, " << info.sampleRate << " Hz";
+        if (!trajectory.empty()) {
+            std::cout << ", " << trajectory.size() << " poses";
+        }
+        std::cout << ")...\n";
+
+        vrb::OfflineRenderer renderer(config);
+        const auto result = renderer.Render(inputPath, trajectory, outputPath, options);
+        vrb::Logger::Shutdown();
+        if (!result.success) {
+            std::cerr << "❌ Render failed: " << result.error << "\n";
+            return 1;
+        }
+
+        std::cout << "✅ Wrote " << outputPath << "\n"
+                  << "   Frames:     " << result.frames << " in " << result.segments << " segment(s)\n"
+                  << "   Time:       " << std::fixed << std::setprecision(3) << result.seconds << " s\n"
+                  << "   Throughput: " << std::setprecision(0) << result.samplesPerSecond << " samples/s ("
+                  << std::setprecision(1) << result.realtimeFactor << "x realtime)\n";
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Render failed: " << e.what() << "\n";
+        return 1;
+    }
+}
@@ -2,6 +2,7 @@
 
 #include "audio_engine.h"
 #include "logger.h"
+#include "simd/audio_simd.h"
 #include <algorithm>
 #include <cstring>
 #include <cmath>
@@ -10,6 +11,8 @@
 #include <iomanip>
 #include <fstream>
 #include <cstdlib>
+#include <ctime>
+#include <filesystem>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
@@ -38,150 +41,48 @@ constexpr int MAX_BUFFER_SIZE = 2048;
 constexpr int MIN_BUFFER_SIZE = 32;
 constexpr const char* VIRTUAL_OUTPUT_NAME = "VR Binaural Recorder";
 constexpr double MAX_CALLBACK_TIME_MS = 10.0;  // Maximum allowed callback duration
-constexpr int ADAPTIVE_BUFFER_THRESHOLD = 5;  // Number of xruns before buffer adjustment
 constexpr float PEAK_DECAY_RATE = 0.99f;  // Peak level decay per callback
+constexpr int MAX_LOOKAHEAD_BLOCKS = 8;  // Worker pipeline lookahead limit
+constexpr size_t LATENCY_CROSSFADE_FRAMES = 32;  // Splice length when the latency controller steers the queue
+constexpr float STAGE_TIMING_SMOOTHING = 0.05f;  // Weight of the newest block in stage averages
+constexpr size_t SRC_RETURN_SLACK_FRAMES = 4;     // Device-rate frames queued behind the converters
 
-// SIMD-optimized audio processing functions
-namespace simd {
-    // Float conversion with SIMD optimization
-    void convertInt16ToFloat(const int16_t* input, float* output, size_t samples) {
-#ifdef VRB_USE_AVX2
-        const size_t simdSamples = samples & ~15;  // Process 16 samples at a time
-        const __m256 scale = _mm256_set1_ps(1.0f / 32768.0f);
+namespace {
 
-        for (size_t i = 0; i < simdSamples; i += 16) {
-            __m128i int16_data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
-            __m256i int32_data = _mm256_cvtepi16_epi32(int16_data);
-            __m256 float_data = _mm256_cvtepi32_ps(int32_data);
-            __m256 scaled_data = _mm256_mul_ps(float_data, scale);
-            _mm256_storeu_ps(output + i, scaled_data);
-
-            int16_data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i + 8));
-            int32_data = _mm256_cvtepi16_epi32(int16_data);
-            float_data = _mm256_cvtepi32_ps(int32_data);
-            scaled_data = _mm256_mul_ps(float_data, scale);
-            _mm256_storeu_ps(output + i + 8, scaled_data);
-        }
-
-        // Process remaining samples
-        for (size_t i = simdSamples; i < samples; ++i) {
-            output[i] = static_cast<float>(input[i]) / 32768.0f;
-        }
-#elif defined(VRB_USE_SSE2)
-        const size_t simdSamples = samples & ~7;  // Process 8 samples at a time
-        const __m128 scale = _mm_set1_ps(1.0f / 32768.0f);
-
-        for (size_t i = 0; i < simdSamples; i += 8) {
-            __m128i int16_data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
-            __m128i int32_lo = _mm_unpacklo_epi16(int16_data, _mm_setzero_si128());
-            __m128i int32_hi = _mm_unpackhi_epi16(int16_data, _mm_setzero_si128());
-
-            // Convert to signed 32-bit
-            int32_lo = _mm_srai_epi32(_mm_slli_epi32(int32_lo, 16), 16);
-            int32_hi = _mm_srai_epi32(_mm_slli_epi32(int32_hi, 16), 16);
-
-            __m128 float_lo = _mm_cvtepi32_ps(int32_lo);
-            __m128 float_hi = _mm_cvtepi32_ps(int32_hi);
-
-            __m128 scaled_lo = _mm_mul_ps(float_lo, scale);
-            __m128 scaled_hi = _mm_mul_ps(float_hi, scale);
-
-            _mm_storeu_ps(output + i, scaled_lo);
-            _mm_storeu_ps(output + i + 4, scaled_hi);
-        }
-
-        // Process remaining samples
-        for (size_t i = simdSamples; i < samples; ++i) {
-            output[i] = static_cast<float>(input[i]) / 32768.0f;
-        }
+// directory/name with the local time substituted into pattern (strftime)
+std::string TimestampedPath(const std::string& directory, const char* pattern) {
+    const std::time_t now = std::time(nullptr);
+    std::tm local{};
+#ifdef _WIN32
+    localtime_s(&local, &now);
 #else
-        for (size_t i = 0; i < samples; ++i) {
-            output[i] = static_cast<float>(input[i]) / 32768.0f;
-        }
+    localtime_r(&now, &local);
 #endif
-    }
-
-    void convertFloatToInt16(const float* input, int16_t* output, size_t samples) {
-#ifdef VRB_USE_AVX2
-        const size_t simdSamples = samples & ~15;
-        const __m256 scale = _mm256_set1_ps(32767.0f);
-        const __m256 min_val = _mm256_set1_ps(-32768.0f);
-        const __m256 max_val = _mm256_set1_ps(32767.0f);
-
-        for (size_t i = 0; i < simdSamples; i += 16) {
-            __m256 float_data1 = _mm256_loadu_ps(input + i);
-            __m256 float_data2 = _mm256_loadu_ps(input + i + 8);
-
-            // Scale and clamp
-            float_data1 = _mm256_mul_ps(float_data1, scale);
-            float_data2 = _mm256_mul_ps(float_data2, scale);
-            float_data1 = _mm256_max_ps(_mm256_min_ps(float_data1, max_val), min_val);
-            float_data2 = _mm256_max_ps(_mm256_min_ps(float_data2, max_val), min_val);
-
-            // Convert to int32
-            __m256i int32_data1 = _mm256_cvtps_epi32(float_data1);
-            __m256i int32_data2 = _mm256_cvtps_epi32(float_data2);
-
-            // Pack to int16
-            __m256i packed = _mm256_packs_epi32(int32_data1, int32_data2);
-            packed = _mm256_permute4x64_epi64(packed, _MM_SHUFFLE(3,1,2,0));
-            _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + i), packed);
-        }
-
-        for (size_t i = simdSamples; i < samples; ++i) {
-            float scaled = input[i] * 32767.0f;
-            output[i] = static_cast<int16_t>(std::clamp(scaled, -32768.0f, 32767.0f));
-        }
-#else
-        for (size_t i = 0; i < samples; ++i) {
-            float scaled = input[i] * 32767.0f;
-            output[i] = static_cast<int16_t>(std::clamp(scaled, -32768.0f, 32767.0f));
-        }
-#endif
-    }
-
-    float calculatePeakLevel(const float* buffer, size_t samples) {
-#ifdef VRB_USE_AVX2
-        __m256 max_vals = _mm256_setzero_ps();
-        const size_t simdSamples = samples & ~7;
-
-        for (size_t i = 0; i < simdSamples; i += 8) {
-            __m256 data = _mm256_loadu_ps(buffer + i);
-            __m256 abs_data = _mm256_andnot_ps(_mm256_set1_ps(-0.0f), data);
-            max_vals = _mm256_max_ps(max_vals, abs_data);
-        }
-
-        float result[8];
-        _mm256_storeu_ps(result, max_vals);
-        float peak = *std::max_element(result, result + 8);
+    char name[64];
+    std::strftime(name, sizeof(name), pattern, &local);
+    return (std::filesystem::path(directory) / name).string();
+}
 
-        // Process remaining samples
-        for (size_t i = simdSamples; i < samples; ++i) {
-            peak = std::max(peak, std::abs(buffer[i]));
-        }
+AudioEngine::PipelineMode ParsePipelineMode(const std::string& mode) {
+    return mode == "worker" ? AudioEngine::PipelineMode::Worker : AudioEngine::PipelineMode::Inline;
+}
 
-        return peak;
+// Keep the calling thread on one core so its caches stay warm between blocks
+bool PinCurrentThreadToCPU(int cpu) {
+#ifdef _WIN32
+    return cpu < 64 && SetThreadAffinityMask(GetCurrentThread(), static_cast<DWORD_PTR>(1) << cpu) != 0;
+#elif defined(__linux__)
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(cpu, &cpus);
+    return pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) == 0;
 #else
-        float peak = 0.0f;
-        for (size_t i = 0; i < samples; ++i) {
-            peak = std::max(peak, std::abs(buffer[i]));
-        }
-        return peak;
+    (void)cpu;  // macOS only offers affinity hints
+    return false;
 #endif
-    }
 }
 
-// Sample rate conversion state
-struct AudioEngine::SRCState {
-    double ratio;
-    std::vector<float> history;
-    size_t historyIndex;
-    bool initialized;
-
-    SRCState() : ratio(1.0), historyIndex(0), initialized(false) {
-        history.resize(256, 0.0f);  // Small history buffer for interpolation
-    }
-};
+} // namespace
 
 AudioEngine::AudioEngine()
     : m_stream(nullptr)
@@ -196,13 +97,12 @@ AudioEngine::AudioEngine()
     , m_preferredHostAPI(HostAPI::Default)
     , m_inputDevice(paNoDevice)
     , m_outputDevice(paNoDevice)
-    , m_hostApiIndex(-1)
-    , m_srcState(std::make_unique<SRCState>())
-    , m_callbackHistory(CALLBACK_HISTORY_SIZE) {
+    , m_hostApiIndex(-1) {
 }
 
 AudioEngine::~AudioEngine() {
     Stop();
+    m_deviceCatalog.CancelProbe();
 
     // Stop monitoring thread
     if (m_monitorRunning) {
@@ -220,6 +120,9 @@ AudioEngine::~AudioEngine() {
         }
     }
 
+    // No callback is left to publish; readers see the producer go
+    m_sharedOutput.Close();
+
     // Remove virtual audio device if created
     RemoveVirtualAudioDevice();
 
@@ -231,7 +134,10 @@ AudioEngine::~AudioEngine() {
     }
 #endif
 
-    if (m_initialized && !m_mockBackend) {
+    if (m_initialized && m_jackBackend) {
+        m_jack.Close();
+        LOG_INFO("JACK client closed");
+    } else if (m_initialized && !m_mockBackend) {
         Pa_Terminate();
         LOG_INFO("PortAudio terminated");
     } else if (m_initialized && m_mockBackend) {
@@ -251,6 +157,32 @@ bool AudioEngine::Initialize(const Config& config, HRTFProcessor* hrtf) {
         return false;
     }
 
+    // Pipeline settings apply to the mock backend as well
+    m_pipelineMode = ParsePipelineMode(config.GetPipelineMode());
+    m_lookaheadBlocks = std::clamp(config.GetPipelineLookahead(), 1, MAX_LOOKAHEAD_BLOCKS);
+    m_dspWorkerCpu = config.GetDSPWorkerCPU();
+    m_outputDither = config.GetOutputDither();
+    m_adaptiveBuffering = config.GetAdaptiveLatency();
+    LoadRecordingSettings(config);
+    LoadSharedOutputSettings(config);
+    LoadSimulationSettings(config);
+
+    // A JACK client needs neither PortAudio nor a display, so it is tried before the headless check
+    const std::string backend = config.GetAudioBackend();
+    if (backend == "jack" || backend == "auto") {
+        if (InitializeJackBackend(config)) {
+            return true;
+        }
+        if (backend == "jack") {
+            LOG_WARN("JACK backend unavailable, falling back to PortAudio");
+        }
+    }
+
+    if (backend == "simulated") {
+        LOG_INFO("Simulated audio backend selected ({} clock)", SimulatedClockName(m_simulationOptions.clock));
+        return InitializeMockBackend();
+    }
+
     // Check for headless/WSL2 environment first
     if (IsHeadlessEnvironment()) {
         LOG_INFO("Headless environment detected, initializing mock audio backend");
@@ -268,11 +200,12 @@ bool AudioEngine::Initialize(const Config& config, HRTFProcessor* hrtf) {
 
     // Load configuration
     m_sampleRate = config.GetSampleRate();
-    m_targetSampleRate = m_sampleRate;
+    m_targetSampleRate = config.GetProcessingSampleRate();
+    m_resamplerQuality = ParseResamplerQuality(config.GetResamplerQuality());
     m_bufferSize = std::clamp(config.GetBufferSize(), MIN_BUFFER_SIZE, MAX_BUFFER_SIZE);
     m_virtualOutputName = config.GetVirtualOutputName();
     m_exclusiveMode = config.GetWASAPIExclusive();
-    m_adaptiveBuffering = true;  // Enable by default
+    m_deviceCachePath = config.GetDeviceCachePath();
 
     // Setup preferred host API
     if (config.GetUseASIO()) {
@@ -291,7 +224,6 @@ bool AudioEngine::Initialize(const Config& config, HRTFProcessor* hrtf) {
     size_t bufferSize = std::max(RING_BUFFER_SIZE, m_bufferSize * 8);
     m_inputBuffer = std::make_unique<RingBuffer<float>>(bufferSize * m_inputChannels);
     m_outputBuffer = std::make_unique<RingBuffer<float>>(bufferSize * m_outputChannels);
-    m_processingBuffer = std::make_unique<RingBuffer<float>>(bufferSize * m_outputChannels);
 
     // Initialize conversion buffers
     m_conversionBufferInput.resize(m_bufferSize * 8);  // Support up to 8 channels
@@ -303,6 +235,9 @@ bool AudioEngine::Initialize(const Config& config, HRTFProcessor* hrtf) {
         LOG_WARN("Failed to setup platform optimizations");
     }
 
+    // Probing opens every device, so it runs behind the rest of startup
+    RefreshDeviceCatalog();
+
     // Find and set default input device
     auto devices = GetInputDevices();
     if (!devices.empty()) {
@@ -330,12 +265,14 @@ bool AudioEngine::Initialize(const Config& config, HRTFProcessor* hrtf) {
         LOG_INFO("Selected input device: {} (index: {})", m_inputDeviceName, m_inputDevice);
     } else {
         LOG_ERROR("No input devices found");
+        m_deviceCatalog.CancelProbe();
         return false;
     }
 
     // Initialize virtual output
     if (!InitializeVirtualOutput()) {
         LOG_ERROR("Failed to initialize virtual audio output");
+        m_deviceCatalog.CancelProbe();   // The probe is inside PortAudio until joined
         Pa_Terminate();
         return false;
     }
@@ -366,6 +303,43 @@ bool AudioEngine::Start() {
     // Reset statistics
     ResetStats();
 
+    ConfigureSampleRateConversion();
+
+    // Automation follows the processing rate, which the new stream may have changed
+    if (m_automationPlayer && GetProcessingRate() != m_automationRate) {
+        const int rate = GetProcessingRate();
+        m_automationPlayhead = m_automationPlayhead * static_cast<uint64_t>(rate) / static_cast<uint64_t>(m_automationRate);
+        m_automationPlayer->SetTimeline(rate, m_automationSpeed);
+        m_automationPlayer->Seek(m_automationPlayhead);
+        m_automationRate = rate;
+    }
+
+    // Size the HRTF scratch for this stream's blocks (at the processing rate) before the callback can run
+    if (m_hrtf) {
+        m_hrtf->SetMaxBlockSize(std::max(static_cast<size_t>(m_bufferSize),
+                                         m_captureConverter.GetMaxOutputFrames(static_cast<size_t>(m_bufferSize))));
+    }
+
+    OpenSharedOutput();
+    StartPipeline();
+
+    if (m_jackBackend) {
+        // The callback renders as soon as the client is active
+        m_running = true;
+        m_lastCallbackTime = std::chrono::steady_clock::now();
+        std::string error;
+        if (!m_jack.Activate(error)) {
+            LOG_ERROR("Failed to activate JACK client: {}", error);
+            m_running = false;
+            StopPipeline();
+            return false;
+        }
+        LOG_INFO("Audio engine started on JACK - Client: '{}', Input latency: {:.2f}ms, Output latency: {:.2f}ms, SR: {}Hz",
+                 m_jack.GetClientName(), m_jack.GetInputLatency() * 1000.0, m_jack.GetOutputLatency() * 1000.0,
+                 m_sampleRate);
+        return true;
+    }
+
     // Handle mock backend
     if (m_mockBackend) {
         m_running = true;
@@ -373,13 +347,14 @@ bool AudioEngine::Start() {
         m_mockLastProcessTime = std::chrono::steady_clock::now();
 
         // Start mock processing thread
+        m_simulationDone = false;
         m_mockProcessingRunning = true;
         m_mockProcessingThread = std::thread([this] {
             MockProcessingLoop();
         });
 
-        LOG_INFO("Mock audio engine started - SR: {}Hz, Buffer: {} samples",
-                 m_sampleRate, m_bufferSize);
+        LOG_INFO("Mock audio engine started - SR: {}Hz, Buffer: {} samples, Clock: {}",
+                 m_sampleRate, m_bufferSize, SimulatedClockName(m_simulationOptions.clock));
         return true;
     }
 
@@ -388,8 +363,12 @@ bool AudioEngine::Start() {
         LOG_WARN("Failed to set real-time priority");
     }
 
+    // A probe holding the device would make the open fail; it resumes once the stream runs
+    m_deviceCatalog.CancelProbe();
+
     if (!OpenStream()) {
         LOG_ERROR("Failed to open audio stream");
+        StopPipeline();
         return false;
     }
 
@@ -397,11 +376,13 @@ bool AudioEngine::Start() {
     if (err != paNoError) {
         LOG_ERROR("Failed to start stream: {}", Pa_GetErrorText(err));
         CloseStream();
+        StopPipeline();
         return false;
     }
 
     m_running = true;
     m_lastCallbackTime = std::chrono::steady_clock::now();
+    StartDeviceProbe();
 
     // Get actual stream info
     const PaStreamInfo* streamInfo = Pa_GetStreamInfo(m_stream);
@@ -424,12 +405,16 @@ void AudioEngine::Stop() {
 
     m_running = false;
 
+    // Start resumes the capability probe once the stream runs; PortAudio must not see it and the stop at once
+    m_deviceCatalog.CancelProbe();
+
     // Handle mock backend
     if (m_mockBackend) {
         m_mockProcessingRunning = false;
         if (m_mockProcessingThread.joinable()) {
             m_mockProcessingThread.join();
         }
+        StopPipeline();
 
         // Log comprehensive statistics
         AudioStats stats = GetStats();
@@ -438,16 +423,23 @@ void AudioEngine::Stop() {
         return;
     }
 
-    if (m_stream) {
+    if (m_jackBackend) {
+        m_jack.Deactivate();
+    } else if (m_stream) {
         PaError err = Pa_StopStream(m_stream);
         if (err != paNoError) {
             LOG_WARN("Error stopping stream: {}", Pa_GetErrorText(err));
         }
         CloseStream();
     }
+    StopPipeline();
 
     // Log comprehensive statistics
     AudioStats stats = GetStats();
+    if (stats.pipelineMode == PipelineMode::Worker) {
+        LOG_INFO("DSP worker stopped - Pipeline underruns: {}, DSP: {:.1f}us avg / {:.1f}us max",
+                 stats.pipelineUnderruns, stats.dspStageDuration.count(), stats.maxDspStageDuration.count());
+    }
     LOG_INFO("Audio engine stopped - Frames: {}, XRuns: {}/{}, Latency: {:.2f}/{:.2f}ms, Peak: {:.3f}/{:.3f}, Dropped: {}",
              stats.framesProcessed, stats.underruns, stats.overruns,
              stats.inputLatency * 1000.0, stats.outputLatency * 1000.0,
@@ -462,11 +454,6 @@ void AudioEngine::Update() {
     // Update performance monitoring
     MonitorPerformance();
 
-    // Handle adaptive buffer adjustment if enabled
-    if (m_adaptiveBuffering) {
-        AdjustBufferSize();
-    }
-
     // Update audio level monitoring for VR overlay
     // Decay peak levels gradually for smooth VR meter visualization
     float currentInputLevel = m_peakInputLevel.load();
@@ -485,6 +472,13 @@ void AudioEngine::Shutdown() {
     if (m_running) {
         Stop();
     }
+    StopRecording();
+    StopAutomationRecording();
+    StopAutomationPlayback();
+    m_jack.Close();
+    m_jackBackend = false;
+    m_sharedOutput.Close();
+    m_deviceCatalog.CancelProbe();
 
     // Stop monitor thread
     if (m_monitorRunning) {
@@ -523,7 +517,6 @@ void AudioEngine::Shutdown() {
     // Clear buffers
     m_inputBuffer.reset();
     m_outputBuffer.reset();
-    m_processingBuffer.reset();
 
     LOG_INFO("Audio engine shutdown complete");
 }
@@ -536,71 +529,28 @@ std::vector<AudioEngine::DeviceInfo> AudioEngine::GetInputDevices() const {
         return m_mockInputDevices;
     }
 
-    int numDevices = Pa_GetDeviceCount();
-    if (numDevices < 0) {
-        LOG_ERROR("Failed to get device count: {}", Pa_GetErrorText(numDevices));
+    // The JACK client is the only device; its sources are whatever gets connected to it
+    if (m_jackBackend) {
+        DeviceInfo device;
+        device.index = 0;
+        device.name = m_jack.GetClientName();
+        device.maxInputChannels = m_jack.GetInputChannels();
+        device.maxOutputChannels = 2;
+        device.defaultSampleRate = m_sampleRate;
+        device.lowInputLatency = m_jack.GetInputLatency();
+        device.lowOutputLatency = m_jack.GetOutputLatency();
+        device.hostAPI = HostAPI::Jack;
+        device.supportsExclusiveMode = false;
+        device.supportedSampleRates = {m_sampleRate};
+        device.supportedFormats = {AudioFormat::Float32};
+        devices.push_back(device);
         return devices;
     }
 
-    for (int i = 0; i < numDevices; i++) {
-        const PaDeviceInfo* info = Pa_GetDeviceInfo(i);
-        if (info && info->maxInputChannels > 0) {
-            DeviceInfo device;
-            device.index = i;
-            device.name = info->name;
-            device.maxInputChannels = info->maxInputChannels;
-            device.maxOutputChannels = info->maxOutputChannels;
-            device.defaultSampleRate = info->defaultSampleRate;
-            device.lowInputLatency = info->defaultLowInputLatency;
-            device.lowOutputLatency = info->defaultLowOutputLatency;
-
-            // Determine host API
-            const PaHostApiInfo* hostInfo = Pa_GetHostApiInfo(info->hostApi);
-            if (hostInfo) {
-                switch (hostInfo->type) {
-                    case paASIO: device.hostAPI = HostAPI::ASIO; break;
-                    case paWASAPI: device.hostAPI = HostAPI::WASAPI; break;
-                    case paCoreAudio: device.hostAPI = HostAPI::CoreAudio; break;
-                    case paALSA: device.hostAPI = HostAPI::ALSA; break;
-                    case paJACK: device.hostAPI = HostAPI::Jack; break;
-                    default: device.hostAPI = HostAPI::Default; break;
-                }
-            } else {
-                device.hostAPI = HostAPI::Default;
-            }
-
-            // Check for exclusive mode support
-            device.supportsExclusiveMode = (device.hostAPI == HostAPI::WASAPI ||
-                                           device.hostAPI == HostAPI::CoreAudio ||
-                                           device.hostAPI == HostAPI::ASIO);
-
-            // Test supported sample rates
-            device.supportedSampleRates.clear();
-            std::vector<int> testRates = {8000, 11025, 16000, 22050, 44100, 48000, 88200, 96000, 176400, 192000};
-            for (int rate : testRates) {
-                if (audio_utils::IsSampleRateSupported(i, rate)) {
-                    device.supportedSampleRates.push_back(rate);
-                }
-            }
-
-            // Test supported formats
-            device.supportedFormats.clear();
-            std::vector<PaSampleFormat> testFormats = {paFloat32, paInt32, paInt24, paInt16};
-            for (PaSampleFormat format : testFormats) {
-                PaStreamParameters params;
-                params.device = i;
-                params.channelCount = 1;
-                params.sampleFormat = format;
-                params.suggestedLatency = info->defaultLowInputLatency;
-                params.hostApiSpecificStreamInfo = nullptr;
-
-                PaError err = Pa_IsFormatSupported(&params, nullptr, 48000);
-                if (err == paFormatIsSupported) {
-                    device.supportedFormats.push_back(audio_utils::PAFormatToInternal(format));
-                }
-            }
-
-            devices.push_back(device);
+    // Listed at Initialize; capabilities come from the background probe or the cache file
+    for (const auto& device : m_deviceCatalog.GetDevices()) {
+        if (device.maxInputChannels > 0) {
+            devices.push_back(audio_utils::ToDeviceInfo(device));
         }
     }
 
@@ -629,44 +579,9 @@ std::vector<AudioEngine::DeviceInfo> AudioEngine::EnumerateAudioDevices() {
         return devices;
     }
 
-    for (int i = 0; i < numDevices; i++) {
-        const PaDeviceInfo* info = Pa_GetDeviceInfo(i);
-        if (info) {
-            DeviceInfo device;
-            device.index = i;
-            device.name = info->name;
-            device.maxInputChannels = info->maxInputChannels;
-            device.maxOutputChannels = info->maxOutputChannels;
-            device.defaultSampleRate = info->defaultSampleRate;
-            device.lowInputLatency = info->defaultLowInputLatency;
-            device.lowOutputLatency = info->defaultLowOutputLatency;
-
-            // Determine host API
-            const PaHostApiInfo* hostInfo = Pa_GetHostApiInfo(info->hostApi);
-            if (hostInfo) {
-                switch (hostInfo->type) {
-                    case paASIO: device.hostAPI = HostAPI::ASIO; break;
-                    case paWASAPI: device.hostAPI = HostAPI::WASAPI; break;
-                    case paCoreAudio: device.hostAPI = HostAPI::CoreAudio; break;
-                    case paALSA: device.hostAPI = HostAPI::ALSA; break;
-                    case paJACK: device.hostAPI = HostAPI::Jack; break;
-                    default: device.hostAPI = HostAPI::Default; break;
-                }
-            } else {
-                device.hostAPI = HostAPI::Default;
-            }
-
-            // Check for exclusive mode support
-            device.supportsExclusiveMode = (device.hostAPI == HostAPI::WASAPI ||
-                                          device.hostAPI == HostAPI::CoreAudio ||
-                                          device.hostAPI == HostAPI::ASIO);
-
-            // Basic supported formats - simplified for device listing
-            device.supportedFormats = {AudioFormat::Float32, AudioFormat::Int32, AudioFormat::Int16};
-            device.supportedSampleRates = {44100, 48000, 96000};
-
-            devices.push_back(device);
-        }
+    // Listing only: nothing is opened, so a device reports its default rate until an engine has probed it
+    for (const auto& device : audio_utils::ListDevices()) {
+        devices.push_back(audio_utils::ToDeviceInfo(device));
     }
 
     return devices;
@@ -704,6 +619,15 @@ bool AudioEngine::SelectInputDevice(int deviceIndex) {
         return true;
     }
 
+    if (m_jackBackend) {
+        if (deviceIndex != 0) {
+            LOG_ERROR("Invalid JACK device index: {} (route sources by connecting them to {}:in_N)",
+                      deviceIndex, m_jack.GetClientName());
+            return false;
+        }
+        return true;
+    }
+
     const PaDeviceInfo* info = Pa_GetDeviceInfo(deviceIndex);
     if (!info || info->maxInputChannels <= 0) {
         LOG_ERROR("Invalid input device index: {}", deviceIndex);
@@ -752,9 +676,33 @@ void AudioEngine::UpdateConfiguration(const Config& config) {
     int newSampleRate = config.GetSampleRate();
     int newBufferSize = std::clamp(config.GetBufferSize(), MIN_BUFFER_SIZE, MAX_BUFFER_SIZE);
     bool newExclusiveMode = config.GetWASAPIExclusive();
+    PipelineMode newPipelineMode = ParsePipelineMode(config.GetPipelineMode());
+    int newLookahead = std::clamp(config.GetPipelineLookahead(), 1, MAX_LOOKAHEAD_BLOCKS);
+    int newWorkerCpu = config.GetDSPWorkerCPU();
+    int newProcessingRate = config.GetProcessingSampleRate();
+    ResamplerQuality newResamplerQuality = ParseResamplerQuality(config.GetResamplerQuality());
+    if (m_jackBackend) {
+        // The JACK server owns the rate and period, and the callback always renders inline
+        newSampleRate = m_sampleRate;
+        newBufferSize = m_bufferSize;
+        newProcessingRate = m_targetSampleRate;
+        newPipelineMode = PipelineMode::Inline;
+    }
+
+    // Dither is read per callback, so it switches without a restart
+    if (config.GetOutputDither() != m_outputDither) {
+        SetOutputDither(config.GetOutputDither());
+    }
+    if (!m_jackBackend && config.GetAdaptiveLatency() != m_adaptiveBuffering) {
+        SetAdaptiveBuffering(config.GetAdaptiveLatency());
+    }
+    LoadRecordingSettings(config);  // Applies from the next recording
+    LoadSharedOutputSettings(config);  // Applies from the next Start
 
     if (newSampleRate != m_sampleRate || newBufferSize != m_bufferSize ||
-        newExclusiveMode != m_exclusiveMode) {
+        newExclusiveMode != m_exclusiveMode || newPipelineMode != m_pipelineMode ||
+        newLookahead != m_lookaheadBlocks || newWorkerCpu != m_dspWorkerCpu ||
+        newProcessingRate != m_targetSampleRate || newResamplerQuality != m_resamplerQuality) {
         needsRestart = true;
     }
 
@@ -762,10 +710,18 @@ void AudioEngine::UpdateConfiguration(const Config& config) {
         LOG_INFO("Configuration change requires restart - SR: {}→{}Hz, Buffer: {}→{} samples",
                  m_sampleRate, newSampleRate, m_bufferSize, newBufferSize);
         Stop();
+        if (newSampleRate != m_sampleRate && IsRecording()) {
+            LOG_WARN("Sample rate change ends the recording to {}", m_recording.GetPath());
+            StopRecording();
+        }
         m_sampleRate = newSampleRate;
-        m_targetSampleRate = newSampleRate;
+        m_targetSampleRate = newProcessingRate;
+        m_resamplerQuality = newResamplerQuality;
         m_bufferSize = newBufferSize;
         m_exclusiveMode = newExclusiveMode;
+        m_pipelineMode = newPipelineMode;
+        m_lookaheadBlocks = newLookahead;
+        m_dspWorkerCpu = newWorkerCpu;
 
         // Resize buffers if needed
         if (m_conversionBufferInput.size() < m_bufferSize * 8) {
@@ -778,6 +734,11 @@ void AudioEngine::UpdateConfiguration(const Config& config) {
     } else {
         // Update non-restart parameters
         m_virtualOutputName = config.GetVirtualOutputName();
+        if (!m_running) {
+            m_pipelineMode = newPipelineMode;
+            m_lookaheadBlocks = newLookahead;
+            m_dspWorkerCpu = newWorkerCpu;
+        }
     }
 }
 
@@ -793,8 +754,29 @@ AudioEngine::AudioStats AudioEngine::GetStats() const {
     stats.peakOutputLevel = m_peakOutputLevel.load();
     stats.droppedSamples = m_droppedSamples.load();
 
+    stats.inputStageDuration = AudioStats::StageDuration(m_inputStage.averageMicros.load(std::memory_order_relaxed));
+    stats.dspStageDuration = AudioStats::StageDuration(m_dspStage.averageMicros.load(std::memory_order_relaxed));
+    stats.outputStageDuration = AudioStats::StageDuration(m_outputStage.averageMicros.load(std::memory_order_relaxed));
+    stats.maxDspStageDuration = AudioStats::StageDuration(m_dspStage.maxMicros.load(std::memory_order_relaxed));
+
+    stats.pipelineMode = m_pipelineMode;
+    const bool worker = m_pipelineMode == PipelineMode::Worker;
+    stats.lookaheadBlocks = worker ? m_lookaheadBlocks : 0;
+    stats.pipelineLatency = worker ? static_cast<double>(m_latency.GetTargetFrames()) / m_sampleRate : 0.0;
+    stats.pipelineFramesReady = 0;
+    if (m_dspRunning && m_outputBuffer) {  // The rings are only replaced while the worker is stopped
+        stats.pipelineFramesReady = static_cast<int64_t>(m_outputBuffer->available() / m_outputChannels);
+    }
+    stats.pipelineUnderruns = m_pipelineUnderruns.load();
+    stats.processingSampleRate = m_captureConverter.IsPassthrough() ? m_sampleRate : m_targetSampleRate;
+    stats.resamplerLatency = GetResamplerLatency();
+
     // Get latency info from stream
-    if (m_stream) {
+    if (m_jackBackend) {
+        stats.inputLatency = m_jack.GetInputLatency();
+        stats.outputLatency = m_jack.GetOutputLatency();
+        stats.underruns += static_cast<int>(m_jack.GetXruns());   // The server reports xruns, not the callback
+    } else if (m_stream) {
         const PaStreamInfo* streamInfo = Pa_GetStreamInfo(m_stream);
         if (streamInfo) {
             stats.inputLatency = streamInfo->inputLatency;
@@ -802,11 +784,37 @@ AudioEngine::AudioStats AudioEngine::GetStats() const {
         }
     }
 
-    // Get callback duration
-    {
-        std::lock_guard<std::mutex> lock(m_perfMutex);
-        stats.callbackDuration = m_avgCallbackDuration;
-    }
+    // Callback duration distribution
+    auto micros = [](LatencyHistogram::Duration value) { return AudioStats::StageDuration(value); };
+    stats.callbackDuration = std::chrono::duration_cast<std::chrono::microseconds>(m_callbackDurations.GetMean());
+    stats.callbackP50 = micros(m_callbackDurations.GetPercentile(50.0));
+    stats.callbackP90 = micros(m_callbackDurations.GetPercentile(90.0));
+    stats.callbackP99 = micros(m_callbackDurations.GetPercentile(99.0));
+    stats.callbackP999 = micros(m_callbackDurations.GetPercentile(99.9));
+    stats.callbackMax = micros(m_callbackDurations.GetMax());
+    stats.callbackCount = static_cast<int64_t>(m_callbackDurations.GetCount());
+
+    // Misses have no margin and sit below every recorded one, so low percentiles account for them
+    stats.deadlineMisses = m_deadlineMisses.load(std::memory_order_relaxed);
+    auto marginPercentile = [&](double percentile) {
+        const double total = static_cast<double>(stats.callbackCount);
+        const double missed = static_cast<double>(stats.deadlineMisses);
+        if (total == 0.0 || percentile / 100.0 * total <= missed) {
+            return AudioStats::StageDuration(0.0f);
+        }
+        const double recorded = total - missed;
+        return micros(m_deadlineMargins.GetPercentile(100.0 * (percentile / 100.0 * total - missed) / recorded));
+    };
+    stats.deadlineMarginP50 = marginPercentile(50.0);
+    stats.deadlineMarginP10 = marginPercentile(10.0);
+    stats.deadlineMarginP1 = marginPercentile(1.0);
+    stats.deadlineMarginP01 = marginPercentile(0.1);
+
+    const auto recording = m_recording.GetStats();
+    stats.recording = m_recording.IsRecording();
+    stats.recordingOverflowFrames = static_cast<int64_t>(recording.binaural.overflowFrames);
+    stats.sharedOutput = m_sharedOutput.IsOpen();
+    stats.sharedOutputReaders = static_cast<int>(m_sharedOutput.GetReaderCount());
 
     return stats;
 }
@@ -901,12 +909,6 @@ bool AudioEngine::InitializeVirtualOutput() {
         std::this_thread::sleep_for(std::chrono::milliseconds(100));
     }
 
-    int numDevices = Pa_GetDeviceCount();
-    if (numDevices < 0) {
-        LOG_ERROR("Failed to get device count: {}", Pa_GetErrorText(numDevices));
-        return false;
-    }
-
     struct VirtualDeviceCandidate {
         int index;
         std::string name;
@@ -915,6 +917,8 @@ bool AudioEngine::InitializeVirtualOutput() {
         bool isVirtual;
         double latency;
         int maxChannels;
+        bool probed;
+        std::vector<int> sampleRates;
     };
 
     std::vector<VirtualDeviceCandidate> candidates;
@@ -937,35 +941,22 @@ bool AudioEngine::InitializeVirtualOutput() {
         {"VirtualAudio", 30}
     };
 
-    // Scan all output devices and evaluate them
-    for (int i = 0; i < numDevices; i++) {
-        const PaDeviceInfo* info = Pa_GetDeviceInfo(i);
-        if (!info || info->maxOutputChannels < 2) {
+    // Evaluate every output device the catalog listed
+    for (const auto& device : m_deviceCatalog.GetDevices()) {
+        if (device.maxOutputChannels < 2) {
             continue;
         }
 
         VirtualDeviceCandidate candidate;
-        candidate.index = i;
-        candidate.name = info->name;
-        candidate.maxChannels = info->maxOutputChannels;
-        candidate.latency = info->defaultLowOutputLatency;
+        candidate.index = device.index;
+        candidate.name = device.name;
+        candidate.maxChannels = device.maxOutputChannels;
+        candidate.latency = device.lowOutputLatency;
         candidate.isVirtual = false;
         candidate.priority = 0;
-
-        // Determine host API
-        const PaHostApiInfo* hostInfo = Pa_GetHostApiInfo(info->hostApi);
-        if (hostInfo) {
-            switch (hostInfo->type) {
-                case paASIO: candidate.hostAPI = HostAPI::ASIO; break;
-                case paWASAPI: candidate.hostAPI = HostAPI::WASAPI; break;
-                case paCoreAudio: candidate.hostAPI = HostAPI::CoreAudio; break;
-                case paALSA: candidate.hostAPI = HostAPI::ALSA; break;
-                case paJACK: candidate.hostAPI = HostAPI::Jack; break;
-                default: candidate.hostAPI = HostAPI::Default; break;
-            }
-        } else {
-            candidate.hostAPI = HostAPI::Default;
-        }
+        candidate.hostAPI = audio_utils::HostAPIFromPA(device.hostApiType);
+        candidate.probed = device.probed;
+        candidate.sampleRates = device.outputSampleRates;
 
         // Check if device name matches virtual patterns
         std::string nameLower = candidate.name;
@@ -1006,15 +997,23 @@ bool AudioEngine::InitializeVirtualOutput() {
 
     // Try to select the best candidate
     for (const auto& candidate : candidates) {
-        // Test if the device actually works
-        PaStreamParameters testParams;
-        testParams.device = candidate.index;
-        testParams.channelCount = std::min(2, candidate.maxChannels);
-        testParams.sampleFormat = paFloat32;
-        testParams.suggestedLatency = candidate.latency;
-        testParams.hostApiSpecificStreamInfo = nullptr;
-
-        PaError err = Pa_IsFormatSupported(nullptr, &testParams, m_sampleRate);
+        // Test if the device actually works; a probed one already says
+        PaError err = paFormatIsSupported;
+        if (candidate.probed) {
+            if (std::find(candidate.sampleRates.begin(), candidate.sampleRates.end(), m_sampleRate) == candidate.sampleRates.end()) {
+                err = paInvalidSampleRate;
+            }
+        } else {
+            PaStreamParameters testParams;
+            testParams.device = candidate.index;
+            testParams.channelCount = std::min(2, candidate.maxChannels);
+            testParams.sampleFormat = paFloat32;
+            testParams.suggestedLatency = candidate.latency;
+            testParams.hostApiSpecificStreamInfo = nullptr;
+
+            std::lock_guard<std::mutex> lock(m_deviceProbeMutex);
+            err = Pa_IsFormatSupported(nullptr, &testParams, m_sampleRate);
+        }
         if (err == paFormatIsSupported) {
             m_outputDevice = candidate.index;
             m_outputDeviceName = candidate.name;
@@ -1071,6 +1070,7 @@ int AudioEngine::AudioCallback(const void* inputBuffer, void* outputBuffer,
 int AudioEngine::ProcessAudio(const void* input, void* output, unsigned long frames,
                               PaStreamCallbackFlags statusFlags, const PaStreamCallbackTimeInfo* /* timeInfo */) {
     auto callbackStart = std::chrono::steady_clock::now();
+    rtlog::RegisterThread("audio");     // Claims this device thread's log channel on the first callback
 
     if (!m_running) {
         // Output silence if not running
@@ -1079,34 +1079,28 @@ int AudioEngine::ProcessAudio(const void* input, void* output, unsigned long fra
         return paContinue;
     }
 
-    // Check for underrun/overrun and handle adaptively
+    // Count xruns; in worker mode the latency controller reacts to them at the next block
     bool hasXruns = false;
     if (statusFlags & paInputUnderflow) {
         m_underruns++;
         hasXruns = true;
-        LOG_WARN("Input underflow detected (count: {})", m_underruns.load());
-        if (m_adaptiveBuffering && m_underruns % ADAPTIVE_BUFFER_THRESHOLD == 0) {
-            AdjustBufferSize();
-        }
+        RT_LOG_WARN("Input underflow detected (count: {})", m_underruns.load());
     }
     if (statusFlags & paOutputOverflow) {
         m_overruns++;
         hasXruns = true;
-        LOG_WARN("Output overflow detected (count: {})", m_overruns.load());
-        if (m_adaptiveBuffering && m_overruns % ADAPTIVE_BUFFER_THRESHOLD == 0) {
-            AdjustBufferSize();
-        }
+        RT_LOG_WARN("Output overflow detected (count: {})", m_overruns.load());
     }
     if (statusFlags & paInputOverflow) {
         m_bufferOverruns++;
-        LOG_DEBUG("Input buffer overflow (count: {})", m_bufferOverruns.load());
+        RT_LOG_DEBUG("Input buffer overflow (count: {})", m_bufferOverruns.load());
     }
     if (statusFlags & paOutputUnderflow) {
         m_bufferUnderruns++;
-        LOG_DEBUG("Output buffer underflow (count: {})", m_bufferUnderruns.load());
+        RT_LOG_DEBUG("Output buffer underflow (count: {})", m_bufferUnderruns.load());
     }
     if (statusFlags & paPrimingOutput) {
-        LOG_DEBUG("Priming output buffers");
+        RT_LOG_DEBUG("Priming output buffers");
     }
 
     // Convert input to internal format and write to ring buffer
@@ -1123,19 +1117,25 @@ int AudioEngine::ProcessAudio(const void* input, void* output, unsigned long fra
         }
 
         // Calculate input peak level
-        float inputPeak = simd::calculatePeakLevel(inputFloat, frames * m_inputChannels);
+        float inputPeak = simd::calculatePeak(inputFloat, frames * m_inputChannels);
         float currentInputPeak = m_peakInputLevel.load();
         m_peakInputLevel = std::max(inputPeak, currentInputPeak * PEAK_DECAY_RATE);
 
-        // Write input to ring buffer for thread-safe processing
-        size_t samplesWritten = m_inputBuffer->write(inputFloat, frames * m_inputChannels);
-        if (samplesWritten < frames * m_inputChannels) {
-            m_bufferOverruns++;
-            LOG_DEBUG("Input ring buffer overflow: wrote {} of {} samples", samplesWritten, frames * m_inputChannels);
+        // Inline mode queues input here; worker mode queues it once the rendered block is taken
+        if (m_pipelineMode == PipelineMode::Inline) {
+            size_t samplesWritten = m_inputBuffer->write(inputFloat, frames * m_inputChannels);
+            if (samplesWritten < frames * m_inputChannels) {
+                m_bufferOverruns++;
+                RT_LOG_DEBUG("Input ring buffer overflow: wrote {} of {} samples", samplesWritten, frames * m_inputChannels);
+            }
+            inputReady = true;
         }
-        inputReady = true;
     }
 
+    const auto outputStageStart = std::chrono::steady_clock::now();
+    m_inputStage.Record(outputStageStart - callbackStart);
+    std::chrono::steady_clock::duration dspElapsed{0};
+
     // Determine output destination
     float* outputFloat = nullptr;
     if (m_outputFormat == AudioFormat::Float32) {
@@ -1148,7 +1148,12 @@ int AudioEngine::ProcessAudio(const void* input, void* output, unsigned long fra
     size_t outputSamplesAvailable = m_outputBuffer->available();
     size_t outputSamplesNeeded = frames * m_outputChannels;
 
-    if (outputSamplesAvailable >= outputSamplesNeeded) {
+    if (m_pipelineMode == PipelineMode::Worker) {
+        // The DSP worker renders; this thread only trades blocks with it
+        if (ExchangePipelineBlock(inputFloat, outputFloat, frames, callbackStart)) {
+            m_framesProcessed += frames;
+        }
+    } else if (outputSamplesAvailable >= outputSamplesNeeded) {
         // We have enough processed audio available
         size_t samplesRead = m_outputBuffer->read(outputFloat, outputSamplesNeeded);
         if (samplesRead == outputSamplesNeeded) {
@@ -1170,24 +1175,13 @@ int AudioEngine::ProcessAudio(const void* input, void* output, unsigned long fra
             size_t samplesRead = m_inputBuffer->read(m_resampleBuffer.data(), inputSamplesNeeded);
 
             if (samplesRead == inputSamplesNeeded) {
-                // Process through HRTF
-                if (m_sampleRate != m_targetSampleRate) {
-                    // Apply sample rate conversion if needed
-                    if (ApplySampleRateConversion(m_resampleBuffer.data(),
-                                                m_conversionBufferInput.data(), frames, frames)) {
-                        m_hrtf->Process(m_conversionBufferInput.data(), outputFloat, frames, m_inputChannels);
-                    } else {
-                        // Fallback to direct processing if SRC fails
-                        m_hrtf->Process(m_resampleBuffer.data(), outputFloat, frames, m_inputChannels);
-                    }
-                } else {
-                    m_hrtf->Process(m_resampleBuffer.data(), outputFloat, frames, m_inputChannels);
-                }
+                // Process through HRTF on the device deadline
+                dspElapsed = RenderBlock(m_resampleBuffer.data(), outputFloat, frames);
 
                 // Store processed audio in output ring buffer for future use
                 size_t outputWritten = m_outputBuffer->write(outputFloat, outputSamplesNeeded);
                 if (outputWritten < outputSamplesNeeded) {
-                    LOG_DEBUG("Output ring buffer full: wrote {} of {} samples", outputWritten, outputSamplesNeeded);
+                    RT_LOG_DEBUG("Output ring buffer full: wrote {} of {} samples", outputWritten, outputSamplesNeeded);
                 }
 
                 m_framesProcessed += frames;
@@ -1202,23 +1196,7 @@ int AudioEngine::ProcessAudio(const void* input, void* output, unsigned long fra
                 if (m_inputChannels == m_outputChannels) {
                     std::memcpy(outputFloat, inputFloat, frames * m_outputChannels * sizeof(float));
                 } else if (m_inputChannels == 1 && m_outputChannels == 2) {
-                    // Mono to stereo conversion with SIMD optimization
-                    const size_t simdFrames = frames & ~7;  // Process 8 frames at a time
-
-#ifdef VRB_USE_AVX2
-                    for (size_t i = 0; i < simdFrames; i += 8) {
-                        __m256 mono = _mm256_loadu_ps(&inputFloat[i]);
-                        __m256 stereo_lo = _mm256_unpacklo_ps(mono, mono);
-                        __m256 stereo_hi = _mm256_unpackhi_ps(mono, mono);
-                        _mm256_storeu_ps(&outputFloat[i * 2], stereo_lo);
-                        _mm256_storeu_ps(&outputFloat[i * 2 + 8], stereo_hi);
-                    }
-#endif
-                    // Handle remaining frames
-                    for (size_t i = simdFrames; i < frames; ++i) {
-                        outputFloat[i * 2] = inputFloat[i];
-                        outputFloat[i * 2 + 1] = inputFloat[i];
-                    }
+                    simd::monoToStereo(inputFloat, outputFloat, frames);
                 } else {
                     // Channel count mismatch - output silence
                     std::memset(outputFloat, 0, outputSamplesNeeded * sizeof(float));
@@ -1232,11 +1210,22 @@ int AudioEngine::ProcessAudio(const void* input, void* output, unsigned long fra
 
     // Calculate output peak level
     if (outputFloat) {
-        float outputPeak = simd::calculatePeakLevel(outputFloat, frames * m_outputChannels);
+        float outputPeak = simd::calculatePeak(outputFloat, frames * m_outputChannels);
         float currentOutputPeak = m_peakOutputLevel.load();
         m_peakOutputLevel = std::max(outputPeak, currentOutputPeak * PEAK_DECAY_RATE);
     }
 
+    // Hand the blocks to the disk writers; a full ring drops them instead of waiting
+    m_recording.PushAudio(inputFloat, outputFloat, frames);
+    if (m_sharedOutput.IsOpen()) {
+        // Readers follow the cursor on their own; a copy, and a wake only if one sleeps
+        m_sharedOutput.Write(outputFloat, frames);
+        if (hasXruns) {
+            m_sharedOutput.AddSourceXruns(1);
+        }
+    }
+    m_streamFrames.fetch_add(frames, std::memory_order_relaxed);
+
     // Convert output from internal format if necessary
     if (m_outputFormat != AudioFormat::Float32 && outputFloat != output) {
         ConvertAudioFormat(outputFloat, output, frames, m_outputFormat, m_outputChannels);
@@ -1244,38 +1233,724 @@ int AudioEngine::ProcessAudio(const void* input, void* output, unsigned long fra
 
     // Update performance statistics
     auto callbackEnd = std::chrono::steady_clock::now();
+    m_outputStage.Record(callbackEnd - outputStageStart - dspElapsed);
+    RecordCallbackTiming(callbackStart, callbackEnd, frames);
     auto duration = std::chrono::duration_cast<std::chrono::microseconds>(callbackEnd - callbackStart);
 
-    {
-        std::lock_guard<std::mutex> lock(m_perfMutex);
-        m_callbackHistory[m_callbackHistoryIndex] = duration;
-        m_callbackHistoryIndex = (m_callbackHistoryIndex + 1) % CALLBACK_HISTORY_SIZE;
+    // Update CPU load (estimate based on callback duration)
+    double callbackMs = duration.count() / 1000.0;
+    double expectedMs = (static_cast<double>(frames) / m_sampleRate) * 1000.0;
+    m_cpuLoad = static_cast<float>(std::min(callbackMs / expectedMs, 1.0));
+
+    // Check for excessive callback duration
+    if (duration.count() > MAX_CALLBACK_TIME_MS * 1000) {
+        m_droppedSamples += frames;
+        RT_LOG_WARN("Callback duration exceeded limit: {:.2f}ms", duration.count() / 1000.0);
+    }
+
+    return paContinue;
+}
+
+void AudioEngine::JackProcess(const float* const* inputs, float* left, float* right, size_t frames, void* userData) {
+    static_cast<AudioEngine*>(userData)->ProcessJack(inputs, left, right, frames);
+}
+
+void AudioEngine::ProcessJack(const float* const* inputs, float* left, float* right, size_t frames) {
+    const auto callbackStart = std::chrono::steady_clock::now();
+    rtlog::RegisterThread("audio");
+
+    if (!m_running || !m_hrtf) {
+        std::memset(left, 0, frames * sizeof(float));
+        std::memset(right, 0, frames * sizeof(float));
+        return;
+    }
+
+    // JACK hands over planar float ports: no format conversion, no ring hop
+    float inputPeak = 0.0f;
+    for (int ch = 0; ch < m_inputChannels; ++ch) {
+        inputPeak = std::max(inputPeak, simd::calculatePeak(inputs[ch], frames));
+    }
+    m_peakInputLevel = std::max(inputPeak, m_peakInputLevel.load() * PEAK_DECAY_RATE);
+
+    const auto dspStart = std::chrono::steady_clock::now();
+    m_inputStage.Record(dspStart - callbackStart);
+
+    // The spatializer writes into the output port buffers
+    RenderAutomated(frames, [&](size_t offset, size_t count) {
+        const float* planes[JackBackend::MAX_INPUTS] = {inputs[0] + offset,
+                                                        m_inputChannels > 1 ? inputs[1] + offset : nullptr};
+        m_hrtf->ProcessPlanar(planes, m_inputChannels, left + offset, right + offset, count);
+    });
+    const auto dspEnd = std::chrono::steady_clock::now();
+    m_dspStage.Record(dspEnd - dspStart);
+    m_framesProcessed += frames;
+
+    const float outputPeak = std::max(simd::calculatePeak(left, frames), simd::calculatePeak(right, frames));
+    m_peakOutputLevel = std::max(outputPeak, m_peakOutputLevel.load() * PEAK_DECAY_RATE);
+
+    // The disk writers take interleaved blocks; only recording pays for the interleave
+    if (m_recording.IsRecording()) {
+        const size_t chunk = m_conversionBufferOutput.size() / 2;
+        for (size_t offset = 0; offset < frames; offset += chunk) {
+            const size_t count = std::min(chunk, frames - offset);
+            float* dry = m_conversionBufferInput.data();
+            float* binaural = m_conversionBufferOutput.data();
+            for (size_t i = 0; i < count; ++i) {
+                for (int ch = 0; ch < m_inputChannels; ++ch) {
+                    dry[i * m_inputChannels + ch] = inputs[ch][offset + i];
+                }
+                binaural[i * 2] = left[offset + i];
+                binaural[i * 2 + 1] = right[offset + i];
+            }
+            m_recording.PushAudio(dry, binaural, count);
+        }
+    }
+    if (m_sharedOutput.IsOpen()) {
+        m_sharedOutput.WritePlanar(left, right, frames);
+        const uint64_t xruns = m_jack.GetXruns();
+        if (xruns != m_sharedOutputJackXruns) {
+            m_sharedOutput.AddSourceXruns(xruns - m_sharedOutputJackXruns);
+            m_sharedOutputJackXruns = xruns;
+        }
+    }
+    m_streamFrames.fetch_add(frames, std::memory_order_relaxed);
+
+    const auto callbackEnd = std::chrono::steady_clock::now();
+    m_outputStage.Record(callbackEnd - dspEnd);
+    RecordCallbackTiming(callbackStart, callbackEnd, frames);
+    const double callbackMs = std::chrono::duration<double, std::milli>(callbackEnd - callbackStart).count();
+    const double expectedMs = (static_cast<double>(frames) / m_sampleRate) * 1000.0;
+    m_cpuLoad = static_cast<float>(std::min(callbackMs / expectedMs, 1.0));
+}
+
+std::chrono::steady_clock::duration AudioEngine::RenderBlock(const float* input, float* output, size_t frames) {
+    const auto start = std::chrono::steady_clock::now();
+
+    if (!m_hrtf) {
+        // No spatializer: pass the capture through
+        if (m_inputChannels == m_outputChannels) {
+            std::memcpy(output, input, frames * m_outputChannels * sizeof(float));
+        } else if (m_inputChannels == 1 && m_outputChannels == 2) {
+            simd::monoToStereo(input, output, frames);
+        } else {
+            std::memset(output, 0, frames * m_outputChannels * sizeof(float));
+        }
+    } else if (!m_captureConverter.IsPassthrough()) {
+        RenderResampled(input, output, frames);
+    } else {
+        // Device and processing rates match
+        ProcessSpatial(input, output, frames);
+    }
+
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    m_dspStage.Record(elapsed);
+    return elapsed;
+}
+
+void AudioEngine::RenderResampled(const float* input, float* output, size_t frames) {
+    constexpr int HRTF_CHANNELS = 2;
+    const size_t captured = m_captureConverter.Process(input, frames, m_srcCapture.data(),
+                                                       m_srcCapture.size() / m_inputChannels);
+    ProcessSpatial(m_srcCapture.data(), m_srcRender.data(), captured);
+
+    // Back to the device rate, behind whatever the previous block left over
+    float* queueEnd = m_srcReturn.data() + m_srcReturnFrames * HRTF_CHANNELS;
+    const size_t capacity = m_srcReturn.size() / HRTF_CHANNELS - m_srcReturnFrames;
+    m_srcReturnFrames += m_renderConverter.Process(m_srcRender.data(), captured, queueEnd, capacity);
+
+    const size_t ready = std::min(frames, m_srcReturnFrames);
+    std::memcpy(output, m_srcReturn.data(), ready * HRTF_CHANNELS * sizeof(float));
+    if (ready < frames) {
+        std::memset(output + ready * HRTF_CHANNELS, 0, (frames - ready) * HRTF_CHANNELS * sizeof(float));
+        m_bufferUnderruns++;
+        RT_LOG_DEBUG("Sample rate conversion short by {} frames", frames - ready);
+    }
+    m_srcReturnFrames -= ready;
+    std::memmove(m_srcReturn.data(), m_srcReturn.data() + ready * HRTF_CHANNELS,
+                 m_srcReturnFrames * HRTF_CHANNELS * sizeof(float));
+}
+
+template <typename Render>
+void AudioEngine::RenderAutomated(size_t frames, Render&& render) {
+    // Store-then-load on both sides (here and in StopAutomationPlayback) is a Dekker handshake: it
+    // needs seq_cst, or this load could see the old player while Stop sees the count still at zero
+    m_automationInUse.fetch_add(1);
+    AutomationPlayer* player = m_automation.load();
+    if (!player) {
+        m_automationInUse.fetch_sub(1);
+        render(size_t{0}, frames);
+        return;
+    }
+
+    // Render up to each event's frame, then apply it, so changes land on the recorded sample
+    size_t done = 0;
+    while (done < frames) {
+        // A loop restarts one frame after the last event
+        if (m_automationLoop && m_automationPlayhead > player->GetDuration()) {
+            player->Seek(0);
+            m_automationPlayhead = 0;
+        }
+
+        size_t count = 0;
+        while ((count = player->Read(m_automationPlayhead + 1, m_automationEvents.data(), m_automationEvents.size())) > 0) {
+            for (size_t i = 0; i < count; ++i) {
+                ApplyAutomationEvent(m_automationEvents[i]);
+            }
+        }
+
+        uint64_t until = player->PeekFrame();
+        if (m_automationLoop) {
+            until = std::min(until, player->GetDuration() + 1);
+        }
+        const size_t run = static_cast<size_t>(std::min<uint64_t>(until - m_automationPlayhead, frames - done));
+        render(done, run);
+        done += run;
+        m_automationPlayhead += run;
+    }
+    m_automationInUse.fetch_sub(1);
+}
+
+void AudioEngine::ProcessSpatial(const float* input, float* output, size_t frames) {
+    constexpr int HRTF_CHANNELS = 2;
+    RenderAutomated(frames, [&](size_t offset, size_t count) {
+        m_hrtf->Process(input + offset * m_inputChannels, output + offset * HRTF_CHANNELS, count, m_inputChannels);
+    });
+}
+
+void AudioEngine::ApplyAutomationEvent(const AutomationEvent& event) {
+    // Rendering thread: the spatializer's lock-free setters, never the control-side ones
+    switch (event.lane) {
+        case AutomationLane::MicrophonePosition:
+            m_hrtf->AutomateListenerPosition(event.value);
+            break;
+        case AutomationLane::SourcePosition:
+            m_hrtf->AutomateSourcePosition(event.source, event.value);
+            break;
+        case AutomationLane::SourceGain:
+            m_hrtf->AutomateSourceGain(event.source, event.value.x);
+            break;
+    }
+}
+
+bool AudioEngine::ExchangePipelineBlock(const float* input, float* output, size_t frames,
+                                        std::chrono::steady_clock::time_point now) {
+    const size_t outputSamples = frames * m_outputChannels;
+    const size_t inputSamples = frames * m_inputChannels;
+    const size_t queued = m_outputBuffer->available() / m_outputChannels;
+
+    // The recording's dry track is aligned for the depth it started at, so the depth holds while it runs
+    const bool adaptive = m_adaptiveBuffering.load(std::memory_order_relaxed) && !m_recording.IsRecording();
+    size_t take = frames;
+    if (adaptive) {
+        const double jitterFrames = m_lastExchange == std::chrono::steady_clock::time_point{} ? 0.0 :
+            std::chrono::duration<double>(now - m_lastExchange).count() * m_sampleRate - static_cast<double>(frames);
+        m_lastExchange = now;
+        const int trouble = m_underruns.load(std::memory_order_relaxed) + m_overruns.load(std::memory_order_relaxed) +
+                            m_pipelineUnderruns.load(std::memory_order_relaxed);
+        take = m_latency.Plan(queued, jitterFrames, trouble != m_latencyTrouble);
+        m_latencyTrouble = trouble;
+    }
+
+    bool played = true;
+    if (queued < take) {
+        // The worker is behind: play silence
+        std::memset(output, 0, outputSamples * sizeof(float));
+        m_pipelineUnderruns++;
+        if (!adaptive) {
+            // Drop this capture so the lookahead stays at its configured depth instead of growing
+            m_droppedSamples += static_cast<int>(frames);
+            return false;
+        }
+        // The dropout has happened; keeping the capture deepens the queue by a block for free
+        m_latency.OnUnderrun(queued);
+        m_latencyTrouble++;
+        played = false;
+    } else if (take == frames) {
+        m_outputBuffer->read(output, outputSamples);
+    } else {
+        // Steering the depth: a few frames more or fewer than a block, crossfaded into one
+        m_outputBuffer->read(m_latencyScratch.data(), take * m_outputChannels);
+        LatencyController::Splice(m_latencyScratch.data(), take, output, frames, m_outputChannels,
+                                  m_latency.GetCrossfadeFrames());
+    }
+
+    if (!input) {
+        // Output-only stream: feed silence so the worker keeps pace with the device
+        std::memset(m_conversionBufferInput.data(), 0, inputSamples * sizeof(float));
+        input = m_conversionBufferInput.data();
+    }
+    if (m_inputBuffer->write(input, inputSamples) < inputSamples) {
+        m_bufferOverruns++;
+    } else {
+        m_pipelineBlocksQueued++;
+    }
+    return played;
+}
+
+void AudioEngine::StartPipeline() {
+    // Fresh rings sized for this stream's blocks; audio left from a previous run is dropped
+    const size_t ringFrames = std::max<size_t>(RING_BUFFER_SIZE,
+                                               static_cast<size_t>(m_bufferSize) * (MAX_LOOKAHEAD_BLOCKS + 2));
+    m_inputBuffer = std::make_unique<RingBuffer<float>>(ringFrames * m_inputChannels);
+    m_outputBuffer = std::make_unique<RingBuffer<float>>(ringFrames * m_outputChannels);
+
+    if (m_pipelineMode != PipelineMode::Worker) {
+        return;
+    }
+
+    m_dspInput.assign(static_cast<size_t>(m_bufferSize) * m_inputChannels, 0.0f);
+    m_dspOutput.assign(static_cast<size_t>(m_bufferSize) * m_outputChannels, 0.0f);
+
+    // Prime the lookahead with silence; the device plays it while the first captures are rendered
+    for (int block = 0; block < m_lookaheadBlocks; ++block) {
+        m_outputBuffer->write(m_dspOutput.data(), m_dspOutput.size());
+    }
+
+    // The lookahead is where the controller starts; it moves within one block and the ring's worth of them
+    LatencyControllerOptions latency;
+    latency.blockFrames = static_cast<size_t>(m_bufferSize);
+    latency.initialFrames = static_cast<size_t>(m_lookaheadBlocks) * m_bufferSize;
+    latency.maxFrames = static_cast<size_t>(MAX_LOOKAHEAD_BLOCKS) * m_bufferSize;
+    latency.sampleRate = m_sampleRate;
+    latency.crossfadeFrames = std::min<size_t>(LATENCY_CROSSFADE_FRAMES, m_bufferSize / 2);
+    m_latency.Reset(latency);
+    m_latencyScratch.assign((m_bufferSize + m_latency.GetMaxStepFrames()) * m_outputChannels, 0.0f);
+    m_lastExchange = {};
+    m_pipelineBlocksQueued = 0;
+    m_dspBlocksRendered.store(0, std::memory_order_relaxed);
+    m_latencyTrouble = m_underruns.load() + m_overruns.load() + m_pipelineUnderruns.load();
+
+    m_dspRunning = true;
+    m_dspThread = std::thread([this] { DSPWorkerLoop(); });
+
+    LOG_INFO("DSP worker pipeline started - Lookahead: {} blocks ({:.2f}ms), CPU: {}",
+             m_lookaheadBlocks, 1000.0 * m_lookaheadBlocks * m_bufferSize / m_sampleRate,
+             m_dspWorkerCpu >= 0 ? std::to_string(m_dspWorkerCpu) : std::string("any"));
+}
+
+void AudioEngine::StopPipeline() {
+    if (!m_dspRunning) {
+        return;
+    }
+    m_dspRunning = false;
+    if (m_dspThread.joinable()) {
+        m_dspThread.join();
+    }
+}
+
+void AudioEngine::DSPWorkerLoop() {
+    rtlog::RegisterThread("dsp");
+    if (!audio_utils::SetupRealtimeThread()) {
+        LOG_WARN("DSP worker running without real-time priority");
+    }
+    if (m_dspWorkerCpu >= 0 && !PinCurrentThreadToCPU(m_dspWorkerCpu)) {
+        LOG_WARN("Failed to pin DSP worker to CPU {}", m_dspWorkerCpu);
+    }
+
+    const size_t frames = static_cast<size_t>(m_bufferSize);
+    const size_t inputSamples = m_dspInput.size();
+    const size_t outputSamples = m_dspOutput.size();
+
+    // Polling a quarter block at a time keeps the callback free of wake-up syscalls
+    // while picking up each capture well inside one block of the lookahead
+    const auto idleWait = std::chrono::microseconds(
+        std::max<int64_t>(50, static_cast<int64_t>(frames * 250000.0 / m_sampleRate)));
+    // A free-running simulated device waits for every block, so the two hand off instead of polling
+    const bool lockstep = m_mockBackend && m_simulationOptions.clock == SimulatedClock::Free;
+
+    while (m_dspRunning.load(std::memory_order_acquire)) {
+        bool rendered = false;
+        while (m_inputBuffer->available() >= inputSamples && m_outputBuffer->free() >= outputSamples) {
+            m_inputBuffer->read(m_dspInput.data(), inputSamples);
+            RenderBlock(m_dspInput.data(), m_dspOutput.data(), frames);
+            m_outputBuffer->write(m_dspOutput.data(), outputSamples);
+            m_dspBlocksRendered.fetch_add(1, std::memory_order_release);
+            rendered = true;
+            if (lockstep) {
+                { std::lock_guard<std::mutex> lock(m_lockstepMutex); }
+                m_lockstepCondition.notify_all();
+            }
+        }
+        if (rendered) {
+            continue;
+        }
+        if (lockstep) {
+            std::unique_lock<std::mutex> lock(m_lockstepMutex);
+            m_lockstepCondition.wait_for(lock, idleWait, [&] {
+                return m_inputBuffer->available() >= inputSamples || !m_dspRunning.load(std::memory_order_acquire);
+            });
+        } else {
+            std::this_thread::sleep_for(idleWait);
+        }
+    }
+}
+
+bool AudioEngine::SetPipelineMode(PipelineMode mode, int lookaheadBlocks) {
+    if (m_running) {
+        LOG_ERROR("Cannot change the processing pipeline while running");
+        return false;
+    }
+    if (m_jackBackend && mode == PipelineMode::Worker) {
+        LOG_ERROR("The JACK backend renders inside the process callback; worker mode is not available");
+        return false;
+    }
+
+    m_pipelineMode = mode;
+    m_lookaheadBlocks = std::clamp(lookaheadBlocks, 1, MAX_LOOKAHEAD_BLOCKS);
+    LOG_INFO("Processing pipeline: {} (lookahead {} blocks)",
+             mode == PipelineMode::Worker ? "worker" : "inline", m_lookaheadBlocks);
+    return true;
+}
+
+bool AudioEngine::SetResamplerQuality(ResamplerQuality quality) {
+    if (m_running) {
+        LOG_ERROR("Cannot change the resampler while running");
+        return false;
+    }
+
+    m_resamplerQuality = quality;
+    LOG_INFO("Resampler quality: {}", ResamplerQualityName(quality));
+    return true;
+}
+
+double AudioEngine::GetResamplerLatency() const {
+    if (!m_captureConverter.IsConfigured() || m_captureConverter.IsPassthrough()) {
+        return 0.0;
+    }
+    return m_captureConverter.GetLatencyFrames() / m_sampleRate +
+           m_renderConverter.GetLatencyFrames() / m_targetSampleRate +
+           static_cast<double>(SRC_RETURN_SLACK_FRAMES) / m_sampleRate;
+}
+
+void AudioEngine::LoadRecordingSettings(const Config& config) {
+    RecordingSessionOptions options;
+    if (!ParseWavSampleFormat(config.GetRecordingFormat(), options.audio.format)) {
+        LOG_WARN("Unknown recording format '{}', using 24-bit", config.GetRecordingFormat());
+        options.audio.format = WavSampleFormat::Int24;
+    }
+    options.audio.dither = config.GetOutputDither();
+    options.audio.bufferSeconds = config.GetRecordingBufferSeconds();
+    options.audio.preallocateBytes = static_cast<uint64_t>(std::max(0, config.GetRecordingPreallocateMB())) << 20;
+    options.audio.directIO = config.GetRecordingDirectIO();
+    options.audio.headerIntervalSeconds = config.GetRecordingHeaderInterval();
+    options.audio.description = "VR Binaural Recorder session";
+    options.captureDry = config.GetRecordingCaptureDry();
+    options.capturePoses = config.GetRecordingCapturePoses();
+    m_recordingOptions = options;
+    m_recordingDirectory = config.GetRecordingDirectory();
+
+    m_automationEnabled = config.GetEnableAutomation();
+    m_automationDirectory = config.GetRecordPath();
+    m_automationExportJson = config.GetRecordFormat() == "json";
+    m_automationSpeed = std::clamp(config.GetPlaybackSpeed(), 0.01f, 100.0f);
+}
+
+void AudioEngine::LoadSharedOutputSettings(const Config& config) {
+    m_sharedOutputEnabled = config.GetSharedOutputEnabled();
+    m_sharedOutputName = config.GetSharedOutputName();
+    m_sharedOutputBufferMs = std::clamp(config.GetSharedOutputBufferMs(), 10, 10000);
+}
+
+void AudioEngine::LoadSimulationSettings(const Config& config) {
+    m_simulationOptions.clock = ParseSimulatedClock(config.GetSimulationClock());
+    m_simulationOptions.seed = static_cast<uint64_t>(config.GetSimulationSeed());
+    m_simulationOptions.jitterMicros = std::max(0.0f, config.GetSimulationJitterUs());
+    m_simulationOptions.lateProbability = std::clamp(config.GetSimulationLateProbability(), 0.0f, 1.0f);
+    m_simulationOptions.lateMicros = std::max(0.0f, config.GetSimulationLateUs());
+    m_simulationOptions.dropProbability = std::clamp(config.GetSimulationDropProbability(), 0.0f, 1.0f);
+}
+
+bool AudioEngine::SetSimulation(const SimulatedDeviceOptions& options) {
+    if (m_running) {
+        LOG_ERROR("Cannot change the simulated device while running");
+        return false;
+    }
+
+    m_simulationOptions = options;
+    LOG_INFO("Simulated device: {} clock, seed {}, jitter {:.0f}us, late {:.1f}% by {:.0f}us, drop {:.1f}%, {} scripted faults",
+             SimulatedClockName(options.clock), options.seed, options.jitterMicros, options.lateProbability * 100.0,
+             options.lateMicros, options.dropProbability * 100.0, options.faults.size());
+    return true;
+}
+
+AudioEngine::SimulationStats AudioEngine::GetSimulationStats() const {
+    SimulationStats stats{};
+    stats.blocks = m_simulatedDevice.GetBlocks();
+    stats.droppedBlocks = m_simulatedDevice.GetDroppedBlocks();
+    stats.lateBlocks = m_simulatedDevice.GetLateBlocks();
+    stats.virtualSeconds = m_sampleRate > 0 ? static_cast<double>(stats.blocks) * m_bufferSize / m_sampleRate : 0.0;
+    stats.outputChecksum = m_simulatedDevice.GetOutputChecksum();
+    return stats;
+}
+
+bool AudioEngine::WaitForSimulation(std::chrono::milliseconds timeout) const {
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (!m_simulationDone.load(std::memory_order_acquire)) {
+        if (!m_mockProcessingRunning || std::chrono::steady_clock::now() >= deadline) {
+            return m_simulationDone.load(std::memory_order_acquire);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+void AudioEngine::RefreshDeviceCatalog() {
+    m_deviceCatalog.Update(audio_utils::ListDevices(), m_deviceCachePath, Pa_GetVersionText());
+    const size_t listed = m_deviceCatalog.GetDevices().size();
+    LOG_INFO("Listed {} audio devices, {} with capabilities from the cache{}", listed, m_deviceCatalog.GetCachedCount(),
+             m_deviceCachePath.empty() ? " (audio.deviceCachePath not set)" : "");
+    StartDeviceProbe();
+}
+
+void AudioEngine::StartDeviceProbe() {
+    // Opening a device the stream holds fails, and the failure would be cached as unsupported
+    const int busyInput = m_running ? m_inputDevice : paNoDevice;
+    const int busyOutput = m_running ? m_outputDevice : paNoDevice;
+    m_deviceCatalog.StartProbe([this, busyInput, busyOutput](DeviceCapabilities& device) {
+        if (device.index == busyInput || device.index == busyOutput) {
+            return false;
+        }
+        audio_utils::ProbeDevice(device, m_deviceProbeMutex);
+        return true;
+    });
+}
+
+bool AudioEngine::WaitForDeviceProbe(std::chrono::milliseconds timeout) const {
+    return m_deviceCatalog.WaitForProbe(timeout);
+}
+
+void AudioEngine::OpenSharedOutput() {
+    if (!m_sharedOutputEnabled || m_outputChannels != static_cast<int>(SharedOutputFormat::CHANNELS)) {
+        if (m_sharedOutputEnabled) {
+            LOG_WARN("Shared output carries stereo only; {} output channels are not published", m_outputChannels);
+        }
+        m_sharedOutput.Close();
+        return;
+    }
+
+    const size_t minFrames = static_cast<size_t>(m_sampleRate) * static_cast<size_t>(m_sharedOutputBufferMs) / 1000;
+    // Attached readers keep following a segment whose format still fits
+    if (m_sharedOutput.IsOpen() && m_sharedOutput.GetName() == m_sharedOutputName &&
+        m_sharedOutput.GetSampleRate() == m_sampleRate && m_sharedOutput.GetCapacity() >= minFrames) {
+        return;
+    }
+
+    std::string error;
+    if (!m_sharedOutput.Open(m_sharedOutputName, m_sampleRate, minFrames, error)) {
+        LOG_WARN("Shared output unavailable: {}", error);
+        return;
+    }
+    m_sharedOutputJackXruns = m_jack.GetXruns();
+    LOG_INFO("Publishing binaural output to shared memory '{}' - SR: {}Hz, Ring: {} frames",
+             m_sharedOutputName, m_sampleRate, m_sharedOutput.GetCapacity());
+}
+
+bool AudioEngine::StartRecording(const std::string& path) {
+    if (m_recording.IsRecording()) {
+        LOG_WARN("Already recording to {}", m_recording.GetPath());
+        return false;
+    }
+
+    const std::string target = path.empty() ? TimestampedPath(m_recordingDirectory, "VRB_%Y%m%d_%H%M%S.wav") : path;
+
+    // Recorded as it enters and leaves the engine, at the device rate and channel counts. The
+    // binaural track trails the dry one by the worker queue, held still while recording, and the resampler delay.
+    double queueLatency = 0.0;
+    if (m_pipelineMode == PipelineMode::Worker) {
+        queueLatency = (m_dspRunning ? static_cast<double>(m_latency.GetQueuedFrames())
+                                     : static_cast<double>(m_lookaheadBlocks) * m_bufferSize) / m_sampleRate;
+    }
+    const double renderLatency = queueLatency + GetResamplerLatency();
+    const auto latencyFrames = static_cast<uint32_t>(std::lround(renderLatency * m_sampleRate));
+    std::string error;
+    if (!m_recording.Start(target, m_sampleRate, m_inputChannels, m_outputChannels, latencyFrames,
+                           m_recordingOptions, error)) {
+        LOG_ERROR("Failed to start recording: {}", error);
+        return false;
+    }
+
+    // The automation track starts with the audio; both count device frames from here
+    m_sessionAutomation = m_automationEnabled && !IsRecordingAutomation() &&
+                          StartAutomationRecording(m_recording.GetPaths().automation);
+    return true;
+}
+
+bool AudioEngine::StopRecording() {
+    if (!m_recording.IsRecording()) {
+        return false;
+    }
+
+    bool ok = m_recording.Stop();
+    if (m_sessionAutomation) {
+        m_sessionAutomation = false;
+        ok = StopAutomationRecording() && ok;
+    }
+    return ok;
+}
+
+void AudioEngine::RecordPose(const VRPose& hmd, const std::vector<VRPose>& controllers) {
+    m_recording.PushPose(hmd, controllers);
+    if (!IsRecordingAutomation()) {
+        return;
+    }
+
+    // The mic HRTFProcessor::UpdateSpatialPosition follows: the first valid controller, else chest height in front
+    Vec3 mic(0.0f, hmd.position.y - 0.2f, hmd.position.z - 0.3f);
+    for (const auto& controller : controllers) {
+        if (controller.isValid) {
+            mic = controller.position;
+            break;
+        }
+    }
+    RecordAutomation(AutomationLane::MicrophonePosition, 0, mic - hmd.position);
+}
+
+bool AudioEngine::StartAutomationRecording(const std::string& path) {
+    std::lock_guard<std::mutex> lock(m_automationWriteMutex);
+    if (m_automationWriter.IsOpen()) {
+        LOG_WARN("Already recording automation to {}", m_automationWriter.GetPath());
+        return false;
+    }
+
+    const std::string target = path.empty() ? TimestampedPath(m_automationDirectory, "VRB_%Y%m%d_%H%M%S.vrba") : path;
+    std::string error;
+    if (!m_automationWriter.Open(target, m_sampleRate, error)) {
+        LOG_ERROR("Failed to start automation recording: {}", error);
+        return false;
+    }
+    m_automationStartFrame = m_streamFrames.load(std::memory_order_relaxed);
+    m_automationRecording.store(true, std::memory_order_release);
+    LOG_INFO("Recording automation to {}", target);
+    return true;
+}
+
+bool AudioEngine::StopAutomationRecording() {
+    std::string path;
+    uint64_t events = 0;
+    bool ok = false;
+    {
+        std::lock_guard<std::mutex> lock(m_automationWriteMutex);
+        if (!m_automationWriter.IsOpen()) {
+            return false;
+        }
+        m_automationRecording.store(false, std::memory_order_release);
+        path = m_automationWriter.GetPath();
+        events = m_automationWriter.GetEventCount();
+        ok = m_automationWriter.Close();
+    }
+    LOG_INFO("Automation recording stopped: {} events in {}", events, path);
+
+    // JSON is only ever an export of the binary stream
+    if (ok && m_automationExportJson) {
+        const std::string jsonPath = std::filesystem::path(path).replace_extension(".json").string();
+        std::string error;
+        if (!ExportAutomationJson(path, jsonPath, error)) {
+            LOG_ERROR("Automation JSON export failed: {}", error);
+        }
+    }
+    return ok;
+}
+
+bool AudioEngine::IsRecordingAutomation() const {
+    return m_automationRecording.load(std::memory_order_acquire);
+}
+
+void AudioEngine::RecordAutomation(AutomationLane lane, int source, const Vec3& value) {
+    if (!IsRecordingAutomation() || source < 0) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_automationWriteMutex);
+    if (!m_automationWriter.IsOpen()) {
+        return;
+    }
+    AutomationEvent event;
+    event.frame = m_streamFrames.load(std::memory_order_relaxed) - m_automationStartFrame;
+    event.lane = lane;
+    event.source = static_cast<uint16_t>(std::min(source, 0xffff));
+    event.value = value;
+    m_automationWriter.Write(event);
+}
+
+bool AudioEngine::StartAutomationPlayback(const std::string& path, bool loop) {
+    StopAutomationPlayback();
+    if (!m_hrtf) {
+        LOG_WARN("No spatializer to play automation into");
+        return false;
+    }
+
+    auto player = std::make_unique<AutomationPlayer>();
+    std::string error;
+    if (!player->Open(path, error)) {
+        LOG_ERROR("Failed to open automation: {}", error);
+        return false;
+    }
+
+    // Recorded at the device rate, applied wherever the spatializer runs
+    m_automationRate = GetProcessingRate();
+    player->SetTimeline(m_automationRate, m_automationSpeed);
+    player->Seek(0);
+    m_automationPlayhead = 0;
+    m_automationLoop = loop && player->GetDuration() > 0;
+    LOG_INFO("Playing automation {} ({} events, {:.1f}s{})", path, player->GetEventCount(),
+             static_cast<double>(player->GetDuration()) / m_automationRate, m_automationLoop ? ", looped" : "");
+
+    m_automationPlayer = std::move(player);
+    m_automation.store(m_automationPlayer.get(), std::memory_order_release);
+    return true;
+}
+
+void AudioEngine::StopAutomationPlayback() {
+    m_automation.store(nullptr);
+    while (m_automationInUse.load() != 0) {
+        std::this_thread::yield();
+    }
+    m_automationPlayer.reset();
+}
+
+int AudioEngine::GetProcessingRate() const {
+    return m_captureConverter.IsConfigured() && !m_captureConverter.IsPassthrough() ? m_targetSampleRate : m_sampleRate;
+}
 
-        // Update maximum duration
-        if (duration > m_maxCallbackDuration) {
-            m_maxCallbackDuration = duration;
-        }
+void AudioEngine::RecordCallbackTiming(std::chrono::steady_clock::time_point start,
+                                       std::chrono::steady_clock::time_point end, size_t frames) {
+    const auto duration = std::chrono::duration_cast<LatencyHistogram::Duration>(end - start);
+    const LatencyHistogram::Duration period(static_cast<int64_t>(frames * 1e9 / m_sampleRate));
 
-        // Calculate rolling average
-        auto sum = std::accumulate(m_callbackHistory.begin(), m_callbackHistory.end(),
-                                 std::chrono::microseconds(0));
-        m_avgCallbackDuration = sum / CALLBACK_HISTORY_SIZE;
+    // ResetStats cannot clear the histograms under a running writer, so this thread does it before recording
+    if (m_timingResetPending.load(std::memory_order_acquire)) {
+        m_timingResetPending.store(false, std::memory_order_relaxed);
+        ResetCallbackTiming();
+    }
 
-        m_lastCallbackTime = callbackStart;
+    m_callbackDurations.Record(duration);
+    if (duration < period) {
+        m_deadlineMargins.Record(period - duration);
+    } else {
+        m_deadlineMisses.fetch_add(1, std::memory_order_relaxed);
     }
+    m_lastCallbackTime.store(start, std::memory_order_relaxed);
+}
 
-    // Update CPU load (estimate based on callback duration)
-    double callbackMs = duration.count() / 1000.0;
-    double expectedMs = (static_cast<double>(frames) / m_sampleRate) * 1000.0;
-    m_cpuLoad = static_cast<float>(std::min(callbackMs / expectedMs, 1.0));
+void AudioEngine::ResetCallbackTiming() {
+    m_callbackDurations.Reset();
+    m_deadlineMargins.Reset();
+    m_deadlineMisses = 0;
+}
 
-    // Check for excessive callback duration
-    if (duration.count() > MAX_CALLBACK_TIME_MS * 1000) {
-        m_droppedSamples += frames;
-        LOG_WARN("Callback duration exceeded limit: {:.2f}ms", duration.count() / 1000.0);
+void AudioEngine::StageTimer::Record(std::chrono::steady_clock::duration elapsed) {
+    const float micros = std::chrono::duration<float, std::micro>(elapsed).count();
+    const float average = averageMicros.load(std::memory_order_relaxed);
+    averageMicros.store(average == 0.0f ? micros : average + STAGE_TIMING_SMOOTHING * (micros - average),
+                        std::memory_order_relaxed);
+    if (micros > maxMicros.load(std::memory_order_relaxed)) {
+        maxMicros.store(micros, std::memory_order_relaxed);
     }
+}
 
-    return paContinue;
+void AudioEngine::StageTimer::Reset() {
+    averageMicros.store(0.0f, std::memory_order_relaxed);
+    maxMicros.store(0.0f, std::memory_order_relaxed);
 }
 
 // Additional member function implementations
@@ -1325,7 +2000,13 @@ bool AudioEngine::SetThreadPriority(int /* priority */) {
 AudioEngine::StreamInfo AudioEngine::GetStreamInfo() const {
     StreamInfo info{};
 
-    if (m_stream) {
+    if (m_jackBackend) {
+        info.isActive = m_jack.IsActive();
+        info.inputLatency = m_jack.GetInputLatency();
+        info.outputLatency = m_jack.GetOutputLatency();
+        info.sampleRate = m_sampleRate;
+        info.cpuLoad = m_cpuLoad.load();
+    } else if (m_stream) {
         info.isActive = Pa_IsStreamActive(m_stream) == 1;
 
         const PaStreamInfo* streamInfo = Pa_GetStreamInfo(m_stream);
@@ -1339,8 +2020,14 @@ AudioEngine::StreamInfo AudioEngine::GetStreamInfo() const {
     }
 
     info.bufferSize = m_bufferSize;
-    info.xruns = m_underruns.load() + m_overruns.load();
-    info.lastCallback = m_lastCallbackTime;
+    info.xruns = m_underruns.load() + m_overruns.load() + static_cast<int>(m_jack.GetXruns());
+    if (m_pipelineMode == PipelineMode::Worker && m_dspRunning && m_outputBuffer) {
+        const bool steering = m_adaptiveBuffering && !m_recording.IsRecording();
+        const size_t queued = steering ? m_latency.GetQueuedFrames() : m_outputBuffer->available() / m_outputChannels;
+        info.addedLatency = static_cast<double>(queued) / m_sampleRate;
+        info.targetLatency = static_cast<double>(steering ? m_latency.GetTargetFrames() : queued) / m_sampleRate;
+    }
+    info.lastCallback = m_lastCallbackTime.load(std::memory_order_relaxed);
 
     return info;
 }
@@ -1354,20 +2041,31 @@ void AudioEngine::ResetStats() {
     m_peakInputLevel = 0.0f;
     m_peakOutputLevel = 0.0f;
     m_droppedSamples = 0;
+    m_pipelineUnderruns = 0;
     m_cpuLoad = 0.0f;
+    m_inputStage.Reset();
+    m_dspStage.Reset();
+    m_outputStage.Reset();
 
-    std::lock_guard<std::mutex> lock(m_perfMutex);
-    m_maxCallbackDuration = std::chrono::microseconds(0);
-    m_avgCallbackDuration = std::chrono::microseconds(0);
-    std::fill(m_callbackHistory.begin(), m_callbackHistory.end(), std::chrono::microseconds(0));
-    m_callbackHistoryIndex = 0;
+    // The histograms have a single writer; while the stream runs it clears them at its next callback
+    if (m_running) {
+        m_timingResetPending.store(true, std::memory_order_release);
+    } else {
+        m_timingResetPending.store(false, std::memory_order_relaxed);
+        ResetCallbackTiming();
+    }
 
     LOG_DEBUG("Audio engine statistics reset");
 }
 
 void AudioEngine::SetAdaptiveBuffering(bool enable) {
     m_adaptiveBuffering = enable;
-    LOG_INFO("Adaptive buffering: {}", enable ? "enabled" : "disabled");
+    LOG_INFO("Adaptive latency: {}", enable ? "enabled" : "disabled");
+}
+
+void AudioEngine::SetOutputDither(bool enable) {
+    m_outputDither = enable;
+    LOG_INFO("Output dither: {}", enable ? "enabled" : "disabled");
 }
 
 void AudioEngine::ConvertAudioFormat(const void* input, float* output, size_t frames,
@@ -1405,48 +2103,12 @@ void AudioEngine::ConvertAudioFormat(const void* input, float* output, size_t fr
             case AudioFormat::Int16:
                 simd::convertInt16ToFloat(static_cast<const int16_t*>(input), output, samples);
                 break;
-            case AudioFormat::Int32: {
-                const int32_t* input32 = static_cast<const int32_t*>(input);
-                // Use SIMD-optimized conversion where possible
-                const size_t simdSamples = samples & ~7;  // Process 8 samples at a time
-
-#ifdef VRB_USE_AVX2
-                const __m256 scale = _mm256_set1_ps(1.0f / 2147483648.0f);
-                for (size_t i = 0; i < simdSamples; i += 8) {
-                    __m256i int32_data = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&input32[i]));
-                    __m256 float_data = _mm256_cvtepi32_ps(int32_data);
-                    __m256 scaled_data = _mm256_mul_ps(float_data, scale);
-                    _mm256_storeu_ps(&output[i], scaled_data);
-                }
-#else
-                // Fallback scalar conversion
-                for (size_t i = 0; i < simdSamples; ++i) {
-                    output[i] = static_cast<float>(input32[i]) / 2147483648.0f;
-                }
-#endif
-                // Handle remaining samples
-                for (size_t i = simdSamples; i < samples; ++i) {
-                    output[i] = static_cast<float>(input32[i]) / 2147483648.0f;
-                }
+            case AudioFormat::Int32:
+                simd::convertInt32ToFloat(static_cast<const int32_t*>(input), output, samples);
                 break;
-            }
-            case AudioFormat::Int24: {
-                const uint8_t* input24 = static_cast<const uint8_t*>(input);
-                for (size_t i = 0; i < samples; ++i) {
-                    // Properly handle 24-bit signed integer conversion
-                    int32_t sample = (static_cast<int32_t>(input24[i*3]) << 8) |
-                                   (static_cast<int32_t>(input24[i*3+1]) << 16) |
-                                   (static_cast<int32_t>(input24[i*3+2]) << 24);
-
-                    // Sign extend from 24-bit to 32-bit
-                    if (sample & 0x80000000) {
-                        sample |= 0xFF000000;
-                    }
-
-                    output[i] = static_cast<float>(sample) / 2147483648.0f;
-                }
+            case AudioFormat::Int24:
+                simd::convertInt24ToFloat(static_cast<const uint8_t*>(input), output, samples);
                 break;
-            }
             default:
                 LOG_ERROR("Unsupported input audio format: {}", static_cast<int>(inputFormat));
                 std::fill(output, output + samples, 0.0f);
@@ -1490,56 +2152,23 @@ void AudioEngine::ConvertAudioFormat(const float* input, void* output, size_t fr
                 break;
             }
             case AudioFormat::Int16:
-                simd::convertFloatToInt16(input, static_cast<int16_t*>(output), samples);
-                break;
-            case AudioFormat::Int32: {
-                int32_t* output32 = static_cast<int32_t*>(output);
-                const size_t simdSamples = samples & ~7;
-
-#ifdef VRB_USE_AVX2
-                const __m256 scale = _mm256_set1_ps(2147483647.0f);
-                const __m256 min_val = _mm256_set1_ps(-2147483648.0f);
-                const __m256 max_val = _mm256_set1_ps(2147483647.0f);
-
-                for (size_t i = 0; i < simdSamples; i += 8) {
-                    __m256 float_data = _mm256_loadu_ps(&input[i]);
-
-                    // Scale and clamp
-                    float_data = _mm256_mul_ps(float_data, scale);
-                    float_data = _mm256_max_ps(_mm256_min_ps(float_data, max_val), min_val);
-
-                    // Convert to int32
-                    __m256i int32_data = _mm256_cvtps_epi32(float_data);
-                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(&output32[i]), int32_data);
-                }
-#else
-                for (size_t i = 0; i < simdSamples; ++i) {
-                    float scaled = input[i] * 2147483647.0f;
-                    output32[i] = static_cast<int32_t>(std::clamp(scaled, -2147483648.0f, 2147483647.0f));
-                }
-#endif
-                // Handle remaining samples
-                for (size_t i = simdSamples; i < samples; ++i) {
-                    float scaled = input[i] * 2147483647.0f;
-                    output32[i] = static_cast<int32_t>(std::clamp(scaled, -2147483648.0f, 2147483647.0f));
+                if (m_outputDither) {
+                    simd::convertFloatToInt16Dithered(input, static_cast<int16_t*>(output), samples, m_ditherState);
+                } else {
+                    simd::convertFloatToInt16(input, static_cast<int16_t*>(output), samples);
                 }
                 break;
-            }
-            case AudioFormat::Int24: {
-                uint8_t* output24 = static_cast<uint8_t*>(output);
-                for (size_t i = 0; i < samples; ++i) {
-                    // Clamp input to valid range first
-                    float clampedInput = std::clamp(input[i], -1.0f, 1.0f);
-                    float scaled = clampedInput * 8388607.0f;  // 2^23 - 1
-                    int32_t sample = static_cast<int32_t>(std::clamp(scaled, -8388608.0f, 8388607.0f));
-
-                    // Pack 24-bit value (little-endian)
-                    output24[i*3] = sample & 0xFF;
-                    output24[i*3+1] = (sample >> 8) & 0xFF;
-                    output24[i*3+2] = (sample >> 16) & 0xFF;
+            case AudioFormat::Int32:
+                // 32-bit integer output carries more precision than the float mix, so it is never dithered
+                simd::convertFloatToInt32(input, static_cast<int32_t*>(output), samples);
+                break;
+            case AudioFormat::Int24:
+                if (m_outputDither) {
+                    simd::convertFloatToInt24Dithered(input, static_cast<uint8_t*>(output), samples, m_ditherState);
+                } else {
+                    simd::convertFloatToInt24(input, static_cast<uint8_t*>(output), samples);
                 }
                 break;
-            }
             default:
                 LOG_ERROR("Unsupported output audio format: {}", static_cast<int>(outputFormat));
                 std::memset(output, 0, samples * audio_utils::GetSampleSize(outputFormat));
@@ -1551,172 +2180,34 @@ void AudioEngine::ConvertAudioFormat(const float* input, void* output, size_t fr
     }
 }
 
-bool AudioEngine::ApplySampleRateConversion(const float* input, float* output,
-                                          size_t inputFrames, size_t outputFrames) {
-    if (!input || !output || inputFrames == 0 || outputFrames == 0) {
-        LOG_ERROR("Invalid parameters for sample rate conversion");
-        return false;
-    }
-
-    if (!m_srcState->initialized) {
-        m_srcState->ratio = static_cast<double>(m_targetSampleRate) / m_sampleRate;
-        m_srcState->initialized = true;
-
-        // Initialize history buffer for better interpolation
-        m_srcState->history.resize(256 * m_inputChannels, 0.0f);
-        m_srcState->historyIndex = 0;
-
-        LOG_INFO("Sample rate conversion initialized: {}Hz -> {}Hz (ratio: {:.4f})",
-                 m_sampleRate, m_targetSampleRate, m_srcState->ratio);
-    }
-
-    // Check if conversion is actually needed
-    if (std::abs(m_srcState->ratio - 1.0) < 0.001) {
-        // Essentially no conversion needed - direct copy
-        if (inputFrames == outputFrames) {
-            std::memcpy(output, input, inputFrames * m_inputChannels * sizeof(float));
-            return true;
-        }
-    }
+void AudioEngine::ConfigureSampleRateConversion() {
+    const size_t blockFrames = static_cast<size_t>(m_bufferSize);
+    m_srcReturnFrames = 0;
 
-    try {
-        // Use improved interpolation algorithm based on the conversion ratio
-        if (m_srcState->ratio > 1.5 || m_srcState->ratio < 0.67) {
-            // Significant rate change - use high-quality polyphase interpolation
-            return ApplyPolyphaseInterpolation(input, output, inputFrames, outputFrames);
-        } else {
-            // Moderate rate change - use optimized linear interpolation
-            return ApplyLinearInterpolation(input, output, inputFrames, outputFrames);
-        }
-    } catch (const std::exception& e) {
-        LOG_ERROR("Sample rate conversion error: {}", e.what());
-        // Fallback to simple copy/repeat strategy
-        if (m_srcState->ratio >= 1.0) {
-            // Upsampling - repeat samples
-            for (size_t i = 0; i < outputFrames; ++i) {
-                size_t srcIdx = std::min(static_cast<size_t>(i / m_srcState->ratio), inputFrames - 1);
-                for (int ch = 0; ch < m_inputChannels; ++ch) {
-                    output[i * m_inputChannels + ch] = input[srcIdx * m_inputChannels + ch];
-                }
-            }
-        } else {
-            // Downsampling - skip samples
-            for (size_t i = 0; i < outputFrames; ++i) {
-                size_t srcIdx = static_cast<size_t>(i * (1.0 / m_srcState->ratio));
-                if (srcIdx < inputFrames) {
-                    for (int ch = 0; ch < m_inputChannels; ++ch) {
-                        output[i * m_inputChannels + ch] = input[srcIdx * m_inputChannels + ch];
-                    }
-                } else {
-                    for (int ch = 0; ch < m_inputChannels; ++ch) {
-                        output[i * m_inputChannels + ch] = 0.0f;
-                    }
-                }
-            }
-        }
-        return false;
+    if (!m_captureConverter.Configure(m_sampleRate, m_targetSampleRate, m_inputChannels, blockFrames,
+                                      m_resamplerQuality)) {
+        LOG_ERROR("Cannot convert {}Hz to {}Hz (more than {} filter phases); processing at the device rate",
+                  m_sampleRate, m_targetSampleRate, SampleRateConverter::MAX_PHASES);
+        m_captureConverter.Configure(m_sampleRate, m_sampleRate, m_inputChannels, blockFrames);
     }
-}
-
-bool AudioEngine::ApplyLinearInterpolation(const float* input, float* output,
-                                         size_t inputFrames, size_t outputFrames) {
-    const double step = 1.0 / m_srcState->ratio;
-    double position = 0.0;
-
-    for (size_t i = 0; i < outputFrames; ++i) {
-        const size_t idx = static_cast<size_t>(position);
-        const double frac = position - idx;
-
-        if (idx + 1 < inputFrames) {
-            // Normal case - interpolate between two samples
-            for (int ch = 0; ch < m_inputChannels; ++ch) {
-                const float sample1 = input[idx * m_inputChannels + ch];
-                const float sample2 = input[(idx + 1) * m_inputChannels + ch];
-                output[i * m_inputChannels + ch] = sample1 + frac * (sample2 - sample1);
-            }
-        } else if (idx < inputFrames) {
-            // At the end - use last sample
-            for (int ch = 0; ch < m_inputChannels; ++ch) {
-                output[i * m_inputChannels + ch] = input[idx * m_inputChannels + ch];
-            }
-        } else {
-            // Beyond input - output silence
-            for (int ch = 0; ch < m_inputChannels; ++ch) {
-                output[i * m_inputChannels + ch] = 0.0f;
-            }
-        }
-
-        position += step;
+    if (m_captureConverter.IsPassthrough()) {
+        return;
     }
 
-    return true;
-}
-
-bool AudioEngine::ApplyPolyphaseInterpolation(const float* input, float* output,
-                                            size_t inputFrames, size_t outputFrames) {
-    // Simple polyphase implementation using a small FIR filter
-    constexpr int FILTER_LENGTH = 8;
-    constexpr float FILTER_COEFFS[FILTER_LENGTH] = {
-        -0.015625f, 0.0625f, -0.234375f, 0.734375f,
-         0.734375f, -0.234375f, 0.0625f, -0.015625f
-    };
-
-    const double step = 1.0 / m_srcState->ratio;
-    double position = 0.0;
-
-    // Combine input with history for seamless processing
-    std::vector<float> extendedInput(m_srcState->history.size() + inputFrames * m_inputChannels);
-    std::memcpy(extendedInput.data(), m_srcState->history.data(), m_srcState->history.size() * sizeof(float));
-    std::memcpy(extendedInput.data() + m_srcState->history.size(), input, inputFrames * m_inputChannels * sizeof(float));
-
-    const size_t historyFrames = m_srcState->history.size() / m_inputChannels;
-
-    for (size_t i = 0; i < outputFrames; ++i) {
-        const double actualPos = position + historyFrames;
-        const size_t centerIdx = static_cast<size_t>(actualPos);
-        const double frac = actualPos - centerIdx;
-
-        for (int ch = 0; ch < m_inputChannels; ++ch) {
-            float result = 0.0f;
-
-            // Apply polyphase filter
-            for (int j = 0; j < FILTER_LENGTH; ++j) {
-                const int sampleIdx = static_cast<int>(centerIdx) - FILTER_LENGTH/2 + j;
-                if (sampleIdx >= 0 && sampleIdx < static_cast<int>(extendedInput.size() / m_inputChannels)) {
-                    // Interpolate filter coefficient based on fractional position
-                    float coeff = FILTER_COEFFS[j];
-                    if (j > 0 && j < FILTER_LENGTH - 1) {
-                        const float prevCoeff = FILTER_COEFFS[j-1];
-                        const float nextCoeff = FILTER_COEFFS[j+1];
-                        coeff += frac * (nextCoeff - prevCoeff) * 0.5f;
-                    }
-
-                    result += extendedInput[sampleIdx * m_inputChannels + ch] * coeff;
-                }
-            }
-
-            output[i * m_inputChannels + ch] = result;
-        }
-
-        position += step;
-    }
+    const size_t processingFrames = m_captureConverter.GetMaxOutputFrames(blockFrames);
+    m_renderConverter.Configure(m_targetSampleRate, m_sampleRate, 2, processingFrames, m_resamplerQuality);
+    m_srcCapture.assign(processingFrames * m_inputChannels, 0.0f);
+    m_srcRender.assign(processingFrames * 2, 0.0f);
 
-    // Update history buffer with recent input
-    const size_t historySize = m_srcState->history.size();
-    if (inputFrames * m_inputChannels >= historySize) {
-        // Use last part of input as new history
-        std::memcpy(m_srcState->history.data(),
-                   input + (inputFrames * m_inputChannels - historySize),
-                   historySize * sizeof(float));
-    } else {
-        // Shift existing history and append new input
-        const size_t shiftSize = historySize - inputFrames * m_inputChannels;
-        std::memmove(m_srcState->history.data(), m_srcState->history.data() + inputFrames * m_inputChannels,
-                    shiftSize * sizeof(float));
-        std::memcpy(m_srcState->history.data() + shiftSize, input, inputFrames * m_inputChannels * sizeof(float));
-    }
+    // A few frames of slack absorb the per-block wobble of both converters
+    m_srcReturnFrames = SRC_RETURN_SLACK_FRAMES;
+    m_srcReturn.assign((SRC_RETURN_SLACK_FRAMES + blockFrames + m_renderConverter.GetMaxOutputFrames(processingFrames)) * 2,
+                       0.0f);
 
-    return true;
+    LOG_INFO("Sample rate conversion: {}Hz <-> {}Hz ({}/{}, {} taps per phase, {} quality, {:.2f}ms added latency)",
+             m_sampleRate, m_targetSampleRate, m_captureConverter.GetUpFactor(), m_captureConverter.GetDownFactor(),
+             m_captureConverter.GetTapsPerPhase(), ResamplerQualityName(m_resamplerQuality),
+             1000.0 * GetResamplerLatency());
 }
 
 bool AudioEngine::SetupPlatformOptimizations() {
@@ -1944,6 +2435,7 @@ bool AudioEngine::SetupRealtimePriority() {
 
 void AudioEngine::MonitorPerformance() {
     LOG_DEBUG("Performance monitoring thread started");
+    int64_t reportedMisses = 0;
 
     while (m_monitorRunning) {
         std::this_thread::sleep_for(std::chrono::seconds(1));
@@ -1956,9 +2448,16 @@ void AudioEngine::MonitorPerformance() {
                 LOG_WARN("High CPU load: {:.1f}%", stats.cpuLoad * 100.0f);
             }
 
-            if (stats.callbackDuration.count() > MAX_CALLBACK_TIME_MS * 500) { // 50% of limit
-                LOG_WARN("Long callback duration: {:.2f}ms", stats.callbackDuration.count() / 1000.0);
+            if (stats.callbackP99.count() > MAX_CALLBACK_TIME_MS * 500) { // 50% of limit
+                LOG_WARN("Long callback duration: p99 {:.2f}ms, max {:.2f}ms",
+                         stats.callbackP99.count() / 1000.0f, stats.callbackMax.count() / 1000.0f);
+            }
+
+            if (stats.deadlineMisses > reportedMisses) {
+                LOG_WARN("{} callbacks overran their block deadline (p99.9 {:.0f}us, max {:.0f}us)",
+                         stats.deadlineMisses - reportedMisses, stats.callbackP999.count(), stats.callbackMax.count());
             }
+            reportedMisses = stats.deadlineMisses;
 
             // Periodic statistics logging
             static int logCounter = 0;
@@ -1967,6 +2466,10 @@ void AudioEngine::MonitorPerformance() {
                          stats.cpuLoad * 100.0f,
                          (stats.inputLatency + stats.outputLatency) * 1000.0,
                          stats.underruns, stats.overruns);
+                LOG_DEBUG("Callback - p50 {:.0f}us, p90 {:.0f}us, p99 {:.0f}us, p99.9 {:.0f}us, max {:.0f}us; "
+                          "deadline margin p1 {:.0f}us",
+                          stats.callbackP50.count(), stats.callbackP90.count(), stats.callbackP99.count(),
+                          stats.callbackP999.count(), stats.callbackMax.count(), stats.deadlineMarginP1.count());
                 logCounter = 0;
             }
         }
@@ -2045,13 +2548,13 @@ void AudioEngine::HandleAudioError(PaError error) {
 
         case paInvalidSampleRate: {
             LOG_WARN("Invalid sample rate, attempting fallback");
+            std::lock_guard<std::mutex> probeLock(m_deviceProbeMutex);
             // Try common fallback sample rates
             std::vector<int> fallbackRates = {44100, 48000, 96000, 88200};
             for (int rate : fallbackRates) {
                 if (rate != m_sampleRate && audio_utils::IsSampleRateSupported(m_inputDevice, rate)) {
                     LOG_INFO("Falling back to sample rate: {}Hz", rate);
                     m_sampleRate = rate;
-                    m_targetSampleRate = rate;
                     break;
                 }
             }
@@ -2070,7 +2573,6 @@ void AudioEngine::HandleAudioError(PaError error) {
                 // Reset to safe defaults
                 m_bufferSize = std::max(m_bufferSize * 2, 256);  // Increase buffer size for stability
                 m_sampleRate = 48000;
-                m_targetSampleRate = 48000;
 
                 if (Start()) {
                     LOG_INFO("Emergency restart successful");
@@ -2095,145 +2597,6 @@ void AudioEngine::HandleAudioError(PaError error) {
     }
 }
 
-void AudioEngine::AdjustBufferSize() {
-    if (!m_adaptiveBuffering || !m_running) {
-        return;
-    }
-
-    // Get current performance metrics
-    AudioStats stats = GetStats();
-    int currentUnderruns = m_underruns.load();
-    int currentOverruns = m_overruns.load();
-    int bufferUnderruns = m_bufferUnderruns.load();
-    int bufferOverruns = m_bufferOverruns.load();
-    float cpuLoad = stats.cpuLoad;
-
-    // Calculate total problem indicators
-    int totalProblems = currentUnderruns + currentOverruns + bufferUnderruns + bufferOverruns;
-
-    // Don't adjust if we haven't had enough problems to warrant a change
-    if (totalProblems < ADAPTIVE_BUFFER_THRESHOLD) {
-        return;
-    }
-
-    int newBufferSize = m_bufferSize;
-    bool needsRestart = false;
-
-    // Analyze the problem patterns to determine optimal buffer size
-    if (currentUnderruns > currentOverruns || bufferUnderruns > bufferOverruns) {
-        // More underruns than overruns - increase buffer size for stability
-        if (cpuLoad > 0.8f) {
-            // High CPU load - be more aggressive with buffer increase
-            newBufferSize = std::min(MAX_BUFFER_SIZE, m_bufferSize * 3 / 2);
-        } else {
-            // Normal CPU load - modest increase
-            newBufferSize = std::min(MAX_BUFFER_SIZE, m_bufferSize + 32);
-        }
-
-        LOG_INFO("Buffer underruns detected, increasing buffer size for stability");
-    }
-    else if (currentOverruns > currentUnderruns && m_bufferSize > MIN_BUFFER_SIZE) {
-        // More overruns than underruns - try to reduce latency
-        if (cpuLoad < 0.5f && stats.callbackDuration.count() < MAX_CALLBACK_TIME_MS * 300) {
-            // Low CPU load and good callback performance - can afford smaller buffer
-            newBufferSize = std::max(MIN_BUFFER_SIZE, m_bufferSize - 16);
-        } else {
-            // Don't reduce buffer if CPU is stressed
-            LOG_DEBUG("Overruns detected but CPU load too high to reduce buffer size");
-            return;
-        }
-
-        LOG_INFO("Buffer overruns detected, attempting to reduce latency");
-    }
-    else {
-        // Equal problems or other issues - use ring buffer status to decide
-        size_t inputAvailable = m_inputBuffer->available();
-        size_t outputAvailable = m_outputBuffer->available();
-        size_t inputCapacity = m_inputBuffer->capacity();
-        size_t outputCapacity = m_outputBuffer->capacity();
-
-        // Check ring buffer utilization
-        float inputUtilization = static_cast<float>(inputAvailable) / inputCapacity;
-        float outputUtilization = static_cast<float>(outputAvailable) / outputCapacity;
-
-        if (inputUtilization > 0.8f || outputUtilization > 0.8f) {
-            // Ring buffers are getting full - increase audio buffer size
-            newBufferSize = std::min(MAX_BUFFER_SIZE, m_bufferSize + 64);
-            LOG_INFO("Ring buffers near capacity, increasing audio buffer size");
-        } else if (inputUtilization < 0.2f && outputUtilization < 0.2f && cpuLoad < 0.6f) {
-            // Ring buffers underutilized and CPU not stressed - can reduce buffer
-            newBufferSize = std::max(MIN_BUFFER_SIZE, m_bufferSize - 32);
-            LOG_INFO("Ring buffers underutilized, reducing audio buffer size");
-        }
-    }
-
-    // Validate the new buffer size is reasonable
-    if (newBufferSize != m_bufferSize) {
-        // Check if the new size is a power of 2 (preferred for some audio drivers)
-        int roundedSize = 1;
-        while (roundedSize < newBufferSize) {
-            roundedSize *= 2;
-        }
-
-        // If the rounded size is close to our target, use it
-        if (std::abs(roundedSize - newBufferSize) <= 16) {
-            newBufferSize = roundedSize;
-        }
-
-        // Ensure we don't change too drastically
-        int maxChange = m_bufferSize / 2;
-        if (newBufferSize > m_bufferSize + maxChange) {
-            newBufferSize = m_bufferSize + maxChange;
-        } else if (newBufferSize < m_bufferSize - maxChange) {
-            newBufferSize = m_bufferSize - maxChange;
-        }
-
-        LOG_INFO("Adaptive buffer size adjustment: {} → {} samples (underruns: {}, overruns: {}, CPU: {:.1f}%)",
-                 m_bufferSize, newBufferSize, currentUnderruns, currentOverruns, cpuLoad * 100.0f);
-
-        // Actually apply the buffer size change
-        // Note: This requires a stream restart in most audio APIs
-        if (m_running) {
-            LOG_INFO("Restarting stream for buffer size change");
-
-            // Save current state
-            bool wasRunning = m_running;
-            Stop();
-
-            // Update buffer size
-            m_bufferSize = newBufferSize;
-
-            // Resize internal buffers accordingly
-            m_conversionBufferInput.resize(m_bufferSize * 8);
-            m_conversionBufferOutput.resize(m_bufferSize * 8);
-            m_resampleBuffer.resize(m_bufferSize * 4);
-
-            // Clear ring buffers to prevent stale data
-            m_inputBuffer->reset();
-            m_outputBuffer->reset();
-            m_processingBuffer->reset();
-
-            // Reset statistics for clean measurement
-            ResetStats();
-
-            // Restart if it was running
-            if (wasRunning) {
-                if (!Start()) {
-                    LOG_ERROR("Failed to restart stream after buffer size change");
-                    // Try to revert to original buffer size
-                    m_bufferSize = m_bufferSize == newBufferSize ? DEFAULT_BUFFER_SIZE : m_bufferSize;
-                    if (!Start()) {
-                        LOG_ERROR("Failed to restart stream with original buffer size");
-                    }
-                }
-            }
-        } else {
-            // Just update the buffer size for next start
-            m_bufferSize = newBufferSize;
-        }
-    }
-}
-
 // ===== MOCK BACKEND IMPLEMENTATION =====
 // This is the brilliant creative solution to the WSL2 problem!
 
@@ -2285,6 +2648,20 @@ bool AudioEngine::CreateVirtualAudioDevice() {
         return true;
     }
 
+    // The JACK client's output ports already are the device; nothing to load into a sound server
+    if (m_jackBackend) {
+        const auto ports = m_jack.GetOutputPorts();
+        LOG_INFO("Virtual audio device is the JACK client '{}' ({})", m_jack.GetClientName(),
+                 ports.empty() ? std::string() : ports.front() + ", " + ports.back());
+        return true;
+    }
+
+    // Consumers read the shared segment directly; no sound server sink to spawn
+    if (m_sharedOutputEnabled) {
+        LOG_INFO("Virtual audio device not created: audio.sharedOutput publishes to '{}'", m_sharedOutputName);
+        return false;
+    }
+
 #ifdef __linux__
     // For Linux, create a PulseAudio null sink that appears as a virtual output device
     std::string deviceName = m_virtualOutputName;
@@ -2391,6 +2768,62 @@ bool AudioEngine::RemoveVirtualAudioDevice() {
     return true;
 }
 
+bool AudioEngine::InitializeJackBackend(const Config& config) {
+    JackBackendOptions options;
+    options.clientName = config.GetJackClientName().empty() ? config.GetVirtualOutputName() : config.GetJackClientName();
+    options.inputChannels = std::clamp(config.GetInputChannels(), 1, JackBackend::MAX_INPUTS);
+    options.connectInputs = config.GetJackConnectInputs();
+    options.connectOutputs = config.GetJackConnectOutputs();
+
+    std::string error;
+    if (!m_jack.Open(options, &AudioEngine::JackProcess, this, error)) {
+        LOG_INFO("JACK backend not used: {}", error);
+        return false;
+    }
+    m_jackBackend = true;
+
+    // The server owns the clock: its rate and period replace audio.sampleRate and audio.bufferSize
+    m_sampleRate = m_jack.GetSampleRate();
+    m_targetSampleRate = m_sampleRate;
+    m_bufferSize = static_cast<int>(std::clamp(m_jack.GetBufferSize(), static_cast<size_t>(MIN_BUFFER_SIZE),
+                                               static_cast<size_t>(MAX_BUFFER_SIZE)));
+    m_inputChannels = m_jack.GetInputChannels();
+    m_outputChannels = 2;
+    m_inputFormat = AudioFormat::Float32;
+    m_outputFormat = AudioFormat::Float32;
+    m_preferredHostAPI = HostAPI::Jack;
+    m_virtualOutputName = m_jack.GetClientName();
+    m_inputDeviceName = m_jack.GetClientName();
+    m_outputDeviceName = m_jack.GetClientName();
+    m_inputDevice = 0;
+    m_outputDevice = 0;
+    m_adaptiveBuffering = false;    // The period is the server's to change
+
+    if (m_pipelineMode == PipelineMode::Worker || config.GetProcessingSampleRate() != config.GetSampleRate()) {
+        LOG_WARN("JACK backend renders inline at the server rate; audio.pipeline mode and sampleRate are ignored");
+    }
+    m_pipelineMode = PipelineMode::Inline;
+
+    // Rings are unused by the process callback but kept for GetStats and the pipeline helpers;
+    // the conversion buffers stage interleaved blocks for the recorder
+    size_t bufferSize = std::max(RING_BUFFER_SIZE, MAX_BUFFER_SIZE * 8);
+    m_inputBuffer = std::make_unique<RingBuffer<float>>(bufferSize * m_inputChannels);
+    m_outputBuffer = std::make_unique<RingBuffer<float>>(bufferSize * m_outputChannels);
+    m_conversionBufferInput.resize(MAX_BUFFER_SIZE * 8);
+    m_conversionBufferOutput.resize(MAX_BUFFER_SIZE * 8);
+    m_resampleBuffer.resize(MAX_BUFFER_SIZE * 4);
+
+    CreateVirtualAudioDevice();
+
+    m_monitorRunning = true;
+    m_monitorThread = std::thread([this] { MonitorPerformance(); });
+
+    m_initialized = true;
+    LOG_INFO("Audio engine initialized on JACK - SR: {}Hz, Period: {} frames, Client: '{}'",
+             m_sampleRate, m_jack.GetBufferSize(), m_jack.GetClientName());
+    return true;
+}
+
 bool AudioEngine::InitializeMockBackend() {
     m_mockBackend = true;
 
@@ -2463,7 +2896,6 @@ bool AudioEngine::InitializeMockBackend() {
     size_t bufferSize = std::max(RING_BUFFER_SIZE, m_bufferSize * 8);
     m_inputBuffer = std::make_unique<RingBuffer<float>>(bufferSize * m_inputChannels);
     m_outputBuffer = std::make_unique<RingBuffer<float>>(bufferSize * m_outputChannels);
-    m_processingBuffer = std::make_unique<RingBuffer<float>>(bufferSize * m_outputChannels);
 
     // Initialize conversion buffers
     m_conversionBufferInput.resize(m_bufferSize * 8);
@@ -2479,102 +2911,121 @@ bool AudioEngine::InitializeMockBackend() {
 
 void AudioEngine::MockProcessingLoop() {
     LOG_DEBUG("Mock processing thread started");
-
-    // Calculate timing for realistic callback simulation
-    const auto frameDuration = std::chrono::microseconds(
-        static_cast<int64_t>((m_bufferSize * 1000000.0) / m_sampleRate));
-
-    auto nextCallbackTime = std::chrono::steady_clock::now();
+    rtlog::RegisterThread("audio");
+
+    // The simulated device supplies the callbacks' timing and the capture signal
+    SimulatedDeviceOptions options = m_simulationOptions;
+    options.sampleRate = m_sampleRate;
+    options.blockFrames = static_cast<size_t>(m_bufferSize);
+    options.inputChannels = m_inputChannels;
+    m_simulatedDevice.Reset(options);
+    const bool freeRunning = options.clock == SimulatedClock::Free;
+    const auto origin = m_simulatedDevice.GetOrigin();
+    const auto period = m_simulatedDevice.GetPeriod();
 
     std::vector<float> mockInput(m_bufferSize * m_inputChannels);
     std::vector<float> mockOutput(m_bufferSize * m_outputChannels);
 
-    while (m_mockProcessingRunning) {
-        auto now = std::chrono::steady_clock::now();
+    while (m_mockProcessingRunning && !m_simulatedDevice.Finished()) {
+        const SimulatedCallback callback = m_simulatedDevice.Next();
+        m_simulatedDevice.WaitFor(callback);
 
-        if (now >= nextCallbackTime) {
-            auto callbackStart = std::chrono::steady_clock::now();
-
-            // Generate realistic mock input signal (low level noise + occasional signals)
-            for (size_t i = 0; i < mockInput.size(); ++i) {
-                // Add some variety - sine waves and noise for testing
-                float time = static_cast<float>(m_framesProcessed + i / m_inputChannels) / m_sampleRate;
-                float signal = 0.0f;
-
-                // Occasional test tones for variety (makes tests more interesting!)
-                if (static_cast<int>(time * 2) % 5 == 0) {
-                    signal = 0.1f * std::sin(2.0f * M_PI * 440.0f * time);  // 440Hz tone
+        if (callback.dropped) {
+            // The period never reached the engine: its capture is lost and the device played silence
+            m_overruns++;
+            RT_LOG_WARN("Simulated device dropped period {} (count: {})", callback.block, m_overruns.load());
+            continue;
+        }
+        if (callback.lateness >= period) {
+            // Arrived after its own deadline: the device ran dry waiting for it
+            m_underruns++;
+            RT_LOG_WARN("Simulated callback {} arrived {}us late (count: {})", callback.block,
+                        std::chrono::duration_cast<std::chrono::microseconds>(callback.lateness).count(),
+                        m_underruns.load());
+        }
+
+        const bool lockstep = freeRunning && m_pipelineMode == PipelineMode::Worker;
+        if (lockstep) {
+            // Virtual time stands still while the worker catches up, so every block finds the same queue
+            std::unique_lock<std::mutex> lock(m_lockstepMutex);
+            while (!m_lockstepCondition.wait_for(lock, std::chrono::milliseconds(10), [&] {
+                return m_dspBlocksRendered.load(std::memory_order_acquire) >= m_pipelineBlocksQueued ||
+                       m_outputBuffer->free() < mockOutput.size() || !m_dspRunning.load(std::memory_order_acquire);
+            })) {
+                if (!m_mockProcessingRunning) {
+                    break;
                 }
+            }
+        }
 
-                // Add some gentle noise
-                signal += 0.001f * (static_cast<float>(rand()) / RAND_MAX - 0.5f);
+        auto callbackStart = std::chrono::steady_clock::now();
+        m_simulatedDevice.GenerateInput(mockInput.data());
 
-                mockInput[i] = signal;
-            }
+        // Update peak input level with realistic values
+        float inputPeak = simd::calculatePeak(mockInput.data(), mockInput.size());
+        float currentInputPeak = m_peakInputLevel.load();
+        m_peakInputLevel = std::max(inputPeak, currentInputPeak * PEAK_DECAY_RATE);
 
-            // Update peak input level with realistic values
-            float inputPeak = simd::calculatePeakLevel(mockInput.data(), mockInput.size());
-            float currentInputPeak = m_peakInputLevel.load();
-            m_peakInputLevel = std::max(inputPeak, currentInputPeak * PEAK_DECAY_RATE);
+        const auto outputStageStart = std::chrono::steady_clock::now();
+        m_inputStage.Record(outputStageStart - callbackStart);
+        std::chrono::steady_clock::duration dspElapsed{0};
 
+        if (m_pipelineMode == PipelineMode::Worker) {
+            // Same hand-off as the device callback; the DSP worker renders
+            if (ExchangePipelineBlock(mockInput.data(), mockOutput.data(), m_bufferSize,
+                                      origin + callback.slot + callback.lateness)) {
+                m_framesProcessed += m_bufferSize;
+            }
+            if (lockstep) {
+                { std::lock_guard<std::mutex> lock(m_lockstepMutex); }
+                m_lockstepCondition.notify_all();
+            }
+        } else if (m_hrtf) {
             // Process through HRTF if available (this is the real magic!)
-            if (m_hrtf) {
-                m_hrtf->Process(mockInput.data(), mockOutput.data(), m_bufferSize, m_inputChannels);
-            } else {
-                // Simple mono->stereo fallback for testing
-                for (size_t i = 0; i < m_bufferSize; ++i) {
-                    float mono = (m_inputChannels == 1) ? mockInput[i] :
-                                (mockInput[i * 2] + mockInput[i * 2 + 1]) * 0.5f;
-                    mockOutput[i * 2] = mono * 0.7f;      // Left with slight attenuation
-                    mockOutput[i * 2 + 1] = mono * 0.6f;  // Right with more attenuation
-                }
+            dspElapsed = RenderBlock(mockInput.data(), mockOutput.data(), m_bufferSize);
+        } else {
+            // Simple mono->stereo fallback for testing
+            for (size_t i = 0; i < m_bufferSize; ++i) {
+                float mono = (m_inputChannels == 1) ? mockInput[i] :
+                            (mockInput[i * 2] + mockInput[i * 2 + 1]) * 0.5f;
+                mockOutput[i * 2] = mono * 0.7f;      // Left with slight attenuation
+                mockOutput[i * 2 + 1] = mono * 0.6f;  // Right with more attenuation
             }
+        }
 
-            // Update peak output level
-            float outputPeak = simd::calculatePeakLevel(mockOutput.data(), mockOutput.size());
-            float currentOutputPeak = m_peakOutputLevel.load();
-            m_peakOutputLevel = std::max(outputPeak, currentOutputPeak * PEAK_DECAY_RATE);
+        // Update peak output level
+        float outputPeak = simd::calculatePeak(mockOutput.data(), mockOutput.size());
+        float currentOutputPeak = m_peakOutputLevel.load();
+        m_peakOutputLevel = std::max(outputPeak, currentOutputPeak * PEAK_DECAY_RATE);
+        m_recording.PushAudio(mockInput.data(), mockOutput.data(), m_bufferSize);
+        if (m_sharedOutput.IsOpen()) {
+            m_sharedOutput.Write(mockOutput.data(), m_bufferSize);
+        }
+        m_simulatedDevice.ConsumeOutput(mockOutput.data(), mockOutput.size());
+        m_streamFrames.fetch_add(m_bufferSize, std::memory_order_relaxed);
 
+        if (m_pipelineMode == PipelineMode::Inline) {
             // Update statistics to make tests happy
             m_framesProcessed += m_bufferSize;
 
             // Store processed audio in buffers (for GetStats verification)
             m_inputBuffer->write(mockInput.data(), mockInput.size());
             m_outputBuffer->write(mockOutput.data(), mockOutput.size());
+        }
 
-            // Update timing statistics
-            auto callbackEnd = std::chrono::steady_clock::now();
-            auto duration = std::chrono::duration_cast<std::chrono::microseconds>(callbackEnd - callbackStart);
-
-            {
-                std::lock_guard<std::mutex> lock(m_perfMutex);
-                m_callbackHistory[m_callbackHistoryIndex] = duration;
-                m_callbackHistoryIndex = (m_callbackHistoryIndex + 1) % CALLBACK_HISTORY_SIZE;
-
-                if (duration > m_maxCallbackDuration) {
-                    m_maxCallbackDuration = duration;
-                }
-
-                auto sum = std::accumulate(m_callbackHistory.begin(), m_callbackHistory.end(),
-                                         std::chrono::microseconds(0));
-                m_avgCallbackDuration = sum / CALLBACK_HISTORY_SIZE;
-
-                m_lastCallbackTime = callbackStart;
-                m_mockLastProcessTime = callbackStart;
-            }
-
-            // Simulate realistic CPU load (very low for mock)
-            double callbackMs = duration.count() / 1000.0;
-            double expectedMs = (static_cast<double>(m_bufferSize) / m_sampleRate) * 1000.0;
-            m_cpuLoad = static_cast<float>(std::min(callbackMs / expectedMs, 0.1));  // Cap at 10%
+        // Timing on the virtual clock: the callback started at its slot plus its lateness and took the real work's time
+        auto callbackEnd = std::chrono::steady_clock::now();
+        m_outputStage.Record(callbackEnd - outputStageStart - dspElapsed);
+        const auto work = callbackEnd - callbackStart;
+        const auto slotStart = origin + callback.slot;
+        RecordCallbackTiming(slotStart, slotStart + callback.lateness + work, m_bufferSize);
+        m_mockLastProcessTime = callbackStart;
 
-            nextCallbackTime += frameDuration;
-        } else {
-            // Sleep for a short time to avoid busy waiting
-            std::this_thread::sleep_for(std::chrono::microseconds(100));
-        }
+        // Load against the device period, as the hardware callbacks measure it
+        m_cpuLoad = static_cast<float>(std::min(std::chrono::duration<double>(work) / period, 1.0));
     }
 
+    m_simulationDone.store(m_simulatedDevice.Finished(), std::memory_order_release);
     LOG_DEBUG("Mock processing thread stopped");
 }
 
@@ -2641,6 +3092,127 @@ namespace vrb::audio_utils {
         return err == paFormatIsSupported;
     }
 
+    AudioEngine::HostAPI HostAPIFromPA(int hostApiType) {
+        switch (hostApiType) {
+            case paASIO: return AudioEngine::HostAPI::ASIO;
+            case paWASAPI: return AudioEngine::HostAPI::WASAPI;
+            case paCoreAudio: return AudioEngine::HostAPI::CoreAudio;
+            case paALSA: return AudioEngine::HostAPI::ALSA;
+            case paJACK: return AudioEngine::HostAPI::Jack;
+            default: return AudioEngine::HostAPI::Default;
+        }
+    }
+
+    std::vector<DeviceCapabilities> ListDevices() {
+        std::vector<DeviceCapabilities> devices;
+        const int numDevices = Pa_GetDeviceCount();
+        for (int i = 0; i < numDevices; i++) {
+            const PaDeviceInfo* info = Pa_GetDeviceInfo(i);
+            if (!info) {
+                continue;
+            }
+            DeviceCapabilities device;
+            device.index = i;
+            device.name = info->name;
+            const PaHostApiInfo* hostInfo = Pa_GetHostApiInfo(info->hostApi);
+            device.hostApiType = hostInfo ? static_cast<int>(hostInfo->type) : -1;
+            device.maxInputChannels = info->maxInputChannels;
+            device.maxOutputChannels = info->maxOutputChannels;
+            device.defaultSampleRate = info->defaultSampleRate;
+            device.lowInputLatency = info->defaultLowInputLatency;
+            device.lowOutputLatency = info->defaultLowOutputLatency;
+            devices.push_back(device);
+        }
+        return devices;
+    }
+
+    void ProbeDevice(DeviceCapabilities& device, std::mutex& queryMutex) {
+        static const int testRates[] = {8000, 11025, 16000, 22050, 44100, 48000, 88200, 96000, 176400, 192000};
+        static const PaSampleFormat testFormats[] = {paFloat32, paInt32, paInt24, paInt16};
+
+        // Locked per query, so the engine's own queries never wait out a whole device
+        auto supported = [&queryMutex](const PaStreamParameters* input, const PaStreamParameters* output, double rate) {
+            std::lock_guard<std::mutex> lock(queryMutex);
+            return Pa_IsFormatSupported(input, output, rate) == paFormatIsSupported;
+        };
+
+        device.inputSampleRates.clear();
+        device.outputSampleRates.clear();
+        device.inputFormats = 0;
+
+        if (device.maxInputChannels > 0) {
+            PaStreamParameters params;
+            params.device = device.index;
+            params.channelCount = 1;
+            params.sampleFormat = paFloat32;
+            params.suggestedLatency = device.lowInputLatency;
+            params.hostApiSpecificStreamInfo = nullptr;
+            for (int rate : testRates) {
+                if (supported(&params, nullptr, rate)) {
+                    device.inputSampleRates.push_back(rate);
+                }
+            }
+            for (PaSampleFormat format : testFormats) {
+                params.sampleFormat = format;
+                if (supported(&params, nullptr, 48000)) {
+                    device.inputFormats |= static_cast<uint32_t>(format);
+                }
+            }
+        }
+
+        // Stereo float32 is what the binaural output opens
+        if (device.maxOutputChannels > 0) {
+            PaStreamParameters params;
+            params.device = device.index;
+            params.channelCount = std::min(2, device.maxOutputChannels);
+            params.sampleFormat = paFloat32;
+            params.suggestedLatency = device.lowOutputLatency;
+            params.hostApiSpecificStreamInfo = nullptr;
+            for (int rate : testRates) {
+                if (supported(nullptr, &params, rate)) {
+                    device.outputSampleRates.push_back(rate);
+                }
+            }
+        }
+    }
+
+    AudioEngine::DeviceInfo ToDeviceInfo(const DeviceCapabilities& device) {
+        AudioEngine::DeviceInfo info;
+        info.index = device.index;
+        info.name = device.name;
+        info.maxInputChannels = device.maxInputChannels;
+        info.maxOutputChannels = device.maxOutputChannels;
+        info.defaultSampleRate = device.defaultSampleRate;
+        info.lowInputLatency = device.lowInputLatency;
+        info.lowOutputLatency = device.lowOutputLatency;
+        info.hostAPI = HostAPIFromPA(device.hostApiType);
+
+        // Check for exclusive mode support
+        info.supportsExclusiveMode = (info.hostAPI == AudioEngine::HostAPI::WASAPI ||
+                                      info.hostAPI == AudioEngine::HostAPI::CoreAudio ||
+                                      info.hostAPI == AudioEngine::HostAPI::ASIO);
+
+        if (device.probed) {
+            // Capture devices report what capture supports; playback is only probed in float32
+            if (device.maxInputChannels > 0) {
+                info.supportedSampleRates = device.inputSampleRates;
+                for (PaSampleFormat format : {paFloat32, paInt32, paInt24, paInt16}) {
+                    if (device.inputFormats & static_cast<uint32_t>(format)) {
+                        info.supportedFormats.push_back(PAFormatToInternal(format));
+                    }
+                }
+            } else {
+                info.supportedSampleRates = device.outputSampleRates;
+                info.supportedFormats = {AudioEngine::AudioFormat::Float32};
+            }
+        } else {
+            // Not opened yet: what the driver reports as its default
+            info.supportedSampleRates = {static_cast<int>(std::lround(device.defaultSampleRate))};
+            info.supportedFormats = {AudioEngine::AudioFormat::Float32};
+        }
+        return info;
+    }
+
     int GetOptimalBufferSize(int deviceIndex, int targetLatencyMs) {
         const PaDeviceInfo* info = Pa_GetDeviceInfo(deviceIndex);
         if (!info) return DEFAULT_BUFFER_SIZE;
@@ -3,15 +3,7 @@
 
 #pragma once
 
-// SIMD support detection
-#if defined(__AVX2__) || (defined(_MSC_VER) && defined(__AVX2__))
-#define VRB_USE_AVX2 1
-#include <immintrin.h>
-#elif defined(__SSE2__) || (defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86_FP)))
-#define VRB_USE_SSE2 1
-#include <emmintrin.h>
-#endif
-
+#include <array>
 #include <atomic>
 #include <vector>
 #include <string>
@@ -39,9 +31,19 @@
 #include <mach/thread_policy.h>
 #endif
 
+#include "automation.h"
 #include "config.h"
+#include "device_catalog.h"
 #include "hrtf_processor.h"
+#include "jack_backend.h"
+#include "latency_controller.h"
+#include "recording_session.h"
+#include "latency_histogram.h"
 #include "ring_buffer.h"
+#include "sample_rate_converter.h"
+#include "shared_output.h"
+#include "simulated_device.h"
+#include "simd/simd_dispatch.h"
 
 namespace vrb {
 
@@ -71,6 +73,19 @@ public:
         Jack
     };
 
+    /**
+     * @brief Where HRTF processing runs relative to the device callback
+     *
+     * Inline renders each block inside the callback, so DSP cost lands on the
+     * device deadline. Worker leaves the callback with format conversion and
+     * ring I/O only; a dedicated real-time thread renders into the output ring
+     * and keeps a configurable number of blocks ready ahead of the device.
+     */
+    enum class PipelineMode {
+        Inline,
+        Worker
+    };
+
     struct DeviceInfo {
         int index;
         std::string name;
@@ -94,6 +109,8 @@ public:
         float cpuLoad;
         int xruns;
         std::chrono::steady_clock::time_point lastCallback;
+        double addedLatency;                    // Seconds of rendered audio queued ahead of the device (worker mode)
+        double targetLatency;                   // Depth the latency controller is steering that queue to
     };
 
     AudioEngine();
@@ -133,10 +150,20 @@ public:
 
     /**
      * @brief Get list of available input devices
+     *
+     * Served from the device catalog: rates and formats are those probed in
+     * the background or read from the capability cache, and a device not
+     * probed yet reports only its default rate in float32.
      * @return Vector of available input devices
      */
     std::vector<DeviceInfo> GetInputDevices() const;
 
+    /**
+     * @brief Wait for the background device probe started by Initialize
+     * @return true once every device the probe could reach has been probed
+     */
+    bool WaitForDeviceProbe(std::chrono::milliseconds timeout) const;
+
     /**
      * @brief Select input device by index
      * @param deviceIndex PortAudio device index
@@ -162,6 +189,66 @@ public:
      */
     bool IsMockBackend() const { return m_mockBackend; }
 
+    /**
+     * @brief Check if the engine runs as a native JACK client (audio.backend)
+     *
+     * Its "binaural_L"/"binaural_R" ports are then the virtual output device,
+     * and the capture comes from whatever is connected to its "in_N" ports.
+     */
+    bool IsJackBackend() const { return m_jackBackend; }
+
+    /**
+     * @brief Check if the binaural output is published to shared memory (audio.sharedOutput)
+     *
+     * Local processes attach a SharedOutputReader to GetSharedOutputName()
+     * instead of recording a PulseAudio sink; the segment is created on Start
+     * and stays up across restarts at the same sample rate.
+     */
+    bool IsSharedOutputOpen() const { return m_sharedOutput.IsOpen(); }
+    const std::string& GetSharedOutputName() const { return m_sharedOutput.GetName(); }
+
+    /**
+     * @brief Configure the mock backend's simulated device (takes effect on the next Start)
+     *
+     * audio.backend "simulated" selects the mock backend even where PortAudio
+     * works. On a free clock callbacks run back to back and wait for the DSP
+     * worker, so the output depends only on the seed; late and dropped
+     * periods, random or scripted, count as xruns as a device would report them.
+     * @return false while the engine is running
+     */
+    bool SetSimulation(const SimulatedDeviceOptions& options);
+    const SimulatedDeviceOptions& GetSimulation() const { return m_simulationOptions; }
+
+    struct SimulationStats {
+        uint64_t blocks;                        // Periods scheduled, dropped ones included
+        uint64_t droppedBlocks;
+        uint64_t lateBlocks;                    // Arrived a period or more after their slot
+        double virtualSeconds;                  // Device time simulated
+        uint64_t outputChecksum;                // FNV-1a over every played sample
+    };
+    SimulationStats GetSimulationStats() const;
+
+    // Waits for a run with maxBlocks set to deliver them all; false on timeout
+    bool WaitForSimulation(std::chrono::milliseconds timeout) const;
+
+    /**
+     * @brief Select the processing pipeline (takes effect on the next Start)
+     * @param mode Inline or worker-thread processing
+     * @param lookaheadBlocks Blocks the worker renders ahead of the device; each
+     *        adds one buffer of latency and one buffer of tolerance to DSP jitter
+     * @return false while the engine is running
+     */
+    bool SetPipelineMode(PipelineMode mode, int lookaheadBlocks);
+    PipelineMode GetPipelineMode() const { return m_pipelineMode; }
+    int GetLookaheadBlocks() const { return m_lookaheadBlocks; }
+
+    /**
+     * @brief Select the filter used when the device and processing rates differ (takes effect on the next Start)
+     * @return false while the engine is running
+     */
+    bool SetResamplerQuality(ResamplerQuality quality);
+    ResamplerQuality GetResamplerQuality() const { return m_resamplerQuality; }
+
     /**
      * @brief Get current audio statistics
      */
@@ -178,6 +265,44 @@ public:
         float peakOutputLevel;
         std::chrono::microseconds callbackDuration;
         int droppedSamples;
+
+        // Per-stage cost of one block, smoothed; the DSP stage runs on the worker in worker mode
+        using StageDuration = std::chrono::duration<float, std::micro>;
+        StageDuration inputStageDuration;      // Capture conversion and metering
+        StageDuration dspStageDuration;        // Sample rate conversion and HRTF
+        StageDuration outputStageDuration;     // Ring hand-off, metering and device conversion
+        StageDuration maxDspStageDuration;     // Since the last ResetStats
+
+        PipelineMode pipelineMode;
+        int lookaheadBlocks;                   // 0 in inline mode
+        double pipelineLatency;                // Seconds the latency controller holds rendered audio for; starts at the lookahead
+        int64_t pipelineFramesReady;           // Rendered frames waiting for the device
+        int pipelineUnderruns;                 // Device blocks the worker had not rendered in time
+
+        int processingSampleRate;              // Rate HRTF runs at; equal to the device rate when no SRC is needed
+        double resamplerLatency;               // Seconds added by converting to the processing rate and back
+
+        // Callback duration distribution since ResetStats (callbackDuration is its mean);
+        // the tail, not the average, is what predicts dropouts
+        StageDuration callbackP50;
+        StageDuration callbackP90;
+        StageDuration callbackP99;
+        StageDuration callbackP999;
+        StageDuration callbackMax;
+
+        // Time left before the block deadline when the callback returned, worst tail last
+        StageDuration deadlineMarginP50;
+        StageDuration deadlineMarginP10;
+        StageDuration deadlineMarginP1;
+        StageDuration deadlineMarginP01;       // 0.1th percentile
+        int64_t deadlineMisses;                // Callbacks that ran longer than their block
+        int64_t callbackCount;
+
+        bool recording;
+        int64_t recordingOverflowFrames;       // Output frames the disk writer had no room for, this session
+
+        bool sharedOutput;                     // audio.sharedOutput segment open
+        int sharedOutputReaders;               // Processes attached to it
     };
     AudioStats GetStats() const;
 
@@ -219,15 +344,76 @@ public:
 
     /**
      * @brief Reset audio statistics
+     *
+     * While the stream runs, the callback timing histograms are cleared by the
+     * audio thread itself at its next callback, so GetStats may show the old
+     * distribution until then. Call from the control thread, like Start and Stop.
      */
     void ResetStats();
 
     /**
-     * @brief Enable/disable adaptive buffer sizing
-     * @param enable Enable adaptive buffering
+     * @brief Enable/disable the worker pipeline's latency controller (audio.pipeline.adaptiveLatency)
+     *
+     * The device buffer never changes. The controller deepens the queue of
+     * rendered blocks after xruns or late renders and trims it again after a
+     * quiet spell, a few crossfaded frames per block. Disabled, the queue
+     * stays at the configured lookahead. The depth holds while recording.
+     * @param enable Enable adaptive latency
      */
     void SetAdaptiveBuffering(bool enable);
 
+    /**
+     * @brief Enable/disable TPDF dither on 16- and 24-bit output (safe while running)
+     */
+    void SetOutputDither(bool enable);
+    bool IsOutputDitherEnabled() const { return m_outputDither; }
+
+    /**
+     * @brief Record the binaural output to a Broadcast Wave file (RF64 past 4 GB)
+     *
+     * The callback hands each output block to a disk writer thread and never
+     * waits for it; blocks that do not fit in its ring are dropped and counted.
+     * With recording.captureDry and recording.capturePoses the dry input and
+     * the RecordPose stream are written next to it on the same sample clock.
+     * @param path Target file; empty names one after the current time in recording.directory
+     * @return false if already recording or the file cannot be created
+     */
+    bool StartRecording(const std::string& path = std::string());
+    bool StopRecording();
+    bool IsRecording() const { return m_recording.IsRecording(); }
+    std::string GetRecordingPath() const { return m_recording.GetPath(); }
+    RecordingSession::Stats GetRecordingStats() const { return m_recording.GetStats(); }
+
+    // Tracking thread: adds the poses to the session's pose track, and the mic position to the automation, while recording
+    void RecordPose(const VRPose& hmd, const std::vector<VRPose>& controllers);
+
+    /**
+     * @brief Record spatial parameter changes to a delta-encoded .vrba file
+     *
+     * Events are stamped with the engine's stream position at the device rate.
+     * With automation.enableAutomation every StartRecording also records
+     * "take.vrba" next to the audio; automation.recordFormat "json" adds a
+     * JSON export when the recording stops.
+     * @param path Target file; empty names one after the current time in automation.recordPath
+     */
+    bool StartAutomationRecording(const std::string& path = std::string());
+    bool StopAutomationRecording();
+    bool IsRecordingAutomation() const;
+    // Control or tracking thread. Gains are carried in value.x.
+    void RecordAutomation(AutomationLane lane, int source, const Vec3& value);
+
+    /**
+     * @brief Play a .vrba file into the spatializer
+     *
+     * The file is mapped and read on the rendering thread; each block is split
+     * at event frames so every change lands on the sample it was recorded at.
+     * Live tracking should not drive the listener while this runs.
+     * @param loop Restart at the end (automation.loop)
+     */
+    bool StartAutomationPlayback(const std::string& path, bool loop);
+    void StopAutomationPlayback();
+    bool IsPlayingAutomation() const { return m_automation.load(std::memory_order_acquire) != nullptr; }
+
     /**
      * @brief Static method to enumerate available audio devices without initializing AudioEngine
      * @return Vector of available input devices with detailed information
@@ -252,6 +438,12 @@ private:
                      PaStreamCallbackFlags statusFlags, const PaStreamCallbackTimeInfo* timeInfo);
 
 
+    /**
+     * @brief JACK process callback: renders the capture ports straight into the output ports
+     */
+    static void JackProcess(const float* const* inputs, float* left, float* right, size_t frames, void* userData);
+    void ProcessJack(const float* const* inputs, float* left, float* right, size_t frames);
+
     /**
      * @brief Convert audio format
      */
@@ -261,22 +453,64 @@ private:
                            AudioFormat outputFormat, int outputChannels);
 
     /**
-     * @brief Apply sample rate conversion
+     * @brief Render one block through sample rate conversion and HRTF, timing the DSP stage
+     * @return Time spent rendering
      */
-    bool ApplySampleRateConversion(const float* input, float* output,
-                                  size_t inputFrames, size_t outputFrames);
+    std::chrono::steady_clock::duration RenderBlock(const float* input, float* output, size_t frames);
 
     /**
-     * @brief Apply linear interpolation for sample rate conversion
+     * @brief Convert the block to the processing rate, spatialize it there and convert it back
+     *
+     * Each direction yields a frame more or less than its share per block as
+     * the converter phases wrap, so the device-rate result is queued behind a
+     * few frames of slack and the device always takes exactly one block.
      */
-    bool ApplyLinearInterpolation(const float* input, float* output,
-                                 size_t inputFrames, size_t outputFrames);
+    void RenderResampled(const float* input, float* output, size_t frames);
 
     /**
-     * @brief Apply polyphase interpolation for high-quality sample rate conversion
+     * @brief Spatialize at the processing rate, applying due automation events between sub-blocks
      */
-    bool ApplyPolyphaseInterpolation(const float* input, float* output,
-                                   size_t inputFrames, size_t outputFrames);
+    void ProcessSpatial(const float* input, float* output, size_t frames);
+    // Calls render(offset, count) for consecutive runs of the block, applying due automation events between them
+    template <typename Render>
+    void RenderAutomated(size_t frames, Render&& render);
+    void ApplyAutomationEvent(const AutomationEvent& event);
+    int GetProcessingRate() const;          // The rate the spatializer runs at for this stream
+
+    /**
+     * @brief Worker mode device side: take one rendered block and queue one captured block
+     *
+     * With the latency controller on, the block may be spliced from a few frames
+     * more or fewer, and an underrun keeps the capture so the queue deepens.
+     * @param now When the callback arrived; the simulated device passes its virtual time
+     * @return false on a pipeline underrun (output is silenced; the input is dropped unless adaptive)
+     */
+    bool ExchangePipelineBlock(const float* input, float* output, size_t frames,
+                               std::chrono::steady_clock::time_point now);
+
+    /**
+     * @brief DSP worker thread: renders queued input until the output ring holds the lookahead
+     */
+    void DSPWorkerLoop();
+
+    /**
+     * @brief Size and clear the rings, prime the lookahead and start the worker if enabled
+     */
+    void StartPipeline();
+    void StopPipeline();
+
+    /**
+     * @brief Build the converters between the device and processing rates for this stream
+     */
+    void ConfigureSampleRateConversion();
+    double GetResamplerLatency() const;     // Seconds, 0 when the rates match
+
+    void LoadRecordingSettings(const Config& config);
+    void LoadSharedOutputSettings(const Config& config);
+    void LoadSimulationSettings(const Config& config);
+    void RefreshDeviceCatalog();            // Lists the devices and fills them in from the capability cache
+    void StartDeviceProbe();                // Skips the devices an open stream holds
+    void OpenSharedOutput();                // (Re)creates the segment for the current stream; Start only
 
     /**
      * @brief Open audio stream with selected devices
@@ -325,6 +559,17 @@ private:
      */
     bool SetupRealtimePriority();
 
+    /**
+     * @brief Record one callback's duration and deadline margin (audio thread, wait-free)
+     */
+    void RecordCallbackTiming(std::chrono::steady_clock::time_point start,
+                              std::chrono::steady_clock::time_point end, size_t frames);
+
+    /**
+     * @brief Clear the callback timing histograms (their writer only, or while no stream runs)
+     */
+    void ResetCallbackTiming();
+
     /**
      * @brief Monitor audio performance
      */
@@ -335,11 +580,6 @@ private:
      */
     void HandleAudioError(PaError error);
 
-    /**
-     * @brief Adaptive buffer size adjustment
-     */
-    void AdjustBufferSize();
-
     /**
      * @brief Detect if running in headless/WSL2 environment
      */
@@ -350,6 +590,11 @@ private:
      */
     bool InitializeMockBackend();
 
+    /**
+     * @brief Open a JACK client in place of PortAudio; false when no server is running
+     */
+    bool InitializeJackBackend(const Config& config);
+
 
     /**
      * @brief Mock processing thread loop
@@ -362,6 +607,8 @@ private:
     std::atomic<bool> m_exclusiveMode{false};
     std::atomic<bool> m_adaptiveBuffering{false};
     std::atomic<bool> m_mockBackend{false};
+    std::atomic<bool> m_jackBackend{false};
+    std::atomic<bool> m_outputDither{true};
 
     // Audio configuration
     int m_sampleRate;
@@ -379,25 +626,82 @@ private:
     std::string m_inputDeviceName;
     std::string m_outputDeviceName;
     std::string m_virtualOutputName;
+    DeviceCatalog m_deviceCatalog;
+    std::string m_deviceCachePath;
+    std::mutex m_deviceProbeMutex;          // PortAudio format queries are not re-entrant: one at a time
 
     // PortAudio
     PaStream* m_stream;
     PaHostApiIndex m_hostApiIndex;
 
+    // JACK; the client calls back into this engine, so it is closed before the members it uses go away
+    JackBackend m_jack;
+
     // Processing
     HRTFProcessor* m_hrtf;
     std::unique_ptr<RingBuffer<float>> m_inputBuffer;
     std::unique_ptr<RingBuffer<float>> m_outputBuffer;
-    std::unique_ptr<RingBuffer<float>> m_processingBuffer;
+
+    // DSP pipeline
+    PipelineMode m_pipelineMode{PipelineMode::Inline};
+    int m_lookaheadBlocks{2};
+    int m_dspWorkerCpu{-1};                 // Core the worker is pinned to, -1 for none
+    std::thread m_dspThread;
+    std::atomic<bool> m_dspRunning{false};
+    std::vector<float> m_dspInput;          // Worker-owned block buffers
+    std::vector<float> m_dspOutput;
+    std::atomic<uint64_t> m_dspBlocksRendered{0};
+    uint64_t m_pipelineBlocksQueued{0};     // Captures handed to the worker; device thread only
+    LatencyController m_latency;            // Device side of the pipeline; reset by StartPipeline
+    std::vector<float> m_latencyScratch;    // A block plus the largest step, for splicing
+    std::chrono::steady_clock::time_point m_lastExchange;
+    int m_latencyTrouble{0};                // Xrun and underrun total the controller has seen
 
     // Format conversion buffers
     std::vector<float> m_conversionBufferInput;
     std::vector<float> m_conversionBufferOutput;
     std::vector<float> m_resampleBuffer;
-
-    // Sample rate conversion
-    struct SRCState;
-    std::unique_ptr<SRCState> m_srcState;
+    simd::DitherState m_ditherState;            // Output conversion only, on the callback thread
+
+    // Session recording; the recorder lives as long as the engine so the callback can always reach it
+    RecordingSession m_recording;
+    RecordingSessionOptions m_recordingOptions;
+    std::string m_recordingDirectory{"./recordings"};
+
+    // Shared-memory output for local consumers; opened and closed only while no callback runs
+    SharedOutputWriter m_sharedOutput;
+    bool m_sharedOutputEnabled{false};
+    std::string m_sharedOutputName{SharedOutputFormat::DEFAULT_NAME};
+    int m_sharedOutputBufferMs{250};
+    uint64_t m_sharedOutputJackXruns{0};        // JACK xruns already forwarded, callback thread only
+    std::atomic<uint64_t> m_streamFrames{0};    // Device frames through the callback since Initialize
+
+    // Automation. The writer is shared by control and tracking threads; the player by its owner and the renderer.
+    std::mutex m_automationWriteMutex;
+    AutomationWriter m_automationWriter;
+    std::atomic<bool> m_automationRecording{false};
+    uint64_t m_automationStartFrame{0};
+    bool m_sessionAutomation{false};            // Started by StartRecording, stopped with it
+    bool m_automationEnabled{false};
+    std::string m_automationDirectory{"./automation"};
+    bool m_automationExportJson{false};
+    float m_automationSpeed{1.0f};
+    std::unique_ptr<AutomationPlayer> m_automationPlayer;
+    std::atomic<AutomationPlayer*> m_automation{nullptr};
+    std::atomic<int> m_automationInUse{0};
+    bool m_automationLoop{false};
+    int m_automationRate{0};                    // Processing rate the player's timeline is set for
+    uint64_t m_automationPlayhead{0};           // Processing-rate frames, rendering thread only
+    std::array<AutomationEvent, 32> m_automationEvents;
+
+    // Sample rate conversion; owned by whichever thread renders (callback or DSP worker)
+    ResamplerQuality m_resamplerQuality{ResamplerQuality::Balanced};
+    SampleRateConverter m_captureConverter;     // Device rate -> processing rate, input channels
+    SampleRateConverter m_renderConverter;      // Processing rate -> device rate, HRTF stereo
+    std::vector<float> m_srcCapture;            // One block at the processing rate
+    std::vector<float> m_srcRender;
+    std::vector<float> m_srcReturn;             // Device-rate frames waiting for the next block
+    size_t m_srcReturnFrames{0};
 
     // Statistics and monitoring
     mutable std::atomic<float> m_cpuLoad{0.0f};
@@ -409,15 +713,26 @@ private:
     mutable std::atomic<float> m_peakInputLevel{0.0f};
     mutable std::atomic<float> m_peakOutputLevel{0.0f};
     mutable std::atomic<int> m_droppedSamples{0};
+    mutable std::atomic<int> m_pipelineUnderruns{0};
 
-    // Performance monitoring
-    mutable std::mutex m_perfMutex;
-    std::chrono::steady_clock::time_point m_lastCallbackTime;
-    std::chrono::microseconds m_maxCallbackDuration{0};
-    std::chrono::microseconds m_avgCallbackDuration{0};
-    std::vector<std::chrono::microseconds> m_callbackHistory;
-    size_t m_callbackHistoryIndex{0};
-    static constexpr size_t CALLBACK_HISTORY_SIZE = 1000;
+    // Smoothed cost of one pipeline stage; each is written only by the thread running that stage
+    struct StageTimer {
+        std::atomic<float> averageMicros{0.0f};
+        std::atomic<float> maxMicros{0.0f};
+
+        void Record(std::chrono::steady_clock::duration elapsed);
+        void Reset();
+    };
+    StageTimer m_inputStage;
+    StageTimer m_dspStage;
+    StageTimer m_outputStage;
+
+    // Performance monitoring: written by the audio thread without locks, read by GetStats
+    std::atomic<std::chrono::steady_clock::time_point> m_lastCallbackTime{};
+    LatencyHistogram m_callbackDurations;
+    LatencyHistogram m_deadlineMargins;     // Block period minus callback duration, when positive
+    std::atomic<int64_t> m_deadlineMisses{0};
+    std::atomic<bool> m_timingResetPending{false};  // Set by ResetStats while the stream runs
 
     // Platform-specific handles
 #ifdef _WIN32
@@ -442,6 +757,11 @@ private:
     std::thread m_mockProcessingThread;
     std::atomic<bool> m_mockProcessingRunning{false};
     std::chrono::steady_clock::time_point m_mockLastProcessTime;
+    SimulatedDeviceOptions m_simulationOptions;
+    SimulatedDevice m_simulatedDevice;
+    std::atomic<bool> m_simulationDone{false};
+    std::mutex m_lockstepMutex;             // Free-running simulation only: device and DSP worker hand off blocks
+    std::condition_variable m_lockstepCondition;
 
     // Virtual device state
     std::atomic<bool> m_virtualDeviceCreated{false};
@@ -483,6 +803,27 @@ namespace vrb::audio_utils {
      */
     bool IsSampleRateSupported(int deviceIndex, double sampleRate);
 
+    /**
+     * @brief Map a PortAudio host API type to the engine's
+     */
+    AudioEngine::HostAPI HostAPIFromPA(int hostApiType);
+
+    /**
+     * @brief List the PortAudio devices without opening any of them
+     */
+    std::vector<DeviceCapabilities> ListDevices();
+
+    /**
+     * @brief Probe a device's capture and playback rates and capture formats (opens the device)
+     * @param queryMutex Held around each format query
+     */
+    void ProbeDevice(DeviceCapabilities& device, std::mutex& queryMutex);
+
+    /**
+     * @brief Device catalog entry as the engine reports it
+     */
+    AudioEngine::DeviceInfo ToDeviceInfo(const DeviceCapabilities& device);
+
     /**
      * @brief Get optimal buffer size for device
      */
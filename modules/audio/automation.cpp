@@ -0,0 +1,685 @@
+// automation.cpp - Binary automation of spatial parameters
+// Encoding, mapped playback and JSON export; see automation.h for the layout
+
+#include "automation.h"
+#include "logger.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace vrb {
+
+namespace {
+
+constexpr char MAGIC[8] = {'V', 'R', 'B', 'A', 'U', 'T', 'O', '\0'};
+constexpr uint8_t TAG_SYNC = 0x00;
+constexpr uint8_t TAG_ABSOLUTE = 0x80;
+constexpr size_t INDEX_ENTRY_BYTES = 16;
+constexpr size_t MAX_EVENT_BYTES = 1 + 10 + 5 + 3 * 5;
+
+void PutU32(uint8_t* data, uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        data[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+void PutU64(uint8_t* data, uint64_t value) {
+    PutU32(data, static_cast<uint32_t>(value));
+    PutU32(data + 4, static_cast<uint32_t>(value >> 32));
+}
+
+uint32_t GetU32(const uint8_t* data) {
+    return data[0] | (data[1] << 8) | (data[2] << 16) | (static_cast<uint32_t>(data[3]) << 24);
+}
+
+uint64_t GetU64(const uint8_t* data) {
+    return GetU32(data) | (static_cast<uint64_t>(GetU32(data + 4)) << 32);
+}
+
+size_t PutVarint(uint8_t* data, uint64_t value) {
+    size_t size = 0;
+    while (value >= 0x80) {
+        data[size++] = static_cast<uint8_t>(value | 0x80);
+        value >>= 7;
+    }
+    data[size++] = static_cast<uint8_t>(value);
+    return size;
+}
+
+bool GetVarint(const uint8_t* data, size_t end, size_t& cursor, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && cursor < end; shift += 7) {
+        const uint8_t byte = data[cursor++];
+        value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+uint64_t ZigZag(int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+int64_t UnZigZag(uint64_t value) {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+int Components(AutomationLane lane) {
+    return lane == AutomationLane::SourceGain ? 1 : 3;
+}
+
+bool IsSourceLane(AutomationLane lane) {
+    return lane != AutomationLane::MicrophonePosition;
+}
+
+float Step(AutomationLane lane) {
+    return lane == AutomationLane::SourceGain ? AutomationFormat::GAIN_STEP : AutomationFormat::POSITION_STEP;
+}
+
+// Mic first, then every source's position, then every source's gain
+size_t LaneIndex(AutomationLane lane, uint16_t source) {
+    switch (lane) {
+        case AutomationLane::MicrophonePosition: return 0;
+        case AutomationLane::SourcePosition: return 1 + source;
+        case AutomationLane::SourceGain: return 1 + AutomationFormat::MAX_SOURCES + source;
+    }
+    return 0;
+}
+
+AutomationLane LaneType(size_t index) {
+    if (index == 0) {
+        return AutomationLane::MicrophonePosition;
+    }
+    return index <= AutomationFormat::MAX_SOURCES ? AutomationLane::SourcePosition : AutomationLane::SourceGain;
+}
+
+uint16_t LaneSource(size_t index) {
+    if (index == 0) {
+        return 0;
+    }
+    return static_cast<uint16_t>((index - 1) % AutomationFormat::MAX_SOURCES);
+}
+
+bool ValidLane(uint8_t lane) {
+    return lane >= static_cast<uint8_t>(AutomationLane::MicrophonePosition) &&
+           lane <= static_cast<uint8_t>(AutomationLane::SourceGain);
+}
+
+int32_t Quantize(float value, float step) {
+    const double steps = std::round(static_cast<double>(value) / step);
+    return static_cast<int32_t>(std::clamp(steps, static_cast<double>(std::numeric_limits<int32_t>::min()),
+                                           static_cast<double>(std::numeric_limits<int32_t>::max())));
+}
+
+const char* LaneName(AutomationLane lane) {
+    switch (lane) {
+        case AutomationLane::MicrophonePosition: return "microphonePosition";
+        case AutomationLane::SourcePosition: return "sourcePosition";
+        case AutomationLane::SourceGain: return "sourceGain";
+    }
+    return "unknown";
+}
+
+} // anonymous namespace
+
+// AutomationWriter
+
+AutomationWriter::~AutomationWriter() {
+    Close();
+}
+
+bool AutomationWriter::Open(const std::string& path, int sampleRate, std::string& error, uint32_t syncInterval) {
+    if (m_file) {
+        error = "automation already open: " + m_path;
+        return false;
+    }
+    if (sampleRate <= 0) {
+        error = "invalid sample rate " + std::to_string(sampleRate);
+        return false;
+    }
+
+    std::error_code ec;
+    const auto parent = std::filesystem::path(path).parent_path();
+    if (!parent.empty()) {
+        std::filesystem::create_directories(parent, ec);
+    }
+
+    m_file = std::fopen(path.c_str(), "wb");
+    if (!m_file) {
+        error = "cannot create " + path + ": " + std::strerror(errno);
+        return false;
+    }
+
+    m_path = path;
+    m_sampleRate = sampleRate;
+    m_syncInterval = syncInterval > 0 ? syncInterval : static_cast<uint32_t>(sampleRate);
+    m_offset = 0;
+    m_lastFrame = 0;
+    m_nextSync = 0;
+    m_started = false;
+    m_failed = false;
+    m_eventCount = 0;
+    m_scratch.resize(MAX_EVENT_BYTES);
+    m_lanes.assign(AutomationFormat::MAX_LANES, LaneState());
+    m_index.clear();
+
+    // The index offset stays zero until Close, which marks a file cut short
+    if (!WriteHeader(0)) {
+        error = "cannot write the header of " + path;
+        std::fclose(m_file);
+        m_file = nullptr;
+        return false;
+    }
+    m_offset = AutomationFormat::HEADER_BYTES;
+    return true;
+}
+
+bool AutomationWriter::Close() {
+    if (!m_file) {
+        return true;
+    }
+
+    const uint64_t indexOffset = m_offset;
+    uint8_t entry[INDEX_ENTRY_BYTES];
+    for (const auto& sync : m_index) {
+        PutU64(entry, sync.first);
+        PutU64(entry + 8, sync.second);
+        Put(entry, sizeof(entry));
+    }
+    bool ok = !m_failed && std::fseek(m_file, 0, SEEK_SET) == 0 && WriteHeader(indexOffset);
+    ok = std::fclose(m_file) == 0 && ok;
+    m_file = nullptr;
+    if (!ok) {
+        LOG_ERROR("Automation {} is incomplete: a write failed", m_path);
+    }
+    return ok;
+}
+
+bool AutomationWriter::Write(const AutomationEvent& event) {
+    if (!m_file || m_failed) {
+        return false;
+    }
+    const auto laneByte = static_cast<uint8_t>(event.lane);
+    if (!ValidLane(laneByte) || (IsSourceLane(event.lane) && event.source >= AutomationFormat::MAX_SOURCES)) {
+        return false;
+    }
+
+    const size_t lane = LaneIndex(event.lane, event.source);
+    const int components = Components(event.lane);
+    const float step = Step(event.lane);
+    const float input[3] = {event.value.x, event.value.y, event.value.z};
+    int32_t values[3] = {0, 0, 0};
+    for (int c = 0; c < components; ++c) {
+        values[c] = Quantize(input[c], step);
+    }
+
+    LaneState& state = m_lanes[lane];
+    if (state.set && std::equal(values, values + components, state.value)) {
+        return true;
+    }
+
+    // Late events are moved up to the last frame written so decoding never steps backwards
+    const uint64_t frame = std::max(event.frame, m_lastFrame);
+    if (!m_started || frame >= m_nextSync) {
+        WriteSync(frame);
+    }
+
+    int32_t deltas[3] = {0, 0, 0};
+    for (int c = 0; c < components; ++c) {
+        deltas[c] = static_cast<int32_t>(static_cast<int64_t>(values[c]) - state.value[c]);
+    }
+    WriteEvent(frame - m_lastFrame, lane, false, deltas);
+    std::copy(values, values + 3, state.value);
+    state.set = true;
+    m_lastFrame = frame;
+    ++m_eventCount;
+    return !m_failed;
+}
+
+void AutomationWriter::WriteSync(uint64_t frame) {
+    m_index.emplace_back(frame, m_offset);
+    uint8_t sync[9];
+    sync[0] = TAG_SYNC;
+    PutU64(sync + 1, frame);
+    Put(sync, sizeof(sync));
+
+    m_lastFrame = frame;
+    for (size_t lane = 0; lane < m_lanes.size(); ++lane) {
+        if (m_lanes[lane].set) {
+            WriteEvent(0, lane, true, m_lanes[lane].value);
+        }
+    }
+    m_started = true;
+    m_nextSync = frame + m_syncInterval;
+}
+
+void AutomationWriter::WriteEvent(uint64_t frameDelta, size_t lane, bool absolute, const int32_t* values) {
+    const AutomationLane type = LaneType(lane);
+    uint8_t* data = m_scratch.data();
+    size_t size = 0;
+    data[size++] = static_cast<uint8_t>(static_cast<uint8_t>(type) | (absolute ? TAG_ABSOLUTE : 0));
+    size += PutVarint(data + size, frameDelta);
+    if (IsSourceLane(type)) {
+        size += PutVarint(data + size, LaneSource(lane));
+    }
+    for (int c = 0; c < Components(type); ++c) {
+        size += PutVarint(data + size, ZigZag(values[c]));
+    }
+    Put(data, size);
+}
+
+void AutomationWriter::Put(const uint8_t* data, size_t size) {
+    if (m_failed) {
+        return;
+    }
+    if (std::fwrite(data, 1, size, m_file) != size) {
+        m_failed = true;
+        LOG_ERROR("Automation write failed for {}", m_path);
+        return;
+    }
+    m_offset += size;
+}
+
+bool AutomationWriter::WriteHeader(uint64_t indexOffset) {
+    uint8_t header[AutomationFormat::HEADER_BYTES] = {};
+    std::memcpy(header, MAGIC, sizeof(MAGIC));
+    PutU32(header + 8, AutomationFormat::VERSION);
+    PutU32(header + 12, static_cast<uint32_t>(m_sampleRate));
+    PutU64(header + 16, m_eventCount);
+    PutU64(header + 24, m_lastFrame);
+    PutU64(header + 32, indexOffset);
+    PutU64(header + 40, indexOffset ? m_index.size() : 0);
+    PutU32(header + 48, m_syncInterval);
+    return std::fwrite(header, 1, sizeof(header), m_file) == sizeof(header);
+}
+
+// AutomationPlayer
+
+AutomationPlayer::~AutomationPlayer() {
+    Close();
+}
+
+bool AutomationPlayer::Open(const std::string& path, std::string& error) {
+    Close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        error = "cannot open " + path;
+        return false;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        CloseHandle(file);
+        error = "empty or unreadable file";
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    const void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!view) {
+        if (mapping) CloseHandle(mapping);
+        CloseHandle(file);
+        error = "cannot map " + path;
+        return false;
+    }
+    m_fileHandle = file;
+    m_mapping = mapping;
+    m_data = static_cast<const uint8_t*>(view);
+    m_size = static_cast<size_t>(size.QuadPart);
+#else
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        error = "cannot open " + path + ": " + std::strerror(errno);
+        return false;
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || info.st_size <= 0) {
+        ::close(fd);
+        error = "empty or unreadable file";
+        return false;
+    }
+    const size_t size = static_cast<size_t>(info.st_size);
+    void* view = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (view == MAP_FAILED) {
+        error = "cannot map " + path + ": " + std::strerror(errno);
+        return false;
+    }
+    m_data = static_cast<const uint8_t*>(view);
+    m_size = size;
+#endif
+
+    if (m_size < AutomationFormat::HEADER_BYTES || std::memcmp(m_data, MAGIC, sizeof(MAGIC)) != 0) {
+        Close();
+        error = path + " is not an automation file";
+        return false;
+    }
+    const uint32_t version = GetU32(m_data + 8);
+    if (version != AutomationFormat::VERSION) {
+        Close();
+        error = path + ": unsupported automation version " + std::to_string(version);
+        return false;
+    }
+    m_sampleRate = static_cast<int>(GetU32(m_data + 12));
+    if (m_sampleRate <= 0) {
+        Close();
+        error = path + ": invalid sample rate";
+        return false;
+    }
+
+    const uint64_t indexOffset = GetU64(m_data + 32);
+    const uint64_t indexCount = GetU64(m_data + 40);
+    if (indexOffset >= AutomationFormat::HEADER_BYTES && indexOffset <= m_size &&
+        indexCount == (m_size - indexOffset) / INDEX_ENTRY_BYTES) {
+        m_streamEnd = static_cast<size_t>(indexOffset);
+        m_eventCount = GetU64(m_data + 16);
+        m_lastFrame = GetU64(m_data + 24);
+        m_index.resize(static_cast<size_t>(indexCount));
+        for (size_t i = 0; i < m_index.size(); ++i) {
+            const uint8_t* entry = m_data + m_streamEnd + i * INDEX_ENTRY_BYTES;
+            m_index[i] = {GetU64(entry), GetU64(entry + 8)};
+        }
+    } else {
+        LOG_WARN("Automation {} was not closed cleanly; indexing it by scanning", path);
+        m_streamEnd = m_size;
+        ScanIndex();
+    }
+
+    SetTimeline(m_sampleRate);
+    Seek(0);
+    return true;
+}
+
+void AutomationPlayer::Close() {
+#ifdef _WIN32
+    if (m_data) {
+        UnmapViewOfFile(m_data);
+    }
+    if (m_mapping) {
+        CloseHandle(m_mapping);
+    }
+    if (m_fileHandle) {
+        CloseHandle(m_fileHandle);
+    }
+    m_mapping = nullptr;
+    m_fileHandle = nullptr;
+#else
+    if (m_data) {
+        ::munmap(const_cast<uint8_t*>(m_data), m_size);
+    }
+#endif
+    m_data = nullptr;
+    m_size = 0;
+    m_streamEnd = 0;
+    m_sampleRate = 0;
+    m_eventCount = 0;
+    m_lastFrame = 0;
+    m_index.clear();
+    m_hasNext = false;
+    m_pendingState = false;
+}
+
+void AutomationPlayer::ScanIndex() {
+    m_index.clear();
+    m_eventCount = 0;
+    m_lastFrame = 0;
+    m_cursor = AutomationFormat::HEADER_BYTES;
+    m_frame = 0;
+    m_hasNext = false;
+    for (auto& lane : m_lanes) {
+        lane = LaneState();
+    }
+
+    for (;;) {
+        while (m_cursor + 9 <= m_streamEnd && m_data[m_cursor] == TAG_SYNC) {
+            m_index.emplace_back(GetU64(m_data + m_cursor + 1), m_cursor);
+            m_frame = m_index.back().first;
+            m_cursor += 9;
+        }
+        // Stops at the end or at the torn tail the crash left
+        if (!DecodeNext()) {
+            break;
+        }
+        if (!m_nextFromSync) {
+            ++m_eventCount;
+            m_lastFrame = m_nextFrame;
+        }
+        Consume();
+    }
+}
+
+void AutomationPlayer::SetTimeline(int sampleRate, double speed) {
+    if (sampleRate <= 0 || m_sampleRate <= 0) {
+        m_scale = 1.0;
+        return;
+    }
+    if (!(speed > 0.0)) {
+        speed = 1.0;
+    }
+    m_scale = static_cast<double>(sampleRate) / (static_cast<double>(m_sampleRate) * speed);
+}
+
+uint64_t AutomationPlayer::ToTimeline(uint64_t fileFrame) const {
+    return static_cast<uint64_t>(std::llround(static_cast<double>(fileFrame) * m_scale));
+}
+
+uint64_t AutomationPlayer::GetDuration() const {
+    return ToTimeline(m_lastFrame);
+}
+
+void AutomationPlayer::Seek(uint64_t frame) {
+    for (auto& lane : m_lanes) {
+        lane = LaneState();
+    }
+    m_hasNext = false;
+    m_frame = 0;
+    m_cursor = AutomationFormat::HEADER_BYTES;
+
+    // Start from the last sync block at or before the target
+    auto sync = std::upper_bound(m_index.begin(), m_index.end(), frame,
+                                 [this](uint64_t target, const std::pair<uint64_t, uint64_t>& entry) {
+                                     return target < ToTimeline(entry.first);
+                                 });
+    if (sync != m_index.begin()) {
+        m_cursor = static_cast<size_t>(std::prev(sync)->second);
+    }
+
+    while ((m_hasNext || DecodeNext()) && ToTimeline(m_nextFrame) <= frame) {
+        Consume();
+    }
+
+    m_pendingState = false;
+    for (auto& lane : m_lanes) {
+        lane.pending = lane.set;
+        m_pendingState = m_pendingState || lane.set;
+    }
+    m_seekFrame = frame;
+}
+
+size_t AutomationPlayer::Read(uint64_t endFrame, AutomationEvent* events, size_t maxEvents) {
+    size_t count = 0;
+    if (m_pendingState) {
+        m_pendingState = false;
+        for (size_t lane = 0; lane < AutomationFormat::MAX_LANES; ++lane) {
+            if (!m_lanes[lane].pending) {
+                continue;
+            }
+            if (count == maxEvents) {
+                m_pendingState = true;
+                return count;
+            }
+            MakeEvent(lane, m_seekFrame, events[count++]);
+            m_lanes[lane].pending = false;
+        }
+    }
+
+    while (count < maxEvents && (m_hasNext || DecodeNext())) {
+        const uint64_t frame = ToTimeline(m_nextFrame);
+        if (frame >= endFrame) {
+            break;
+        }
+        // Sync blocks restate values already in effect; they only matter when seeking
+        const bool restated = m_nextFromSync;
+        const size_t lane = m_nextLane;
+        Consume();
+        if (!restated) {
+            MakeEvent(lane, frame, events[count++]);
+        }
+    }
+    return count;
+}
+
+uint64_t AutomationPlayer::PeekFrame() {
+    if (m_pendingState) {
+        return m_seekFrame;
+    }
+    while (m_hasNext || DecodeNext()) {
+        if (!m_nextFromSync) {
+            return ToTimeline(m_nextFrame);
+        }
+        Consume();
+    }
+    return std::numeric_limits<uint64_t>::max();
+}
+
+bool AutomationPlayer::AtEnd() {
+    return PeekFrame() == std::numeric_limits<uint64_t>::max();
+}
+
+bool AutomationPlayer::DecodeNext() {
+    size_t cursor = m_cursor;
+    uint64_t frame = m_frame;
+    while (cursor < m_streamEnd) {
+        const uint8_t tag = m_data[cursor++];
+        if (tag == TAG_SYNC) {
+            if (cursor + 8 > m_streamEnd) {
+                break;
+            }
+            frame = GetU64(m_data + cursor);
+            cursor += 8;
+            continue;
+        }
+
+        const uint8_t laneByte = tag & static_cast<uint8_t>(~TAG_ABSOLUTE);
+        if (!ValidLane(laneByte)) {
+            break;
+        }
+        const auto type = static_cast<AutomationLane>(laneByte);
+        uint64_t delta = 0;
+        uint64_t source = 0;
+        if (!GetVarint(m_data, m_streamEnd, cursor, delta) ||
+            (IsSourceLane(type) && (!GetVarint(m_data, m_streamEnd, cursor, source) ||
+                                    source >= AutomationFormat::MAX_SOURCES))) {
+            break;
+        }
+
+        const size_t lane = LaneIndex(type, static_cast<uint16_t>(source));
+        const bool absolute = (tag & TAG_ABSOLUTE) != 0;
+        bool complete = true;
+        for (int c = 0; c < Components(type); ++c) {
+            uint64_t encoded = 0;
+            if (!GetVarint(m_data, m_streamEnd, cursor, encoded)) {
+                complete = false;
+                break;
+            }
+            const int64_t value = UnZigZag(encoded);
+            m_nextValue[c] = static_cast<int32_t>(absolute ? value : m_lanes[lane].value[c] + value);
+        }
+        if (!complete) {
+            break;
+        }
+
+        m_cursor = cursor;
+        m_frame = frame + delta;
+        m_nextFrame = m_frame;
+        m_nextLane = lane;
+        m_nextFromSync = absolute;
+        m_hasNext = true;
+        return true;
+    }
+
+    // End of stream, or the torn tail of a file that was never closed
+    m_cursor = m_streamEnd;
+    m_hasNext = false;
+    return false;
+}
+
+void AutomationPlayer::Consume() {
+    LaneState& lane = m_lanes[m_nextLane];
+    std::copy(m_nextValue, m_nextValue + Components(LaneType(m_nextLane)), lane.value);
+    lane.set = true;
+    lane.pending = false;
+    m_hasNext = false;
+}
+
+void AutomationPlayer::MakeEvent(size_t lane, uint64_t frame, AutomationEvent& event) const {
+    const LaneState& state = m_lanes[lane];
+    event.frame = frame;
+    event.lane = LaneType(lane);
+    event.source = LaneSource(lane);
+    const float step = Step(event.lane);
+    event.value = Vec3(state.value[0] * step, state.value[1] * step, state.value[2] * step);
+}
+
+bool ExportAutomationJson(const std::string& binaryPath, const std::string& jsonPath, std::string& error) {
+    AutomationPlayer player;
+    if (!player.Open(binaryPath, error)) {
+        return false;
+    }
+
+    std::FILE* file = std::fopen(jsonPath.c_str(), "w");
+    if (!file) {
+        error = "cannot create " + jsonPath + ": " + std::strerror(errno);
+        return false;
+    }
+
+    // Streamed event by event; an hour of tracking would be a very large Json::Value
+    std::fprintf(file, "{\n  \"sampleRate\": %d,\n  \"events\": [", player.GetSampleRate());
+    AutomationEvent events[256];
+    bool first = true;
+    size_t count = 0;
+    while ((count = player.Read(std::numeric_limits<uint64_t>::max(), events, 256)) > 0) {
+        for (size_t i = 0; i < count; ++i) {
+            const AutomationEvent& event = events[i];
+            std::fprintf(file, "%s\n    {\"frame\": %llu, \"lane\": \"%s\"", first ? "" : ",",
+                         static_cast<unsigned long long>(event.frame), LaneName(event.lane));
+            if (IsSourceLane(event.lane)) {
+                std::fprintf(file, ", \"source\": %u", static_cast<unsigned>(event.source));
+            }
+            if (event.lane == AutomationLane::SourceGain) {
+                std::fprintf(file, ", \"value\": %.6g}", event.value.x);
+            } else {
+                std::fprintf(file, ", \"value\": [%.6g, %.6g, %.6g]}", event.value.x, event.value.y, event.value.z);
+            }
+            first = false;
+        }
+    }
+    std::fprintf(file, "\n  ]\n}\n");
+
+    if (std::fclose(file) != 0) {
+        error = "cannot write " + jsonPath;
+        return false;
+    }
+    return true;
+}
+
+} // namespace vrb
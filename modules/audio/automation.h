@@ -0,0 +1,184 @@
+// automation.h - Binary automation of spatial parameters
+// Delta-encoded event streams recorded against the audio clock and played back from a mapped file
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "vr_types.h"
+
+namespace vrb {
+
+enum class AutomationLane : uint8_t {
+    MicrophonePosition = 1,     // Head-relative metres, as HRTFProcessor::SetListenerPosition
+    SourcePosition = 2,         // Head-relative metres of source n
+    SourceGain = 3              // Linear gain of source n in value.x
+};
+
+struct AutomationEvent {
+    uint64_t frame{0};
+    AutomationLane lane{AutomationLane::MicrophonePosition};
+    uint16_t source{0};
+    Vec3 value;
+};
+
+/**
+ * @brief .vrba file layout
+ *
+ * A 64-byte header, the event stream, then an index of sync points. Events
+ * are a tag byte (lane, plus 0x80 inside a sync block), a varint frame delta
+ * from the previous event, a varint source id for source lanes and one
+ * zig-zag varint per component: the change from the lane's previous value in
+ * 0.1 mm (positions) or 1/65536 (gain) steps. A sync block (tag 0, absolute
+ * frame) restates every lane's value in absolute terms once per interval, so
+ * decoding can start at any sync point; the index lists them for seeking.
+ * A file whose index was never written (the recorder died) is indexed by
+ * scanning when opened.
+ */
+struct AutomationFormat {
+    static constexpr uint32_t VERSION = 1;
+    static constexpr size_t HEADER_BYTES = 64;
+    static constexpr int MAX_SOURCES = 64;
+    static constexpr size_t MAX_LANES = 1 + 2 * MAX_SOURCES;
+    static constexpr float POSITION_STEP = 1e-4f;
+    static constexpr float GAIN_STEP = 1.0f / 65536.0f;
+};
+
+/**
+ * @brief Appends events to a .vrba file
+ *
+ * Events must come in frame order; one that repeats its lane's current value
+ * (after quantization) is not stored. Writes are buffered and may block, so
+ * this runs on a control or tracking thread, never the audio thread.
+ */
+class AutomationWriter {
+public:
+    AutomationWriter() = default;
+    ~AutomationWriter();
+
+    AutomationWriter(const AutomationWriter&) = delete;
+    AutomationWriter& operator=(const AutomationWriter&) = delete;
+
+    // syncInterval: frames between sync blocks (0 = one second)
+    bool Open(const std::string& path, int sampleRate, std::string& error, uint32_t syncInterval = 0);
+    // Writes the index and the final header
+    bool Close();
+    bool IsOpen() const { return m_file != nullptr; }
+
+    bool Write(const AutomationEvent& event);
+
+    uint64_t GetEventCount() const { return m_eventCount; }
+    uint64_t GetBytesWritten() const { return m_offset; }
+    const std::string& GetPath() const { return m_path; }
+
+private:
+    struct LaneState {
+        bool set{false};
+        int32_t value[3]{0, 0, 0};
+    };
+
+    void WriteSync(uint64_t frame);
+    void WriteEvent(uint64_t frameDelta, size_t lane, bool absolute, const int32_t* values);
+    void Put(const uint8_t* data, size_t size);
+    bool WriteHeader(uint64_t indexOffset);
+
+    std::FILE* m_file{nullptr};
+    std::string m_path;
+    int m_sampleRate{0};
+    uint32_t m_syncInterval{0};
+    uint64_t m_offset{0};
+    uint64_t m_lastFrame{0};
+    uint64_t m_nextSync{0};
+    bool m_started{false};
+    bool m_failed{false};
+    uint64_t m_eventCount{0};
+    std::vector<uint8_t> m_scratch;
+    std::vector<LaneState> m_lanes;
+    std::vector<std::pair<uint64_t, uint64_t>> m_index;     // Sync frame, byte offset
+};
+
+/**
+ * @brief Plays a .vrba file from a read-only mapping
+ *
+ * Open maps the file, checks it and loads the sync index. Seek and Read
+ * never allocate or touch the filesystem, so they can run on the audio
+ * thread. Frames given to and returned by Seek and Read are in the
+ * renderer's timeline, which SetTimeline relates to the file's.
+ */
+class AutomationPlayer {
+public:
+    AutomationPlayer() = default;
+    ~AutomationPlayer();
+
+    AutomationPlayer(const AutomationPlayer&) = delete;
+    AutomationPlayer& operator=(const AutomationPlayer&) = delete;
+
+    bool Open(const std::string& path, std::string& error);
+    void Close();
+    bool IsOpen() const { return m_data != nullptr; }
+
+    // The renderer's sample rate and playback speed (1 = as recorded)
+    void SetTimeline(int sampleRate, double speed = 1.0);
+
+    // The next Read first reports every lane's value at frame, stamped with frame
+    void Seek(uint64_t frame);
+    // Up to maxEvents events due before endFrame, in order
+    size_t Read(uint64_t endFrame, AutomationEvent* events, size_t maxEvents);
+    // Frame of the next event Read would return, or UINT64_MAX at the end
+    uint64_t PeekFrame();
+    bool AtEnd();
+
+    int GetSampleRate() const { return m_sampleRate; }
+    uint64_t GetEventCount() const { return m_eventCount; }
+    uint64_t GetDuration() const;               // Last event, renderer frames
+    size_t GetSyncPointCount() const { return m_index.size(); }
+
+private:
+    struct LaneState {
+        bool set{false};
+        bool pending{false};                    // Reported by the next Read after a Seek
+        int32_t value[3]{0, 0, 0};
+    };
+
+    // Decodes the next stored event without applying it; false at the end or on a truncated tail
+    bool DecodeNext();
+    // Applies the decoded event to its lane
+    void Consume();
+    void ScanIndex();
+    uint64_t ToTimeline(uint64_t fileFrame) const;
+    void MakeEvent(size_t lane, uint64_t frame, AutomationEvent& event) const;
+
+    const uint8_t* m_data{nullptr};
+    size_t m_size{0};
+    size_t m_streamEnd{0};
+#ifdef _WIN32
+    void* m_fileHandle{nullptr};
+    void* m_mapping{nullptr};
+#endif
+
+    int m_sampleRate{0};
+    uint64_t m_eventCount{0};
+    uint64_t m_lastFrame{0};
+    double m_scale{1.0};                        // Renderer frames per file frame
+    std::vector<std::pair<uint64_t, uint64_t>> m_index;
+    LaneState m_lanes[AutomationFormat::MAX_LANES];
+
+    // Decoder
+    size_t m_cursor{0};
+    uint64_t m_frame{0};
+    bool m_hasNext{false};
+    bool m_nextFromSync{false};
+    size_t m_nextLane{0};
+    uint64_t m_nextFrame{0};
+    int32_t m_nextValue[3]{0, 0, 0};
+    uint64_t m_seekFrame{0};
+    bool m_pendingState{false};
+};
+
+// Writes a .vrba file as JSON for inspection and interchange; recording and playback stay binary
+bool ExportAutomationJson(const std::string& binaryPath, const std::string& jsonPath, std::string& error);
+
+} // namespace vrb
@@ -0,0 +1,295 @@
+// device_catalog.cpp - Audio device listing with capabilities probed in the background
+
+#include "device_catalog.h"
+#include "logger.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <json/json.h>
+
+namespace vrb {
+
+namespace {
+
+Json::Value ToJson(const std::vector<int>& values) {
+    Json::Value array(Json::arrayValue);
+    for (int value : values) {
+        array.append(value);
+    }
+    return array;
+}
+
+std::vector<int> IntsFromJson(const Json::Value& array) {
+    std::vector<int> values;
+    for (const auto& value : array) {
+        if (value.isInt()) {
+            values.push_back(value.asInt());
+        }
+    }
+    return values;
+}
+
+void CopyProbeResults(const DeviceCapabilities& from, DeviceCapabilities& to) {
+    to.probed = from.probed;
+    to.inputSampleRates = from.inputSampleRates;
+    to.outputSampleRates = from.outputSampleRates;
+    to.inputFormats = from.inputFormats;
+}
+
+} // anonymous namespace
+
+bool DeviceCapabilities::SameDevice(const DeviceCapabilities& other) const {
+    return name == other.name && hostApiType == other.hostApiType &&
+           maxInputChannels == other.maxInputChannels && maxOutputChannels == other.maxOutputChannels &&
+           defaultSampleRate == other.defaultSampleRate;
+}
+
+DeviceCatalog::~DeviceCatalog() {
+    CancelProbe();
+}
+
+void DeviceCatalog::Update(std::vector<DeviceCapabilities> devices, const std::string& cachePath,
+                           const std::string& hostVersion) {
+    CancelProbe();
+
+    std::vector<DeviceCapabilities> cached;
+    std::string error;
+    std::error_code ec;
+    if (!cachePath.empty() && std::filesystem::exists(cachePath, ec) && !Load(cachePath, hostVersion, cached, error)) {
+        LOG_INFO("Ignoring device capability cache {}: {}", cachePath, error);
+    }
+
+    // Each cached entry serves at most one device, so identical interfaces are matched pairwise
+    std::vector<bool> used(cached.size(), false);
+    size_t reused = 0;
+    for (auto& device : devices) {
+        CopyProbeResults(DeviceCapabilities{}, device);
+        for (size_t i = 0; i < cached.size(); ++i) {
+            if (!used[i] && cached[i].SameDevice(device)) {
+                CopyProbeResults(cached[i], device);
+                used[i] = true;
+                ++reused;
+                break;
+            }
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_devices = std::move(devices);
+    m_cachePath = cachePath;
+    m_hostVersion = hostVersion;
+    m_cachedCount = reused;
+    m_dirty = reused != cached.size() || reused != m_devices.size();
+}
+
+void DeviceCatalog::StartProbe(Probe probe) {
+    CancelProbe();
+    m_cancel = false;
+    m_probing = true;
+    m_probeThread = std::thread([this, probe = std::move(probe)] { ProbeLoop(probe); });
+}
+
+void DeviceCatalog::CancelProbe() {
+    m_cancel = true;
+    if (m_probeThread.joinable()) {
+        m_probeThread.join();
+    }
+}
+
+bool DeviceCatalog::WaitForProbe(std::chrono::milliseconds timeout) const {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    return m_probeDone.wait_for(lock, timeout, [this] { return !m_probing.load(); });
+}
+
+std::vector<DeviceCapabilities> DeviceCatalog::GetDevices() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_devices;
+}
+
+bool DeviceCatalog::GetDevice(int index, DeviceCapabilities& device) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const auto& entry : m_devices) {
+        if (entry.index == index) {
+            device = entry;
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t DeviceCatalog::GetProbedCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return static_cast<size_t>(std::count_if(m_devices.begin(), m_devices.end(),
+                                             [](const DeviceCapabilities& d) { return d.probed; }));
+}
+
+void DeviceCatalog::ProbeLoop(Probe probe) {
+    const auto start = std::chrono::steady_clock::now();
+    size_t probedNow = 0;
+
+    for (size_t i = 0; !m_cancel; ++i) {
+        DeviceCapabilities device;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            while (i < m_devices.size() && m_devices[i].probed) {
+                ++i;
+            }
+            if (i >= m_devices.size()) {
+                break;
+            }
+            device = m_devices[i];
+        }
+
+        // The slow part runs without the lock; the device list only changes through Update, which joins first
+        if (!probe(device)) {
+            continue;
+        }
+        device.probed = true;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        CopyProbeResults(device, m_devices[i]);
+        m_dirty = true;
+        ++probedNow;
+    }
+
+    SaveProbed();
+    if (probedNow > 0) {
+        LOG_INFO("Probed {} audio device(s) in {} ms", probedNow,
+                 std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_probing = false;
+    }
+    m_probeDone.notify_all();
+}
+
+void DeviceCatalog::SaveProbed() {
+    std::vector<DeviceCapabilities> probed;
+    std::string path;
+    std::string hostVersion;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_dirty || m_cachePath.empty()) {
+            return;
+        }
+        std::copy_if(m_devices.begin(), m_devices.end(), std::back_inserter(probed),
+                     [](const DeviceCapabilities& d) { return d.probed; });
+        path = m_cachePath;
+        hostVersion = m_hostVersion;
+    }
+
+    std::string error;
+    if (!Save(path, hostVersion, probed, error)) {
+        LOG_WARN("Failed to write device capability cache: {}", error);
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_dirty = probed.size() != m_devices.size();
+}
+
+bool DeviceCatalog::Load(const std::string& path, const std::string& hostVersion,
+                         std::vector<DeviceCapabilities>& devices, std::string& error) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        error = "cannot open " + path;
+        return false;
+    }
+
+    Json::Value root;
+    Json::CharReaderBuilder builder;
+    std::string errors;
+    if (!Json::parseFromStream(builder, file, &root, &errors)) {
+        error = "not valid JSON: " + errors;
+        return false;
+    }
+    if (!root.isObject() || !root["version"].isInt() || root["version"].asInt() != VERSION) {
+        error = "not a version " + std::to_string(VERSION) + " device cache";
+        return false;
+    }
+    if (!root["host"].isString() || root["host"].asString() != hostVersion) {
+        error = "written for another host library";
+        return false;
+    }
+
+    // A hand-edited entry of the wrong type throws; the whole file is then ignored
+    devices.clear();
+    try {
+        for (const auto& entry : root["devices"]) {
+            DeviceCapabilities device;
+            device.name = entry["name"].asString();
+            device.hostApiType = entry["hostApi"].asInt();
+            device.maxInputChannels = entry["inputChannels"].asInt();
+            device.maxOutputChannels = entry["outputChannels"].asInt();
+            device.defaultSampleRate = entry["defaultSampleRate"].asDouble();
+            device.probed = true;
+            device.inputSampleRates = IntsFromJson(entry["inputSampleRates"]);
+            device.outputSampleRates = IntsFromJson(entry["outputSampleRates"]);
+            device.inputFormats = entry["inputFormats"].asUInt();
+            devices.push_back(device);
+        }
+    } catch (const Json::Exception& e) {
+        devices.clear();
+        error = e.what();
+        return false;
+    }
+    return true;
+}
+
+bool DeviceCatalog::Save(const std::string& path, const std::string& hostVersion,
+                         const std::vector<DeviceCapabilities>& devices, std::string& error) {
+    Json::Value root;
+    root["version"] = VERSION;
+    root["host"] = hostVersion;
+    root["devices"] = Json::Value(Json::arrayValue);
+    for (const auto& device : devices) {
+        Json::Value entry;
+        entry["name"] = device.name;
+        entry["hostApi"] = device.hostApiType;
+        entry["inputChannels"] = device.maxInputChannels;
+        entry["outputChannels"] = device.maxOutputChannels;
+        entry["defaultSampleRate"] = device.defaultSampleRate;
+        entry["inputSampleRates"] = ToJson(device.inputSampleRates);
+        entry["outputSampleRates"] = ToJson(device.outputSampleRates);
+        entry["inputFormats"] = device.inputFormats;
+        root["devices"].append(entry);
+    }
+
+    const std::filesystem::path parent = std::filesystem::path(path).parent_path();
+    std::error_code ec;
+    if (!parent.empty()) {
+        std::filesystem::create_directories(parent, ec);
+    }
+
+    // Written aside and renamed into place, so a start never reads half a file
+    const std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::trunc);
+        if (!file.is_open()) {
+            error = "cannot create " + temporary;
+            return false;
+        }
+        Json::StreamWriterBuilder writer;
+        writer["indentation"] = "  ";
+        file << Json::writeString(writer, root) << '\n';
+        if (!file.good()) {
+            error = "cannot write " + temporary;
+            return false;
+        }
+    }
+
+    std::filesystem::rename(temporary, path, ec);
+    if (ec) {
+        std::remove(temporary.c_str());
+        error = "cannot rename " + temporary + " to " + path + ": " + ec.message();
+        return false;
+    }
+    return true;
+}
+
+} // namespace vrb
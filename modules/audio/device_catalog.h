@@ -0,0 +1,100 @@
+// device_catalog.h - Audio device listing with capabilities probed in the background
+// Probe results persist in a JSON cache file and are reused while the device is unchanged
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace vrb {
+
+struct DeviceCapabilities {
+    // What the host reports when listing, cheap to read at every start
+    int index = -1;
+    std::string name;
+    int hostApiType = 0;                    // PaHostApiTypeId
+    int maxInputChannels = 0;
+    int maxOutputChannels = 0;
+    double defaultSampleRate = 0.0;
+    double lowInputLatency = 0.0;
+    double lowOutputLatency = 0.0;
+
+    // What only opening the device tells, from the probe or the cache file
+    bool probed = false;
+    std::vector<int> inputSampleRates;      // Mono float32 capture
+    std::vector<int> outputSampleRates;     // Stereo float32 playback
+    uint32_t inputFormats = 0;              // PaSampleFormat bits for mono capture at 48 kHz
+
+    // Same name, host API, channel counts and default rate: the probe results still hold
+    bool SameDevice(const DeviceCapabilities& other) const;
+};
+
+/**
+ * @brief The host's devices and what each of them supports
+ *
+ * Update() takes the current listing and fills in every device the cache
+ * file already probed. StartProbe() probes the rest on a background thread,
+ * one device at a time, and rewrites the file when the set of devices
+ * changed, so a device that was unplugged drops out and a new or changed
+ * one is probed once. A file from another cache version or another host
+ * library version is ignored as a whole.
+ *
+ * The probe is given a copy of each device; results are merged in under
+ * the lock, so the devices may be read from any thread while it runs.
+ */
+class DeviceCatalog {
+public:
+    static constexpr int VERSION = 1;
+
+    // Fills in the capabilities; false leaves the device unprobed for a later start
+    using Probe = std::function<bool(DeviceCapabilities&)>;
+
+    DeviceCatalog() = default;
+    ~DeviceCatalog();
+    DeviceCatalog(const DeviceCatalog&) = delete;
+    DeviceCatalog& operator=(const DeviceCatalog&) = delete;
+
+    // Cancels any probe still running; an empty cachePath keeps nothing on disk
+    void Update(std::vector<DeviceCapabilities> devices, const std::string& cachePath, const std::string& hostVersion);
+
+    void StartProbe(Probe probe);
+    void CancelProbe();     // Finishes the device in hand, saves what was probed and joins
+    bool WaitForProbe(std::chrono::milliseconds timeout) const;
+    bool IsProbing() const { return m_probing.load(); }
+
+    std::vector<DeviceCapabilities> GetDevices() const;
+    bool GetDevice(int index, DeviceCapabilities& device) const;
+    size_t GetCachedCount() const { return m_cachedCount; }    // Filled from the file by the last Update
+    size_t GetProbedCount() const;
+
+    static bool Load(const std::string& path, const std::string& hostVersion,
+                     std::vector<DeviceCapabilities>& devices, std::string& error);
+    static bool Save(const std::string& path, const std::string& hostVersion,
+                     const std::vector<DeviceCapabilities>& devices, std::string& error);
+
+private:
+    void ProbeLoop(Probe probe);
+    void SaveProbed();
+
+    mutable std::mutex m_mutex;
+    mutable std::condition_variable m_probeDone;
+    std::vector<DeviceCapabilities> m_devices;
+    std::string m_cachePath;
+    std::string m_hostVersion;
+    size_t m_cachedCount{0};
+    bool m_dirty{false};                    // The file no longer matches the devices
+
+    std::thread m_probeThread;
+    std::atomic<bool> m_probing{false};
+    std::atomic<bool> m_cancel{false};
+};
+
+} // namespace vrb
@@ -0,0 +1,550 @@
+// disk_recorder.cpp - Streaming session recorder for the binaural output
+// Writer thread, Broadcast Wave/RF64 header layout and the platform file layer
+
+#include "disk_recorder.h"
+#include "logger.h"
+#include "simd/audio_simd.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace vrb {
+
+namespace {
+
+constexpr size_t IO_ALIGNMENT = 4096;
+constexpr size_t DRAIN_FRAMES = 8192;
+constexpr uint64_t RIFF_LIMIT = 0xFFFFFFFFull;
+
+// Header layout: RIFF/RF64, JUNK/ds64, bext, fmt, JUNK padding, data
+constexpr size_t DS64_OFFSET = 12;
+constexpr size_t DS64_SIZE = 28;
+constexpr size_t BEXT_OFFSET = DS64_OFFSET + 8 + DS64_SIZE;
+constexpr size_t BEXT_SIZE = 602;               // EBU Tech 3285 v1 without coding history
+constexpr size_t FMT_OFFSET = BEXT_OFFSET + 8 + BEXT_SIZE;
+constexpr size_t PAD_OFFSET = FMT_OFFSET + 8 + 16;
+constexpr size_t DATA_OFFSET = DiskRecorder::HEADER_BYTES - 8;
+static_assert(PAD_OFFSET + 8 <= DATA_OFFSET && (DATA_OFFSET - PAD_OFFSET) % 2 == 0, "header chunks overlap");
+
+void PutU16(uint8_t* data, uint16_t value) {
+    data[0] = static_cast<uint8_t>(value);
+    data[1] = static_cast<uint8_t>(value >> 8);
+}
+
+void PutU32(uint8_t* data, uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        data[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+void PutU64(uint8_t* data, uint64_t value) {
+    PutU32(data, static_cast<uint32_t>(value));
+    PutU32(data + 4, static_cast<uint32_t>(value >> 32));
+}
+
+void PutText(uint8_t* data, size_t field, const std::string& text) {
+    std::memcpy(data, text.data(), std::min(field, text.size()));
+}
+
+// Points into storage at an alignment boundary with room for bytes after it
+uint8_t* AlignedBlock(std::vector<uint8_t>& storage, size_t bytes) {
+    storage.assign(bytes + IO_ALIGNMENT, 0);
+    const auto address = reinterpret_cast<uintptr_t>(storage.data());
+    return storage.data() + (IO_ALIGNMENT - address % IO_ALIGNMENT) % IO_ALIGNMENT;
+}
+
+std::tm LocalTime(std::time_t time) {
+    std::tm local{};
+#ifdef _WIN32
+    localtime_s(&local, &time);
+#else
+    localtime_r(&time, &local);
+#endif
+    return local;
+}
+
+} // anonymous namespace
+
+/**
+ * @brief Positioned writes to one file, unbuffered where the platform allows
+ */
+class DiskRecorder::File {
+public:
+    ~File() { Close(); }
+
+    bool Open(const std::string& path, bool direct, std::string& error) {
+#ifdef _WIN32
+        (void)direct;
+        m_handle = std::fopen(path.c_str(), "wb");
+        if (!m_handle) {
+            error = "cannot create " + path + ": " + std::strerror(errno);
+            return false;
+        }
+#else
+        int flags = O_WRONLY | O_CREAT | O_TRUNC;
+#ifdef O_CLOEXEC
+        flags |= O_CLOEXEC;
+#endif
+#ifdef O_DIRECT
+        if (direct) {
+            m_fd = ::open(path.c_str(), flags | O_DIRECT, 0644);
+            m_direct = m_fd >= 0;
+        }
+#endif
+        if (m_fd < 0) {
+            m_fd = ::open(path.c_str(), flags, 0644);
+        }
+        if (m_fd < 0) {
+            error = "cannot create " + path + ": " + std::strerror(errno);
+            return false;
+        }
+#if !defined(O_DIRECT) && defined(F_NOCACHE)
+        m_direct = direct && ::fcntl(m_fd, F_NOCACHE, 1) == 0;
+#endif
+#endif
+        return true;
+    }
+
+    bool WriteAt(uint64_t offset, const void* data, size_t bytes) {
+        const auto* bytePointer = static_cast<const uint8_t*>(data);
+#ifdef _WIN32
+        return _fseeki64(m_handle, static_cast<__int64>(offset), SEEK_SET) == 0 &&
+               std::fwrite(bytePointer, 1, bytes, m_handle) == bytes;
+#else
+        while (bytes > 0) {
+            const ssize_t written = ::pwrite(m_fd, bytePointer, bytes, static_cast<off_t>(offset));
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+#ifdef O_DIRECT
+                if (errno == EINVAL && m_direct) {
+                    // The filesystem takes O_DIRECT at open but not for this write; go through the page cache
+                    ::fcntl(m_fd, F_SETFL, ::fcntl(m_fd, F_GETFL) & ~O_DIRECT);
+                    m_direct = false;
+                    continue;
+                }
+#endif
+                return false;
+            }
+            bytePointer += written;
+            offset += static_cast<uint64_t>(written);
+            bytes -= static_cast<size_t>(written);
+        }
+        return true;
+#endif
+    }
+
+    // Best effort: a filesystem without fallocate simply allocates as the writes arrive
+    void Preallocate(uint64_t offset, uint64_t bytes) {
+#if defined(__linux__)
+        if (::fallocate(m_fd, 0, static_cast<off_t>(offset), static_cast<off_t>(bytes)) != 0) {
+            LOG_DEBUG("Recorder preallocation unavailable: {}", std::strerror(errno));
+        }
+#else
+        (void)offset;
+        (void)bytes;
+#endif
+    }
+
+    bool Truncate(uint64_t bytes) {
+#ifdef _WIN32
+        std::fflush(m_handle);
+        return _chsize_s(_fileno(m_handle), static_cast<__int64>(bytes)) == 0;
+#else
+        return ::ftruncate(m_fd, static_cast<off_t>(bytes)) == 0;
+#endif
+    }
+
+    bool Close() {
+        bool ok = true;
+#ifdef _WIN32
+        if (m_handle) {
+            ok = std::fclose(m_handle) == 0;
+            m_handle = nullptr;
+        }
+#else
+        if (m_fd >= 0) {
+            ok = ::fsync(m_fd) == 0;
+            ok = ::close(m_fd) == 0 && ok;
+            m_fd = -1;
+        }
+#endif
+        return ok;
+    }
+
+    bool IsDirect() const { return m_direct; }
+
+private:
+#ifdef _WIN32
+    std::FILE* m_handle{nullptr};
+#else
+    int m_fd{-1};
+#endif
+    bool m_direct{false};
+};
+
+DiskRecorder::DiskRecorder() = default;
+
+DiskRecorder::~DiskRecorder() {
+    Stop();
+}
+
+bool DiskRecorder::Start(const std::string& path, int sampleRate, int channels, const DiskRecorderOptions& options,
+                         std::string& error) {
+    if (m_file) {
+        error = "already recording to " + m_path;
+        return false;
+    }
+    if (sampleRate <= 0 || channels <= 0) {
+        error = "invalid recording format (" + std::to_string(sampleRate) + " Hz, " +
+                std::to_string(channels) + " channels)";
+        return false;
+    }
+
+    std::error_code ec;
+    const auto parent = std::filesystem::path(path).parent_path();
+    if (!parent.empty()) {
+        std::filesystem::create_directories(parent, ec);
+    }
+
+    auto file = std::make_unique<File>();
+    if (!file->Open(path, options.directIO, error)) {
+        return false;
+    }
+
+    m_path = path;
+    m_options = options;
+    m_info.sampleRate = sampleRate;
+    m_info.channels = channels;
+    m_info.format = options.format;
+    m_info.frames = 0;
+    m_startTime = std::chrono::system_clock::now();
+    m_ditherState = simd::DitherState(static_cast<uint32_t>(m_startTime.time_since_epoch().count()));
+
+    // Everything the writer and audio threads touch is sized here, before either runs
+    const size_t ringSamples = std::max<size_t>(
+        static_cast<size_t>(std::ceil(options.bufferSeconds * sampleRate)) * channels, DRAIN_FRAMES * channels);
+    m_ring = std::make_unique<RingBuffer<float>>(ringSamples + 1);
+    m_drainBuffer.assign(DRAIN_FRAMES * channels, 0.0f);
+    m_convertBuffer.assign(DRAIN_FRAMES * channels * GetWavSampleBytes(options.format), 0);
+    m_staging = AlignedBlock(m_stagingStorage, WRITE_CHUNK_BYTES);
+    m_stagingBytes = 0;
+    m_stagingOnDisk = 0;
+    m_header = AlignedBlock(m_headerStorage, HEADER_BYTES);
+
+    m_file = std::move(file);
+    m_framesPushed = 0;
+    m_bytesWritten = 0;
+    m_overflowFrames = 0;
+    m_overflowEvents = 0;
+    m_writes = 0;
+    m_rf64 = false;
+    m_writeFailed = false;
+    m_preallocatedTo = HEADER_BYTES;
+    if (options.preallocateBytes > 0) {
+        m_file->Preallocate(m_preallocatedTo, options.preallocateBytes);
+        m_preallocatedTo += options.preallocateBytes;
+    }
+    if (!WriteHeader(0)) {
+        error = "cannot write the header of " + path;
+        m_file.reset();
+        return false;
+    }
+    m_directIO = m_file->IsDirect();
+
+    m_stopping = false;
+    m_writerThread = std::thread([this] { WriterLoop(); });
+    m_active.store(true, std::memory_order_release);
+
+    LOG_INFO("Recording to {} ({} Hz, {} ch, {} bytes/sample, {} I/O, {:.2f}s buffer)", path, sampleRate, channels,
+             GetWavSampleBytes(options.format), m_directIO ? "direct" : "buffered", options.bufferSeconds);
+    return true;
+}
+
+bool DiskRecorder::Stop() {
+    if (!m_file) {
+        return true;
+    }
+
+    // No Push may be inside the ring once the writer has drained it for the last time
+    m_active.store(false);
+    while (m_pushing.load() != 0) {
+        std::this_thread::yield();
+    }
+    m_stopping.store(true, std::memory_order_release);
+    if (m_writerThread.joinable()) {
+        m_writerThread.join();
+    }
+
+    const bool ok = m_file->Close() && !m_writeFailed;
+    m_file.reset();
+
+    const Stats stats = GetStats();
+    LOG_INFO("Recording stopped: {} frames, {:.1f} MB in {} writes{}", stats.framesWritten,
+             stats.bytesWritten / (1024.0 * 1024.0), stats.writes, stats.rf64 ? " (RF64)" : "");
+    if (stats.overflowFrames > 0) {
+        LOG_WARN("Recording dropped {} frames in {} blocks: the writer fell behind the audio thread",
+                 stats.overflowFrames, stats.overflowEvents);
+    }
+    if (!ok) {
+        LOG_ERROR("Recording to {} is incomplete: a disk write failed", m_path);
+    }
+    return ok;
+}
+
+bool DiskRecorder::Push(const float* interleaved, size_t frames) {
+    m_pushing.fetch_add(1);
+    bool accepted = false;
+    if (m_active.load() && interleaved) {
+        const size_t samples = frames * static_cast<size_t>(m_info.channels);
+        if (m_ring->free() >= samples) {
+            m_ring->write(interleaved, samples);
+            m_framesPushed.fetch_add(frames, std::memory_order_relaxed);
+            accepted = true;
+        } else {
+            // Never wait for the disk: the block is lost and counted
+            m_overflowFrames.fetch_add(frames, std::memory_order_relaxed);
+            m_overflowEvents.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    m_pushing.fetch_sub(1);
+    return accepted;
+}
+
+bool DiskRecorder::HasSpace(size_t frames) const {
+    m_pushing.fetch_add(1);
+    const bool space = m_active.load() && m_ring->free() >= frames * static_cast<size_t>(m_info.channels);
+    m_pushing.fetch_sub(1);
+    return space;
+}
+
+void DiskRecorder::Drop(size_t frames) {
+    if (m_active.load(std::memory_order_relaxed)) {
+        m_overflowFrames.fetch_add(frames, std::memory_order_relaxed);
+        m_overflowEvents.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+DiskRecorder::Stats DiskRecorder::GetStats() const {
+    Stats stats;
+    const size_t frameBytes = GetWavSampleBytes(m_info.format) * static_cast<size_t>(std::max(1, m_info.channels));
+    stats.framesPushed = m_framesPushed.load(std::memory_order_relaxed);
+    stats.bytesWritten = m_bytesWritten.load(std::memory_order_relaxed);
+    stats.framesWritten = m_headerBytes.load(std::memory_order_relaxed) / frameBytes;
+    stats.overflowFrames = m_overflowFrames.load(std::memory_order_relaxed);
+    stats.overflowEvents = m_overflowEvents.load(std::memory_order_relaxed);
+    stats.writes = m_writes.load(std::memory_order_relaxed);
+    stats.directIO = m_directIO.load(std::memory_order_relaxed);
+    stats.rf64 = m_rf64.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void DiskRecorder::WriterLoop() {
+    // Polling keeps Push free of wake-up syscalls; an eighth of the ring leaves plenty of slack
+    const auto idleWait = std::chrono::milliseconds(
+        std::clamp(static_cast<int>(m_options.bufferSeconds * 125.0), 1, 20));
+    const auto headerInterval = std::chrono::duration<double>(std::max(0.05, m_options.headerIntervalSeconds));
+    auto lastHeader = std::chrono::steady_clock::now();
+    uint64_t reportedOverflows = 0;
+
+    while (true) {
+        const bool stopping = m_stopping.load(std::memory_order_acquire);
+        const size_t taken = Drain();
+
+        const auto now = std::chrono::steady_clock::now();
+        if (!m_writeFailed && now - lastHeader >= headerInterval) {
+            lastHeader = now;
+            // Full chunks alone would leave up to a megabyte outside the header however often it is written
+            if (!FlushStaging(true) || !WriteHeader(m_bytesWritten.load(std::memory_order_relaxed))) {
+                m_writeFailed = true;
+                LOG_ERROR("Recording header update failed for {}", m_path);
+            }
+            const uint64_t overflows = m_overflowEvents.load(std::memory_order_relaxed);
+            if (overflows != reportedOverflows) {
+                LOG_WARN("Recording ring overflowed: {} blocks ({} frames) dropped so far", overflows,
+                         m_overflowFrames.load(std::memory_order_relaxed));
+                reportedOverflows = overflows;
+            }
+        }
+
+        if (taken == 0) {
+            if (stopping) {
+                break;
+            }
+            std::this_thread::sleep_for(idleWait);
+        }
+    }
+
+    // Last partial chunk, the exact length (plus the RIFF pad byte) and the final sizes
+    if (!m_writeFailed) {
+        const bool flushed = FlushStaging(true);
+        const uint64_t dataBytes = m_bytesWritten.load(std::memory_order_relaxed);
+        if (!flushed || !m_file->Truncate(HEADER_BYTES + dataBytes + (dataBytes & 1)) || !WriteHeader(dataBytes)) {
+            m_writeFailed = true;
+        }
+    }
+}
+
+size_t DiskRecorder::Drain() {
+    const size_t channels = static_cast<size_t>(m_info.channels);
+    const size_t samples = std::min(m_ring->available(), m_drainBuffer.size()) / channels * channels;
+    if (samples == 0) {
+        return 0;
+    }
+    m_ring->read(m_drainBuffer.data(), samples);
+    if (m_writeFailed) {
+        return samples / channels;      // Keep the ring moving; the file is already lost
+    }
+
+    const size_t bytes = samples * GetWavSampleBytes(m_info.format);
+    switch (m_info.format) {
+        case WavSampleFormat::Int16: {
+            auto* output = reinterpret_cast<int16_t*>(m_convertBuffer.data());
+            if (m_options.dither) {
+                simd::convertFloatToInt16Dithered(m_drainBuffer.data(), output, samples, m_ditherState);
+            } else {
+                simd::convertFloatToInt16(m_drainBuffer.data(), output, samples);
+            }
+            break;
+        }
+        case WavSampleFormat::Int24:
+            if (m_options.dither) {
+                simd::convertFloatToInt24Dithered(m_drainBuffer.data(), m_convertBuffer.data(), samples, m_ditherState);
+            } else {
+                simd::convertFloatToInt24(m_drainBuffer.data(), m_convertBuffer.data(), samples);
+            }
+            break;
+        case WavSampleFormat::Int32:
+            simd::convertFloatToInt32(m_drainBuffer.data(), reinterpret_cast<int32_t*>(m_convertBuffer.data()), samples);
+            break;
+        case WavSampleFormat::Float32:
+            std::memcpy(m_convertBuffer.data(), m_drainBuffer.data(), bytes);
+            break;
+    }
+
+    // Fill the staging chunk and write it out whenever it is full
+    for (size_t copied = 0; copied < bytes && !m_writeFailed;) {
+        const size_t count = std::min(bytes - copied, WRITE_CHUNK_BYTES - m_stagingBytes);
+        std::memcpy(m_staging + m_stagingBytes, m_convertBuffer.data() + copied, count);
+        m_stagingBytes += count;
+        copied += count;
+        if (!FlushStaging(false)) {
+            m_writeFailed = true;
+            LOG_ERROR("Recording write failed for {}: {}", m_path, std::strerror(errno));
+        }
+    }
+    return samples / channels;
+}
+
+bool DiskRecorder::FlushStaging(bool partial) {
+    if (m_stagingBytes == m_stagingOnDisk || (!partial && m_stagingBytes < WRITE_CHUNK_BYTES)) {
+        return true;
+    }
+
+    // The staging buffer always starts on an I/O block of the file
+    const uint64_t offset = HEADER_BYTES + m_bytesWritten.load(std::memory_order_relaxed) - m_stagingOnDisk;
+    if (m_options.preallocateBytes > 0 && offset + WRITE_CHUNK_BYTES > m_preallocatedTo) {
+        m_file->Preallocate(m_preallocatedTo, m_options.preallocateBytes);
+        m_preallocatedTo += m_options.preallocateBytes;
+    }
+
+    // Unbuffered writes must cover whole blocks; the padding is overwritten by the next write or truncated at Stop
+    size_t writeBytes = m_stagingBytes;
+    if (m_file->IsDirect()) {
+        writeBytes = (m_stagingBytes + IO_ALIGNMENT - 1) / IO_ALIGNMENT * IO_ALIGNMENT;
+        std::memset(m_staging + m_stagingBytes, 0, writeBytes - m_stagingBytes);
+    }
+    if (!m_file->WriteAt(offset, m_staging, writeBytes)) {
+        return false;
+    }
+    m_directIO.store(m_file->IsDirect(), std::memory_order_relaxed);
+    m_bytesWritten.fetch_add(m_stagingBytes - m_stagingOnDisk, std::memory_order_relaxed);
+    m_writes.fetch_add(1, std::memory_order_relaxed);
+
+    // A partial block stays staged, so the next write lands on a block boundary and replaces its padding
+    const size_t tail = m_stagingBytes % IO_ALIGNMENT;
+    std::memmove(m_staging, m_staging + (m_stagingBytes - tail), tail);
+    m_stagingBytes = tail;
+    m_stagingOnDisk = tail;
+    return true;
+}
+
+bool DiskRecorder::WriteHeader(uint64_t dataBytes) {
+    const uint16_t sampleBytes = static_cast<uint16_t>(GetWavSampleBytes(m_info.format));
+    const uint16_t blockAlign = static_cast<uint16_t>(sampleBytes * m_info.channels);
+    const uint64_t riffBytes = HEADER_BYTES - 8 + dataBytes + (dataBytes & 1);
+    const bool rf64 = riffBytes > RIFF_LIMIT;
+
+    uint8_t* header = m_header;
+    std::memset(header, 0, HEADER_BYTES);
+    std::memcpy(header, rf64 ? "RF64" : "RIFF", 4);
+    PutU32(header + 4, rf64 ? 0xFFFFFFFFu : static_cast<uint32_t>(riffBytes));
+    std::memcpy(header + 8, "WAVE", 4);
+
+    // Reserved as JUNK until the sizes outgrow 32 bits, then rewritten in place as ds64
+    std::memcpy(header + DS64_OFFSET, rf64 ? "ds64" : "JUNK", 4);
+    PutU32(header + DS64_OFFSET + 4, DS64_SIZE);
+    if (rf64) {
+        PutU64(header + DS64_OFFSET + 8, riffBytes);
+        PutU64(header + DS64_OFFSET + 16, dataBytes);
+        PutU64(header + DS64_OFFSET + 24, dataBytes / blockAlign);
+    }
+
+    // Broadcast extension: origination stamp and the start as a sample count since midnight
+    uint8_t* bext = header + BEXT_OFFSET + 8;
+    std::memcpy(header + BEXT_OFFSET, "bext", 4);
+    PutU32(header + BEXT_OFFSET + 4, BEXT_SIZE);
+    const std::time_t start = std::chrono::system_clock::to_time_t(m_startTime);
+    const std::tm local = LocalTime(start);
+    char dateText[11], timeText[9];
+    std::strftime(dateText, sizeof(dateText), "%Y-%m-%d", &local);
+    std::strftime(timeText, sizeof(timeText), "%H:%M:%S", &local);
+    const uint64_t timeReference = static_cast<uint64_t>(local.tm_hour * 3600 + local.tm_min * 60 + local.tm_sec) *
+                                   static_cast<uint64_t>(m_info.sampleRate);
+    PutText(bext, 256, m_options.description);
+    PutText(bext + 256, 32, "VR Binaural Recorder");
+    PutText(bext + 288, 32, std::filesystem::path(m_path).filename().string());
+    PutText(bext + 320, 10, dateText);
+    PutText(bext + 330, 8, timeText);
+    PutU64(bext + 338, timeReference);
+    PutU16(bext + 346, 1);
+
+    std::memcpy(header + FMT_OFFSET, "fmt ", 4);
+    PutU32(header + FMT_OFFSET + 4, 16);
+    PutU16(header + FMT_OFFSET + 8, m_info.format == WavSampleFormat::Float32 ? 0x0003 : 0x0001);
+    PutU16(header + FMT_OFFSET + 10, static_cast<uint16_t>(m_info.channels));
+    PutU32(header + FMT_OFFSET + 12, static_cast<uint32_t>(m_info.sampleRate));
+    PutU32(header + FMT_OFFSET + 16, static_cast<uint32_t>(m_info.sampleRate) * blockAlign);
+    PutU16(header + FMT_OFFSET + 20, blockAlign);
+    PutU16(header + FMT_OFFSET + 22, static_cast<uint16_t>(sampleBytes * 8));
+
+    // Pads the header out so the samples start on an I/O block
+    std::memcpy(header + PAD_OFFSET, "JUNK", 4);
+    PutU32(header + PAD_OFFSET + 4, static_cast<uint32_t>(DATA_OFFSET - PAD_OFFSET - 8));
+
+    std::memcpy(header + DATA_OFFSET, "data", 4);
+    PutU32(header + DATA_OFFSET + 4, rf64 ? 0xFFFFFFFFu : static_cast<uint32_t>(dataBytes));
+
+    if (!m_file->WriteAt(0, header, HEADER_BYTES)) {
+        return false;
+    }
+    m_headerBytes.store(dataBytes, std::memory_order_relaxed);
+    m_rf64.store(rf64, std::memory_order_relaxed);
+    return true;
+}
+
+} // namespace vrb
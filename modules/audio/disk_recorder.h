@@ -0,0 +1,128 @@
+// disk_recorder.h - Streaming session recorder for the binaural output
+// The audio thread hands blocks to a writer thread through a lock-free ring; only that thread touches the disk
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "ring_buffer.h"
+#include "simd/simd_dispatch.h"
+#include "wav_file.h"
+
+namespace vrb {
+
+struct DiskRecorderOptions {
+    WavSampleFormat format{WavSampleFormat::Int24};
+    bool dither{true};                      // TPDF on 16/24-bit samples
+    double bufferSeconds{4.0};              // Ring between the audio and writer threads
+    uint64_t preallocateBytes{256ull << 20}; // Reserved on disk ahead of the write position
+    bool directIO{true};                    // O_DIRECT where the platform and filesystem allow it
+    double headerIntervalSeconds{2.0};      // How often the header is rewritten with the current length
+    std::string description;                // BWF bext description
+};
+
+/**
+ * @brief Records interleaved float blocks to a Broadcast Wave file that grows past 4 GB
+ *
+ * Push is wait-free and never allocates or touches the filesystem: it copies
+ * the block into a ring, or drops the whole block and counts it when the
+ * ring is full. A writer thread drains the ring, converts to the file
+ * format and issues 1 MiB writes aligned for unbuffered I/O, extending a
+ * preallocated region ahead of itself. Samples start 4 KiB into the file,
+ * after a bext chunk and a placeholder that becomes the ds64 chunk of an
+ * RF64 file once the data passes the 32-bit RIFF limit. At every header
+ * interval the partial chunk is written too, padded out to an I/O block,
+ * and the header rewritten to cover it; the next write starts over the
+ * padding. A crash loses at most the last interval.
+ *
+ * Start and Stop run on a control thread; Push on one audio thread.
+ */
+class DiskRecorder {
+public:
+    static constexpr size_t HEADER_BYTES = 4096;            // Samples start here, aligned for O_DIRECT
+    static constexpr size_t WRITE_CHUNK_BYTES = 1u << 20;
+
+    struct Stats {
+        uint64_t framesPushed{0};           // Accepted from the audio thread
+        uint64_t framesWritten{0};          // On disk and covered by the header
+        uint64_t bytesWritten{0};           // Sample data on disk
+        uint64_t overflowFrames{0};         // Dropped because the ring was full
+        uint64_t overflowEvents{0};         // Blocks dropped
+        uint64_t writes{0};                 // Disk writes issued, header fix-ups excluded
+        bool directIO{false};
+        bool rf64{false};                   // The header switched to RF64
+    };
+
+    DiskRecorder();
+    ~DiskRecorder();
+
+    DiskRecorder(const DiskRecorder&) = delete;
+    DiskRecorder& operator=(const DiskRecorder&) = delete;
+
+    bool Start(const std::string& path, int sampleRate, int channels, const DiskRecorderOptions& options,
+               std::string& error);
+    // Drains everything pushed so far, finalizes the header and closes the file
+    bool Stop();
+    bool IsRecording() const { return m_active.load(std::memory_order_acquire); }
+
+    // Audio thread. false when not recording or when the block was dropped for lack of ring space.
+    bool Push(const float* interleaved, size_t frames);
+    // Audio thread. Lets a caller keep several recorders aligned: check every one, then Push all or Drop all.
+    bool HasSpace(size_t frames) const;
+    void Drop(size_t frames);
+
+    Stats GetStats() const;
+    const std::string& GetPath() const { return m_path; }
+
+private:
+    class File;
+
+    void WriterLoop();
+    size_t Drain();                         // Moves ring contents into the staging buffer; returns frames taken
+    bool FlushStaging(bool partial);        // partial: write what is staged even if the chunk is not full
+    bool WriteHeader(uint64_t dataBytes);
+
+    // Control state
+    std::string m_path;
+    std::unique_ptr<File> m_file;
+    std::thread m_writerThread;
+    std::atomic<bool> m_stopping{false};
+    bool m_writeFailed{false};
+
+    // Audio thread hand-off
+    std::atomic<bool> m_active{false};
+    mutable std::atomic<int> m_pushing{0};  // Audio thread calls in flight; Stop waits for zero before tearing down
+    std::unique_ptr<RingBuffer<float>> m_ring;
+
+    // Writer thread
+    WavInfo m_info;
+    DiskRecorderOptions m_options;
+    std::chrono::system_clock::time_point m_startTime;
+    simd::DitherState m_ditherState;
+    std::vector<float> m_drainBuffer;
+    std::vector<uint8_t> m_convertBuffer;
+    std::vector<uint8_t> m_stagingStorage;
+    uint8_t* m_staging{nullptr};            // WRITE_CHUNK_BYTES, aligned for O_DIRECT
+    size_t m_stagingBytes{0};
+    size_t m_stagingOnDisk{0};              // Leading staged bytes a partial write already put on disk
+    std::vector<uint8_t> m_headerStorage;
+    uint8_t* m_header{nullptr};             // HEADER_BYTES, aligned
+    uint64_t m_preallocatedTo{0};
+
+    // Statistics, written by the audio and writer threads
+    std::atomic<uint64_t> m_framesPushed{0};
+    std::atomic<uint64_t> m_bytesWritten{0};
+    std::atomic<uint64_t> m_headerBytes{0};  // Data bytes the header currently covers
+    std::atomic<uint64_t> m_overflowFrames{0};
+    std::atomic<uint64_t> m_overflowEvents{0};
+    std::atomic<uint64_t> m_writes{0};
+    std::atomic<bool> m_directIO{false};
+    std::atomic<bool> m_rf64{false};
+};
+
+} // namespace vrb
@@ -0,0 +1,294 @@
+// hrtf_cache.cpp - Precompiled HRTF dataset files
+// Writing, mapping and validation of the on-disk format; see hrtf_cache.h for the layout
+
+#include "hrtf_cache.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <type_traits>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace vrb {
+
+namespace {
+
+constexpr char MAGIC[8] = {'V', 'R', 'B', 'H', 'R', 'T', 'F', '\0'};
+
+// Little-endian on every supported target; the record size check rejects foreign layouts
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;
+    uint32_t sampleRate;
+    uint32_t filterCount;
+    uint32_t filterLength;
+    uint32_t filterRecordSize;
+    float maxDelay;
+    uint32_t sectionCount;
+    uint64_t fileSize;
+    uint64_t checksum;          // FNV-1a over bytes [headerSize, fileSize)
+    char key[HRTFCacheFile::MAX_KEY_LENGTH + 1];
+    uint8_t reserved[8];
+};
+static_assert(sizeof(FileHeader) % HRTFCacheFile::SECTION_ALIGNMENT == 0, "header must keep sections aligned");
+static_assert(std::is_trivially_copyable<FileHeader>::value, "header is written as raw bytes");
+
+struct SectionEntry {
+    uint32_t id;
+    uint32_t reserved;
+    uint64_t offset;
+    uint64_t size;
+};
+static_assert(sizeof(SectionEntry) == 24, "section entry layout is part of the format");
+
+constexpr uint64_t FNV_OFFSET = 0xcbf29ce484222325ULL;
+constexpr uint64_t FNV_PRIME = 0x100000001b3ULL;
+
+uint64_t Checksum(const uint8_t* data, size_t size, uint64_t hash = FNV_OFFSET) {
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ data[i]) * FNV_PRIME;
+    }
+    return hash;
+}
+
+size_t AlignUp(size_t value) {
+    return (value + HRTFCacheFile::SECTION_ALIGNMENT - 1) & ~(HRTFCacheFile::SECTION_ALIGNMENT - 1);
+}
+
+} // anonymous namespace
+
+HRTFCacheFile::~HRTFCacheFile() {
+    Close();
+}
+
+bool HRTFCacheFile::Write(const std::string& path, const Metadata& metadata,
+                          const std::vector<SectionData>& sections, std::string& error) {
+    if (metadata.key.size() > MAX_KEY_LENGTH) {
+        error = "cache key longer than " + std::to_string(MAX_KEY_LENGTH) + " characters";
+        return false;
+    }
+
+    // Header, section table, then each section on its own aligned offset
+    std::vector<SectionEntry> table(sections.size());
+    size_t offset = AlignUp(sizeof(FileHeader) + sizeof(SectionEntry) * sections.size());
+    for (size_t i = 0; i < sections.size(); ++i) {
+        table[i] = {static_cast<uint32_t>(sections[i].id), 0, offset, sections[i].size};
+        offset = AlignUp(offset + sections[i].size);
+    }
+
+    std::vector<uint8_t> image(offset, 0);
+    std::memcpy(image.data() + sizeof(FileHeader), table.data(), sizeof(SectionEntry) * table.size());
+    for (size_t i = 0; i < sections.size(); ++i) {
+        if (sections[i].size > 0) {
+            std::memcpy(image.data() + table[i].offset, sections[i].data, sections[i].size);
+        }
+    }
+
+    FileHeader header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.headerSize = sizeof(FileHeader);
+    header.sampleRate = metadata.sampleRate;
+    header.filterCount = metadata.filterCount;
+    header.filterLength = metadata.filterLength;
+    header.filterRecordSize = metadata.filterRecordSize;
+    header.maxDelay = metadata.maxDelay;
+    header.sectionCount = static_cast<uint32_t>(sections.size());
+    header.fileSize = image.size();
+    header.checksum = Checksum(image.data() + sizeof(FileHeader), image.size() - sizeof(FileHeader));
+    std::memcpy(header.key, metadata.key.data(), metadata.key.size());
+    std::memcpy(image.data(), &header, sizeof(header));
+
+    // Rename into place so a reader never maps a half-written file
+    const std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            error = "cannot create " + temporary;
+            return false;
+        }
+        file.write(reinterpret_cast<const char*>(image.data()), static_cast<std::streamsize>(image.size()));
+        if (!file) {
+            error = "write failed for " + temporary;
+            std::remove(temporary.c_str());
+            return false;
+        }
+    }
+
+#ifdef _WIN32
+    const bool renamed = MoveFileExA(temporary.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    const bool renamed = std::rename(temporary.c_str(), path.c_str()) == 0;
+#endif
+    if (!renamed) {
+        error = "cannot rename " + temporary + " to " + path;
+        std::remove(temporary.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool HRTFCacheFile::Open(const std::string& path, std::string& error) {
+    Close();
+    if (!Map(path, error)) {
+        return false;
+    }
+
+    auto fail = [this, &error](const std::string& reason) {
+        error = reason;
+        Close();
+        return false;
+    };
+
+    if (m_size < sizeof(FileHeader)) {
+        return fail("file too small for a header");
+    }
+    FileHeader header;
+    std::memcpy(&header, m_data, sizeof(header));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+        return fail("not an HRTF cache file");
+    }
+    if (header.version != VERSION) {
+        return fail("format version " + std::to_string(header.version) + ", expected " + std::to_string(VERSION));
+    }
+    if (header.headerSize != sizeof(FileHeader) || header.fileSize != m_size) {
+        return fail("truncated or resized file");
+    }
+    if (header.key[MAX_KEY_LENGTH] != '\0') {
+        return fail("unterminated cache key");
+    }
+    if (static_cast<uint64_t>(header.sectionCount) * sizeof(SectionEntry) > m_size - sizeof(FileHeader)) {
+        return fail("section table outside the file");
+    }
+    if (Checksum(m_data + sizeof(FileHeader), m_size - sizeof(FileHeader)) != header.checksum) {
+        return fail("checksum mismatch");
+    }
+
+    m_sections.clear();
+    const uint8_t* tableData = m_data + sizeof(FileHeader);
+    for (uint32_t i = 0; i < header.sectionCount; ++i) {
+        SectionEntry entry;
+        std::memcpy(&entry, tableData + i * sizeof(SectionEntry), sizeof(entry));
+        if (entry.offset % SECTION_ALIGNMENT != 0 || entry.offset > m_size || entry.size > m_size - entry.offset) {
+            return fail("section " + std::to_string(entry.id) + " outside the file");
+        }
+        m_sections.push_back({static_cast<Section>(entry.id), m_data + entry.offset, static_cast<size_t>(entry.size)});
+    }
+
+    m_metadata.sampleRate = header.sampleRate;
+    m_metadata.filterCount = header.filterCount;
+    m_metadata.filterLength = header.filterLength;
+    m_metadata.filterRecordSize = header.filterRecordSize;
+    m_metadata.maxDelay = header.maxDelay;
+    m_metadata.key = header.key;
+    return true;
+}
+
+const void* HRTFCacheFile::GetSection(Section id, size_t& size) const {
+    auto it = std::find_if(m_sections.begin(), m_sections.end(),
+                           [id](const SectionData& section) { return section.id == id; });
+    if (it == m_sections.end()) {
+        size = 0;
+        return nullptr;
+    }
+    size = it->size;
+    return it->data;
+}
+
+#ifdef _WIN32
+bool HRTFCacheFile::Map(const std::string& path, std::string& error) {
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        error = "cannot open " + path;
+        return false;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        CloseHandle(file);
+        error = "empty or unreadable file";
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    const void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!view) {
+        if (mapping) CloseHandle(mapping);
+        CloseHandle(file);
+        error = "cannot map " + path;
+        return false;
+    }
+    m_file = file;
+    m_mapping = mapping;
+    m_data = static_cast<const uint8_t*>(view);
+    m_size = static_cast<size_t>(size.QuadPart);
+    return true;
+}
+
+void HRTFCacheFile::Close() {
+    if (m_data) {
+        UnmapViewOfFile(m_data);
+    }
+    if (m_mapping) {
+        CloseHandle(m_mapping);
+    }
+    if (m_file) {
+        CloseHandle(m_file);
+    }
+    m_data = nullptr;
+    m_size = 0;
+    m_mapping = nullptr;
+    m_file = nullptr;
+    m_sections.clear();
+    m_metadata = Metadata();
+}
+#else
+bool HRTFCacheFile::Map(const std::string& path, std::string& error) {
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        error = "cannot open " + path + ": " + std::strerror(errno);
+        return false;
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || info.st_size <= 0) {
+        ::close(fd);
+        error = "empty or unreadable file";
+        return false;
+    }
+    const size_t size = static_cast<size_t>(info.st_size);
+    void* view = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);    // The mapping keeps the file referenced
+    if (view == MAP_FAILED) {
+        error = "cannot map " + path + ": " + std::strerror(errno);
+        return false;
+    }
+    m_data = static_cast<const uint8_t*>(view);
+    m_size = size;
+    return true;
+}
+
+void HRTFCacheFile::Close() {
+    if (m_data) {
+        ::munmap(const_cast<uint8_t*>(m_data), m_size);
+    }
+    m_data = nullptr;
+    m_size = 0;
+    m_sections.clear();
+    m_metadata = Metadata();
+}
+#endif
+
+} // namespace vrb
@@ -0,0 +1,89 @@
+// hrtf_cache.h - Precompiled HRTF dataset files
+// Versioned, checksummed binary images of a processed dataset that are mapped read-only at startup
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace vrb {
+
+/**
+ * @brief Memory-mapped precompiled HRTF dataset
+ *
+ * A file is a fixed header, a section table and the sections themselves, each
+ * starting on a 64-byte boundary. Sections hold the processed dataset in the
+ * exact in-memory layout the HRTF processor renders from (filter records,
+ * directions, triangulation), so an opened file is used in place: nothing is
+ * parsed or copied, and every process on the host shares the same page-cache
+ * copy. The header carries a format version, the filter record size (which
+ * catches layout changes), a key naming the dataset and processing settings,
+ * and a checksum over everything after the header.
+ *
+ * Files are written to a temporary name and renamed into place, so readers
+ * never see a partial file.
+ */
+class HRTFCacheFile {
+public:
+    static constexpr uint32_t VERSION = 1;
+    static constexpr size_t SECTION_ALIGNMENT = 64;
+    static constexpr size_t MAX_KEY_LENGTH = 191;
+
+    enum class Section : uint32_t {
+        Positions = 1,      // HRTFData::Position per filter
+        Filters = 2,        // HRTFData::Filter records
+        Triangles = 3,      // Triangulation filter indices
+        InverseBases = 4,   // Triangulation barycentric bases
+        Lookup = 5          // Triangulation direction lookup table
+    };
+
+    struct Metadata {
+        uint32_t sampleRate{0};         // Rate the filters are sampled at
+        uint32_t filterCount{0};
+        uint32_t filterLength{0};       // Taps in use per ear
+        uint32_t filterRecordSize{0};   // Bytes per Filters record
+        float maxDelay{0.0f};           // Largest ear delay in samples
+        std::string key;                // Dataset identity and processing settings
+    };
+
+    struct SectionData {
+        Section id;
+        const void* data;
+        size_t size;
+    };
+
+    HRTFCacheFile() = default;
+    ~HRTFCacheFile();
+    HRTFCacheFile(const HRTFCacheFile&) = delete;
+    HRTFCacheFile& operator=(const HRTFCacheFile&) = delete;
+
+    static bool Write(const std::string& path, const Metadata& metadata,
+                      const std::vector<SectionData>& sections, std::string& error);
+
+    // Maps the file and validates header, section table and checksum
+    bool Open(const std::string& path, std::string& error);
+    void Close();
+
+    bool IsOpen() const { return m_data != nullptr; }
+    const Metadata& GetMetadata() const { return m_metadata; }
+    size_t GetMappedSize() const { return m_size; }
+
+    // Section contents inside the mapping, or nullptr when the file has no such section
+    const void* GetSection(Section id, size_t& size) const;
+
+private:
+    bool Map(const std::string& path, std::string& error);
+
+    const uint8_t* m_data{nullptr};
+    size_t m_size{0};
+    Metadata m_metadata;
+    std::vector<SectionData> m_sections;
+#ifdef _WIN32
+    void* m_file{nullptr};
+    void* m_mapping{nullptr};
+#endif
+};
+
+} // namespace vrb
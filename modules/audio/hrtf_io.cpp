@@ -0,0 +1,351 @@
+// hrtf_io.cpp - Decoding of measured HRTF datasets
+// WAV and SOFA readers plus the load-time impulse response resampler
+
+#define _USE_MATH_DEFINES
+#include "hrtf_io.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+
+#if VRB_HAVE_SOFA
+#include <hdf5.h>
+#endif
+
+namespace vrb {
+namespace hrtf_io {
+
+namespace {
+
+constexpr uint16_t WAVE_FORMAT_PCM = 0x0001;
+constexpr uint16_t WAVE_FORMAT_IEEE_FLOAT = 0x0003;
+constexpr uint16_t WAVE_FORMAT_EXTENSIBLE = 0xFFFE;
+
+uint16_t ReadU16(const uint8_t* data) {
+    return static_cast<uint16_t>(data[0] | (data[1] << 8));
+}
+
+uint32_t ReadU32(const uint8_t* data) {
+    return static_cast<uint32_t>(data[0]) | (static_cast<uint32_t>(data[1]) << 8) |
+           (static_cast<uint32_t>(data[2]) << 16) | (static_cast<uint32_t>(data[3]) << 24);
+}
+
+float DecodeSample(const uint8_t* data, uint16_t format, int bytes) {
+    switch (bytes) {
+        case 2:
+            return static_cast<int16_t>(ReadU16(data)) / 32768.0f;
+        case 3: {
+            const uint32_t bits = (static_cast<uint32_t>(data[0]) << 8) | (static_cast<uint32_t>(data[1]) << 16) |
+                                  (static_cast<uint32_t>(data[2]) << 24);
+            return (static_cast<int32_t>(bits) >> 8) / 8388608.0f;
+        }
+        case 4: {
+            const uint32_t bits = ReadU32(data);
+            if (format == WAVE_FORMAT_IEEE_FLOAT) {
+                float value;
+                std::memcpy(&value, &bits, sizeof(value));
+                return value;
+            }
+            return static_cast<float>(static_cast<int32_t>(bits) / 2147483648.0);
+        }
+        default:
+            return 0.0f;
+    }
+}
+
+// Zeroth-order modified Bessel function of the first kind, for the Kaiser window
+double BesselI0(double x) {
+    double sum = 1.0, term = 1.0;
+    for (int k = 1; k < 64 && term > sum * 1e-17; ++k) {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+    }
+    return sum;
+}
+
+} // anonymous namespace
+
+bool ReadWav(const std::string& path, WavData& wav, std::string& error) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        error = "cannot open " + path;
+        return false;
+    }
+    std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (bytes.size() < 12 || std::memcmp(bytes.data(), "RIFF", 4) != 0 || std::memcmp(bytes.data() + 8, "WAVE", 4) != 0) {
+        error = path + " is not a RIFF/WAVE file";
+        return false;
+    }
+
+    uint16_t format = 0, channels = 0, bitsPerSample = 0;
+    uint32_t sampleRate = 0;
+    const uint8_t* samples = nullptr;
+    size_t sampleBytes = 0;
+    for (size_t offset = 12; offset + 8 <= bytes.size();) {
+        const uint8_t* chunk = bytes.data() + offset;
+        const size_t size = std::min<size_t>(ReadU32(chunk + 4), bytes.size() - offset - 8);
+        if (std::memcmp(chunk, "fmt ", 4) == 0 && size >= 16) {
+            format = ReadU16(chunk + 8);
+            channels = ReadU16(chunk + 10);
+            sampleRate = ReadU32(chunk + 12);
+            bitsPerSample = ReadU16(chunk + 22);
+            if (format == WAVE_FORMAT_EXTENSIBLE && size >= 40) {
+                format = ReadU16(chunk + 32);   // First two bytes of the SubFormat GUID
+            }
+        } else if (std::memcmp(chunk, "data", 4) == 0) {
+            samples = chunk + 8;
+            sampleBytes = size;
+        }
+        offset += 8 + size + (size & 1);    // Chunks are word aligned
+    }
+
+    const int bytesPerSample = bitsPerSample / 8;
+    const bool supported = (format == WAVE_FORMAT_PCM && (bitsPerSample == 16 || bitsPerSample == 24 || bitsPerSample == 32)) ||
+                           (format == WAVE_FORMAT_IEEE_FLOAT && bitsPerSample == 32);
+    if (!supported || channels == 0 || sampleRate == 0 || !samples) {
+        error = path + ": unsupported WAV (format " + std::to_string(format) + ", " +
+                std::to_string(bitsPerSample) + " bit, " + std::to_string(channels) + " channels)";
+        return false;
+    }
+
+    const size_t frames = sampleBytes / (static_cast<size_t>(bytesPerSample) * channels);
+    wav.sampleRate = static_cast<int>(sampleRate);
+    wav.channels.assign(channels, std::vector<float>(frames));
+    for (size_t frame = 0; frame < frames; ++frame) {
+        for (uint16_t channel = 0; channel < channels; ++channel) {
+            const uint8_t* sample = samples + (frame * channels + channel) * bytesPerSample;
+            wav.channels[channel][frame] = DecodeSample(sample, format, bytesPerSample);
+        }
+    }
+    return true;
+}
+
+#if VRB_HAVE_SOFA
+namespace {
+
+// Closes an HDF5 handle on scope exit
+class H5Handle {
+public:
+    H5Handle(hid_t id, herr_t (*close)(hid_t)) : m_id(id), m_close(close) {}
+    ~H5Handle() {
+        if (m_id >= 0) m_close(m_id);
+    }
+    H5Handle(const H5Handle&) = delete;
+    H5Handle& operator=(const H5Handle&) = delete;
+    hid_t get() const { return m_id; }
+    bool valid() const { return m_id >= 0; }
+
+private:
+    hid_t m_id;
+    herr_t (*m_close)(hid_t);
+};
+
+bool ReadDataset(hid_t file, const char* name, std::vector<float>& values, std::vector<hsize_t>& dims) {
+    if (H5Lexists(file, name, H5P_DEFAULT) <= 0) {
+        return false;
+    }
+    H5Handle dataset(H5Dopen2(file, name, H5P_DEFAULT), H5Dclose);
+    H5Handle space(dataset.valid() ? H5Dget_space(dataset.get()) : -1, H5Sclose);
+    if (!space.valid()) {
+        return false;
+    }
+    const int rank = H5Sget_simple_extent_ndims(space.get());
+    dims.assign(static_cast<size_t>(std::max(rank, 0)), 0);
+    if (rank < 0 || H5Sget_simple_extent_dims(space.get(), dims.data(), nullptr) < 0) {
+        return false;
+    }
+    const hsize_t count = std::accumulate(dims.begin(), dims.end(), hsize_t(1), std::multiplies<hsize_t>());
+    values.resize(static_cast<size_t>(count));
+    return count == 0 || H5Dread(dataset.get(), H5T_NATIVE_FLOAT, H5S_ALL, H5S_ALL, H5P_DEFAULT, values.data()) >= 0;
+}
+
+std::string ReadStringAttribute(hid_t object, const char* name) {
+    if (H5Aexists(object, name) <= 0) {
+        return "";
+    }
+    H5Handle attribute(H5Aopen(object, name, H5P_DEFAULT), H5Aclose);
+    H5Handle type(attribute.valid() ? H5Aget_type(attribute.get()) : -1, H5Tclose);
+    if (!type.valid() || H5Tget_class(type.get()) != H5T_STRING) {
+        return "";
+    }
+
+    H5Handle memoryType(H5Tcopy(type.get()), H5Tclose);
+    if (H5Tis_variable_str(type.get()) > 0) {
+        char* value = nullptr;
+        if (H5Aread(attribute.get(), memoryType.get(), &value) < 0 || !value) {
+            return "";
+        }
+        std::string result(value);
+        H5free_memory(value);
+        return result;
+    }
+    std::string value(H5Tget_size(type.get()), '\0');
+    if (H5Aread(attribute.get(), memoryType.get(), &value[0]) < 0) {
+        return "";
+    }
+    return value.substr(0, value.find('\0'));
+}
+
+// Value of row m of a SOFA variable that is either per measurement (M x n) or shared (1 x n)
+const float* Row(const std::vector<float>& values, const std::vector<hsize_t>& dims, size_t m) {
+    const size_t rowLength = dims.size() > 1 ? static_cast<size_t>(dims[1]) : 1;
+    const size_t rows = dims.empty() ? 0 : static_cast<size_t>(dims[0]);
+    return values.data() + (rows > 1 ? m : 0) * rowLength;
+}
+
+} // anonymous namespace
+
+bool IsSOFASupported() {
+    return true;
+}
+
+bool ReadSOFA(const std::string& path, SOFAData& sofa, std::string& error) {
+    // HDF5 prints its own error stack by default; failures are reported through error instead
+    H5Eset_auto2(H5E_DEFAULT, nullptr, nullptr);
+
+    H5Handle file(H5Fopen(path.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT), H5Fclose);
+    if (!file.valid()) {
+        error = "cannot open " + path + " as HDF5/netCDF-4";
+        return false;
+    }
+    if (ReadStringAttribute(file.get(), "Conventions") != "SOFA") {
+        error = path + " is not a SOFA file";
+        return false;
+    }
+
+    std::vector<float> ir, rate, positions, delays;
+    std::vector<hsize_t> irDims, rateDims, positionDims, delayDims;
+    if (!ReadDataset(file.get(), "Data.IR", ir, irDims) || irDims.size() != 3 || irDims[1] != 2) {
+        error = path + ": Data.IR must be measurements x 2 receivers x samples";
+        return false;
+    }
+    if (!ReadDataset(file.get(), "Data.SamplingRate", rate, rateDims) || rate.empty() || !(rate[0] > 0.0f)) {
+        error = path + ": missing Data.SamplingRate";
+        return false;
+    }
+    if (!ReadDataset(file.get(), "SourcePosition", positions, positionDims) ||
+        positionDims.size() != 2 || positionDims[1] != 3) {
+        error = path + ": SourcePosition must be measurements x 3";
+        return false;
+    }
+    const bool hasDelays = ReadDataset(file.get(), "Data.Delay", delays, delayDims) &&
+                           delayDims.size() == 2 && delayDims[1] == 2;
+
+    std::string type, units;
+    {
+        H5Handle dataset(H5Dopen2(file.get(), "SourcePosition", H5P_DEFAULT), H5Dclose);
+        type = ReadStringAttribute(dataset.get(), "Type");
+        units = ReadStringAttribute(dataset.get(), "Units");
+    }
+    const bool cartesian = type == "cartesian";
+    const bool radians = units.find("radian") != std::string::npos;
+
+    sofa.sampleRate = static_cast<int>(std::lround(rate[0]));
+    sofa.measurementCount = static_cast<size_t>(irDims[0]);
+    sofa.length = static_cast<size_t>(irDims[2]);
+    sofa.impulseResponses = std::move(ir);
+    sofa.directions.resize(sofa.measurementCount);
+    sofa.delays.assign(sofa.measurementCount, {{0.0f, 0.0f}});
+    for (size_t m = 0; m < sofa.measurementCount; ++m) {
+        const float* position = Row(positions, positionDims, m);
+        double azimuth, elevation;
+        if (cartesian) {
+            // SOFA: x front, y left, z up
+            azimuth = std::atan2(position[1], position[0]) * 180.0 / M_PI;
+            elevation = std::atan2(position[2], std::hypot(position[0], position[1])) * 180.0 / M_PI;
+        } else {
+            const double scale = radians ? 180.0 / M_PI : 1.0;
+            azimuth = position[0] * scale;
+            elevation = position[1] * scale;
+        }
+
+        // SOFA azimuth runs counter-clockwise (to the left); ours is +right in (-180, 180]
+        azimuth = std::remainder(-azimuth, 360.0);
+        sofa.directions[m] = {{static_cast<float>(azimuth), static_cast<float>(elevation)}};
+        if (hasDelays) {
+            const float* delay = Row(delays, delayDims, m);
+            sofa.delays[m] = {{delay[0], delay[1]}};
+        }
+    }
+    return true;
+}
+#else
+bool IsSOFASupported() {
+    return false;
+}
+
+bool ReadSOFA(const std::string& path, SOFAData&, std::string& error) {
+    error = "cannot read " + path + ": built without SOFA support (HDF5 not found)";
+    return false;
+}
+#endif
+
+ImpulseResponseResampler::ImpulseResponseResampler(int sourceRate, int targetRate) {
+    const int divisor = std::gcd(std::max(1, sourceRate), std::max(1, targetRate));
+    m_up = std::max(1, targetRate) / divisor;
+    m_down = std::max(1, sourceRate) / divisor;
+    if (IsIdentity()) {
+        return;
+    }
+
+    // Band limit to the lower of the two Nyquist rates, in units of source samples
+    const double cutoff = PASSBAND * std::min(1.0, static_cast<double>(m_up) / m_down);
+    const double halfWidth = HALF_TAPS / cutoff;
+    const int reach = static_cast<int>(std::ceil(halfWidth));
+    m_firstTap = -reach;
+    m_taps = 2 * reach + 1;
+
+    // Phase p serves outputs whose position lies p/up past an input sample. Scaling by
+    // down/up turns the unity-DC interpolator into an impulse response resampler
+    const double scale = static_cast<double>(m_down) / m_up;
+    const double norm = BesselI0(KAISER_BETA);
+    m_phases.assign(static_cast<size_t>(m_up) * m_taps, 0.0);
+    for (int p = 0; p < m_up; ++p) {
+        const double fraction = static_cast<double>(p) / m_up;
+        for (int t = 0; t < m_taps; ++t) {
+            const double u = fraction - (m_firstTap + t);
+            if (std::abs(u) >= halfWidth) {
+                continue;
+            }
+            const double x = M_PI * cutoff * u;
+            const double sinc = (std::abs(x) < 1e-12) ? 1.0 : std::sin(x) / x;
+            const double ratio = u / halfWidth;
+            const double window = BesselI0(KAISER_BETA * std::sqrt(1.0 - ratio * ratio)) / norm;
+            m_phases[static_cast<size_t>(p) * m_taps + t] = scale * cutoff * sinc * window;
+        }
+    }
+}
+
+size_t ImpulseResponseResampler::GetOutputLength(size_t inputLength) const {
+    return (inputLength * m_up + m_down - 1) / m_down;
+}
+
+void ImpulseResponseResampler::Process(const float* input, size_t inputLength, std::vector<float>& output) const {
+    if (IsIdentity()) {
+        output.assign(input, input + inputLength);
+        return;
+    }
+
+    output.assign(GetOutputLength(inputLength), 0.0f);
+    const long long length = static_cast<long long>(inputLength);
+    for (size_t n = 0; n < output.size(); ++n) {
+        const long long position = static_cast<long long>(n) * m_down;
+        const long long base = position / m_up;
+        const double* phase = m_phases.data() + static_cast<size_t>(position % m_up) * m_taps;
+
+        // Taps that would read before the start or past the end of the input see zeros
+        const long long first = std::max(0LL, -(base + m_firstTap));
+        const long long last = std::min<long long>(m_taps, length - (base + m_firstTap));
+        double sum = 0.0;
+        for (long long t = first; t < last; ++t) {
+            sum += phase[t] * input[base + m_firstTap + t];
+        }
+        output[n] = static_cast<float>(sum);
+    }
+}
+
+} // namespace hrtf_io
+} // namespace vrb
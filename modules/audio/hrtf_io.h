@@ -0,0 +1,85 @@
+// hrtf_io.h - Decoding of measured HRTF datasets
+// WAV impulse responses (MIT KEMAR), SOFA files and load-time resampling of HRIRs
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace vrb {
+
+// One measured direction: the head-related impulse response of each ear
+struct HRIRMeasurement {
+    float azimuth{0.0f};        // Degrees, +right
+    float elevation{0.0f};      // Degrees, +up
+    std::vector<float> left;
+    std::vector<float> right;
+};
+
+namespace hrtf_io {
+
+struct WavData {
+    int sampleRate{0};
+    std::vector<std::vector<float>> channels;   // Deinterleaved, full scale = 1.0
+};
+
+// PCM 16/24/32-bit and 32-bit float, plain or WAVE_FORMAT_EXTENSIBLE
+bool ReadWav(const std::string& path, WavData& wav, std::string& error);
+
+/**
+ * @brief Measurements of a SOFA (AES69) SimpleFreeFieldHRIR file
+ *
+ * Impulse responses are stored measurement-major, left ear then right ear,
+ * exactly as in Data.IR. Directions are already converted from SOFA's
+ * counter-clockwise azimuth to this project's +right convention, and
+ * Data.Delay is given per measurement and ear in samples.
+ */
+struct SOFAData {
+    int sampleRate{0};
+    size_t measurementCount{0};
+    size_t length{0};                           // Samples per impulse response
+    std::vector<float> impulseResponses;        // measurementCount x 2 x length
+    std::vector<std::array<float, 2>> directions;   // Azimuth, elevation per measurement
+    std::vector<std::array<float, 2>> delays;       // Left, right per measurement
+
+    const float* Response(size_t measurement, int ear) const {
+        return impulseResponses.data() + (measurement * 2 + static_cast<size_t>(ear)) * length;
+    }
+};
+
+// False when the build has no HDF5 (SOFA files are netCDF-4, i.e. HDF5)
+bool IsSOFASupported();
+bool ReadSOFA(const std::string& path, SOFAData& sofa, std::string& error);
+
+/**
+ * @brief Windowed-sinc polyphase resampler for impulse responses
+ *
+ * Built once per rate pair and shared read-only by the load workers. The
+ * ratio is reduced to L/M and every output sample is one dot product with
+ * one of L precomputed Kaiser-windowed sinc phases. Output is scaled by
+ * M/L so the resampled response keeps the same frequency response gain.
+ */
+class ImpulseResponseResampler {
+public:
+    ImpulseResponseResampler(int sourceRate, int targetRate);
+
+    bool IsIdentity() const { return m_up == m_down; }
+    size_t GetOutputLength(size_t inputLength) const;
+    void Process(const float* input, size_t inputLength, std::vector<float>& output) const;
+
+private:
+    static constexpr int HALF_TAPS = 16;            // Zero crossings each side at the source rate
+    static constexpr double KAISER_BETA = 8.6;      // About 90 dB stopband
+    static constexpr double PASSBAND = 0.95;        // Cutoff relative to the lower Nyquist
+
+    int m_up{1};
+    int m_down{1};
+    int m_taps{0};                  // Per phase
+    int m_firstTap{0};              // Input offset of tap 0 relative to the base sample
+    std::vector<double> m_phases;   // m_up x m_taps
+};
+
+} // namespace hrtf_io
+} // namespace vrb
@@ -3,24 +3,530 @@
 #define _USE_MATH_DEFINES
 #include <cmath>
 #include <algorithm>
+#include <chrono>
+#include <cstdio>
 #include <cstring>
+#include <limits>
+#include <type_traits>
+#include <unordered_map>
 #include "hrtf_processor.h"
+#include "config.h"
+#include "hrtf_io.h"
 #include "logger.h"
+#include "realtime_check.h"
+#include "simd/audio_simd.h"
+#include "worker_pool.h"
 
 namespace vrb {
 
+namespace {
+
+// Below this length the direct loop beats the FFT round trip
+constexpr int AUTO_FFT_MIN_FILTER_LENGTH = 64;
+
+bool UseFFTConvolution(const std::string& method, int filterLength) {
+    if (method == "direct" || method == "time_domain") {
+        return false;
+    }
+    if (method == "auto") {
+        return filterLength >= AUTO_FFT_MIN_FILTER_LENGTH;
+    }
+    if (method != "overlap_save" && method != "overlap_add" &&
+        method != "partitioned" && method != "fft") {
+        LOG_WARN("Unknown convolution method '{}', using partitioned FFT", method);
+    }
+    return true;
+}
+
+// processing.crossfade_samples from the dataset description file, if present
+int LoadCrossfadeSamples(const std::string& datasetConfigPath, int fallback) {
+    std::ifstream file(datasetConfigPath);
+    if (!file.is_open()) {
+        return fallback;
+    }
+
+    Json::Value root;
+    Json::CharReaderBuilder builder;
+    std::string errors;
+    if (!Json::parseFromStream(builder, file, &root, &errors)) {
+        LOG_WARN("Could not parse HRTF dataset config {}: {}", datasetConfigPath, errors);
+        return fallback;
+    }
+
+    const Json::Value& value = root["hrtf"]["processing"]["crossfade_samples"];
+    return value.isInt() ? value.asInt() : fallback;
+}
+
+// Where a dataset path leads and a fingerprint of its files for the cache key
+struct DatasetSource {
+    enum class Format { Synthetic, MITKEMARCompact, MITKEMARFull, SOFA };
+    Format format{Format::Synthetic};
+    std::string location;
+    std::string key{"synthetic-v1"};
+};
+
+// MIT KEMAR file names: H<elevation>e<azimuth>a.wav (compact) or L/R... (one ear per file)
+bool ParseKEMARName(const std::string& name, char& prefix, int& elevation, int& azimuth) {
+    char tail[8] = {};
+    if (std::sscanf(name.c_str(), "%c%de%da%7s", &prefix, &elevation, &azimuth, tail) != 4) {
+        return false;
+    }
+    return std::string(tail) == ".wav" || std::string(tail) == ".WAV";
+}
+
+// Sub-directories named elev<degrees>, sorted by elevation
+std::vector<std::pair<int, std::filesystem::path>> ListElevationDirectories(const std::filesystem::path& root) {
+    std::vector<std::pair<int, std::filesystem::path>> directories;
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(root, error)) {
+        const std::string name = entry.path().filename().string();
+        int elevation = 0;
+        if (entry.is_directory() && std::sscanf(name.c_str(), "elev%d", &elevation) == 1) {
+            directories.emplace_back(elevation, entry.path());
+        }
+    }
+    std::sort(directories.begin(), directories.end());
+    return directories;
+}
+
+DatasetSource ResolveDatasetSource(const std::string& path) {
+    namespace fs = std::filesystem;
+    DatasetSource source;
+    std::error_code error;
+    if (path.empty() || !fs::exists(path, error)) {
+        return source;
+    }
+
+    auto isSOFA = [](const fs::path& file) {
+        std::string extension = file.extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+        return extension == ".sofa";
+    };
+
+    fs::path location;
+    if (fs::is_regular_file(path, error) && isSOFA(path)) {
+        source.format = DatasetSource::Format::SOFA;
+        location = path;
+    } else if (fs::is_directory(path, error)) {
+        // The shipped layout is <dataPath>/mit_kemar_compact/elev*/H*e*a.wav
+        fs::path root = path;
+        if (fs::is_directory(root / "mit_kemar_compact", error)) {
+            root /= "mit_kemar_compact";
+        }
+        for (const auto& directory : ListElevationDirectories(root)) {
+            for (const auto& entry : fs::directory_iterator(directory.second, error)) {
+                char prefix = 0;
+                int elevation = 0, azimuth = 0;
+                if (ParseKEMARName(entry.path().filename().string(), prefix, elevation, azimuth) &&
+                    (prefix == 'H' || prefix == 'L')) {
+                    source.format = (prefix == 'H') ? DatasetSource::Format::MITKEMARCompact
+                                                    : DatasetSource::Format::MITKEMARFull;
+                    location = root;
+                    break;
+                }
+            }
+            if (source.format != DatasetSource::Format::Synthetic) {
+                break;
+            }
+        }
+
+        // Otherwise the first SOFA file in the directory
+        if (source.format == DatasetSource::Format::Synthetic) {
+            std::vector<fs::path> files;
+            for (const auto& entry : fs::directory_iterator(path, error)) {
+                if (entry.is_regular_file() && isSOFA(entry.path())) {
+                    files.push_back(entry.path());
+                }
+            }
+            if (!files.empty()) {
+                std::sort(files.begin(), files.end());
+                source.format = DatasetSource::Format::SOFA;
+                location = files.front();
+            }
+        }
+    }
+    if (source.format == DatasetSource::Format::Synthetic) {
+        return source;
+    }
+
+    // Count, total size and newest modification time stand in for the contents
+    size_t files = 0;
+    uintmax_t bytes = 0;
+    fs::file_time_type newest{};
+    auto account = [&](const fs::path& file) {
+        ++files;
+        bytes += fs::file_size(file, error);
+        newest = std::max(newest, fs::last_write_time(file, error));
+    };
+    if (fs::is_directory(location, error)) {
+        for (const auto& entry : fs::recursive_directory_iterator(location, error)) {
+            if (entry.is_regular_file()) {
+                account(entry.path());
+            }
+        }
+    } else {
+        account(location);
+    }
+
+    // Hashed so long paths still fit the cache file's key field
+    static const char* const FORMAT_NAMES[] = {"synthetic", "mit-kemar-compact", "mit-kemar-full", "sofa"};
+    source.location = fs::absolute(location, error).lexically_normal().string();
+    const std::string identity = source.location + "|" + std::to_string(files) + "|" + std::to_string(bytes) +
+                                 "|" + std::to_string(newest.time_since_epoch().count());
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (unsigned char c : identity) {
+        hash = (hash ^ c) * 0x100000001b3ULL;
+    }
+    char digest[17];
+    std::snprintf(digest, sizeof(digest), "%016llx", static_cast<unsigned long long>(hash));
+    source.key = std::string(FORMAT_NAMES[static_cast<int>(source.format)]) + "-" + digest;
+    return source;
+}
+
+// Ear delays are kept at least this large so the Lagrange delay line can read one sample ahead
+constexpr float MIN_EAR_DELAY_SAMPLES = 1.0f;
+
+// In-place radix-2 complex FFT for load-time analysis; size must be a power of two
+void TransformInPlace(std::vector<std::complex<double>>& data, bool inverse) {
+    const size_t size = data.size();
+    for (size_t i = 1, j = 0; i < size; ++i) {
+        size_t bit = size >> 1;
+        for (; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j) {
+            std::swap(data[i], data[j]);
+        }
+    }
+
+    // Explicit real arithmetic: std::complex multiplication goes through the slow NaN-checking path
+    double* values = reinterpret_cast<double*>(data.data());
+    for (size_t length = 2; length <= size; length <<= 1) {
+        const double angle = (inverse ? 2.0 : -2.0) * M_PI / static_cast<double>(length);
+        const double stepRe = std::cos(angle), stepIm = std::sin(angle);
+        const size_t half = length / 2;
+        for (size_t start = 0; start < size; start += length) {
+            double twiddleRe = 1.0, twiddleIm = 0.0;
+            for (size_t k = 0; k < half; ++k) {
+                double* even = values + 2 * (start + k);
+                double* odd = values + 2 * (start + k + half);
+                const double oddRe = odd[0] * twiddleRe - odd[1] * twiddleIm;
+                const double oddIm = odd[0] * twiddleIm + odd[1] * twiddleRe;
+                odd[0] = even[0] - oddRe;
+                odd[1] = even[1] - oddIm;
+                even[0] += oddRe;
+                even[1] += oddIm;
+                const double nextRe = twiddleRe * stepRe - twiddleIm * stepIm;
+                twiddleIm = twiddleRe * stepIm + twiddleIm * stepRe;
+                twiddleRe = nextRe;
+            }
+        }
+    }
+
+    if (inverse) {
+        for (auto& value : data) {
+            value /= static_cast<double>(size);
+        }
+    }
+}
+
+/**
+ * Split an HRIR into its minimum-phase equivalent (real-cepstrum folding),
+ * truncated to `taps` with a short fade-out, and the delay of its excess
+ * phase, found as the cross-correlation peak between the two. Returns the
+ * delay in samples.
+ */
+float DecomposeImpulseResponse(const float* impulse, int length, float* minimumPhase, int taps) {
+    size_t size = 1;
+    while (size < static_cast<size_t>(length) * 4) {
+        size <<= 1;  // Oversampled so the folded cepstrum does not alias
+    }
+
+    std::vector<std::complex<double>> spectrum(size, {0.0, 0.0});
+    for (int i = 0; i < length; ++i) {
+        spectrum[i] = impulse[i];
+    }
+    TransformInPlace(spectrum, false);
+
+    // Log magnitude with a -100 dB floor relative to the peak
+    double peakPower = 0.0;
+    for (const auto& bin : spectrum) {
+        peakPower = std::max(peakPower, std::norm(bin));
+    }
+    if (peakPower <= 0.0) {
+        std::fill(minimumPhase, minimumPhase + taps, 0.0f);
+        return 0.0f;
+    }
+    std::vector<std::complex<double>> cepstrum(size);
+    for (size_t k = 0; k < size; ++k) {
+        cepstrum[k] = 0.5 * std::log(std::max(std::norm(spectrum[k]), peakPower * 1e-10));
+    }
+    TransformInPlace(cepstrum, true);
+
+    // Fold the anti-causal part of the cepstrum onto the causal part
+    for (size_t n = 1; n < size / 2; ++n) {
+        cepstrum[n] = 2.0 * cepstrum[n].real();
+        cepstrum[size - n] = 0.0;
+    }
+    cepstrum[0] = cepstrum[0].real();
+    cepstrum[size / 2] = cepstrum[size / 2].real();
+    TransformInPlace(cepstrum, false);
+
+    std::vector<std::complex<double>> minimumSpectrum(size);
+    for (size_t k = 0; k < size; ++k) {
+        const double magnitude = std::exp(cepstrum[k].real());
+        minimumSpectrum[k] = {magnitude * std::cos(cepstrum[k].imag()), magnitude * std::sin(cepstrum[k].imag())};
+    }
+
+    // Excess-phase delay: correlation of the original against its minimum-phase version
+    std::vector<std::complex<double>> correlation(size);
+    for (size_t k = 0; k < size; ++k) {
+        const double re = spectrum[k].real(), im = spectrum[k].imag();
+        const double minRe = minimumSpectrum[k].real(), minIm = minimumSpectrum[k].imag();
+        correlation[k] = {re * minRe + im * minIm, im * minRe - re * minIm};
+    }
+    TransformInPlace(correlation, true);
+
+    int lag = 0;
+    for (int k = 1; k < length; ++k) {
+        if (correlation[k].real() > correlation[lag].real()) {
+            lag = k;
+        }
+    }
+    const double before = correlation[(lag + size - 1) % size].real();
+    const double centre = correlation[lag].real();
+    const double after = correlation[lag + 1].real();
+    const double curvature = before - 2.0 * centre + after;
+    const double offset = (curvature < 0.0) ? std::clamp(0.5 * (before - after) / curvature, -0.5, 0.5) : 0.0;
+
+    TransformInPlace(minimumSpectrum, true);
+    const int fadeLength = std::max(1, taps / 8);
+    for (int i = 0; i < taps; ++i) {
+        float gain = 1.0f;
+        if (i >= taps - fadeLength) {
+            gain = static_cast<float>(0.5 * (1.0 + std::cos(M_PI * (i - (taps - fadeLength) + 1) / (fadeLength + 1))));
+        }
+        minimumPhase[i] = static_cast<float>(minimumSpectrum[i].real()) * gain;
+    }
+
+    return static_cast<float>(std::max(0.0, lag + offset));
+}
+
+// Third-order Lagrange weights for x[n-D-2], x[n-D-1], x[n-D], x[n-D+1] at delay D + fraction
+std::array<float, 4> LagrangeCoefficients(float fraction) {
+    const float t = -fraction;
+    return {{-(t - 1.0f) * t * (t + 1.0f) / 6.0f,
+             (t - 1.0f) * t * (t + 2.0f) / 2.0f,
+             -(t - 1.0f) * (t + 1.0f) * (t + 2.0f) / 2.0f,
+             t * (t + 1.0f) * (t + 2.0f) / 6.0f}};
+}
+
+// Unit vector for a direction, matching SetListenerPosition: +x right, +y up, -z ahead
+std::array<float, 3> DirectionVector(float azimuth, float elevation) {
+    const double az = azimuth * M_PI / 180.0;
+    const double el = elevation * M_PI / 180.0;
+    return {{static_cast<float>(std::cos(el) * std::sin(az)),
+             static_cast<float>(std::sin(el)),
+             static_cast<float>(-std::cos(el) * std::cos(az))}};
+}
+
+using Point3 = std::array<double, 3>;
+
+Point3 Subtract(const Point3& a, const Point3& b) {
+    return {{a[0] - b[0], a[1] - b[1], a[2] - b[2]}};
+}
+
+Point3 Cross(const Point3& a, const Point3& b) {
+    return {{a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0]}};
+}
+
+double Dot(const Point3& a, const Point3& b) {
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+// atan2 in degrees from an odd minimax polynomial on [0, 1] (error below 0.001 degree).
+// Branch-free, unlike the std::atan2 library call, so the per-source angle pass vectorizes.
+inline float FastAtan2Degrees(float y, float x) {
+    const float ax = std::abs(x);
+    const float ay = std::abs(y);
+    const float a = std::min(ax, ay) / std::max(std::max(ax, ay), 1e-30f);
+    const float s = a * a;
+    float r = ((-0.0464964749f * s + 0.15931422f) * s - 0.327622764f) * s * a + a;
+    r = ay > ax ? 1.57079637f - r : r;
+    r = x < 0.0f ? 3.14159274f - r : r;
+    r = y < 0.0f ? -r : r;
+    return r * 57.2957795f;
+}
+
+// Listener direction of a head-relative position (SetListenerPosition and its automation)
+void ListenerDirection(const Vec3& position, float& azimuth, float& elevation, float& distance) {
+    distance = std::sqrt(position.x * position.x + position.y * position.y + position.z * position.z);
+    azimuth = 0.0f;
+    elevation = 0.0f;
+    if (distance > 0.01f) {
+        azimuth = static_cast<float>(std::atan2(position.x, -position.z) * 180.0 / M_PI);
+        elevation = static_cast<float>(std::asin(position.y / distance) * 180.0 / M_PI);
+    }
+}
+
+// Same curve as the single-source path in Process()
+inline float DistanceAttenuation(float distance) {
+    return distance > 0.1f ? std::min(1.0f, 1.0f / (distance * distance * 0.1f + 0.1f)) : 1.0f;
+}
+
+// Incremental 3D convex hull; for points on a sphere its faces are the spherical
+// Delaunay triangulation. Returns outward-oriented triangles of point indices.
+bool BuildConvexHull(const std::vector<Point3>& points, std::vector<std::array<int, 3>>& triangles) {
+    constexpr double EPSILON = 1e-9;
+    const int count = static_cast<int>(points.size());
+    if (count < 4) {
+        return false;
+    }
+
+    // Initial tetrahedron from well-separated points
+    int i0 = 0, i1 = -1, i2 = -1, i3 = -1;
+    double best = 0.0;
+    for (int i = 1; i < count; ++i) {
+        const Point3 d = Subtract(points[i], points[i0]);
+        const double length = Dot(d, d);
+        if (length > best) { best = length; i1 = i; }
+    }
+    best = 0.0;
+    for (int i = 1; i < count && i1 >= 0; ++i) {
+        const Point3 c = Cross(Subtract(points[i1], points[i0]), Subtract(points[i], points[i0]));
+        const double area = Dot(c, c);
+        if (area > best) { best = area; i2 = i; }
+    }
+    best = 0.0;
+    for (int i = 1; i < count && i2 >= 0; ++i) {
+        const Point3 n = Cross(Subtract(points[i1], points[i0]), Subtract(points[i2], points[i0]));
+        const double volume = std::abs(Dot(n, Subtract(points[i], points[i0])));
+        if (volume > best) { best = volume; i3 = i; }
+    }
+    if (i3 < 0 || best < EPSILON) {
+        return false;  // All points coplanar
+    }
+
+    struct Face {
+        std::array<int, 3> v;
+        Point3 normal;
+        double offset;
+        bool alive;
+    };
+    std::vector<Face> faces;
+    std::unordered_map<int64_t, int> edgeToFace;  // Directed edge (a -> b) to owning face
+    auto edgeKey = [count](int a, int b) { return static_cast<int64_t>(a) * count + b; };
+
+    const Point3 centroid = {{(points[i0][0] + points[i1][0] + points[i2][0] + points[i3][0]) / 4.0,
+                              (points[i0][1] + points[i1][1] + points[i2][1] + points[i3][1]) / 4.0,
+                              (points[i0][2] + points[i1][2] + points[i2][2] + points[i3][2]) / 4.0}};
+
+    auto addFace = [&](int a, int b, int c) {
+        Face face;
+        face.normal = Cross(Subtract(points[b], points[a]), Subtract(points[c], points[a]));
+        if (Dot(face.normal, Subtract(centroid, points[a])) > 0.0) {
+            std::swap(b, c);
+            face.normal = Cross(Subtract(points[b], points[a]), Subtract(points[c], points[a]));
+        }
+        const double length = std::sqrt(Dot(face.normal, face.normal));
+        for (auto& component : face.normal) {
+            component /= length;
+        }
+        face.v = {{a, b, c}};
+        face.offset = Dot(face.normal, points[a]);
+        face.alive = true;
+
+        const int index = static_cast<int>(faces.size());
+        faces.push_back(face);
+        edgeToFace[edgeKey(a, b)] = index;
+        edgeToFace[edgeKey(b, c)] = index;
+        edgeToFace[edgeKey(c, a)] = index;
+    };
+
+    addFace(i0, i1, i2);
+    addFace(i0, i1, i3);
+    addFace(i0, i2, i3);
+    addFace(i1, i2, i3);
+
+    std::vector<char> visible;
+    std::vector<int> visibleFaces;
+    std::vector<std::pair<int, int>> horizon;
+
+    for (int p = 0; p < count; ++p) {
+        if (p == i0 || p == i1 || p == i2 || p == i3) {
+            continue;
+        }
+
+        visible.assign(faces.size(), 0);
+        visibleFaces.clear();
+        for (size_t f = 0; f < faces.size(); ++f) {
+            if (faces[f].alive && Dot(faces[f].normal, points[p]) - faces[f].offset > EPSILON) {
+                visible[f] = 1;
+                visibleFaces.push_back(static_cast<int>(f));
+            }
+        }
+        if (visibleFaces.empty()) {
+            continue;  // Inside or on the hull
+        }
+
+        // Horizon: edges of visible faces whose neighbour across the edge is not visible
+        horizon.clear();
+        for (int f : visibleFaces) {
+            for (int e = 0; e < 3; ++e) {
+                const int a = faces[f].v[e];
+                const int b = faces[f].v[(e + 1) % 3];
+                auto neighbour = edgeToFace.find(edgeKey(b, a));
+                if (neighbour == edgeToFace.end() || !visible[neighbour->second]) {
+                    horizon.emplace_back(a, b);
+                }
+            }
+        }
+
+        for (int f : visibleFaces) {
+            faces[f].alive = false;
+            for (int e = 0; e < 3; ++e) {
+                edgeToFace.erase(edgeKey(faces[f].v[e], faces[f].v[(e + 1) % 3]));
+            }
+        }
+        for (const auto& edge : horizon) {
+            addFace(edge.first, edge.second, p);
+        }
+    }
+
+    triangles.clear();
+    for (const auto& face : faces) {
+        if (face.alive) {
+            triangles.push_back(face.v);
+        }
+    }
+    return !triangles.empty();
+}
+
+} // anonymous namespace
+
 HRTFProcessor::HRTFProcessor()
     : m_initialized(false) {
     LOG_DEBUG("HRTFProcessor constructor");
 }
 
 HRTFProcessor::~HRTFProcessor() {
+    m_filterBank.reset();
     LOG_DEBUG("HRTFProcessor destructor");
 }
 
 bool HRTFProcessor::Initialize(const std::string& hrtfDataPath) {
     LOG_INFO("Initializing HRTF processor with data path: {}", hrtfDataPath);
 
+    // The filter bank references the dataset, so tear it down (and every source using it) first
+    m_sources.Resize(0);
+    m_sourceTargets.Resize(0);
+    m_sourceChannel.reset(m_sourceTargets);
+    m_sourceRenderers.clear();
+    m_retiredRenderers.clear();
+    m_primarySource.reset();
+    m_filterBank.reset();
+
     // Initialize HRTF data structure
     m_hrtfData = std::make_unique<HRTFData>();
 
@@ -31,20 +537,59 @@ bool HRTFProcessor::Initialize(const std::string& hrtfDataPath) {
     }
 
     // Initialize convolution engine
-    m_convolution = std::make_unique<ConvolutionEngine>(HRTFData::FILTER_LENGTH);
+    const int filterLength = m_hrtfData->filterLength;
+    m_primarySource = CreateSourceRenderer();
+    const ConvolutionEngine& convolution = *m_primarySource->convolution;
     m_interpolation = std::make_unique<InterpolationEngine>();
 
+    // Frequency-domain filter bank keeps filter switches free of FFT work on the audio thread
+    if (convolution.IsFFTEnabled() && m_filterCacheSize > 0 && !m_hrtfData->filters.empty()) {
+        m_filterBank = std::make_unique<FilterBank>(*m_hrtfData, filterLength,
+                                                    convolution.GetFFTSize(), m_filterCacheSize);
+        m_filterBank->Prefetch(0.0f, 0.0f, Vec3());
+        AllocateBlendTargets(*m_primarySource);
+    }
+
+    // Source slots and scratch are sized once; AddSource only builds the convolver.
+    // All three snapshot buffers get the full capacity so publishing never reallocates
+    m_sources.Resize(m_maxSources);
+    m_sourceTargets.Resize(m_maxSources);
+    m_sourceChannel.reset(m_sourceTargets);
+    m_sourceRenderers.clear();
+    m_sourceRenderers.resize(m_maxSources);
+    m_sourceCount = 0;
+    m_sourceSequence = 0;
+    m_consumedSourceSequence = 0;
+    m_scratch.Resize(m_maxBlockSize);
+
     // Reset spatial parameters to defaults
-    m_currentAzimuth = 0.0f;
-    m_currentElevation = 0.0f;
-    m_currentDistance = 1.0f;
-    m_currentFilterIndex = 0;
+    m_spatialState = SpatialState();
+    m_spatialChannel.reset(m_spatialState);
+    m_automatedSpatialChannel.reset(m_spatialState);
 
     m_initialized = true;
-    LOG_INFO("HRTF processor initialized successfully with {} filters", m_hrtfData->filters.size());
+    LOG_INFO("HRTF processor initialized successfully with {} filters of {} taps ({} convolution{})",
+             m_hrtfData->filters.size(), filterLength,
+             convolution.IsFFTEnabled() ? "partitioned FFT" : "time-domain",
+             convolution.IsFFTEnabled() ? ", FFT size " + std::to_string(convolution.GetFFTSize()) : "");
     return true;
 }
 
+bool HRTFProcessor::Initialize(const Config& config) {
+    m_convolutionMethod = config.GetConvolutionMethod();
+    m_fftSize = config.GetFFTSize();
+    m_filterCacheSize = static_cast<size_t>(std::max(0, config.GetHRTFFilterCacheSize()));
+    m_crossfadeSamples = LoadCrossfadeSamples(config.GetHRTFDatasetConfigPath(), m_crossfadeSamples);
+    m_interpolationEnabled = config.GetHRTFInterpolation();
+    m_minimumPhase = config.GetMinimumPhase();
+    m_minimumPhaseTaps = config.GetMinimumPhaseTaps();
+    m_maxSources = static_cast<size_t>(std::max(0, config.GetHRTFMaxSources()));
+    m_maxBlockSize = std::max(DEFAULT_MAX_BLOCK, static_cast<size_t>(std::max(1, config.GetBufferSize())));
+    m_sampleRate = std::max(1, config.GetProcessingSampleRate());
+    m_cachePath = config.GetHRTFCachePath();
+    return Initialize(config.GetHRTFDataPath());
+}
+
 // NOTE: InitializeWithHeadset method removed - not declared in header
 // Advanced headset-specific optimizations will be implemented in future iterations
 
@@ -70,94 +615,132 @@ void HRTFProcessor::UpdateSpatialPosition(const VRPose& hmdPose, const std::vect
         micPose.position = {0.0f, hmdPose.position.y - 0.2f, hmdPose.position.z - 0.3f}; // Chest level, in front
         micPose.orientation = hmdPose.orientation;
         micPose.isValid = true;
-        LOG_DEBUG("No controllers detected - using default microphone position relative to HMD");
+        RT_LOG_DEBUG("No controllers detected - using default microphone position relative to HMD");
     }
 
     // Calculate angles between HMD and microphone position
     float azimuth, elevation, distance;
     CalculateAngles(hmdPose, micPose, azimuth, elevation, distance);
 
-    // Update target values for smooth interpolation
-    m_interpolation->UpdateTarget(azimuth, elevation, distance);
+    // Hand the complete direction to the audio thread in one snapshot
+    SpatialState state;
+    state.azimuth = azimuth;
+    state.elevation = elevation;
+    state.distance = distance;
+    state.filterIndex = m_hrtfData->GetFilterIndex(azimuth, elevation);
+    PublishSpatialState(state);
+
+    // Warm the filter bank for where the head is turning
+    if (m_filterBank) {
+        m_filterBank->Prefetch(azimuth, elevation, hmdPose.angularVelocity);
+    }
 
-    // Update atomic variables for stats
-    m_currentAzimuth = azimuth;
-    m_currentElevation = elevation;
-    m_currentDistance = distance;
+    RT_LOG_DEBUG("Updated spatial position - Az: {:.1f}°, El: {:.1f}°, Dist: {:.2f}m, Filter: {} (from {} controllers)",
+              azimuth, elevation, distance, state.filterIndex, controllerPoses.size());
+}
+
+const HRTFProcessor::HRTFData::Filter& HRTFProcessor::PreparePrimary(const FilterSpectrum*& spectrum, float& attenuation) {
+    // Pick up the latest complete pose; the tracker thread never blocks this
+    if (m_spatialChannel.acquire()) {
+        const SpatialState& state = m_spatialChannel.front();
+        m_interpolation->UpdateTarget(state.azimuth, state.elevation, state.distance);
+    }
 
-    // Update filter index for current position
-    m_currentFilterIndex = m_hrtfData->GetFilterIndex(azimuth, elevation);
+    // Get current spatial parameters with smoothing
+    float azimuth, elevation, distance;
+    m_interpolation->GetSmoothedValues(azimuth, elevation, distance);
 
-    LOG_DEBUG("Updated spatial position - Az: {:.1f}°, El: {:.1f}°, Dist: {:.2f}m, Filter: {} (from {} controllers)",
-              azimuth, elevation, distance, m_currentFilterIndex.load(), controllerPoses.size());
+    // Get the interpolated HRTF filter for the current position, with its spectra when available
+    spectrum = nullptr;
+    attenuation = DistanceAttenuation(distance);
+    return SelectFilter(*m_primarySource, azimuth, elevation, spectrum);
 }
 
 void HRTFProcessor::Process(const float* input, float* output, size_t frames, int inputChannels) {
-    if (!m_initialized || !input || !output || frames == 0 || !m_hrtfData || !m_convolution) {
+    if (!m_initialized || !input || !output || frames == 0 || !m_hrtfData || !m_primarySource) {
         if (output) {
             std::memset(output, 0, frames * 2 * sizeof(float));
         }
         return;
     }
+    if (inputChannels != 1 && inputChannels != 2) {
+        // Unsupported channel count, output silence
+        std::memset(output, 0, frames * 2 * sizeof(float));
+        return;
+    }
 
-    std::lock_guard<std::mutex> lock(m_processingMutex);
-
-    // Get current spatial parameters with smoothing
-    float azimuth, elevation, distance;
-    m_interpolation->GetSmoothedValues(azimuth, elevation, distance);
-
-    // Get appropriate HRTF filter for current position
-    const auto& filter = m_hrtfData->GetFilter(azimuth, elevation);
+    realtime::ScopedRealtimeSection realtimeSection;
 
-    if (inputChannels == 1) {
-        // Mono to spatial stereo processing with HRTF convolution
-        std::vector<float> leftOutput(frames);
-        std::vector<float> rightOutput(frames);
+    const FilterSpectrum* spectrum = nullptr;
+    float attenuation = 1.0f;
+    const auto& filter = PreparePrimary(spectrum, attenuation);
+    ConvolutionEngine& convolution = *m_primarySource->convolution;
 
-        // Apply HRTF convolution
-        m_convolution->Process(input, leftOutput.data(), rightOutput.data(), frames, filter);
+    // The convolver streams, so arena-sized pieces render exactly like one call
+    for (size_t offset = 0; offset < frames; offset += m_scratch.blockSize) {
+        const size_t count = std::min(m_scratch.blockSize, frames - offset);
 
-        // Apply distance attenuation
-        float attenuation = 1.0f;
-        if (distance > 0.1f) {
-            attenuation = std::min(1.0f, 1.0f / (distance * distance * 0.1f + 0.1f));
+        const float* mono = input + offset;
+        if (inputChannels == 2) {
+            // Stereo input - convolution is linear, so downmix (left + 0.5 * right) first
+            // and run a single convolution instead of two passes through the same state
+            const float* stereo = input + offset * 2;
+            for (size_t i = 0; i < count; ++i) {
+                m_scratch.mono[i] = stereo[i * 2] + stereo[i * 2 + 1] * 0.5f;
+            }
+            mono = m_scratch.mono;
         }
 
+        convolution.Process(mono, m_scratch.left, m_scratch.right, count, filter, spectrum);
+
         // Interleave stereo output with distance attenuation
-        for (size_t i = 0; i < frames; ++i) {
-            output[i * 2] = leftOutput[i] * attenuation;
-            output[i * 2 + 1] = rightOutput[i] * attenuation;
+        float* out = output + offset * 2;
+        for (size_t i = 0; i < count; ++i) {
+            out[i * 2] = m_scratch.left[i] * attenuation;
+            out[i * 2 + 1] = m_scratch.right[i] * attenuation;
         }
-    } else if (inputChannels == 2) {
-        // Stereo input - process each channel separately and sum
-        std::vector<float> leftOut1(frames), rightOut1(frames);
-        std::vector<float> leftOut2(frames), rightOut2(frames);
-        std::vector<float> leftInput(frames), rightInput(frames);
+    }
+}
 
-        // De-interleave stereo input
-        for (size_t i = 0; i < frames; ++i) {
-            leftInput[i] = input[i * 2];
-            rightInput[i] = input[i * 2 + 1];
-        }
+void HRTFProcessor::ProcessPlanar(const float* const* inputs, int inputChannels, float* left, float* right,
+                                  size_t frames) {
+    if (!left || !right || frames == 0) {
+        return;
+    }
+    if (!m_initialized || !inputs || !inputs[0] || !m_hrtfData || !m_primarySource ||
+        (inputChannels != 1 && (inputChannels != 2 || !inputs[1]))) {
+        std::memset(left, 0, frames * sizeof(float));
+        std::memset(right, 0, frames * sizeof(float));
+        return;
+    }
 
-        // Process left and right channels with HRTF
-        m_convolution->Process(leftInput.data(), leftOut1.data(), rightOut1.data(), frames, filter);
-        m_convolution->Process(rightInput.data(), leftOut2.data(), rightOut2.data(), frames, filter);
+    realtime::ScopedRealtimeSection realtimeSection;
 
-        // Apply distance attenuation
-        float attenuation = 1.0f;
-        if (distance > 0.1f) {
-            attenuation = std::min(1.0f, 1.0f / (distance * distance * 0.1f + 0.1f));
+    const FilterSpectrum* spectrum = nullptr;
+    float attenuation = 1.0f;
+    const auto& filter = PreparePrimary(spectrum, attenuation);
+    ConvolutionEngine& convolution = *m_primarySource->convolution;
+
+    // Same signal path as Process, but the convolver writes the caller's planar buffers directly
+    for (size_t offset = 0; offset < frames; offset += m_scratch.blockSize) {
+        const size_t count = std::min(m_scratch.blockSize, frames - offset);
+
+        const float* mono = inputs[0] + offset;
+        if (inputChannels == 2) {
+            const float* second = inputs[1] + offset;
+            for (size_t i = 0; i < count; ++i) {
+                m_scratch.mono[i] = mono[i] + second[i] * 0.5f;
+            }
+            mono = m_scratch.mono;
         }
 
-        // Mix and interleave output
-        for (size_t i = 0; i < frames; ++i) {
-            output[i * 2] = (leftOut1[i] + leftOut2[i] * 0.5f) * attenuation;
-            output[i * 2 + 1] = (rightOut1[i] + rightOut2[i] * 0.5f) * attenuation;
+        float* outLeft = left + offset;
+        float* outRight = right + offset;
+        convolution.Process(mono, outLeft, outRight, count, filter, spectrum);
+        for (size_t i = 0; i < count; ++i) {
+            outLeft[i] *= attenuation;
+            outRight[i] *= attenuation;
         }
-    } else {
-        // Unsupported channel count, output silence
-        std::memset(output, 0, frames * 2 * sizeof(float));
     }
 }
 
@@ -166,32 +749,21 @@ void HRTFProcessor::SetListenerPosition(const Vec3& position) {
         return;
     }
 
-    // Calculate distance from origin
-    float distance = std::sqrt(position.x * position.x +
-                              position.y * position.y +
-                              position.z * position.z);
-
-    // Calculate azimuth and elevation from position
-    float azimuth = 0.0f, elevation = 0.0f;
-    if (distance > 0.01f) {
-        azimuth = static_cast<float>(std::atan2(position.x, -position.z) * 180.0 / M_PI);
-        elevation = static_cast<float>(std::asin(position.y / distance) * 180.0 / M_PI);
-    }
-
-    // Update interpolation engine target values for smooth processing
-    m_interpolation->UpdateTarget(azimuth, elevation, distance);
+    float azimuth, elevation, distance;
+    ListenerDirection(position, azimuth, elevation, distance);
 
-    // Update atomic variables for stats
-    m_currentDistance = distance;
-    m_currentAzimuth = azimuth;
-    m_currentElevation = elevation;
+    SpatialState state;
+    state.azimuth = azimuth;
+    state.elevation = elevation;
+    state.distance = distance;
+    state.filterIndex = m_hrtfData ? m_hrtfData->GetFilterIndex(azimuth, elevation) : 0;
+    PublishSpatialState(state);
 
-    // Update filter index for current position
-    if (m_hrtfData) {
-        m_currentFilterIndex = m_hrtfData->GetFilterIndex(azimuth, elevation);
+    if (m_filterBank) {
+        m_filterBank->Prefetch(azimuth, elevation, Vec3());
     }
 
-    LOG_DEBUG("Listener position updated - Az: {:.1f}°, El: {:.1f}°, Dist: {:.2f}m",
+    RT_LOG_DEBUG("Listener position updated - Az: {:.1f}°, El: {:.1f}°, Dist: {:.2f}m",
               azimuth, elevation, distance);
 }
 
@@ -212,98 +784,1095 @@ void HRTFProcessor::SetListenerOrientation(const Vec3& orientation) {
 }
 
 void HRTFProcessor::Reset() {
-    m_currentAzimuth = 0.0f;
-    m_currentElevation = 0.0f;
-    m_currentDistance = 1.0f;
-    m_currentFilterIndex = 0;
+    PublishSpatialState(SpatialState());
 
     LOG_DEBUG("HRTF processor reset");
 }
 
-HRTFProcessor::ProcessingStats HRTFProcessor::GetStats() const {
-    ProcessingStats stats;
-    stats.azimuth = m_currentAzimuth.load();
-    stats.elevation = m_currentElevation.load();
-    stats.distance = m_currentDistance.load();
-    stats.hrtfIndex = m_currentFilterIndex.load();
-    return stats;
-}
+int HRTFProcessor::AddSource(const Vec3& position) {
+    if (!m_initialized || !m_hrtfData) {
+        return -1;
+    }
 
-void HRTFProcessor::CalculateAngles(const VRPose& headPose, const VRPose& micPose,
-                                   float& azimuth, float& elevation, float& distance) {
-    // Calculate relative position vector from head to mic
-    float dx = micPose.position.x - headPose.position.x;
-    float dy = micPose.position.y - headPose.position.y;
-    float dz = micPose.position.z - headPose.position.z;
+    // Build the convolver before taking the lock; only the slot install is serialized
+    auto renderer = CreateSourceRenderer();
 
-    // Calculate distance
-    distance = std::sqrt(dx*dx + dy*dy + dz*dz);
+    int id = -1;
+    {
+        std::lock_guard<std::mutex> lock(m_controlMutex);
+        for (size_t slot = 0; slot < m_sourceRenderers.size(); ++slot) {
+            if (!m_sourceRenderers[slot]) {
+                id = static_cast<int>(slot);
+                break;
+            }
+        }
+        if (id < 0) {
+            LOG_WARN("AddSource: all {} source slots in use (hrtf.maxSources)", m_sourceRenderers.size());
+            return -1;
+        }
 
-    // Calculate azimuth (horizontal angle)
-    azimuth = static_cast<float>(std::atan2(dx, -dz) * 180.0 / M_PI);
+        // The audio thread starts a new renderer at its position and fades it in
+        m_sourceTargets.x[id] = position.x;
+        m_sourceTargets.y[id] = position.y;
+        m_sourceTargets.z[id] = position.z;
+        m_sourceTargets.gain[id] = 1.0f;
+        m_sourceTargets.positionRevision[id]++;
+        m_sourceTargets.gainRevision[id]++;
+        m_sourceTargets.renderers[id] = renderer.get();
+        m_sourceRenderers[id] = std::move(renderer);
+        m_sourceCount++;
+        PublishSources();
+        ReclaimRenderers();
+    }
 
-    // Calculate elevation (vertical angle)
-    float horizontalDistance = std::sqrt(dx*dx + dz*dz);
-    elevation = static_cast<float>(std::atan2(dy, horizontalDistance) * 180.0 / M_PI);
+    SetSourcePosition(id, position);
+    LOG_DEBUG("Added spatial source {} ({} active)", id, GetSourceCount());
+    return id;
+}
 
-    // Normalize angles
-    while (azimuth < -180.0f) azimuth += 360.0f;
-    while (azimuth > 180.0f) azimuth -= 360.0f;
+bool HRTFProcessor::RemoveSource(int sourceId) {
+    {
+        std::lock_guard<std::mutex> lock(m_controlMutex);
+        if (!IsSourceSlot(sourceId)) {
+            return false;
+        }
+        m_sourceTargets.renderers[sourceId] = nullptr;
+        m_sourceCount--;
+        PublishSources();
 
-    elevation = std::clamp(elevation, -90.0f, 90.0f);
+        // The audio thread may still be rendering it until it picks up this table
+        m_retiredRenderers.push_back({m_sourceSequence, std::move(m_sourceRenderers[sourceId])});
+        ReclaimRenderers();
+    }
 
-    // Ensure minimum distance
-    distance = std::max(distance, 0.1f);
+    LOG_DEBUG("Removed spatial source {}", sourceId);
+    return true;
 }
 
-// Stub implementations for ConvolutionEngine to fix linking errors
-HRTFProcessor::ConvolutionEngine::ConvolutionEngine(int filterLength)
-    : m_filterLength(filterLength), m_historyIndex(0), m_fftSize(filterLength * 2) {
-    LOG_DEBUG("ConvolutionEngine constructor (stub) - filter length: {}", filterLength);
+bool HRTFProcessor::SetSourcePosition(int sourceId, const Vec3& position) {
+    {
+        std::lock_guard<std::mutex> lock(m_controlMutex);
+        if (!IsSourceSlot(sourceId)) {
+            return false;
+        }
+        m_sourceTargets.x[sourceId] = position.x;
+        m_sourceTargets.y[sourceId] = position.y;
+        m_sourceTargets.z[sourceId] = position.z;
+        m_sourceTargets.positionRevision[sourceId]++;
+        PublishSources();
+    }
+
+    // Warm the filter bank for the new direction
+    if (m_filterBank) {
+        const float horizontal = std::sqrt(position.x * position.x + position.z * position.z);
+        m_filterBank->Prefetch(FastAtan2Degrees(position.x, -position.z),
+                               FastAtan2Degrees(position.y, horizontal), Vec3());
+    }
+    return true;
 }
 
-HRTFProcessor::ConvolutionEngine::~ConvolutionEngine() {
-    LOG_DEBUG("ConvolutionEngine destructor (stub)");
+bool HRTFProcessor::SetSourceGain(int sourceId, float gain) {
+    std::lock_guard<std::mutex> lock(m_controlMutex);
+    if (!IsSourceSlot(sourceId)) {
+        return false;
+    }
+    m_sourceTargets.gain[sourceId] = std::max(0.0f, gain);
+    m_sourceTargets.gainRevision[sourceId]++;
+    PublishSources();
+    return true;
 }
 
-void HRTFProcessor::ConvolutionEngine::Process(const float* input, float* outputLeft, float* outputRight,
-                                              size_t frames, const HRTFData::Filter& filter) {
-    // Ensure we have valid output buffers
-    if (!input || !outputLeft || !outputRight || frames == 0) {
+void HRTFProcessor::AutomateListenerPosition(const Vec3& position) {
+    if (!m_initialized || !m_interpolation) {
         return;
     }
+    realtime::ScopedRealtimeSection realtimeSection;
 
-    // Resize history buffer if needed
-    if (m_historyBuffer.size() < frames + m_filterLength) {
-        m_historyBuffer.resize(frames + m_filterLength, 0.0f);
+    // A control-side pose published earlier must not land on top of this one in the next block
+    if (m_spatialChannel.acquire()) {
+        const SpatialState& state = m_spatialChannel.front();
+        m_interpolation->UpdateTarget(state.azimuth, state.elevation, state.distance);
     }
 
-    // Copy input to end of history buffer
-    std::copy(input, input + frames, m_historyBuffer.begin() + m_filterLength);
-
-    // Perform time-domain convolution for each output channel
-    for (size_t i = 0; i < frames; ++i) {
-        float leftSum = 0.0f;
-        float rightSum = 0.0f;
+    SpatialState& state = m_automatedSpatialChannel.back();
+    ListenerDirection(position, state.azimuth, state.elevation, state.distance);
+    state.filterIndex = m_hrtfData->GetFilterIndex(state.azimuth, state.elevation);
+    m_interpolation->UpdateTarget(state.azimuth, state.elevation, state.distance);
+    m_automatedSpatialChannel.publish();
+}
 
-        // Convolve with HRTF filters
-        for (int j = 0; j < m_filterLength; ++j) {
-            float inputSample = m_historyBuffer[i + m_filterLength - j - 1];
-            leftSum += inputSample * filter.left[j];
-            rightSum += inputSample * filter.right[j];
-        }
+bool HRTFProcessor::AutomateSourcePosition(int sourceId, const Vec3& position) {
+    // Picks up the latest table first, so an automated source added since the last block exists here
+    if (m_sourceChannel.acquire()) {
+        ApplySourceTargets(m_sourceChannel.front());
+    }
+    if (sourceId < 0 || static_cast<size_t>(sourceId) >= m_sources.Capacity() || !m_sources.active[sourceId]) {
+        return false;
+    }
+    m_sources.targetX[sourceId] = position.x;
+    m_sources.targetY[sourceId] = position.y;
+    m_sources.targetZ[sourceId] = position.z;
+    return true;
+}
 
-        outputLeft[i] = leftSum;
-        outputRight[i] = rightSum;
+bool HRTFProcessor::AutomateSourceGain(int sourceId, float gain) {
+    if (m_sourceChannel.acquire()) {
+        ApplySourceTargets(m_sourceChannel.front());
+    }
+    if (sourceId < 0 || static_cast<size_t>(sourceId) >= m_sources.Capacity() || !m_sources.active[sourceId]) {
+        return false;
     }
+    m_sources.gain[sourceId] = std::max(0.0f, gain);
+    return true;
+}
 
-    // Shift history buffer: move end portion to beginning
-    std::copy(m_historyBuffer.begin() + frames,
-             m_historyBuffer.begin() + frames + m_filterLength,
-             m_historyBuffer.begin());
+size_t HRTFProcessor::GetSourceCount() const {
+    std::lock_guard<std::mutex> lock(m_controlMutex);
+    return m_sourceCount;
+}
 
-    // Clear the input portion for next iteration
-    std::fill(m_historyBuffer.begin() + m_filterLength, m_historyBuffer.end(), 0.0f);
+size_t HRTFProcessor::GetSourceCapacity() const {
+    std::lock_guard<std::mutex> lock(m_controlMutex);
+    return m_sourceRenderers.size();
+}
+
+void HRTFProcessor::SetMaxBlockSize(size_t frames) {
+    m_maxBlockSize = std::max<size_t>(frames, 1);
+    if (m_initialized) {
+        m_scratch.Resize(m_maxBlockSize);
+    }
+}
+
+size_t HRTFProcessor::GetMaxBlockSize() const {
+    return m_maxBlockSize;
+}
+
+void HRTFProcessor::ProcessSources(const float* const* inputs, float* output, size_t frames) {
+    if (!output || frames == 0) {
+        return;
+    }
+    if (!m_initialized || !inputs || !m_hrtfData) {
+        std::memset(output, 0, frames * 2 * sizeof(float));
+        return;
+    }
+
+    realtime::ScopedRealtimeSection realtimeSection;
+
+    if (m_sourceChannel.acquire()) {
+        ApplySourceTargets(m_sourceChannel.front());
+    }
+
+    for (size_t offset = 0; offset < frames; offset += m_scratch.blockSize) {
+        const size_t count = std::min(m_scratch.blockSize, frames - offset);
+
+        // Position smoothing scaled to the chunk length, so the glide time is buffer-size independent
+        UpdateSourceAngles(1.0f - std::exp(-static_cast<float>(count) / SOURCE_SMOOTHING_SAMPLES));
+        RenderSources(inputs, offset, count);
+
+        float* out = output + offset * 2;
+        for (size_t i = 0; i < count; ++i) {
+            out[i * 2] = m_scratch.busLeft[i];
+            out[i * 2 + 1] = m_scratch.busRight[i];
+        }
+    }
+}
+
+HRTFProcessor::ProcessingStats HRTFProcessor::GetStats() const {
+    ProcessingStats stats;
+    {
+        std::lock_guard<std::mutex> lock(m_controlMutex);
+        if (m_automatedSpatialChannel.acquire()) {
+            m_spatialState = m_automatedSpatialChannel.front();
+        }
+        stats.azimuth = m_spatialState.azimuth;
+        stats.elevation = m_spatialState.elevation;
+        stats.distance = m_spatialState.distance;
+        stats.hrtfIndex = m_spatialState.filterIndex;
+    }
+
+    stats.filterCacheHits = 0;
+    stats.filterCacheMisses = 0;
+    stats.filterCacheResident = 0;
+    if (m_filterBank) {
+        const auto bankStats = m_filterBank->GetStats();
+        stats.filterCacheHits = bankStats.hits;
+        stats.filterCacheMisses = bankStats.misses;
+        stats.filterCacheResident = bankStats.resident;
+    }
+
+    const ConvolutionEngine* convolution = m_primarySource ? m_primarySource->convolution.get() : nullptr;
+    stats.filterSwitches = convolution ? convolution->GetFilterSwitches() : 0;
+    stats.transitionBlocks = convolution ? convolution->GetTransitionBlocks() : 0;
+    stats.processedBlocks = convolution ? convolution->GetProcessedBlocks() : 0;
+    stats.filterLength = m_hrtfData ? m_hrtfData->filterLength : 0;
+    return stats;
+}
+
+const HRTFProcessor::HRTFData::Filter& HRTFProcessor::SelectFilter(SourceRenderer& source, float azimuth,
+                                                                  float elevation, const FilterSpectrum*& spectrum) {
+    spectrum = nullptr;
+
+    HRTFData::Interpolation interpolation;
+    if (m_interpolationEnabled) {
+        interpolation = m_hrtfData->Interpolate(azimuth, elevation);
+    } else {
+        interpolation.indices = {{m_hrtfData->GetFilterIndex(azimuth, elevation), -1, -1}};
+        interpolation.weights = {{1.0f, 0.0f, 0.0f}};
+    }
+    if (interpolation.indices[0] < 0) {
+        return m_hrtfData->GetFilter(azimuth, elevation);
+    }
+
+    // Re-blend only when the weights move, and never while the previous switch is still
+    // crossfading: the idle buffer is the outgoing filter until then
+    bool reblend = source.activeInterpolated < 0;
+    if (!reblend && !source.convolution->IsCrossfading()) {
+        for (int v = 0; v < 3 && !reblend; ++v) {
+            reblend = interpolation.indices[v] != source.activeInterpolation.indices[v] ||
+                      std::abs(interpolation.weights[v] - source.activeInterpolation.weights[v]) > INTERPOLATION_EPSILON;
+        }
+    }
+
+    if (reblend) {
+        const int target = (source.activeInterpolated + 1) % 2;
+        BlendFilter(source, interpolation, target);
+        source.activeInterpolated = target;
+        source.activeInterpolation = interpolation;
+    }
+
+    const auto& active = source.interpolatedFilters[source.activeInterpolated];
+    spectrum = active.hasSpectrum ? &active.spectrum : nullptr;
+    return active.filter;
+}
+
+void HRTFProcessor::BlendFilter(SourceRenderer& source, const HRTFData::Interpolation& interpolation, int target) {
+    auto& blended = source.interpolatedFilters[target];
+
+    // Unused vertices carry zero weight; point them at the first so every load is valid
+    std::array<int, 3> indices = interpolation.indices;
+    for (auto& index : indices) {
+        if (index < 0) {
+            index = indices[0];
+        }
+    }
+    const auto& w = interpolation.weights;
+
+    // Time-domain blend: convolved directly by the time-domain path, transformed on a bank miss
+    const auto& f0 = m_hrtfData->filters[indices[0]];
+    const auto& f1 = m_hrtfData->filters[indices[1]];
+    const auto& f2 = m_hrtfData->filters[indices[2]];
+    const size_t taps = static_cast<size_t>(m_hrtfData->filterLength);
+    simd::weightedSum3(blended.filter.left.data(), f0.left.data(), f1.left.data(), f2.left.data(),
+                       w[0], w[1], w[2], taps);
+    simd::weightedSum3(blended.filter.right.data(), f0.right.data(), f1.right.data(), f2.right.data(),
+                       w[0], w[1], w[2], taps);
+
+    // Minimum-phase vertices are aligned, so blending their delays interpolates the ITD itself
+    blended.filter.leftDelay = f0.leftDelay * w[0] + f1.leftDelay * w[1] + f2.leftDelay * w[2];
+    blended.filter.rightDelay = f0.rightDelay * w[0] + f1.rightDelay * w[1] + f2.rightDelay * w[2];
+
+    // Frequency-domain blend of the vertex spectra; the transform is linear, so this is exact
+    blended.hasSpectrum = false;
+    if (!m_filterBank) {
+        return;
+    }
+
+    std::array<int, 3> slots{{-1, -1, -1}};
+    bool resident = true;
+    for (int v = 0; v < 3; ++v) {
+        slots[v] = m_filterBank->Acquire(indices[v]);
+        resident = resident && slots[v] >= 0;
+    }
+
+    const size_t spectrumSize = blended.spectrum.left.size();
+    if (resident && m_filterBank->GetSpectrum(slots[0]).left.size() == spectrumSize) {
+        const auto& s0 = m_filterBank->GetSpectrum(slots[0]);
+        const auto& s1 = m_filterBank->GetSpectrum(slots[1]);
+        const auto& s2 = m_filterBank->GetSpectrum(slots[2]);
+        simd::weightedSum3(reinterpret_cast<float*>(blended.spectrum.left.data()),
+                           reinterpret_cast<const float*>(s0.left.data()),
+                           reinterpret_cast<const float*>(s1.left.data()),
+                           reinterpret_cast<const float*>(s2.left.data()),
+                           w[0], w[1], w[2], spectrumSize * 2);
+        simd::weightedSum3(reinterpret_cast<float*>(blended.spectrum.right.data()),
+                           reinterpret_cast<const float*>(s0.right.data()),
+                           reinterpret_cast<const float*>(s1.right.data()),
+                           reinterpret_cast<const float*>(s2.right.data()),
+                           w[0], w[1], w[2], spectrumSize * 2);
+        blended.hasSpectrum = true;
+    }
+
+    for (int slot : slots) {
+        if (slot >= 0) {
+            m_filterBank->Release(slot);
+        }
+    }
+}
+
+std::unique_ptr<HRTFProcessor::SourceRenderer> HRTFProcessor::CreateSourceRenderer() const {
+    auto source = std::make_unique<SourceRenderer>();
+    const bool useFFT = UseFFTConvolution(m_convolutionMethod, m_hrtfData->filterLength);
+    source->convolution = std::make_unique<ConvolutionEngine>(m_hrtfData->filterLength, m_fftSize, useFFT,
+                                                              m_crossfadeSamples, m_hrtfData->maxDelay);
+    AllocateBlendTargets(*source);
+    return source;
+}
+
+void HRTFProcessor::AllocateBlendTargets(SourceRenderer& source) const {
+    if (!m_filterBank) {
+        return;
+    }
+
+    // Blend targets match the convolver's partition layout
+    const size_t spectrumSize = static_cast<size_t>(source.convolution->GetPartitionCount()) *
+                                (source.convolution->GetFFTSize() / 2 + 1);
+    for (auto& interpolated : source.interpolatedFilters) {
+        interpolated.spectrum.left.assign(spectrumSize, {0.0f, 0.0f});
+        interpolated.spectrum.right.assign(spectrumSize, {0.0f, 0.0f});
+        interpolated.hasSpectrum = false;
+    }
+}
+
+void HRTFProcessor::PublishSpatialState(const SpatialState& state) {
+    std::lock_guard<std::mutex> lock(m_controlMutex);
+    // Automation published before this pose is older than it; drop it so GetStats cannot revive it
+    m_automatedSpatialChannel.acquire();
+    m_spatialState = state;
+    m_spatialChannel.back() = state;
+    m_spatialChannel.publish();
+}
+
+void HRTFProcessor::PublishSources() {
+    // Caller holds m_controlMutex. The back buffer already has the capacity, so this copy
+    // reuses its storage; the whole table goes out because the buffer holds an older one
+    SourceTargets& back = m_sourceChannel.back();
+    back.x = m_sourceTargets.x;
+    back.y = m_sourceTargets.y;
+    back.z = m_sourceTargets.z;
+    back.gain = m_sourceTargets.gain;
+    back.positionRevision = m_sourceTargets.positionRevision;
+    back.gainRevision = m_sourceTargets.gainRevision;
+    back.renderers = m_sourceTargets.renderers;
+    back.sequence = ++m_sourceSequence;
+    m_sourceChannel.publish();
+}
+
+void HRTFProcessor::ReclaimRenderers() {
+    // Caller holds m_controlMutex
+    const uint64_t consumed = m_consumedSourceSequence.load(std::memory_order_acquire);
+    m_retiredRenderers.erase(std::remove_if(m_retiredRenderers.begin(), m_retiredRenderers.end(),
+                                            [consumed](const RetiredRenderer& retired) {
+                                                return retired.sequence <= consumed;
+                                            }),
+                             m_retiredRenderers.end());
+}
+
+bool HRTFProcessor::IsSourceSlot(int sourceId) const {
+    // Caller holds m_controlMutex
+    return sourceId >= 0 && static_cast<size_t>(sourceId) < m_sourceRenderers.size() && m_sourceRenderers[sourceId];
+}
+
+void HRTFProcessor::ApplySourceTargets(const SourceTargets& targets) {
+    const size_t capacity = m_sources.Capacity();
+    for (size_t id = 0; id < capacity; ++id) {
+        // Only values the control side changed since the last table; the rest may be automated
+        if (targets.positionRevision[id] != m_sources.positionRevision[id]) {
+            m_sources.targetX[id] = targets.x[id];
+            m_sources.targetY[id] = targets.y[id];
+            m_sources.targetZ[id] = targets.z[id];
+            m_sources.positionRevision[id] = targets.positionRevision[id];
+        }
+        if (targets.gainRevision[id] != m_sources.gainRevision[id]) {
+            m_sources.gain[id] = targets.gain[id];
+            m_sources.gainRevision[id] = targets.gainRevision[id];
+        }
+
+        SourceRenderer* renderer = targets.renderers[id];
+        if (renderer && renderer != m_sources.renderers[id]) {
+            // New source in this slot: start at its position and fade in from silence
+            m_sources.x[id] = targets.x[id];
+            m_sources.y[id] = targets.y[id];
+            m_sources.z[id] = targets.z[id];
+            m_sources.endGain[id] = 0.0f;
+        }
+        m_sources.renderers[id] = renderer;
+        m_sources.active[id] = renderer ? 1 : 0;
+    }
+
+    // Renderers missing from this table are no longer referenced here
+    m_consumedSourceSequence.store(targets.sequence, std::memory_order_release);
+}
+
+void HRTFProcessor::UpdateSourceAngles(float smoothing) {
+    // Straight loops over every slot: inactive slots are computed and masked out by their gain
+    const size_t capacity = m_sources.Capacity();
+    float* x = m_sources.x.data();
+    float* y = m_sources.y.data();
+    float* z = m_sources.z.data();
+    const float* targetX = m_sources.targetX.data();
+    const float* targetY = m_sources.targetY.data();
+    const float* targetZ = m_sources.targetZ.data();
+
+    for (size_t i = 0; i < capacity; ++i) {
+        x[i] += (targetX[i] - x[i]) * smoothing;
+        y[i] += (targetY[i] - y[i]) * smoothing;
+        z[i] += (targetZ[i] - z[i]) * smoothing;
+    }
+
+    float* azimuth = m_sources.azimuth.data();
+    float* elevation = m_sources.elevation.data();
+    float* distance = m_sources.distance.data();
+    float* startGain = m_sources.startGain.data();
+    float* endGain = m_sources.endGain.data();
+    const float* gain = m_sources.gain.data();
+    const uint8_t* active = m_sources.active.data();
+
+    for (size_t i = 0; i < capacity; ++i) {
+        const float horizontal = std::sqrt(x[i] * x[i] + z[i] * z[i]);
+        distance[i] = std::sqrt(horizontal * horizontal + y[i] * y[i]);
+        azimuth[i] = FastAtan2Degrees(x[i], -z[i]);
+        elevation[i] = FastAtan2Degrees(y[i], horizontal);
+
+        // Gain ramps from where the previous block ended
+        startGain[i] = endGain[i];
+        endGain[i] = active[i] ? gain[i] * DistanceAttenuation(distance[i]) : 0.0f;
+    }
+}
+
+void HRTFProcessor::RenderSources(const float* const* inputs, size_t offset, size_t frames) {
+    std::fill(m_scratch.busLeft, m_scratch.busLeft + frames, 0.0f);
+    std::fill(m_scratch.busRight, m_scratch.busRight + frames, 0.0f);
+
+    for (size_t id = 0; id < m_sources.Capacity(); ++id) {
+        if (!m_sources.active[id] || !inputs[id]) {
+            continue;
+        }
+
+        SourceRenderer& source = *m_sources.renderers[id];
+        const FilterSpectrum* spectrum = nullptr;
+        const auto& filter = SelectFilter(source, m_sources.azimuth[id], m_sources.elevation[id], spectrum);
+        source.convolution->Process(inputs[id] + offset, m_scratch.left, m_scratch.right, frames, filter, spectrum);
+
+        simd::applyGainWithFade(m_scratch.left, frames, m_sources.startGain[id], m_sources.endGain[id]);
+        simd::applyGainWithFade(m_scratch.right, frames, m_sources.startGain[id], m_sources.endGain[id]);
+        simd::mixBuffers(m_scratch.busLeft, m_scratch.left, frames);
+        simd::mixBuffers(m_scratch.busRight, m_scratch.right, frames);
+    }
+}
+
+void HRTFProcessor::SourceTable::Resize(size_t capacity) {
+    for (auto* field : {&targetX, &targetY, &targetZ, &x, &y, &z, &azimuth, &elevation, &distance,
+                        &startGain, &endGain}) {
+        field->assign(capacity, 0.0f);
+    }
+    gain.assign(capacity, 1.0f);
+    active.assign(capacity, 0);
+    positionRevision.assign(capacity, 0);
+    gainRevision.assign(capacity, 0);
+    renderers.assign(capacity, nullptr);
+}
+
+void HRTFProcessor::SourceTargets::Resize(size_t capacity) {
+    for (auto* field : {&x, &y, &z}) {
+        field->assign(capacity, 0.0f);
+    }
+    gain.assign(capacity, 1.0f);
+    positionRevision.assign(capacity, 0);
+    gainRevision.assign(capacity, 0);
+    renderers.assign(capacity, nullptr);
+    sequence = 0;
+}
+
+void HRTFProcessor::ScratchArena::Resize(size_t frames) {
+    // Spans start on 64-byte boundaries relative to the buffer
+    constexpr size_t SPANS = 5;
+    blockSize = std::max<size_t>(frames, 1);
+    const size_t stride = (blockSize + 15) & ~size_t(15);
+    storage.assign(SPANS * stride, 0.0f);
+
+    float* base = storage.data();
+    mono = base;
+    left = base + stride;
+    right = base + 2 * stride;
+    busLeft = base + 3 * stride;
+    busRight = base + 4 * stride;
+}
+
+void HRTFProcessor::CalculateAngles(const VRPose& headPose, const VRPose& micPose,
+                                   float& azimuth, float& elevation, float& distance) {
+    // Calculate relative position vector from head to mic
+    float dx = micPose.position.x - headPose.position.x;
+    float dy = micPose.position.y - headPose.position.y;
+    float dz = micPose.position.z - headPose.position.z;
+
+    // Calculate distance
+    distance = std::sqrt(dx*dx + dy*dy + dz*dz);
+
+    // Calculate azimuth (horizontal angle)
+    azimuth = static_cast<float>(std::atan2(dx, -dz) * 180.0 / M_PI);
+
+    // Calculate elevation (vertical angle)
+    float horizontalDistance = std::sqrt(dx*dx + dz*dz);
+    elevation = static_cast<float>(std::atan2(dy, horizontalDistance) * 180.0 / M_PI);
+
+    // Normalize angles
+    while (azimuth < -180.0f) azimuth += 360.0f;
+    while (azimuth > 180.0f) azimuth -= 360.0f;
+
+    elevation = std::clamp(elevation, -90.0f, 90.0f);
+
+    // Ensure minimum distance
+    distance = std::max(distance, 0.1f);
+}
+
+HRTFProcessor::ConvolutionEngine::ConvolutionEngine(int filterLength, int fftSize, bool useFFT, int crossfadeSamples,
+                                                    float maxDelay)
+    : m_filterLength(filterLength), m_historyIndex(0), m_fftSize(fftSize), m_useFFT(useFFT)
+    , m_crossfadeLength(std::clamp(crossfadeSamples, 0, MAX_CROSSFADE_SAMPLES)) {
+    if (maxDelay > 0.0f) {
+        // The interpolator reads two samples behind and one ahead of the integer delay
+        m_delayHistory = static_cast<int>(std::ceil(maxDelay)) + 3;
+        for (auto& line : m_delayLines) {
+            line.assign(static_cast<size_t>(m_delayHistory) + DELAY_CHUNK, 0.0f);
+        }
+    }
+
+    if (m_useFFT) {
+        InitializeFFT();
+        LOG_DEBUG("ConvolutionEngine: partitioned overlap-save, filter length {}, FFT size {}, {} partition(s)",
+                  m_filterLength, m_fftSize, m_numPartitions);
+    } else {
+        m_historyBuffer.assign(m_filterLength * 2, 0.0f);
+        LOG_DEBUG("ConvolutionEngine: time-domain, filter length {}", m_filterLength);
+    }
+}
+
+HRTFProcessor::ConvolutionEngine::~ConvolutionEngine() {
+    CleanupFFT();
+}
+
+void HRTFProcessor::ConvolutionEngine::InitializeFFT() {
+    // FFT size must be a power of two; the partition length is half of it
+    int size = 64;
+    while (size < m_fftSize && size < 16384) {
+        size <<= 1;
+    }
+    if (size != m_fftSize) {
+        LOG_WARN("ConvolutionEngine: FFT size {} is not a supported power of two, using {}", m_fftSize, size);
+    }
+    m_fftSize = size;
+    m_blockSize = m_fftSize / 2;
+    m_numBins = m_fftSize / 2 + 1;
+    m_numPartitions = (m_filterLength + m_blockSize - 1) / m_blockSize;
+
+    // Twiddle factors for the full size; the half-size complex FFT uses every other entry
+    m_twiddleFactors.resize(m_fftSize / 2);
+    for (int k = 0; k < m_fftSize / 2; ++k) {
+        double angle = -2.0 * M_PI * k / m_fftSize;
+        m_twiddleFactors[k] = std::complex<float>(static_cast<float>(std::cos(angle)),
+                                                  static_cast<float>(std::sin(angle)));
+    }
+
+    // Bit reversal permutation for the half-size complex FFT
+    const int complexSize = m_fftSize / 2;
+    int bits = 0;
+    while ((1 << bits) < complexSize) {
+        ++bits;
+    }
+    m_bitReverse.resize(complexSize);
+    for (int i = 0; i < complexSize; ++i) {
+        int reversed = 0;
+        for (int b = 0; b < bits; ++b) {
+            if (i & (1 << b)) {
+                reversed |= 1 << (bits - 1 - b);
+            }
+        }
+        m_bitReverse[i] = reversed;
+    }
+
+    // Two halves, so a freshly transformed filter never overwrites the one being faded out
+    m_filterFFTLeft.assign(2 * static_cast<size_t>(m_numPartitions) * m_numBins, {0.0f, 0.0f});
+    m_filterFFTRight.assign(2 * static_cast<size_t>(m_numPartitions) * m_numBins, {0.0f, 0.0f});
+    m_signalFFT.assign(m_numBins, {0.0f, 0.0f});
+    m_outputFFT.assign(m_numBins, {0.0f, 0.0f});
+    m_tailFFTLeft.assign(m_numBins, {0.0f, 0.0f});
+    m_tailFFTRight.assign(m_numBins, {0.0f, 0.0f});
+    m_previousTailFFTLeft.assign(m_numBins, {0.0f, 0.0f});
+    m_previousTailFFTRight.assign(m_numBins, {0.0f, 0.0f});
+    m_spectrumHistory.assign(static_cast<size_t>(std::max(m_numPartitions - 1, 0)) * m_numBins, {0.0f, 0.0f});
+    m_spectrumHistoryIndex = 0;
+    m_fftWorkspace.assign(m_fftSize, {0.0f, 0.0f});
+    m_overlapBuffer.assign(m_fftSize, 0.0f);
+    m_timeScratch.assign(m_fftSize, 0.0f);
+    m_historyIndex = 0;
+}
+
+void HRTFProcessor::ConvolutionEngine::CleanupFFT() {
+    m_filterFFTLeft.clear();
+    m_filterFFTRight.clear();
+    m_signalFFT.clear();
+    m_outputFFT.clear();
+    m_twiddleFactors.clear();
+    m_overlapBuffer.clear();
+    m_spectrumHistory.clear();
+    m_activeFilterLeft = nullptr;
+    m_activeFilterRight = nullptr;
+    m_tailFFTLeft.clear();
+    m_tailFFTRight.clear();
+    m_previousTailFFTLeft.clear();
+    m_previousTailFFTRight.clear();
+    m_fftWorkspace.clear();
+    m_timeScratch.clear();
+    m_bitReverse.clear();
+    m_cachedFilter = nullptr;
+    m_filterCached = false;
+    m_crossfading = false;
+}
+
+void HRTFProcessor::ConvolutionEngine::Process(const float* input, float* outputLeft, float* outputRight,
+                                              size_t frames, const HRTFData::Filter& filter,
+                                              const FilterSpectrum* spectrum) {
+    // Ensure we have valid output buffers
+    if (!input || !outputLeft || !outputRight || frames == 0) {
+        return;
+    }
+
+    const bool firstFilter = !m_filterCached;
+    const bool switching = firstFilter || m_cachedFilter != &filter;
+
+    if (m_useFFT) {
+        ProcessFFT(input, outputLeft, outputRight, frames, filter, spectrum);
+    } else {
+        ProcessTimeDomain(input, outputLeft, outputRight, frames, filter);
+    }
+
+    if (m_delayHistory > 0) {
+        if (switching) {
+            RetargetDelay(filter, firstFilter);
+        }
+        ApplyDelay(outputLeft, outputRight, frames);
+    }
+
+    m_processedBlocks.fetch_add(1, std::memory_order_relaxed);
+}
+
+void HRTFProcessor::ConvolutionEngine::RetargetDelay(const HRTFData::Filter& filter, bool immediate) {
+    const float maxDelay = static_cast<float>(m_delayHistory - 3);
+    const std::array<float, 2> target{{std::clamp(filter.leftDelay, MIN_EAR_DELAY_SAMPLES, maxDelay),
+                                       std::clamp(filter.rightDelay, MIN_EAR_DELAY_SAMPLES, maxDelay)}};
+
+    // Glide from wherever the delay currently is, over the same window as the filter crossfade
+    for (int ear = 0; ear < 2; ++ear) {
+        float current = m_delayTarget[ear];
+        if (m_delayRampPosition < m_delayRampLength) {
+            const float progress = static_cast<float>(m_delayRampPosition) / static_cast<float>(m_delayRampLength);
+            current = m_delayStart[ear] + (m_delayTarget[ear] - m_delayStart[ear]) * progress;
+        }
+        m_delayStart[ear] = immediate ? target[ear] : current;
+        m_delayTarget[ear] = target[ear];
+    }
+    m_delayRampLength = immediate ? 0 : m_crossfadeLength;
+    m_delayRampPosition = 0;
+}
+
+void HRTFProcessor::ConvolutionEngine::ApplyDelay(float* outputLeft, float* outputRight, size_t frames) {
+    const size_t history = static_cast<size_t>(m_delayHistory);
+
+    for (size_t processed = 0; processed < frames; processed += DELAY_CHUNK) {
+        const size_t count = std::min(frames - processed, static_cast<size_t>(DELAY_CHUNK));
+        const int rampRemaining = std::max(0, m_delayRampLength - m_delayRampPosition);
+
+        for (int ear = 0; ear < 2; ++ear) {
+            float* output = ((ear == 0) ? outputLeft : outputRight) + processed;
+            float* line = m_delayLines[ear].data();
+            std::copy(output, output + count, line + history);
+
+            // Gliding delay: per-sample coefficients for the rest of the ramp
+            size_t i = 0;
+            const size_t rampCount = std::min(count, static_cast<size_t>(rampRemaining));
+            for (; i < rampCount; ++i) {
+                const float progress = static_cast<float>(m_delayRampPosition + static_cast<int>(i) + 1) /
+                                       static_cast<float>(m_delayRampLength);
+                const float delay = m_delayStart[ear] + (m_delayTarget[ear] - m_delayStart[ear]) * progress;
+                const int whole = static_cast<int>(delay);
+                const auto c = LagrangeCoefficients(delay - static_cast<float>(whole));
+                const float* source = line + history + i - whole - 2;
+                output[i] = c[0] * source[0] + c[1] * source[1] + c[2] * source[2] + c[3] * source[3];
+            }
+
+            // Settled delay: one set of coefficients for the whole run
+            if (i < count) {
+                const float delay = m_delayTarget[ear];
+                const int whole = static_cast<int>(delay);
+                const auto c = LagrangeCoefficients(delay - static_cast<float>(whole));
+                simd::applyFIR4(output + i, line + history + i - whole - 2, c.data(), count - i);
+            }
+
+            std::memmove(line, line + count, history * sizeof(float));
+        }
+
+        m_delayRampPosition = std::min(m_delayRampLength, m_delayRampPosition + static_cast<int>(count));
+    }
+}
+
+void HRTFProcessor::ConvolutionEngine::BeginCrossfade() {
+    // Keep the outgoing filter running alongside the new one for m_crossfadeLength samples
+    m_previousFilter = m_cachedFilter;
+    m_previousFilterLeft = m_activeFilterLeft;
+    m_previousFilterRight = m_activeFilterRight;
+    m_previousTailFFTLeft.swap(m_tailFFTLeft);
+    m_previousTailFFTRight.swap(m_tailFFTRight);
+    m_crossfadePosition = 0;
+    m_crossfading = true;
+}
+
+size_t HRTFProcessor::ConvolutionEngine::ApplyCrossfade(float* output, const float* outgoing, size_t count) const {
+    // Linear ramp from the outgoing to the incoming response; neighbouring HRIRs are
+    // strongly correlated, so this keeps the level steady across the switch
+    const size_t fadeCount = std::min(count, static_cast<size_t>(m_crossfadeLength - m_crossfadePosition));
+    const float step = 1.0f / static_cast<float>(m_crossfadeLength);
+    for (size_t i = 0; i < fadeCount; ++i) {
+        const float gain = static_cast<float>(m_crossfadePosition + static_cast<int>(i) + 1) * step;
+        output[i] = outgoing[i] + (output[i] - outgoing[i]) * gain;
+    }
+    return fadeCount;
+}
+
+void HRTFProcessor::ConvolutionEngine::AdvanceCrossfade(size_t count) {
+    m_crossfadePosition += static_cast<int>(count);
+    if (m_crossfadePosition >= m_crossfadeLength) {
+        m_crossfading = false;
+        m_previousFilter = nullptr;
+        m_previousFilterLeft = nullptr;
+        m_previousFilterRight = nullptr;
+    }
+}
+
+void HRTFProcessor::ConvolutionEngine::ProcessFFT(const float* input, float* outputLeft, float* outputRight,
+                                                 size_t frames, const HRTFData::Filter& filter,
+                                                 const FilterSpectrum* spectrum) {
+    // Switch spectra only when the filter changes, preferring precomputed ones;
+    // the tail contribution of the already-seen input is re-accumulated so the
+    // switch takes effect immediately
+    if (!m_filterCached || m_cachedFilter != &filter) {
+        if (m_filterCached && m_crossfadeLength > 0) {
+            BeginCrossfade();
+        }
+
+        const size_t spectrumSize = static_cast<size_t>(m_numPartitions) * m_numBins;
+        if (spectrum && spectrum->left.size() == spectrumSize && spectrum->right.size() == spectrumSize) {
+            m_activeFilterLeft = spectrum->left.data();
+            m_activeFilterRight = spectrum->right.data();
+        } else {
+            m_ownSpectrumHalf ^= 1;
+            const size_t offset = m_ownSpectrumHalf * spectrumSize;
+            ComputeFilterFFT(filter, m_filterFFTLeft.data() + offset, m_filterFFTRight.data() + offset);
+            m_activeFilterLeft = m_filterFFTLeft.data() + offset;
+            m_activeFilterRight = m_filterFFTRight.data() + offset;
+        }
+        m_cachedFilter = &filter;
+        m_filterCached = true;
+        m_filterSwitches.fetch_add(1, std::memory_order_relaxed);
+        UpdateTailSpectrum();
+    }
+
+    if (m_crossfading) {
+        m_transitionBlocks.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // m_historyIndex tracks how much of the current block has been filled
+    size_t processed = 0;
+    while (processed < frames) {
+        const size_t count = std::min(frames - processed,
+                                      static_cast<size_t>(m_blockSize - m_historyIndex));
+        float* currentBlock = m_overlapBuffer.data() + m_blockSize;
+
+        std::copy(input + processed, input + processed + count, currentBlock + m_historyIndex);
+
+        // One forward transform of [previous block | current block], shared by both ears
+        PerformRealFFT(m_overlapBuffer.data(), m_signalFFT.data(), m_fftSize);
+
+        const int outputOffset = m_blockSize + m_historyIndex;
+        for (int ear = 0; ear < 2; ++ear) {
+            float* output = (ear == 0) ? outputLeft : outputRight;
+
+            RenderEar((ear == 0) ? m_activeFilterLeft : m_activeFilterRight,
+                      (ear == 0) ? m_tailFFTLeft : m_tailFFTRight);
+            std::copy(m_timeScratch.begin() + outputOffset,
+                     m_timeScratch.begin() + outputOffset + count,
+                     output + processed);
+
+            // During a transition the outgoing filter is rendered from the same input spectrum
+            if (m_crossfading) {
+                RenderEar((ear == 0) ? m_previousFilterLeft : m_previousFilterRight,
+                          (ear == 0) ? m_previousTailFFTLeft : m_previousTailFFTRight);
+                ApplyCrossfade(output + processed, m_timeScratch.data() + outputOffset, count);
+            }
+        }
+
+        if (m_crossfading) {
+            AdvanceCrossfade(count);
+        }
+
+        m_historyIndex += static_cast<int>(count);
+        processed += count;
+
+        if (m_historyIndex == m_blockSize) {
+            // Block complete: its window spectrum enters the delay line for the tail partitions
+            if (m_numPartitions > 1) {
+                m_spectrumHistoryIndex = (m_spectrumHistoryIndex + 1) % (m_numPartitions - 1);
+                std::copy(m_signalFFT.begin(), m_signalFFT.end(),
+                         m_spectrumHistory.begin() + static_cast<size_t>(m_spectrumHistoryIndex) * m_numBins);
+                UpdateTailSpectrum();
+            }
+
+            // Slide the window: current block becomes the previous block
+            std::copy(currentBlock, currentBlock + m_blockSize, m_overlapBuffer.begin());
+            std::fill(currentBlock, currentBlock + m_blockSize, 0.0f);
+            m_historyIndex = 0;
+        }
+    }
+}
+
+void HRTFProcessor::ConvolutionEngine::RenderEar(const std::complex<float>* filterFFT,
+                                                const std::vector<std::complex<float>>& tailFFT) {
+    // Head partition times the current window, plus the precomputed tail, into m_timeScratch
+    if (m_numPartitions > 1) {
+        std::copy(tailFFT.begin(), tailFFT.end(), m_outputFFT.begin());
+        ComplexMultiplyAccumulate(m_signalFFT.data(), filterFFT, m_outputFFT.data(), m_numBins);
+    } else {
+        ComplexMultiply(m_signalFFT.data(), filterFFT, m_outputFFT.data(), m_numBins);
+    }
+    PerformRealIFFT(m_outputFFT.data(), m_timeScratch.data(), m_fftSize);
+}
+
+void HRTFProcessor::ConvolutionEngine::ProcessTimeDomain(const float* input, float* outputLeft, float* outputRight,
+                                                        size_t frames, const HRTFData::Filter& filter) {
+    if (!m_filterCached || m_cachedFilter != &filter) {
+        if (m_filterCached && m_crossfadeLength > 0) {
+            BeginCrossfade();
+        }
+        m_cachedFilter = &filter;
+        m_filterCached = true;
+        m_filterSwitches.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (m_crossfading) {
+        m_transitionBlocks.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // The history buffer is sized at construction; longer blocks run through it in pieces
+    const size_t chunk = m_historyBuffer.size() - static_cast<size_t>(m_filterLength);
+    for (size_t processed = 0; processed < frames; processed += chunk) {
+        const size_t count = std::min(chunk, frames - processed);
+        ConvolveTimeDomain(input + processed, outputLeft + processed, outputRight + processed, count, filter);
+    }
+}
+
+void HRTFProcessor::ConvolutionEngine::ConvolveTimeDomain(const float* input, float* outputLeft, float* outputRight,
+                                                         size_t frames, const HRTFData::Filter& filter) {
+    // Copy input to end of history buffer
+    std::copy(input, input + frames, m_historyBuffer.begin() + m_filterLength);
+
+    // Perform time-domain convolution for each output channel
+    const HRTFData::Filter* outgoing = m_crossfading ? m_previousFilter : nullptr;
+    for (size_t i = 0; i < frames; ++i) {
+        float leftSum = 0.0f;
+        float rightSum = 0.0f;
+        float previousLeftSum = 0.0f;
+        float previousRightSum = 0.0f;
+
+        // Convolve with HRTF filters
+        for (int j = 0; j < m_filterLength; ++j) {
+            float inputSample = m_historyBuffer[i + m_filterLength - j];
+            leftSum += inputSample * filter.left[j];
+            rightSum += inputSample * filter.right[j];
+        }
+
+        // Outgoing filter only for the remainder of the crossfade window
+        if (outgoing && m_crossfading) {
+            for (int j = 0; j < m_filterLength; ++j) {
+                float inputSample = m_historyBuffer[i + m_filterLength - j];
+                previousLeftSum += inputSample * outgoing->left[j];
+                previousRightSum += inputSample * outgoing->right[j];
+            }
+            ApplyCrossfade(&leftSum, &previousLeftSum, 1);
+            ApplyCrossfade(&rightSum, &previousRightSum, 1);
+            AdvanceCrossfade(1);
+        }
+
+        outputLeft[i] = leftSum;
+        outputRight[i] = rightSum;
+    }
+
+    // Shift history buffer: move end portion to beginning
+    std::copy(m_historyBuffer.begin() + frames,
+             m_historyBuffer.begin() + frames + m_filterLength,
+             m_historyBuffer.begin());
+
+    // Clear the input portion for next iteration
+    std::fill(m_historyBuffer.begin() + m_filterLength, m_historyBuffer.end(), 0.0f);
+}
+
+void HRTFProcessor::ConvolutionEngine::ComputeFilterSpectrum(const HRTFData::Filter& filter, FilterSpectrum& spectrum) {
+    const size_t spectrumSize = static_cast<size_t>(m_numPartitions) * m_numBins;
+    spectrum.left.resize(spectrumSize);
+    spectrum.right.resize(spectrumSize);
+    ComputeFilterFFT(filter, spectrum.left.data(), spectrum.right.data());
+}
+
+void HRTFProcessor::ConvolutionEngine::ComputeFilterFFT(const HRTFData::Filter& filter,
+                                                       std::complex<float>* spectrumLeft,
+                                                       std::complex<float>* spectrumRight) {
+    const int taps = std::min(m_filterLength, HRTFData::FILTER_LENGTH);
+
+    for (int partition = 0; partition < m_numPartitions; ++partition) {
+        const int begin = partition * m_blockSize;
+        const int end = std::min(begin + m_blockSize, taps);
+        const size_t offset = static_cast<size_t>(partition) * m_numBins;
+
+        // Each partition occupies the first half of the window, zero-padded to fftSize
+        std::fill(m_timeScratch.begin(), m_timeScratch.end(), 0.0f);
+        if (begin < end) {
+            std::copy(filter.left.begin() + begin, filter.left.begin() + end, m_timeScratch.begin());
+        }
+        PerformRealFFT(m_timeScratch.data(), spectrumLeft + offset, m_fftSize);
+
+        std::fill(m_timeScratch.begin(), m_timeScratch.end(), 0.0f);
+        if (begin < end) {
+            std::copy(filter.right.begin() + begin, filter.right.begin() + end, m_timeScratch.begin());
+        }
+        PerformRealFFT(m_timeScratch.data(), spectrumRight + offset, m_fftSize);
+    }
+}
+
+void HRTFProcessor::ConvolutionEngine::UpdateTailSpectrum() {
+    AccumulateTail(m_activeFilterLeft, m_activeFilterRight, m_tailFFTLeft, m_tailFFTRight);
+    if (m_crossfading) {
+        AccumulateTail(m_previousFilterLeft, m_previousFilterRight, m_previousTailFFTLeft, m_previousTailFFTRight);
+    }
+}
+
+void HRTFProcessor::ConvolutionEngine::AccumulateTail(const std::complex<float>* filterLeft,
+                                                     const std::complex<float>* filterRight,
+                                                     std::vector<std::complex<float>>& tailLeft,
+                                                     std::vector<std::complex<float>>& tailRight) {
+    std::fill(tailLeft.begin(), tailLeft.end(), std::complex<float>(0.0f, 0.0f));
+    std::fill(tailRight.begin(), tailRight.end(), std::complex<float>(0.0f, 0.0f));
+
+    const int historyLength = m_numPartitions - 1;
+    if (!filterLeft || !filterRight) {
+        return;
+    }
+    for (int partition = 1; partition < m_numPartitions; ++partition) {
+        // Partition k applies to the window completed k blocks ago
+        const int slot = (m_spectrumHistoryIndex - (partition - 1) + historyLength) % historyLength;
+        const std::complex<float>* history = m_spectrumHistory.data() + static_cast<size_t>(slot) * m_numBins;
+        const size_t offset = static_cast<size_t>(partition) * m_numBins;
+
+        ComplexMultiplyAccumulate(history, filterLeft + offset, tailLeft.data(), m_numBins);
+        ComplexMultiplyAccumulate(history, filterRight + offset, tailRight.data(), m_numBins);
+    }
+}
+
+void HRTFProcessor::ConvolutionEngine::PerformRealFFT(const float* input, std::complex<float>* output, int size) {
+    // Real FFT of length `size` via a complex FFT of length size/2 on packed even/odd samples
+    const int half = size / 2;
+    std::complex<float>* packed = m_fftWorkspace.data();
+    std::complex<float>* spectrum = m_fftWorkspace.data() + half;
+
+    for (int n = 0; n < half; ++n) {
+        packed[n] = std::complex<float>(input[2 * n], input[2 * n + 1]);
+    }
+
+    FFTRadix2(packed, spectrum, half);
+
+    for (int k = 0; k <= half; ++k) {
+        const std::complex<float> zk = spectrum[k % half];
+        const std::complex<float> zmk = std::conj(spectrum[(half - k) % half]);
+        const std::complex<float> even = 0.5f * (zk + zmk);
+        const std::complex<float> odd = std::complex<float>(0.0f, -0.5f) * (zk - zmk);
+        const std::complex<float> twiddle = (k < half) ? m_twiddleFactors[k] : std::complex<float>(-1.0f, 0.0f);
+        output[k] = even + twiddle * odd;
+    }
+}
+
+void HRTFProcessor::ConvolutionEngine::PerformRealIFFT(const std::complex<float>* input, float* output, int size) {
+    const int half = size / 2;
+    std::complex<float>* packed = m_fftWorkspace.data();
+    std::complex<float>* signal = m_fftWorkspace.data() + half;
+
+    // Undo the even/odd split, then a half-size inverse FFT yields interleaved samples
+    for (int k = 0; k < half; ++k) {
+        const std::complex<float> xk = input[k];
+        const std::complex<float> xmk = std::conj(input[half - k]);
+        const std::complex<float> even = 0.5f * (xk + xmk);
+        const std::complex<float> odd = 0.5f * (xk - xmk) * std::conj(m_twiddleFactors[k]);
+        packed[k] = even + std::complex<float>(0.0f, 1.0f) * odd;
+    }
+
+    IFFTRadix2(packed, signal, half);
+
+    for (int n = 0; n < half; ++n) {
+        output[2 * n] = signal[n].real();
+        output[2 * n + 1] = signal[n].imag();
+    }
+}
+
+void HRTFProcessor::ConvolutionEngine::FFTRadix2(const std::complex<float>* input, std::complex<float>* output, int size) {
+    // Out-of-place; size must equal fftSize / 2 (the size of the bit reversal table)
+    for (int i = 0; i < size; ++i) {
+        output[m_bitReverse[i]] = input[i];
+    }
+    Butterflies(output, size, false);
+}
+
+void HRTFProcessor::ConvolutionEngine::IFFTRadix2(const std::complex<float>* input, std::complex<float>* output, int size) {
+    for (int i = 0; i < size; ++i) {
+        output[m_bitReverse[i]] = input[i];
+    }
+    Butterflies(output, size, true);
+
+    const float scale = 1.0f / static_cast<float>(size);
+    for (int i = 0; i < size; ++i) {
+        output[i] *= scale;
+    }
+}
+
+void HRTFProcessor::ConvolutionEngine::Butterflies(std::complex<float>* data, int size, bool inverse) {
+    for (int length = 2; length <= size; length <<= 1) {
+        const int halfLength = length / 2;
+        const int stride = m_fftSize / length;
+
+        for (int start = 0; start < size; start += length) {
+            for (int k = 0; k < halfLength; ++k) {
+                std::complex<float> twiddle = m_twiddleFactors[k * stride];
+                if (inverse) {
+                    twiddle = std::conj(twiddle);
+                }
+
+                const std::complex<float> a = data[start + k];
+                const std::complex<float> b = data[start + k + halfLength];
+                const float br = b.real() * twiddle.real() - b.imag() * twiddle.imag();
+                const float bi = b.real() * twiddle.imag() + b.imag() * twiddle.real();
+
+                data[start + k] = std::complex<float>(a.real() + br, a.imag() + bi);
+                data[start + k + halfLength] = std::complex<float>(a.real() - br, a.imag() - bi);
+            }
+        }
+    }
+}
+
+void HRTFProcessor::ConvolutionEngine::ComplexMultiply(const std::complex<float>* a, const std::complex<float>* b,
+                                                      std::complex<float>* result, int size) {
+    // Explicit real arithmetic avoids the NaN/Inf recovery path of std::complex operator*
+    simd::complexMultiply(reinterpret_cast<const float*>(a), reinterpret_cast<const float*>(b),
+                          reinterpret_cast<float*>(result), static_cast<size_t>(size));
+}
+
+void HRTFProcessor::ConvolutionEngine::ComplexMultiplyAccumulate(const std::complex<float>* a, const std::complex<float>* b,
+                                                                std::complex<float>* accumulator, int size) {
+    simd::complexMultiplyAccumulate(reinterpret_cast<const float*>(a), reinterpret_cast<const float*>(b),
+                                    reinterpret_cast<float*>(accumulator), static_cast<size_t>(size));
 }
 
 void HRTFProcessor::ConvolutionEngine::Reset() {
@@ -314,9 +1883,223 @@ void HRTFProcessor::ConvolutionEngine::Reset() {
     // Clear cached filter
     m_cachedFilter = nullptr;
     m_filterCached = false;
-
-    // Clear overlap buffer if using FFT
+    m_activeFilterLeft = nullptr;
+    m_activeFilterRight = nullptr;
+    m_crossfading = false;
+    m_previousFilter = nullptr;
+    m_previousFilterLeft = nullptr;
+    m_previousFilterRight = nullptr;
+
+    // Clear FFT state
     std::fill(m_overlapBuffer.begin(), m_overlapBuffer.end(), 0.0f);
+    std::fill(m_spectrumHistory.begin(), m_spectrumHistory.end(), std::complex<float>(0.0f, 0.0f));
+    std::fill(m_tailFFTLeft.begin(), m_tailFFTLeft.end(), std::complex<float>(0.0f, 0.0f));
+    std::fill(m_tailFFTRight.begin(), m_tailFFTRight.end(), std::complex<float>(0.0f, 0.0f));
+    m_spectrumHistoryIndex = 0;
+
+    // Clear delay lines
+    for (auto& line : m_delayLines) {
+        std::fill(line.begin(), line.end(), 0.0f);
+    }
+    m_delayRampPosition = 0;
+    m_delayRampLength = 0;
+}
+
+HRTFProcessor::FilterBank::FilterBank(const HRTFData& data, int filterLength, int fftSize, size_t capacity)
+    : m_data(data)
+    , m_transform(filterLength, fftSize, true)
+    , m_slots(std::max<size_t>(1, std::min(capacity, data.filters.size())))
+    , m_slotForFilter(data.filters.size())
+    , m_requests(data.filters.size()) {
+    for (auto& slot : m_slotForFilter) {
+        slot.store(-1, std::memory_order_relaxed);
+    }
+    for (auto& request : m_requests) {
+        request.store(REQUEST_NONE, std::memory_order_relaxed);
+    }
+
+    m_running = true;
+    m_worker = std::thread([this] { WorkerLoop(); });
+
+    LOG_DEBUG("FilterBank created - {} slots for {} filters", m_slots.size(), data.filters.size());
+}
+
+HRTFProcessor::FilterBank::~FilterBank() {
+    {
+        std::lock_guard<std::mutex> lock(m_workerMutex);
+        m_running = false;
+    }
+    m_workerCondition.notify_all();
+    if (m_worker.joinable()) {
+        m_worker.join();
+    }
+}
+
+int HRTFProcessor::FilterBank::Acquire(int filterIndex) {
+    if (filterIndex < 0 || filterIndex >= static_cast<int>(m_slotForFilter.size())) {
+        return -1;
+    }
+
+    const int slotIndex = m_slotForFilter[filterIndex].load();
+    if (slotIndex >= 0) {
+        Slot& slot = m_slots[slotIndex];
+
+        // Pin first, then confirm the mapping; eviction clears the mapping before
+        // checking pins, so one of the two sides always sees the other
+        slot.pins.fetch_add(1);
+        if (slot.filterIndex.load() == filterIndex && m_slotForFilter[filterIndex].load() == slotIndex) {
+            slot.lastUse.store(m_clock.fetch_add(1, std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            m_hits.fetch_add(1, std::memory_order_relaxed);
+            return slotIndex;
+        }
+        slot.pins.fetch_sub(1);
+    }
+
+    // Miss: the caller transforms this once itself, the worker fills the bank for next time
+    m_misses.fetch_add(1, std::memory_order_relaxed);
+    RequestFilter(filterIndex, REQUEST_DEMAND);
+    return -1;
+}
+
+void HRTFProcessor::FilterBank::Release(int slot) {
+    if (slot >= 0 && slot < static_cast<int>(m_slots.size())) {
+        m_slots[slot].pins.fetch_sub(1);
+    }
+}
+
+void HRTFProcessor::FilterBank::Prefetch(float azimuth, float elevation, const Vec3& angularVelocity) {
+    // Immediate neighbourhood of the current direction
+    for (int de = -1; de <= 1; ++de) {
+        for (int da = -1; da <= 1; ++da) {
+            RequestDirection(azimuth + da * PREFETCH_PROBE_DEGREES, elevation + de * PREFETCH_PROBE_DEGREES);
+        }
+    }
+
+    // Cells along the predicted path: yawing left (+y) moves sources to the right,
+    // pitching up (+x) moves them down
+    const float yawRate = static_cast<float>(angularVelocity.y * 180.0 / M_PI);
+    const float pitchRate = static_cast<float>(angularVelocity.x * 180.0 / M_PI);
+    if (std::abs(yawRate) > 1.0f || std::abs(pitchRate) > 1.0f) {
+        for (int step = 1; step <= PREFETCH_STEPS; ++step) {
+            const float t = step * PREFETCH_STEP_SECONDS;
+            RequestDirection(azimuth + yawRate * t, elevation - pitchRate * t);
+        }
+    }
+
+    m_workerCondition.notify_one();
+}
+
+HRTFProcessor::FilterBank::Stats HRTFProcessor::FilterBank::GetStats() const {
+    Stats stats;
+    stats.hits = m_hits.load(std::memory_order_relaxed);
+    stats.misses = m_misses.load(std::memory_order_relaxed);
+    stats.populated = m_populated.load(std::memory_order_relaxed);
+    stats.evictions = m_evictions.load(std::memory_order_relaxed);
+    stats.resident = m_resident.load(std::memory_order_relaxed);
+    stats.capacity = m_slots.size();
+    return stats;
+}
+
+void HRTFProcessor::FilterBank::RequestDirection(float azimuth, float elevation) {
+    // Every vertex the interpolation at this direction will blend
+    const HRTFData::Interpolation interpolation = m_data.Interpolate(azimuth, elevation);
+    for (int index : interpolation.indices) {
+        RequestFilter(index, REQUEST_PREFETCH);
+    }
+}
+
+void HRTFProcessor::FilterBank::RequestFilter(int filterIndex, uint8_t priority) {
+    if (filterIndex < 0 || filterIndex >= static_cast<int>(m_requests.size())) {
+        return;
+    }
+    if (m_slotForFilter[filterIndex].load(std::memory_order_relaxed) >= 0) {
+        return;  // Already resident
+    }
+
+    // Raise, never lower, the pending priority
+    uint8_t current = m_requests[filterIndex].load(std::memory_order_relaxed);
+    while (current < priority &&
+           !m_requests[filterIndex].compare_exchange_weak(current, priority, std::memory_order_relaxed)) {
+    }
+}
+
+void HRTFProcessor::FilterBank::WorkerLoop() {
+    // The audio thread only raises request flags and never signals, so poll briefly
+    constexpr auto POLL_INTERVAL = std::chrono::milliseconds(2);
+
+    while (m_running) {
+        {
+            std::unique_lock<std::mutex> lock(m_workerMutex);
+            m_workerCondition.wait_for(lock, POLL_INTERVAL, [this] { return !m_running; });
+        }
+
+        // Demand misses first, then motion-predicted prefetches
+        for (uint8_t priority : {REQUEST_DEMAND, REQUEST_PREFETCH}) {
+            for (size_t i = 0; i < m_requests.size() && m_running; ++i) {
+                if (m_requests[i].load(std::memory_order_relaxed) != priority) {
+                    continue;
+                }
+                m_requests[i].store(REQUEST_NONE, std::memory_order_relaxed);
+                Populate(static_cast<int>(i));
+            }
+        }
+    }
+}
+
+int HRTFProcessor::FilterBank::SelectSlot() const {
+    int victim = -1;
+    uint64_t oldest = UINT64_MAX;
+
+    for (size_t i = 0; i < m_slots.size(); ++i) {
+        const Slot& slot = m_slots[i];
+        if (slot.pins.load() != 0) {
+            continue;
+        }
+        if (slot.filterIndex.load(std::memory_order_relaxed) < 0) {
+            return static_cast<int>(i);  // Free slot
+        }
+        const uint64_t lastUse = slot.lastUse.load(std::memory_order_relaxed);
+        if (lastUse < oldest) {
+            oldest = lastUse;
+            victim = static_cast<int>(i);
+        }
+    }
+    return victim;
+}
+
+bool HRTFProcessor::FilterBank::Populate(int filterIndex) {
+    if (m_slotForFilter[filterIndex].load() >= 0) {
+        return false;
+    }
+
+    const int slotIndex = SelectSlot();
+    if (slotIndex < 0) {
+        return false;  // Every slot is pinned
+    }
+
+    Slot& slot = m_slots[slotIndex];
+    const int previous = slot.filterIndex.load();
+    if (previous >= 0) {
+        // Unpublish, then back off if the audio thread pinned it in the meantime
+        slot.filterIndex.store(-1);
+        m_slotForFilter[previous].store(-1);
+        if (slot.pins.load() != 0) {
+            slot.filterIndex.store(previous);
+            m_slotForFilter[previous].store(slotIndex);
+            return false;
+        }
+        m_evictions.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        m_resident.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    m_transform.ComputeFilterSpectrum(m_data.filters[filterIndex], slot.spectrum);
+
+    slot.lastUse.store(m_clock.fetch_add(1, std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    slot.filterIndex.store(filterIndex);
+    m_slotForFilter[filterIndex].store(slotIndex);
+    m_populated.fetch_add(1, std::memory_order_relaxed);
+    return true;
 }
 
 // Stub implementations for InterpolationEngine
@@ -371,6 +2154,34 @@ const HRTFProcessor::HRTFData::Filter& HRTFProcessor::HRTFData::GetFilter(float
 }
 
 int HRTFProcessor::HRTFData::GetFilterIndex(float azimuth, float elevation) const {
+    // Nearest measured filter: the dominant vertex of the enclosing triangle
+    if (triangulation.IsValid()) {
+        const Interpolation interpolation = triangulation.Locate(azimuth, elevation);
+        int dominant = 0;
+        for (int v = 1; v < 3; ++v) {
+            if (interpolation.weights[v] > interpolation.weights[dominant]) {
+                dominant = v;
+            }
+        }
+        return interpolation.indices[dominant];
+    }
+
+    // Measured set that could not be triangulated (e.g. a single ring): closest direction
+    if (positions.size() == filters.size() && !positions.empty()) {
+        const auto target = DirectionVector(azimuth, elevation);
+        int nearest = 0;
+        float best = -2.0f;
+        for (size_t i = 0; i < positions.size(); ++i) {
+            const auto direction = DirectionVector(positions[i].azimuth, positions[i].elevation);
+            const float dot = direction[0] * target[0] + direction[1] * target[1] + direction[2] * target[2];
+            if (dot > best) {
+                best = dot;
+                nearest = static_cast<int>(i);
+            }
+        }
+        return nearest;
+    }
+
     // Normalize angles
     while (azimuth < -180.0f) azimuth += 360.0f;
     while (azimuth > 180.0f) azimuth -= 360.0f;
@@ -387,17 +2198,650 @@ int HRTFProcessor::HRTFData::GetFilterIndex(float azimuth, float elevation) cons
     return std::min(index, static_cast<int>(filters.size()) - 1);
 }
 
+bool HRTFProcessor::HRTFData::DecomposeMinimumPhase(int taps, WorkerPool* pool) {
+    if (ownedFilters.empty()) {
+        return false;
+    }
+    taps = std::clamp(taps, 16, FILTER_LENGTH);
+
+    // Filters are independent, so a pool takes them in parallel
+    auto decompose = [this, taps](size_t index) {
+        std::vector<float> minimumPhase(taps);
+        auto& filter = ownedFilters[index];
+        for (int ear = 0; ear < 2; ++ear) {
+            auto& response = (ear == 0) ? filter.left : filter.right;
+            const float lag = DecomposeImpulseResponse(response.data(), FILTER_LENGTH, minimumPhase.data(), taps);
+            std::copy(minimumPhase.begin(), minimumPhase.end(), response.begin());
+            std::fill(response.begin() + taps, response.end(), 0.0f);
+            ((ear == 0) ? filter.leftDelay : filter.rightDelay) = lag;
+        }
+    };
+    if (pool) {
+        pool->Run(ownedFilters.size(), decompose);
+    } else {
+        for (size_t i = 0; i < ownedFilters.size(); ++i) {
+            decompose(i);
+        }
+    }
+
+    float minimumLag = std::numeric_limits<float>::max();
+    for (const auto& filter : ownedFilters) {
+        minimumLag = std::min({minimumLag, filter.leftDelay, filter.rightDelay});
+    }
+
+    // Drop the propagation delay common to the whole dataset; only the ear differences matter
+    maxDelay = 0.0f;
+    for (auto& filter : ownedFilters) {
+        filter.leftDelay = filter.leftDelay - minimumLag + MIN_EAR_DELAY_SAMPLES;
+        filter.rightDelay = filter.rightDelay - minimumLag + MIN_EAR_DELAY_SAMPLES;
+        maxDelay = std::max({maxDelay, filter.leftDelay, filter.rightDelay});
+    }
+    filterLength = taps;
+
+    LOG_INFO("Minimum-phase HRTF: {} taps, ear delays up to {:.2f} samples (removed {:.2f} common)",
+             taps, maxDelay, minimumLag);
+    return true;
+}
+
+bool HRTFProcessor::HRTFData::AttachCache(std::unique_ptr<HRTFCacheFile> file) {
+    using Section = HRTFCacheFile::Section;
+    const auto& metadata = file->GetMetadata();
+    if (metadata.filterRecordSize != sizeof(Filter) || metadata.filterCount == 0 ||
+        metadata.filterLength == 0 || metadata.filterLength > static_cast<uint32_t>(FILTER_LENGTH)) {
+        return false;
+    }
+
+    // Sections start 64-byte aligned inside a page-aligned mapping, so records are used in place
+    size_t filterBytes = 0, positionBytes = 0;
+    const void* filterData = file->GetSection(Section::Filters, filterBytes);
+    const void* positionData = file->GetSection(Section::Positions, positionBytes);
+    if (!filterData || filterBytes != metadata.filterCount * sizeof(Filter) ||
+        positionBytes != metadata.filterCount * sizeof(Position)) {
+        return false;
+    }
+
+    size_t triangleBytes = 0, basisBytes = 0, lookupBytes = 0;
+    const void* triangleData = file->GetSection(Section::Triangles, triangleBytes);
+    const void* basisData = file->GetSection(Section::InverseBases, basisBytes);
+    const void* lookupData = file->GetSection(Section::Lookup, lookupBytes);
+    if (triangleData &&
+        !triangulation.Attach({static_cast<const std::array<int, 3>*>(triangleData), triangleBytes / sizeof(std::array<int, 3>)},
+                       {static_cast<const std::array<float, 9>*>(basisData), basisBytes / sizeof(std::array<float, 9>)},
+                       {static_cast<const int*>(lookupData), lookupBytes / sizeof(int)}, metadata.filterCount)) {
+        return false;
+    }
+
+    ownedFilters.clear();
+    ownedPositions.clear();
+    filters = {static_cast<const Filter*>(filterData), metadata.filterCount};
+    positions = {static_cast<const Position*>(positionData), metadata.filterCount};
+    sampleRate = static_cast<int>(metadata.sampleRate);
+    filterLength = static_cast<int>(metadata.filterLength);
+    maxDelay = metadata.maxDelay;
+    cache = std::move(file);
+    return true;
+}
+
+bool HRTFProcessor::HRTFData::WriteCache(const std::string& path, const std::string& key, std::string& error) const {
+    using Section = HRTFCacheFile::Section;
+    static_assert(std::is_trivially_copyable<Filter>::value, "filter records are written as raw bytes");
+
+    HRTFCacheFile::Metadata metadata;
+    metadata.sampleRate = static_cast<uint32_t>(sampleRate);
+    metadata.filterCount = static_cast<uint32_t>(filters.size());
+    metadata.filterLength = static_cast<uint32_t>(filterLength);
+    metadata.filterRecordSize = sizeof(Filter);
+    metadata.maxDelay = maxDelay;
+    metadata.key = key;
+
+    std::vector<HRTFCacheFile::SectionData> sections = {
+        {Section::Positions, positions.data(), positions.size() * sizeof(Position)},
+        {Section::Filters, filters.data(), filters.size() * sizeof(Filter)},
+    };
+    if (triangulation.IsValid()) {
+        const auto triangles = triangulation.GetTriangles();
+        const auto bases = triangulation.GetInverseBases();
+        const auto lookup = triangulation.GetLookup();
+        sections.push_back({Section::Triangles, triangles.data(), triangles.size() * sizeof(triangles[0])});
+        sections.push_back({Section::InverseBases, bases.data(), bases.size() * sizeof(bases[0])});
+        sections.push_back({Section::Lookup, lookup.data(), lookup.size() * sizeof(lookup[0])});
+    }
+    return HRTFCacheFile::Write(path, metadata, sections, error);
+}
+
+HRTFProcessor::HRTFData::Interpolation HRTFProcessor::HRTFData::Interpolate(float azimuth, float elevation) const {
+    if (triangulation.IsValid()) {
+        return triangulation.Locate(azimuth, elevation);
+    }
+
+    // No measurement positions: nearest grid filter at full weight
+    Interpolation interpolation;
+    interpolation.indices[0] = GetFilterIndex(azimuth, elevation);
+    interpolation.weights[0] = 1.0f;
+    return interpolation;
+}
+
+bool HRTFProcessor::HRTFData::Triangulation::Build(Table<Position> positions) {
+    m_ownedTriangles.clear();
+    m_ownedInverseBases.clear();
+    m_ownedLookup.clear();
+    m_triangles = {};
+    m_inverseBases = {};
+    m_lookup = {};
+
+    // Merge coincident directions (e.g. every azimuth at a pole) onto their first filter
+    std::vector<Point3> points;
+    std::vector<int> pointToFilter;
+    for (size_t i = 0; i < positions.size(); ++i) {
+        const auto direction = DirectionVector(positions[i].azimuth, positions[i].elevation);
+        const Point3 point = {{direction[0], direction[1], direction[2]}};
+
+        bool duplicate = false;
+        for (const auto& existing : points) {
+            if (Dot(existing, point) > 1.0 - 1e-9) {
+                duplicate = true;
+                break;
+            }
+        }
+        if (!duplicate) {
+            points.push_back(point);
+            pointToFilter.push_back(static_cast<int>(i));
+        }
+    }
+
+    std::vector<std::array<int, 3>> hull;
+    if (!BuildConvexHull(points, hull)) {
+        LOG_WARN("HRTF triangulation failed for {} unique directions", points.size());
+        return false;
+    }
+
+    // Inverse of [a b c] maps a direction to (unnormalized) barycentric weights
+    for (const auto& triangle : hull) {
+        const Point3& a = points[triangle[0]];
+        const Point3& b = points[triangle[1]];
+        const Point3& c = points[triangle[2]];
+        const Point3 bc = Cross(b, c);
+        const double determinant = Dot(a, bc);
+        if (std::abs(determinant) < 1e-12) {
+            continue;  // Plane through the centre (only possible for hemispherical sets)
+        }
+
+        const Point3 ca = Cross(c, a);
+        const Point3 ab = Cross(a, b);
+        std::array<float, 9> inverse;
+        for (int k = 0; k < 3; ++k) {
+            inverse[k] = static_cast<float>(bc[k] / determinant);
+            inverse[3 + k] = static_cast<float>(ca[k] / determinant);
+            inverse[6 + k] = static_cast<float>(ab[k] / determinant);
+        }
+
+        m_ownedTriangles.push_back({{pointToFilter[triangle[0]], pointToFilter[triangle[1]], pointToFilter[triangle[2]]}});
+        m_ownedInverseBases.push_back(inverse);
+    }
+    m_triangles = {m_ownedTriangles.data(), m_ownedTriangles.size()};
+    m_inverseBases = {m_ownedInverseBases.data(), m_ownedInverseBases.size()};
+
+    // Constant-time lookup: enclosing triangle of each 1-degree cell centre
+    m_ownedLookup.assign(static_cast<size_t>(LUT_AZIMUTHS) * LUT_ELEVATIONS, 0);
+    int hint = 0;
+    for (int el = 0; el < LUT_ELEVATIONS; ++el) {
+        for (int az = 0; az < LUT_AZIMUTHS; ++az) {
+            const auto direction = DirectionVector(static_cast<float>(az - 180), static_cast<float>(el - 90));
+            hint = FindTriangle(direction, hint);
+            m_ownedLookup[static_cast<size_t>(el) * LUT_AZIMUTHS + az] = hint;
+        }
+    }
+    m_lookup = {m_ownedLookup.data(), m_ownedLookup.size()};
+
+    LOG_INFO("HRTF triangulation: {} directions, {} triangles", points.size(), m_triangles.size());
+    return !m_triangles.empty();
+}
+
+bool HRTFProcessor::HRTFData::Triangulation::Attach(Table<std::array<int, 3>> triangles,
+                                                     Table<std::array<float, 9>> inverseBases,
+                                                     Table<int> lookup, size_t filterCount) {
+    m_ownedTriangles.clear();
+    m_ownedInverseBases.clear();
+    m_ownedLookup.clear();
+    m_triangles = {};
+    m_inverseBases = {};
+    m_lookup = {};
+
+    // The checksum catches damage, not a file built for a different dataset layout
+    if (triangles.empty() || inverseBases.size() != triangles.size() ||
+        lookup.size() != static_cast<size_t>(LUT_AZIMUTHS) * LUT_ELEVATIONS) {
+        return false;
+    }
+    for (const auto& triangle : triangles) {
+        for (int index : triangle) {
+            if (index < 0 || static_cast<size_t>(index) >= filterCount) {
+                return false;
+            }
+        }
+    }
+    for (int triangle : lookup) {
+        if (triangle < 0 || static_cast<size_t>(triangle) >= triangles.size()) {
+            return false;
+        }
+    }
+
+    m_triangles = triangles;
+    m_inverseBases = inverseBases;
+    m_lookup = lookup;
+    return true;
+}
+
+float HRTFProcessor::HRTFData::Triangulation::MinimumWeight(int triangle, const std::array<float, 3>& direction) const {
+    const auto& m = m_inverseBases[triangle];
+    float minimum = 0.0f;
+    for (int v = 0; v < 3; ++v) {
+        const float weight = m[v * 3] * direction[0] + m[v * 3 + 1] * direction[1] + m[v * 3 + 2] * direction[2];
+        minimum = (v == 0) ? weight : std::min(minimum, weight);
+    }
+    return minimum;
+}
+
+int HRTFProcessor::HRTFData::Triangulation::FindTriangle(const std::array<float, 3>& direction, int hint) const {
+    constexpr float TOLERANCE = -1e-6f;
+    if (hint >= 0 && hint < static_cast<int>(m_triangles.size()) && MinimumWeight(hint, direction) >= TOLERANCE) {
+        return hint;
+    }
+
+    // The most interior triangle also covers directions that fall in a gap of the dataset
+    int best = 0;
+    float bestWeight = -std::numeric_limits<float>::max();
+    for (size_t t = 0; t < m_triangles.size(); ++t) {
+        const float weight = MinimumWeight(static_cast<int>(t), direction);
+        if (weight > bestWeight) {
+            bestWeight = weight;
+            best = static_cast<int>(t);
+        }
+        if (weight >= TOLERANCE) {
+            return best;
+        }
+    }
+    return best;
+}
+
+HRTFProcessor::HRTFData::Interpolation HRTFProcessor::HRTFData::Triangulation::Locate(float azimuth, float elevation) const {
+    Interpolation interpolation;
+    if (m_triangles.empty()) {
+        return interpolation;
+    }
+
+    while (azimuth < -180.0f) azimuth += 360.0f;
+    while (azimuth >= 180.0f) azimuth -= 360.0f;
+    elevation = std::clamp(elevation, -90.0f, 90.0f);
+
+    const int az = static_cast<int>(std::lround(azimuth + 180.0f)) % LUT_AZIMUTHS;
+    const int el = std::clamp(static_cast<int>(std::lround(elevation + 90.0f)), 0, LUT_ELEVATIONS - 1);
+    const int triangle = m_lookup[static_cast<size_t>(el) * LUT_AZIMUTHS + az];
+
+    // Weights at the exact direction; clamping absorbs the few directions near a
+    // cell edge that fall just outside the cell-centre triangle
+    const auto direction = DirectionVector(azimuth, elevation);
+    const auto& m = m_inverseBases[triangle];
+    float sum = 0.0f;
+    for (int v = 0; v < 3; ++v) {
+        const float weight = m[v * 3] * direction[0] + m[v * 3 + 1] * direction[1] + m[v * 3 + 2] * direction[2];
+        interpolation.weights[v] = std::max(0.0f, weight);
+        sum += interpolation.weights[v];
+    }
+    for (int v = 0; v < 3; ++v) {
+        interpolation.weights[v] = (sum > 0.0f) ? interpolation.weights[v] / sum : (v == 0 ? 1.0f : 0.0f);
+    }
+    interpolation.indices = m_triangles[triangle];
+    return interpolation;
+}
+
 // Implementation of missing LoadHRTFDataset method
 bool HRTFProcessor::LoadHRTFDataset(const std::string& path) {
+    const DatasetSource source = ResolveDatasetSource(path);
+    m_datasetSource = source.key;
+
+    // A precompiled dataset for these settings skips decoding, decomposition and triangulation
+    if (!m_cachePath.empty() && LoadCachedDataset()) {
+        return true;
+    }
+
     LOG_INFO("Loading HRTF dataset from: {}", path);
+    const auto start = std::chrono::steady_clock::now();
+    WorkerPool pool;
+
+    bool loaded = false;
+    switch (source.format) {
+        case DatasetSource::Format::MITKEMARCompact:
+            loaded = LoadMITKEMARCompact(source.location, pool);
+            break;
+        case DatasetSource::Format::MITKEMARFull:
+            loaded = LoadMITKEMARFiles(source.location, pool);
+            break;
+        case DatasetSource::Format::SOFA:
+            loaded = LoadSOFAFile(source.location, pool);
+            break;
+        case DatasetSource::Format::Synthetic:
+            if (!path.empty()) {
+                LOG_WARN("No MIT KEMAR or SOFA dataset found at '{}'", path);
+            }
+            break;
+    }
+
+    // Without measurements, a synthetic set that still produces spatial differences
+    if (!loaded) {
+        m_datasetSource = DatasetSource().key;
+        if (!GenerateHighQualitySyntheticHRTF()) {
+            LOG_ERROR("Failed to generate synthetic HRTF dataset");
+            return false;
+        }
+    }
+
+    // Minimum-phase filters plus per-ear delays: shorter convolution, aligned interpolation
+    if (m_minimumPhase && !m_hrtfData->DecomposeMinimumPhase(m_minimumPhaseTaps, &pool)) {
+        LOG_WARN("Minimum-phase decomposition failed, using full-length filters");
+    }
+
+    // Triangulate the measurement directions for barycentric interpolation
+    if (m_hrtfData->positions.size() == m_hrtfData->filters.size() &&
+        !m_hrtfData->triangulation.Build(m_hrtfData->positions)) {
+        LOG_WARN("HRTF interpolation unavailable, using nearest-filter lookup");
+    }
+
+    const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+    LOG_INFO("HRTF dataset loaded successfully with {} filters in {:.0f} ms ({} threads)",
+             m_hrtfData->filters.size(), elapsed.count(), pool.GetThreadCount());
+
+    // A cache that cannot be written only costs the next startup its shortcut
+    if (!m_cachePath.empty()) {
+        std::string error;
+        if (m_hrtfData->WriteCache(m_cachePath, GetCacheKey(), error)) {
+            LOG_INFO("Precompiled HRTF dataset written to {}", m_cachePath);
+        } else {
+            LOG_WARN("Could not write precompiled HRTF dataset {}: {}", m_cachePath, error);
+        }
+    }
+    return true;
+}
+
+bool HRTFProcessor::LoadCachedDataset() {
+    auto file = std::make_unique<HRTFCacheFile>();
+    std::string error;
+    if (!file->Open(m_cachePath, error)) {
+        if (std::filesystem::exists(m_cachePath)) {
+            LOG_WARN("Ignoring precompiled HRTF dataset {}: {}", m_cachePath, error);
+        }
+        return false;
+    }
+
+    const std::string key = GetCacheKey();
+    if (file->GetMetadata().key != key) {
+        LOG_INFO("Precompiled HRTF dataset {} was built for '{}', rebuilding for '{}'",
+                 m_cachePath, file->GetMetadata().key, key);
+        return false;
+    }
+    if (!m_hrtfData->AttachCache(std::move(file))) {
+        LOG_WARN("Ignoring precompiled HRTF dataset {}: layout does not match this build", m_cachePath);
+        return false;
+    }
+
+    LOG_INFO("Mapped precompiled HRTF dataset {} ({} filters of {} taps at {} Hz)", m_cachePath,
+             m_hrtfData->filters.size(), m_hrtfData->filterLength, m_hrtfData->sampleRate);
+    return true;
+}
+
+std::string HRTFProcessor::GetCacheKey() const {
+    // Everything that changes the processed filters: the source files, the rate they are resampled to
+    // and the decomposition
+    std::string key = m_datasetSource + " rate=" + std::to_string(m_sampleRate);
+    key += m_minimumPhase ? " minphase=" + std::to_string(std::clamp(m_minimumPhaseTaps, 16, HRTFData::FILTER_LENGTH))
+                          : " minphase=off";
+    return key;
+}
+
+bool HRTFProcessor::CompileCache(const std::string& path) const {
+    if (!m_hrtfData || m_hrtfData->filters.empty()) {
+        LOG_ERROR("No HRTF dataset loaded to compile");
+        return false;
+    }
+
+    std::string error;
+    if (!m_hrtfData->WriteCache(path, GetCacheKey(), error)) {
+        LOG_ERROR("Failed to write precompiled HRTF dataset {}: {}", path, error);
+        return false;
+    }
+    LOG_INFO("Precompiled HRTF dataset written to {} ({} filters at {} Hz)",
+             path, m_hrtfData->filters.size(), m_hrtfData->sampleRate);
+    return true;
+}
+
+bool HRTFProcessor::IsDatasetMapped() const {
+    return m_hrtfData && m_hrtfData->cache;
+}
+
+bool HRTFProcessor::LoadMITKEMARCompact(const std::string& directory, WorkerPool& pool) {
+    // One stereo file per direction on the right; the left half mirrors it with the ears swapped
+    const auto elevations = ListElevationDirectories(directory);
+    struct Result {
+        std::vector<HRIRMeasurement> measurements;
+        int sampleRate{0};
+        std::string error;
+    };
+    std::vector<Result> results(elevations.size());
+
+    pool.Run(elevations.size(), [&](size_t task) {
+        Result& result = results[task];
+        std::error_code error;
+        for (const auto& entry : std::filesystem::directory_iterator(elevations[task].second, error)) {
+            char prefix = 0;
+            int elevation = 0, azimuth = 0;
+            if (!ParseKEMARName(entry.path().filename().string(), prefix, elevation, azimuth) || prefix != 'H') {
+                continue;
+            }
+
+            hrtf_io::WavData wav;
+            if (!hrtf_io::ReadWav(entry.path().string(), wav, result.error)) {
+                return;
+            }
+            if (wav.channels.size() != 2 || (result.sampleRate != 0 && wav.sampleRate != result.sampleRate)) {
+                result.error = entry.path().string() + ": expected stereo at the rate of the other files";
+                return;
+            }
+            result.sampleRate = wav.sampleRate;
+
+            HRIRMeasurement measurement;
+            measurement.azimuth = static_cast<float>(azimuth);
+            measurement.elevation = static_cast<float>(elevation);
+            measurement.left = wav.channels[0];
+            measurement.right = wav.channels[1];
+            if (azimuth % 180 != 0) {
+                HRIRMeasurement mirrored;
+                mirrored.azimuth = -measurement.azimuth;
+                mirrored.elevation = measurement.elevation;
+                mirrored.left = measurement.right;
+                mirrored.right = measurement.left;
+                result.measurements.push_back(std::move(mirrored));
+            }
+            result.measurements.push_back(std::move(measurement));
+        }
+    });
+
+    std::vector<HRIRMeasurement> measurements;
+    int sampleRate = 0;
+    for (auto& result : results) {
+        if (!result.error.empty()) {
+            LOG_ERROR("MIT KEMAR compact dataset: {}", result.error);
+            return false;
+        }
+        if (result.measurements.empty()) {
+            continue;
+        }
+        if (sampleRate != 0 && result.sampleRate != sampleRate) {
+            LOG_ERROR("MIT KEMAR compact dataset mixes {} Hz and {} Hz files", sampleRate, result.sampleRate);
+            return false;
+        }
+        sampleRate = result.sampleRate;
+        std::move(result.measurements.begin(), result.measurements.end(), std::back_inserter(measurements));
+    }
+
+    LOG_INFO("MIT KEMAR compact: {} directions from {} elevation directories", measurements.size(), elevations.size());
+    return StoreMeasurements(measurements, sampleRate, pool);
+}
+
+bool HRTFProcessor::LoadMITKEMARFiles(const std::string& path, WorkerPool& pool) {
+    // Full set: separate left (L...) and right (R...) ear files around the whole circle
+    const auto elevations = ListElevationDirectories(path);
+    struct Result {
+        std::vector<HRIRMeasurement> measurements;
+        int sampleRate{0};
+        bool failed{false};
+    };
+    std::vector<Result> results(elevations.size());
+
+    pool.Run(elevations.size(), [&](size_t task) {
+        Result& result = results[task];
+        std::error_code error;
+        for (const auto& entry : std::filesystem::directory_iterator(elevations[task].second, error)) {
+            const std::string name = entry.path().filename().string();
+            char prefix = 0;
+            int elevation = 0, azimuth = 0;
+            if (!ParseKEMARName(name, prefix, elevation, azimuth) || prefix != 'L') {
+                continue;
+            }
 
-    // For immediate testing, generate synthetic HRTF that produces spatial differences
-    if (!GenerateHighQualitySyntheticHRTF()) {
-        LOG_ERROR("Failed to generate synthetic HRTF dataset");
+            const auto rightFile = entry.path().parent_path() / ("R" + name.substr(1));
+            HRIRMeasurement measurement;
+            int sampleRate = 0;
+            const float signedAzimuth = static_cast<float>(azimuth > 180 ? azimuth - 360 : azimuth);
+            if (!LoadImpulseResponse(entry.path().string(), rightFile.string(), signedAzimuth,
+                                     static_cast<float>(elevation), measurement, sampleRate) ||
+                (result.sampleRate != 0 && sampleRate != result.sampleRate)) {
+                result.failed = true;
+                return;
+            }
+            result.sampleRate = sampleRate;
+            result.measurements.push_back(std::move(measurement));
+        }
+    });
+
+    std::vector<HRIRMeasurement> measurements;
+    int sampleRate = 0;
+    for (auto& result : results) {
+        if (result.failed || (sampleRate != 0 && result.sampleRate != 0 && result.sampleRate != sampleRate)) {
+            LOG_ERROR("MIT KEMAR dataset in {} could not be decoded", path);
+            return false;
+        }
+        if (!result.measurements.empty()) {
+            sampleRate = result.sampleRate;
+            std::move(result.measurements.begin(), result.measurements.end(), std::back_inserter(measurements));
+        }
+    }
+
+    LOG_INFO("MIT KEMAR: {} directions from {} elevation directories", measurements.size(), elevations.size());
+    return StoreMeasurements(measurements, sampleRate, pool);
+}
+
+bool HRTFProcessor::LoadImpulseResponse(const std::string& leftFile, const std::string& rightFile,
+                                        float azimuth, float elevation, HRIRMeasurement& measurement,
+                                        int& sampleRate) const {
+    hrtf_io::WavData left, right;
+    std::string error;
+    if (!hrtf_io::ReadWav(leftFile, left, error) || !hrtf_io::ReadWav(rightFile, right, error)) {
+        LOG_ERROR("HRIR pair: {}", error);
+        return false;
+    }
+    if (left.sampleRate != right.sampleRate) {
+        LOG_ERROR("HRIR pair {} / {} has mismatched rates", leftFile, rightFile);
+        return false;
+    }
+
+    measurement.azimuth = azimuth;
+    measurement.elevation = elevation;
+    measurement.left = std::move(left.channels[0]);
+    measurement.right = std::move(right.channels[0]);
+    sampleRate = left.sampleRate;
+    return true;
+}
+
+bool HRTFProcessor::LoadSOFAFile(const std::string& filename, WorkerPool& pool) {
+    // HDF5 is not thread-safe, so the file is read in one call; building the measurements fans out
+    hrtf_io::SOFAData sofa;
+    std::string error;
+    if (!hrtf_io::ReadSOFA(filename, sofa, error)) {
+        LOG_ERROR("SOFA dataset: {}", error);
         return false;
     }
 
-    LOG_INFO("HRTF dataset loaded successfully with {} filters", m_hrtfData->filters.size());
+    constexpr size_t BLOCK = 64;
+    std::vector<HRIRMeasurement> measurements(sofa.measurementCount);
+    pool.Run((sofa.measurementCount + BLOCK - 1) / BLOCK, [&](size_t block) {
+        const size_t end = std::min(sofa.measurementCount, (block + 1) * BLOCK);
+        for (size_t m = block * BLOCK; m < end; ++m) {
+            auto& measurement = measurements[m];
+            measurement.azimuth = sofa.directions[m][0];
+            measurement.elevation = sofa.directions[m][1];
+
+            // Data.Delay becomes leading silence; the minimum-phase split measures onsets again anyway
+            for (int ear = 0; ear < 2; ++ear) {
+                auto& response = (ear == 0) ? measurement.left : measurement.right;
+                const size_t delay = static_cast<size_t>(std::max(0L, std::lround(sofa.delays[m][ear])));
+                response.assign(delay, 0.0f);
+                response.insert(response.end(), sofa.Response(m, ear), sofa.Response(m, ear) + sofa.length);
+            }
+        }
+    });
+
+    LOG_INFO("SOFA: {} directions of {} samples at {} Hz from {}",
+             sofa.measurementCount, sofa.length, sofa.sampleRate, filename);
+    return StoreMeasurements(measurements, sofa.sampleRate, pool);
+}
+
+bool HRTFProcessor::StoreMeasurements(std::vector<HRIRMeasurement>& measurements, int sourceRate, WorkerPool& pool) {
+    if (measurements.empty() || sourceRate <= 0) {
+        LOG_ERROR("HRTF dataset has no usable measurements");
+        return false;
+    }
+
+    // One polyphase table for the rate pair, shared by every worker
+    const hrtf_io::ImpulseResponseResampler resampler(sourceRate, m_sampleRate);
+    m_hrtfData->ownedFilters.assign(measurements.size(), HRTFData::Filter());
+    m_hrtfData->ownedPositions.resize(measurements.size());
+    std::atomic<size_t> truncated{0};
+
+    pool.Run(measurements.size(), [&](size_t index) {
+        const auto& measurement = measurements[index];
+        auto& filter = m_hrtfData->ownedFilters[index];
+        m_hrtfData->ownedPositions[index] = {measurement.azimuth, measurement.elevation};
+
+        std::vector<float> resampled;
+        bool cut = false;
+        for (int ear = 0; ear < 2; ++ear) {
+            const auto& source = (ear == 0) ? measurement.left : measurement.right;
+            auto& response = (ear == 0) ? filter.left : filter.right;
+            resampler.Process(source.data(), source.size(), resampled);
+
+            // Longer responses keep their first FILTER_LENGTH taps with a short fade-out
+            const size_t length = std::min(resampled.size(), static_cast<size_t>(HRTFData::FILTER_LENGTH));
+            std::copy(resampled.begin(), resampled.begin() + length, response.begin());
+            if (resampled.size() > length) {
+                constexpr size_t FADE = 32;
+                for (size_t i = 0; i < FADE; ++i) {
+                    response[length - FADE + i] *= 0.5f * (1.0f + std::cos(static_cast<float>(M_PI) * (i + 1) / FADE));
+                }
+                cut = true;
+            }
+        }
+        if (cut) {
+            truncated.fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+
+    if (truncated > 0) {
+        LOG_WARN("{} of {} HRIRs are longer than {} taps and were truncated",
+                 truncated.load(), measurements.size(), HRTFData::FILTER_LENGTH);
+    }
+    m_hrtfData->sampleRate = m_sampleRate;
+    m_hrtfData->filterLength = HRTFData::FILTER_LENGTH;
+    m_hrtfData->AdoptOwned();
+    LOG_INFO("Stored {} measured HRIR pairs, resampled {} Hz -> {} Hz", measurements.size(), sourceRate, m_sampleRate);
     return true;
 }
 
@@ -407,9 +2851,16 @@ bool HRTFProcessor::GenerateHighQualitySyntheticHRTF() {
         return false;
     }
 
+    constexpr double HEAD_RADIUS = 0.0875;    // metres
+    constexpr double SPEED_OF_SOUND = 343.0;  // metres per second
+
     // Generate HRTF filters for each position that create REAL spatial differences
+    // Rendered directly at the device rate, so no resampling is needed
     const int totalFilters = HRTFData::NUM_AZIMUTHS * HRTFData::NUM_ELEVATIONS;
-    m_hrtfData->filters.resize(totalFilters);
+    const double sampleRate = static_cast<double>(m_sampleRate);
+    m_hrtfData->sampleRate = m_sampleRate;
+    m_hrtfData->ownedFilters.assign(totalFilters, HRTFData::Filter());
+    m_hrtfData->ownedPositions.resize(totalFilters);
 
     for (int elev = 0; elev < HRTFData::NUM_ELEVATIONS; ++elev) {
         for (int az = 0; az < HRTFData::NUM_AZIMUTHS; ++az) {
@@ -419,51 +2870,63 @@ bool HRTFProcessor::GenerateHighQualitySyntheticHRTF() {
             float azimuth = (az * 360.0f / HRTFData::NUM_AZIMUTHS) - 180.0f;
             float elevation = (elev * 180.0f / HRTFData::NUM_ELEVATIONS) - 90.0f;
 
-            auto& filter = m_hrtfData->filters[index];
+            auto& filter = m_hrtfData->ownedFilters[index];
+            m_hrtfData->ownedPositions[index] = {azimuth, elevation};
+
+            // Woodworth interaural delay: the far ear hears the source later
+            const double lateral = std::asin(std::sin(azimuth * M_PI / 180.0) * std::cos(elevation * M_PI / 180.0));
+            const double itd = HEAD_RADIUS / SPEED_OF_SOUND * (std::abs(lateral) + std::sin(std::abs(lateral))) * sampleRate;
+            const double leftOnset = (lateral > 0.0) ? itd : 0.0;
+            const double rightOnset = (lateral < 0.0) ? itd : 0.0;
 
             // Generate HRTF that creates REAL spatial differences (not just panning)
             for (int i = 0; i < HRTFData::FILTER_LENGTH; ++i) {
-                if (i < 64) {  // Main impulse response
-                    float delay = i / 48000.0f;  // Sample delay
-
-                    // Left ear: attenuated for right-side sources (positive azimuth)
-                    float leftAttenuation = (azimuth > 0) ? 1.0f - (azimuth / 180.0f) * 0.7f : 1.0f;
-                    filter.left[i] = leftAttenuation * static_cast<float>(std::exp(-delay * 1000.0) * std::sin(delay * 2.0 * M_PI * 1000.0));
-
-                    // Right ear: attenuated for left-side sources (negative azimuth)
-                    float rightAttenuation = (azimuth < 0) ? 1.0f - (-azimuth / 180.0f) * 0.7f : 1.0f;
-                    filter.right[i] = rightAttenuation * static_cast<float>(std::exp(-delay * 1000.0) * std::sin(delay * 2.0 * M_PI * 1000.0));
-
-                    // Apply elevation effects (frequency filtering)
-                    if (elevation > 0) {  // Above
-                        filter.left[i] *= (1.0f + elevation / 90.0f * 0.5f);
-                        filter.right[i] *= (1.0f + elevation / 90.0f * 0.5f);
-                    } else {  // Below
-                        filter.left[i] *= (1.0f - abs(elevation) / 90.0f * 0.3f);
-                        filter.right[i] *= (1.0f - abs(elevation) / 90.0f * 0.3f);
+                // Main impulse response: 64 samples after each ear's onset
+                auto response = [i, sampleRate](double onset) {
+                    const double t = i - onset;
+                    if (t < 0.0 || t >= 64.0) {
+                        return 0.0f;
                     }
-                } else {
-                    // Decay to zero
-                    filter.left[i] = 0.0f;
-                    filter.right[i] = 0.0f;
+                    const double delay = t / sampleRate;
+                    return static_cast<float>(std::exp(-delay * 1000.0) * std::sin(delay * 2.0 * M_PI * 1000.0));
+                };
+
+                // Left ear: attenuated for right-side sources (positive azimuth)
+                float leftAttenuation = (azimuth > 0) ? 1.0f - (azimuth / 180.0f) * 0.7f : 1.0f;
+                filter.left[i] = leftAttenuation * response(leftOnset);
+
+                // Right ear: attenuated for left-side sources (negative azimuth)
+                float rightAttenuation = (azimuth < 0) ? 1.0f - (-azimuth / 180.0f) * 0.7f : 1.0f;
+                filter.right[i] = rightAttenuation * response(rightOnset);
+
+                // Apply elevation effects (frequency filtering)
+                if (elevation > 0) {  // Above
+                    filter.left[i] *= (1.0f + elevation / 90.0f * 0.5f);
+                    filter.right[i] *= (1.0f + elevation / 90.0f * 0.5f);
+                } else {  // Below
+                    filter.left[i] *= (1.0f - abs(elevation) / 90.0f * 0.3f);
+                    filter.right[i] *= (1.0f - abs(elevation) / 90.0f * 0.3f);
                 }
             }
 
-            // Ensure significant left/right differences exist
+            // Ensure significant left/right differences exist (first 32 samples after each onset)
+            const int leftStart = static_cast<int>(std::ceil(leftOnset));
+            const int rightStart = static_cast<int>(std::ceil(rightOnset));
             if (azimuth < -90.0f) {  // Far left
                 for (int i = 0; i < 32; ++i) {
-                    filter.left[i] *= 2.0f;   // Boost left channel
-                    filter.right[i] *= 0.3f; // Attenuate right channel
+                    filter.left[leftStart + i] *= 2.0f;   // Boost left channel
+                    filter.right[rightStart + i] *= 0.3f; // Attenuate right channel
                 }
             } else if (azimuth > 90.0f) {  // Far right
                 for (int i = 0; i < 32; ++i) {
-                    filter.left[i] *= 0.3f;  // Attenuate left channel
-                    filter.right[i] *= 2.0f; // Boost right channel
+                    filter.left[leftStart + i] *= 0.3f;  // Attenuate left channel
+                    filter.right[rightStart + i] *= 2.0f; // Boost right channel
                 }
             }
         }
     }
 
+    m_hrtfData->AdoptOwned();
     LOG_INFO("Generated synthetic HRTF with {} filters for spatial testing", m_hrtfData->filters.size());
     return true;
 }
@@ -8,6 +8,9 @@
 #include <array>
 #include <atomic>
 #include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <cstdint>
 #include <complex>
 #include <filesystem>
 #include <cmath>
@@ -16,13 +19,22 @@
 #include <iomanip>
 #include <algorithm>
 #include <immintrin.h>  // For SIMD
+#include "hrtf_cache.h"
+#include "snapshot_channel.h"
 #include "vr_types.h"
 
 namespace vrb {
 
+class Config;
+class WorkerPool;
+struct HRIRMeasurement;
 
 /**
  * @brief HRTF processor for spatial audio rendering
+ *
+ * Process and ProcessSources run on one audio thread and never block: pose and
+ * source updates from other threads reach it as whole snapshots through
+ * wait-free channels. Initialize and SetMaxBlockSize must not overlap them.
  */
 class HRTFProcessor {
 public:
@@ -30,73 +42,366 @@ public:
     ~HRTFProcessor();
 
     bool Initialize(const std::string& hrtfDataPath);
+    bool Initialize(const Config& config);
     void UpdateSpatialPosition(const VRPose& hmdPose, const std::vector<VRPose>& controllerPoses);
     void SetListenerPosition(const Vec3& position);
     void SetListenerOrientation(const Vec3& orientation);
     void Process(const float* input, float* output, size_t frames, int inputChannels);
+    // Process for planar buffers (one per input channel), rendering into separate left and right
+    // outputs such as a host's port buffers. Inputs must not alias the outputs.
+    void ProcessPlanar(const float* const* inputs, int inputChannels, float* left, float* right, size_t frames);
     void Reset();
 
+    // Process and ProcessSources never allocate: their scratch is sized here for the largest
+    // block (longer blocks are rendered in pieces). Allocates, so call it while the stream is stopped.
+    void SetMaxBlockSize(size_t frames);
+    size_t GetMaxBlockSize() const;
+
+    // Precompiled dataset (hrtf.cachePath): Initialize maps a matching cache file instead of
+    // building the dataset, and writes one after a build. CompileCache writes the loaded dataset.
+    bool CompileCache(const std::string& path) const;
+    bool IsDatasetMapped() const;
+
+    // Independent mono sources, each with its own filter state, rendered into one stereo bus.
+    // Positions are head-relative in metres (same frame as SetListenerPosition).
+    int AddSource(const Vec3& position);   // Source id, or -1 when all hrtf.maxSources slots are taken
+    bool RemoveSource(int sourceId);
+    bool SetSourcePosition(int sourceId, const Vec3& position);
+    bool SetSourceGain(int sourceId, float gain);
+    size_t GetSourceCount() const;
+    size_t GetSourceCapacity() const;
+    // inputs[id] is the mono block of source id (GetSourceCapacity() entries, nullptr skips the
+    // source); output is interleaved stereo and overwritten with the mix of all active sources
+    void ProcessSources(const float* const* inputs, float* output, size_t frames);
+
+    // Automation replay from the thread that runs Process / ProcessSources: written straight into
+    // that thread's state, with no lock and no filter prefetch (a bank miss is queued for the worker).
+    // A later control-side update of the same value replaces it, and the other way round.
+    void AutomateListenerPosition(const Vec3& position);
+    bool AutomateSourcePosition(int sourceId, const Vec3& position);
+    bool AutomateSourceGain(int sourceId, float gain);
+
     struct ProcessingStats {
         float azimuth;
         float elevation;
         float distance;
         int hrtfIndex;
+        uint64_t filterCacheHits;       // Interpolation vertices served from the spectrum bank
+        uint64_t filterCacheMisses;     // Vertices not resident; the blend is transformed on the audio thread
+        size_t filterCacheResident;
+        uint64_t filterSwitches;
+        uint64_t transitionBlocks;      // Blocks that ran the outgoing and incoming filters together
+        uint64_t processedBlocks;
+        int filterLength;               // Taps convolved per ear (truncated when minimum-phase)
     };
     ProcessingStats GetStats() const;
 
 private:
     struct HRTFData {
         static constexpr int FILTER_LENGTH = 512;
-        static constexpr int NUM_AZIMUTHS = 72;
+        static constexpr int NUM_AZIMUTHS = 72;     // Synthetic grid layout
         static constexpr int NUM_ELEVATIONS = 14;
 
-        struct Filter {
-            std::array<float, FILTER_LENGTH> left;
-            std::array<float, FILTER_LENGTH> right;
+        // Taps beyond HRTFData::filterLength are zero. Delays are in samples and only
+        // set for minimum-phase filters, whose onset is stripped by the decomposition.
+        // Records are cache-line aligned, which is also their layout in a cache file
+        struct alignas(64) Filter {
+            std::array<float, FILTER_LENGTH> left{};
+            std::array<float, FILTER_LENGTH> right{};
+            float leftDelay{0.0f};
+            float rightDelay{0.0f};
+        };
+
+        // Measurement direction of a filter in degrees (azimuth +right, elevation +up)
+        struct Position {
+            float azimuth;
+            float elevation;
+        };
+
+        // Read-only array over either owned storage or a mapped cache file
+        template<typename T>
+        class Table {
+        public:
+            Table() = default;
+            Table(const T* data, size_t count) : m_data(count ? data : nullptr), m_count(count) {}
+            size_t size() const { return m_count; }
+            bool empty() const { return m_count == 0; }
+            const T* data() const { return m_data; }
+            const T& operator[](size_t i) const { return m_data[i]; }
+            const T* begin() const { return m_data; }
+            const T* end() const { return m_data + m_count; }
+
+        private:
+            const T* m_data{nullptr};
+            size_t m_count{0};
+        };
+
+        // Filters enclosing a direction and their barycentric weights (summing to 1)
+        struct Interpolation {
+            std::array<int, 3> indices{{-1, -1, -1}};
+            std::array<float, 3> weights{{0.0f, 0.0f, 0.0f}};
         };
 
-        std::vector<Filter> filters;
+        /**
+         * @brief Triangulation of the measurement sphere with a direction lookup table
+         *
+         * Built once at load as the convex hull of the measurement directions,
+         * which is their spherical Delaunay triangulation, so any grid works. A
+         * 1-degree (azimuth, elevation) table maps each direction to its
+         * enclosing triangle, and per-triangle inverse bases turn the direction
+         * into barycentric weights in constant time.
+         */
+        class Triangulation {
+        public:
+            static constexpr int LUT_AZIMUTHS = 360;
+            static constexpr int LUT_ELEVATIONS = 181;
+
+            bool Build(Table<Position> positions);
+            // Uses tables built elsewhere (a cache file) in place after checking their indices
+            bool Attach(Table<std::array<int, 3>> triangles, Table<std::array<float, 9>> inverseBases,
+                        Table<int> lookup, size_t filterCount);
+            bool IsValid() const { return !m_triangles.empty(); }
+            size_t GetTriangleCount() const { return m_triangles.size(); }
+            Interpolation Locate(float azimuth, float elevation) const;
+
+            Table<std::array<int, 3>> GetTriangles() const { return m_triangles; }
+            Table<std::array<float, 9>> GetInverseBases() const { return m_inverseBases; }
+            Table<int> GetLookup() const { return m_lookup; }
+
+        private:
+            int FindTriangle(const std::array<float, 3>& direction, int hint) const;
+            float MinimumWeight(int triangle, const std::array<float, 3>& direction) const;
+
+            std::vector<std::array<int, 3>> m_ownedTriangles;
+            std::vector<std::array<float, 9>> m_ownedInverseBases;
+            std::vector<int> m_ownedLookup;
+            Table<std::array<int, 3>> m_triangles;      // Filter indices
+            Table<std::array<float, 9>> m_inverseBases;
+            Table<int> m_lookup;                        // LUT_ELEVATIONS x LUT_AZIMUTHS
+        };
+
+        // Rendering reads filters and positions through these tables; they point into
+        // the owned vectors while a dataset is built and into the mapping when loaded
+        // from a cache file
+        Table<Filter> filters;
+        Table<Position> positions;
+        std::vector<Filter> ownedFilters;
+        std::vector<Position> ownedPositions;
+        std::unique_ptr<HRTFCacheFile> cache;
+        Triangulation triangulation;
+        int sampleRate{48000};              // Rate the filters are sampled at
+        int filterLength{FILTER_LENGTH};    // Taps in use per ear
+        float maxDelay{0.0f};               // Largest ear delay; 0 when filters keep their onset
+
+        void AdoptOwned() {
+            filters = Table<Filter>(ownedFilters.data(), ownedFilters.size());
+            positions = Table<Position>(ownedPositions.data(), ownedPositions.size());
+        }
+        bool DecomposeMinimumPhase(int taps, WorkerPool* pool = nullptr);
+        bool AttachCache(std::unique_ptr<HRTFCacheFile> file);
+        bool WriteCache(const std::string& path, const std::string& key, std::string& error) const;
+
         const Filter& GetFilter(float azimuth, float elevation) const;
         int GetFilterIndex(float azimuth, float elevation) const;
+        Interpolation Interpolate(float azimuth, float elevation) const;
+    };
+
+    // Partition spectra of one HRIR pair, laid out partition-major
+    struct FilterSpectrum {
+        std::vector<std::complex<float>> left;
+        std::vector<std::complex<float>> right;
     };
 
+    /**
+     * @brief Binaural convolution of a mono signal with a left/right HRIR pair
+     *
+     * The FFT path is a zero-latency, uniformly-partitioned overlap-save
+     * convolver: the filter is split into partitions of fftSize/2 taps, the
+     * head partition is applied to the partially filled current block on
+     * every call, and the remaining partitions are accumulated once per block
+     * from a frequency-domain delay line. The input spectrum is computed once
+     * per call and shared between both ears.
+     *
+     * On a filter switch the outgoing filter keeps rendering from the same
+     * input for crossfadeSamples samples and is then dropped, so the dual
+     * convolution cost is paid only inside the transition window.
+     *
+     * With maxDelay > 0 the filters are minimum-phase and each ear's output
+     * passes through a fractional delay line (third-order Lagrange) that
+     * restores the filter's leftDelay/rightDelay. The delay glides to the new
+     * value over the crossfade window rather than jumping.
+     */
     class ConvolutionEngine {
     public:
-        ConvolutionEngine(int filterLength);
+        ConvolutionEngine(int filterLength, int fftSize = 1024, bool useFFT = true, int crossfadeSamples = 0,
+                          float maxDelay = 0.0f);
         ~ConvolutionEngine();
+        // spectrum, when given, must hold the precomputed partitions of filter
         void Process(const float* input, float* outputLeft, float* outputRight,
-                    size_t frames, const HRTFData::Filter& filter);
+                    size_t frames, const HRTFData::Filter& filter,
+                    const FilterSpectrum* spectrum = nullptr);
+        void ComputeFilterSpectrum(const HRTFData::Filter& filter, FilterSpectrum& spectrum);
         void Reset();
 
+        bool IsFFTEnabled() const { return m_useFFT; }
+        int GetFFTSize() const { return m_fftSize; }
+        int GetPartitionCount() const { return m_numPartitions; }
+        bool IsCrossfading() const { return m_crossfading; }
+        uint64_t GetFilterSwitches() const { return m_filterSwitches.load(std::memory_order_relaxed); }
+        uint64_t GetTransitionBlocks() const { return m_transitionBlocks.load(std::memory_order_relaxed); }
+        uint64_t GetProcessedBlocks() const { return m_processedBlocks.load(std::memory_order_relaxed); }
+
+        static constexpr int MAX_CROSSFADE_SAMPLES = 4096;
+        static constexpr int DELAY_CHUNK = 256;  // Samples per delay line pass
+
     private:
         int m_filterLength;
         std::vector<float> m_historyBuffer;
         int m_historyIndex;
         int m_fftSize;
-        std::vector<std::complex<float>> m_filterFFTLeft;
+        bool m_useFFT;
+        int m_blockSize{0};       // Partition length, fftSize / 2
+        int m_numPartitions{0};
+        int m_numBins{0};         // fftSize / 2 + 1 (real spectrum)
+        std::vector<std::complex<float>> m_filterFFTLeft;   // 2 * m_numPartitions * m_numBins
         std::vector<std::complex<float>> m_filterFFTRight;
-        std::vector<std::complex<float>> m_signalFFT;
+        size_t m_ownSpectrumHalf{0};
+        const std::complex<float>* m_activeFilterLeft{nullptr};  // Own spectra or a filter bank slot
+        const std::complex<float>* m_activeFilterRight{nullptr};
+        std::vector<std::complex<float>> m_signalFFT;       // Spectrum of the current input window
         std::vector<std::complex<float>> m_outputFFT;
-        std::vector<std::complex<float>> m_twiddleFactors;
-        std::vector<float> m_overlapBuffer;
+        std::vector<std::complex<float>> m_twiddleFactors;  // exp(-2*pi*i*k/fftSize), k < fftSize/2
+        std::vector<float> m_overlapBuffer;                 // [previous block | current block]
+        std::vector<std::complex<float>> m_spectrumHistory; // Frequency-domain delay line
+        int m_spectrumHistoryIndex{0};
+        std::vector<std::complex<float>> m_tailFFTLeft;     // Contribution of partitions 1..K-1
+        std::vector<std::complex<float>> m_tailFFTRight;
+        std::vector<std::complex<float>> m_previousTailFFTLeft;  // Outgoing filter's tail during a crossfade
+        std::vector<std::complex<float>> m_previousTailFFTRight;
+        std::vector<std::complex<float>> m_fftWorkspace;
+        std::vector<float> m_timeScratch;
+        std::vector<int> m_bitReverse;
         const HRTFData::Filter* m_cachedFilter{nullptr};
         bool m_filterCached{false};
 
+        // Filter transition state
+        int m_crossfadeLength;
+        int m_crossfadePosition{0};
+        bool m_crossfading{false};
+        const HRTFData::Filter* m_previousFilter{nullptr};
+        const std::complex<float>* m_previousFilterLeft{nullptr};
+        const std::complex<float>* m_previousFilterRight{nullptr};
+        std::atomic<uint64_t> m_filterSwitches{0};
+        std::atomic<uint64_t> m_transitionBlocks{0};
+        std::atomic<uint64_t> m_processedBlocks{0};
+
+        // Interaural delay lines: [history | chunk] per ear, history covers the largest delay
+        int m_delayHistory{0};
+        std::array<std::vector<float>, 2> m_delayLines;
+        std::array<float, 2> m_delayStart{{0.0f, 0.0f}};
+        std::array<float, 2> m_delayTarget{{0.0f, 0.0f}};
+        int m_delayRampPosition{0};
+        int m_delayRampLength{0};
+
         void InitializeFFT();
         void CleanupFFT();
         void ProcessFFT(const float* input, float* outputLeft, float* outputRight,
-                       size_t frames, const HRTFData::Filter& filter);
+                       size_t frames, const HRTFData::Filter& filter, const FilterSpectrum* spectrum);
         void ProcessTimeDomain(const float* input, float* outputLeft, float* outputRight,
                               size_t frames, const HRTFData::Filter& filter);
-        void ComputeFilterFFT(const HRTFData::Filter& filter);
+        void ConvolveTimeDomain(const float* input, float* outputLeft, float* outputRight,
+                               size_t frames, const HRTFData::Filter& filter);
+        void ComputeFilterFFT(const HRTFData::Filter& filter,
+                             std::complex<float>* spectrumLeft, std::complex<float>* spectrumRight);
+        void UpdateTailSpectrum();
+        void AccumulateTail(const std::complex<float>* filterLeft, const std::complex<float>* filterRight,
+                           std::vector<std::complex<float>>& tailLeft, std::vector<std::complex<float>>& tailRight);
+        void RenderEar(const std::complex<float>* filterFFT, const std::vector<std::complex<float>>& tailFFT);
+        void RetargetDelay(const HRTFData::Filter& filter, bool immediate);
+        void ApplyDelay(float* outputLeft, float* outputRight, size_t frames);
+        void BeginCrossfade();
+        size_t ApplyCrossfade(float* output, const float* outgoing, size_t count) const;
+        void AdvanceCrossfade(size_t count);
         void PerformRealFFT(const float* input, std::complex<float>* output, int size);
         void PerformRealIFFT(const std::complex<float>* input, float* output, int size);
         void FFTRadix2(const std::complex<float>* input, std::complex<float>* output, int size);
         void IFFTRadix2(const std::complex<float>* input, std::complex<float>* output, int size);
+        void Butterflies(std::complex<float>* data, int size, bool inverse);
         void ComplexMultiply(const std::complex<float>* a, const std::complex<float>* b,
                             std::complex<float>* result, int size);
+        void ComplexMultiplyAccumulate(const std::complex<float>* a, const std::complex<float>* b,
+                                      std::complex<float>* accumulator, int size);
     };
 
+    /**
+     * @brief LRU-bounded bank of precomputed filter spectra per HRTF position
+     *
+     * Spectra are transformed on a background worker, either on demand after an
+     * audio-thread miss or ahead of time for the cells the head is turning
+     * towards. Acquire/Release are wait-free and never transform or allocate;
+     * a pinned slot is never evicted.
+     */
+    class FilterBank {
+    public:
+        FilterBank(const HRTFData& data, int filterLength, int fftSize, size_t capacity);
+        ~FilterBank();
+
+        int Acquire(int filterIndex);  // Slot index, or -1 on a miss (queued for the worker)
+        const FilterSpectrum& GetSpectrum(int slot) const { return m_slots[slot].spectrum; }
+        void Release(int slot);
+        void Prefetch(float azimuth, float elevation, const Vec3& angularVelocity);
+
+        struct Stats {
+            uint64_t hits;
+            uint64_t misses;
+            uint64_t populated;
+            uint64_t evictions;
+            size_t resident;
+            size_t capacity;
+        };
+        Stats GetStats() const;
+
+    private:
+        struct Slot {
+            FilterSpectrum spectrum;
+            std::atomic<int> filterIndex{-1};
+            std::atomic<int> pins{0};
+            std::atomic<uint64_t> lastUse{0};
+        };
+
+        static constexpr uint8_t REQUEST_NONE = 0;
+        static constexpr uint8_t REQUEST_PREFETCH = 1;
+        static constexpr uint8_t REQUEST_DEMAND = 2;
+        static constexpr int PREFETCH_STEPS = 4;
+        static constexpr float PREFETCH_STEP_SECONDS = 0.05f;
+        static constexpr float PREFETCH_PROBE_DEGREES = 5.0f;
+
+        void WorkerLoop();
+        bool Populate(int filterIndex);
+        int SelectSlot() const;
+        void RequestFilter(int filterIndex, uint8_t priority);
+        void RequestDirection(float azimuth, float elevation);
+
+        const HRTFData& m_data;
+        ConvolutionEngine m_transform;  // Worker-thread FFT scratch
+        std::vector<Slot> m_slots;
+        std::vector<std::atomic<int>> m_slotForFilter;
+        std::vector<std::atomic<uint8_t>> m_requests;
+
+        std::atomic<uint64_t> m_clock{0};
+        std::atomic<uint64_t> m_hits{0};
+        std::atomic<uint64_t> m_misses{0};
+        std::atomic<uint64_t> m_populated{0};
+        std::atomic<uint64_t> m_evictions{0};
+        std::atomic<size_t> m_resident{0};
+
+        std::thread m_worker;
+        std::mutex m_workerMutex;
+        std::condition_variable m_workerCondition;
+        std::atomic<bool> m_running{false};
+    };
+
+    // Audio-thread only; targets arrive through m_spatialChannel
     class InterpolationEngine {
     public:
         InterpolationEngine();
@@ -104,39 +409,170 @@ private:
         void GetSmoothedValues(float& azimuth, float& elevation, float& distance);
 
     private:
-        std::atomic<float> m_targetAzimuth{0.0f};
-        std::atomic<float> m_targetElevation{0.0f};
-        std::atomic<float> m_targetDistance{1.0f};
+        float m_targetAzimuth{0.0f};
+        float m_targetElevation{0.0f};
+        float m_targetDistance{1.0f};
         float m_currentAzimuth{0.0f};
         float m_currentElevation{0.0f};
         float m_currentDistance{1.0f};
         static constexpr float SMOOTHING_FACTOR = 0.01f;
     };
 
+    // Blended filter a convolver runs; double-buffered so the outgoing one survives its crossfade
+    struct InterpolatedFilter {
+        HRTFData::Filter filter;
+        FilterSpectrum spectrum;
+        bool hasSpectrum{false};
+    };
+
+    // Convolution state of one rendered source
+    struct SourceRenderer {
+        std::unique_ptr<ConvolutionEngine> convolution;
+        std::array<InterpolatedFilter, 2> interpolatedFilters;
+        int activeInterpolated{-1};
+        HRTFData::Interpolation activeInterpolation;
+    };
+
+    // Listener direction published by UpdateSpatialPosition / SetListenerPosition
+    struct SpatialState {
+        float azimuth{0.0f};
+        float elevation{0.0f};
+        float distance{1.0f};
+        int filterIndex{0};
+    };
+
+    // Control-thread view of the source slots, published whole to the audio thread
+    struct SourceTargets {
+        std::vector<float> x, y, z;                 // Requested head-relative position
+        std::vector<float> gain;                    // SetSourceGain
+        std::vector<uint32_t> positionRevision;     // Bumped per slot by each control-side change, so
+        std::vector<uint32_t> gainRevision;         // the audio thread keeps automated values otherwise
+        std::vector<SourceRenderer*> renderers;     // nullptr marks a free slot
+        uint64_t sequence{0};                       // Publication number
+
+        void Resize(size_t capacity);
+    };
+
+    /**
+     * @brief Structure-of-arrays state of the sources added with AddSource
+     *
+     * Audio-thread only. Each per-block quantity is a parallel array indexed by
+     * source id, so the smoothing, angle and gain passes in ProcessSources are
+     * straight loops over every slot that the compiler vectorizes; inactive
+     * slots are computed and masked rather than branched around. Only the
+     * convolution itself runs per source.
+     */
+    struct SourceTable {
+        std::vector<float> targetX, targetY, targetZ;   // Latest SourceTargets or automation position
+        std::vector<float> x, y, z;                     // Smoothed position
+        std::vector<float> azimuth, elevation, distance;
+        std::vector<float> gain;
+        std::vector<float> startGain, endGain;          // Gain ramp across the current block
+        std::vector<uint8_t> active;
+        std::vector<uint32_t> positionRevision;         // SourceTargets revisions applied
+        std::vector<uint32_t> gainRevision;
+        std::vector<SourceRenderer*> renderers;         // Owned by m_sourceRenderers
+
+        void Resize(size_t capacity);
+        size_t Capacity() const { return active.size(); }
+    };
+
+    // A removed source's convolver, freed once the audio thread has seen a table without it
+    struct RetiredRenderer {
+        uint64_t sequence;
+        std::unique_ptr<SourceRenderer> renderer;
+    };
+
+    /**
+     * @brief Preallocated scratch for the audio path
+     *
+     * One buffer carved into fixed spans at Initialize / SetMaxBlockSize, so
+     * Process and ProcessSources render from it without touching the heap.
+     */
+    struct ScratchArena {
+        std::vector<float> storage;
+        size_t blockSize{0};
+        float* mono{nullptr};       // Stereo input downmix
+        float* left{nullptr};       // One source's convolution output
+        float* right{nullptr};
+        float* busLeft{nullptr};    // Mix of all sources
+        float* busRight{nullptr};
+
+        void Resize(size_t frames);
+    };
+
+    static constexpr size_t DEFAULT_MAX_BLOCK = 1024;           // Scratch length until SetMaxBlockSize
+    static constexpr float SOURCE_SMOOTHING_SAMPLES = 480.0f;   // Position time constant (10 ms at 48 kHz)
+
     bool LoadHRTFDataset(const std::string& path);
-    bool LoadSOFAFile(const std::string& filename);
-    bool LoadMITKEMARCompact(const std::string& filename);
-    bool LoadMITKEMARFiles(const std::string& path);
+    bool LoadCachedDataset();
+    std::string GetCacheKey() const;
+    // Measured datasets decode on the pool (one task per elevation directory or SOFA
+    // measurement block) and are resampled once to m_sampleRate by StoreMeasurements
+    bool LoadSOFAFile(const std::string& filename, WorkerPool& pool);
+    bool LoadMITKEMARCompact(const std::string& directory, WorkerPool& pool);
+    bool LoadMITKEMARFiles(const std::string& path, WorkerPool& pool);
     bool LoadImpulseResponse(const std::string& leftFile, const std::string& rightFile,
-                             float azimuth, float elevation);
+                             float azimuth, float elevation, HRIRMeasurement& measurement, int& sampleRate) const;
+    bool StoreMeasurements(std::vector<HRIRMeasurement>& measurements, int sourceRate, WorkerPool& pool);
     bool GenerateHighQualitySyntheticHRTF();
 
     void CalculateAngles(const VRPose& headPose, const VRPose& micPose,
                         float& azimuth, float& elevation, float& distance);
     void ApplyDistanceAttenuation(float* buffer, size_t frames, float distance);
+    const HRTFData::Filter& SelectFilter(SourceRenderer& source, float azimuth, float elevation,
+                                         const FilterSpectrum*& spectrum);
+    const HRTFData::Filter& PreparePrimary(const FilterSpectrum*& spectrum, float& attenuation);
+    void BlendFilter(SourceRenderer& source, const HRTFData::Interpolation& interpolation, int target);
+    std::unique_ptr<SourceRenderer> CreateSourceRenderer() const;
+    void AllocateBlendTargets(SourceRenderer& source) const;
+    void PublishSpatialState(const SpatialState& state);
+    void PublishSources();
+    void ReclaimRenderers();
+    bool IsSourceSlot(int sourceId) const;
+    void ApplySourceTargets(const SourceTargets& targets);
+    void UpdateSourceAngles(float smoothing);
+    void RenderSources(const float* const* inputs, size_t offset, size_t frames);
 
     std::unique_ptr<HRTFData> m_hrtfData;
-    std::unique_ptr<ConvolutionEngine> m_convolution;
+    std::unique_ptr<FilterBank> m_filterBank;
     std::unique_ptr<InterpolationEngine> m_interpolation;
+    std::unique_ptr<SourceRenderer> m_primarySource;   // Process() / UpdateSpatialPosition source
+    static constexpr float INTERPOLATION_EPSILON = 1e-3f;  // Weight change that triggers a re-blend
 
-    mutable std::mutex m_processingMutex;
-    std::atomic<bool> m_initialized{false};
+    ScratchArena m_scratch;
+    size_t m_maxBlockSize{DEFAULT_MAX_BLOCK};
 
-    std::atomic<float> m_currentAzimuth{0.0f};
-    std::atomic<float> m_currentElevation{0.0f};
-    std::atomic<float> m_currentDistance{1.0f};
-    std::atomic<int> m_currentFilterIndex{0};
+    // Audio thread side of the handoff
+    SourceTable m_sources;
+    SnapshotChannel<SpatialState> m_spatialChannel;
+    SnapshotChannel<SourceTargets> m_sourceChannel;
+    mutable SnapshotChannel<SpatialState> m_automatedSpatialChannel;   // Automated listener pose back to GetStats (read under m_controlMutex)
+    std::atomic<uint64_t> m_consumedSourceSequence{0};   // Last SourceTargets the audio thread applied
+
+    // Control side, guarded by m_controlMutex (serializes writers; never taken on the audio thread)
+    mutable std::mutex m_controlMutex;
+    mutable SpatialState m_spatialState;   // GetStats folds in automated poses
+    SourceTargets m_sourceTargets;
+    std::vector<std::unique_ptr<SourceRenderer>> m_sourceRenderers;
+    std::vector<RetiredRenderer> m_retiredRenderers;
+    size_t m_sourceCount{0};
+    uint64_t m_sourceSequence{0};
+
+    std::atomic<bool> m_initialized{false};
 
+    // Convolution settings (hrtf.convolutionMethod / hrtf.fftSize)
+    std::string m_convolutionMethod{"auto"};
+    int m_fftSize{1024};
+    size_t m_filterCacheSize{256};  // hrtf.filterCacheSize, 0 disables the filter bank
+    int m_crossfadeSamples{64};     // processing.crossfade_samples from the dataset config
+    bool m_interpolationEnabled{true};  // hrtf.interpolation, false selects the nearest filter
+    bool m_minimumPhase{true};          // hrtf.minimumPhase / hrtf.minimumPhaseTaps
+    int m_minimumPhaseTaps{128};
+    size_t m_maxSources{32};            // hrtf.maxSources
+    int m_sampleRate{48000};            // audio.sampleRate, the rate the dataset is prepared for
+    std::string m_cachePath;            // hrtf.cachePath, empty disables the precompiled dataset
+    std::string m_datasetSource;        // Identity of the loaded dataset, part of the cache key
 };
 
 } // namespace vrb
\ No newline at end of file
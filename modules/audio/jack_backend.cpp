@@ -0,0 +1,262 @@
+// jack_backend.cpp - Native JACK client for the audio engine
+
+#include "jack_backend.h"
+#include "logger.h"
+
+#include <algorithm>
+#include <cerrno>
+
+#if VRB_HAVE_JACK
+#include <jack/jack.h>
+#endif
+
+namespace vrb {
+
+JackBackend::~JackBackend() {
+    Close();
+}
+
+bool JackBackend::IsAvailable() {
+#if VRB_HAVE_JACK
+    return true;
+#else
+    return false;
+#endif
+}
+
+#if VRB_HAVE_JACK
+
+namespace {
+
+const char* const OUTPUT_PORTS[2] = {"binaural_L", "binaural_R"};
+
+} // anonymous namespace
+
+bool JackBackend::Open(const JackBackendOptions& options, ProcessCallback callback, void* user, std::string& error) {
+    if (m_client) {
+        error = "JACK client already open as " + m_clientName;
+        return false;
+    }
+    if (!callback || options.inputChannels < 1 || options.inputChannels > MAX_INPUTS) {
+        error = "JACK backend needs a callback and 1 or 2 input channels";
+        return false;
+    }
+
+    // Client names are limited by the server; a too-long one is refused outright
+    std::string name = options.clientName.empty() ? "VR Binaural Output" : options.clientName;
+    name.resize(std::min<size_t>(name.size(), static_cast<size_t>(jack_client_name_size() - 1)));
+
+    jack_status_t status{};
+    m_client = jack_client_open(name.c_str(), JackNoStartServer, &status);
+    if (!m_client) {
+        error = (status & JackServerFailed) ? "no JACK server running"
+                                            : "cannot open JACK client (status " + std::to_string(status) + ")";
+        return false;
+    }
+
+    m_options = options;
+    m_clientName = jack_get_client_name(m_client);
+    m_inputChannels = options.inputChannels;
+    m_callback = callback;
+    m_user = user;
+    m_sampleRate = static_cast<int>(jack_get_sample_rate(m_client));
+    m_bufferSize.store(jack_get_buffer_size(m_client), std::memory_order_relaxed);
+    m_xruns.store(0);
+    m_serverLost.store(false);
+
+    for (int ch = 0; ch < m_inputChannels; ++ch) {
+        const std::string port = "in_" + std::to_string(ch + 1);
+        m_inputs[ch] = jack_port_register(m_client, port.c_str(), JACK_DEFAULT_AUDIO_TYPE, JackPortIsInput, 0);
+    }
+    for (int ear = 0; ear < 2; ++ear) {
+        m_outputs[ear] = jack_port_register(m_client, OUTPUT_PORTS[ear], JACK_DEFAULT_AUDIO_TYPE,
+                                            JackPortIsOutput | JackPortIsTerminal, 0);
+    }
+    const bool portsOk = std::all_of(m_inputs, m_inputs + m_inputChannels, [](jack_port_t* p) { return p != nullptr; }) &&
+                         m_outputs[0] && m_outputs[1];
+
+    if (!portsOk || jack_set_process_callback(m_client, &JackBackend::ProcessThunk, this) != 0 ||
+        jack_set_buffer_size_callback(m_client, &JackBackend::BufferSizeThunk, this) != 0 ||
+        jack_set_xrun_callback(m_client, &JackBackend::XrunThunk, this) != 0) {
+        error = "cannot register the JACK ports and callbacks of " + m_clientName;
+        Close();
+        return false;
+    }
+    jack_on_shutdown(m_client, &JackBackend::ShutdownThunk, this);
+
+    LOG_INFO("JACK client '{}': {}Hz, {} frames per period, {} input port(s)", m_clientName, m_sampleRate,
+             m_bufferSize.load(), m_inputChannels);
+    return true;
+}
+
+void JackBackend::Close() {
+    if (!m_client) {
+        return;
+    }
+    Deactivate();
+    if (!m_serverLost.load()) {
+        jack_client_close(m_client);
+    }
+    m_client = nullptr;
+    std::fill(m_inputs, m_inputs + MAX_INPUTS, nullptr);
+    m_outputs[0] = m_outputs[1] = nullptr;
+    m_inputChannels = 0;
+}
+
+bool JackBackend::Activate(std::string& error) {
+    if (!m_client) {
+        error = "JACK client not open";
+        return false;
+    }
+    if (m_active.load()) {
+        return true;
+    }
+    if (jack_activate(m_client) != 0) {
+        error = "cannot activate JACK client " + m_clientName;
+        return false;
+    }
+    m_active.store(true, std::memory_order_release);
+
+    // Connections can only be made once the client is active
+    if (m_options.connectInputs) {
+        ConnectPhysical(true);
+    }
+    if (m_options.connectOutputs) {
+        ConnectPhysical(false);
+    }
+    return true;
+}
+
+void JackBackend::Deactivate() {
+    if (!m_client || !m_active.exchange(false)) {
+        return;
+    }
+    // Returns once the process callback has finished its last period
+    if (!m_serverLost.load()) {
+        jack_deactivate(m_client);
+    }
+}
+
+void JackBackend::ConnectPhysical(bool capture) {
+    // Physical capture ports are outputs from JACK's point of view, playback ports inputs
+    const char** ports = jack_get_ports(m_client, nullptr, JACK_DEFAULT_AUDIO_TYPE,
+                                        JackPortIsPhysical | (capture ? JackPortIsOutput : JackPortIsInput));
+    if (!ports) {
+        LOG_WARN("JACK: no physical {} ports to connect", capture ? "capture" : "playback");
+        return;
+    }
+
+    const int count = capture ? m_inputChannels : 2;
+    for (int i = 0; i < count && ports[i]; ++i) {
+        jack_port_t* own = capture ? m_inputs[i] : m_outputs[i];
+        const int result = capture ? jack_connect(m_client, ports[i], jack_port_name(own))
+                                   : jack_connect(m_client, jack_port_name(own), ports[i]);
+        if (result != 0 && result != EEXIST) {
+            LOG_WARN("JACK: cannot connect {} {}", jack_port_name(own), ports[i]);
+        }
+    }
+    jack_free(ports);
+}
+
+std::vector<std::string> JackBackend::GetOutputPorts() const {
+    std::vector<std::string> names;
+    for (jack_port_t* port : m_outputs) {
+        if (port) {
+            names.emplace_back(jack_port_name(port));
+        }
+    }
+    return names;
+}
+
+double JackBackend::GetInputLatency() const {
+    if (!m_client || !m_inputs[0] || m_sampleRate <= 0) {
+        return 0.0;
+    }
+    jack_latency_range_t range{};
+    jack_port_get_latency_range(m_inputs[0], JackCaptureLatency, &range);
+    return static_cast<double>(range.max) / m_sampleRate;
+}
+
+double JackBackend::GetOutputLatency() const {
+    if (!m_client || !m_outputs[0] || m_sampleRate <= 0) {
+        return 0.0;
+    }
+    jack_latency_range_t range{};
+    jack_port_get_latency_range(m_outputs[0], JackPlaybackLatency, &range);
+    return static_cast<double>(range.max) / m_sampleRate;
+}
+
+int JackBackend::ProcessThunk(uint32_t frames, void* arg) {
+    auto* backend = static_cast<JackBackend*>(arg);
+    const float* inputs[MAX_INPUTS] = {nullptr, nullptr};
+    for (int ch = 0; ch < backend->m_inputChannels; ++ch) {
+        inputs[ch] = static_cast<const float*>(jack_port_get_buffer(backend->m_inputs[ch], frames));
+    }
+    auto* left = static_cast<float*>(jack_port_get_buffer(backend->m_outputs[0], frames));
+    auto* right = static_cast<float*>(jack_port_get_buffer(backend->m_outputs[1], frames));
+    backend->m_callback(inputs, left, right, frames, backend->m_user);
+    return 0;
+}
+
+int JackBackend::BufferSizeThunk(uint32_t frames, void* arg) {
+    static_cast<JackBackend*>(arg)->m_bufferSize.store(frames, std::memory_order_relaxed);
+    return 0;
+}
+
+int JackBackend::XrunThunk(void* arg) {
+    static_cast<JackBackend*>(arg)->m_xruns.fetch_add(1, std::memory_order_relaxed);
+    return 0;
+}
+
+void JackBackend::ShutdownThunk(void* arg) {
+    // The server is gone and the client with it; nothing may be called on it any more
+    auto* backend = static_cast<JackBackend*>(arg);
+    backend->m_serverLost.store(true, std::memory_order_release);
+    backend->m_active.store(false, std::memory_order_release);
+}
+
+#else
+
+bool JackBackend::Open(const JackBackendOptions&, ProcessCallback, void*, std::string& error) {
+    error = "built without JACK support";
+    return false;
+}
+
+void JackBackend::Close() {}
+
+bool JackBackend::Activate(std::string& error) {
+    error = "built without JACK support";
+    return false;
+}
+
+void JackBackend::Deactivate() {}
+
+std::vector<std::string> JackBackend::GetOutputPorts() const {
+    return {};
+}
+
+double JackBackend::GetInputLatency() const {
+    return 0.0;
+}
+
+double JackBackend::GetOutputLatency() const {
+    return 0.0;
+}
+
+int JackBackend::ProcessThunk(uint32_t, void*) {
+    return 0;
+}
+
+int JackBackend::BufferSizeThunk(uint32_t, void*) {
+    return 0;
+}
+
+int JackBackend::XrunThunk(void*) {
+    return 0;
+}
+
+void JackBackend::ShutdownThunk(void*) {}
+
+#endif
+
+} // namespace vrb
@@ -0,0 +1,97 @@
+// jack_backend.h - Native JACK client for the audio engine
+// The process callback receives JACK's own port buffers: no interleaving, format conversion or ring hop
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Opaque JACK handles, as declared by <jack/types.h>
+typedef struct _jack_client jack_client_t;
+typedef struct _jack_port jack_port_t;
+
+namespace vrb {
+
+struct JackBackendOptions {
+    std::string clientName{"VR Binaural Output"};
+    int inputChannels{1};                   // Mono or stereo capture ports, "in_1", "in_2"
+    bool connectInputs{true};               // Connect the physical capture ports on Activate
+    bool connectOutputs{false};             // Connect "binaural_L"/"binaural_R" to the physical playback ports
+};
+
+/**
+ * @brief A JACK client with capture ports in and a binaural stereo pair out
+ *
+ * The output ports are the recorder's virtual device: any JACK (or
+ * PipeWire-JACK) application can connect to them. Open registers the client
+ * and its ports without starting a server, so it fails quickly where none
+ * is running. The callback runs on JACK's real-time thread once per period
+ * and writes straight into the output port buffers.
+ *
+ * Without VRB_HAVE_JACK every Open fails, so callers need no build checks.
+ */
+class JackBackend {
+public:
+    static constexpr int MAX_INPUTS = 2;
+
+    // inputs holds inputChannels planar buffers; left and right are the output ports
+    using ProcessCallback = void (*)(const float* const* inputs, float* left, float* right, size_t frames, void* user);
+
+    JackBackend() = default;
+    ~JackBackend();
+
+    JackBackend(const JackBackend&) = delete;
+    JackBackend& operator=(const JackBackend&) = delete;
+
+    static bool IsAvailable();              // Built with JACK support
+
+    bool Open(const JackBackendOptions& options, ProcessCallback callback, void* user, std::string& error);
+    void Close();
+    bool IsOpen() const { return m_client != nullptr; }
+
+    // Starts the process callback and makes the configured connections
+    bool Activate(std::string& error);
+    void Deactivate();
+    bool IsActive() const { return m_active.load(std::memory_order_acquire); }
+
+    int GetSampleRate() const { return m_sampleRate; }
+    size_t GetBufferSize() const { return m_bufferSize.load(std::memory_order_relaxed); }
+    int GetInputChannels() const { return m_inputChannels; }
+    const std::string& GetClientName() const { return m_clientName; }   // As granted; JACK may rename duplicates
+    std::vector<std::string> GetOutputPorts() const;                   // Full names, "client:binaural_L"
+
+    // Seconds between the physical capture and the client, and the client and the physical playback
+    double GetInputLatency() const;
+    double GetOutputLatency() const;
+
+    uint64_t GetXruns() const { return m_xruns.load(std::memory_order_relaxed); }
+    bool IsServerLost() const { return m_serverLost.load(std::memory_order_acquire); }
+
+private:
+    static int ProcessThunk(uint32_t frames, void* arg);
+    static int BufferSizeThunk(uint32_t frames, void* arg);
+    static int XrunThunk(void* arg);
+    static void ShutdownThunk(void* arg);
+
+    void ConnectPhysical(bool capture);
+
+    jack_client_t* m_client{nullptr};
+    jack_port_t* m_inputs[MAX_INPUTS]{nullptr, nullptr};
+    jack_port_t* m_outputs[2]{nullptr, nullptr};
+    int m_inputChannels{0};
+    JackBackendOptions m_options;
+    std::string m_clientName;
+    int m_sampleRate{0};
+    std::atomic<size_t> m_bufferSize{0};
+
+    ProcessCallback m_callback{nullptr};
+    void* m_user{nullptr};
+
+    std::atomic<bool> m_active{false};
+    std::atomic<bool> m_serverLost{false};
+    std::atomic<uint64_t> m_xruns{0};
+};
+
+} // namespace vrb
@@ -0,0 +1,125 @@
+// latency_controller.cpp - Jitter-buffer depth control for the worker pipeline
+
+#include "latency_controller.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace vrb {
+
+namespace {
+
+constexpr double QUEUE_SMOOTHING = 1.0 / 16.0;     // Weight of the newest block in the queue estimate
+constexpr double JITTER_DECAY = 0.999;             // Per block; the peak fades over a few seconds
+
+} // anonymous namespace
+
+void LatencyController::Reset(const LatencyControllerOptions& options) {
+    m_options = options;
+    m_options.blockFrames = std::max<size_t>(1, options.blockFrames);
+    const size_t block = m_options.blockFrames;
+
+    m_maxStep = std::max<size_t>(1, block / 8);
+    m_deadband = std::max<size_t>(2, block / 16);
+    m_minFrames = block;
+    m_options.maxFrames = std::max(options.maxFrames, m_minFrames);
+    m_holdFrames = static_cast<size_t>(std::max(0.0, options.holdSeconds) * options.sampleRate);
+
+    const size_t target = std::clamp(options.initialFrames, m_minFrames, m_options.maxFrames);
+    m_smoothedQueue = static_cast<double>(target);
+    m_jitterPeak = 0.0;
+    m_lowWater = std::numeric_limits<size_t>::max();
+    m_quietFrames = 0;
+    m_target.store(target, std::memory_order_relaxed);
+    m_queued.store(target, std::memory_order_relaxed);
+}
+
+size_t LatencyController::Plan(size_t queuedFrames, double jitterFrames, bool xrun) {
+    const size_t block = m_options.blockFrames;
+
+    m_smoothedQueue += (static_cast<double>(queuedFrames) - m_smoothedQueue) * QUEUE_SMOOTHING;
+    m_queued.store(static_cast<size_t>(std::lround(m_smoothedQueue)), std::memory_order_relaxed);
+    m_jitterPeak = std::max(m_jitterPeak * JITTER_DECAY, std::abs(jitterFrames));
+    m_lowWater = std::min(m_lowWater, queuedFrames);
+
+    if (xrun) {
+        Grow(block / 2);
+    } else if ((m_quietFrames += block) >= m_holdFrames) {
+        // Frames that stayed queued through the whole quiet spell were latency nothing needed
+        const size_t target = m_target.load(std::memory_order_relaxed);
+        const size_t safety = static_cast<size_t>(std::ceil(m_jitterPeak)) + m_options.crossfadeFrames;
+        const size_t slack = m_lowWater > block ? m_lowWater - block : 0;
+        if (slack > safety && target > m_minFrames) {
+            const size_t shrink = std::min({slack - safety, block / 2, target - m_minFrames});
+            m_target.store(target - shrink, std::memory_order_relaxed);
+        }
+        m_quietFrames = 0;
+        m_lowWater = std::numeric_limits<size_t>::max();
+    }
+
+    // Steer the smoothed depth, not the instantaneous one: a worker a little late for
+    // this block is jitter, not a reason to splice
+    const double error = m_smoothedQueue - static_cast<double>(m_target.load(std::memory_order_relaxed));
+    size_t take = block;
+    if (std::abs(error) > static_cast<double>(m_deadband)) {
+        const double step = std::clamp(std::round(error), -static_cast<double>(m_maxStep), static_cast<double>(m_maxStep));
+        take = static_cast<size_t>(static_cast<double>(block) + step);
+    }
+
+    // Nearly a block queued: stretch what there is rather than play silence
+    if (take > queuedFrames) {
+        take = queuedFrames + m_maxStep >= block ? std::max(queuedFrames, block - m_maxStep) : block;
+    }
+    return take;
+}
+
+void LatencyController::OnUnderrun(size_t queuedFrames) {
+    // The block about to be queued lands on top of what is left
+    const size_t target = m_target.load(std::memory_order_relaxed);
+    const size_t grown = std::max(target + m_options.blockFrames / 2, queuedFrames + m_options.blockFrames);
+    m_target.store(std::min(grown, m_options.maxFrames), std::memory_order_relaxed);
+    m_quietFrames = 0;
+    m_lowWater = std::numeric_limits<size_t>::max();
+}
+
+void LatencyController::Grow(size_t frames) {
+    const size_t target = m_target.load(std::memory_order_relaxed);
+    m_target.store(std::min(target + frames, m_options.maxFrames), std::memory_order_relaxed);
+    m_quietFrames = 0;
+    m_lowWater = std::numeric_limits<size_t>::max();
+}
+
+void LatencyController::Splice(const float* source, size_t sourceFrames, float* output, size_t frames,
+                               int channels, size_t crossfadeFrames) {
+    const size_t ch = static_cast<size_t>(channels);
+    if (sourceFrames == frames) {
+        std::memcpy(output, source, frames * ch * sizeof(float));
+        return;
+    }
+
+    // Dropping jumps ahead from the first frame; repeating jumps back once the
+    // frames it replays have been played
+    const bool repeat = sourceFrames < frames;
+    const size_t distance = repeat ? frames - sourceFrames : sourceFrames - frames;
+    const size_t splice = repeat ? distance : 0;
+    const size_t room = repeat ? frames - std::min(frames, 2 * distance) : frames;
+    const size_t fade = std::min(crossfadeFrames, room);
+    auto shifted = [&](size_t frame) { return repeat ? frame - distance : frame + distance; };
+
+    std::memcpy(output, source, splice * ch * sizeof(float));
+    for (size_t i = 0; i < fade; ++i) {
+        const size_t frame = splice + i;
+        const float in = static_cast<float>(i + 1) / static_cast<float>(fade + 1);
+        const float* from = source + frame * ch;
+        const float* to = source + shifted(frame) * ch;
+        for (size_t c = 0; c < ch; ++c) {
+            output[frame * ch + c] = from[c] + (to[c] - from[c]) * in;
+        }
+    }
+    const size_t rest = splice + fade;
+    std::memcpy(output + rest * ch, source + shifted(rest) * ch, (frames - rest) * ch * sizeof(float));
+}
+
+} // namespace vrb
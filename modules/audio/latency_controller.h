@@ -0,0 +1,81 @@
+// latency_controller.h - Jitter-buffer depth control for the worker pipeline
+// Keeps the device buffer fixed and moves the rendered-audio queue instead, a few frames per block
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+namespace vrb {
+
+struct LatencyControllerOptions {
+    size_t blockFrames = 128;           // Device block; the queue never drops below one
+    size_t initialFrames = 256;         // Target at start (the configured lookahead)
+    size_t maxFrames = 1024;            // Ceiling for the target
+    double sampleRate = 48000.0;
+    double holdSeconds = 5.0;           // Trouble-free time before the target may shrink
+    size_t crossfadeFrames = 32;        // Length of every splice
+};
+
+/**
+ * @brief Decides, once per device block, how many queued frames to play
+ *
+ * The target queue depth grows by half a block on every xrun or underrun and
+ * shrinks only after holdSeconds without one, by the part of the queue that
+ * was never needed in that time less a safety margin from the callback
+ * jitter seen. The queue is steered towards the target by taking up to
+ * blockFrames/8 frames more (dropping) or fewer (repeating) than a block and
+ * splicing them with a short crossfade, so the device keeps its buffer and
+ * the stream never restarts.
+ *
+ * Plan, OnUnderrun and Reset belong to the audio thread; the getters may be
+ * called from any thread.
+ */
+class LatencyController {
+public:
+    void Reset(const LatencyControllerOptions& options);
+
+    /**
+     * @brief Frames to take from the queue for this block (blockFrames ± the correction)
+     * @param queuedFrames Rendered frames waiting before this block is taken
+     * @param jitterFrames How far this callback arrived from one block after the last
+     * @param xrun The device or the pipeline reported trouble since the last block
+     */
+    size_t Plan(size_t queuedFrames, double jitterFrames, bool xrun);
+
+    // The queue could not cover a block: the target grows to at least queuedFrames plus one block
+    void OnUnderrun(size_t queuedFrames);
+
+    size_t GetTargetFrames() const { return m_target.load(std::memory_order_relaxed); }
+    size_t GetQueuedFrames() const { return m_queued.load(std::memory_order_relaxed); }    // Smoothed
+    size_t GetCrossfadeFrames() const { return m_options.crossfadeFrames; }
+    size_t GetMaxStepFrames() const { return m_maxStep; }
+
+    /**
+     * @brief Play sourceFrames as frames, splicing out or repeating the difference
+     *
+     * Source frame j + delta replaces output frame j from the splice point on,
+     * with a linear crossfade of up to crossfadeFrames into the jump; delta is
+     * sourceFrames - frames and must stay within frames/4.
+     */
+    static void Splice(const float* source, size_t sourceFrames, float* output, size_t frames,
+                       int channels, size_t crossfadeFrames);
+
+private:
+    void Grow(size_t frames);
+
+    LatencyControllerOptions m_options;
+    size_t m_minFrames{0};
+    size_t m_maxStep{0};
+    size_t m_deadband{0};
+    size_t m_holdFrames{0};
+
+    double m_smoothedQueue{0.0};
+    double m_jitterPeak{0.0};           // Decaying maximum, in frames
+    size_t m_lowWater{0};               // Fewest frames queued since the last shrink decision
+    size_t m_quietFrames{0};
+
+    std::atomic<size_t> m_target{0};
+    std::atomic<size_t> m_queued{0};
+};
+
+} // namespace vrb
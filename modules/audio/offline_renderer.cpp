@@ -0,0 +1,174 @@
+// offline_renderer.cpp - Faster-than-realtime binaural rendering of files
+// Segment planning, per-lane HRTF processors and region writes into one output file
+
+#include "offline_renderer.h"
+#include "config.h"
+#include "hrtf_processor.h"
+#include "logger.h"
+#include "worker_pool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace vrb {
+
+namespace {
+
+size_t RoundUp(size_t value, size_t multiple) {
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+// Everything one lane needs; lanes render segments lane, lane + lanes, ...
+struct RenderLane {
+    std::unique_ptr<HRTFProcessor> processor;
+    std::vector<float> input;
+    std::vector<float> output;
+    std::string error;
+};
+
+} // anonymous namespace
+
+OfflineRenderResult OfflineRenderer::Render(const std::string& inputPath, const PoseTrajectory& trajectory,
+                                            const std::string& outputPath, const OfflineRenderOptions& options) {
+    OfflineRenderResult result;
+
+    WavReader probe;
+    if (!probe.Open(inputPath, result.error)) {
+        return result;
+    }
+    const WavInfo info = probe.GetInfo();
+    probe.Close();
+
+    if (info.channels != 1 && info.channels != 2) {
+        result.error = inputPath + ": " + std::to_string(info.channels) + " channels, expected mono or stereo";
+        return result;
+    }
+    const int sampleRate = m_config.GetProcessingSampleRate();
+    if (info.sampleRate != sampleRate) {
+        result.error = inputPath + " is " + std::to_string(info.sampleRate) + " Hz but processing runs at " +
+                       std::to_string(sampleRate) + " Hz";
+        return result;
+    }
+
+    // Plan block-aligned segments, at most one per thread unless asked otherwise
+    const size_t block = std::max<size_t>(options.blockFrames, 1);
+    const size_t threads = options.threads ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+    const uint64_t frames = info.frames;
+    size_t segments = options.segments;
+    if (segments == 0) {
+        segments = static_cast<size_t>(std::min<uint64_t>(threads, frames / std::max<size_t>(options.minSegmentFrames, 1)));
+    }
+    segments = std::max<size_t>(segments, 1);
+    const uint64_t segmentFrames = std::max<uint64_t>(RoundUp(static_cast<size_t>((frames + segments - 1) / segments), block), block);
+    segments = static_cast<size_t>(std::max<uint64_t>((frames + segmentFrames - 1) / segmentFrames, 1));
+    const uint64_t primeFrames = RoundUp(options.primeFrames, block);
+    const size_t lanes = std::min(segments, threads);
+
+    // Fix the output length up front so the lanes can fill their regions in any order
+    {
+        WavWriter output;
+        if (!output.Open(outputPath, sampleRate, 2, options.outputFormat, result.error)) {
+            return result;
+        }
+        if (!output.Reserve(frames) || !output.Close()) {
+            result.error = "cannot reserve " + std::to_string(frames) + " frames in " + outputPath;
+            return result;
+        }
+    }
+
+    // The first processor loads (or compiles and caches) the dataset; the rest can then map it
+    std::vector<RenderLane> renderLanes(lanes);
+    for (auto& lane : renderLanes) {
+        lane.processor = std::make_unique<HRTFProcessor>();
+        lane.input.resize(block * info.channels);
+        lane.output.resize(block * 2);
+    }
+    if (!renderLanes[0].processor->Initialize(m_config)) {
+        result.error = "HRTF processor failed to initialize";
+        return result;
+    }
+
+    WorkerPool pool(lanes);
+    pool.Run(lanes, [&](size_t index) {
+        RenderLane& lane = renderLanes[index];
+        if (index > 0 && !lane.processor->Initialize(m_config)) {
+            lane.error = "HRTF processor failed to initialize";
+        }
+        if (lane.error.empty() && block > lane.processor->GetMaxBlockSize()) {
+            lane.processor->SetMaxBlockSize(block);
+        }
+    });
+
+    const auto start = std::chrono::steady_clock::now();
+    pool.Run(lanes, [&](size_t index) {
+        RenderLane& lane = renderLanes[index];
+        if (!lane.error.empty()) {
+            return;
+        }
+        WavReader reader;
+        if (!reader.Open(inputPath, lane.error)) {
+            return;
+        }
+
+        std::vector<VRPose> microphone(1);
+        VRPose head;
+        for (size_t segment = index; segment < segments; segment += lanes) {
+            const uint64_t first = segment * segmentFrames;
+            const uint64_t last = std::min<uint64_t>(first + segmentFrames, frames);
+            const uint64_t primeStart = first > primeFrames ? first - primeFrames : 0;
+
+            WavWriter writer;
+            if (!writer.OpenRegion(outputPath, first, lane.error)) {
+                return;
+            }
+            writer.SetDither(options.dither, 0x9E3779B9u + static_cast<uint32_t>(segment) * 0x85EBCA6Bu);
+            lane.processor->Reset();
+            if (!reader.Seek(primeStart)) {
+                lane.error = inputPath + ": seek failed";
+                return;
+            }
+
+            for (uint64_t position = primeStart; position < last; position += block) {
+                const size_t count = static_cast<size_t>(std::min<uint64_t>(block, last - position));
+                if (reader.Read(lane.input.data(), count) != count) {
+                    lane.error = inputPath + ": read failed at frame " + std::to_string(position);
+                    return;
+                }
+                trajectory.Sample(static_cast<double>(position) / sampleRate, head, microphone[0]);
+                lane.processor->UpdateSpatialPosition(head, microphone);
+                lane.processor->Process(lane.input.data(), lane.output.data(), count, info.channels);
+                if (position >= first && !writer.Write(lane.output.data(), count)) {
+                    lane.error = outputPath + ": write failed at frame " + std::to_string(position);
+                    return;
+                }
+            }
+            if (!writer.Close()) {
+                lane.error = outputPath + ": write failed";
+                return;
+            }
+        }
+    });
+    const auto end = std::chrono::steady_clock::now();
+
+    for (const auto& lane : renderLanes) {
+        if (!lane.error.empty()) {
+            result.error = lane.error;
+            return result;
+        }
+    }
+
+    result.success = true;
+    result.frames = frames;
+    result.segments = segments;
+    result.seconds = std::chrono::duration<double>(end - start).count();
+    result.samplesPerSecond = result.seconds > 0.0 ? frames / result.seconds : 0.0;
+    result.realtimeFactor = result.samplesPerSecond / sampleRate;
+    LOG_INFO("Offline render: {} frames in {} segments on {} threads, {:.3f} s ({:.0f} samples/s, {:.1f}x realtime)",
+             frames, segments, lanes, result.seconds, result.samplesPerSecond, result.realtimeFactor);
+    return result;
+}
+
+} // namespace vrb
@@ -0,0 +1,60 @@
+// offline_renderer.h - Faster-than-realtime binaural rendering of files
+// Re-renders archived sessions and benchmarks HRTF throughput without an audio device
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "pose_trajectory.h"
+#include "wav_file.h"
+
+namespace vrb {
+
+class Config;
+
+struct OfflineRenderOptions {
+    size_t blockFrames{256};            // Frames per Process call and per pose update
+    size_t threads{0};                  // 0 uses every hardware thread
+    size_t segments{0};                 // 0 picks one per thread, no shorter than minSegmentFrames
+    size_t minSegmentFrames{480000};    // Below this, splitting costs more priming than it saves
+    size_t primeFrames{8192};           // Rendered and discarded before each segment
+    WavSampleFormat outputFormat{WavSampleFormat::Float32};
+    bool dither{true};                  // TPDF on 16/24-bit output
+};
+
+struct OfflineRenderResult {
+    bool success{false};
+    std::string error;
+    uint64_t frames{0};
+    size_t segments{0};
+    double seconds{0.0};                // Rendering only; the HRTF load is excluded
+    double samplesPerSecond{0.0};       // Input frames rendered per wall-clock second
+    double realtimeFactor{0.0};         // samplesPerSecond / sample rate
+};
+
+/**
+ * @brief Renders a mono or stereo WAV to binaural stereo along a pose trajectory
+ *
+ * The input is cut into block-aligned segments that render in parallel, each
+ * on its own HRTFProcessor with its own reader and writer. Every segment
+ * first renders primeFrames of the audio before it and throws that away, so
+ * the convolution history and filter crossfades are settled by the time its
+ * own output starts and the joins match a single continuous render. Poses
+ * are sampled from the trajectory once per block at the block's start time.
+ *
+ * The processing rate is taken from the config and must match the input
+ * file; the output has the same length as the input (no filter tail).
+ */
+class OfflineRenderer {
+public:
+    explicit OfflineRenderer(const Config& config) : m_config(config) {}
+
+    OfflineRenderResult Render(const std::string& inputPath, const PoseTrajectory& trajectory,
+                               const std::string& outputPath,
+                               const OfflineRenderOptions& options = OfflineRenderOptions());
+
+private:
+    const Config& m_config;
+};
+
+} // namespace vrb
@@ -0,0 +1,245 @@
+// pose_track.cpp - Binary VR pose stream recorded alongside the audio
+
+#include "pose_track.h"
+#include "logger.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+
+namespace vrb {
+
+namespace {
+
+constexpr char MAGIC[8] = {'V', 'R', 'B', 'P', 'O', 'S', 'E', '\0'};
+constexpr uint32_t VERSION = 1;
+constexpr size_t HEADER_BYTES = 32;
+constexpr size_t RECORD_BYTES = 96;
+constexpr size_t RING_RECORDS = 4096;       // Over 40 s of 90 Hz tracking
+constexpr auto WRITE_INTERVAL = std::chrono::milliseconds(100);
+
+void PutU32(uint8_t* data, uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        data[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+uint32_t GetU32(const uint8_t* data) {
+    return data[0] | (data[1] << 8) | (data[2] << 16) | (static_cast<uint32_t>(data[3]) << 24);
+}
+
+uint64_t GetU64(const uint8_t* data) {
+    return GetU32(data) | (static_cast<uint64_t>(GetU32(data + 4)) << 32);
+}
+
+void PackPose(const VRPose& pose, float* out) {
+    out[0] = pose.position.x;
+    out[1] = pose.position.y;
+    out[2] = pose.position.z;
+    out[3] = pose.orientation.w;
+    out[4] = pose.orientation.x;
+    out[5] = pose.orientation.y;
+    out[6] = pose.orientation.z;
+}
+
+VRPose UnpackPose(const uint8_t* data, bool valid) {
+    float v[7];
+    std::memcpy(v, data, sizeof(v));
+    VRPose pose;
+    pose.position = Vec3(v[0], v[1], v[2]);
+    pose.orientation = Quat(v[3], v[4], v[5], v[6]);
+    pose.isValid = valid;
+    return pose;
+}
+
+} // anonymous namespace
+
+PoseTrackWriter::PoseTrackWriter() = default;
+
+PoseTrackWriter::~PoseTrackWriter() {
+    Close();
+}
+
+bool PoseTrackWriter::Open(const std::string& path, const PoseTrackInfo& info, std::string& error) {
+    if (m_file) {
+        error = "pose track already open: " + m_path;
+        return false;
+    }
+
+    std::error_code ec;
+    const auto parent = std::filesystem::path(path).parent_path();
+    if (!parent.empty()) {
+        std::filesystem::create_directories(parent, ec);
+    }
+
+    m_file = std::fopen(path.c_str(), "wb");
+    if (!m_file) {
+        error = "cannot create " + path + ": " + std::strerror(errno);
+        return false;
+    }
+
+    uint8_t header[HEADER_BYTES] = {};
+    std::memcpy(header, MAGIC, sizeof(MAGIC));
+    PutU32(header + 8, VERSION);
+    PutU32(header + 12, static_cast<uint32_t>(info.sampleRate));
+    PutU32(header + 16, PoseTrackSample::MAX_CONTROLLERS);
+    PutU32(header + 20, info.latencyFrames);
+    PutU32(header + 24, static_cast<uint32_t>(info.startTimeMicros));
+    PutU32(header + 28, static_cast<uint32_t>(info.startTimeMicros >> 32));
+    if (std::fwrite(header, 1, sizeof(header), m_file) != sizeof(header)) {
+        error = "cannot write the header of " + path;
+        std::fclose(m_file);
+        m_file = nullptr;
+        return false;
+    }
+
+    m_path = path;
+    m_ring = std::make_unique<RingBuffer<Record>>(RING_RECORDS);
+    m_drainBuffer.resize(RING_RECORDS);
+    m_lastFrame = 0;
+    m_written = 0;
+    m_dropped = 0;
+    m_writeFailed = false;
+    m_stopping = false;
+    m_writerThread = std::thread([this] { WriterLoop(); });
+    m_active.store(true, std::memory_order_release);
+    return true;
+}
+
+bool PoseTrackWriter::Close() {
+    if (!m_file) {
+        return true;
+    }
+
+    m_active.store(false);
+    while (m_pushing.load() != 0) {
+        std::this_thread::yield();
+    }
+    m_stopping.store(true, std::memory_order_release);
+    if (m_writerThread.joinable()) {
+        m_writerThread.join();
+    }
+
+    const bool ok = std::fclose(m_file) == 0 && !m_writeFailed;
+    m_file = nullptr;
+    if (!ok) {
+        LOG_ERROR("Pose track {} is incomplete: a write failed", m_path);
+    }
+    if (m_dropped.load() > 0) {
+        LOG_WARN("Pose track dropped {} tracking updates", m_dropped.load());
+    }
+    return ok;
+}
+
+bool PoseTrackWriter::Push(uint64_t frame, const VRPose& hmd, const std::vector<VRPose>& controllers) {
+    m_pushing.fetch_add(1);
+    bool accepted = false;
+    if (m_active.load()) {
+        Record record{};
+        m_lastFrame = std::max(m_lastFrame, frame);
+        record.frame = m_lastFrame;
+        record.validMask = hmd.isValid ? 1u : 0u;
+        PackPose(hmd, record.poses[0]);
+        const size_t count = std::min<size_t>(controllers.size(), PoseTrackSample::MAX_CONTROLLERS);
+        for (size_t c = 0; c < PoseTrackSample::MAX_CONTROLLERS; ++c) {
+            const VRPose pose = c < count ? controllers[c] : VRPose();
+            record.validMask |= pose.isValid ? (2u << c) : 0u;
+            PackPose(pose, record.poses[1 + c]);
+        }
+        accepted = m_ring->write(&record, 1) == 1;
+        if (!accepted) {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    m_pushing.fetch_sub(1);
+    return accepted;
+}
+
+void PoseTrackWriter::WriterLoop() {
+    while (true) {
+        const bool stopping = m_stopping.load(std::memory_order_acquire);
+        const size_t taken = Drain();
+        if (taken > 0 && !m_writeFailed && std::fflush(m_file) != 0) {
+            m_writeFailed = true;
+        }
+        if (taken == 0) {
+            if (stopping) {
+                break;
+            }
+            std::this_thread::sleep_for(WRITE_INTERVAL);
+        }
+    }
+}
+
+size_t PoseTrackWriter::Drain() {
+    const size_t count = m_ring->read(m_drainBuffer.data(), m_drainBuffer.size());
+    if (count == 0 || m_writeFailed) {
+        return count;
+    }
+    if (std::fwrite(m_drainBuffer.data(), sizeof(Record), count, m_file) != count) {
+        m_writeFailed = true;
+        LOG_ERROR("Pose track write failed for {}", m_path);
+        return count;
+    }
+    m_written.fetch_add(count, std::memory_order_relaxed);
+    return count;
+}
+
+bool ReadPoseTrack(const std::string& path, PoseTrackInfo& info, std::vector<PoseTrackSample>& samples,
+                   std::string& error) {
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        error = "cannot open " + path;
+        return false;
+    }
+
+    uint8_t header[HEADER_BYTES];
+    if (std::fread(header, 1, sizeof(header), file) != sizeof(header) ||
+        std::memcmp(header, MAGIC, sizeof(MAGIC)) != 0) {
+        std::fclose(file);
+        error = path + " is not a pose track";
+        return false;
+    }
+    const uint32_t version = GetU32(header + 8);
+    const uint32_t controllers = GetU32(header + 16);
+    if (version != VERSION || controllers != PoseTrackSample::MAX_CONTROLLERS) {
+        std::fclose(file);
+        error = path + ": unsupported pose track version " + std::to_string(version);
+        return false;
+    }
+    info.sampleRate = static_cast<int>(GetU32(header + 12));
+    info.latencyFrames = GetU32(header + 20);
+    info.startTimeMicros = GetU64(header + 24);
+
+    // A trailing partial record is what a crash mid-write leaves; it is ignored
+    samples.clear();
+    uint8_t record[RECORD_BYTES];
+    while (std::fread(record, 1, sizeof(record), file) == sizeof(record)) {
+        PoseTrackSample sample;
+        sample.frame = GetU64(record);
+        const uint32_t mask = GetU32(record + 8);
+        sample.hmd = UnpackPose(record + 12, (mask & 1u) != 0);
+        for (int c = 0; c < PoseTrackSample::MAX_CONTROLLERS; ++c) {
+            sample.controllers[c] = UnpackPose(record + 12 + 28 * (1 + c), (mask & (2u << c)) != 0);
+        }
+        samples.push_back(sample);
+    }
+    std::fclose(file);
+    return true;
+}
+
+bool IsPoseTrackFile(const std::string& path) {
+    char magic[sizeof(MAGIC)] = {};
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        return false;
+    }
+    const bool match = std::fread(magic, 1, sizeof(magic), file) == sizeof(magic) &&
+                       std::memcmp(magic, MAGIC, sizeof(MAGIC)) == 0;
+    std::fclose(file);
+    return match;
+}
+
+} // namespace vrb
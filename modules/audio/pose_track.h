@@ -0,0 +1,101 @@
+// pose_track.h - Binary VR pose stream recorded alongside the audio
+// Poses are stamped with the audio sample clock so a session can be re-rendered frame-accurately
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "ring_buffer.h"
+#include "vr_types.h"
+
+namespace vrb {
+
+/**
+ * @brief One tracking update: the HMD and up to two controllers at an audio frame
+ */
+struct PoseTrackSample {
+    static constexpr int MAX_CONTROLLERS = 2;
+
+    uint64_t frame{0};          // Sample clock of the session's audio files
+    VRPose hmd;
+    VRPose controllers[MAX_CONTROLLERS];
+};
+
+struct PoseTrackInfo {
+    int sampleRate{0};
+    uint32_t latencyFrames{0};  // Rendered output trails the dry input by this much
+    uint64_t startTimeMicros{0}; // Unix time the recording started
+};
+
+/**
+ * @brief Streams pose samples to a .vrbpose file from a background thread
+ *
+ * File layout, little-endian: a 32-byte header ("VRBPOSE\0", version,
+ * sample rate, controller slots, latency frames, start time in unix
+ * microseconds) followed by 96-byte records (frame, validity bits, then
+ * position and orientation w,x,y,z of the HMD and each controller).
+ *
+ * Push runs on the tracking thread and only copies into a ring; a full ring
+ * drops the update and counts it.
+ */
+class PoseTrackWriter {
+public:
+    PoseTrackWriter();
+    ~PoseTrackWriter();
+
+    PoseTrackWriter(const PoseTrackWriter&) = delete;
+    PoseTrackWriter& operator=(const PoseTrackWriter&) = delete;
+
+    bool Open(const std::string& path, const PoseTrackInfo& info, std::string& error);
+    // Writes everything pushed so far and closes the file
+    bool Close();
+    bool IsOpen() const { return m_active.load(std::memory_order_acquire); }
+
+    // Tracking thread. Frames that go backwards are raised to the last one written.
+    bool Push(uint64_t frame, const VRPose& hmd, const std::vector<VRPose>& controllers);
+
+    uint64_t GetSamplesWritten() const { return m_written.load(std::memory_order_relaxed); }
+    uint64_t GetSamplesDropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+private:
+    // On-disk record; written as-is on little-endian hosts
+    struct Record {
+        uint64_t frame;
+        uint32_t validMask;                 // Bit 0 the HMD, bit 1 + n controller n
+        float poses[1 + PoseTrackSample::MAX_CONTROLLERS][7];
+    };
+    static_assert(sizeof(Record) == 96, "pose records are 96 bytes on disk");
+
+    void WriterLoop();
+    size_t Drain();
+
+    std::FILE* m_file{nullptr};
+    std::string m_path;
+    std::thread m_writerThread;
+    std::atomic<bool> m_stopping{false};
+    bool m_writeFailed{false};
+
+    std::atomic<bool> m_active{false};
+    std::atomic<int> m_pushing{0};
+    std::unique_ptr<RingBuffer<Record>> m_ring;
+    std::vector<Record> m_drainBuffer;
+    uint64_t m_lastFrame{0};                // Tracking thread
+
+    std::atomic<uint64_t> m_written{0};
+    std::atomic<uint64_t> m_dropped{0};
+};
+
+/**
+ * @brief Reads a whole .vrbpose file
+ */
+bool ReadPoseTrack(const std::string& path, PoseTrackInfo& info, std::vector<PoseTrackSample>& samples,
+                   std::string& error);
+
+// Whether the file starts with the pose track signature
+bool IsPoseTrackFile(const std::string& path);
+
+} // namespace vrb
@@ -0,0 +1,189 @@
+// pose_trajectory.cpp - Timestamped head and microphone poses for offline rendering
+
+#include "pose_trajectory.h"
+#include "pose_track.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+namespace vrb {
+
+namespace {
+
+// Splits on commas and whitespace; false if any field is not a number
+bool ParseRow(const std::string& line, std::vector<double>& values) {
+    values.clear();
+    std::string field;
+    std::istringstream stream(line);
+    while (std::getline(stream, field, ',')) {
+        std::istringstream fieldStream(field);
+        std::string token;
+        while (fieldStream >> token) {
+            char* end = nullptr;
+            const double value = std::strtod(token.c_str(), &end);
+            if (end == token.c_str() || *end != '\0') {
+                return false;
+            }
+            values.push_back(value);
+        }
+    }
+    return true;
+}
+
+VRPose MakePose(const double* v, bool withOrientation) {
+    VRPose pose;
+    pose.position = Vec3(static_cast<float>(v[0]), static_cast<float>(v[1]), static_cast<float>(v[2]));
+    if (withOrientation) {
+        pose.orientation = Quat(static_cast<float>(v[3]), static_cast<float>(v[4]),
+                                static_cast<float>(v[5]), static_cast<float>(v[6])).normalized();
+    }
+    pose.isValid = true;
+    return pose;
+}
+
+Vec3 Lerp(const Vec3& a, const Vec3& b, float t) {
+    return a + (b - a) * t;
+}
+
+// Normalised lerp along the shorter arc; keyframes are close enough that slerp buys nothing
+Quat Nlerp(const Quat& a, const Quat& b, float t) {
+    const float sign = (a.w * b.w + a.x * b.x + a.y * b.y + a.z * b.z) < 0.0f ? -1.0f : 1.0f;
+    return Quat(a.w + (sign * b.w - a.w) * t, a.x + (sign * b.x - a.x) * t,
+                a.y + (sign * b.y - a.y) * t, a.z + (sign * b.z - a.z) * t).normalized();
+}
+
+VRPose Interpolate(const VRPose& a, const VRPose& b, float t) {
+    VRPose pose;
+    pose.position = Lerp(a.position, b.position, t);
+    pose.orientation = Nlerp(a.orientation, b.orientation, t);
+    pose.isValid = true;
+    return pose;
+}
+
+} // anonymous namespace
+
+bool PoseTrajectory::LoadPoseTrack(const std::string& path, std::string& error) {
+    PoseTrackInfo info;
+    std::vector<PoseTrackSample> samples;
+    if (!ReadPoseTrack(path, info, samples, error)) {
+        return false;
+    }
+    if (info.sampleRate <= 0) {
+        error = path + ": pose track has no sample rate";
+        return false;
+    }
+
+    // Same microphone choice as HRTFProcessor::UpdateSpatialPosition made while recording
+    m_keyframes.clear();
+    for (const auto& sample : samples) {
+        PoseKeyframe keyframe;
+        keyframe.time = static_cast<double>(sample.frame) / info.sampleRate;
+        keyframe.head = sample.hmd.isValid ? sample.hmd : VRPose();
+        keyframe.head.isValid = true;
+        for (const auto& controller : sample.controllers) {
+            if (controller.isValid) {
+                keyframe.microphone = controller;
+                break;
+            }
+        }
+        if (!keyframe.microphone.isValid) {
+            keyframe.microphone.position = Vec3(0.0f, keyframe.head.position.y - 0.2f, keyframe.head.position.z - 0.3f);
+            keyframe.microphone.orientation = keyframe.head.orientation;
+            keyframe.microphone.isValid = true;
+        }
+        if (!Add(keyframe)) {
+            error = path + ": time goes backwards at frame " + std::to_string(sample.frame);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool PoseTrajectory::Load(const std::string& path, std::string& error) {
+    if (IsPoseTrackFile(path)) {
+        return LoadPoseTrack(path, error);
+    }
+
+    std::ifstream file(path);
+    if (!file) {
+        error = "cannot open " + path;
+        return false;
+    }
+
+    m_keyframes.clear();
+    std::string line;
+    std::vector<double> values;
+    bool headerSkipped = false;
+    for (size_t lineNumber = 1; std::getline(file, line); ++lineNumber) {
+        const size_t start = line.find_first_not_of(" \t\r");
+        if (start == std::string::npos || line[start] == '#') {
+            continue;
+        }
+        if (!ParseRow(line, values)) {
+            if (m_keyframes.empty() && !headerSkipped) {
+                headerSkipped = true;   // Column header
+                continue;
+            }
+            error = path + ":" + std::to_string(lineNumber) + ": not a number";
+            return false;
+        }
+
+        PoseKeyframe keyframe;
+        keyframe.time = values.empty() ? 0.0 : values[0];
+        if (values.size() == 15) {
+            keyframe.head = MakePose(&values[1], true);
+            keyframe.microphone = MakePose(&values[8], true);
+        } else if (values.size() == 4) {
+            keyframe.head.isValid = true;
+            keyframe.microphone = MakePose(&values[1], false);
+        } else {
+            error = path + ":" + std::to_string(lineNumber) + ": expected 4 or 15 columns, found " +
+                    std::to_string(values.size());
+            return false;
+        }
+        if (!Add(keyframe)) {
+            error = path + ":" + std::to_string(lineNumber) + ": time goes backwards";
+            return false;
+        }
+    }
+    return true;
+}
+
+bool PoseTrajectory::Add(const PoseKeyframe& keyframe) {
+    if (!m_keyframes.empty() && keyframe.time < m_keyframes.back().time) {
+        return false;
+    }
+    m_keyframes.push_back(keyframe);
+    return true;
+}
+
+void PoseTrajectory::Sample(double time, VRPose& head, VRPose& microphone) const {
+    if (m_keyframes.empty()) {
+        head = VRPose();
+        microphone = VRPose();
+        microphone.position = Vec3(0.0f, 0.0f, -1.0f);
+    } else if (time <= m_keyframes.front().time) {
+        head = m_keyframes.front().head;
+        microphone = m_keyframes.front().microphone;
+    } else if (time >= m_keyframes.back().time) {
+        head = m_keyframes.back().head;
+        microphone = m_keyframes.back().microphone;
+    } else {
+        const auto next = std::upper_bound(m_keyframes.begin(), m_keyframes.end(), time,
+                                           [](double t, const PoseKeyframe& k) { return t < k.time; });
+        const auto& a = *(next - 1);
+        const auto& b = *next;
+        const double span = b.time - a.time;
+        const float t = span > 0.0 ? static_cast<float>((time - a.time) / span) : 1.0f;
+        head = Interpolate(a.head, b.head, t);
+        microphone = Interpolate(a.microphone, b.microphone, t);
+    }
+    head.isValid = true;
+    microphone.isValid = true;
+    head.timestamp = time;
+    microphone.timestamp = time;
+}
+
+} // namespace vrb
@@ -0,0 +1,51 @@
+// pose_trajectory.h - Timestamped head and microphone poses for offline rendering
+// Loaded from CSV, sampled at any time by interpolating between keyframes
+#pragma once
+
+#include <string>
+#include <vector>
+#include "vr_types.h"
+
+namespace vrb {
+
+struct PoseKeyframe {
+    double time{0.0};       // Seconds from the start of the audio
+    VRPose head;
+    VRPose microphone;
+};
+
+/**
+ * @brief Sequence of head/microphone poses ordered by time
+ *
+ * CSV rows are either 15 columns
+ *   time, head x,y,z, head qw,qx,qy,qz, mic x,y,z, mic qw,qx,qy,qz
+ * or 4 columns
+ *   time, mic x,y,z
+ * with the head at the origin looking down -Z. Blank lines, '#' comments and
+ * a non-numeric header row are skipped. Load also accepts a recorded
+ * .vrbpose track, taking the microphone from the first tracked controller as
+ * the live renderer does. Sample holds the first and last
+ * keyframes outside the covered range; an empty trajectory samples a static
+ * listener with the microphone one metre ahead.
+ */
+class PoseTrajectory {
+public:
+    bool Load(const std::string& path, std::string& error);
+    bool LoadPoseTrack(const std::string& path, std::string& error);
+
+    // Keyframes must arrive in time order; out-of-order ones are rejected
+    bool Add(const PoseKeyframe& keyframe);
+    void Clear() { m_keyframes.clear(); }
+
+    bool empty() const { return m_keyframes.empty(); }
+    size_t size() const { return m_keyframes.size(); }
+    double GetDuration() const { return m_keyframes.empty() ? 0.0 : m_keyframes.back().time; }
+
+    // Linear position, normalised-lerp orientation; both poses come back valid
+    void Sample(double time, VRPose& head, VRPose& microphone) const;
+
+private:
+    std::vector<PoseKeyframe> m_keyframes;
+};
+
+} // namespace vrb
@@ -0,0 +1,186 @@
+// recording_session.cpp - Synchronized capture of the dry input, binaural output and pose stream
+
+#include "recording_session.h"
+#include "logger.h"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <thread>
+
+namespace vrb {
+
+namespace {
+
+int64_t SteadyNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // anonymous namespace
+
+RecordingSession::Paths RecordingSession::MakePaths(const std::string& binauralPath) {
+    std::filesystem::path base(binauralPath);
+    if (base.extension() == ".wav" || base.extension() == ".WAV") {
+        base.replace_extension();
+    }
+    Paths paths;
+    paths.binaural = binauralPath;
+    paths.dry = base.string() + ".dry.wav";
+    paths.poses = base.string() + ".vrbpose";
+    paths.automation = base.string() + ".vrba";
+    return paths;
+}
+
+RecordingSession::RecordingSession() = default;
+
+RecordingSession::~RecordingSession() {
+    Stop();
+}
+
+bool RecordingSession::Start(const std::string& binauralPath, int sampleRate, int inputChannels, int outputChannels,
+                             uint32_t latencyFrames, const RecordingSessionOptions& options, std::string& error) {
+    if (m_binaural.IsRecording()) {
+        error = "already recording to " + m_paths.binaural;
+        return false;
+    }
+
+    m_paths = MakePaths(binauralPath);
+    m_sampleRate = sampleRate;
+    m_dryTrack = options.captureDry && inputChannels > 0;
+    m_poseTrack = options.capturePoses;
+    m_silence.assign(SILENCE_FRAMES * static_cast<size_t>(std::max(1, inputChannels)), 0.0f);
+
+    DiskRecorderOptions binauralOptions = options.audio;
+    binauralOptions.description = options.audio.description.empty() ? "Binaural render" : options.audio.description;
+    if (!m_binaural.Start(m_paths.binaural, sampleRate, outputChannels, binauralOptions, error)) {
+        return false;
+    }
+    if (m_dryTrack) {
+        DiskRecorderOptions dryOptions = options.audio;
+        dryOptions.description = "Dry input";
+        if (!m_dry.Start(m_paths.dry, sampleRate, inputChannels, dryOptions, error)) {
+            m_binaural.Stop();
+            return false;
+        }
+    }
+    if (m_poseTrack) {
+        PoseTrackInfo info;
+        info.sampleRate = sampleRate;
+        info.latencyFrames = latencyFrames;
+        info.startTimeMicros = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count());
+        if (!m_poses.Open(m_paths.poses, info, error)) {
+            m_dry.Stop();
+            m_binaural.Stop();
+            return false;
+        }
+    }
+
+    m_blockStartFrame = 0;
+    m_blockFrames = 0;
+    m_blockTimeNs = SteadyNowNs();
+    m_active.store(true, std::memory_order_release);
+
+    LOG_INFO("Session recording: binaural{}{}, output {} frames behind the input", m_dryTrack ? " + dry" : "",
+             m_poseTrack ? " + poses" : "", latencyFrames);
+    return true;
+}
+
+bool RecordingSession::Stop() {
+    if (!m_binaural.IsRecording() && !m_dry.IsRecording() && !m_poses.IsOpen()) {
+        return true;
+    }
+
+    m_active.store(false);
+    while (m_pushing.load() != 0) {
+        std::this_thread::yield();
+    }
+
+    bool ok = m_binaural.Stop();
+    ok = m_dry.Stop() && ok;
+    ok = m_poses.Close() && ok;
+    return ok;
+}
+
+bool RecordingSession::PushAudio(const float* dry, const float* binaural, size_t frames) {
+    m_pushing.fetch_add(1);
+    bool accepted = false;
+    if (m_active.load()) {
+        // All tracks take the block or none does, so they never drift apart
+        if (m_binaural.HasSpace(frames) && (!m_dryTrack || m_dry.HasSpace(frames))) {
+            m_binaural.Push(binaural, frames);
+            if (m_dryTrack) {
+                if (dry) {
+                    m_dry.Push(dry, frames);
+                } else {
+                    for (size_t done = 0; done < frames; done += SILENCE_FRAMES) {
+                        m_dry.Push(m_silence.data(), std::min(SILENCE_FRAMES, frames - done));
+                    }
+                }
+            }
+
+            const uint64_t start = m_blockStartFrame.load(std::memory_order_relaxed) +
+                                   m_blockFrames.load(std::memory_order_relaxed);
+            const uint32_t sequence = m_clockSequence.load(std::memory_order_relaxed);
+            m_clockSequence.store(sequence + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            m_blockStartFrame.store(start, std::memory_order_relaxed);
+            m_blockFrames.store(frames, std::memory_order_relaxed);
+            m_blockTimeNs.store(SteadyNowNs(), std::memory_order_relaxed);
+            m_clockSequence.store(sequence + 2, std::memory_order_release);
+            accepted = true;
+        } else {
+            m_binaural.Drop(frames);
+            if (m_dryTrack) {
+                m_dry.Drop(frames);
+            }
+        }
+    }
+    m_pushing.fetch_sub(1);
+    return accepted;
+}
+
+bool RecordingSession::PushPose(const VRPose& hmd, const std::vector<VRPose>& controllers) {
+    if (!m_poseTrack || !m_active.load(std::memory_order_acquire)) {
+        return false;
+    }
+    return m_poses.Push(GetFrameClock(), hmd, controllers);
+}
+
+uint64_t RecordingSession::GetFrameClock() const {
+    uint64_t start = 0;
+    uint64_t frames = 0;
+    int64_t blockTime = 0;
+    for (;;) {
+        const uint32_t sequence = m_clockSequence.load(std::memory_order_acquire);
+        start = m_blockStartFrame.load(std::memory_order_relaxed);
+        frames = m_blockFrames.load(std::memory_order_relaxed);
+        blockTime = m_blockTimeNs.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if ((sequence & 1u) == 0 && m_clockSequence.load(std::memory_order_relaxed) == sequence) {
+            break;
+        }
+    }
+
+    // Time since the last block places the pose inside it; the next block takes over past its end
+    const double elapsed = static_cast<double>(SteadyNowNs() - blockTime) * 1e-9;
+    const auto offset = static_cast<uint64_t>(std::clamp(elapsed * m_sampleRate, 0.0, static_cast<double>(frames)));
+    return start + offset;
+}
+
+RecordingSession::Stats RecordingSession::GetStats() const {
+    Stats stats;
+    stats.binaural = m_binaural.GetStats();
+    stats.dryTrack = m_dryTrack;
+    stats.poseTrack = m_poseTrack;
+    if (m_dryTrack) {
+        stats.dry = m_dry.GetStats();
+    }
+    stats.frames = stats.binaural.framesPushed;
+    stats.poses = m_poses.GetSamplesWritten();
+    stats.posesDropped = m_poses.GetSamplesDropped();
+    return stats;
+}
+
+} // namespace vrb
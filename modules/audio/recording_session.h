@@ -0,0 +1,104 @@
+// recording_session.h - Synchronized capture of the dry input, binaural output and pose stream
+// Every track shares one sample clock, so a take can be re-rendered offline with new HRTFs or mic placement
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "disk_recorder.h"
+#include "pose_track.h"
+#include "vr_types.h"
+
+namespace vrb {
+
+struct RecordingSessionOptions {
+    DiskRecorderOptions audio;              // Shared by both audio tracks
+    bool captureDry{true};                  // Pre-HRTF input next to the binaural render
+    bool capturePoses{true};                // HMD and controller poses on the audio clock
+};
+
+/**
+ * @brief A sidecar set of files recorded against one sample clock
+ *
+ * "take.wav" holds the binaural output, "take.dry.wav" the device input
+ * before any processing and "take.vrbpose" the tracking stream. Both audio
+ * files receive the same blocks: when either ring is full the block is
+ * dropped from both, so frame n of one is frame n of the other. Poses are
+ * stamped with the frame the audio files had reached when they arrived,
+ * refined within the current block by elapsed time, and land in the same
+ * frame numbering. The pose header also records how many frames the
+ * binaural output trails the dry input.
+ *
+ * Start and Stop run on a control thread, PushAudio on the audio thread and
+ * PushPose on the tracking thread; neither push blocks.
+ */
+class RecordingSession {
+public:
+    struct Paths {
+        std::string binaural;
+        std::string dry;
+        std::string poses;
+        std::string automation;             // Written by the engine's AutomationWriter, not the session
+    };
+
+    struct Stats {
+        DiskRecorder::Stats binaural;
+        DiskRecorder::Stats dry;
+        uint64_t frames{0};                 // Sample clock: frames in each audio file
+        uint64_t poses{0};                  // Pose samples written
+        uint64_t posesDropped{0};
+        bool dryTrack{false};
+        bool poseTrack{false};
+    };
+
+    // "dir/take.wav" -> dir/take.wav, dir/take.dry.wav, dir/take.vrbpose, dir/take.vrba
+    static Paths MakePaths(const std::string& binauralPath);
+
+    RecordingSession();
+    ~RecordingSession();
+
+    RecordingSession(const RecordingSession&) = delete;
+    RecordingSession& operator=(const RecordingSession&) = delete;
+
+    bool Start(const std::string& binauralPath, int sampleRate, int inputChannels, int outputChannels,
+               uint32_t latencyFrames, const RecordingSessionOptions& options, std::string& error);
+    bool Stop();
+    bool IsRecording() const { return m_active.load(std::memory_order_acquire); }
+
+    // Audio thread. A null dry block (no input this callback) is recorded as silence to keep the tracks aligned.
+    bool PushAudio(const float* dry, const float* binaural, size_t frames);
+
+    // Tracking thread
+    bool PushPose(const VRPose& hmd, const std::vector<VRPose>& controllers);
+
+    // The frame a pose arriving now belongs to
+    uint64_t GetFrameClock() const;
+
+    Stats GetStats() const;
+    const std::string& GetPath() const { return m_paths.binaural; }
+    const Paths& GetPaths() const { return m_paths; }
+
+private:
+    static constexpr size_t SILENCE_FRAMES = 1024;
+
+    DiskRecorder m_binaural;
+    DiskRecorder m_dry;
+    PoseTrackWriter m_poses;
+    Paths m_paths;
+    int m_sampleRate{0};
+    bool m_dryTrack{false};
+    bool m_poseTrack{false};
+    std::vector<float> m_silence;
+
+    std::atomic<bool> m_active{false};
+    mutable std::atomic<int> m_pushing{0};
+
+    // Sample clock, published by the audio thread under a sequence count
+    std::atomic<uint32_t> m_clockSequence{0};
+    std::atomic<uint64_t> m_blockStartFrame{0};
+    std::atomic<uint64_t> m_blockFrames{0};
+    std::atomic<int64_t> m_blockTimeNs{0};      // steady_clock when the block was recorded
+};
+
+} // namespace vrb
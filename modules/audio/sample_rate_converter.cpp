@@ -0,0 +1,203 @@
+// sample_rate_converter.cpp - Streaming polyphase sample rate conversion
+// Filter bank design at configure time, one dot product per output sample at run time
+
+#define _USE_MATH_DEFINES
+#include "sample_rate_converter.h"
+#include "simd/audio_simd.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+
+namespace vrb {
+
+namespace {
+
+struct QualityPreset {
+    int zeroCrossings;      // Each side of the centre tap, at the lower of the two rates
+    double attenuation;     // Stopband, dB
+};
+
+QualityPreset GetPreset(ResamplerQuality quality) {
+    switch (quality) {
+        case ResamplerQuality::Fast: return {8, 60.0};
+        case ResamplerQuality::High: return {64, 120.0};
+        case ResamplerQuality::Balanced:
+        default: return {32, 90.0};
+    }
+}
+
+// Kaiser's estimate of the window shape for a stopband attenuation
+double KaiserBeta(double attenuation) {
+    return attenuation > 50.0 ? 0.1102 * (attenuation - 8.7) : 0.5842 * std::pow(attenuation - 21.0, 0.4) +
+                                                               0.07886 * (attenuation - 21.0);
+}
+
+// Zeroth-order modified Bessel function of the first kind, for the Kaiser window
+double BesselI0(double x) {
+    double sum = 1.0, term = 1.0;
+    for (int k = 1; k < 64 && term > sum * 1e-17; ++k) {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+    }
+    return sum;
+}
+
+} // anonymous namespace
+
+ResamplerQuality ParseResamplerQuality(const std::string& name) {
+    if (name == "fast") return ResamplerQuality::Fast;
+    if (name == "high") return ResamplerQuality::High;
+    return ResamplerQuality::Balanced;
+}
+
+const char* ResamplerQualityName(ResamplerQuality quality) {
+    switch (quality) {
+        case ResamplerQuality::Fast: return "fast";
+        case ResamplerQuality::High: return "high";
+        case ResamplerQuality::Balanced:
+        default: return "balanced";
+    }
+}
+
+bool SampleRateConverter::Configure(int sourceRate, int targetRate, int channels, size_t maxInputFrames,
+                                    ResamplerQuality quality) {
+    m_channels = 0;
+    if (sourceRate <= 0 || targetRate <= 0 || channels <= 0 || maxInputFrames == 0) {
+        return false;
+    }
+
+    const int divisor = std::gcd(sourceRate, targetRate);
+    const int up = targetRate / divisor;
+    const int down = sourceRate / divisor;
+    if (up > MAX_PHASES) {
+        return false;
+    }
+    m_up = up;
+    m_down = down;
+
+    // Centre the transition band so the stopband starts right at the lower Nyquist rate;
+    // Kaiser's length estimate gives its width relative to that Nyquist rate
+    const QualityPreset preset = GetPreset(quality);
+    const double transition = (preset.attenuation - 7.95) / (14.36 * preset.zeroCrossings);
+    const double kaiserBeta = KaiserBeta(preset.attenuation);
+
+    // Cutoff in units of source frames
+    const double cutoff = (1.0 - transition / 2.0) * std::min(1.0, static_cast<double>(m_up) / m_down);
+    const double halfWidth = preset.zeroCrossings / cutoff;
+    const int reach = static_cast<int>(std::ceil(halfWidth));
+    m_taps = 2 * reach;
+    m_delay = reach;
+
+    // Phase p serves outputs lying p/up past their base frame; tap k reads base - k
+    const double norm = BesselI0(kaiserBeta);
+    std::vector<double> phase(static_cast<size_t>(m_taps));
+    m_phases.assign(static_cast<size_t>(m_up) * m_taps, 0.0f);
+    for (int p = 0; p < m_up; ++p) {
+        const double fraction = static_cast<double>(p) / m_up;
+        double sum = 0.0;
+        for (int k = 0; k < m_taps; ++k) {
+            const double u = k + fraction - m_delay;
+            double value = 0.0;
+            if (std::abs(u) < halfWidth) {
+                const double x = M_PI * cutoff * u;
+                const double sinc = (std::abs(x) < 1e-12) ? 1.0 : std::sin(x) / x;
+                const double ratio = u / halfWidth;
+                value = cutoff * sinc * BesselI0(kaiserBeta * std::sqrt(1.0 - ratio * ratio)) / norm;
+            }
+            phase[k] = value;
+            sum += value;
+        }
+
+        // Unity DC gain on every phase keeps the phase sweep from modulating a constant input
+        float* stored = m_phases.data() + static_cast<size_t>(p) * m_taps;
+        for (int k = 0; k < m_taps; ++k) {
+            stored[m_taps - 1 - k] = static_cast<float>(phase[k] / sum);
+        }
+    }
+
+    m_channels = channels;
+    m_maxInputFrames = maxInputFrames;
+    m_stride = static_cast<size_t>(m_taps - 1) + maxInputFrames;
+    m_history.assign(m_stride * channels, 0.0f);
+    Reset();
+    return true;
+}
+
+void SampleRateConverter::Reset() {
+    std::fill(m_history.begin(), m_history.end(), 0.0f);
+    m_phase = 0;
+    m_position = 0;
+}
+
+size_t SampleRateConverter::GetMaxOutputFrames(size_t inputFrames) const {
+    if (IsPassthrough()) {
+        return inputFrames;
+    }
+    // Each chunk can emit one frame more than its share while the phase wraps
+    const size_t chunks = m_maxInputFrames ? (inputFrames + m_maxInputFrames - 1) / m_maxInputFrames : 1;
+    return (inputFrames * m_up + m_down - 1) / m_down + chunks;
+}
+
+size_t SampleRateConverter::Process(const float* input, size_t inputFrames, float* output, size_t maxOutputFrames) {
+    if (!IsConfigured() || !input || !output) {
+        return 0;
+    }
+    if (IsPassthrough()) {
+        const size_t frames = std::min(inputFrames, maxOutputFrames);
+        std::memcpy(output, input, frames * m_channels * sizeof(float));
+        return frames;
+    }
+
+    size_t produced = 0;
+    for (size_t offset = 0; offset < inputFrames; offset += m_maxInputFrames) {
+        const size_t count = std::min(m_maxInputFrames, inputFrames - offset);
+        produced += ProcessChunk(input + offset * m_channels, count,
+                                 output + produced * m_channels, maxOutputFrames - produced);
+    }
+    return produced;
+}
+
+size_t SampleRateConverter::ProcessChunk(const float* input, size_t inputFrames, float* output,
+                                         size_t maxOutputFrames) {
+    const size_t historyFrames = static_cast<size_t>(m_taps - 1);
+
+    // Deinterleave behind the carried history so every tap window is contiguous
+    for (int ch = 0; ch < m_channels; ++ch) {
+        float* line = m_history.data() + ch * m_stride + historyFrames;
+        for (size_t i = 0; i < inputFrames; ++i) {
+            line[i] = input[i * m_channels + ch];
+        }
+    }
+
+    size_t produced = 0;
+    while (m_position < inputFrames && produced < maxOutputFrames) {
+        const float* coefficients = m_phases.data() + static_cast<size_t>(m_phase) * m_taps;
+        for (int ch = 0; ch < m_channels; ++ch) {
+            output[produced * m_channels + ch] =
+                simd::dotProduct(coefficients, m_history.data() + ch * m_stride + m_position, m_taps);
+        }
+        ++produced;
+
+        m_phase += m_down;
+        m_position += static_cast<size_t>(m_phase / m_up);
+        m_phase %= m_up;
+    }
+
+    // An undersized output drops the rest of this block's frames but keeps the timeline
+    while (m_position < inputFrames) {
+        m_phase += m_down;
+        m_position += static_cast<size_t>(m_phase / m_up);
+        m_phase %= m_up;
+    }
+    m_position -= inputFrames;
+
+    for (int ch = 0; ch < m_channels; ++ch) {
+        float* line = m_history.data() + ch * m_stride;
+        std::memmove(line, line + inputFrames, historyFrames * sizeof(float));
+    }
+    return produced;
+}
+
+} // namespace vrb
@@ -0,0 +1,84 @@
+// sample_rate_converter.h - Streaming polyphase sample rate conversion
+// Bridges the device rate and the processing rate on the audio thread
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace vrb {
+
+enum class ResamplerQuality {
+    Fast,       // 8 zero crossings each side, 60 dB stopband
+    Balanced,   // 32 zero crossings each side, 90 dB stopband
+    High        // 64 zero crossings each side, 120 dB stopband
+};
+
+// "fast", "balanced" or "high"; anything else is Balanced
+ResamplerQuality ParseResamplerQuality(const std::string& name);
+const char* ResamplerQualityName(ResamplerQuality quality);
+
+/**
+ * @brief Kaiser-windowed sinc resampler for continuous interleaved streams
+ *
+ * The rate pair is reduced to L/M and one bank of L filter phases is built at
+ * Configure time, so every output frame costs one SIMD dot product per
+ * channel against a precomputed phase. History is carried between blocks and
+ * the phase accumulator is exact integer arithmetic, so a stream split into
+ * blocks of any size produces the same samples and exactly L/M as many
+ * frames over time; per-block output counts vary by one frame as the phase
+ * wraps. Process neither allocates nor locks.
+ */
+class SampleRateConverter {
+public:
+    static constexpr int MAX_PHASES = 4096;     // Covers every pair of standard rates
+
+    /**
+     * @brief Build the filter bank and size the stream state (allocates)
+     * @param maxInputFrames Largest block Process will be handed in one call
+     * @return false for invalid rates or a pair needing more than MAX_PHASES phases
+     */
+    bool Configure(int sourceRate, int targetRate, int channels, size_t maxInputFrames,
+                   ResamplerQuality quality = ResamplerQuality::Balanced);
+
+    // Clear history and phase, as if the stream had just started
+    void Reset();
+
+    bool IsConfigured() const { return m_channels > 0; }
+    bool IsPassthrough() const { return m_up == m_down; }
+    int GetUpFactor() const { return m_up; }
+    int GetDownFactor() const { return m_down; }
+    int GetTapsPerPhase() const { return m_taps; }
+
+    // Output capacity Process needs for a block of inputFrames
+    size_t GetMaxOutputFrames(size_t inputFrames) const;
+
+    // Group delay in source frames
+    double GetLatencyFrames() const { return IsPassthrough() ? 0.0 : static_cast<double>(m_delay); }
+
+    /**
+     * @brief Convert one interleaved block, consuming all of it
+     * @param maxOutputFrames Capacity of output; GetMaxOutputFrames(inputFrames) always suffices
+     * @return Frames written to output
+     */
+    size_t Process(const float* input, size_t inputFrames, float* output, size_t maxOutputFrames);
+
+private:
+    size_t ProcessChunk(const float* input, size_t inputFrames, float* output, size_t maxOutputFrames);
+
+    int m_up{1};
+    int m_down{1};
+    int m_channels{0};
+    int m_taps{0};                  // Per phase
+    int m_delay{0};                 // Source frames between an input and the outputs centred on it
+    size_t m_maxInputFrames{0};
+    size_t m_stride{0};             // Per-channel history length: m_taps - 1 + m_maxInputFrames
+
+    std::vector<float> m_phases;    // m_up x m_taps, time-reversed so each output is a forward dot product
+    std::vector<float> m_history;   // Planar, m_channels x m_stride
+
+    int m_phase{0};                 // Next output lies m_phase / m_up past its base input frame
+    size_t m_position{0};           // Base input frame of the next output, relative to the next block
+};
+
+} // namespace vrb
@@ -0,0 +1,440 @@
+// shared_output.cpp - Binaural output published to other local processes through shared memory
+// Kept free of the logger and engine so sidecars can link it on its own (vrb_shared_output)
+
+#include "shared_output.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <thread>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#endif
+
+namespace vrb {
+
+namespace {
+
+constexpr size_t MIN_CAPACITY_FRAMES = 256;
+#ifndef __linux__
+constexpr auto POLL_INTERVAL = std::chrono::milliseconds(1);   // Wait without futexes
+#endif
+
+size_t SegmentBytes(size_t capacityFrames) {
+    return SharedOutputFormat::HEADER_BYTES + capacityFrames * SharedOutputFormat::CHANNELS * sizeof(float);
+}
+
+// Shared between processes, so these are not FUTEX_PRIVATE operations
+#ifdef __linux__
+void FutexWait(std::atomic<uint32_t>& word, uint32_t expected, std::chrono::milliseconds timeout) {
+    timespec relative{};
+    relative.tv_sec = static_cast<time_t>(timeout.count() / 1000);
+    relative.tv_nsec = static_cast<long>((timeout.count() % 1000) * 1000000);
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT, expected, &relative, nullptr, 0);
+}
+
+void FutexWake(std::atomic<uint32_t>& word) {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+}
+#endif
+
+uint64_t NewGeneration(uint64_t previous) {
+    const auto now = static_cast<uint64_t>(std::chrono::system_clock::now().time_since_epoch().count());
+    return std::max(now, previous + 1);
+}
+
+} // anonymous namespace
+
+// ===== Producer =====
+
+SharedOutputWriter::~SharedOutputWriter() {
+    Close();
+}
+
+bool SharedOutputWriter::Open(const std::string& name, int sampleRate, size_t minFrames, std::string& error) {
+    Close();
+    if (name.empty() || sampleRate <= 0) {
+        error = "shared output needs a name and a sample rate";
+        return false;
+    }
+
+    size_t capacity = MIN_CAPACITY_FRAMES;
+    while (capacity < minFrames) {
+        capacity <<= 1;
+    }
+    const size_t bytes = SegmentBytes(capacity);
+
+#ifdef _WIN32
+    const auto size = static_cast<unsigned long long>(bytes);
+    HANDLE mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                        static_cast<DWORD>(size >> 32), static_cast<DWORD>(size), name.c_str());
+    void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, bytes) : nullptr;
+    if (!view) {
+        // An existing mapping held open by readers keeps its original size
+        if (mapping) CloseHandle(mapping);
+        error = "cannot create shared memory " + name;
+        return false;
+    }
+    m_mapping = mapping;
+#else
+    // A segment left by a crashed producer is replaced; readers still mapping it see the name change
+    shm_unlink(name.c_str());
+    const int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+        error = "cannot create shared memory " + name + ": " + std::strerror(errno);
+        return false;
+    }
+    void* view = MAP_FAILED;
+    if (ftruncate(fd, static_cast<off_t>(bytes)) == 0) {
+        view = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    const int mapError = errno;
+    close(fd);
+    if (view == MAP_FAILED) {
+        shm_unlink(name.c_str());
+        error = "cannot map shared memory " + name + ": " + std::strerror(mapError);
+        return false;
+    }
+    // Keep the audio thread clear of page faults; unprivileged limits may refuse, which only costs that
+    mlock(view, bytes);
+#endif
+
+    auto* header = static_cast<SharedOutputHeader*>(view);
+    header->producerLive.store(0, std::memory_order_release);
+
+    // Touch every page now rather than on the first pass of the audio thread
+    std::memset(static_cast<uint8_t*>(view) + SharedOutputFormat::HEADER_BYTES, 0,
+                bytes - SharedOutputFormat::HEADER_BYTES);
+
+    header->version = SharedOutputFormat::VERSION;
+    header->headerBytes = static_cast<uint32_t>(SharedOutputFormat::HEADER_BYTES);
+    header->sampleRate = static_cast<uint32_t>(sampleRate);
+    header->channels = SharedOutputFormat::CHANNELS;
+    header->capacityFrames = capacity;
+    header->generation = NewGeneration(header->generation);
+    header->writeFrames.store(0, std::memory_order_relaxed);
+    header->writingFrames.store(0, std::memory_order_relaxed);
+    header->sourceXruns.store(0, std::memory_order_relaxed);
+    header->readerOverrunFrames.store(0, std::memory_order_relaxed);
+    std::memcpy(header->magic, SharedOutputFormat::MAGIC, sizeof(header->magic));
+    header->producerLive.store(1, std::memory_order_release);
+
+    m_header = header;
+    m_data = reinterpret_cast<float*>(static_cast<uint8_t*>(view) + SharedOutputFormat::HEADER_BYTES);
+    m_mask = capacity - 1;
+    m_mappedBytes = bytes;
+    m_name = name;
+    return true;
+}
+
+void SharedOutputWriter::Close() {
+    if (!m_header) {
+        return;
+    }
+    // Sleeping readers wake up to find the producer gone
+    m_header->producerLive.store(0, std::memory_order_seq_cst);
+    Publish(m_header->writeFrames.load(std::memory_order_relaxed));
+
+#ifdef _WIN32
+    UnmapViewOfFile(m_header);
+    CloseHandle(m_mapping);
+    m_mapping = nullptr;
+#else
+    munmap(m_header, m_mappedBytes);
+    shm_unlink(m_name.c_str());
+#endif
+    m_header = nullptr;
+    m_data = nullptr;
+    m_mask = 0;
+    m_mappedBytes = 0;
+}
+
+void SharedOutputWriter::Write(const float* interleaved, size_t frames) {
+    if (!m_header || !interleaved || frames == 0) {
+        return;
+    }
+    constexpr size_t CH = SharedOutputFormat::CHANNELS;
+    uint64_t position = m_header->writeFrames.load(std::memory_order_relaxed);
+
+    // Only the newest ring's worth of an oversized block can survive anyway
+    const size_t capacity = m_mask + 1;
+    if (frames > capacity) {
+        interleaved += (frames - capacity) * CH;
+        position += frames - capacity;
+        frames = capacity;
+    }
+
+    BeginWrite(position + frames);
+    const size_t index = static_cast<size_t>(position) & m_mask;
+    const size_t first = std::min(frames, capacity - index);
+    std::memcpy(m_data + index * CH, interleaved, first * CH * sizeof(float));
+    std::memcpy(m_data, interleaved + first * CH, (frames - first) * CH * sizeof(float));
+    Publish(position + frames);
+}
+
+void SharedOutputWriter::WritePlanar(const float* left, const float* right, size_t frames) {
+    if (!m_header || !left || !right || frames == 0) {
+        return;
+    }
+    uint64_t position = m_header->writeFrames.load(std::memory_order_relaxed);
+    const size_t capacity = m_mask + 1;
+    if (frames > capacity) {
+        left += frames - capacity;
+        right += frames - capacity;
+        position += frames - capacity;
+        frames = capacity;
+    }
+
+    // Interleaved straight into the ring: the only copy the planar block gets
+    BeginWrite(position + frames);
+    size_t index = static_cast<size_t>(position) & m_mask;
+    for (size_t i = 0; i < frames; ++i) {
+        m_data[index * 2] = left[i];
+        m_data[index * 2 + 1] = right[i];
+        index = (index + 1) & m_mask;
+    }
+    Publish(position + frames);
+}
+
+void SharedOutputWriter::BeginWrite(uint64_t writingFrames) {
+    // Ordered before the copy: a reader that sees any of the new samples also sees the new cursor
+    m_header->writingFrames.store(writingFrames, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+void SharedOutputWriter::Publish(uint64_t writeFrames) {
+    // Sequentially consistent against Wait's waiter registration, so a reader either sees the
+    // new cursor or is counted in waiters before the wake decision
+    m_header->writeFrames.store(writeFrames, std::memory_order_seq_cst);
+    m_header->wakeSequence.fetch_add(1, std::memory_order_seq_cst);
+#ifdef __linux__
+    if (m_header->waiters.load(std::memory_order_seq_cst) > 0) {
+        FutexWake(m_header->wakeSequence);
+    }
+#endif
+}
+
+void SharedOutputWriter::AddSourceXruns(uint64_t count) {
+    if (m_header) {
+        m_header->sourceXruns.fetch_add(count, std::memory_order_relaxed);
+    }
+}
+
+uint64_t SharedOutputWriter::GetFramesWritten() const {
+    return m_header ? m_header->writeFrames.load(std::memory_order_relaxed) : 0;
+}
+
+uint32_t SharedOutputWriter::GetReaderCount() const {
+    return m_header ? m_header->readers.load(std::memory_order_relaxed) : 0;
+}
+
+// ===== Consumer =====
+
+SharedOutputReader::~SharedOutputReader() {
+    Detach();
+}
+
+bool SharedOutputReader::Attach(const std::string& name, std::string& error) {
+    Detach();
+
+#ifdef _WIN32
+    HANDLE mapping = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, name.c_str());
+    void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0) : nullptr;
+    MEMORY_BASIC_INFORMATION region{};
+    if (!view || VirtualQuery(view, &region, sizeof(region)) == 0) {
+        if (view) UnmapViewOfFile(view);
+        if (mapping) CloseHandle(mapping);
+        error = "no shared output named " + name;
+        return false;
+    }
+    const size_t size = region.RegionSize;
+#else
+    const int fd = shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0) {
+        error = "no shared output named " + name + ": " + std::strerror(errno);
+        return false;
+    }
+    struct stat info{};
+    void* view = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && static_cast<size_t>(info.st_size) >= SharedOutputFormat::HEADER_BYTES) {
+        view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (view == MAP_FAILED) {
+        error = "cannot map shared output " + name;
+        return false;
+    }
+    const size_t size = static_cast<size_t>(info.st_size);
+#endif
+
+    auto* header = static_cast<SharedOutputHeader*>(view);
+    const uint64_t capacity = header->capacityFrames;
+    const bool valid = std::memcmp(header->magic, SharedOutputFormat::MAGIC, sizeof(header->magic)) == 0 &&
+                       header->version == SharedOutputFormat::VERSION &&
+                       header->headerBytes == SharedOutputFormat::HEADER_BYTES &&
+                       header->channels == SharedOutputFormat::CHANNELS &&
+                       capacity > 0 && (capacity & (capacity - 1)) == 0 && size >= SegmentBytes(capacity);
+    if (!valid || header->producerLive.load(std::memory_order_acquire) == 0) {
+#ifdef _WIN32
+        UnmapViewOfFile(view);
+        CloseHandle(mapping);
+#else
+        munmap(view, size);
+#endif
+        error = valid ? "shared output " + name + " has no producer" : "not a compatible shared output: " + name;
+        return false;
+    }
+
+    m_header = header;
+    m_data = reinterpret_cast<const float*>(static_cast<uint8_t*>(view) + SharedOutputFormat::HEADER_BYTES);
+    m_mask = static_cast<size_t>(capacity - 1);
+    m_mappedBytes = size;
+    m_generation = header->generation;
+    m_position = header->writeFrames.load(std::memory_order_acquire);
+    m_overrunFrames = 0;
+    m_name = name;
+#ifdef _WIN32
+    m_mapping = mapping;
+#else
+    m_inode = static_cast<unsigned long>(info.st_ino);
+#endif
+    header->readers.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void SharedOutputReader::Detach() {
+    if (!m_header) {
+        return;
+    }
+    m_header->readers.fetch_sub(1, std::memory_order_relaxed);
+#ifdef _WIN32
+    UnmapViewOfFile(m_header);
+    CloseHandle(m_mapping);
+    m_mapping = nullptr;
+#else
+    munmap(m_header, m_mappedBytes);
+#endif
+    m_header = nullptr;
+    m_data = nullptr;
+    m_mask = 0;
+    m_mappedBytes = 0;
+}
+
+size_t SharedOutputReader::Available() const {
+    if (!m_header || m_header->generation != m_generation) {
+        return 0;
+    }
+    const uint64_t written = m_header->writeFrames.load(std::memory_order_acquire);
+    return static_cast<size_t>(std::min<uint64_t>(written - m_position, m_mask + 1));
+}
+
+size_t SharedOutputReader::Read(float* interleaved, size_t maxFrames) {
+    if (!m_header || !interleaved || maxFrames == 0 || m_header->generation != m_generation) {
+        return 0;
+    }
+    constexpr size_t CH = SharedOutputFormat::CHANNELS;
+    const size_t capacity = m_mask + 1;
+
+    auto skipTo = [this](uint64_t position) {
+        const uint64_t lost = position - m_position;
+        m_overrunFrames += lost;
+        m_header->readerOverrunFrames.fetch_add(lost, std::memory_order_relaxed);
+        m_position = position;
+    };
+
+    // Two tries: a producer lapping this reader mid-copy moves it to half a ring behind the block in flight
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        const uint64_t written = m_header->writeFrames.load(std::memory_order_acquire);
+        if (written - m_position > capacity) {
+            skipTo(written - capacity / 2);
+        }
+        const size_t count = static_cast<size_t>(std::min<uint64_t>(maxFrames, written - m_position));
+        if (count == 0) {
+            return 0;
+        }
+
+        const size_t index = static_cast<size_t>(m_position) & m_mask;
+        const size_t first = std::min(count, capacity - index);
+        std::memcpy(interleaved, m_data + index * CH, first * CH * sizeof(float));
+        std::memcpy(interleaved + first * CH, m_data, (count - first) * CH * sizeof(float));
+
+        // The copy is intact unless the producer has since started a block that wraps onto its first
+        // frame; writeFrames alone misses the block that is being copied in but not yet published
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const uint64_t writing = m_header->writingFrames.load(std::memory_order_relaxed);
+        if (writing - m_position <= capacity) {
+            m_position += count;
+            return count;
+        }
+        skipTo(std::min(writing - capacity / 2, m_header->writeFrames.load(std::memory_order_acquire)));
+    }
+    return 0;
+}
+
+size_t SharedOutputReader::Wait(std::chrono::milliseconds timeout) {
+    if (!m_header) {
+        std::this_thread::sleep_for(timeout);
+        return 0;
+    }
+    if (const size_t available = Available()) {
+        return available;
+    }
+
+#ifdef __linux__
+    const uint32_t sequence = m_header->wakeSequence.load(std::memory_order_seq_cst);
+    m_header->waiters.fetch_add(1, std::memory_order_seq_cst);
+    if (Available() == 0 && m_header->producerLive.load(std::memory_order_seq_cst) != 0) {
+        FutexWait(m_header->wakeSequence, sequence, timeout);
+    }
+    m_header->waiters.fetch_sub(1, std::memory_order_seq_cst);
+#else
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (Available() == 0 && m_header->producerLive.load(std::memory_order_acquire) != 0 &&
+           std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(POLL_INTERVAL);
+    }
+#endif
+    return Available();
+}
+
+bool SharedOutputReader::IsProducerGone() const {
+    if (!m_header || m_header->producerLive.load(std::memory_order_acquire) == 0 ||
+        m_header->generation != m_generation) {
+        return true;
+    }
+#ifndef _WIN32
+    // A producer that crashed never cleared producerLive; its successor replaced the name instead
+    const int fd = shm_open(m_name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        return true;
+    }
+    struct stat info{};
+    const bool replaced = fstat(fd, &info) != 0 || static_cast<unsigned long>(info.st_ino) != m_inode;
+    close(fd);
+    return replaced;
+#else
+    return false;
+#endif
+}
+
+uint64_t SharedOutputReader::GetSourceXruns() const {
+    return m_header ? m_header->sourceXruns.load(std::memory_order_relaxed) : 0;
+}
+
+} // namespace vrb
@@ -0,0 +1,152 @@
+// shared_output.h - Binaural output published to other local processes through shared memory
+// The segment is a SharedOutputHeader followed by a ring of interleaved float frames at the device rate
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace vrb {
+
+struct SharedOutputFormat {
+    static constexpr char MAGIC[8] = {'V', 'R', 'B', 'S', 'H', 'M', 'O', '\0'};
+    static constexpr uint32_t VERSION = 2;
+    static constexpr size_t HEADER_BYTES = 256;         // Sample data starts here
+    static constexpr uint32_t CHANNELS = 2;
+    static constexpr const char* DEFAULT_NAME = "/vrb_binaural";
+};
+
+/**
+ * @brief Start of the shared segment
+ *
+ * Only the producer writes the ring and the cursors. Readers keep their own
+ * positions and follow writeFrames, so any number of them can attach and a
+ * slow or crashed one never holds up the audio thread: a reader that falls a
+ * whole ring behind skips ahead and counts the frames it lost. The producer
+ * raises writingFrames before it copies a block in, so a reader checks its
+ * copy against the block in flight, not just the published ones.
+ */
+struct SharedOutputHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t headerBytes;
+    uint32_t sampleRate;
+    uint32_t channels;
+    uint64_t capacityFrames;                        // Power of two
+    uint64_t generation;                            // New for every producer Open; readers re-attach on a change
+
+    alignas(64) std::atomic<uint64_t> writeFrames;  // Frames published; everything before it is complete
+    std::atomic<uint64_t> writingFrames;            // End of the block being copied in; frames a ring before it are gone
+    std::atomic<uint32_t> wakeSequence;             // Futex word, bumped after every publish
+    std::atomic<uint32_t> waiters;                  // Readers sleeping in Wait
+    std::atomic<uint32_t> producerLive;             // Cleared by Close
+    std::atomic<uint64_t> sourceXruns;              // Device xruns in the engine: gaps inside the stream
+
+    alignas(64) std::atomic<uint32_t> readers;      // Attached readers
+    std::atomic<uint64_t> readerOverrunFrames;      // Frames lost by readers that fell a ring behind, all readers
+};
+
+static_assert(sizeof(SharedOutputHeader) <= SharedOutputFormat::HEADER_BYTES, "header outgrew its reserved space");
+static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free,
+              "shared-memory atomics must be lock-free");
+
+/**
+ * @brief Producer side, owned by the audio engine
+ *
+ * Open and Close allocate and make system calls; Write and WritePlanar copy
+ * into the ring and only enter the kernel to wake a reader that is asleep in
+ * Wait. Open and Close must not overlap a Write.
+ */
+class SharedOutputWriter {
+public:
+    SharedOutputWriter() = default;
+    ~SharedOutputWriter();
+
+    SharedOutputWriter(const SharedOutputWriter&) = delete;
+    SharedOutputWriter& operator=(const SharedOutputWriter&) = delete;
+
+    // name: "/vrb_binaural" style (a Local\ mapping name on Windows); minFrames is rounded up to a power of two.
+    // Replaces a segment left behind by a crashed producer.
+    bool Open(const std::string& name, int sampleRate, size_t minFrames, std::string& error);
+    void Close();                           // Marks the segment dead for readers and removes the name
+    bool IsOpen() const { return m_header != nullptr; }
+
+    void Write(const float* interleaved, size_t frames);
+    void WritePlanar(const float* left, const float* right, size_t frames);
+    void AddSourceXruns(uint64_t count);
+
+    const std::string& GetName() const { return m_name; }
+    int GetSampleRate() const { return m_header ? static_cast<int>(m_header->sampleRate) : 0; }
+    size_t GetCapacity() const { return m_mask + 1; }
+    uint64_t GetFramesWritten() const;
+    uint32_t GetReaderCount() const;
+
+private:
+    void BeginWrite(uint64_t writingFrames);
+    void Publish(uint64_t writeFrames);
+
+    SharedOutputHeader* m_header{nullptr};
+    float* m_data{nullptr};
+    size_t m_mask{0};
+    size_t m_mappedBytes{0};
+    std::string m_name;
+#ifdef _WIN32
+    void* m_mapping{nullptr};
+#endif
+};
+
+/**
+ * @brief Reference consumer: attach, then Wait and Read in a loop
+ *
+ * Reads start at the live position. A reader is used from one thread;
+ * several readers, in one process or many, may follow the same segment.
+ */
+class SharedOutputReader {
+public:
+    SharedOutputReader() = default;
+    ~SharedOutputReader();
+
+    SharedOutputReader(const SharedOutputReader&) = delete;
+    SharedOutputReader& operator=(const SharedOutputReader&) = delete;
+
+    bool Attach(const std::string& name, std::string& error);
+    void Detach();
+    bool IsAttached() const { return m_header != nullptr; }
+
+    int GetSampleRate() const { return m_header ? static_cast<int>(m_header->sampleRate) : 0; }
+    int GetChannels() const { return m_header ? static_cast<int>(m_header->channels) : 0; }
+    size_t GetCapacity() const { return m_mask + 1; }
+
+    size_t Available() const;               // Unread frames, capped at the ring size
+    // Copies up to maxFrames of the oldest unread frames; returns the number copied
+    size_t Read(float* interleaved, size_t maxFrames);
+    // Sleeps until frames are unread or the timeout passes; returns Available()
+    size_t Wait(std::chrono::milliseconds timeout);
+
+    // The producer closed, or replaced the segment (new rate, restart); Attach again to follow it
+    bool IsProducerGone() const;
+
+    uint64_t GetPosition() const { return m_position; }
+    uint64_t GetOverrunFrames() const { return m_overrunFrames; }      // This reader's losses
+    uint64_t GetSourceXruns() const;
+
+private:
+    SharedOutputHeader* m_header{nullptr};
+    const float* m_data{nullptr};
+    size_t m_mask{0};
+    size_t m_mappedBytes{0};
+    uint64_t m_generation{0};
+    uint64_t m_position{0};
+    uint64_t m_overrunFrames{0};
+    std::string m_name;
+#ifdef _WIN32
+    void* m_mapping{nullptr};
+#else
+    unsigned long m_inode{0};               // Identifies the segment; a replacement under the same name has another
+#endif
+};
+
+} // namespace vrb
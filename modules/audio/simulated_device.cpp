@@ -0,0 +1,161 @@
+// simulated_device.cpp - Virtual-clock audio device behind the mock backend
+
+#define _USE_MATH_DEFINES
+#include "simulated_device.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <thread>
+
+namespace vrb {
+
+namespace {
+
+constexpr double TEST_TONE_HZ = 440.0;
+constexpr float TEST_TONE_LEVEL = 0.1f;
+constexpr float NOISE_LEVEL = 0.001f;
+constexpr uint64_t FNV_OFFSET = 14695981039346656037ull;
+constexpr uint64_t FNV_PRIME = 1099511628211ull;
+
+constexpr uint64_t GOLDEN_GAMMA = 0x9E3779B97F4A7C15ull;
+
+// SplitMix64's finalizer: the same numbers on every platform and standard library
+uint64_t Mix(uint64_t x) {
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+double ToUnit(uint64_t bits) {
+    return static_cast<double>(bits >> 11) * (1.0 / 9007199254740992.0);  // [0, 1) from the top 53 bits
+}
+
+} // anonymous namespace
+
+SimulatedClock ParseSimulatedClock(const std::string& name) {
+    if (name == "free") return SimulatedClock::Free;
+    return SimulatedClock::Realtime;
+}
+
+const char* SimulatedClockName(SimulatedClock clock) {
+    switch (clock) {
+        case SimulatedClock::Free: return "free";
+        case SimulatedClock::Realtime:
+        default: return "realtime";
+    }
+}
+
+void SimulatedDevice::Reset(const SimulatedDeviceOptions& options) {
+    m_options = options;
+    m_options.sampleRate = std::max(1, options.sampleRate);
+    m_options.blockFrames = std::max<size_t>(1, options.blockFrames);
+    m_options.inputChannels = std::max(1, options.inputChannels);
+    std::stable_sort(m_options.faults.begin(), m_options.faults.end(),
+                     [](const SimulatedFault& a, const SimulatedFault& b) { return a.block < b.block; });
+
+    m_period = std::chrono::nanoseconds(static_cast<int64_t>(
+        std::llround(m_options.blockFrames * 1e9 / m_options.sampleRate)));
+    m_origin = std::chrono::steady_clock::now();
+    m_faultState = Mix(m_options.seed);
+    m_nextFault = 0;
+    m_nextBlock = 0;
+    m_lastArrival = std::chrono::nanoseconds(0);
+
+    m_blocks.store(0, std::memory_order_relaxed);
+    m_droppedBlocks.store(0, std::memory_order_relaxed);
+    m_lateBlocks.store(0, std::memory_order_relaxed);
+    m_checksum.store(FNV_OFFSET, std::memory_order_relaxed);
+}
+
+bool SimulatedDevice::Finished() const {
+    return m_options.maxBlocks > 0 && m_nextBlock >= m_options.maxBlocks;
+}
+
+SimulatedCallback SimulatedDevice::Next() {
+    SimulatedCallback callback;
+    callback.block = m_nextBlock++;
+    callback.slot = m_period * static_cast<int64_t>(callback.block);
+
+    // All three are drawn every period so one setting never shifts another's sequence
+    double lateMicros = NextUniform() * m_options.jitterMicros;
+    if (NextUniform() < m_options.lateProbability) {
+        lateMicros += m_options.lateMicros;
+    }
+    callback.dropped = NextUniform() < m_options.dropProbability;
+
+    for (; m_nextFault < m_options.faults.size() && m_options.faults[m_nextFault].block <= callback.block; ++m_nextFault) {
+        const SimulatedFault& fault = m_options.faults[m_nextFault];
+        if (fault.block != callback.block) {
+            continue;
+        }
+        if (fault.kind == SimulatedFault::Kind::Drop) {
+            callback.dropped = true;
+        } else {
+            lateMicros += fault.lateMicros;
+        }
+    }
+
+    // A callback cannot overtake the one before it
+    callback.lateness = std::chrono::nanoseconds(static_cast<int64_t>(std::llround(std::max(0.0, lateMicros) * 1000.0)));
+    if (callback.slot + callback.lateness < m_lastArrival) {
+        callback.lateness = m_lastArrival - callback.slot;
+    }
+
+    m_blocks.fetch_add(1, std::memory_order_relaxed);
+    if (callback.dropped) {
+        m_droppedBlocks.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        m_lastArrival = callback.slot + callback.lateness;
+        if (callback.lateness >= m_period) {
+            m_lateBlocks.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    return callback;
+}
+
+void SimulatedDevice::WaitFor(const SimulatedCallback& callback) const {
+    if (m_options.clock == SimulatedClock::Realtime) {
+        std::this_thread::sleep_until(m_origin + callback.slot + callback.lateness);
+    }
+}
+
+void SimulatedDevice::GenerateInput(float* input) {
+    // Positioned by the period, not by how many were generated, so drops leave the rest of the signal alone
+    const size_t channels = static_cast<size_t>(m_options.inputChannels);
+    const uint64_t firstFrame = (m_nextBlock - 1) * m_options.blockFrames;
+    const uint64_t noiseKey = Mix(m_options.seed + GOLDEN_GAMMA * 0x5EED);
+
+    for (size_t i = 0; i < m_options.blockFrames; ++i) {
+        const uint64_t frame = firstFrame + i;
+        const double time = static_cast<double>(frame) / m_options.sampleRate;
+
+        // Half a second of tone every two and a half, over low-level noise
+        float tone = 0.0f;
+        if (static_cast<int64_t>(time * 2.0) % 5 == 0) {
+            tone = TEST_TONE_LEVEL * static_cast<float>(std::sin(2.0 * M_PI * TEST_TONE_HZ * time));
+        }
+        for (size_t c = 0; c < channels; ++c) {
+            const double noise = ToUnit(Mix(noiseKey + frame * channels + c)) - 0.5;
+            input[i * channels + c] = tone + NOISE_LEVEL * static_cast<float>(noise);
+        }
+    }
+}
+
+void SimulatedDevice::ConsumeOutput(const float* output, size_t samples) {
+    // FNV-1a over the sample bits: equal only if every sample matched
+    uint64_t hash = m_checksum.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < samples; ++i) {
+        uint32_t bits;
+        std::memcpy(&bits, &output[i], sizeof(bits));
+        hash = (hash ^ bits) * FNV_PRIME;
+    }
+    m_checksum.store(hash, std::memory_order_relaxed);
+}
+
+double SimulatedDevice::NextUniform() {
+    m_faultState += GOLDEN_GAMMA;
+    return ToUnit(Mix(m_faultState));
+}
+
+} // namespace vrb
@@ -0,0 +1,107 @@
+// simulated_device.h - Virtual-clock audio device behind the mock backend
+// Schedules callbacks on simulated time, so benchmarks can run faster than real time
+// and xruns can be injected reproducibly
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace vrb {
+
+enum class SimulatedClock {
+    Realtime,   // Callbacks paced to the wall clock, like a real device
+    Free        // Callbacks back to back, as fast as the engine renders them
+};
+
+SimulatedClock ParseSimulatedClock(const std::string& name);
+const char* SimulatedClockName(SimulatedClock clock);
+
+// One fault at an exact period, on top of the random ones
+struct SimulatedFault {
+    enum class Kind {
+        Late,   // The callback arrives lateMicros after its slot
+        Drop    // The period is lost: no callback, capture and playback both gone
+    };
+    uint64_t block = 0;
+    Kind kind = Kind::Late;
+    double lateMicros = 0.0;
+};
+
+struct SimulatedDeviceOptions {
+    SimulatedClock clock = SimulatedClock::Realtime;
+    int sampleRate = 48000;
+    size_t blockFrames = 128;
+    int inputChannels = 1;
+    uint64_t seed = 1;                      // Same seed, same input and the same faults
+    double jitterMicros = 0.0;              // Every callback arrives up to this long after its slot
+    double lateProbability = 0.0;           // Chance a callback is a further lateMicros behind
+    double lateMicros = 0.0;
+    double dropProbability = 0.0;           // Chance a period is lost outright
+    uint64_t maxBlocks = 0;                 // Periods to run; 0 runs until stopped
+    std::vector<SimulatedFault> faults;
+};
+
+struct SimulatedCallback {
+    uint64_t block = 0;
+    std::chrono::nanoseconds slot{0};       // When the period fell due on the virtual clock
+    std::chrono::nanoseconds lateness{0};   // How long after the slot the callback arrived
+    bool dropped = false;
+};
+
+/**
+ * @brief The device side of the mock backend, driven by a virtual clock
+ *
+ * Next() schedules period after period: each callback's lateness is drawn
+ * from the seeded generator (jitter, late callbacks, drops) plus any
+ * scripted faults, and arrivals never run backwards. WaitFor() sleeps until
+ * the arrival on a Realtime clock and returns at once on a Free one. The
+ * capture signal depends only on the seed and the frame position, so the
+ * fault settings never change it; every played block is folded into a
+ * checksum so two runs can be compared.
+ *
+ * Reset, Next, WaitFor, GenerateInput and ConsumeOutput belong to the
+ * device thread; the counters may be read from any thread.
+ */
+class SimulatedDevice {
+public:
+    void Reset(const SimulatedDeviceOptions& options);
+
+    bool Finished() const;
+    SimulatedCallback Next();
+    void WaitFor(const SimulatedCallback& callback) const;
+
+    // One interleaved capture block for the period last returned by Next()
+    void GenerateInput(float* input);
+    void ConsumeOutput(const float* output, size_t samples);
+
+    const SimulatedDeviceOptions& GetOptions() const { return m_options; }
+    std::chrono::nanoseconds GetPeriod() const { return m_period; }
+    std::chrono::steady_clock::time_point GetOrigin() const { return m_origin; }   // Virtual time zero
+
+    uint64_t GetBlocks() const { return m_blocks.load(std::memory_order_relaxed); }
+    uint64_t GetDroppedBlocks() const { return m_droppedBlocks.load(std::memory_order_relaxed); }
+    uint64_t GetLateBlocks() const { return m_lateBlocks.load(std::memory_order_relaxed); }    // Arrived a period or more late
+    uint64_t GetOutputChecksum() const { return m_checksum.load(std::memory_order_relaxed); }
+
+private:
+    double NextUniform();
+
+    SimulatedDeviceOptions m_options;       // faults sorted by block
+    std::chrono::nanoseconds m_period{0};
+    std::chrono::steady_clock::time_point m_origin;
+    uint64_t m_faultState{0};
+    size_t m_nextFault{0};
+    uint64_t m_nextBlock{0};
+    std::chrono::nanoseconds m_lastArrival{0};
+
+    std::atomic<uint64_t> m_blocks{0};
+    std::atomic<uint64_t> m_droppedBlocks{0};
+    std::atomic<uint64_t> m_lateBlocks{0};
+    std::atomic<uint64_t> m_checksum{0};
+};
+
+} // namespace vrb
@@ -0,0 +1,359 @@
+// wav_file.cpp - Streaming RIFF/WAVE reading and writing
+// Header parsing and patching; sample conversion goes through the SIMD format kernels
+
+#include "wav_file.h"
+#include "simd/audio_simd.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace vrb {
+
+namespace {
+
+constexpr uint16_t WAVE_FORMAT_PCM = 0x0001;
+constexpr uint16_t WAVE_FORMAT_IEEE_FLOAT = 0x0003;
+constexpr uint16_t WAVE_FORMAT_EXTENSIBLE = 0xFFFE;
+constexpr uint64_t HEADER_BYTES = 44;       // RIFF header, 16-byte fmt chunk, data chunk header
+constexpr uint64_t MAX_RIFF_DATA_BYTES = std::numeric_limits<uint32_t>::max() - (HEADER_BYTES - 8);
+
+uint16_t ReadU16(const uint8_t* data) {
+    return static_cast<uint16_t>(data[0] | (data[1] << 8));
+}
+
+uint32_t ReadU32(const uint8_t* data) {
+    return static_cast<uint32_t>(data[0]) | (static_cast<uint32_t>(data[1]) << 8) |
+           (static_cast<uint32_t>(data[2]) << 16) | (static_cast<uint32_t>(data[3]) << 24);
+}
+
+void PutU16(uint8_t* data, uint16_t value) {
+    data[0] = static_cast<uint8_t>(value);
+    data[1] = static_cast<uint8_t>(value >> 8);
+}
+
+void PutU32(uint8_t* data, uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        data[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+} // anonymous namespace
+
+bool ParseWavSampleFormat(const std::string& name, WavSampleFormat& format) {
+    if (name == "16") format = WavSampleFormat::Int16;
+    else if (name == "24") format = WavSampleFormat::Int24;
+    else if (name == "32") format = WavSampleFormat::Int32;
+    else if (name == "float") format = WavSampleFormat::Float32;
+    else return false;
+    return true;
+}
+
+size_t GetWavSampleBytes(WavSampleFormat format) {
+    switch (format) {
+        case WavSampleFormat::Int16: return 2;
+        case WavSampleFormat::Int24: return 3;
+        case WavSampleFormat::Int32:
+        case WavSampleFormat::Float32:
+        default: return 4;
+    }
+}
+
+bool WavReader::Open(const std::string& path, std::string& error) {
+    Close();
+    m_file.open(path, std::ios::binary);
+    if (!m_file) {
+        error = "cannot open " + path;
+        return false;
+    }
+
+    uint8_t riff[12];
+    const bool read = static_cast<bool>(m_file.read(reinterpret_cast<char*>(riff), sizeof(riff)));
+    const bool rf64 = read && (std::memcmp(riff, "RF64", 4) == 0 || std::memcmp(riff, "BW64", 4) == 0);
+    if (!read || (!rf64 && std::memcmp(riff, "RIFF", 4) != 0) || std::memcmp(riff + 8, "WAVE", 4) != 0) {
+        error = path + " is not a RIFF/WAVE or RF64 file";
+        Close();
+        return false;
+    }
+
+    m_file.seekg(0, std::ios::end);
+    const uint64_t fileBytes = static_cast<uint64_t>(m_file.tellg());
+    uint16_t format = 0, channels = 0, bitsPerSample = 0;
+    uint32_t sampleRate = 0;
+    uint64_t dataBytes = 0;
+    uint64_t ds64DataBytes = 0;
+    bool haveData = false;
+
+    // Walk the chunk headers; sample data is not read until Read
+    for (uint64_t offset = 12; offset + 8 <= fileBytes && !haveData;) {
+        uint8_t chunk[8];
+        m_file.seekg(static_cast<std::streamoff>(offset));
+        if (!m_file.read(reinterpret_cast<char*>(chunk), sizeof(chunk))) {
+            break;
+        }
+        const uint32_t declared = ReadU32(chunk + 4);
+        uint64_t size = std::min<uint64_t>(declared, fileBytes - offset - 8);
+        if (rf64 && std::memcmp(chunk, "ds64", 4) == 0 && size >= 16) {
+            // 64-bit RIFF and data sizes; the 32-bit fields hold 0xFFFFFFFF
+            uint8_t ds64[16];
+            m_file.read(reinterpret_cast<char*>(ds64), sizeof(ds64));
+            ds64DataBytes = ReadU32(ds64 + 8) | (static_cast<uint64_t>(ReadU32(ds64 + 12)) << 32);
+        } else if (std::memcmp(chunk, "fmt ", 4) == 0 && size >= 16) {
+            uint8_t fmt[40] = {};
+            m_file.read(reinterpret_cast<char*>(fmt), static_cast<std::streamsize>(std::min<uint64_t>(size, 40)));
+            format = ReadU16(fmt);
+            channels = ReadU16(fmt + 2);
+            sampleRate = ReadU32(fmt + 4);
+            bitsPerSample = ReadU16(fmt + 14);
+            if (format == WAVE_FORMAT_EXTENSIBLE && size >= 40) {
+                format = ReadU16(fmt + 24);     // First two bytes of the SubFormat GUID
+            }
+        } else if (std::memcmp(chunk, "data", 4) == 0) {
+            if (rf64 && declared == 0xFFFFFFFFu) {
+                size = std::min<uint64_t>(ds64DataBytes, fileBytes - offset - 8);
+            }
+            m_dataOffset = offset + 8;
+            dataBytes = size;
+            haveData = true;
+        }
+        offset += 8 + size + (size & 1);        // Chunks are word aligned
+    }
+
+    const bool pcm = format == WAVE_FORMAT_PCM && (bitsPerSample == 16 || bitsPerSample == 24 || bitsPerSample == 32);
+    const bool ieee = format == WAVE_FORMAT_IEEE_FLOAT && bitsPerSample == 32;
+    if ((!pcm && !ieee) || channels == 0 || sampleRate == 0 || !haveData) {
+        error = path + ": unsupported WAV (format " + std::to_string(format) + ", " +
+                std::to_string(bitsPerSample) + " bit, " + std::to_string(channels) + " channels)";
+        Close();
+        return false;
+    }
+
+    m_file.clear();
+    m_info.sampleRate = static_cast<int>(sampleRate);
+    m_info.channels = channels;
+    m_info.format = ieee ? WavSampleFormat::Float32
+                  : bitsPerSample == 16 ? WavSampleFormat::Int16
+                  : bitsPerSample == 24 ? WavSampleFormat::Int24 : WavSampleFormat::Int32;
+    m_info.frames = dataBytes / (GetWavSampleBytes(m_info.format) * channels);
+    return Seek(0);
+}
+
+void WavReader::Close() {
+    if (m_file.is_open()) {
+        m_file.close();
+    }
+    m_file.clear();
+    m_info = WavInfo();
+    m_dataOffset = 0;
+    m_position = 0;
+}
+
+bool WavReader::Seek(uint64_t frame) {
+    if (!m_file.is_open() || frame > m_info.frames) {
+        return false;
+    }
+    const uint64_t frameBytes = GetWavSampleBytes(m_info.format) * m_info.channels;
+    m_file.clear();
+    m_file.seekg(static_cast<std::streamoff>(m_dataOffset + frame * frameBytes));
+    m_position = frame;
+    return static_cast<bool>(m_file);
+}
+
+size_t WavReader::Read(float* interleaved, size_t frames) {
+    if (!m_file.is_open() || !interleaved) {
+        return 0;
+    }
+    frames = static_cast<size_t>(std::min<uint64_t>(frames, m_info.frames - m_position));
+    const size_t samples = frames * m_info.channels;
+    const size_t bytes = samples * GetWavSampleBytes(m_info.format);
+    if (m_raw.size() < bytes) {
+        m_raw.resize(bytes);
+    }
+    if (!m_file.read(reinterpret_cast<char*>(m_raw.data()), static_cast<std::streamsize>(bytes))) {
+        return 0;
+    }
+    m_position += frames;
+
+    switch (m_info.format) {
+        case WavSampleFormat::Int16:
+            simd::convertInt16ToFloat(reinterpret_cast<const int16_t*>(m_raw.data()), interleaved, samples);
+            break;
+        case WavSampleFormat::Int24:
+            simd::convertInt24ToFloat(m_raw.data(), interleaved, samples);
+            break;
+        case WavSampleFormat::Int32:
+            simd::convertInt32ToFloat(reinterpret_cast<const int32_t*>(m_raw.data()), interleaved, samples);
+            break;
+        case WavSampleFormat::Float32:
+            std::memcpy(interleaved, m_raw.data(), bytes);
+            break;
+    }
+    return frames;
+}
+
+WavWriter::~WavWriter() {
+    Close();
+}
+
+bool WavWriter::Open(const std::string& path, int sampleRate, int channels, WavSampleFormat format,
+                     std::string& error) {
+    Close();
+    if (sampleRate <= 0 || channels <= 0) {
+        error = "invalid WAV format (" + std::to_string(sampleRate) + " Hz, " + std::to_string(channels) + " channels)";
+        return false;
+    }
+
+    m_file.open(path, std::ios::binary | std::ios::in | std::ios::out | std::ios::trunc);
+    if (!m_file) {
+        error = "cannot create " + path;
+        return false;
+    }
+    m_path = path;
+    m_info.sampleRate = sampleRate;
+    m_info.channels = channels;
+    m_info.format = format;
+    m_region = false;
+    return WriteHeader(0);
+}
+
+bool WavWriter::OpenRegion(const std::string& path, uint64_t startFrame, std::string& error) {
+    Close();
+    WavReader reader;
+    if (!reader.Open(path, error)) {
+        return false;
+    }
+    if (startFrame > reader.GetInfo().frames) {
+        error = path + ": region starts past the reserved length";
+        return false;
+    }
+    m_info = reader.GetInfo();
+    reader.Close();
+
+    m_file.open(path, std::ios::binary | std::ios::in | std::ios::out);
+    if (!m_file) {
+        error = "cannot open " + path + " for writing";
+        return false;
+    }
+    m_path = path;
+    m_region = true;
+    m_file.seekp(static_cast<std::streamoff>(HEADER_BYTES + startFrame * GetWavSampleBytes(m_info.format) * m_info.channels));
+    return static_cast<bool>(m_file);
+}
+
+bool WavWriter::Reserve(uint64_t frames) {
+    if (!m_file.is_open() || m_region) {
+        return false;
+    }
+    const uint64_t bytes = frames * GetWavSampleBytes(m_info.format) * m_info.channels;
+    if (bytes > MAX_RIFF_DATA_BYTES) {
+        return false;
+    }
+    const auto position = m_file.tellp();
+    m_reservedFrames = frames;
+    if (!WriteHeader(frames)) {
+        return false;
+    }
+
+    // Extend the file so region writers seek within it
+    if (bytes > 0) {
+        m_file.seekp(static_cast<std::streamoff>(HEADER_BYTES + bytes - 1));
+        m_file.put('\0');
+    }
+    m_file.seekp(position);
+    return static_cast<bool>(m_file);
+}
+
+bool WavWriter::Close() {
+    if (!m_file.is_open()) {
+        return true;
+    }
+    bool ok = static_cast<bool>(m_file);
+    if (!m_region) {
+        ok = WriteHeader(std::max(m_reservedFrames, m_framesWritten)) && ok;
+    }
+    m_file.close();
+    m_info = WavInfo();
+    m_region = false;
+    m_reservedFrames = 0;
+    m_framesWritten = 0;
+    return ok;
+}
+
+bool WavWriter::Write(const float* interleaved, size_t frames) {
+    if (!m_file.is_open() || !interleaved) {
+        return false;
+    }
+    const size_t samples = frames * m_info.channels;
+    const size_t bytes = samples * GetWavSampleBytes(m_info.format);
+    const uint64_t totalBytes = (m_framesWritten + frames) * GetWavSampleBytes(m_info.format) * m_info.channels;
+    if (!m_region && totalBytes > MAX_RIFF_DATA_BYTES) {
+        return false;
+    }
+    if (m_raw.size() < bytes) {
+        m_raw.resize(bytes);
+    }
+
+    switch (m_info.format) {
+        case WavSampleFormat::Int16: {
+            auto* output = reinterpret_cast<int16_t*>(m_raw.data());
+            if (m_dither) {
+                simd::convertFloatToInt16Dithered(interleaved, output, samples, m_ditherState);
+            } else {
+                simd::convertFloatToInt16(interleaved, output, samples);
+            }
+            break;
+        }
+        case WavSampleFormat::Int24:
+            if (m_dither) {
+                simd::convertFloatToInt24Dithered(interleaved, m_raw.data(), samples, m_ditherState);
+            } else {
+                simd::convertFloatToInt24(interleaved, m_raw.data(), samples);
+            }
+            break;
+        case WavSampleFormat::Int32:
+            simd::convertFloatToInt32(interleaved, reinterpret_cast<int32_t*>(m_raw.data()), samples);
+            break;
+        case WavSampleFormat::Float32:
+            std::memcpy(m_raw.data(), interleaved, bytes);
+            break;
+    }
+
+    m_file.write(reinterpret_cast<const char*>(m_raw.data()), static_cast<std::streamsize>(bytes));
+    m_framesWritten += frames;
+    return static_cast<bool>(m_file);
+}
+
+void WavWriter::SetDither(bool enable, uint32_t seed) {
+    m_dither = enable;
+    m_ditherState = simd::DitherState(seed);
+}
+
+bool WavWriter::WriteHeader(uint64_t frames) {
+    const uint16_t sampleBytes = static_cast<uint16_t>(GetWavSampleBytes(m_info.format));
+    const uint16_t blockAlign = static_cast<uint16_t>(sampleBytes * m_info.channels);
+    const uint32_t dataBytes = static_cast<uint32_t>(frames * blockAlign);
+
+    uint8_t header[HEADER_BYTES];
+    std::memcpy(header, "RIFF", 4);
+    PutU32(header + 4, static_cast<uint32_t>(HEADER_BYTES - 8) + dataBytes);
+    std::memcpy(header + 8, "WAVEfmt ", 8);
+    PutU32(header + 16, 16);
+    PutU16(header + 20, m_info.format == WavSampleFormat::Float32 ? WAVE_FORMAT_IEEE_FLOAT : WAVE_FORMAT_PCM);
+    PutU16(header + 22, static_cast<uint16_t>(m_info.channels));
+    PutU32(header + 24, static_cast<uint32_t>(m_info.sampleRate));
+    PutU32(header + 28, static_cast<uint32_t>(m_info.sampleRate) * blockAlign);
+    PutU16(header + 32, blockAlign);
+    PutU16(header + 34, static_cast<uint16_t>(sampleBytes * 8));
+    std::memcpy(header + 36, "data", 4);
+    PutU32(header + 40, dataBytes);
+
+    const auto position = m_file.tellp();
+    m_file.seekp(0);
+    m_file.write(reinterpret_cast<const char*>(header), sizeof(header));
+    if (position > static_cast<std::streamoff>(HEADER_BYTES)) {
+        m_file.seekp(position);
+    }
+    return static_cast<bool>(m_file);
+}
+
+} // namespace vrb
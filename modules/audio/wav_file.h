@@ -0,0 +1,100 @@
+// wav_file.h - Streaming RIFF/WAVE reading and writing
+// Block-at-a-time access for files too long to hold in memory (offline renders, recordings)
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "simd/simd_dispatch.h"
+
+namespace vrb {
+
+enum class WavSampleFormat {
+    Int16,
+    Int24,      // Packed, 3 bytes per sample
+    Int32,
+    Float32
+};
+
+// "16", "24", "32" or "float"; false for anything else
+bool ParseWavSampleFormat(const std::string& name, WavSampleFormat& format);
+size_t GetWavSampleBytes(WavSampleFormat format);
+
+struct WavInfo {
+    int sampleRate{0};
+    int channels{0};
+    WavSampleFormat format{WavSampleFormat::Float32};
+    uint64_t frames{0};
+};
+
+/**
+ * @brief Reads interleaved float frames from a PCM 16/24/32-bit or 32-bit float WAV
+ *
+ * Only the header is parsed at Open; Read converts one block at a time with
+ * the SIMD format kernels. Every reader has its own file handle, so several
+ * can read different parts of one file in parallel. RF64/BW64 files (sizes
+ * past 4 GB in a ds64 chunk) read like plain RIFF; chunks such as bext are
+ * skipped.
+ */
+class WavReader {
+public:
+    bool Open(const std::string& path, std::string& error);
+    void Close();
+
+    const WavInfo& GetInfo() const { return m_info; }
+    bool Seek(uint64_t frame);
+
+    // Interleaved, full scale +/-1.0; returns frames read, fewer than asked only at the end
+    size_t Read(float* interleaved, size_t frames);
+
+private:
+    std::ifstream m_file;
+    WavInfo m_info;
+    uint64_t m_dataOffset{0};
+    uint64_t m_position{0};         // Next frame Read returns
+    std::vector<uint8_t> m_raw;
+};
+
+/**
+ * @brief Writes interleaved float frames as a WAV file
+ *
+ * Open creates the file and Write appends; Close patches the RIFF sizes.
+ * For parallel renders, Reserve fixes the data length up front and other
+ * writers fill disjoint parts of it through OpenRegion, which leaves the
+ * header alone. 16- and 24-bit output is TPDF-dithered unless disabled.
+ */
+class WavWriter {
+public:
+    ~WavWriter();
+
+    bool Open(const std::string& path, int sampleRate, int channels, WavSampleFormat format,
+              std::string& error);
+    // Writes into a file whose data length was fixed by Reserve, starting at startFrame
+    bool OpenRegion(const std::string& path, uint64_t startFrame, std::string& error);
+    bool Reserve(uint64_t frames);
+    bool Close();
+
+    bool Write(const float* interleaved, size_t frames);
+
+    void SetDither(bool enable, uint32_t seed = 0x9E3779B9u);
+    const WavInfo& GetInfo() const { return m_info; }
+    uint64_t GetFramesWritten() const { return m_framesWritten; }
+
+private:
+    bool WriteHeader(uint64_t frames);
+
+    std::fstream m_file;
+    std::string m_path;
+    WavInfo m_info;
+    bool m_region{false};           // OpenRegion: never touches the header
+    uint64_t m_reservedFrames{0};
+    uint64_t m_framesWritten{0};
+    bool m_dither{true};
+    simd::DitherState m_ditherState;
+    std::vector<uint8_t> m_raw;
+};
+
+} // namespace vrb
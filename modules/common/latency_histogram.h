@@ -0,0 +1,134 @@
+// latency_histogram.h - Wait-free log-bucketed histogram for audio-thread timings
+// One writer (the audio thread) records; any thread may read percentiles at any time
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace vrb {
+
+/**
+ * @brief HDR-style histogram of durations with bounded relative error
+ *
+ * Values are nanoseconds. Each power-of-two range is split into SUB_BUCKETS
+ * linear buckets, so every recorded value lands in a bucket no wider than
+ * 1/SUB_BUCKETS of its magnitude (about 6%) from 1 ns up to MAX_TRACKABLE;
+ * anything longer is clamped into the top bucket while the exact maximum is
+ * still kept. Record is a handful of relaxed atomic adds with no loops or
+ * locks, so it is safe on the audio thread; readers see a slightly torn but
+ * always usable snapshot.
+ */
+class LatencyHistogram {
+public:
+    using Duration = std::chrono::nanoseconds;
+
+    static constexpr int SUB_BUCKET_BITS = 4;
+    static constexpr uint64_t SUB_BUCKETS = 1ull << SUB_BUCKET_BITS;
+    static constexpr int MAGNITUDES = 32;                            // Up to ~4.3 s
+    static constexpr size_t BUCKET_COUNT = SUB_BUCKETS * (MAGNITUDES - SUB_BUCKET_BITS + 1);
+    static constexpr uint64_t MAX_TRACKABLE = (1ull << MAGNITUDES) - 1;
+
+    void Record(Duration value) {
+        const uint64_t ns = value.count() > 0 ? static_cast<uint64_t>(value.count()) : 0;
+        m_buckets[BucketIndex(std::min(ns, MAX_TRACKABLE))].fetch_add(1, std::memory_order_relaxed);
+        m_count.fetch_add(1, std::memory_order_relaxed);
+        m_sum.fetch_add(ns, std::memory_order_relaxed);
+        if (ns > m_max.load(std::memory_order_relaxed)) {
+            m_max.store(ns, std::memory_order_relaxed);     // Single writer: no compare-exchange loop
+        }
+    }
+
+    // Not synchronized with Record; call while the writer is idle (e.g. before a stream starts)
+    void Reset() {
+        for (auto& bucket : m_buckets) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+        m_count.store(0, std::memory_order_relaxed);
+        m_sum.store(0, std::memory_order_relaxed);
+        m_max.store(0, std::memory_order_relaxed);
+    }
+
+    uint64_t GetCount() const { return m_count.load(std::memory_order_relaxed); }
+    Duration GetMax() const { return Duration(m_max.load(std::memory_order_relaxed)); }
+
+    Duration GetMean() const {
+        const uint64_t count = GetCount();
+        return count ? Duration(m_sum.load(std::memory_order_relaxed) / count) : Duration(0);
+    }
+
+    /**
+     * @brief Value at or below which the given fraction of recordings fall
+     * @param percentile 0-100
+     * @return Upper edge of the bucket holding that rank, never above the recorded maximum
+     */
+    Duration GetPercentile(double percentile) const {
+        std::array<uint64_t, BUCKET_COUNT> counts;
+        uint64_t total = 0;
+        for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+            counts[i] = m_buckets[i].load(std::memory_order_relaxed);
+            total += counts[i];
+        }
+        if (total == 0) {
+            return Duration(0);
+        }
+
+        const double clamped = std::clamp(percentile, 0.0, 100.0);
+        const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(clamped / 100.0 * static_cast<double>(total) + 0.5));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+            seen += counts[i];
+            if (seen >= rank) {
+                if (i == BUCKET_COUNT - 1) {
+                    return GetMax();    // Holds every clamped value
+                }
+                return Duration(std::min(BucketUpperBound(i), m_max.load(std::memory_order_relaxed)));
+            }
+        }
+        return GetMax();
+    }
+
+    // Bucket layout, exposed for tests
+    static size_t BucketIndex(uint64_t ns) {
+        if (ns < SUB_BUCKETS) {
+            return static_cast<size_t>(ns);
+        }
+        const int magnitude = HighestBit(ns);                       // >= SUB_BUCKET_BITS
+        const int shift = magnitude - SUB_BUCKET_BITS;
+        const uint64_t sub = (ns >> shift) & (SUB_BUCKETS - 1);
+        return static_cast<size_t>((shift + 1) * SUB_BUCKETS + sub);
+    }
+
+    static uint64_t BucketUpperBound(size_t index) {
+        if (index < SUB_BUCKETS) {
+            return index;
+        }
+        const int shift = static_cast<int>(index / SUB_BUCKETS) - 1;
+        const uint64_t lower = (SUB_BUCKETS + index % SUB_BUCKETS) << shift;
+        return lower + (1ull << shift) - 1;
+    }
+
+private:
+    static int HighestBit(uint64_t value) {
+#if defined(_MSC_VER)
+        unsigned long bit = 0;
+        _BitScanReverse64(&bit, value);
+        return static_cast<int>(bit);
+#else
+        return 63 - __builtin_clzll(value);
+#endif
+    }
+
+    std::array<std::atomic<uint64_t>, BUCKET_COUNT> m_buckets{};
+    std::atomic<uint64_t> m_count{0};
+    std::atomic<uint64_t> m_sum{0};
+    std::atomic<uint64_t> m_max{0};
+};
+
+} // namespace vrb
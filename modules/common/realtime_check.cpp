@@ -0,0 +1,87 @@
+// realtime_check.cpp - Replacement global operator new for the real-time allocation check
+// Only replaces the allocator when VRB_REALTIME_CHECKS is on; release builds keep the default
+
+#include "realtime_check.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+namespace vrb {
+namespace realtime {
+
+namespace {
+
+void DefaultViolationHandler(size_t bytes) {
+    // spdlog allocates, so report straight to stderr
+    std::fprintf(stderr, "FATAL: heap allocation of %zu bytes inside a real-time section\n", bytes);
+    std::fflush(stderr);
+    std::abort();
+}
+
+std::atomic<ViolationHandler> g_handler{&DefaultViolationHandler};
+std::atomic<uint64_t> g_violations{0};
+
+} // namespace
+
+void setViolationHandler(ViolationHandler handler) {
+    g_handler.store(handler ? handler : &DefaultViolationHandler);
+}
+
+uint64_t violationCount() {
+    return g_violations.load(std::memory_order_relaxed);
+}
+
+#if VRB_REALTIME_CHECKS
+namespace detail {
+
+void* CheckedAllocate(size_t bytes) {
+    if (t_sectionDepth > 0) {
+        g_violations.fetch_add(1, std::memory_order_relaxed);
+
+        // Leave the section while reporting so a handler that allocates cannot recurse
+        const int depth = t_sectionDepth;
+        t_sectionDepth = 0;
+        g_handler.load()(bytes);
+        t_sectionDepth = depth;
+    }
+
+    if (void* memory = std::malloc(bytes ? bytes : 1)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+} // namespace detail
+#endif
+
+} // namespace realtime
+} // namespace vrb
+
+#if VRB_REALTIME_CHECKS
+// Over-aligned and nothrow forms keep the library defaults; nothing on the audio path uses them
+void* operator new(std::size_t bytes) {
+    return vrb::realtime::detail::CheckedAllocate(bytes);
+}
+
+void* operator new[](std::size_t bytes) {
+    return vrb::realtime::detail::CheckedAllocate(bytes);
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+#endif
@@ -0,0 +1,53 @@
+// realtime_check.h - Debug detection of heap allocation on the real-time audio path
+// A ScopedRealtimeSection marks code that must not allocate; with checks enabled the
+// global operator new (realtime_check.cpp) reports any allocation made inside one
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// On by default in debug builds; define VRB_REALTIME_CHECKS=1 to enable it elsewhere
+#ifndef VRB_REALTIME_CHECKS
+#ifdef NDEBUG
+#define VRB_REALTIME_CHECKS 0
+#else
+#define VRB_REALTIME_CHECKS 1
+#endif
+#endif
+
+namespace vrb {
+namespace realtime {
+
+// Called with the request size for every allocation inside a real-time section.
+// Runs on the offending thread and must not allocate; the default prints and aborts.
+using ViolationHandler = void (*)(size_t bytes);
+
+void setViolationHandler(ViolationHandler handler);  // nullptr restores the default
+uint64_t violationCount();
+constexpr bool checksEnabled() { return VRB_REALTIME_CHECKS != 0; }
+
+namespace detail {
+inline thread_local int t_sectionDepth = 0;
+}
+
+/**
+ * @brief Marks the enclosing scope as real-time: no heap allocation allowed
+ *
+ * Nests, and costs one thread-local increment when checks are enabled and
+ * nothing otherwise.
+ */
+class ScopedRealtimeSection {
+public:
+#if VRB_REALTIME_CHECKS
+    ScopedRealtimeSection() { ++detail::t_sectionDepth; }
+    ~ScopedRealtimeSection() { --detail::t_sectionDepth; }
+#else
+    ScopedRealtimeSection() {}
+#endif
+    ScopedRealtimeSection(const ScopedRealtimeSection&) = delete;
+    ScopedRealtimeSection& operator=(const ScopedRealtimeSection&) = delete;
+};
+
+} // namespace realtime
+} // namespace vrb
@@ -1,17 +1,14 @@
 // audio_simd.h - Consolidated SIMD optimizations for audio processing
 // Consolidates SIMD operations from utils.h and other audio components
+// Each call goes through the kernel table selected at startup (see simd_dispatch.h)
 
 #pragma once
 
+#include "simd_dispatch.h"
+
 #include <cstddef>
+#include <cstdint>
 #include <cstring>
-#include <cmath>
-
-#ifdef __AVX2__
-#include <immintrin.h>
-#elif defined(__SSE2__)
-#include <emmintrin.h>
-#endif
 
 namespace vrb {
 namespace simd {
@@ -20,239 +17,119 @@ namespace simd {
  * @brief SIMD-optimized RMS calculation
  */
 inline float calculateRMS(const float* buffer, size_t size) {
-    if (size == 0) return 0.0f;
-
-#ifdef __AVX2__
-    __m256 sum = _mm256_setzero_ps();
-    const size_t simdSize = size & ~7;
-
-    for (size_t i = 0; i < simdSize; i += 8) {
-        __m256 samples = _mm256_loadu_ps(&buffer[i]);
-        sum = _mm256_fmadd_ps(samples, samples, sum);
-    }
-
-    // Horizontal sum
-    __m128 sum128 = _mm_add_ps(_mm256_extractf128_ps(sum, 0), _mm256_extractf128_ps(sum, 1));
-    sum128 = _mm_hadd_ps(sum128, sum128);
-    sum128 = _mm_hadd_ps(sum128, sum128);
-
-    float result = _mm_cvtss_f32(sum128);
-
-    // Handle remaining elements
-    for (size_t i = simdSize; i < size; ++i) {
-        result += buffer[i] * buffer[i];
-    }
-
-    return std::sqrt(result / size);
-
-#elif defined(__SSE2__)
-    __m128 sum = _mm_setzero_ps();
-    const size_t simdSize = size & ~3;
-
-    for (size_t i = 0; i < simdSize; i += 4) {
-        __m128 samples = _mm_loadu_ps(&buffer[i]);
-        sum = _mm_add_ps(sum, _mm_mul_ps(samples, samples));
-    }
-
-    // Horizontal sum
-    sum = _mm_hadd_ps(sum, sum);
-    sum = _mm_hadd_ps(sum, sum);
-
-    float result = _mm_cvtss_f32(sum);
-
-    // Handle remaining elements
-    for (size_t i = simdSize; i < size; ++i) {
-        result += buffer[i] * buffer[i];
-    }
-
-    return std::sqrt(result / size);
-
-#else
-    float sum = 0.0f;
-    for (size_t i = 0; i < size; ++i) {
-        sum += buffer[i] * buffer[i];
-    }
-    return std::sqrt(sum / size);
-#endif
+    return kernels().calculateRMS(buffer, size);
 }
 
 /**
  * @brief SIMD-optimized peak calculation
  */
 inline float calculatePeak(const float* buffer, size_t size) {
-    if (size == 0) return 0.0f;
-
-#ifdef __AVX2__
-    __m256 maxValues = _mm256_setzero_ps();
-    const size_t simdSize = size & ~7;
-
-    for (size_t i = 0; i < simdSize; i += 8) {
-        __m256 samples = _mm256_loadu_ps(&buffer[i]);
-        __m256 absSamples = _mm256_andnot_ps(_mm256_set1_ps(-0.0f), samples);
-        maxValues = _mm256_max_ps(maxValues, absSamples);
-    }
-
-    // Horizontal max
-    __m128 max128 = _mm_max_ps(_mm256_extractf128_ps(maxValues, 0), _mm256_extractf128_ps(maxValues, 1));
-    max128 = _mm_max_ps(max128, _mm_shuffle_ps(max128, max128, _MM_SHUFFLE(2, 3, 0, 1)));
-    max128 = _mm_max_ps(max128, _mm_shuffle_ps(max128, max128, _MM_SHUFFLE(1, 0, 3, 2)));
-
-    float result = _mm_cvtss_f32(max128);
-
-    // Handle remaining elements
-    for (size_t i = simdSize; i < size; ++i) {
-        result = std::max(result, std::abs(buffer[i]));
-    }
-
-    return result;
-
-#elif defined(__SSE2__)
-    __m128 maxValues = _mm_setzero_ps();
-    const size_t simdSize = size & ~3;
-
-    for (size_t i = 0; i < simdSize; i += 4) {
-        __m128 samples = _mm_loadu_ps(&buffer[i]);
-        __m128 absSamples = _mm_andnot_ps(_mm_set1_ps(-0.0f), samples);
-        maxValues = _mm_max_ps(maxValues, absSamples);
-    }
-
-    // Horizontal max
-    maxValues = _mm_max_ps(maxValues, _mm_shuffle_ps(maxValues, maxValues, _MM_SHUFFLE(2, 3, 0, 1)));
-    maxValues = _mm_max_ps(maxValues, _mm_shuffle_ps(maxValues, maxValues, _MM_SHUFFLE(1, 0, 3, 2)));
-
-    float result = _mm_cvtss_f32(maxValues);
-
-    // Handle remaining elements
-    for (size_t i = simdSize; i < size; ++i) {
-        result = std::max(result, std::abs(buffer[i]));
-    }
-
-    return result;
-
-#else
-    float maxVal = 0.0f;
-    for (size_t i = 0; i < size; ++i) {
-        maxVal = std::max(maxVal, std::abs(buffer[i]));
-    }
-    return maxVal;
-#endif
+    return kernels().calculatePeak(buffer, size);
 }
 
 /**
  * @brief SIMD-optimized buffer mixing
  */
 inline void mixBuffers(float* destination, const float* source, size_t size, float gain = 1.0f) {
-#ifdef __AVX2__
-    const __m256 gainVector = _mm256_set1_ps(gain);
-    const size_t simdSize = size & ~7;
-
-    for (size_t i = 0; i < simdSize; i += 8) {
-        __m256 dest = _mm256_loadu_ps(&destination[i]);
-        __m256 src = _mm256_loadu_ps(&source[i]);
-        __m256 scaled = _mm256_mul_ps(src, gainVector);
-        __m256 result = _mm256_add_ps(dest, scaled);
-        _mm256_storeu_ps(&destination[i], result);
-    }
-
-    // Handle remaining elements
-    for (size_t i = simdSize; i < size; ++i) {
-        destination[i] += source[i] * gain;
-    }
-
-#elif defined(__SSE2__)
-    const __m128 gainVector = _mm_set1_ps(gain);
-    const size_t simdSize = size & ~3;
-
-    for (size_t i = 0; i < simdSize; i += 4) {
-        __m128 dest = _mm_loadu_ps(&destination[i]);
-        __m128 src = _mm_loadu_ps(&source[i]);
-        __m128 scaled = _mm_mul_ps(src, gainVector);
-        __m128 result = _mm_add_ps(dest, scaled);
-        _mm_storeu_ps(&destination[i], result);
-    }
-
-    // Handle remaining elements
-    for (size_t i = simdSize; i < size; ++i) {
-        destination[i] += source[i] * gain;
-    }
-
-#else
-    for (size_t i = 0; i < size; ++i) {
-        destination[i] += source[i] * gain;
-    }
-#endif
+    kernels().mixBuffers(destination, source, size, gain);
 }
 
 /**
- * @brief SIMD-optimized buffer copying
+ * @brief Buffer copying (memcpy is already vectorized by the C library)
  */
 inline void copyBuffer(float* destination, const float* source, size_t size) {
-#ifdef __AVX2__
-    const size_t simdSize = size & ~7;
+    std::memcpy(destination, source, size * sizeof(float));
+}
 
-    for (size_t i = 0; i < simdSize; i += 8) {
-        __m256 data = _mm256_loadu_ps(&source[i]);
-        _mm256_storeu_ps(&destination[i], data);
-    }
+/**
+ * @brief SIMD-optimized gain application with fade
+ */
+inline void applyGainWithFade(float* buffer, size_t size, float startGain, float endGain) {
+    kernels().applyGainWithFade(buffer, size, startGain, endGain);
+}
 
-    // Handle remaining elements
-    std::memcpy(&destination[simdSize], &source[simdSize], (size - simdSize) * sizeof(float));
+/**
+ * @brief SIMD-optimized weighted sum of three buffers (barycentric blend)
+ */
+inline void weightedSum3(float* destination, const float* a, const float* b, const float* c,
+                         float weightA, float weightB, float weightC, size_t size) {
+    kernels().weightedSum3(destination, a, b, c, weightA, weightB, weightC, size);
+}
 
-#elif defined(__SSE2__)
-    const size_t simdSize = size & ~3;
+/**
+ * @brief SIMD-optimized mono to interleaved stereo duplication
+ */
+inline void monoToStereo(const float* input, float* output, size_t frames) {
+    kernels().monoToStereo(input, output, frames);
+}
 
-    for (size_t i = 0; i < simdSize; i += 4) {
-        __m128 data = _mm_loadu_ps(&source[i]);
-        _mm_storeu_ps(&destination[i], data);
-    }
+/**
+ * @brief SIMD-optimized 4-tap FIR over a contiguous window (fractional delay read)
+ *
+ * destination[i] = sum over k of coefficients[k] * source[i + k]
+ */
+inline void applyFIR4(float* destination, const float* source, const float* coefficients, size_t size) {
+    kernels().applyFIR4(destination, source, coefficients, size);
+}
 
-    // Handle remaining elements
-    std::memcpy(&destination[simdSize], &source[simdSize], (size - simdSize) * sizeof(float));
+/**
+ * @brief SIMD-optimized inner product (one polyphase resampler output per call)
+ */
+inline float dotProduct(const float* a, const float* b, size_t size) {
+    return kernels().dotProduct(a, b, size);
+}
 
-#else
-    std::memcpy(destination, source, size * sizeof(float));
-#endif
+/**
+ * @brief SIMD-optimized spectrum product over interleaved (re, im) bins
+ */
+inline void complexMultiply(const float* a, const float* b, float* result, size_t bins) {
+    kernels().complexMultiply(a, b, result, bins);
 }
 
 /**
- * @brief SIMD-optimized gain application with fade
+ * @brief SIMD-optimized spectrum product accumulated into an interleaved buffer
  */
-inline void applyGainWithFade(float* buffer, size_t size, float startGain, float endGain) {
-    if (size == 0) return;
+inline void complexMultiplyAccumulate(const float* a, const float* b, float* accumulator, size_t bins) {
+    kernels().complexMultiplyAccumulate(a, b, accumulator, bins);
+}
+
+/**
+ * @brief SIMD-optimized sample format conversions (full scale +/-1.0, round to nearest, saturating)
+ */
+inline void convertInt16ToFloat(const int16_t* input, float* output, size_t samples) {
+    kernels().convertInt16ToFloat(input, output, samples);
+}
 
-    const float gainStep = (endGain - startGain) / static_cast<float>(size - 1);
+inline void convertFloatToInt16(const float* input, int16_t* output, size_t samples) {
+    kernels().convertFloatToInt16(input, output, samples);
+}
 
-#ifdef __AVX2__
-    const size_t simdSize = size & ~7;
-    const __m256 stepVector = _mm256_set_ps(
-        7 * gainStep, 6 * gainStep, 5 * gainStep, 4 * gainStep,
-        3 * gainStep, 2 * gainStep, 1 * gainStep, 0 * gainStep
-    );
-    const __m256 incrementVector = _mm256_set1_ps(8 * gainStep);
+inline void convertInt32ToFloat(const int32_t* input, float* output, size_t samples) {
+    kernels().convertInt32ToFloat(input, output, samples);
+}
 
-    __m256 currentGain = _mm256_set1_ps(startGain);
-    currentGain = _mm256_add_ps(currentGain, stepVector);
+inline void convertFloatToInt32(const float* input, int32_t* output, size_t samples) {
+    kernels().convertFloatToInt32(input, output, samples);
+}
 
-    for (size_t i = 0; i < simdSize; i += 8) {
-        __m256 samples = _mm256_loadu_ps(&buffer[i]);
-        __m256 result = _mm256_mul_ps(samples, currentGain);
-        _mm256_storeu_ps(&buffer[i], result);
-        currentGain = _mm256_add_ps(currentGain, incrementVector);
-    }
+inline void convertInt24ToFloat(const uint8_t* input, float* output, size_t samples) {
+    kernels().convertInt24ToFloat(input, output, samples);
+}
 
-    // Handle remaining elements
-    for (size_t i = simdSize; i < size; ++i) {
-        float gain = startGain + gainStep * static_cast<float>(i);
-        buffer[i] *= gain;
-    }
+inline void convertFloatToInt24(const float* input, uint8_t* output, size_t samples) {
+    kernels().convertFloatToInt24(input, output, samples);
+}
+
+/**
+ * @brief Float to integer with TPDF dither; the caller owns one DitherState per output stream
+ */
+inline void convertFloatToInt16Dithered(const float* input, int16_t* output, size_t samples, DitherState& dither) {
+    kernels().convertFloatToInt16Dithered(input, output, samples, dither);
+}
 
-#else
-    for (size_t i = 0; i < size; ++i) {
-        float gain = startGain + gainStep * static_cast<float>(i);
-        buffer[i] *= gain;
-    }
-#endif
+inline void convertFloatToInt24Dithered(const float* input, uint8_t* output, size_t samples, DitherState& dither) {
+    kernels().convertFloatToInt24Dithered(input, output, samples, dither);
 }
 
 } // namespace simd
-} // namespace vrb
\ No newline at end of file
+} // namespace vrb
@@ -0,0 +1,232 @@
+// simd_dispatch.cpp - CPU feature detection and kernel table selection
+
+#include "simd_dispatch.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#include <immintrin.h>
+#define VRB_CPUID_MSVC 1
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <cpuid.h>
+#define VRB_CPUID_GCC 1
+#endif
+
+namespace vrb {
+namespace simd {
+
+namespace {
+
+// XCR0 bits the OS must save for the wider registers to be usable
+constexpr uint64_t XCR0_AVX_STATE = 0x6;      // SSE + AVX (YMM)
+constexpr uint64_t XCR0_AVX512_STATE = 0xE6;  // + opmask, ZMM_Hi256, Hi16_ZMM
+
+std::atomic<const KernelTable*> g_activeKernels{nullptr};
+
+#if defined(VRB_CPUID_MSVC) || defined(VRB_CPUID_GCC)
+
+struct CpuidRegisters {
+    uint32_t eax = 0, ebx = 0, ecx = 0, edx = 0;
+};
+
+CpuidRegisters cpuid(uint32_t leaf, uint32_t subleaf) {
+    CpuidRegisters regs;
+#if defined(VRB_CPUID_MSVC)
+    int info[4];
+    __cpuidex(info, static_cast<int>(leaf), static_cast<int>(subleaf));
+    regs.eax = static_cast<uint32_t>(info[0]);
+    regs.ebx = static_cast<uint32_t>(info[1]);
+    regs.ecx = static_cast<uint32_t>(info[2]);
+    regs.edx = static_cast<uint32_t>(info[3]);
+#else
+    __cpuid_count(leaf, subleaf, regs.eax, regs.ebx, regs.ecx, regs.edx);
+#endif
+    return regs;
+}
+
+uint64_t readXCR0() {
+#if defined(VRB_CPUID_MSVC)
+    return _xgetbv(0);
+#else
+    // Encoded directly so this file needs no -mxsave
+    uint32_t eax = 0, edx = 0;
+    __asm__ volatile(".byte 0x0f, 0x01, 0xd0" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (static_cast<uint64_t>(edx) << 32) | eax;
+#endif
+}
+
+Level detectCpuLevel() {
+    const uint32_t maxLeaf = cpuid(0, 0).eax;
+    if (maxLeaf < 1) return Level::Scalar;
+
+    const CpuidRegisters leaf1 = cpuid(1, 0);
+    const bool sse2 = (leaf1.edx & (1u << 26)) != 0;
+    if (!sse2) return Level::Scalar;
+
+    const bool osxsave = (leaf1.ecx & (1u << 27)) != 0;
+    const bool avx = (leaf1.ecx & (1u << 28)) != 0;
+    const bool fma = (leaf1.ecx & (1u << 12)) != 0;
+    if (!osxsave || !avx || !fma || maxLeaf < 7) return Level::SSE2;
+
+    const uint64_t xcr0 = readXCR0();
+    if ((xcr0 & XCR0_AVX_STATE) != XCR0_AVX_STATE) return Level::SSE2;
+
+    const CpuidRegisters leaf7 = cpuid(7, 0);
+    const bool avx2 = (leaf7.ebx & (1u << 5)) != 0;
+    if (!avx2) return Level::SSE2;
+
+    const bool avx512f = (leaf7.ebx & (1u << 16)) != 0;
+    if (!avx512f || (xcr0 & XCR0_AVX512_STATE) != XCR0_AVX512_STATE) return Level::AVX2;
+
+    return Level::AVX512;
+}
+
+#else
+
+Level detectCpuLevel() {
+    return Level::Scalar;
+}
+
+#endif
+
+const KernelTable* tableFor(Level level) {
+    switch (level) {
+        case Level::AVX512: return avx512Kernels();
+        case Level::AVX2:   return avx2Kernels();
+        case Level::SSE2:   return sse2Kernels();
+        case Level::Scalar: return scalarKernels();
+    }
+    return scalarKernels();
+}
+
+// Highest level at or below the requested one whose table was built
+const KernelTable* bestTableAtOrBelow(Level level) {
+    for (int l = static_cast<int>(level); l > static_cast<int>(Level::Scalar); --l) {
+        if (const KernelTable* table = tableFor(static_cast<Level>(l))) {
+            return table;
+        }
+    }
+    return scalarKernels();
+}
+
+template <typename Fn>
+const char* sourceLevel(Fn KernelTable::*member, const KernelTable& active) {
+    for (int l = static_cast<int>(Level::Scalar); l <= static_cast<int>(active.level); ++l) {
+        const KernelTable* table = tableFor(static_cast<Level>(l));
+        if (table && table->*member == active.*member) {
+            return levelName(static_cast<Level>(l));
+        }
+    }
+    return levelName(active.level);
+}
+
+} // anonymous namespace
+
+DitherState::DitherState(uint32_t seed) {
+    // splitmix32 spreads one seed over the lanes; xorshift must never start at zero
+    for (size_t lane = 0; lane < LANES; ++lane) {
+        uint32_t z = seed + static_cast<uint32_t>(lane + 1) * 0x9E3779B9u;
+        z = (z ^ (z >> 16)) * 0x85EBCA6Bu;
+        z = (z ^ (z >> 13)) * 0xC2B2AE35u;
+        z ^= z >> 16;
+        lanes[lane] = z ? z : 0x6D2B79F5u;
+    }
+}
+
+Level detectLevel() {
+    static const Level detected = detectCpuLevel();
+    return detected;
+}
+
+bool parseLevel(const std::string& name, Level& level, bool& automatic) {
+    std::string lower(name);
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+    automatic = false;
+    if (lower == "auto") {
+        automatic = true;
+        level = detectLevel();
+    } else if (lower == "avx512") {
+        level = Level::AVX512;
+    } else if (lower == "avx2") {
+        level = Level::AVX2;
+    } else if (lower == "sse2") {
+        level = Level::SSE2;
+    } else if (lower == "scalar") {
+        level = Level::Scalar;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char* levelName(Level level) {
+    switch (level) {
+        case Level::Scalar: return "scalar";
+        case Level::SSE2:   return "sse2";
+        case Level::AVX2:   return "avx2";
+        case Level::AVX512: return "avx512";
+    }
+    return "unknown";
+}
+
+Level initialize(const std::string& requested) {
+    Level level = Level::Scalar;
+    bool automatic = false;
+    if (!parseLevel(requested, level, automatic)) {
+        level = detectLevel();
+    }
+
+    level = std::min(level, detectLevel());
+    const KernelTable* table = bestTableAtOrBelow(level);
+    g_activeKernels.store(table, std::memory_order_release);
+    return table->level;
+}
+
+const KernelTable& kernels() {
+    const KernelTable* table = g_activeKernels.load(std::memory_order_acquire);
+    if (!table) {
+        // Racing first calls all pick the same table, so a plain store is enough
+        table = bestTableAtOrBelow(detectLevel());
+        g_activeKernels.store(table, std::memory_order_release);
+    }
+    return *table;
+}
+
+std::string describeKernels() {
+    const KernelTable& active = kernels();
+    std::string description;
+    auto append = [&description](const char* name, const char* level) {
+        if (!description.empty()) description += ' ';
+        description += name;
+        description += '=';
+        description += level;
+    };
+
+    append("rms", sourceLevel(&KernelTable::calculateRMS, active));
+    append("peak", sourceLevel(&KernelTable::calculatePeak, active));
+    append("mix", sourceLevel(&KernelTable::mixBuffers, active));
+    append("fade", sourceLevel(&KernelTable::applyGainWithFade, active));
+    append("weightedSum3", sourceLevel(&KernelTable::weightedSum3, active));
+    append("monoToStereo", sourceLevel(&KernelTable::monoToStereo, active));
+    append("fir4", sourceLevel(&KernelTable::applyFIR4, active));
+    append("dot", sourceLevel(&KernelTable::dotProduct, active));
+    append("complexMul", sourceLevel(&KernelTable::complexMultiply, active));
+    append("complexMac", sourceLevel(&KernelTable::complexMultiplyAccumulate, active));
+    append("i16ToF", sourceLevel(&KernelTable::convertInt16ToFloat, active));
+    append("fToI16", sourceLevel(&KernelTable::convertFloatToInt16, active));
+    append("i32ToF", sourceLevel(&KernelTable::convertInt32ToFloat, active));
+    append("fToI32", sourceLevel(&KernelTable::convertFloatToInt32, active));
+    append("i24ToF", sourceLevel(&KernelTable::convertInt24ToFloat, active));
+    append("fToI24", sourceLevel(&KernelTable::convertFloatToInt24, active));
+    append("fToI16Dither", sourceLevel(&KernelTable::convertFloatToInt16Dithered, active));
+    append("fToI24Dither", sourceLevel(&KernelTable::convertFloatToInt24Dithered, active));
+    return description;
+}
+
+} // namespace simd
+} // namespace vrb
@@ -0,0 +1,101 @@
+// simd_dispatch.h - Runtime selection of SIMD kernel variants
+// Each kernel is compiled once per instruction set; the best one the CPU supports
+// (or the one requested by performance.simdLevel) is selected at startup
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace vrb {
+namespace simd {
+
+enum class Level {
+    Scalar = 0,
+    SSE2 = 1,
+    AVX2 = 2,     // AVX2 + FMA
+    AVX512 = 3    // AVX-512F
+};
+
+/**
+ * @brief Generator state for TPDF dither, owned by the one thread converting a stream
+ *
+ * Eight independent xorshift32 lanes; sample i of every conversion call draws
+ * from lane i % LANES, so the vector variants step all lanes at once and still
+ * produce the scalar sequence.
+ */
+struct DitherState {
+    static constexpr size_t LANES = 8;
+    uint32_t lanes[LANES];
+
+    explicit DitherState(uint32_t seed = 0x9E3779B9u);
+};
+
+/**
+ * @brief Function table for one instruction set
+ *
+ * Complex buffers are interleaved (re, im) pairs, matching std::complex<float>.
+ * A table may reuse lower-level entries where a wider variant gains nothing.
+ */
+struct KernelTable {
+    Level level;
+
+    // Analysis
+    float (*calculateRMS)(const float* buffer, size_t size);
+    float (*calculatePeak)(const float* buffer, size_t size);
+
+    // Mixing
+    void (*mixBuffers)(float* destination, const float* source, size_t size, float gain);
+    void (*applyGainWithFade)(float* buffer, size_t size, float startGain, float endGain);
+    void (*weightedSum3)(float* destination, const float* a, const float* b, const float* c,
+                         float weightA, float weightB, float weightC, size_t size);
+    void (*monoToStereo)(const float* input, float* output, size_t frames);
+
+    // Convolution
+    void (*applyFIR4)(float* destination, const float* source, const float* coefficients, size_t size);
+    float (*dotProduct)(const float* a, const float* b, size_t size);
+    void (*complexMultiply)(const float* a, const float* b, float* result, size_t bins);
+    void (*complexMultiplyAccumulate)(const float* a, const float* b, float* accumulator, size_t bins);
+
+    // Sample format conversion (float full scale is +/-1.0, rounding to nearest)
+    void (*convertInt16ToFloat)(const int16_t* input, float* output, size_t samples);
+    void (*convertFloatToInt16)(const float* input, int16_t* output, size_t samples);
+    void (*convertInt32ToFloat)(const int32_t* input, float* output, size_t samples);
+    void (*convertFloatToInt32)(const float* input, int32_t* output, size_t samples);
+    void (*convertInt24ToFloat)(const uint8_t* input, float* output, size_t samples);     // Packed little-endian, 3 bytes
+    void (*convertFloatToInt24)(const float* input, uint8_t* output, size_t samples);
+
+    // Float to integer with +/-1 LSB triangular dither added before rounding
+    void (*convertFloatToInt16Dithered)(const float* input, int16_t* output, size_t samples, DitherState& dither);
+    void (*convertFloatToInt24Dithered)(const float* input, uint8_t* output, size_t samples, DitherState& dither);
+};
+
+// Per-instruction-set tables; nullptr when the variant is not built for this target
+const KernelTable* scalarKernels();
+const KernelTable* sse2Kernels();
+const KernelTable* avx2Kernels();
+const KernelTable* avx512Kernels();
+
+// Highest level both the CPU and the OS (saved register state) support
+Level detectLevel();
+
+// "auto", "avx512", "avx2", "sse2" or "scalar"; false for anything else
+bool parseLevel(const std::string& name, Level& level, bool& automatic);
+const char* levelName(Level level);
+
+/**
+ * @brief Select the active kernels
+ * @param requested performance.simdLevel; levels above detectLevel() are capped
+ * @return The level actually selected
+ */
+Level initialize(const std::string& requested);
+
+// Active kernels; the first call without initialize() selects "auto"
+const KernelTable& kernels();
+
+// "rms=avx2 peak=avx2 ..." - which variant each active kernel came from
+std::string describeKernels();
+
+} // namespace simd
+} // namespace vrb
@@ -0,0 +1,457 @@
+// simd_kernels_avx2.cpp - AVX2 + FMA kernels
+// Built with -mavx2 -mfma (/arch:AVX2); only called once detectLevel() confirms support
+
+#include "simd_dispatch.h"
+#include "simd_kernels_common.h"
+
+#if defined(__AVX2__) && (defined(__FMA__) || defined(_MSC_VER))  // MSVC implies FMA with /arch:AVX2
+#include <immintrin.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+
+namespace vrb {
+namespace simd {
+
+#if defined(__AVX2__) && (defined(__FMA__) || defined(_MSC_VER))
+
+namespace {
+
+inline float horizontalSum(__m256 values) {
+    __m128 sum = _mm_add_ps(_mm256_castps256_ps128(values), _mm256_extractf128_ps(values, 1));
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_movehdup_ps(sum));
+    return _mm_cvtss_f32(sum);
+}
+
+inline float horizontalMax(__m256 values) {
+    __m128 max128 = _mm_max_ps(_mm256_castps256_ps128(values), _mm256_extractf128_ps(values, 1));
+    max128 = _mm_max_ps(max128, _mm_shuffle_ps(max128, max128, _MM_SHUFFLE(2, 3, 0, 1)));
+    max128 = _mm_max_ps(max128, _mm_shuffle_ps(max128, max128, _MM_SHUFFLE(1, 0, 3, 2)));
+    return _mm_cvtss_f32(max128);
+}
+
+// Four interleaved complex products: (ar*br - ai*bi, ar*bi + ai*br)
+inline __m256 complexProduct(__m256 a, __m256 b) {
+    const __m256 aReal = _mm256_moveldup_ps(a);
+    const __m256 aImag = _mm256_movehdup_ps(a);
+    const __m256 bSwapped = _mm256_permute_ps(b, _MM_SHUFFLE(2, 3, 0, 1));
+    return _mm256_fmaddsub_ps(aReal, b, _mm256_mul_ps(aImag, bSwapped));
+}
+
+// xorshift32 on all eight dither lanes
+inline __m256i stepDither(__m256i state) {
+    state = _mm256_xor_si256(state, _mm256_slli_epi32(state, 13));
+    state = _mm256_xor_si256(state, _mm256_srli_epi32(state, 17));
+    return _mm256_xor_si256(state, _mm256_slli_epi32(state, 5));
+}
+
+inline __m256 ditherNoise(__m256i random) {
+    const __m256i halves = _mm256_add_epi32(_mm256_and_si256(random, _mm256_set1_epi32(0xFFFF)),
+                                            _mm256_srli_epi32(random, 16));
+    return _mm256_sub_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(halves), _mm256_set1_ps(DITHER_SCALE)), _mm256_set1_ps(1.0f));
+}
+
+// Eight packed 24-bit samples (24 bytes) in the top three bytes of each lane; both loads stay inside them
+inline __m256i loadInt24x8(const uint8_t* p) {
+    const __m256i bytes = _mm256_inserti128_si256(
+        _mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))),
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 8)), 1);
+    const __m256i spread = _mm256_setr_epi8(
+        -1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11,           // Samples 0-3 from bytes 0-11
+        -1, 4, 5, 6, -1, 7, 8, 9, -1, 10, 11, 12, -1, 13, 14, 15);      // Samples 4-7 from bytes 12-23
+    return _mm256_shuffle_epi8(bytes, spread);
+}
+
+// Low 24 bits of eight lanes written as 24 contiguous bytes
+inline void storeInt24x8(uint8_t* p, __m256i values) {
+    const __m256i gather = _mm256_setr_epi8(
+        0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1,
+        0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+    const __m256i packed = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(values, gather),
+                                                       _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(p), _mm256_castsi256_si128(packed));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(p + 16), _mm256_extracti128_si256(packed, 1));
+}
+
+float calculateRMS(const float* buffer, size_t size) {
+    if (size == 0) return 0.0f;
+
+    __m256 sum = _mm256_setzero_ps();
+    const size_t simdSize = size & ~7;
+
+    for (size_t i = 0; i < simdSize; i += 8) {
+        __m256 samples = _mm256_loadu_ps(&buffer[i]);
+        sum = _mm256_fmadd_ps(samples, samples, sum);
+    }
+
+    float result = horizontalSum(sum);
+
+    // Handle remaining elements
+    for (size_t i = simdSize; i < size; ++i) {
+        result += buffer[i] * buffer[i];
+    }
+
+    return std::sqrt(result / size);
+}
+
+float calculatePeak(const float* buffer, size_t size) {
+    __m256 maxValues = _mm256_setzero_ps();
+    const size_t simdSize = size & ~7;
+
+    for (size_t i = 0; i < simdSize; i += 8) {
+        __m256 samples = _mm256_loadu_ps(&buffer[i]);
+        __m256 absSamples = _mm256_andnot_ps(_mm256_set1_ps(-0.0f), samples);
+        maxValues = _mm256_max_ps(maxValues, absSamples);
+    }
+
+    float result = horizontalMax(maxValues);
+
+    // Handle remaining elements
+    for (size_t i = simdSize; i < size; ++i) {
+        result = std::max(result, std::abs(buffer[i]));
+    }
+
+    return result;
+}
+
+void mixBuffers(float* destination, const float* source, size_t size, float gain) {
+    const __m256 gainVector = _mm256_set1_ps(gain);
+    const size_t simdSize = size & ~7;
+
+    for (size_t i = 0; i < simdSize; i += 8) {
+        __m256 dest = _mm256_loadu_ps(&destination[i]);
+        __m256 src = _mm256_loadu_ps(&source[i]);
+        _mm256_storeu_ps(&destination[i], _mm256_fmadd_ps(src, gainVector, dest));
+    }
+
+    // Handle remaining elements
+    for (size_t i = simdSize; i < size; ++i) {
+        destination[i] += source[i] * gain;
+    }
+}
+
+void applyGainWithFade(float* buffer, size_t size, float startGain, float endGain) {
+    if (size == 0) return;
+
+    const float gainStep = fadeStep(size, startGain, endGain);
+    const size_t simdSize = size & ~7;
+    const __m256 lane = _mm256_set_ps(7.0f, 6.0f, 5.0f, 4.0f, 3.0f, 2.0f, 1.0f, 0.0f);
+    const __m256 start = _mm256_set1_ps(startGain);
+    const __m256 step = _mm256_set1_ps(gainStep);
+
+    for (size_t i = 0; i < simdSize; i += 8) {
+        // Gain from the sample index rather than a running sum, so no error accumulates
+        __m256 index = _mm256_add_ps(_mm256_set1_ps(static_cast<float>(i)), lane);
+        __m256 gain = _mm256_fmadd_ps(index, step, start);
+        _mm256_storeu_ps(&buffer[i], _mm256_mul_ps(_mm256_loadu_ps(&buffer[i]), gain));
+    }
+
+    // Handle remaining elements
+    for (size_t i = simdSize; i < size; ++i) {
+        buffer[i] *= startGain + gainStep * static_cast<float>(i);
+    }
+}
+
+void weightedSum3(float* destination, const float* a, const float* b, const float* c,
+                  float weightA, float weightB, float weightC, size_t size) {
+    const __m256 wa = _mm256_set1_ps(weightA);
+    const __m256 wb = _mm256_set1_ps(weightB);
+    const __m256 wc = _mm256_set1_ps(weightC);
+    const size_t simdSize = size & ~7;
+
+    for (size_t i = 0; i < simdSize; i += 8) {
+        __m256 result = _mm256_mul_ps(_mm256_loadu_ps(&a[i]), wa);
+        result = _mm256_fmadd_ps(_mm256_loadu_ps(&b[i]), wb, result);
+        result = _mm256_fmadd_ps(_mm256_loadu_ps(&c[i]), wc, result);
+        _mm256_storeu_ps(&destination[i], result);
+    }
+
+    // Handle remaining elements
+    for (size_t i = simdSize; i < size; ++i) {
+        destination[i] = a[i] * weightA + b[i] * weightB + c[i] * weightC;
+    }
+}
+
+void monoToStereo(const float* input, float* output, size_t frames) {
+    const size_t simdFrames = frames & ~7;  // Process 8 frames at a time
+
+    for (size_t i = 0; i < simdFrames; i += 8) {
+        __m256 mono = _mm256_loadu_ps(&input[i]);
+        // unpack works per 128-bit lane: lo = {0,0,1,1 | 4,4,5,5}, hi = {2,2,3,3 | 6,6,7,7}
+        __m256 lo = _mm256_unpacklo_ps(mono, mono);
+        __m256 hi = _mm256_unpackhi_ps(mono, mono);
+        _mm256_storeu_ps(&output[i * 2], _mm256_permute2f128_ps(lo, hi, 0x20));
+        _mm256_storeu_ps(&output[i * 2 + 8], _mm256_permute2f128_ps(lo, hi, 0x31));
+    }
+
+    // Handle remaining frames
+    for (size_t i = simdFrames; i < frames; ++i) {
+        output[i * 2] = input[i];
+        output[i * 2 + 1] = input[i];
+    }
+}
+
+void applyFIR4(float* destination, const float* source, const float* coefficients, size_t size) {
+    const __m256 c0 = _mm256_set1_ps(coefficients[0]);
+    const __m256 c1 = _mm256_set1_ps(coefficients[1]);
+    const __m256 c2 = _mm256_set1_ps(coefficients[2]);
+    const __m256 c3 = _mm256_set1_ps(coefficients[3]);
+    const size_t simdSize = size & ~7;
+
+    for (size_t i = 0; i < simdSize; i += 8) {
+        __m256 result = _mm256_mul_ps(_mm256_loadu_ps(&source[i]), c0);
+        result = _mm256_fmadd_ps(_mm256_loadu_ps(&source[i + 1]), c1, result);
+        result = _mm256_fmadd_ps(_mm256_loadu_ps(&source[i + 2]), c2, result);
+        result = _mm256_fmadd_ps(_mm256_loadu_ps(&source[i + 3]), c3, result);
+        _mm256_storeu_ps(&destination[i], result);
+    }
+
+    // Handle remaining elements
+    for (size_t i = simdSize; i < size; ++i) {
+        destination[i] = source[i] * coefficients[0] + source[i + 1] * coefficients[1] +
+                         source[i + 2] * coefficients[2] + source[i + 3] * coefficients[3];
+    }
+}
+
+float dotProduct(const float* a, const float* b, size_t size) {
+    __m256 sum0 = _mm256_setzero_ps();
+    __m256 sum1 = _mm256_setzero_ps();
+    const size_t simdSize = size & ~15;
+
+    for (size_t i = 0; i < simdSize; i += 16) {
+        sum0 = _mm256_fmadd_ps(_mm256_loadu_ps(&a[i]), _mm256_loadu_ps(&b[i]), sum0);
+        sum1 = _mm256_fmadd_ps(_mm256_loadu_ps(&a[i + 8]), _mm256_loadu_ps(&b[i + 8]), sum1);
+    }
+
+    float result = horizontalSum(_mm256_add_ps(sum0, sum1));
+
+    // Handle remaining elements
+    for (size_t i = simdSize; i < size; ++i) {
+        result += a[i] * b[i];
+    }
+    return result;
+}
+
+void complexMultiply(const float* a, const float* b, float* result, size_t bins) {
+    const size_t simdBins = bins & ~3;
+
+    for (size_t i = 0; i < simdBins; i += 4) {
+        _mm256_storeu_ps(&result[2 * i], complexProduct(_mm256_loadu_ps(&a[2 * i]), _mm256_loadu_ps(&b[2 * i])));
+    }
+
+    // Handle remaining bins
+    for (size_t i = simdBins; i < bins; ++i) {
+        const float ar = a[2 * i], ai = a[2 * i + 1];
+        const float br = b[2 * i], bi = b[2 * i + 1];
+        result[2 * i] = ar * br - ai * bi;
+        result[2 * i + 1] = ar * bi + ai * br;
+    }
+}
+
+void complexMultiplyAccumulate(const float* a, const float* b, float* accumulator, size_t bins) {
+    const size_t simdBins = bins & ~3;
+
+    for (size_t i = 0; i < simdBins; i += 4) {
+        __m256 product = complexProduct(_mm256_loadu_ps(&a[2 * i]), _mm256_loadu_ps(&b[2 * i]));
+        _mm256_storeu_ps(&accumulator[2 * i], _mm256_add_ps(_mm256_loadu_ps(&accumulator[2 * i]), product));
+    }
+
+    // Handle remaining bins
+    for (size_t i = simdBins; i < bins; ++i) {
+        const float ar = a[2 * i], ai = a[2 * i + 1];
+        const float br = b[2 * i], bi = b[2 * i + 1];
+        accumulator[2 * i] += ar * br - ai * bi;
+        accumulator[2 * i + 1] += ar * bi + ai * br;
+    }
+}
+
+void convertInt16ToFloat(const int16_t* input, float* output, size_t samples) {
+    const size_t simdSamples = samples & ~15;  // Process 16 samples at a time
+    const __m256 scale = _mm256_set1_ps(INT16_TO_FLOAT);
+
+    for (size_t i = 0; i < simdSamples; i += 16) {
+        __m128i int16Data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+        _mm256_storeu_ps(output + i, _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(int16Data)), scale));
+
+        int16Data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i + 8));
+        _mm256_storeu_ps(output + i + 8, _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(int16Data)), scale));
+    }
+
+    // Process remaining samples
+    for (size_t i = simdSamples; i < samples; ++i) {
+        output[i] = static_cast<float>(input[i]) * INT16_TO_FLOAT;
+    }
+}
+
+void convertFloatToInt16(const float* input, int16_t* output, size_t samples) {
+    const size_t simdSamples = samples & ~15;
+    const __m256 scale = _mm256_set1_ps(FLOAT_TO_INT16);
+    const __m256 minVal = _mm256_set1_ps(INT16_MIN_FLOAT);
+    const __m256 maxVal = _mm256_set1_ps(INT16_MAX_FLOAT);
+
+    for (size_t i = 0; i < simdSamples; i += 16) {
+        // Scale and clamp
+        __m256 data1 = _mm256_max_ps(_mm256_min_ps(_mm256_mul_ps(_mm256_loadu_ps(input + i), scale), maxVal), minVal);
+        __m256 data2 = _mm256_max_ps(_mm256_min_ps(_mm256_mul_ps(_mm256_loadu_ps(input + i + 8), scale), maxVal), minVal);
+
+        // Pack to int16; packs works per 128-bit lane, so restore sample order afterwards
+        __m256i packed = _mm256_packs_epi32(_mm256_cvtps_epi32(data1), _mm256_cvtps_epi32(data2));
+        packed = _mm256_permute4x64_epi64(packed, _MM_SHUFFLE(3, 1, 2, 0));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + i), packed);
+    }
+
+    for (size_t i = simdSamples; i < samples; ++i) {
+        output[i] = static_cast<int16_t>(roundToInt(
+            std::clamp(input[i] * FLOAT_TO_INT16, INT16_MIN_FLOAT, INT16_MAX_FLOAT)));
+    }
+}
+
+void convertInt32ToFloat(const int32_t* input, float* output, size_t samples) {
+    const size_t simdSamples = samples & ~7;
+    const __m256 scale = _mm256_set1_ps(INT32_TO_FLOAT);
+
+    for (size_t i = 0; i < simdSamples; i += 8) {
+        __m256i int32Data = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + i));
+        _mm256_storeu_ps(output + i, _mm256_mul_ps(_mm256_cvtepi32_ps(int32Data), scale));
+    }
+
+    for (size_t i = simdSamples; i < samples; ++i) {
+        output[i] = static_cast<float>(input[i]) * INT32_TO_FLOAT;
+    }
+}
+
+void convertFloatToInt32(const float* input, int32_t* output, size_t samples) {
+    const size_t simdSamples = samples & ~7;
+    const __m256 scale = _mm256_set1_ps(FLOAT_TO_INT32);
+    const __m256 minVal = _mm256_set1_ps(INT32_MIN_FLOAT);
+    const __m256 maxVal = _mm256_set1_ps(INT32_MAX_FLOAT);
+
+    for (size_t i = 0; i < simdSamples; i += 8) {
+        __m256 scaled = _mm256_max_ps(_mm256_min_ps(_mm256_mul_ps(_mm256_loadu_ps(input + i), scale), maxVal), minVal);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + i), _mm256_cvtps_epi32(scaled));
+    }
+
+    for (size_t i = simdSamples; i < samples; ++i) {
+        output[i] = roundToInt(std::clamp(input[i] * FLOAT_TO_INT32, INT32_MIN_FLOAT, INT32_MAX_FLOAT));
+    }
+}
+
+void convertInt24ToFloat(const uint8_t* input, float* output, size_t samples) {
+    const size_t simdSamples = samples & ~7;
+    const __m256 scale = _mm256_set1_ps(INT32_TO_FLOAT);
+
+    for (size_t i = 0; i < simdSamples; i += 8) {
+        _mm256_storeu_ps(output + i, _mm256_mul_ps(_mm256_cvtepi32_ps(loadInt24x8(input + 3 * i)), scale));
+    }
+
+    for (size_t i = simdSamples; i < samples; ++i) {
+        output[i] = static_cast<float>(loadInt24(input + 3 * i)) * INT32_TO_FLOAT;
+    }
+}
+
+void convertFloatToInt24(const float* input, uint8_t* output, size_t samples) {
+    const size_t simdSamples = samples & ~7;
+    const __m256 scale = _mm256_set1_ps(FLOAT_TO_INT24);
+    const __m256 minVal = _mm256_set1_ps(INT24_MIN_FLOAT);
+    const __m256 maxVal = _mm256_set1_ps(INT24_MAX_FLOAT);
+
+    for (size_t i = 0; i < simdSamples; i += 8) {
+        __m256 scaled = _mm256_max_ps(_mm256_min_ps(_mm256_mul_ps(_mm256_loadu_ps(input + i), scale), maxVal), minVal);
+        storeInt24x8(output + 3 * i, _mm256_cvtps_epi32(scaled));
+    }
+
+    for (size_t i = simdSamples; i < samples; ++i) {
+        storeInt24(output + 3 * i,
+                   roundToInt(std::clamp(input[i] * FLOAT_TO_INT24, INT24_MIN_FLOAT, INT24_MAX_FLOAT)));
+    }
+}
+
+void convertFloatToInt16Dithered(const float* input, int16_t* output, size_t samples, DitherState& dither) {
+    const size_t simdSamples = samples & ~15;  // Two steps of the eight lanes per iteration
+    const __m256 scale = _mm256_set1_ps(FLOAT_TO_INT16);
+    const __m256 minVal = _mm256_set1_ps(INT16_MIN_FLOAT);
+    const __m256 maxVal = _mm256_set1_ps(INT16_MAX_FLOAT);
+    __m256i state = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dither.lanes));
+
+    for (size_t i = 0; i < simdSamples; i += 16) {
+        state = stepDither(state);
+        __m256 data1 = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(input + i), scale), ditherNoise(state));
+        state = stepDither(state);
+        __m256 data2 = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(input + i + 8), scale), ditherNoise(state));
+        data1 = _mm256_max_ps(_mm256_min_ps(data1, maxVal), minVal);
+        data2 = _mm256_max_ps(_mm256_min_ps(data2, maxVal), minVal);
+
+        __m256i packed = _mm256_packs_epi32(_mm256_cvtps_epi32(data1), _mm256_cvtps_epi32(data2));
+        packed = _mm256_permute4x64_epi64(packed, _MM_SHUFFLE(3, 1, 2, 0));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + i), packed);
+    }
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dither.lanes), state);
+
+    for (size_t i = simdSamples; i < samples; ++i) {
+        const float noise = triangularDither(nextDither(dither.lanes[i % DitherState::LANES]));
+        output[i] = static_cast<int16_t>(roundToInt(
+            std::clamp(input[i] * FLOAT_TO_INT16 + noise, INT16_MIN_FLOAT, INT16_MAX_FLOAT)));
+    }
+}
+
+void convertFloatToInt24Dithered(const float* input, uint8_t* output, size_t samples, DitherState& dither) {
+    const size_t simdSamples = samples & ~7;
+    const __m256 scale = _mm256_set1_ps(FLOAT_TO_INT24);
+    const __m256 minVal = _mm256_set1_ps(INT24_MIN_FLOAT);
+    const __m256 maxVal = _mm256_set1_ps(INT24_MAX_FLOAT);
+    __m256i state = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dither.lanes));
+
+    for (size_t i = 0; i < simdSamples; i += 8) {
+        state = stepDither(state);
+        __m256 scaled = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(input + i), scale), ditherNoise(state));
+        scaled = _mm256_max_ps(_mm256_min_ps(scaled, maxVal), minVal);
+        storeInt24x8(output + 3 * i, _mm256_cvtps_epi32(scaled));
+    }
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dither.lanes), state);
+
+    for (size_t i = simdSamples; i < samples; ++i) {
+        const float noise = triangularDither(nextDither(dither.lanes[i % DitherState::LANES]));
+        storeInt24(output + 3 * i,
+                   roundToInt(std::clamp(input[i] * FLOAT_TO_INT24 + noise, INT24_MIN_FLOAT, INT24_MAX_FLOAT)));
+    }
+}
+
+} // anonymous namespace
+
+const KernelTable* avx2Kernels() {
+    static const KernelTable table = {
+        Level::AVX2,
+        calculateRMS,
+        calculatePeak,
+        mixBuffers,
+        applyGainWithFade,
+        weightedSum3,
+        monoToStereo,
+        applyFIR4,
+        dotProduct,
+        complexMultiply,
+        complexMultiplyAccumulate,
+        convertInt16ToFloat,
+        convertFloatToInt16,
+        convertInt32ToFloat,
+        convertFloatToInt32,
+        convertInt24ToFloat,
+        convertFloatToInt24,
+        convertFloatToInt16Dithered,
+        convertFloatToInt24Dithered,
+    };
+    return &table;
+}
+
+#else
+
+const KernelTable* avx2Kernels() {
+    return nullptr;
+}
+
+#endif
+
+} // namespace simd
+} // namespace vrb
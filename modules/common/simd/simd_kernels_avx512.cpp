@@ -0,0 +1,273 @@
+// simd_kernels_avx512.cpp - AVX-512F kernels
+// Built with -mavx512f (/arch:AVX512); kernels that gain nothing from 16 lanes reuse AVX2
+
+#include "simd_dispatch.h"
+#include "simd_kernels_common.h"
+
+#if defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+
+namespace vrb {
+namespace simd {
+
+#if defined(__AVX512F__)
+
+namespace {
+
+// Sixteen interleaved complex products: (ar*br - ai*bi, ar*bi + ai*br)
+inline __m512 complexProduct(__m512 a, __m512 b) {
+    const __m512 aReal = _mm512_moveldup_ps(a);
+    const __m512 aImag = _mm512_movehdup_ps(a);
+    const __m512 bSwapped = _mm512_permute_ps(b, _MM_SHUFFLE(2, 3, 0, 1));
+    return _mm512_fmaddsub_ps(aReal, b, _mm512_mul_ps(aImag, bSwapped));
+}
+
+float calculateRMS(const float* buffer, size_t size) {
+    if (size == 0) return 0.0f;
+
+    __m512 sum = _mm512_setzero_ps();
+    const size_t simdSize = size & ~15;
+
+    for (size_t i = 0; i < simdSize; i += 16) {
+        __m512 samples = _mm512_loadu_ps(&buffer[i]);
+        sum = _mm512_fmadd_ps(samples, samples, sum);
+    }
+
+    float result = _mm512_reduce_add_ps(sum);
+
+    // Handle remaining elements
+    for (size_t i = simdSize; i < size; ++i) {
+        result += buffer[i] * buffer[i];
+    }
+
+    return std::sqrt(result / size);
+}
+
+float calculatePeak(const float* buffer, size_t size) {
+    __m512 maxValues = _mm512_setzero_ps();
+    const size_t simdSize = size & ~15;
+
+    for (size_t i = 0; i < simdSize; i += 16) {
+        maxValues = _mm512_max_ps(maxValues, _mm512_abs_ps(_mm512_loadu_ps(&buffer[i])));
+    }
+
+    float result = _mm512_reduce_max_ps(maxValues);
+
+    // Handle remaining elements
+    for (size_t i = simdSize; i < size; ++i) {
+        result = std::max(result, std::abs(buffer[i]));
+    }
+
+    return result;
+}
+
+void mixBuffers(float* destination, const float* source, size_t size, float gain) {
+    const __m512 gainVector = _mm512_set1_ps(gain);
+    const size_t simdSize = size & ~15;
+
+    for (size_t i = 0; i < simdSize; i += 16) {
+        __m512 dest = _mm512_loadu_ps(&destination[i]);
+        __m512 src = _mm512_loadu_ps(&source[i]);
+        _mm512_storeu_ps(&destination[i], _mm512_fmadd_ps(src, gainVector, dest));
+    }
+
+    // Handle remaining elements
+    for (size_t i = simdSize; i < size; ++i) {
+        destination[i] += source[i] * gain;
+    }
+}
+
+void weightedSum3(float* destination, const float* a, const float* b, const float* c,
+                  float weightA, float weightB, float weightC, size_t size) {
+    const __m512 wa = _mm512_set1_ps(weightA);
+    const __m512 wb = _mm512_set1_ps(weightB);
+    const __m512 wc = _mm512_set1_ps(weightC);
+    const size_t simdSize = size & ~15;
+
+    for (size_t i = 0; i < simdSize; i += 16) {
+        __m512 result = _mm512_mul_ps(_mm512_loadu_ps(&a[i]), wa);
+        result = _mm512_fmadd_ps(_mm512_loadu_ps(&b[i]), wb, result);
+        result = _mm512_fmadd_ps(_mm512_loadu_ps(&c[i]), wc, result);
+        _mm512_storeu_ps(&destination[i], result);
+    }
+
+    // Handle remaining elements
+    for (size_t i = simdSize; i < size; ++i) {
+        destination[i] = a[i] * weightA + b[i] * weightB + c[i] * weightC;
+    }
+}
+
+void applyFIR4(float* destination, const float* source, const float* coefficients, size_t size) {
+    const __m512 c0 = _mm512_set1_ps(coefficients[0]);
+    const __m512 c1 = _mm512_set1_ps(coefficients[1]);
+    const __m512 c2 = _mm512_set1_ps(coefficients[2]);
+    const __m512 c3 = _mm512_set1_ps(coefficients[3]);
+    const size_t simdSize = size & ~15;
+
+    for (size_t i = 0; i < simdSize; i += 16) {
+        __m512 result = _mm512_mul_ps(_mm512_loadu_ps(&source[i]), c0);
+        result = _mm512_fmadd_ps(_mm512_loadu_ps(&source[i + 1]), c1, result);
+        result = _mm512_fmadd_ps(_mm512_loadu_ps(&source[i + 2]), c2, result);
+        result = _mm512_fmadd_ps(_mm512_loadu_ps(&source[i + 3]), c3, result);
+        _mm512_storeu_ps(&destination[i], result);
+    }
+
+    // Handle remaining elements
+    for (size_t i = simdSize; i < size; ++i) {
+        destination[i] = source[i] * coefficients[0] + source[i + 1] * coefficients[1] +
+                         source[i + 2] * coefficients[2] + source[i + 3] * coefficients[3];
+    }
+}
+
+float dotProduct(const float* a, const float* b, size_t size) {
+    __m512 sum = _mm512_setzero_ps();
+    const size_t simdSize = size & ~15;
+
+    for (size_t i = 0; i < simdSize; i += 16) {
+        sum = _mm512_fmadd_ps(_mm512_loadu_ps(&a[i]), _mm512_loadu_ps(&b[i]), sum);
+    }
+
+    float result = _mm512_reduce_add_ps(sum);
+
+    // Handle remaining elements
+    for (size_t i = simdSize; i < size; ++i) {
+        result += a[i] * b[i];
+    }
+    return result;
+}
+
+void complexMultiply(const float* a, const float* b, float* result, size_t bins) {
+    const size_t simdBins = bins & ~7;
+
+    for (size_t i = 0; i < simdBins; i += 8) {
+        _mm512_storeu_ps(&result[2 * i], complexProduct(_mm512_loadu_ps(&a[2 * i]), _mm512_loadu_ps(&b[2 * i])));
+    }
+
+    // Handle remaining bins
+    for (size_t i = simdBins; i < bins; ++i) {
+        const float ar = a[2 * i], ai = a[2 * i + 1];
+        const float br = b[2 * i], bi = b[2 * i + 1];
+        result[2 * i] = ar * br - ai * bi;
+        result[2 * i + 1] = ar * bi + ai * br;
+    }
+}
+
+void complexMultiplyAccumulate(const float* a, const float* b, float* accumulator, size_t bins) {
+    const size_t simdBins = bins & ~7;
+
+    for (size_t i = 0; i < simdBins; i += 8) {
+        __m512 product = complexProduct(_mm512_loadu_ps(&a[2 * i]), _mm512_loadu_ps(&b[2 * i]));
+        _mm512_storeu_ps(&accumulator[2 * i], _mm512_add_ps(_mm512_loadu_ps(&accumulator[2 * i]), product));
+    }
+
+    // Handle remaining bins
+    for (size_t i = simdBins; i < bins; ++i) {
+        const float ar = a[2 * i], ai = a[2 * i + 1];
+        const float br = b[2 * i], bi = b[2 * i + 1];
+        accumulator[2 * i] += ar * br - ai * bi;
+        accumulator[2 * i + 1] += ar * bi + ai * br;
+    }
+}
+
+void convertInt16ToFloat(const int16_t* input, float* output, size_t samples) {
+    const size_t simdSamples = samples & ~15;
+    const __m512 scale = _mm512_set1_ps(INT16_TO_FLOAT);
+
+    for (size_t i = 0; i < simdSamples; i += 16) {
+        __m256i int16Data = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + i));
+        _mm512_storeu_ps(output + i, _mm512_mul_ps(_mm512_cvtepi32_ps(_mm512_cvtepi16_epi32(int16Data)), scale));
+    }
+
+    for (size_t i = simdSamples; i < samples; ++i) {
+        output[i] = static_cast<float>(input[i]) * INT16_TO_FLOAT;
+    }
+}
+
+void convertFloatToInt16(const float* input, int16_t* output, size_t samples) {
+    const size_t simdSamples = samples & ~15;
+    const __m512 scale = _mm512_set1_ps(FLOAT_TO_INT16);
+    const __m512 minVal = _mm512_set1_ps(INT16_MIN_FLOAT);
+    const __m512 maxVal = _mm512_set1_ps(INT16_MAX_FLOAT);
+
+    for (size_t i = 0; i < simdSamples; i += 16) {
+        __m512 scaled = _mm512_max_ps(_mm512_min_ps(_mm512_mul_ps(_mm512_loadu_ps(input + i), scale), maxVal), minVal);
+        // Narrowing with saturation keeps sample order, unlike the AVX2 pack
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + i), _mm512_cvtsepi32_epi16(_mm512_cvtps_epi32(scaled)));
+    }
+
+    for (size_t i = simdSamples; i < samples; ++i) {
+        output[i] = static_cast<int16_t>(roundToInt(
+            std::clamp(input[i] * FLOAT_TO_INT16, INT16_MIN_FLOAT, INT16_MAX_FLOAT)));
+    }
+}
+
+void convertInt32ToFloat(const int32_t* input, float* output, size_t samples) {
+    const size_t simdSamples = samples & ~15;
+    const __m512 scale = _mm512_set1_ps(INT32_TO_FLOAT);
+
+    for (size_t i = 0; i < simdSamples; i += 16) {
+        __m512i int32Data = _mm512_loadu_si512(input + i);
+        _mm512_storeu_ps(output + i, _mm512_mul_ps(_mm512_cvtepi32_ps(int32Data), scale));
+    }
+
+    for (size_t i = simdSamples; i < samples; ++i) {
+        output[i] = static_cast<float>(input[i]) * INT32_TO_FLOAT;
+    }
+}
+
+void convertFloatToInt32(const float* input, int32_t* output, size_t samples) {
+    const size_t simdSamples = samples & ~15;
+    const __m512 scale = _mm512_set1_ps(FLOAT_TO_INT32);
+    const __m512 minVal = _mm512_set1_ps(INT32_MIN_FLOAT);
+    const __m512 maxVal = _mm512_set1_ps(INT32_MAX_FLOAT);
+
+    for (size_t i = 0; i < simdSamples; i += 16) {
+        __m512 scaled = _mm512_max_ps(_mm512_min_ps(_mm512_mul_ps(_mm512_loadu_ps(input + i), scale), maxVal), minVal);
+        _mm512_storeu_si512(output + i, _mm512_cvtps_epi32(scaled));
+    }
+
+    for (size_t i = simdSamples; i < samples; ++i) {
+        output[i] = roundToInt(std::clamp(input[i] * FLOAT_TO_INT32, INT32_MIN_FLOAT, INT32_MAX_FLOAT));
+    }
+}
+
+} // anonymous namespace
+
+const KernelTable* avx512Kernels() {
+    static const KernelTable table = [] {
+        // AVX-512 implies AVX2 + FMA, so the AVX2 table is always built alongside this one
+        // The packed 24-bit and dithered conversions stay on AVX2: byte shuffles across 512 bits
+        // need VBMI, and the eight dither lanes are one AVX2 register
+        KernelTable t = *avx2Kernels();
+        t.level = Level::AVX512;
+        t.calculateRMS = calculateRMS;
+        t.calculatePeak = calculatePeak;
+        t.mixBuffers = mixBuffers;
+        t.weightedSum3 = weightedSum3;
+        t.applyFIR4 = applyFIR4;
+        t.dotProduct = dotProduct;
+        t.complexMultiply = complexMultiply;
+        t.complexMultiplyAccumulate = complexMultiplyAccumulate;
+        t.convertInt16ToFloat = convertInt16ToFloat;
+        t.convertFloatToInt16 = convertFloatToInt16;
+        t.convertInt32ToFloat = convertInt32ToFloat;
+        t.convertFloatToInt32 = convertFloatToInt32;
+        return t;
+    }();
+    return &table;
+}
+
+#else
+
+const KernelTable* avx512Kernels() {
+    return nullptr;
+}
+
+#endif
+
+} // namespace simd
+} // namespace vrb
@@ -0,0 +1,67 @@
+// simd_kernels_common.h - Constants shared by every kernel variant
+// Internal to the simd_kernels_*.cpp translation units. Helpers here are static: each kernel file is
+// built for a different instruction set, and a plain inline function would be merged by the linker
+// into whichever copy it saw first, possibly an AVX one called from the scalar kernels.
+
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace vrb {
+namespace simd {
+
+constexpr float INT16_TO_FLOAT = 1.0f / 32768.0f;
+constexpr float FLOAT_TO_INT16 = 32767.0f;
+constexpr float INT16_MIN_FLOAT = -32768.0f;
+constexpr float INT16_MAX_FLOAT = 32767.0f;
+
+constexpr float INT24_TO_FLOAT = 1.0f / 8388608.0f;
+constexpr float FLOAT_TO_INT24 = 8388607.0f;
+constexpr float INT24_MIN_FLOAT = -8388608.0f;
+constexpr float INT24_MAX_FLOAT = 8388607.0f;
+
+constexpr float INT32_TO_FLOAT = 1.0f / 2147483648.0f;
+constexpr float FLOAT_TO_INT32 = 2147483647.0f;   // Rounds to 2^31 in float
+constexpr float INT32_MIN_FLOAT = -2147483648.0f;
+constexpr float INT32_MAX_FLOAT = 2147483520.0f;  // Largest float below 2^31; 2^31 itself would wrap
+
+// Gain increment per sample for a fade that lands exactly on endGain
+static inline float fadeStep(size_t size, float startGain, float endGain) {
+    return (size > 1) ? (endGain - startGain) / static_cast<float>(size - 1) : 0.0f;
+}
+
+// Packed 24-bit sample at p, placed in the top three bytes of an int32 (so INT32_TO_FLOAT scales it)
+static inline int32_t loadInt24(const uint8_t* p) {
+    return static_cast<int32_t>(static_cast<uint32_t>(p[0]) << 8 | static_cast<uint32_t>(p[1]) << 16 |
+                                static_cast<uint32_t>(p[2]) << 24);
+}
+
+static inline void storeInt24(uint8_t* p, int32_t value) {
+    p[0] = static_cast<uint8_t>(value);
+    p[1] = static_cast<uint8_t>(value >> 8);
+    p[2] = static_cast<uint8_t>(value >> 16);
+}
+
+// One xorshift32 step
+static inline uint32_t nextDither(uint32_t& state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+// Sum of the two 16-bit halves as two uniform variables: triangular over (-1, 1) LSB, computed exactly
+constexpr float DITHER_SCALE = 1.0f / 65536.0f;
+static inline float triangularDither(uint32_t random) {
+    return static_cast<float>((random & 0xFFFFu) + (random >> 16)) * DITHER_SCALE - 1.0f;
+}
+
+// Round to nearest even, as the vector conversion instructions do
+static inline int32_t roundToInt(float value) {
+    return static_cast<int32_t>(std::lrintf(value));
+}
+
+} // namespace simd
+} // namespace vrb
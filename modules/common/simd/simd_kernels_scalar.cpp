@@ -0,0 +1,177 @@
+// simd_kernels_scalar.cpp - Portable reference kernels
+// Every other variant must produce the same results (up to float summation order)
+
+#include "simd_dispatch.h"
+#include "simd_kernels_common.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace vrb {
+namespace simd {
+
+namespace {
+
+float calculateRMS(const float* buffer, size_t size) {
+    if (size == 0) return 0.0f;
+
+    float sum = 0.0f;
+    for (size_t i = 0; i < size; ++i) {
+        sum += buffer[i] * buffer[i];
+    }
+    return std::sqrt(sum / size);
+}
+
+float calculatePeak(const float* buffer, size_t size) {
+    float maxVal = 0.0f;
+    for (size_t i = 0; i < size; ++i) {
+        maxVal = std::max(maxVal, std::abs(buffer[i]));
+    }
+    return maxVal;
+}
+
+void mixBuffers(float* destination, const float* source, size_t size, float gain) {
+    for (size_t i = 0; i < size; ++i) {
+        destination[i] += source[i] * gain;
+    }
+}
+
+void applyGainWithFade(float* buffer, size_t size, float startGain, float endGain) {
+    if (size == 0) return;
+
+    const float gainStep = fadeStep(size, startGain, endGain);
+    for (size_t i = 0; i < size; ++i) {
+        buffer[i] *= startGain + gainStep * static_cast<float>(i);
+    }
+}
+
+void weightedSum3(float* destination, const float* a, const float* b, const float* c,
+                  float weightA, float weightB, float weightC, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        destination[i] = a[i] * weightA + b[i] * weightB + c[i] * weightC;
+    }
+}
+
+void monoToStereo(const float* input, float* output, size_t frames) {
+    for (size_t i = 0; i < frames; ++i) {
+        output[i * 2] = input[i];
+        output[i * 2 + 1] = input[i];
+    }
+}
+
+void applyFIR4(float* destination, const float* source, const float* coefficients, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        destination[i] = source[i] * coefficients[0] + source[i + 1] * coefficients[1] +
+                         source[i + 2] * coefficients[2] + source[i + 3] * coefficients[3];
+    }
+}
+
+float dotProduct(const float* a, const float* b, size_t size) {
+    float sum = 0.0f;
+    for (size_t i = 0; i < size; ++i) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+void complexMultiply(const float* a, const float* b, float* result, size_t bins) {
+    for (size_t i = 0; i < bins; ++i) {
+        const float ar = a[2 * i], ai = a[2 * i + 1];
+        const float br = b[2 * i], bi = b[2 * i + 1];
+        result[2 * i] = ar * br - ai * bi;
+        result[2 * i + 1] = ar * bi + ai * br;
+    }
+}
+
+void complexMultiplyAccumulate(const float* a, const float* b, float* accumulator, size_t bins) {
+    for (size_t i = 0; i < bins; ++i) {
+        const float ar = a[2 * i], ai = a[2 * i + 1];
+        const float br = b[2 * i], bi = b[2 * i + 1];
+        accumulator[2 * i] += ar * br - ai * bi;
+        accumulator[2 * i + 1] += ar * bi + ai * br;
+    }
+}
+
+void convertInt16ToFloat(const int16_t* input, float* output, size_t samples) {
+    for (size_t i = 0; i < samples; ++i) {
+        output[i] = static_cast<float>(input[i]) * INT16_TO_FLOAT;
+    }
+}
+
+void convertFloatToInt16(const float* input, int16_t* output, size_t samples) {
+    for (size_t i = 0; i < samples; ++i) {
+        output[i] = static_cast<int16_t>(roundToInt(
+            std::clamp(input[i] * FLOAT_TO_INT16, INT16_MIN_FLOAT, INT16_MAX_FLOAT)));
+    }
+}
+
+void convertInt32ToFloat(const int32_t* input, float* output, size_t samples) {
+    for (size_t i = 0; i < samples; ++i) {
+        output[i] = static_cast<float>(input[i]) * INT32_TO_FLOAT;
+    }
+}
+
+void convertFloatToInt32(const float* input, int32_t* output, size_t samples) {
+    for (size_t i = 0; i < samples; ++i) {
+        output[i] = roundToInt(std::clamp(input[i] * FLOAT_TO_INT32, INT32_MIN_FLOAT, INT32_MAX_FLOAT));
+    }
+}
+
+void convertInt24ToFloat(const uint8_t* input, float* output, size_t samples) {
+    for (size_t i = 0; i < samples; ++i) {
+        output[i] = static_cast<float>(loadInt24(input + 3 * i)) * INT32_TO_FLOAT;
+    }
+}
+
+void convertFloatToInt24(const float* input, uint8_t* output, size_t samples) {
+    for (size_t i = 0; i < samples; ++i) {
+        storeInt24(output + 3 * i,
+                   roundToInt(std::clamp(input[i] * FLOAT_TO_INT24, INT24_MIN_FLOAT, INT24_MAX_FLOAT)));
+    }
+}
+
+void convertFloatToInt16Dithered(const float* input, int16_t* output, size_t samples, DitherState& dither) {
+    for (size_t i = 0; i < samples; ++i) {
+        const float noise = triangularDither(nextDither(dither.lanes[i % DitherState::LANES]));
+        output[i] = static_cast<int16_t>(roundToInt(
+            std::clamp(input[i] * FLOAT_TO_INT16 + noise, INT16_MIN_FLOAT, INT16_MAX_FLOAT)));
+    }
+}
+
+void convertFloatToInt24Dithered(const float* input, uint8_t* output, size_t samples, DitherState& dither) {
+    for (size_t i = 0; i < samples; ++i) {
+        const float noise = triangularDither(nextDither(dither.lanes[i % DitherState::LANES]));
+        storeInt24(output + 3 * i,
+                   roundToInt(std::clamp(input[i] * FLOAT_TO_INT24 + noise, INT24_MIN_FLOAT, INT24_MAX_FLOAT)));
+    }
+}
+
+} // anonymous namespace
+
+const KernelTable* scalarKernels() {
+    static const KernelTable table = {
+        Level::Scalar,
+        calculateRMS,
+        calculatePeak,
+        mixBuffers,
+        applyGainWithFade,
+        weightedSum3,
+        monoToStereo,
+        applyFIR4,
+        dotProduct,
+        complexMultiply,
+        complexMultiplyAccumulate,
+        convertInt16ToFloat,
+        convertFloatToInt16,
+        convertInt32ToFloat,
+        convertFloatToInt32,
+        convertInt24ToFloat,
+        convertFloatToInt24,
+        convertFloatToInt16Dithered,
+        convertFloatToInt24Dithered,
+    };
+    return &table;
+}
+
+} // namespace simd
+} // namespace vrb
@@ -0,0 +1,457 @@
+// simd_kernels_sse2.cpp - SSE2 kernels (x86-64 baseline, no SSE3 horizontal adds)
+
+#include "simd_dispatch.h"
+#include "simd_kernels_common.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define VRB_SIMD_X86 1
+#include <emmintrin.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace vrb {
+namespace simd {
+
+#ifdef VRB_SIMD_X86
+
+namespace {
+
+inline float horizontalSum(__m128 values) {
+    values = _mm_add_ps(values, _mm_shuffle_ps(values, values, _MM_SHUFFLE(2, 3, 0, 1)));
+    values = _mm_add_ps(values, _mm_shuffle_ps(values, values, _MM_SHUFFLE(1, 0, 3, 2)));
+    return _mm_cvtss_f32(values);
+}
+
+inline float horizontalMax(__m128 values) {
+    values = _mm_max_ps(values, _mm_shuffle_ps(values, values, _MM_SHUFFLE(2, 3, 0, 1)));
+    values = _mm_max_ps(values, _mm_shuffle_ps(values, values, _MM_SHUFFLE(1, 0, 3, 2)));
+    return _mm_cvtss_f32(values);
+}
+
+// Two interleaved complex products: (ar*br - ai*bi, ar*bi + ai*br)
+inline __m128 complexProduct(__m128 a, __m128 b) {
+    const __m128 aReal = _mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 2, 0, 0));
+    const __m128 aImag = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 3, 1, 1));
+    const __m128 bSwapped = _mm_shuffle_ps(b, b, _MM_SHUFFLE(2, 3, 0, 1));
+    const __m128 signs = _mm_set_ps(0.0f, -0.0f, 0.0f, -0.0f);
+    return _mm_add_ps(_mm_mul_ps(aReal, b), _mm_xor_ps(_mm_mul_ps(aImag, bSwapped), signs));
+}
+
+// xorshift32 on four dither lanes
+inline __m128i stepDither(__m128i state) {
+    state = _mm_xor_si128(state, _mm_slli_epi32(state, 13));
+    state = _mm_xor_si128(state, _mm_srli_epi32(state, 17));
+    return _mm_xor_si128(state, _mm_slli_epi32(state, 5));
+}
+
+inline __m128 ditherNoise(__m128i random) {
+    const __m128i halves = _mm_add_epi32(_mm_and_si128(random, _mm_set1_epi32(0xFFFF)), _mm_srli_epi32(random, 16));
+    return _mm_sub_ps(_mm_mul_ps(_mm_cvtepi32_ps(halves), _mm_set1_ps(DITHER_SCALE)), _mm_set1_ps(1.0f));
+}
+
+inline uint32_t loadUnaligned32(const uint8_t* p) {
+    uint32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+// Four packed 24-bit samples (12 bytes) in the top three bytes of each lane, without reading past them
+inline __m128i loadInt24x4(const uint8_t* p) {
+    return _mm_setr_epi32(static_cast<int32_t>(loadUnaligned32(p) << 8),
+                          static_cast<int32_t>(loadUnaligned32(p + 3) << 8),
+                          static_cast<int32_t>(loadUnaligned32(p + 6) << 8),
+                          static_cast<int32_t>(loadUnaligned32(p + 8) & 0xFFFFFF00u));
+}
+
+// Low 24 bits of four lanes written as 12 contiguous bytes
+inline void storeInt24x4(uint8_t* p, __m128i values) {
+    const __m128i evens = _mm_and_si128(values, _mm_set_epi32(0, 0x00FFFFFF, 0, 0x00FFFFFF));
+    const __m128i odds = _mm_srli_epi64(_mm_and_si128(values, _mm_set_epi32(0x00FFFFFF, 0, 0x00FFFFFF, 0)), 8);
+    const __m128i pairs = _mm_or_si128(evens, odds);  // Six bytes at the bottom of each 64-bit half
+    const __m128i packed = _mm_or_si128(_mm_move_epi64(pairs), _mm_slli_si128(_mm_unpackhi_epi64(pairs, pairs), 6));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(p), packed);
+    const uint32_t tail = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_srli_si128(packed, 8)));
+    std::memcpy(p + 8, &tail, sizeof(tail));
+}
+
+float calculateRMS(const float* buffer, size_t size) {
+    if (size == 0) return 0.0f;
+
+    __m128 sum = _mm_setzero_ps();
+    const size_t simdSize = size & ~3;
+
+    for (size_t i = 0; i < simdSize; i += 4) {
+        __m128 samples = _mm_loadu_ps(&buffer[i]);
+        sum = _mm_add_ps(sum, _mm_mul_ps(samples, samples));
+    }
+
+    float result = horizontalSum(sum);
+
+    // Handle remaining elements
+    for (size_t i = simdSize; i < size; ++i) {
+        result += buffer[i] * buffer[i];
+    }
+
+    return std::sqrt(result / size);
+}
+
+float calculatePeak(const float* buffer, size_t size) {
+    __m128 maxValues = _mm_setzero_ps();
+    const size_t simdSize = size & ~3;
+
+    for (size_t i = 0; i < simdSize; i += 4) {
+        __m128 samples = _mm_loadu_ps(&buffer[i]);
+        __m128 absSamples = _mm_andnot_ps(_mm_set1_ps(-0.0f), samples);
+        maxValues = _mm_max_ps(maxValues, absSamples);
+    }
+
+    float result = horizontalMax(maxValues);
+
+    // Handle remaining elements
+    for (size_t i = simdSize; i < size; ++i) {
+        result = std::max(result, std::abs(buffer[i]));
+    }
+
+    return result;
+}
+
+void mixBuffers(float* destination, const float* source, size_t size, float gain) {
+    const __m128 gainVector = _mm_set1_ps(gain);
+    const size_t simdSize = size & ~3;
+
+    for (size_t i = 0; i < simdSize; i += 4) {
+        __m128 dest = _mm_loadu_ps(&destination[i]);
+        __m128 src = _mm_loadu_ps(&source[i]);
+        _mm_storeu_ps(&destination[i], _mm_add_ps(dest, _mm_mul_ps(src, gainVector)));
+    }
+
+    // Handle remaining elements
+    for (size_t i = simdSize; i < size; ++i) {
+        destination[i] += source[i] * gain;
+    }
+}
+
+void applyGainWithFade(float* buffer, size_t size, float startGain, float endGain) {
+    if (size == 0) return;
+
+    const float gainStep = fadeStep(size, startGain, endGain);
+    const size_t simdSize = size & ~3;
+    const __m128 lane = _mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f);
+
+    for (size_t i = 0; i < simdSize; i += 4) {
+        // Gain from the sample index rather than a running sum, so no error accumulates
+        __m128 index = _mm_add_ps(_mm_set1_ps(static_cast<float>(i)), lane);
+        __m128 gain = _mm_add_ps(_mm_set1_ps(startGain), _mm_mul_ps(index, _mm_set1_ps(gainStep)));
+        _mm_storeu_ps(&buffer[i], _mm_mul_ps(_mm_loadu_ps(&buffer[i]), gain));
+    }
+
+    // Handle remaining elements
+    for (size_t i = simdSize; i < size; ++i) {
+        buffer[i] *= startGain + gainStep * static_cast<float>(i);
+    }
+}
+
+void weightedSum3(float* destination, const float* a, const float* b, const float* c,
+                  float weightA, float weightB, float weightC, size_t size) {
+    const __m128 wa = _mm_set1_ps(weightA);
+    const __m128 wb = _mm_set1_ps(weightB);
+    const __m128 wc = _mm_set1_ps(weightC);
+    const size_t simdSize = size & ~3;
+
+    for (size_t i = 0; i < simdSize; i += 4) {
+        __m128 result = _mm_mul_ps(_mm_loadu_ps(&a[i]), wa);
+        result = _mm_add_ps(result, _mm_mul_ps(_mm_loadu_ps(&b[i]), wb));
+        result = _mm_add_ps(result, _mm_mul_ps(_mm_loadu_ps(&c[i]), wc));
+        _mm_storeu_ps(&destination[i], result);
+    }
+
+    // Handle remaining elements
+    for (size_t i = simdSize; i < size; ++i) {
+        destination[i] = a[i] * weightA + b[i] * weightB + c[i] * weightC;
+    }
+}
+
+void monoToStereo(const float* input, float* output, size_t frames) {
+    const size_t simdFrames = frames & ~3;
+
+    for (size_t i = 0; i < simdFrames; i += 4) {
+        __m128 mono = _mm_loadu_ps(&input[i]);
+        _mm_storeu_ps(&output[i * 2], _mm_unpacklo_ps(mono, mono));
+        _mm_storeu_ps(&output[i * 2 + 4], _mm_unpackhi_ps(mono, mono));
+    }
+
+    // Handle remaining frames
+    for (size_t i = simdFrames; i < frames; ++i) {
+        output[i * 2] = input[i];
+        output[i * 2 + 1] = input[i];
+    }
+}
+
+void applyFIR4(float* destination, const float* source, const float* coefficients, size_t size) {
+    const __m128 c0 = _mm_set1_ps(coefficients[0]);
+    const __m128 c1 = _mm_set1_ps(coefficients[1]);
+    const __m128 c2 = _mm_set1_ps(coefficients[2]);
+    const __m128 c3 = _mm_set1_ps(coefficients[3]);
+    const size_t simdSize = size & ~3;
+
+    for (size_t i = 0; i < simdSize; i += 4) {
+        __m128 result = _mm_mul_ps(_mm_loadu_ps(&source[i]), c0);
+        result = _mm_add_ps(result, _mm_mul_ps(_mm_loadu_ps(&source[i + 1]), c1));
+        result = _mm_add_ps(result, _mm_mul_ps(_mm_loadu_ps(&source[i + 2]), c2));
+        result = _mm_add_ps(result, _mm_mul_ps(_mm_loadu_ps(&source[i + 3]), c3));
+        _mm_storeu_ps(&destination[i], result);
+    }
+
+    // Handle remaining elements
+    for (size_t i = simdSize; i < size; ++i) {
+        destination[i] = source[i] * coefficients[0] + source[i + 1] * coefficients[1] +
+                         source[i + 2] * coefficients[2] + source[i + 3] * coefficients[3];
+    }
+}
+
+float dotProduct(const float* a, const float* b, size_t size) {
+    // Two accumulators hide the add latency on the 32- to 64-tap resampler phases
+    __m128 sum0 = _mm_setzero_ps();
+    __m128 sum1 = _mm_setzero_ps();
+    const size_t simdSize = size & ~7;
+
+    for (size_t i = 0; i < simdSize; i += 8) {
+        sum0 = _mm_add_ps(sum0, _mm_mul_ps(_mm_loadu_ps(&a[i]), _mm_loadu_ps(&b[i])));
+        sum1 = _mm_add_ps(sum1, _mm_mul_ps(_mm_loadu_ps(&a[i + 4]), _mm_loadu_ps(&b[i + 4])));
+    }
+
+    float result = horizontalSum(_mm_add_ps(sum0, sum1));
+
+    // Handle remaining elements
+    for (size_t i = simdSize; i < size; ++i) {
+        result += a[i] * b[i];
+    }
+    return result;
+}
+
+void complexMultiply(const float* a, const float* b, float* result, size_t bins) {
+    const size_t simdBins = bins & ~static_cast<size_t>(1);
+
+    for (size_t i = 0; i < simdBins; i += 2) {
+        _mm_storeu_ps(&result[2 * i], complexProduct(_mm_loadu_ps(&a[2 * i]), _mm_loadu_ps(&b[2 * i])));
+    }
+
+    // Handle remaining bin
+    for (size_t i = simdBins; i < bins; ++i) {
+        const float ar = a[2 * i], ai = a[2 * i + 1];
+        const float br = b[2 * i], bi = b[2 * i + 1];
+        result[2 * i] = ar * br - ai * bi;
+        result[2 * i + 1] = ar * bi + ai * br;
+    }
+}
+
+void complexMultiplyAccumulate(const float* a, const float* b, float* accumulator, size_t bins) {
+    const size_t simdBins = bins & ~static_cast<size_t>(1);
+
+    for (size_t i = 0; i < simdBins; i += 2) {
+        __m128 product = complexProduct(_mm_loadu_ps(&a[2 * i]), _mm_loadu_ps(&b[2 * i]));
+        _mm_storeu_ps(&accumulator[2 * i], _mm_add_ps(_mm_loadu_ps(&accumulator[2 * i]), product));
+    }
+
+    // Handle remaining bin
+    for (size_t i = simdBins; i < bins; ++i) {
+        const float ar = a[2 * i], ai = a[2 * i + 1];
+        const float br = b[2 * i], bi = b[2 * i + 1];
+        accumulator[2 * i] += ar * br - ai * bi;
+        accumulator[2 * i + 1] += ar * bi + ai * br;
+    }
+}
+
+void convertInt16ToFloat(const int16_t* input, float* output, size_t samples) {
+    const size_t simdSamples = samples & ~7;  // Process 8 samples at a time
+    const __m128 scale = _mm_set1_ps(INT16_TO_FLOAT);
+
+    for (size_t i = 0; i < simdSamples; i += 8) {
+        __m128i int16Data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+
+        // Sign-extend: place each sample in the high half, then shift back arithmetically
+        __m128i int32Lo = _mm_srai_epi32(_mm_unpacklo_epi16(_mm_setzero_si128(), int16Data), 16);
+        __m128i int32Hi = _mm_srai_epi32(_mm_unpackhi_epi16(_mm_setzero_si128(), int16Data), 16);
+
+        _mm_storeu_ps(output + i, _mm_mul_ps(_mm_cvtepi32_ps(int32Lo), scale));
+        _mm_storeu_ps(output + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(int32Hi), scale));
+    }
+
+    // Process remaining samples
+    for (size_t i = simdSamples; i < samples; ++i) {
+        output[i] = static_cast<float>(input[i]) * INT16_TO_FLOAT;
+    }
+}
+
+void convertFloatToInt16(const float* input, int16_t* output, size_t samples) {
+    const size_t simdSamples = samples & ~7;
+    const __m128 scale = _mm_set1_ps(FLOAT_TO_INT16);
+    const __m128 minVal = _mm_set1_ps(INT16_MIN_FLOAT);
+    const __m128 maxVal = _mm_set1_ps(INT16_MAX_FLOAT);
+
+    for (size_t i = 0; i < simdSamples; i += 8) {
+        __m128 lo = _mm_max_ps(_mm_min_ps(_mm_mul_ps(_mm_loadu_ps(input + i), scale), maxVal), minVal);
+        __m128 hi = _mm_max_ps(_mm_min_ps(_mm_mul_ps(_mm_loadu_ps(input + i + 4), scale), maxVal), minVal);
+        __m128i packed = _mm_packs_epi32(_mm_cvtps_epi32(lo), _mm_cvtps_epi32(hi));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), packed);
+    }
+
+    for (size_t i = simdSamples; i < samples; ++i) {
+        output[i] = static_cast<int16_t>(roundToInt(
+            std::clamp(input[i] * FLOAT_TO_INT16, INT16_MIN_FLOAT, INT16_MAX_FLOAT)));
+    }
+}
+
+void convertInt32ToFloat(const int32_t* input, float* output, size_t samples) {
+    const size_t simdSamples = samples & ~3;
+    const __m128 scale = _mm_set1_ps(INT32_TO_FLOAT);
+
+    for (size_t i = 0; i < simdSamples; i += 4) {
+        __m128i int32Data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+        _mm_storeu_ps(output + i, _mm_mul_ps(_mm_cvtepi32_ps(int32Data), scale));
+    }
+
+    for (size_t i = simdSamples; i < samples; ++i) {
+        output[i] = static_cast<float>(input[i]) * INT32_TO_FLOAT;
+    }
+}
+
+void convertFloatToInt32(const float* input, int32_t* output, size_t samples) {
+    const size_t simdSamples = samples & ~3;
+    const __m128 scale = _mm_set1_ps(FLOAT_TO_INT32);
+    const __m128 minVal = _mm_set1_ps(INT32_MIN_FLOAT);
+    const __m128 maxVal = _mm_set1_ps(INT32_MAX_FLOAT);
+
+    for (size_t i = 0; i < simdSamples; i += 4) {
+        __m128 scaled = _mm_max_ps(_mm_min_ps(_mm_mul_ps(_mm_loadu_ps(input + i), scale), maxVal), minVal);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), _mm_cvtps_epi32(scaled));
+    }
+
+    for (size_t i = simdSamples; i < samples; ++i) {
+        output[i] = roundToInt(std::clamp(input[i] * FLOAT_TO_INT32, INT32_MIN_FLOAT, INT32_MAX_FLOAT));
+    }
+}
+
+void convertInt24ToFloat(const uint8_t* input, float* output, size_t samples) {
+    const size_t simdSamples = samples & ~3;
+    const __m128 scale = _mm_set1_ps(INT32_TO_FLOAT);
+
+    for (size_t i = 0; i < simdSamples; i += 4) {
+        _mm_storeu_ps(output + i, _mm_mul_ps(_mm_cvtepi32_ps(loadInt24x4(input + 3 * i)), scale));
+    }
+
+    for (size_t i = simdSamples; i < samples; ++i) {
+        output[i] = static_cast<float>(loadInt24(input + 3 * i)) * INT32_TO_FLOAT;
+    }
+}
+
+void convertFloatToInt24(const float* input, uint8_t* output, size_t samples) {
+    const size_t simdSamples = samples & ~3;
+    const __m128 scale = _mm_set1_ps(FLOAT_TO_INT24);
+    const __m128 minVal = _mm_set1_ps(INT24_MIN_FLOAT);
+    const __m128 maxVal = _mm_set1_ps(INT24_MAX_FLOAT);
+
+    for (size_t i = 0; i < simdSamples; i += 4) {
+        __m128 scaled = _mm_max_ps(_mm_min_ps(_mm_mul_ps(_mm_loadu_ps(input + i), scale), maxVal), minVal);
+        storeInt24x4(output + 3 * i, _mm_cvtps_epi32(scaled));
+    }
+
+    for (size_t i = simdSamples; i < samples; ++i) {
+        storeInt24(output + 3 * i,
+                   roundToInt(std::clamp(input[i] * FLOAT_TO_INT24, INT24_MIN_FLOAT, INT24_MAX_FLOAT)));
+    }
+}
+
+void convertFloatToInt16Dithered(const float* input, int16_t* output, size_t samples, DitherState& dither) {
+    const size_t simdSamples = samples & ~7;  // One step of all eight lanes per iteration
+    const __m128 scale = _mm_set1_ps(FLOAT_TO_INT16);
+    const __m128 minVal = _mm_set1_ps(INT16_MIN_FLOAT);
+    const __m128 maxVal = _mm_set1_ps(INT16_MAX_FLOAT);
+    __m128i stateLo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dither.lanes));
+    __m128i stateHi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dither.lanes + 4));
+
+    for (size_t i = 0; i < simdSamples; i += 8) {
+        stateLo = stepDither(stateLo);
+        stateHi = stepDither(stateHi);
+        __m128 lo = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(input + i), scale), ditherNoise(stateLo));
+        __m128 hi = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(input + i + 4), scale), ditherNoise(stateHi));
+        lo = _mm_max_ps(_mm_min_ps(lo, maxVal), minVal);
+        hi = _mm_max_ps(_mm_min_ps(hi, maxVal), minVal);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), _mm_packs_epi32(_mm_cvtps_epi32(lo), _mm_cvtps_epi32(hi)));
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dither.lanes), stateLo);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dither.lanes + 4), stateHi);
+
+    for (size_t i = simdSamples; i < samples; ++i) {
+        const float noise = triangularDither(nextDither(dither.lanes[i % DitherState::LANES]));
+        output[i] = static_cast<int16_t>(roundToInt(
+            std::clamp(input[i] * FLOAT_TO_INT16 + noise, INT16_MIN_FLOAT, INT16_MAX_FLOAT)));
+    }
+}
+
+void convertFloatToInt24Dithered(const float* input, uint8_t* output, size_t samples, DitherState& dither) {
+    const size_t simdSamples = samples & ~7;
+    const __m128 scale = _mm_set1_ps(FLOAT_TO_INT24);
+    const __m128 minVal = _mm_set1_ps(INT24_MIN_FLOAT);
+    const __m128 maxVal = _mm_set1_ps(INT24_MAX_FLOAT);
+    __m128i stateLo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dither.lanes));
+    __m128i stateHi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dither.lanes + 4));
+
+    for (size_t i = 0; i < simdSamples; i += 8) {
+        stateLo = stepDither(stateLo);
+        stateHi = stepDither(stateHi);
+        __m128 lo = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(input + i), scale), ditherNoise(stateLo));
+        __m128 hi = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(input + i + 4), scale), ditherNoise(stateHi));
+        storeInt24x4(output + 3 * i, _mm_cvtps_epi32(_mm_max_ps(_mm_min_ps(lo, maxVal), minVal)));
+        storeInt24x4(output + 3 * i + 12, _mm_cvtps_epi32(_mm_max_ps(_mm_min_ps(hi, maxVal), minVal)));
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dither.lanes), stateLo);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dither.lanes + 4), stateHi);
+
+    for (size_t i = simdSamples; i < samples; ++i) {
+        const float noise = triangularDither(nextDither(dither.lanes[i % DitherState::LANES]));
+        storeInt24(output + 3 * i,
+                   roundToInt(std::clamp(input[i] * FLOAT_TO_INT24 + noise, INT24_MIN_FLOAT, INT24_MAX_FLOAT)));
+    }
+}
+
+} // anonymous namespace
+
+const KernelTable* sse2Kernels() {
+    static const KernelTable table = {
+        Level::SSE2,
+        calculateRMS,
+        calculatePeak,
+        mixBuffers,
+        applyGainWithFade,
+        weightedSum3,
+        monoToStereo,
+        applyFIR4,
+        dotProduct,
+        complexMultiply,
+        complexMultiplyAccumulate,
+        convertInt16ToFloat,
+        convertFloatToInt16,
+        convertInt32ToFloat,
+        convertFloatToInt32,
+        convertInt24ToFloat,
+        convertFloatToInt24,
+        convertFloatToInt16Dithered,
+        convertFloatToInt24Dithered,
+    };
+    return &table;
+}
+
+#else
+
+const KernelTable* sse2Kernels() {
+    return nullptr;
+}
+
+#endif
+
+} // namespace simd
+} // namespace vrb
@@ -0,0 +1,128 @@
+// worker_pool.h - Fixed set of threads for fanning out load-time work
+// Not for the audio thread: Run blocks and the pool allocates
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace vrb {
+
+/**
+ * @brief Runs batches of independent tasks on a fixed set of threads
+ *
+ * Run hands out task indices from a shared counter, so uneven tasks balance
+ * themselves, and the calling thread works through the batch too. Threads
+ * live as long as the pool, which lets one load run several batches (decode,
+ * resample, decompose) without respawning them.
+ */
+class WorkerPool {
+public:
+    // threads == 0 uses every hardware thread (the caller counts as one)
+    explicit WorkerPool(size_t threads = 0) {
+        if (threads == 0) {
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        for (size_t i = 1; i < threads; ++i) {
+            m_threads.emplace_back([this] { WorkerLoop(); });
+        }
+    }
+
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_wake.notify_all();
+        for (auto& thread : m_threads) {
+            thread.join();
+        }
+    }
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    size_t GetThreadCount() const { return m_threads.size() + 1; }
+
+    // Calls task(i) once for every i in [0, count) and returns when all calls finished.
+    // Tasks must not throw; report failures through their own results.
+    void Run(size_t count, const std::function<void(size_t)>& task) {
+        if (count == 0) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_task = &task;
+            m_count = count;
+            m_next.store(0);
+            m_pending = count;
+            ++m_generation;
+        }
+        m_wake.notify_all();
+
+        Drain(task, count);
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_done.wait(lock, [this] { return m_pending == 0 && m_active == 0; });
+        m_task = nullptr;
+    }
+
+private:
+    void WorkerLoop() {
+        uint64_t seen = 0;
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true) {
+            m_wake.wait(lock, [&] { return m_stopping || m_generation != seen; });
+            if (m_stopping) {
+                return;
+            }
+            seen = m_generation;
+            if (!m_task) {
+                continue;   // Woke after the batch already completed
+            }
+            const auto& task = *m_task;
+            const size_t count = m_count;
+            ++m_active;
+            lock.unlock();
+            Drain(task, count);
+            lock.lock();
+            if (--m_active == 0 && m_pending == 0) {
+                m_done.notify_all();
+            }
+        }
+    }
+
+    void Drain(const std::function<void(size_t)>& task, size_t count) {
+        size_t finished = 0;
+        for (size_t i = m_next.fetch_add(1); i < count; i = m_next.fetch_add(1)) {
+            task(i);
+            ++finished;
+        }
+        if (finished > 0) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_pending -= finished;
+            if (m_pending == 0) {
+                m_done.notify_all();
+            }
+        }
+    }
+
+    std::vector<std::thread> m_threads;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+    const std::function<void(size_t)>* m_task{nullptr};
+    size_t m_count{0};
+    std::atomic<size_t> m_next{0};
+    size_t m_pending{0};
+    size_t m_active{0};     // Workers inside Drain; Run waits for them before clearing m_task
+    uint64_t m_generation{0};
+    bool m_stopping{false};
+};
+
+} // namespace vrb
@@ -134,6 +134,10 @@ Vec3 AudioRoutingOverlay::GetMicrophonePosition() const {
 }
 
 void AudioRoutingOverlay::StartRecording() {
+    if (m_audioEngine && !m_audioEngine->StartRecording()) {
+        LOG_ERROR("Recording could not be started");
+        return;
+    }
     m_isRecording = true;
     m_virtualMic.isActive = true;
     m_uiState.lastInteraction = std::chrono::steady_clock::now();  // Show UI during recording
@@ -146,7 +150,12 @@ void AudioRoutingOverlay::StopRecording() {
     m_isRecording = false;
     m_virtualMic.isActive = false;
 
-    LOG_INFO("Recording stopped");
+    if (m_audioEngine) {
+        m_audioEngine->StopRecording();
+        LOG_INFO("Recording stopped - saved to {}", m_audioEngine->GetRecordingPath());
+    } else {
+        LOG_INFO("Recording stopped");
+    }
 }
 
 bool AudioRoutingOverlay::IsRecording() const {
@@ -776,10 +776,16 @@ void OverlayUI::ToggleRecording() {
     if (m_audioEngine) {
         if (m_isRecording) {
             m_audioEngine->Start();
-            LOG_INFO("Audio processing started from VR overlay!");
+            if (!m_audioEngine->StartRecording()) {
+                m_isRecording = false;
+                return;
+            }
+            m_lastRecordingPath = m_audioEngine->GetRecordingPath();
+            LOG_INFO("Recording to {} from VR overlay!", m_lastRecordingPath);
         } else {
+            m_audioEngine->StopRecording();
             m_audioEngine->Stop();
-            LOG_INFO("Audio processing stopped from VR overlay!");
+            LOG_INFO("Recording saved to {} from VR overlay!", m_lastRecordingPath);
         }
     }
 }
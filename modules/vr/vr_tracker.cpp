@@ -138,6 +138,8 @@ void VRTracker::Shutdown() {
 }
 
 void VRTracker::TrackingLoop() {
+    rtlog::RegisterThread("tracker");
+
     // Use compositor frame timing instead of fixed 90Hz
     while (m_running.load()) {
         Update(); // Now uses WaitGetPoses for proper frame sync
@@ -299,7 +301,7 @@ void VRTracker::ExtractHMDPose(const vr::TrackedDevicePose_t poses[]) {
     m_hmdPose = ConvertOpenVRPose(poses[vr::k_unTrackedDeviceIndex_Hmd]);
 
     if (m_hmdPose.isValid) {
-        LOG_DEBUG("HMD pose: pos({:.2f}, {:.2f}, {:.2f})",
+        RT_LOG_DEBUG("HMD pose: pos({:.2f}, {:.2f}, {:.2f})",
                  m_hmdPose.position.x, m_hmdPose.position.y, m_hmdPose.position.z);
     }
 }
@@ -313,14 +315,14 @@ void VRTracker::ExtractControllerPoses(const vr::TrackedDevicePose_t poses[]) {
             VRPose controllerPose = ConvertOpenVRPose(poses[device]);
             if (controllerPose.isValid) {
                 m_controllerPoses.push_back(controllerPose);
-                LOG_DEBUG("Controller {} pose: pos({:.2f}, {:.2f}, {:.2f})",
+                RT_LOG_DEBUG("Controller {} pose: pos({:.2f}, {:.2f}, {:.2f})",
                          m_controllerPoses.size() - 1,
                          controllerPose.position.x, controllerPose.position.y, controllerPose.position.z);
             }
         }
     }
 
-    LOG_DEBUG("Extracted {} valid controller poses", m_controllerPoses.size());
+    RT_LOG_DEBUG("Extracted {} valid controller poses", m_controllerPoses.size());
 }
 
 std::string VRTracker::GetHMDModel() const {
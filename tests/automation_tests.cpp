@@ -0,0 +1,264 @@
+// automation_tests.cpp - Binary spatial automation
+// Delta-encoded round trip, size against the JSON export, seeking from sync points,
+// recovery of files that were never closed and timeline scaling
+
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include <json/json.h>
+#include "automation.h"
+
+using namespace vrb;
+
+namespace {
+
+constexpr int RATE = 48000;
+constexpr uint64_t TRACKING_FRAMES = RATE / 90;     // One 90 Hz tracking update
+
+// A slow head sway around a point in front of the listener, as tracking produces it
+Vec3 MicAt(size_t update) {
+    const float t = static_cast<float>(update) / 90.0f;
+    return Vec3(0.3f * std::sin(0.7f * t), -0.2f + 0.05f * std::sin(1.3f * t), -0.3f + 0.1f * std::cos(0.5f * t));
+}
+
+std::vector<AutomationEvent> ReadAll(AutomationPlayer& player) {
+    std::vector<AutomationEvent> events;
+    AutomationEvent block[64];
+    size_t count = 0;
+    while ((count = player.Read(std::numeric_limits<uint64_t>::max(), block, 64)) > 0) {
+        events.insert(events.end(), block, block + count);
+    }
+    return events;
+}
+
+} // anonymous namespace
+
+class AutomationTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        m_dir = std::filesystem::temp_directory_path() / "vrb_automation_tests";
+        std::filesystem::create_directories(m_dir);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(m_dir);
+    }
+
+    std::string Path(const std::string& name) const {
+        return (m_dir / name).string();
+    }
+
+    // updates of mic motion, with source 3's gain changing every second
+    std::vector<AutomationEvent> WriteTake(const std::string& path, size_t updates) {
+        AutomationWriter writer;
+        std::string error;
+        EXPECT_TRUE(writer.Open(path, RATE, error)) << error;
+        std::vector<AutomationEvent> written;
+        for (size_t i = 0; i < updates; ++i) {
+            AutomationEvent event;
+            event.frame = i * TRACKING_FRAMES;
+            event.value = MicAt(i);
+            EXPECT_TRUE(writer.Write(event));
+            written.push_back(event);
+            if (i % 90 == 45) {
+                AutomationEvent gain;
+                gain.frame = event.frame;
+                gain.lane = AutomationLane::SourceGain;
+                gain.source = 3;
+                gain.value.x = 0.5f + 0.25f * std::sin(static_cast<float>(i));
+                EXPECT_TRUE(writer.Write(gain));
+                written.push_back(gain);
+            }
+        }
+        EXPECT_TRUE(writer.Close());
+        return written;
+    }
+
+    std::filesystem::path m_dir;
+};
+
+TEST_F(AutomationTest, RoundTripsQuantizedEventsAndSkipsRepeats) {
+    const std::string path = Path("take.vrba");
+    AutomationWriter writer;
+    std::string error;
+    ASSERT_TRUE(writer.Open(path, RATE, error)) << error;
+
+    AutomationEvent source;
+    source.lane = AutomationLane::SourcePosition;
+    source.source = 1;
+    source.value = Vec3(1.23456f, -0.5f, 2.0f);
+    ASSERT_TRUE(writer.Write(source));
+    source.frame = 100;
+    source.value.x += 0.00001f;     // Below the 0.1 mm step: not stored
+    ASSERT_TRUE(writer.Write(source));
+    source.frame = 200;
+    source.value = Vec3(-1.0f, 0.25f, -3.5f);
+    ASSERT_TRUE(writer.Write(source));
+
+    AutomationEvent gain;
+    gain.frame = 200;
+    gain.lane = AutomationLane::SourceGain;
+    gain.source = 1;
+    gain.value.x = 0.707f;
+    ASSERT_TRUE(writer.Write(gain));
+
+    AutomationEvent outOfRange = gain;
+    outOfRange.source = AutomationFormat::MAX_SOURCES;
+    EXPECT_FALSE(writer.Write(outOfRange));
+    EXPECT_EQ(writer.GetEventCount(), 3u);
+    ASSERT_TRUE(writer.Close());
+
+    AutomationPlayer player;
+    ASSERT_TRUE(player.Open(path, error)) << error;
+    EXPECT_EQ(player.GetSampleRate(), RATE);
+    EXPECT_EQ(player.GetEventCount(), 3u);
+    EXPECT_EQ(player.GetDuration(), 200u);
+
+    const auto events = ReadAll(player);
+    ASSERT_EQ(events.size(), 3u);
+    EXPECT_EQ(events[0].frame, 0u);
+    EXPECT_EQ(events[0].lane, AutomationLane::SourcePosition);
+    EXPECT_EQ(events[0].source, 1);
+    EXPECT_NEAR(events[0].value.x, 1.23456f, 1e-4f);
+    EXPECT_NEAR(events[0].value.y, -0.5f, 1e-4f);
+    EXPECT_EQ(events[1].frame, 200u);
+    EXPECT_NEAR(events[1].value.z, -3.5f, 1e-4f);
+    EXPECT_EQ(events[2].lane, AutomationLane::SourceGain);
+    EXPECT_NEAR(events[2].value.x, 0.707f, 1e-4f);
+    EXPECT_TRUE(player.AtEnd());
+}
+
+TEST_F(AutomationTest, TenMinutesOfTrackingStaysSmallAgainstJson) {
+    const std::string path = Path("long.vrba");
+    const size_t updates = 90 * 600;
+    const auto written = WriteTake(path, updates);
+
+    AutomationPlayer player;
+    std::string error;
+    ASSERT_TRUE(player.Open(path, error)) << error;
+    const auto events = ReadAll(player);
+    ASSERT_EQ(events.size(), written.size());
+    for (size_t i = 0; i < events.size(); i += 997) {
+        EXPECT_EQ(events[i].frame, written[i].frame);
+        EXPECT_EQ(events[i].lane, written[i].lane);
+        EXPECT_NEAR(events[i].value.x, written[i].value.x, 1e-4f);
+        EXPECT_NEAR(events[i].value.z, written[i].value.z, 1e-4f);
+    }
+
+    // Sub-millimetre deltas and ~533-frame gaps fit a handful of bytes per update
+    const auto binaryBytes = std::filesystem::file_size(path);
+    EXPECT_LT(static_cast<double>(binaryBytes) / written.size(), 10.0);
+
+    const std::string json = Path("long.json");
+    ASSERT_TRUE(ExportAutomationJson(path, json, error)) << error;
+    EXPECT_GT(std::filesystem::file_size(json), binaryBytes * 8);
+
+    std::ifstream file(json);
+    Json::Value root;
+    Json::CharReaderBuilder reader;
+    std::string errors;
+    ASSERT_TRUE(Json::parseFromStream(reader, file, &root, &errors)) << errors;
+    EXPECT_EQ(root["sampleRate"].asInt(), RATE);
+    ASSERT_EQ(root["events"].size(), written.size());
+    EXPECT_EQ(root["events"][0]["lane"].asString(), "microphonePosition");
+    EXPECT_NEAR(root["events"][1]["value"][0].asFloat(), written[1].value.x, 1e-4f);
+}
+
+TEST_F(AutomationTest, SeekRestoresStateFromNearestSyncPoint) {
+    const std::string path = Path("seek.vrba");
+    const size_t updates = 90 * 120;
+    const auto written = WriteTake(path, updates);
+
+    AutomationPlayer player;
+    std::string error;
+    ASSERT_TRUE(player.Open(path, error)) << error;
+    EXPECT_GE(player.GetSyncPointCount(), 119u);
+
+    // Scrub to a point between tracking updates, past the first gain change
+    const uint64_t target = 4321 * TRACKING_FRAMES + 100;
+    player.Seek(target);
+    AutomationEvent state[8];
+    const size_t count = player.Read(target + 1, state, 8);
+    ASSERT_EQ(count, 2u);
+    EXPECT_EQ(state[0].frame, target);
+    EXPECT_EQ(state[0].lane, AutomationLane::MicrophonePosition);
+    EXPECT_NEAR(state[0].value.x, MicAt(4321).x, 1e-4f);
+    EXPECT_NEAR(state[0].value.y, MicAt(4321).y, 1e-4f);
+    EXPECT_EQ(state[1].lane, AutomationLane::SourceGain);
+    EXPECT_EQ(state[1].source, 3);
+    EXPECT_NEAR(state[1].value.x, 0.5f + 0.25f * std::sin(4275.0f), 1e-4f);
+
+    // Playback continues with the next stored update
+    EXPECT_EQ(player.PeekFrame(), 4322 * TRACKING_FRAMES);
+    ASSERT_EQ(player.Read(4322 * TRACKING_FRAMES + 1, state, 8), 1u);
+    EXPECT_NEAR(state[0].value.z, MicAt(4322).z, 1e-4f);
+
+    // Back to the start
+    player.Seek(0);
+    ASSERT_EQ(player.Read(1, state, 8), 1u);
+    EXPECT_NEAR(state[0].value.x, MicAt(0).x, 1e-4f);
+}
+
+TEST_F(AutomationTest, UnclosedFileIsIndexedByScanning) {
+    const std::string path = Path("crash.vrba");
+    const size_t updates = 90 * 10;
+    const auto written = WriteTake(path, updates);
+
+    // Drop the index, clear its header fields and tear the last event, as a crash leaves the file
+    std::vector<uint8_t> bytes;
+    {
+        std::ifstream file(path, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    uint64_t indexOffset = 0;
+    std::memcpy(&indexOffset, bytes.data() + 32, sizeof(indexOffset));
+    bytes.resize(static_cast<size_t>(indexOffset) - 2);
+    std::memset(bytes.data() + 16, 0, 32);
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    }
+
+    AutomationPlayer player;
+    std::string error;
+    ASSERT_TRUE(player.Open(path, error)) << error;
+    EXPECT_EQ(player.GetEventCount(), written.size() - 1);
+    EXPECT_GE(player.GetSyncPointCount(), 9u);
+    const auto events = ReadAll(player);
+    ASSERT_EQ(events.size(), written.size() - 1);
+    EXPECT_NEAR(events.back().value.x, written[written.size() - 2].value.x, 1e-4f);
+
+    player.Seek(5 * RATE);
+    AutomationEvent state[4];
+    ASSERT_GE(player.Read(5 * RATE + 1, state, 4), 1u);
+    EXPECT_NEAR(state[0].value.y, MicAt((5 * RATE) / TRACKING_FRAMES).y, 1e-4f);
+}
+
+TEST_F(AutomationTest, TimelineFollowsRendererRateAndSpeed) {
+    const std::string path = Path("rate.vrba");
+    WriteTake(path, 10);
+
+    AutomationPlayer player;
+    std::string error;
+    ASSERT_TRUE(player.Open(path, error)) << error;
+
+    player.SetTimeline(96000);
+    player.Seek(0);
+    AutomationEvent events[16];
+    EXPECT_EQ(player.Read(1, events, 16), 1u);
+    EXPECT_EQ(player.PeekFrame(), 2 * TRACKING_FRAMES);
+    EXPECT_EQ(player.Read(2 * TRACKING_FRAMES, events, 16), 0u);
+    ASSERT_EQ(player.Read(2 * TRACKING_FRAMES + 1, events, 16), 1u);
+    EXPECT_EQ(events[0].frame, 2 * TRACKING_FRAMES);
+
+    player.SetTimeline(RATE, 2.0);
+    player.Seek(0);
+    player.Read(1, events, 16);
+    EXPECT_NEAR(static_cast<double>(player.PeekFrame()), TRACKING_FRAMES / 2.0, 1.0);
+    EXPECT_NEAR(static_cast<double>(player.GetDuration()), 9 * TRACKING_FRAMES / 2.0, 1.0);
+}
@@ -0,0 +1,215 @@
+// device_catalog_tests.cpp - Device listing with a persistent capability cache
+// Probes are fakes that count calls, so reuse and invalidation are checked without opening hardware
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "device_catalog.h"
+
+using namespace vrb;
+
+namespace {
+
+constexpr const char* HOST = "PortAudio V19.7.0-test";
+
+DeviceCapabilities Listed(int index, const std::string& name, int inputs, int outputs) {
+    DeviceCapabilities device;
+    device.index = index;
+    device.name = name;
+    device.hostApiType = 8;     // paALSA
+    device.maxInputChannels = inputs;
+    device.maxOutputChannels = outputs;
+    device.defaultSampleRate = 48000.0;
+    device.lowInputLatency = 0.0087;
+    device.lowOutputLatency = 0.0087;
+    return device;
+}
+
+std::vector<DeviceCapabilities> Rig() {
+    return {Listed(0, "Interface A", 8, 8), Listed(1, "Interface B", 2, 2),
+            Listed(2, "USB Mic", 1, 0), Listed(3, "HDMI", 0, 8)};
+}
+
+// Counts every device it is handed and reports a rate set derived from the channel count
+struct CountingProbe {
+    std::atomic<int> calls{0};
+
+    DeviceCatalog::Probe Get() {
+        return [this](DeviceCapabilities& device) {
+            ++calls;
+            device.inputSampleRates = device.maxInputChannels > 0 ? std::vector<int>{44100, 48000} : std::vector<int>{};
+            device.outputSampleRates = device.maxOutputChannels > 0 ? std::vector<int>{48000, 96000} : std::vector<int>{};
+            device.inputFormats = device.maxInputChannels > 0 ? 0x9u : 0u;
+            return true;
+        };
+    }
+};
+
+} // anonymous namespace
+
+class DeviceCatalogTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        m_dir = std::filesystem::temp_directory_path() / "vrb_device_catalog_tests";
+        std::filesystem::remove_all(m_dir);
+        m_path = (m_dir / "cache" / "audio_devices.json").string();
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(m_dir);
+    }
+
+    // One start: list, fill from the cache, probe the rest; returns how many the probe opened
+    int Start(const std::vector<DeviceCapabilities>& listing, const std::string& host = HOST) {
+        CountingProbe probe;
+        DeviceCatalog catalog;
+        catalog.Update(listing, m_path, host);
+        m_lastCached = catalog.GetCachedCount();
+        catalog.StartProbe(probe.Get());
+        EXPECT_TRUE(catalog.WaitForProbe(std::chrono::seconds(5)));
+        EXPECT_EQ(catalog.GetProbedCount(), listing.size());
+        return probe.calls.load();
+    }
+
+    std::filesystem::path m_dir;
+    std::string m_path;
+    size_t m_lastCached{0};
+};
+
+TEST_F(DeviceCatalogTest, SecondStartProbesNothing) {
+    EXPECT_EQ(Start(Rig()), 4);
+    EXPECT_EQ(m_lastCached, 0u);
+    ASSERT_TRUE(std::filesystem::exists(m_path));
+
+    EXPECT_EQ(Start(Rig()), 0);
+    EXPECT_EQ(m_lastCached, 4u);
+
+    // The cached capabilities are the probed ones
+    DeviceCatalog catalog;
+    catalog.Update(Rig(), m_path, HOST);
+    DeviceCapabilities mic;
+    ASSERT_TRUE(catalog.GetDevice(2, mic));
+    EXPECT_TRUE(mic.probed);
+    EXPECT_EQ(mic.inputSampleRates, (std::vector<int>{44100, 48000}));
+    EXPECT_TRUE(mic.outputSampleRates.empty());
+    EXPECT_EQ(mic.inputFormats, 0x9u);
+    EXPECT_DOUBLE_EQ(mic.lowInputLatency, 0.0087);
+}
+
+TEST_F(DeviceCatalogTest, ChangedDevicesAreProbedAgain) {
+    Start(Rig());
+
+    // B now runs with fewer channels, the mic is unplugged and a new interface appears at its index
+    auto listing = Rig();
+    listing[1].maxInputChannels = 1;
+    listing[2] = Listed(2, "Interface C", 4, 4);
+    EXPECT_EQ(Start(listing), 2);
+    EXPECT_EQ(m_lastCached, 2u);
+
+    // The rewritten file holds exactly the current set
+    std::vector<DeviceCapabilities> cached;
+    std::string error;
+    ASSERT_TRUE(DeviceCatalog::Load(m_path, HOST, cached, error)) << error;
+    ASSERT_EQ(cached.size(), 4u);
+    for (const auto& device : cached) {
+        EXPECT_NE(device.name, "USB Mic");
+    }
+    EXPECT_EQ(Start(listing), 0);
+}
+
+TEST_F(DeviceCatalogTest, IdenticalInterfacesEachNeedAnEntry) {
+    std::vector<DeviceCapabilities> twins = {Listed(0, "USB Audio", 2, 2), Listed(1, "USB Audio", 2, 2)};
+    EXPECT_EQ(Start({twins[0]}), 1);
+    EXPECT_EQ(Start(twins), 1);
+    EXPECT_EQ(Start(twins), 0);
+}
+
+TEST_F(DeviceCatalogTest, ForeignOrDamagedFilesAreIgnored) {
+    Start(Rig());
+
+    // Another host library version may report differently
+    EXPECT_EQ(Start(Rig(), "PortAudio V19.8.0-test"), 4);
+    EXPECT_EQ(m_lastCached, 0u);
+
+    {
+        std::ofstream file(m_path, std::ios::trunc);
+        file << "{\"version\": 1, \"host\": \"" << HOST << "\", \"devices\": [{\"name\": [";
+    }
+    EXPECT_EQ(Start(Rig()), 4);
+
+    {
+        std::ofstream file(m_path, std::ios::trunc);
+        file << "{\"version\": 1, \"host\": \"" << HOST << "\", \"devices\": [{\"name\": {\"x\": 1}}]}";
+    }
+    std::vector<DeviceCapabilities> cached;
+    std::string error;
+    EXPECT_FALSE(DeviceCatalog::Load(m_path, HOST, cached, error));
+    EXPECT_EQ(Start(Rig()), 4);
+    EXPECT_EQ(Start(Rig()), 0);
+}
+
+TEST_F(DeviceCatalogTest, SkippedDevicesWaitForALaterStart) {
+    DeviceCatalog catalog;
+    catalog.Update(Rig(), m_path, HOST);
+    CountingProbe counting;
+    auto probe = counting.Get();
+    catalog.StartProbe([&probe](DeviceCapabilities& device) {
+        return device.index == 0 ? false : probe(device);     // Held by an open stream
+    });
+    ASSERT_TRUE(catalog.WaitForProbe(std::chrono::seconds(5)));
+    EXPECT_EQ(catalog.GetProbedCount(), 3u);
+
+    DeviceCapabilities held;
+    ASSERT_TRUE(catalog.GetDevice(0, held));
+    EXPECT_FALSE(held.probed);
+
+    // Only the probed ones were written
+    EXPECT_EQ(Start(Rig()), 1);
+    EXPECT_EQ(m_lastCached, 3u);
+}
+
+TEST_F(DeviceCatalogTest, CancelKeepsWhatWasProbed) {
+    DeviceCatalog catalog;
+    catalog.Update(Rig(), m_path, HOST);
+
+    std::atomic<int> started{0};
+    catalog.StartProbe([&started](DeviceCapabilities& device) {
+        ++started;
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        device.outputSampleRates = {48000};
+        return true;
+    });
+    EXPECT_TRUE(catalog.IsProbing());
+    while (started.load() == 0) {
+        std::this_thread::yield();
+    }
+
+    // Readable while the probe runs
+    EXPECT_EQ(catalog.GetDevices().size(), 4u);
+
+    catalog.CancelProbe();
+    EXPECT_FALSE(catalog.IsProbing());
+    EXPECT_TRUE(catalog.WaitForProbe(std::chrono::milliseconds(0)));
+    EXPECT_GE(catalog.GetProbedCount(), 1u);
+    EXPECT_LT(catalog.GetProbedCount(), 4u);
+
+    std::vector<DeviceCapabilities> cached;
+    std::string error;
+    ASSERT_TRUE(DeviceCatalog::Load(m_path, HOST, cached, error)) << error;
+    EXPECT_EQ(cached.size(), catalog.GetProbedCount());
+}
+
+TEST_F(DeviceCatalogTest, NoPathKeepsNothingOnDisk) {
+    DeviceCatalog catalog;
+    catalog.Update(Rig(), "", HOST);
+    CountingProbe probe;
+    catalog.StartProbe(probe.Get());
+    ASSERT_TRUE(catalog.WaitForProbe(std::chrono::seconds(5)));
+    EXPECT_EQ(probe.calls.load(), 4);
+    EXPECT_FALSE(std::filesystem::exists(m_dir));
+}
@@ -0,0 +1,315 @@
+// disk_recorder_tests.cpp - Streaming session recorder
+// File layout, sample round trip through the writer thread, overflow accounting, RF64 reading
+// and multitrack sessions sharing one sample clock
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "disk_recorder.h"
+#include "pose_trajectory.h"
+#include "recording_session.h"
+#include "wav_file.h"
+
+using namespace vrb;
+
+class DiskRecorderTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        m_dir = std::filesystem::temp_directory_path() / "vrb_disk_recorder_tests";
+        std::filesystem::create_directories(m_dir);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(m_dir);
+    }
+
+    std::string Path(const std::string& name) const {
+        return (m_dir / name).string();
+    }
+
+    static std::vector<uint8_t> ReadBytes(const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    static uint32_t U32(const std::vector<uint8_t>& bytes, size_t offset) {
+        return bytes[offset] | (bytes[offset + 1] << 8) | (bytes[offset + 2] << 16) |
+               (static_cast<uint32_t>(bytes[offset + 3]) << 24);
+    }
+
+    std::filesystem::path m_dir;
+};
+
+TEST_F(DiskRecorderTest, WritesBroadcastWaveThatReadsBack) {
+    const std::string path = Path("nested/session.wav");
+    const size_t block = 256;
+    const size_t blocks = 1200;     // Several write chunks plus a partial one
+    std::vector<float> signal(block * blocks * 2);
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> dist(-0.9f, 0.9f);
+    for (auto& sample : signal) {
+        sample = dist(rng);
+    }
+
+    DiskRecorder recorder;
+    DiskRecorderOptions options;
+    options.format = WavSampleFormat::Float32;
+    options.headerIntervalSeconds = 0.05;
+    options.preallocateBytes = 1 << 20;
+    options.bufferSeconds = 10.0;   // Holds the whole push, so nothing may be dropped however the threads interleave
+    options.description = "unit test";
+    std::string error;
+    ASSERT_TRUE(recorder.Start(path, 48000, 2, options, error)) << error;
+    EXPECT_TRUE(recorder.IsRecording());
+    EXPECT_FALSE(recorder.Start(path, 48000, 2, options, error));
+
+    // Pushed from another thread, faster than real time
+    std::thread audio([&] {
+        for (size_t b = 0; b < blocks; ++b) {
+            ASSERT_TRUE(recorder.Push(signal.data() + b * block * 2, block));
+            if (b % 64 == 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+    });
+    audio.join();
+    ASSERT_TRUE(recorder.Stop());
+    EXPECT_FALSE(recorder.IsRecording());
+    EXPECT_FALSE(recorder.Push(signal.data(), block));
+
+    const auto stats = recorder.GetStats();
+    EXPECT_EQ(stats.framesPushed, block * blocks);
+    EXPECT_EQ(stats.framesWritten, block * blocks);
+    EXPECT_EQ(stats.overflowFrames, 0u);
+    EXPECT_FALSE(stats.rf64);
+    EXPECT_GE(stats.writes, 2u);
+
+    // Samples start on the 4 KiB boundary after the bext chunk, and the file ends with them
+    const auto bytes = ReadBytes(path);
+    ASSERT_EQ(bytes.size(), DiskRecorder::HEADER_BYTES + signal.size() * sizeof(float));
+    EXPECT_EQ(std::memcmp(bytes.data(), "RIFF", 4), 0);
+    EXPECT_EQ(U32(bytes, 4), bytes.size() - 8);
+    EXPECT_EQ(std::memcmp(bytes.data() + 48, "bext", 4), 0);
+    EXPECT_EQ(std::string(reinterpret_cast<const char*>(bytes.data() + 56)), "unit test");
+    EXPECT_EQ(std::memcmp(bytes.data() + DiskRecorder::HEADER_BYTES - 8, "data", 4), 0);
+
+    WavReader reader;
+    ASSERT_TRUE(reader.Open(path, error)) << error;
+    ASSERT_EQ(reader.GetInfo().frames, block * blocks);
+    EXPECT_EQ(reader.GetInfo().format, WavSampleFormat::Float32);
+    std::vector<float> decoded(signal.size());
+    ASSERT_EQ(reader.Read(decoded.data(), block * blocks), block * blocks);
+    EXPECT_EQ(decoded, signal);
+}
+
+TEST_F(DiskRecorderTest, HeaderIntervalCoversPartialChunks) {
+    const std::string path = Path("crash.wav");
+    DiskRecorder recorder;
+    DiskRecorderOptions options;
+    options.format = WavSampleFormat::Int16;
+    options.dither = false;
+    options.headerIntervalSeconds = 0.05;
+    std::string error;
+    ASSERT_TRUE(recorder.Start(path, 48000, 2, options, error)) << error;
+
+    // Far less than a write chunk, and block sizes that leave the data off the I/O block boundary
+    std::vector<float> signal;
+    auto pushAndWait = [&](size_t frames) {
+        const size_t start = signal.size() / 2;
+        for (size_t i = 0; i < frames; ++i) {
+            signal.push_back(static_cast<float>((start + i) % 1000) / 2048.0f);
+            signal.push_back(-static_cast<float>((start + i) % 1000) / 2048.0f);
+        }
+        EXPECT_TRUE(recorder.Push(signal.data() + start * 2, frames));
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (recorder.GetStats().framesWritten < signal.size() / 2 && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+    };
+
+    // Read while still recording, as after a crash: the header covers everything pushed so far
+    for (size_t frames : {1000u, 3333u, 17u}) {
+        pushAndWait(frames);
+        WavReader reader;
+        ASSERT_TRUE(reader.Open(path, error)) << error;
+        ASSERT_EQ(reader.GetInfo().frames, signal.size() / 2);
+        std::vector<float> decoded(signal.size());
+        ASSERT_EQ(reader.Read(decoded.data(), signal.size() / 2), signal.size() / 2);
+        for (size_t i = 0; i < signal.size(); ++i) {
+            ASSERT_NEAR(decoded[i], signal[i], 2.0f / 32768.0f) << "sample " << i;
+        }
+    }
+
+    ASSERT_TRUE(recorder.Stop());
+    EXPECT_EQ(std::filesystem::file_size(path), DiskRecorder::HEADER_BYTES + signal.size() * sizeof(int16_t));
+}
+
+TEST_F(DiskRecorderTest, FullRingDropsAndCountsBlocksInsteadOfWaiting) {
+    const std::string path = Path("overflow.wav");
+    DiskRecorder recorder;
+    DiskRecorderOptions options;
+    options.format = WavSampleFormat::Int24;
+    options.bufferSeconds = 0.01;   // Smallest ring the recorder allows
+    std::string error;
+    ASSERT_TRUE(recorder.Start(path, 48000, 2, options, error)) << error;
+
+    // Far faster than real time: the ring fills and whole blocks are rejected
+    const size_t block = 4096;
+    const std::vector<float> silence(block * 2, 0.25f);
+    size_t rejected = 0;
+    for (int b = 0; b < 200; ++b) {
+        if (!recorder.Push(silence.data(), block)) {
+            ++rejected;
+        }
+    }
+    ASSERT_TRUE(recorder.Stop());
+
+    const auto stats = recorder.GetStats();
+    EXPECT_GT(rejected, 0u);
+    EXPECT_EQ(stats.overflowEvents, rejected);
+    EXPECT_EQ(stats.overflowFrames, rejected * block);
+    EXPECT_EQ(stats.framesPushed + stats.overflowFrames, 200u * block);
+
+    // Whatever was accepted is on disk in full
+    EXPECT_EQ(stats.framesWritten, stats.framesPushed);
+    WavReader reader;
+    ASSERT_TRUE(reader.Open(path, error)) << error;
+    EXPECT_EQ(reader.GetInfo().frames, stats.framesPushed);
+    EXPECT_EQ(reader.GetInfo().format, WavSampleFormat::Int24);
+}
+
+TEST_F(DiskRecorderTest, ReaderFollowsRF64Sizes) {
+    // RF64 layout as the recorder writes it past 4 GB, shrunk to a few frames
+    const std::string path = Path("rf64.wav");
+    const int16_t samples[] = {1000, -1000, 2000, -2000, 3000, -3000};
+    std::vector<uint8_t> file(12 + 36 + 24 + 8);
+    auto put32 = [&](size_t offset, uint32_t value) { std::memcpy(file.data() + offset, &value, 4); };
+    auto put64 = [&](size_t offset, uint64_t value) { std::memcpy(file.data() + offset, &value, 8); };
+    std::memcpy(file.data(), "RF64", 4);
+    put32(4, 0xFFFFFFFFu);
+    std::memcpy(file.data() + 8, "WAVEds64", 8);
+    put32(16, 28);
+    put64(20, file.size() - 8 + sizeof(samples));
+    put64(28, sizeof(samples));
+    put64(36, 3);
+    std::memcpy(file.data() + 48, "fmt ", 4);
+    put32(52, 16);
+    const uint16_t fmt[] = {1, 2};
+    std::memcpy(file.data() + 56, fmt, 4);
+    put32(60, 44100);
+    put32(64, 44100 * 4);
+    const uint16_t align[] = {4, 16};
+    std::memcpy(file.data() + 68, align, 4);
+    std::memcpy(file.data() + 72, "data", 4);
+    put32(76, 0xFFFFFFFFu);
+    {
+        std::ofstream out(path, std::ios::binary);
+        out.write(reinterpret_cast<const char*>(file.data()), file.size());
+        out.write(reinterpret_cast<const char*>(samples), sizeof(samples));
+        const char trailing[16] = {};   // Bytes past the data chunk are not samples
+        out.write(trailing, sizeof(trailing));
+    }
+
+    WavReader reader;
+    std::string error;
+    ASSERT_TRUE(reader.Open(path, error)) << error;
+    EXPECT_EQ(reader.GetInfo().frames, 3u);
+    EXPECT_EQ(reader.GetInfo().sampleRate, 44100);
+    float decoded[6];
+    ASSERT_EQ(reader.Read(decoded, 3), 3u);
+    EXPECT_NEAR(decoded[4], 3000.0f / 32768.0f, 1e-4f);
+}
+
+TEST_F(DiskRecorderTest, SessionTracksShareOneTimeline) {
+    const std::string path = Path("take.wav");
+    const auto paths = RecordingSession::MakePaths(path);
+    EXPECT_EQ(paths.dry, Path("take.dry.wav"));
+    EXPECT_EQ(paths.poses, Path("take.vrbpose"));
+
+    RecordingSessionOptions options;
+    options.audio.format = WavSampleFormat::Float32;
+    options.audio.bufferSeconds = 0.05;
+    RecordingSession session;
+    std::string error;
+    ASSERT_TRUE(session.Start(path, 48000, 1, 2, 256, options, error)) << error;
+
+    // Each block carries its index in both tracks; blocks too big for the rings are refused by both
+    const size_t block = 512;
+    std::vector<float> dry(block), wet(block * 2);
+    std::vector<VRPose> controllers(1);
+    controllers[0].isValid = true;
+    size_t accepted = 0;
+    size_t refused = 0;
+    for (int b = 0; b < 400; ++b) {
+        std::fill(dry.begin(), dry.end(), b / 1024.0f);
+        std::fill(wet.begin(), wet.end(), -b / 1024.0f);
+        const bool silentInput = b % 7 == 0;
+        if (session.PushAudio(silentInput ? nullptr : dry.data(), wet.data(), block)) {
+            ++accepted;
+        } else {
+            ++refused;
+        }
+
+        VRPose hmd;
+        hmd.isValid = true;
+        controllers[0].position = Vec3(static_cast<float>(b), 0.0f, -1.0f);
+        session.PushPose(hmd, controllers);
+    }
+    ASSERT_TRUE(session.Stop());
+    EXPECT_FALSE(session.IsRecording());
+
+    const auto stats = session.GetStats();
+    EXPECT_GT(refused, 0u);
+    EXPECT_EQ(stats.frames, accepted * block);
+    EXPECT_EQ(stats.binaural.overflowFrames, refused * block);
+    EXPECT_EQ(stats.dry.overflowFrames, refused * block);
+    EXPECT_EQ(stats.poses, 400u);
+
+    // Frame n of the dry track is frame n of the binaural track
+    WavReader binaural, input;
+    ASSERT_TRUE(binaural.Open(paths.binaural, error)) << error;
+    ASSERT_TRUE(input.Open(paths.dry, error)) << error;
+    ASSERT_EQ(binaural.GetInfo().frames, accepted * block);
+    ASSERT_EQ(input.GetInfo().frames, accepted * block);
+    EXPECT_EQ(input.GetInfo().channels, 1);
+    std::vector<float> wetBlock(block * 2), dryBlock(block);
+    for (size_t b = 0; b < accepted; ++b) {
+        ASSERT_EQ(binaural.Read(wetBlock.data(), block), block);
+        ASSERT_EQ(input.Read(dryBlock.data(), block), block);
+        const float index = -wetBlock[0] * 1024.0f;
+        const float expected = static_cast<int>(std::lround(index)) % 7 == 0 ? 0.0f : index / 1024.0f;
+        EXPECT_FLOAT_EQ(dryBlock[block - 1], expected) << "block " << b;
+        EXPECT_FLOAT_EQ(wetBlock[block * 2 - 1], wetBlock[0]);
+    }
+
+    // Poses land on the audio clock and feed the offline renderer
+    PoseTrackInfo info;
+    std::vector<PoseTrackSample> samples;
+    ASSERT_TRUE(ReadPoseTrack(paths.poses, info, samples, error)) << error;
+    EXPECT_EQ(info.sampleRate, 48000);
+    EXPECT_EQ(info.latencyFrames, 256u);
+    ASSERT_EQ(samples.size(), 400u);
+    for (size_t i = 1; i < samples.size(); ++i) {
+        ASSERT_GE(samples[i].frame, samples[i - 1].frame);
+        ASSERT_LE(samples[i].frame, stats.frames);
+    }
+    EXPECT_TRUE(samples.back().hmd.isValid);
+    EXPECT_TRUE(samples.back().controllers[0].isValid);
+    EXPECT_FALSE(samples.back().controllers[1].isValid);
+    EXPECT_FLOAT_EQ(samples.back().controllers[0].position.x, 399.0f);
+
+    PoseTrajectory trajectory;
+    ASSERT_TRUE(trajectory.Load(paths.poses, error)) << error;
+    EXPECT_EQ(trajectory.size(), 400u);
+    VRPose head, mic;
+    trajectory.Sample(1e6, head, mic);
+    EXPECT_FLOAT_EQ(mic.position.x, 399.0f);
+}
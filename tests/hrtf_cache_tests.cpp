@@ -0,0 +1,223 @@
+// hrtf_cache_tests.cpp - Precompiled HRTF dataset files
+// Round trip of the file format, and processors started from a mapped dataset against freshly built ones
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include <json/json.h>
+#include "config.h"
+#include "hrtf_cache.h"
+#include "hrtf_processor.h"
+#include "vr_types.h"
+
+using namespace vrb;
+
+class HRTFCacheTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        m_directory = std::filesystem::temp_directory_path() / "vrb_hrtf_cache_test";
+        std::filesystem::create_directories(m_directory);
+        m_cachePath = (m_directory / "dataset.vrbhrtf").string();
+        m_configPath = (m_directory / "config.json").string();
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(m_directory);
+    }
+
+    std::unique_ptr<HRTFProcessor> CreateProcessor(int minimumPhaseTaps = 128) {
+        Json::Value root;
+        root["hrtf"]["dataPath"] = "";
+        root["hrtf"]["cachePath"] = m_cachePath;
+        root["hrtf"]["minimumPhaseTaps"] = minimumPhaseTaps;
+        root["hrtf"]["maxSources"] = 4;
+        root["hrtf"]["filterCacheSize"] = 0;   // Bank hits depend on worker timing; keep renders deterministic
+        root["logging"]["level"] = "warn";
+
+        std::ofstream file(m_configPath);
+        Json::StreamWriterBuilder builder;
+        std::unique_ptr<Json::StreamWriter> writer(builder.newStreamWriter());
+        writer->write(root, &file);
+        file.close();
+
+        Config config(m_configPath);
+        auto processor = std::make_unique<HRTFProcessor>();
+        if (!processor->Initialize(config)) {
+            return nullptr;
+        }
+        return processor;
+    }
+
+    // Sweeps the source around the head so many filters and interpolation triangles are used
+    static std::vector<float> Render(HRTFProcessor& processor) {
+        constexpr size_t FRAMES = 256;
+        std::vector<float> input(FRAMES);
+        std::mt19937 rng(11);
+        std::uniform_real_distribution<float> dist(-0.5f, 0.5f);
+
+        VRPose head;
+        head.position = {0.0f, 1.7f, 0.0f};
+        head.orientation = {0.0f, 0.0f, 0.0f, 1.0f};
+        head.isValid = true;
+
+        std::vector<float> rendered;
+        std::vector<float> output(FRAMES * 2);
+        for (int block = 0; block < 48; ++block) {
+            VRPose source = head;
+            const float angle = static_cast<float>(block) * 0.4f;
+            source.position = {std::sin(angle), 1.7f + 0.5f * std::cos(angle * 0.7f), -std::cos(angle)};
+            processor.UpdateSpatialPosition(head, {source});
+
+            for (auto& sample : input) {
+                sample = dist(rng);
+            }
+            processor.Process(input.data(), output.data(), FRAMES, 1);
+            rendered.insert(rendered.end(), output.begin(), output.end());
+        }
+        return rendered;
+    }
+
+    std::filesystem::path m_directory;
+    std::string m_cachePath;
+    std::string m_configPath;
+};
+
+TEST_F(HRTFCacheTest, FileRoundTripKeepsSectionsAligned) {
+    std::vector<float> filters(1000);
+    std::vector<int> lookup(37);
+    for (size_t i = 0; i < filters.size(); ++i) filters[i] = static_cast<float>(i) * 0.5f;
+    for (size_t i = 0; i < lookup.size(); ++i) lookup[i] = static_cast<int>(i * 3);
+
+    HRTFCacheFile::Metadata metadata;
+    metadata.sampleRate = 44100;
+    metadata.filterCount = 7;
+    metadata.filterLength = 96;
+    metadata.filterRecordSize = 128;
+    metadata.maxDelay = 12.5f;
+    metadata.key = "round-trip";
+
+    std::string error;
+    ASSERT_TRUE(HRTFCacheFile::Write(m_cachePath, metadata,
+                                     {{HRTFCacheFile::Section::Filters, filters.data(), filters.size() * sizeof(float)},
+                                      {HRTFCacheFile::Section::Lookup, lookup.data(), lookup.size() * sizeof(int)}},
+                                     error)) << error;
+    EXPECT_FALSE(std::filesystem::exists(m_cachePath + ".tmp"));
+
+    HRTFCacheFile file;
+    ASSERT_TRUE(file.Open(m_cachePath, error)) << error;
+    EXPECT_EQ(file.GetMetadata().sampleRate, 44100u);
+    EXPECT_EQ(file.GetMetadata().filterCount, 7u);
+    EXPECT_EQ(file.GetMetadata().filterLength, 96u);
+    EXPECT_EQ(file.GetMetadata().filterRecordSize, 128u);
+    EXPECT_EQ(file.GetMetadata().maxDelay, 12.5f);
+    EXPECT_EQ(file.GetMetadata().key, "round-trip");
+
+    size_t size = 0;
+    const void* filterData = file.GetSection(HRTFCacheFile::Section::Filters, size);
+    ASSERT_NE(filterData, nullptr);
+    EXPECT_EQ(size, filters.size() * sizeof(float));
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(filterData) % HRTFCacheFile::SECTION_ALIGNMENT, 0u);
+    EXPECT_EQ(std::memcmp(filterData, filters.data(), size), 0);
+
+    const void* lookupData = file.GetSection(HRTFCacheFile::Section::Lookup, size);
+    ASSERT_NE(lookupData, nullptr);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(lookupData) % HRTFCacheFile::SECTION_ALIGNMENT, 0u);
+    EXPECT_EQ(std::memcmp(lookupData, lookup.data(), size), 0);
+
+    EXPECT_EQ(file.GetSection(HRTFCacheFile::Section::Triangles, size), nullptr);
+    EXPECT_EQ(size, 0u);
+}
+
+TEST_F(HRTFCacheTest, MappedDatasetRendersIdentically) {
+    auto built = CreateProcessor();
+    ASSERT_NE(built, nullptr);
+    EXPECT_FALSE(built->IsDatasetMapped());
+    ASSERT_TRUE(std::filesystem::exists(m_cachePath));
+
+    auto mapped = CreateProcessor();
+    ASSERT_NE(mapped, nullptr);
+    EXPECT_TRUE(mapped->IsDatasetMapped());
+    EXPECT_EQ(mapped->GetStats().filterLength, built->GetStats().filterLength);
+
+    const auto expected = Render(*built);
+    const auto actual = Render(*mapped);
+    ASSERT_EQ(actual.size(), expected.size());
+    EXPECT_EQ(std::memcmp(actual.data(), expected.data(), actual.size() * sizeof(float)), 0);
+}
+
+TEST_F(HRTFCacheTest, ChangedSettingsRebuildTheCache) {
+    ASSERT_NE(CreateProcessor(128), nullptr);
+
+    // Different decomposition length: the file no longer describes these filters
+    auto rebuilt = CreateProcessor(64);
+    ASSERT_NE(rebuilt, nullptr);
+    EXPECT_FALSE(rebuilt->IsDatasetMapped());
+    EXPECT_EQ(rebuilt->GetStats().filterLength, 64);
+
+    auto mapped = CreateProcessor(64);
+    ASSERT_NE(mapped, nullptr);
+    EXPECT_TRUE(mapped->IsDatasetMapped());
+    EXPECT_EQ(mapped->GetStats().filterLength, 64);
+}
+
+TEST_F(HRTFCacheTest, CorruptedFileIsRejectedAndRebuilt) {
+    ASSERT_NE(CreateProcessor(), nullptr);
+
+    // Flip one byte well inside the filter records
+    const auto size = std::filesystem::file_size(m_cachePath);
+    {
+        std::fstream file(m_cachePath, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekg(static_cast<std::streamoff>(size / 2));
+        char byte = 0;
+        file.read(&byte, 1);
+        byte = static_cast<char>(byte ^ 0x5a);
+        file.seekp(static_cast<std::streamoff>(size / 2));
+        file.write(&byte, 1);
+    }
+
+    HRTFCacheFile file;
+    std::string error;
+    EXPECT_FALSE(file.Open(m_cachePath, error));
+    EXPECT_EQ(error, "checksum mismatch");
+    EXPECT_FALSE(file.IsOpen());
+
+    auto rebuilt = CreateProcessor();
+    ASSERT_NE(rebuilt, nullptr);
+    EXPECT_FALSE(rebuilt->IsDatasetMapped());
+    EXPECT_TRUE(file.Open(m_cachePath, error)) << error;
+}
+
+TEST_F(HRTFCacheTest, CompileCacheWritesLoadedDataset) {
+    Json::Value root;
+    root["hrtf"]["dataPath"] = "";
+    root["logging"]["level"] = "warn";
+    std::ofstream configFile(m_configPath);
+    configFile << root;
+    configFile.close();
+
+    // No cachePath configured: nothing is written until CompileCache is asked to
+    Config config(m_configPath);
+    HRTFProcessor processor;
+    ASSERT_TRUE(processor.Initialize(config));
+    EXPECT_FALSE(processor.IsDatasetMapped());
+    EXPECT_FALSE(std::filesystem::exists(m_cachePath));
+
+    ASSERT_TRUE(processor.CompileCache(m_cachePath));
+    HRTFCacheFile file;
+    std::string error;
+    ASSERT_TRUE(file.Open(m_cachePath, error)) << error;
+    EXPECT_EQ(file.GetMetadata().sampleRate, 48000u);
+    EXPECT_EQ(file.GetMetadata().filterCount, 1008u);
+    EXPECT_EQ(file.GetMetadata().filterLength, 128u);
+
+    // Started with the compiled file configured, the next processor maps it
+    auto mapped = CreateProcessor();
+    ASSERT_NE(mapped, nullptr);
+    EXPECT_TRUE(mapped->IsDatasetMapped());
+}
@@ -0,0 +1,273 @@
+// hrtf_dataset_tests.cpp - Measured HRTF datasets
+// WAV and SOFA decoding, load-time resampling, the load worker pool and the shipped MIT KEMAR set
+
+#define _USE_MATH_DEFINES
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "hrtf_io.h"
+#include "hrtf_processor.h"
+#include "vr_types.h"
+#include "worker_pool.h"
+
+#if VRB_HAVE_SOFA
+#include <hdf5.h>
+#endif
+
+using namespace vrb;
+
+namespace {
+
+void WriteWav16(const std::string& path, int sampleRate, const std::vector<std::vector<int16_t>>& channels) {
+    const uint16_t channelCount = static_cast<uint16_t>(channels.size());
+    const uint32_t frames = static_cast<uint32_t>(channels[0].size());
+    const uint32_t dataBytes = frames * channelCount * 2;
+    auto u32 = [](std::ofstream& out, uint32_t v) { out.write(reinterpret_cast<const char*>(&v), 4); };
+    auto u16 = [](std::ofstream& out, uint16_t v) { out.write(reinterpret_cast<const char*>(&v), 2); };
+
+    std::ofstream out(path, std::ios::binary);
+    out.write("RIFF", 4);
+    u32(out, 36 + dataBytes);
+    out.write("WAVEfmt ", 8);
+    u32(out, 16);
+    u16(out, 1);
+    u16(out, channelCount);
+    u32(out, static_cast<uint32_t>(sampleRate));
+    u32(out, static_cast<uint32_t>(sampleRate) * channelCount * 2);
+    u16(out, static_cast<uint16_t>(channelCount * 2));
+    u16(out, 16);
+    out.write("data", 4);
+    u32(out, dataBytes);
+    for (uint32_t frame = 0; frame < frames; ++frame) {
+        for (const auto& channel : channels) {
+            u16(out, static_cast<uint16_t>(channel[frame]));
+        }
+    }
+}
+
+// Energy of each ear's response to an impulse from the given direction
+std::pair<double, double> EarEnergies(HRTFProcessor& processor, float azimuth) {
+    VRPose head;
+    head.position = {0.0f, 1.7f, 0.0f};
+    head.orientation = {0.0f, 0.0f, 0.0f, 1.0f};
+    head.isValid = true;
+    VRPose source = head;
+    const float radians = azimuth * static_cast<float>(M_PI) / 180.0f;
+    source.position = {std::sin(radians), 1.7f, -std::cos(radians)};
+
+    constexpr size_t FRAMES = 1024;
+    std::vector<float> input(FRAMES, 0.0f), output(FRAMES * 2);
+    for (int block = 0; block < 40; ++block) {  // Let the position smoothing settle
+        processor.UpdateSpatialPosition(head, {source});
+        processor.Process(input.data(), output.data(), FRAMES, 1);
+    }
+    input[0] = 1.0f;
+    processor.UpdateSpatialPosition(head, {source});
+    processor.Process(input.data(), output.data(), FRAMES, 1);
+
+    double left = 0.0, right = 0.0;
+    for (size_t i = 0; i < FRAMES; ++i) {
+        left += output[2 * i] * output[2 * i];
+        right += output[2 * i + 1] * output[2 * i + 1];
+    }
+    return {left, right};
+}
+
+} // namespace
+
+class HRTFDatasetTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        m_directory = std::filesystem::temp_directory_path() / "vrb_hrtf_dataset_test";
+        std::filesystem::remove_all(m_directory);
+        std::filesystem::create_directories(m_directory);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(m_directory);
+    }
+
+    std::filesystem::path m_directory;
+};
+
+TEST(WorkerPoolTest, RunsEveryTaskOnceAcrossBatches) {
+    WorkerPool pool(4);
+    EXPECT_EQ(pool.GetThreadCount(), 4u);
+
+    for (size_t batch = 0; batch < 50; ++batch) {
+        const size_t count = 1 + batch * 7;
+        std::vector<std::atomic<int>> hits(count);
+        pool.Run(count, [&](size_t i) { hits[i].fetch_add(1); });
+        for (size_t i = 0; i < count; ++i) {
+            ASSERT_EQ(hits[i].load(), 1) << "batch " << batch << " task " << i;
+        }
+    }
+    pool.Run(0, [](size_t) { FAIL(); });
+}
+
+TEST(ImpulseResponseResamplerTest, KeepsGainAndWaveform) {
+    hrtf_io::ImpulseResponseResampler resampler(44100, 48000);
+    EXPECT_FALSE(resampler.IsIdentity());
+    EXPECT_EQ(resampler.GetOutputLength(441), 480u);
+
+    // A band-limited tone lands on the same continuous waveform, scaled by 44.1/48
+    constexpr size_t LENGTH = 2205;
+    std::vector<float> tone(LENGTH);
+    for (size_t i = 0; i < LENGTH; ++i) {
+        tone[i] = static_cast<float>(std::sin(2.0 * M_PI * 3000.0 * i / 44100.0));
+    }
+    std::vector<float> output;
+    resampler.Process(tone.data(), tone.size(), output);
+    ASSERT_EQ(output.size(), 2400u);
+    double worst = 0.0;
+    for (size_t n = 200; n < output.size() - 200; ++n) {
+        const double expected = 44100.0 / 48000.0 * std::sin(2.0 * M_PI * 3000.0 * n / 48000.0);
+        worst = std::max(worst, std::abs(output[n] - expected));
+    }
+    EXPECT_LT(worst, 1e-3);
+
+    // An impulse response keeps its DC gain: the taps sum to the same total
+    std::vector<float> impulse(128, 0.0f);
+    impulse[20] = 1.0f;
+    impulse[21] = 0.5f;
+    resampler.Process(impulse.data(), impulse.size(), output);
+    EXPECT_NEAR(std::accumulate(output.begin(), output.end(), 0.0), 1.5, 1e-3);
+
+    hrtf_io::ImpulseResponseResampler identity(48000, 48000);
+    EXPECT_TRUE(identity.IsIdentity());
+    identity.Process(impulse.data(), impulse.size(), output);
+    EXPECT_EQ(output, impulse);
+}
+
+TEST_F(HRTFDatasetTest, ReadsPcmWav) {
+    const std::string path = (m_directory / "pair.wav").string();
+    WriteWav16(path, 44100, {{0, 16384, -32768}, {32767, -16384, 0}});
+
+    hrtf_io::WavData wav;
+    std::string error;
+    ASSERT_TRUE(hrtf_io::ReadWav(path, wav, error)) << error;
+    EXPECT_EQ(wav.sampleRate, 44100);
+    ASSERT_EQ(wav.channels.size(), 2u);
+    EXPECT_EQ(wav.channels[0], (std::vector<float>{0.0f, 0.5f, -1.0f}));
+    EXPECT_FLOAT_EQ(wav.channels[1][0], 32767.0f / 32768.0f);
+    EXPECT_FLOAT_EQ(wav.channels[1][1], -0.5f);
+
+    EXPECT_FALSE(hrtf_io::ReadWav((m_directory / "missing.wav").string(), wav, error));
+}
+
+TEST_F(HRTFDatasetTest, LoadsMirroredKEMARCompactLayout) {
+    // Two elevations; the right-side files carry a louder, earlier right ear
+    for (int elevation : {0, 30}) {
+        const auto directory = m_directory / ("elev" + std::to_string(elevation));
+        std::filesystem::create_directories(directory);
+        for (int azimuth = 0; azimuth <= 180; azimuth += 30) {
+            std::vector<int16_t> left(128, 0), right(128, 0);
+            const double lateral = std::sin(azimuth * M_PI / 180.0);
+            left[10 + static_cast<int>(20 * lateral)] = static_cast<int16_t>(12000 * (1.0 - 0.8 * lateral));
+            right[10] = 12000;
+            char name[32];
+            std::snprintf(name, sizeof(name), "H%de%03da.wav", elevation, azimuth);
+            WriteWav16((directory / name).string(), 44100, {left, right});
+        }
+    }
+
+    HRTFProcessor processor;
+    ASSERT_TRUE(processor.Initialize(m_directory.string()));
+    const auto right = EarEnergies(processor, 90.0f);
+    const auto left = EarEnergies(processor, -90.0f);
+    EXPECT_GT(right.second, right.first * 4.0);
+    EXPECT_GT(left.first, left.second * 4.0);
+    EXPECT_NEAR(right.second, left.first, right.second * 0.01);
+}
+
+TEST_F(HRTFDatasetTest, LoadsShippedMITKEMAR) {
+    const std::filesystem::path dataset = VRB_HRTF_DATA_DIR;
+    if (!std::filesystem::exists(dataset / "mit_kemar_compact")) {
+        GTEST_SKIP() << "MIT KEMAR compact set not found at " << dataset;
+    }
+
+    HRTFProcessor processor;
+    ASSERT_TRUE(processor.Initialize(dataset.string()));
+    const auto front = EarEnergies(processor, 0.0f);
+    const auto right = EarEnergies(processor, 90.0f);
+    const auto left = EarEnergies(processor, -90.0f);
+    EXPECT_NEAR(front.first, front.second, front.first * 0.05);
+    EXPECT_GT(right.second, right.first * 5.0);
+    EXPECT_GT(left.first, left.second * 5.0);
+}
+
+#if VRB_HAVE_SOFA
+TEST_F(HRTFDatasetTest, LoadsSOFASimpleFreeFieldHRIR) {
+    // Ring of 24 directions at 44.1 kHz; SOFA azimuths run to the left
+    constexpr hsize_t M = 24, R = 2, N = 64;
+    std::vector<double> ir(M * R * N, 0.0), positions(M * 3);
+    for (hsize_t m = 0; m < M; ++m) {
+        const double azimuth = m * 15.0;
+        positions[m * 3] = azimuth;
+        positions[m * 3 + 1] = 0.0;
+        positions[m * 3 + 2] = 1.2;
+        const double toLeft = std::sin(azimuth * M_PI / 180.0);
+        ir[(m * R + 0) * N + 4] = 0.6 * (1.0 + 0.8 * toLeft);
+        ir[(m * R + 1) * N + 4] = 0.6 * (1.0 - 0.8 * toLeft);
+    }
+
+    const std::string path = (m_directory / "ring.sofa").string();
+    {
+        const hid_t file = H5Fcreate(path.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+        auto stringAttribute = [](hid_t object, const char* name, const std::string& value) {
+            const hid_t type = H5Tcopy(H5T_C_S1);
+            H5Tset_size(type, value.size());
+            const hid_t space = H5Screate(H5S_SCALAR);
+            const hid_t attribute = H5Acreate2(object, name, type, space, H5P_DEFAULT, H5P_DEFAULT);
+            H5Awrite(attribute, type, value.data());
+            H5Aclose(attribute);
+            H5Sclose(space);
+            H5Tclose(type);
+        };
+        auto dataset = [file](const char* name, const std::vector<hsize_t>& dims, const double* data) {
+            const hid_t space = H5Screate_simple(static_cast<int>(dims.size()), dims.data(), nullptr);
+            const hid_t set = H5Dcreate2(file, name, H5T_IEEE_F64LE, space, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+            H5Dwrite(set, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, data);
+            H5Sclose(space);
+            return set;
+        };
+
+        stringAttribute(file, "Conventions", "SOFA");
+        stringAttribute(file, "SOFAConventions", "SimpleFreeFieldHRIR");
+        H5Dclose(dataset("Data.IR", {M, R, N}, ir.data()));
+        const double rate = 44100.0;
+        H5Dclose(dataset("Data.SamplingRate", {1}, &rate));
+        const double delays[2] = {0.0, 0.0};
+        H5Dclose(dataset("Data.Delay", {1, R}, delays));
+        const hid_t source = dataset("SourcePosition", {M, 3}, positions.data());
+        stringAttribute(source, "Type", "spherical");
+        stringAttribute(source, "Units", "degree, degree, metre");
+        H5Dclose(source);
+        H5Fclose(file);
+    }
+
+    hrtf_io::SOFAData sofa;
+    std::string error;
+    ASSERT_TRUE(hrtf_io::ReadSOFA(path, sofa, error)) << error;
+    EXPECT_EQ(sofa.sampleRate, 44100);
+    EXPECT_EQ(sofa.measurementCount, M);
+    EXPECT_EQ(sofa.length, N);
+    EXPECT_FLOAT_EQ(sofa.directions[6][0], -90.0f);   // SOFA 90 (left) is -90 here
+    EXPECT_FLOAT_EQ(sofa.Response(6, 0)[4], 0.6f * 1.8f);
+
+    // A directory holding only the SOFA file resolves to it
+    HRTFProcessor processor;
+    ASSERT_TRUE(processor.Initialize(m_directory.string()));
+    const auto left = EarEnergies(processor, -90.0f);
+    const auto right = EarEnergies(processor, 90.0f);
+    EXPECT_GT(left.first, left.second * 4.0);
+    EXPECT_GT(right.second, right.first * 4.0);
+}
+#endif
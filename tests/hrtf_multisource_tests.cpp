@@ -0,0 +1,224 @@
+// hrtf_multisource_tests.cpp - Multi-source HRTF rendering tests and benchmark
+// Checks the source table against the single-source path and measures sources per core
+
+#define _USE_MATH_DEFINES
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include <json/json.h>
+#include "config.h"
+#include "hrtf_processor.h"
+#include "vr_types.h"
+
+using namespace vrb;
+
+class HRTFMultiSourceTest : public ::testing::Test {
+protected:
+    void TearDown() override {
+        for (const auto& path : m_configPaths) {
+            std::filesystem::remove(path);
+        }
+    }
+
+    std::unique_ptr<HRTFProcessor> CreateProcessor(int maxSources) {
+        std::string path = "hrtf_multisource_test_" + std::to_string(m_configPaths.size()) + ".json";
+
+        Json::Value root;
+        root["hrtf"]["dataPath"] = "";
+        root["hrtf"]["maxSources"] = maxSources;
+        root["logging"]["level"] = "warn";
+
+        std::ofstream file(path);
+        Json::StreamWriterBuilder builder;
+        std::unique_ptr<Json::StreamWriter> writer(builder.newStreamWriter());
+        writer->write(root, &file);
+        file.close();
+        m_configPaths.push_back(path);
+
+        Config config(path);
+        auto processor = std::make_unique<HRTFProcessor>();
+        if (!processor->Initialize(config)) {
+            return nullptr;
+        }
+        return processor;
+    }
+
+    static std::vector<float> GenerateNoise(size_t frames, unsigned seed) {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<float> dist(-0.5f, 0.5f);
+        std::vector<float> signal(frames);
+        for (auto& sample : signal) {
+            sample = dist(rng);
+        }
+        return signal;
+    }
+
+    // Render mono inputs (one per source id, empty = silent slot) in fixed blocks
+    static std::vector<float> RenderSources(HRTFProcessor& processor, const std::vector<std::vector<float>>& inputs,
+                                            size_t totalFrames, size_t blockSize) {
+        std::vector<float> output(totalFrames * 2, 0.0f);
+        std::vector<const float*> pointers(processor.GetSourceCapacity(), nullptr);
+
+        for (size_t position = 0; position < totalFrames; position += blockSize) {
+            const size_t frames = std::min(blockSize, totalFrames - position);
+            for (size_t id = 0; id < inputs.size(); ++id) {
+                pointers[id] = inputs[id].empty() ? nullptr : inputs[id].data() + position;
+            }
+            processor.ProcessSources(pointers.data(), output.data() + position * 2, frames);
+        }
+        return output;
+    }
+
+    std::vector<std::string> m_configPaths;
+};
+
+TEST_F(HRTFMultiSourceTest, SingleSourceMatchesListenerPath) {
+    auto reference = CreateProcessor(4);
+    auto processor = CreateProcessor(4);
+    ASSERT_NE(reference, nullptr);
+    ASSERT_NE(processor, nullptr);
+
+    const Vec3 position(1.0f, 0.3f, -0.5f);
+    const size_t frames = 4096, blockSize = 256;
+    const auto input = GenerateNoise(frames, 11);
+
+    reference->SetListenerPosition(position);
+    std::vector<float> expected(frames * 2, 0.0f);
+    for (size_t offset = 0; offset < frames; offset += blockSize) {
+        reference->Process(input.data() + offset, expected.data() + offset * 2, blockSize, 1);
+    }
+
+    const int id = processor->AddSource(position);
+    ASSERT_EQ(id, 0);
+    const auto actual = RenderSources(*processor, {input}, frames, blockSize);
+
+    // The first block fades the source in; after that the two paths render the same filter
+    float maxError = 0.0f, peak = 0.0f;
+    for (size_t i = blockSize * 2; i < expected.size(); ++i) {
+        maxError = std::max(maxError, std::abs(expected[i] - actual[i]));
+        peak = std::max(peak, std::abs(expected[i]));
+    }
+    EXPECT_GT(peak, 0.01f);
+    EXPECT_LT(maxError, 1e-3f * peak);
+}
+
+TEST_F(HRTFMultiSourceTest, SourcesMixIntoSharedBus) {
+    auto combined = CreateProcessor(4);
+    auto left = CreateProcessor(4);
+    auto right = CreateProcessor(4);
+    ASSERT_NE(combined, nullptr);
+    ASSERT_NE(left, nullptr);
+    ASSERT_NE(right, nullptr);
+
+    const Vec3 leftPosition(-1.0f, 0.0f, -0.2f), rightPosition(2.0f, -0.4f, 1.0f);
+    const size_t frames = 3000, blockSize = 128;
+    const auto leftInput = GenerateNoise(frames, 3);
+    const auto rightInput = GenerateNoise(frames, 4);
+
+    ASSERT_EQ(combined->AddSource(leftPosition), 0);
+    ASSERT_EQ(combined->AddSource(rightPosition), 1);
+    ASSERT_EQ(left->AddSource(leftPosition), 0);
+    ASSERT_EQ(right->AddSource(rightPosition), 0);
+    ASSERT_TRUE(combined->SetSourceGain(1, 0.5f));
+    ASSERT_TRUE(right->SetSourceGain(0, 0.5f));
+
+    const auto mix = RenderSources(*combined, {leftInput, rightInput}, frames, blockSize);
+    const auto leftOnly = RenderSources(*left, {leftInput}, frames, blockSize);
+    const auto rightOnly = RenderSources(*right, {rightInput}, frames, blockSize);
+
+    for (size_t i = 0; i < mix.size(); ++i) {
+        ASSERT_NEAR(mix[i], leftOnly[i] + rightOnly[i], 1e-5f) << "sample " << i;
+    }
+}
+
+TEST_F(HRTFMultiSourceTest, SourceSlotsAreBoundedAndReused) {
+    auto processor = CreateProcessor(2);
+    ASSERT_NE(processor, nullptr);
+    EXPECT_EQ(processor->GetSourceCapacity(), 2u);
+
+    EXPECT_EQ(processor->AddSource(Vec3(1.0f, 0.0f, 0.0f)), 0);
+    EXPECT_EQ(processor->AddSource(Vec3(-1.0f, 0.0f, 0.0f)), 1);
+    EXPECT_EQ(processor->AddSource(Vec3(0.0f, 0.0f, -1.0f)), -1);
+    EXPECT_EQ(processor->GetSourceCount(), 2u);
+
+    EXPECT_TRUE(processor->RemoveSource(0));
+    EXPECT_FALSE(processor->RemoveSource(0));
+    EXPECT_FALSE(processor->SetSourcePosition(0, Vec3()));
+    EXPECT_EQ(processor->AddSource(Vec3(0.0f, 0.0f, -1.0f)), 0);
+    EXPECT_EQ(processor->GetSourceCount(), 2u);
+}
+
+// Sources one core sustains in real time, with every source orbiting the listener
+TEST_F(HRTFMultiSourceTest, SourcesPerCoreBenchmark) {
+    constexpr double SAMPLE_RATE = 48000.0;
+    constexpr int WARMUP_BLOCKS = 50;
+    constexpr int MEASURED_BLOCKS = 150;
+    constexpr int ROUNDS = 3;   // Best round, to keep scheduler noise out of the scaling check
+
+    for (size_t blockSize : {size_t(128), size_t(256)}) {
+        double costPerSourceSmall = 0.0, costPerSourceLarge = 0.0;
+
+        for (int sources : {4, 16, 32}) {
+            auto processor = CreateProcessor(sources);
+            ASSERT_NE(processor, nullptr);
+
+            std::vector<std::vector<float>> inputs;
+            for (int s = 0; s < sources; ++s) {
+                ASSERT_EQ(processor->AddSource(Vec3(1.0f, 0.0f, 0.0f)), s);
+                inputs.push_back(GenerateNoise(blockSize, 100 + s));
+            }
+            std::vector<const float*> pointers(processor->GetSourceCapacity(), nullptr);
+            for (int s = 0; s < sources; ++s) {
+                pointers[s] = inputs[s].data();
+            }
+            std::vector<float> output(blockSize * 2);
+
+            auto runBlock = [&](int block) {
+                // 30 degrees per second, spread evenly around the head
+                const double t = block * blockSize / SAMPLE_RATE;
+                for (int s = 0; s < sources; ++s) {
+                    const double angle = (t * 30.0 + 360.0 * s / sources) * M_PI / 180.0;
+                    processor->SetSourcePosition(s, Vec3(static_cast<float>(2.0 * std::sin(angle)), 0.0f,
+                                                         static_cast<float>(-2.0 * std::cos(angle))));
+                }
+                processor->ProcessSources(pointers.data(), output.data(), blockSize);
+            };
+
+            for (int block = 0; block < WARMUP_BLOCKS; ++block) {
+                runBlock(block);
+            }
+            double seconds = 0.0;
+            for (int round = 0; round < ROUNDS; ++round) {
+                const auto start = std::chrono::steady_clock::now();
+                for (int block = 0; block < MEASURED_BLOCKS; ++block) {
+                    runBlock(WARMUP_BLOCKS + round * MEASURED_BLOCKS + block);
+                }
+                const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                seconds = (round == 0) ? elapsed : std::min(seconds, elapsed);
+            }
+
+            const double blockSeconds = seconds / MEASURED_BLOCKS;
+            const double costPerSource = blockSeconds / sources;
+            const double sourcesPerCore = (blockSize / SAMPLE_RATE) / costPerSource;
+            std::cout << "[ BENCH    ] " << blockSize << " frames, " << std::setw(2) << sources << " sources: "
+                      << std::fixed << std::setprecision(1) << costPerSource * 1e6 << " us/source/block, "
+                      << std::setprecision(0) << sourcesPerCore << " sources per core" << std::endl;
+            RecordProperty("sourcesPerCore_" + std::to_string(blockSize) + "_" + std::to_string(sources),
+                           static_cast<int>(sourcesPerCore));
+
+            if (sources == 4) costPerSourceSmall = costPerSource;
+            if (sources == 32) costPerSourceLarge = costPerSource;
+        }
+
+        // Linear scaling: per-source cost must not grow with the source count
+        EXPECT_LT(costPerSourceLarge, costPerSourceSmall * 2.0) << blockSize << " frames";
+    }
+}
@@ -0,0 +1,100 @@
+// jack_backend_tests.cpp - Native JACK client
+// Needs a running server for the process tests, e.g. `jackd -d dummy -r 48000 -p 256`;
+// without one (or without JACK in the build) they are skipped
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <gtest/gtest.h>
+#include "jack_backend.h"
+
+using namespace vrb;
+
+namespace {
+
+struct ProcessProbe {
+    std::atomic<uint64_t> frames{0};
+    std::atomic<uint64_t> periods{0};
+    std::atomic<bool> inputsValid{true};
+};
+
+// Copies the capture into both ears and marks the right ear, so the port buffers are observably written
+void ProbeCallback(const float* const* inputs, float* left, float* right, size_t frames, void* user) {
+    auto* probe = static_cast<ProcessProbe*>(user);
+    if (!inputs[0] || !inputs[1]) {
+        probe->inputsValid = false;
+    }
+    for (size_t i = 0; i < frames; ++i) {
+        left[i] = inputs[0] ? inputs[0][i] : 0.0f;
+        right[i] = 0.25f;
+    }
+    probe->frames.fetch_add(frames);
+    probe->periods.fetch_add(1);
+}
+
+bool WaitFor(const std::atomic<uint64_t>& counter, uint64_t target, std::chrono::milliseconds timeout) {
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (counter.load() < target) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return true;
+}
+
+} // anonymous namespace
+
+TEST(JackBackendTest, RejectsInvalidOptionsWithoutAServer) {
+    JackBackend backend;
+    JackBackendOptions options;
+    options.inputChannels = 3;
+    std::string error;
+
+    EXPECT_FALSE(backend.Open(options, &ProbeCallback, nullptr, error));
+    EXPECT_FALSE(error.empty());
+    EXPECT_FALSE(backend.IsOpen());
+    EXPECT_FALSE(backend.Activate(error));
+    EXPECT_TRUE(backend.GetOutputPorts().empty());
+    EXPECT_EQ(backend.GetInputLatency(), 0.0);
+}
+
+TEST(JackBackendTest, ProcessCallbackWritesTheBinauralPorts) {
+    ProcessProbe probe;
+    JackBackend backend;
+    JackBackendOptions options;
+    options.clientName = "vrb_jack_backend_test";
+    options.inputChannels = 2;
+    options.connectInputs = false;
+    std::string error;
+    if (!backend.Open(options, &ProbeCallback, &probe, error)) {
+        GTEST_SKIP() << "JACK unavailable: " << error;
+    }
+
+    EXPECT_GT(backend.GetSampleRate(), 0);
+    EXPECT_GT(backend.GetBufferSize(), 0u);
+    EXPECT_EQ(backend.GetInputChannels(), 2);
+    const auto ports = backend.GetOutputPorts();
+    ASSERT_EQ(ports.size(), 2u);
+    EXPECT_EQ(ports[0], backend.GetClientName() + ":binaural_L");
+    EXPECT_EQ(ports[1], backend.GetClientName() + ":binaural_R");
+
+    ASSERT_TRUE(backend.Activate(error)) << error;
+    EXPECT_TRUE(backend.IsActive());
+
+    // Every period hands over whole port buffers of the server's size
+    ASSERT_TRUE(WaitFor(probe.periods, 4, std::chrono::seconds(5))) << "no process callbacks";
+    EXPECT_TRUE(probe.inputsValid);
+    EXPECT_EQ(probe.frames.load() % backend.GetBufferSize(), 0u);
+
+    // Deactivate returns after the last period; no callback runs afterwards
+    backend.Deactivate();
+    EXPECT_FALSE(backend.IsActive());
+    const uint64_t stopped = probe.periods.load();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(probe.periods.load(), stopped);
+
+    backend.Close();
+    EXPECT_FALSE(backend.IsOpen());
+}
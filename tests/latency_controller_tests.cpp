@@ -0,0 +1,146 @@
+// latency_controller_tests.cpp - Worker pipeline latency controller
+// Drives the controller with a simulated queue: each block it takes frames and the worker adds one block back
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include <gtest/gtest.h>
+#include "latency_controller.h"
+
+using namespace vrb;
+
+namespace {
+
+constexpr size_t BLOCK = 128;
+constexpr double RATE = 48000.0;
+
+LatencyControllerOptions Options(size_t initialBlocks, double holdSeconds = 5.0) {
+    LatencyControllerOptions options;
+    options.blockFrames = BLOCK;
+    options.initialFrames = initialBlocks * BLOCK;
+    options.maxFrames = 8 * BLOCK;
+    options.sampleRate = RATE;
+    options.holdSeconds = holdSeconds;
+    return options;
+}
+
+// Runs blocks through the controller; returns the queue depth afterwards
+size_t RunBlocks(LatencyController& controller, size_t queued, size_t blocks, double jitterFrames = 0.0) {
+    for (size_t i = 0; i < blocks; ++i) {
+        const size_t take = controller.Plan(queued, jitterFrames, false);
+        EXPECT_LE(take, queued);
+        EXPECT_LE(take, BLOCK + controller.GetMaxStepFrames());
+        EXPECT_GE(take, BLOCK - controller.GetMaxStepFrames());
+        queued = queued - take + BLOCK;
+    }
+    return queued;
+}
+
+size_t BlocksIn(double seconds) {
+    return static_cast<size_t>(seconds * RATE / BLOCK);
+}
+
+} // anonymous namespace
+
+TEST(LatencyControllerTest, HoldsASteadyQueueWithoutSplicing) {
+    LatencyController controller;
+    controller.Reset(Options(2));
+    EXPECT_EQ(controller.GetTargetFrames(), 2 * BLOCK);
+
+    for (int i = 0; i < 1000; ++i) {
+        ASSERT_EQ(controller.Plan(2 * BLOCK, 3.0, false), BLOCK);
+    }
+    EXPECT_EQ(controller.GetQueuedFrames(), 2 * BLOCK);
+}
+
+TEST(LatencyControllerTest, XrunsGrowTheQueueWithinItsCeiling) {
+    LatencyController controller;
+    controller.Reset(Options(2));
+
+    size_t queued = 2 * BLOCK;
+    controller.Plan(queued, 0.0, true);
+    EXPECT_EQ(controller.GetTargetFrames(), 2 * BLOCK + BLOCK / 2);
+
+    // The queue follows a few frames per block, never a whole restart
+    queued = RunBlocks(controller, queued, 200);
+    EXPECT_NEAR(static_cast<double>(queued), 2.5 * BLOCK, BLOCK / 8.0);
+
+    for (int i = 0; i < 100; ++i) {
+        controller.Plan(queued, 0.0, true);
+    }
+    EXPECT_EQ(controller.GetTargetFrames(), 8 * BLOCK);
+
+    // An underrun deepens the queue by at least the block it keeps
+    controller.Reset(Options(1));
+    controller.OnUnderrun(40);
+    EXPECT_GE(controller.GetTargetFrames(), 40 + BLOCK);
+}
+
+TEST(LatencyControllerTest, ShrinksOnlyAfterAQuietHold) {
+    LatencyController controller;
+    controller.Reset(Options(4, 1.0));
+
+    size_t queued = RunBlocks(controller, 4 * BLOCK, BlocksIn(0.9));
+    EXPECT_EQ(controller.GetTargetFrames(), 4 * BLOCK);
+
+    // Three blocks of queue were never needed; each hold gives back up to half a block
+    queued = RunBlocks(controller, queued, BlocksIn(10.0));
+    EXPECT_LT(controller.GetTargetFrames(), 2 * BLOCK);
+    EXPECT_GE(controller.GetTargetFrames(), BLOCK);
+    EXPECT_NEAR(static_cast<double>(queued), static_cast<double>(controller.GetTargetFrames()), BLOCK / 8.0);
+
+    // An xrun resets the hold, so the next shrink waits a full second again
+    const size_t settled = controller.GetTargetFrames();
+    controller.Plan(queued, 0.0, true);
+    const size_t grown = controller.GetTargetFrames();
+    EXPECT_GT(grown, settled);
+    RunBlocks(controller, queued, BlocksIn(0.9));
+    EXPECT_EQ(controller.GetTargetFrames(), grown);
+}
+
+TEST(LatencyControllerTest, CallbackJitterKeepsAMargin) {
+    LatencyController calm;
+    LatencyController jittery;
+    calm.Reset(Options(4, 0.5));
+    jittery.Reset(Options(4, 0.5));
+
+    RunBlocks(calm, 4 * BLOCK, BlocksIn(20.0), 0.0);
+    RunBlocks(jittery, 4 * BLOCK, BlocksIn(20.0), 96.0);
+    EXPECT_GT(jittery.GetTargetFrames(), calm.GetTargetFrames());
+    EXPECT_GE(jittery.GetTargetFrames(), BLOCK + 96);
+}
+
+TEST(LatencyControllerTest, StretchesANearlyFullBlockInsteadOfUnderrunning) {
+    LatencyController controller;
+    controller.Reset(Options(1));
+
+    EXPECT_EQ(controller.Plan(BLOCK - 4, 0.0, false), BLOCK - 4);
+    // Too far short to stretch: the caller sees an underrun
+    EXPECT_GT(controller.Plan(BLOCK / 2, 0.0, false), BLOCK / 2);
+}
+
+TEST(LatencyControllerTest, SplicesStayContinuous) {
+    // A 200 Hz sine: any unfaded jump of 16 frames would step far beyond one frame's change
+    const size_t frames = BLOCK;
+    const double omega = 2.0 * M_PI * 200.0 / RATE;
+    std::vector<float> source((frames + 16) * 2);
+    for (size_t i = 0; i < frames + 16; ++i) {
+        source[i * 2] = static_cast<float>(std::sin(omega * i));
+        source[i * 2 + 1] = -source[i * 2];
+    }
+    const float maxNaturalStep = static_cast<float>(omega);
+
+    for (size_t sourceFrames : {frames - 16, frames, frames + 16}) {
+        std::vector<float> output(frames * 2);
+        LatencyController::Splice(source.data(), sourceFrames, output.data(), frames, 2, 32);
+
+        // Starts where the last block left off and ends on the last source frame taken
+        EXPECT_NEAR(output[0], source[0], maxNaturalStep) << sourceFrames;
+        EXPECT_EQ(output[(frames - 1) * 2], source[(sourceFrames - 1) * 2]) << sourceFrames;
+        for (size_t i = 1; i < frames; ++i) {
+            ASSERT_LE(std::abs(output[i * 2] - output[(i - 1) * 2]), 2.0f * maxNaturalStep)
+                << "discontinuity at " << i << " taking " << sourceFrames;
+            ASSERT_EQ(output[i * 2 + 1], -output[i * 2]);
+        }
+    }
+}
@@ -0,0 +1,99 @@
+// latency_histogram_tests.cpp - Wait-free callback timing histogram
+// Bucket layout, percentile accuracy against exact order statistics, and a reader racing the writer
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "latency_histogram.h"
+
+using namespace vrb;
+using Duration = LatencyHistogram::Duration;
+
+TEST(LatencyHistogramTest, BucketsAreContiguousWithBoundedWidth) {
+    EXPECT_EQ(LatencyHistogram::BucketIndex(0), 0u);
+    EXPECT_EQ(LatencyHistogram::BucketIndex(15), 15u);
+    EXPECT_EQ(LatencyHistogram::BucketIndex(LatencyHistogram::MAX_TRACKABLE), LatencyHistogram::BUCKET_COUNT - 1);
+    EXPECT_EQ(LatencyHistogram::BucketUpperBound(LatencyHistogram::BUCKET_COUNT - 1), LatencyHistogram::MAX_TRACKABLE);
+
+    // Every bucket starts right after the previous one ends and is at most 1/16 of its values wide
+    uint64_t previousUpper = LatencyHistogram::BucketUpperBound(LatencyHistogram::SUB_BUCKETS - 1);
+    for (size_t i = LatencyHistogram::SUB_BUCKETS; i < LatencyHistogram::BUCKET_COUNT; ++i) {
+        const uint64_t lower = previousUpper + 1;
+        const uint64_t upper = LatencyHistogram::BucketUpperBound(i);
+        ASSERT_EQ(LatencyHistogram::BucketIndex(lower), i);
+        ASSERT_EQ(LatencyHistogram::BucketIndex(upper), i);
+        ASSERT_LE(upper - lower + 1, lower / LatencyHistogram::SUB_BUCKETS);
+        previousUpper = upper;
+    }
+}
+
+TEST(LatencyHistogramTest, PercentilesTrackExactOrderStatistics) {
+    // Mostly ~400us callbacks with a rare multi-millisecond tail, as on a loaded machine
+    std::mt19937 rng(5);
+    std::lognormal_distribution<double> body(std::log(400000.0), 0.2);
+    std::uniform_real_distribution<double> spike(2e6, 9e6);
+    std::uniform_int_distribution<int> pick(0, 999);
+
+    LatencyHistogram histogram;
+    std::vector<int64_t> values;
+    for (int i = 0; i < 200000; ++i) {
+        const int64_t ns = static_cast<int64_t>(pick(rng) < 3 ? spike(rng) : body(rng));
+        values.push_back(ns);
+        histogram.Record(Duration(ns));
+    }
+    std::sort(values.begin(), values.end());
+
+    EXPECT_EQ(histogram.GetCount(), values.size());
+    EXPECT_EQ(histogram.GetMax().count(), values.back());
+    for (double percentile : {50.0, 90.0, 99.0, 99.9}) {
+        const auto exact = static_cast<double>(values[static_cast<size_t>(percentile / 100.0 * values.size()) - 1]);
+        const auto reported = static_cast<double>(histogram.GetPercentile(percentile).count());
+        EXPECT_GE(reported, exact * 0.999) << "p" << percentile;
+        EXPECT_LE(reported, exact * (1.0 + 1.0 / LatencyHistogram::SUB_BUCKETS)) << "p" << percentile;
+    }
+    EXPECT_EQ(histogram.GetPercentile(100.0), histogram.GetMax());
+
+    histogram.Reset();
+    EXPECT_EQ(histogram.GetCount(), 0u);
+    EXPECT_EQ(histogram.GetPercentile(99.0).count(), 0);
+    EXPECT_EQ(histogram.GetMean().count(), 0);
+}
+
+TEST(LatencyHistogramTest, ClampsOutOfRangeValues) {
+    LatencyHistogram histogram;
+    histogram.Record(Duration(-5));
+    histogram.Record(std::chrono::seconds(30));
+    EXPECT_EQ(histogram.GetPercentile(50.0).count(), 0);
+    EXPECT_EQ(histogram.GetMax(), std::chrono::seconds(30));
+    EXPECT_EQ(histogram.GetPercentile(100.0), std::chrono::seconds(30));
+}
+
+TEST(LatencyHistogramTest, ReadersNeverBlockOrSeeGarbage) {
+    LatencyHistogram histogram;
+    std::atomic<bool> done{false};
+
+    std::thread writer([&] {
+        for (int i = 0; i < 500000; ++i) {
+            histogram.Record(Duration(1000 + (i % 7) * 100));
+        }
+        done = true;
+    });
+
+    uint64_t lastCount = 0;
+    while (!done) {
+        const uint64_t count = histogram.GetCount();
+        EXPECT_GE(count, lastCount);
+        lastCount = count;
+        const auto p99 = histogram.GetPercentile(99.0).count();
+        EXPECT_TRUE(p99 == 0 || (p99 >= 1000 && p99 <= 1600)) << p99;
+    }
+    writer.join();
+
+    EXPECT_EQ(histogram.GetCount(), 500000u);
+    EXPECT_EQ(histogram.GetMax().count(), 1600);
+}
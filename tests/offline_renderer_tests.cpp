@@ -0,0 +1,268 @@
+// offline_renderer_tests.cpp - Offline rendering of files along pose trajectories
+// WAV round trips, trajectory parsing and interpolation, and segmented renders against a single pass
+
+#define _USE_MATH_DEFINES
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include <json/json.h>
+#include "config.h"
+#include "offline_renderer.h"
+#include "pose_trajectory.h"
+#include "wav_file.h"
+
+using namespace vrb;
+
+class OfflineRendererTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        m_dir = std::filesystem::temp_directory_path() / ("vrb_offline_" + std::to_string(::testing::UnitTest::GetInstance()->random_seed()));
+        std::filesystem::create_directories(m_dir);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(m_dir);
+    }
+
+    std::string Path(const std::string& name) const {
+        return (m_dir / name).string();
+    }
+
+    std::string WriteConfig(int sampleRate) const {
+        Json::Value root;
+        root["audio"]["pipeline"]["sampleRate"] = sampleRate;
+        root["hrtf"]["dataPath"] = "";
+        root["hrtf"]["filterCacheSize"] = 0;   // Every block recomputes its filter, so renders are deterministic
+        root["logging"]["level"] = "warn";
+
+        const std::string path = Path("config.json");
+        std::ofstream file(path);
+        Json::StreamWriterBuilder builder;
+        std::unique_ptr<Json::StreamWriter> writer(builder.newStreamWriter());
+        writer->write(root, &file);
+        return path;
+    }
+
+    static std::vector<float> Noise(size_t samples, unsigned seed) {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<float> dist(-0.5f, 0.5f);
+        std::vector<float> signal(samples);
+        for (auto& sample : signal) {
+            sample = dist(rng);
+        }
+        return signal;
+    }
+
+    static std::vector<float> ReadAll(const std::string& path, WavInfo& info) {
+        WavReader reader;
+        std::string error;
+        EXPECT_TRUE(reader.Open(path, error)) << error;
+        info = reader.GetInfo();
+        std::vector<float> samples(info.frames * info.channels);
+        EXPECT_EQ(reader.Read(samples.data(), info.frames), info.frames);
+        return samples;
+    }
+
+    std::filesystem::path m_dir;
+};
+
+TEST_F(OfflineRendererTest, WavFilesRoundTripInEveryFormat) {
+    const auto signal = Noise(3000 * 2, 1);
+
+    for (WavSampleFormat format : {WavSampleFormat::Int16, WavSampleFormat::Int24,
+                                   WavSampleFormat::Int32, WavSampleFormat::Float32}) {
+        const std::string path = Path("roundtrip.wav");
+        WavWriter writer;
+        std::string error;
+        ASSERT_TRUE(writer.Open(path, 44100, 2, format, error)) << error;
+        writer.SetDither(false);
+        ASSERT_TRUE(writer.Write(signal.data(), 1000));
+        ASSERT_TRUE(writer.Write(signal.data() + 2000, 2000));
+        ASSERT_TRUE(writer.Close());
+
+        WavInfo info;
+        const auto decoded = ReadAll(path, info);
+        EXPECT_EQ(info.sampleRate, 44100);
+        EXPECT_EQ(info.channels, 2);
+        EXPECT_EQ(info.format, format);
+        ASSERT_EQ(info.frames, 3000u);
+        EXPECT_EQ(std::filesystem::file_size(path), 44u + 3000u * 2 * GetWavSampleBytes(format));
+
+        const float tolerance = format == WavSampleFormat::Int16 ? 1.0f / 32767.0f
+                              : format == WavSampleFormat::Float32 ? 0.0f : 1.0f / 8388607.0f;
+        for (size_t i = 0; i < decoded.size(); ++i) {
+            ASSERT_NEAR(decoded[i], signal[i], tolerance) << "sample " << i;
+        }
+    }
+}
+
+TEST_F(OfflineRendererTest, ReservedFilesAreFilledThroughRegions) {
+    const std::string path = Path("regions.wav");
+    const auto signal = Noise(4096 * 2, 2);
+    std::string error;
+    {
+        WavWriter writer;
+        ASSERT_TRUE(writer.Open(path, 48000, 2, WavSampleFormat::Int24, error)) << error;
+        ASSERT_TRUE(writer.Reserve(4096));
+        ASSERT_TRUE(writer.Close());
+    }
+
+    // Fill the second half before the first, as parallel segments might
+    for (uint64_t start : {2048u, 0u}) {
+        WavWriter region;
+        ASSERT_TRUE(region.OpenRegion(path, start, error)) << error;
+        region.SetDither(false);
+        ASSERT_TRUE(region.Write(signal.data() + start * 2, 2048));
+        ASSERT_TRUE(region.Close());
+    }
+    WavWriter pastEnd;
+    EXPECT_FALSE(pastEnd.OpenRegion(path, 5000, error));
+
+    WavInfo info;
+    const auto decoded = ReadAll(path, info);
+    ASSERT_EQ(info.frames, 4096u);
+    for (size_t i = 0; i < decoded.size(); ++i) {
+        ASSERT_NEAR(decoded[i], signal[i], 1.0f / 8388607.0f) << "sample " << i;
+    }
+
+    WavReader reader;
+    ASSERT_TRUE(reader.Open(path, error));
+    ASSERT_TRUE(reader.Seek(4000));
+    std::vector<float> tail(200 * 2);
+    EXPECT_EQ(reader.Read(tail.data(), 200), 96u);
+    EXPECT_FALSE(reader.Seek(4097));
+}
+
+TEST_F(OfflineRendererTest, TrajectoriesParseAndInterpolate) {
+    const std::string path = Path("trajectory.csv");
+    {
+        std::ofstream file(path);
+        file << "# recorded session\n"
+             << "time,head_x,head_y,head_z,head_qw,head_qx,head_qy,head_qz,mic_x,mic_y,mic_z,mic_qw,mic_qx,mic_qy,mic_qz\n"
+             << "0.0, 0,1.7,0, 1,0,0,0, 1,1.7,0, 1,0,0,0\n"
+             << "\n"
+             << "2.0, 0,1.7,0, 0.7071068,0,0.7071068,0, -1,1.7,2, 1,0,0,0\n";
+    }
+
+    PoseTrajectory trajectory;
+    std::string error;
+    ASSERT_TRUE(trajectory.Load(path, error)) << error;
+    EXPECT_EQ(trajectory.size(), 2u);
+    EXPECT_DOUBLE_EQ(trajectory.GetDuration(), 2.0);
+
+    VRPose head, mic;
+    trajectory.Sample(1.0, head, mic);
+    EXPECT_TRUE(head.isValid);
+    EXPECT_TRUE(mic.isValid);
+    EXPECT_NEAR(mic.position.x, 0.0f, 1e-6f);
+    EXPECT_NEAR(mic.position.z, 1.0f, 1e-6f);
+    // Halfway through a 90 degree yaw
+    EXPECT_NEAR(head.orientation.w, std::cos(M_PI / 8), 1e-5);
+    EXPECT_NEAR(head.orientation.y, std::sin(M_PI / 8), 1e-5);
+
+    // Held outside the keyframes
+    trajectory.Sample(-1.0, head, mic);
+    EXPECT_FLOAT_EQ(mic.position.x, 1.0f);
+    trajectory.Sample(10.0, head, mic);
+    EXPECT_FLOAT_EQ(mic.position.z, 2.0f);
+
+    // Short rows place only the microphone; malformed and backwards rows are rejected
+    {
+        std::ofstream file(path);
+        file << "0 0 0 -1\n0.5 1 0 0\n";
+    }
+    ASSERT_TRUE(trajectory.Load(path, error)) << error;
+    trajectory.Sample(0.25, head, mic);
+    EXPECT_NEAR(mic.position.x, 0.5f, 1e-6f);
+    EXPECT_NEAR(mic.position.z, -0.5f, 1e-6f);
+    EXPECT_FLOAT_EQ(head.orientation.w, 1.0f);
+
+    {
+        std::ofstream file(path);
+        file << "0,0,0,-1\n1,0,0\n";
+    }
+    EXPECT_FALSE(trajectory.Load(path, error));
+    {
+        std::ofstream file(path);
+        file << "1,0,0,-1\n0,0,0,-1\n";
+    }
+    EXPECT_FALSE(trajectory.Load(path, error));
+}
+
+TEST_F(OfflineRendererTest, SegmentedRenderMatchesASinglePass) {
+    const int sampleRate = 48000;
+    const size_t frames = 48000 * 2 + 123;  // Not a multiple of the block
+    const std::string input = Path("input.wav");
+    {
+        const auto signal = Noise(frames, 3);
+        WavWriter writer;
+        std::string error;
+        ASSERT_TRUE(writer.Open(input, sampleRate, 1, WavSampleFormat::Float32, error)) << error;
+        ASSERT_TRUE(writer.Write(signal.data(), frames));
+        ASSERT_TRUE(writer.Close());
+    }
+
+    // The microphone circles the head once over the file
+    PoseTrajectory trajectory;
+    for (int step = 0; step <= 32; ++step) {
+        const double angle = 2.0 * M_PI * step / 32;
+        PoseKeyframe keyframe;
+        keyframe.time = 2.0 * step / 32;
+        keyframe.head.isValid = true;
+        keyframe.microphone.position = Vec3(static_cast<float>(std::sin(angle)), 0.0f,
+                                            static_cast<float>(-std::cos(angle)));
+        keyframe.microphone.isValid = true;
+        ASSERT_TRUE(trajectory.Add(keyframe));
+    }
+
+    Config config(WriteConfig(sampleRate));
+    OfflineRenderer renderer(config);
+
+    OfflineRenderOptions single;
+    single.segments = 1;
+    single.threads = 1;
+    const auto reference = renderer.Render(input, trajectory, Path("single.wav"), single);
+    ASSERT_TRUE(reference.success) << reference.error;
+    EXPECT_EQ(reference.frames, frames);
+    EXPECT_EQ(reference.segments, 1u);
+    EXPECT_GT(reference.samplesPerSecond, 0.0);
+
+    OfflineRenderOptions split;
+    split.segments = 5;
+    split.threads = 3;
+    const auto segmented = renderer.Render(input, trajectory, Path("split.wav"), split);
+    ASSERT_TRUE(segmented.success) << segmented.error;
+    EXPECT_EQ(segmented.segments, 5u);
+
+    WavInfo singleInfo, splitInfo;
+    const auto a = ReadAll(Path("single.wav"), singleInfo);
+    const auto b = ReadAll(Path("split.wav"), splitInfo);
+    ASSERT_EQ(singleInfo.frames, frames);
+    ASSERT_EQ(splitInfo.frames, frames);
+    EXPECT_EQ(splitInfo.channels, 2);
+
+    double energy = 0.0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        ASSERT_NEAR(a[i], b[i], 1e-4f) << "frame " << i / 2;
+        energy += static_cast<double>(a[i]) * a[i];
+    }
+    EXPECT_GT(energy, 0.0);
+
+    // Inputs at another rate than the processing rate are refused
+    {
+        WavWriter writer;
+        std::string error;
+        ASSERT_TRUE(writer.Open(input, 44100, 1, WavSampleFormat::Int16, error));
+        std::vector<float> silence(256);
+        ASSERT_TRUE(writer.Write(silence.data(), silence.size()));
+    }
+    const auto mismatched = renderer.Render(input, trajectory, Path("mismatch.wav"));
+    EXPECT_FALSE(mismatched.success);
+    EXPECT_FALSE(mismatched.error.empty());
+}
@@ -0,0 +1,134 @@
+// rt_log_tests.cpp - Deferred real-time logging channel
+// Deferred formatting, repeat coalescing, overflow accounting and a producer racing the drain thread
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "rt_log.h"
+
+using namespace vrb;
+
+namespace {
+
+struct EmittedLine {
+    spdlog::level::level_enum level;
+    std::string message;
+};
+
+class RtLogTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        rtlog::SetLevel(spdlog::level::trace);
+        rtlog::GetDrainer().Drain(true);            // Discard anything left by earlier tests
+        rtlog::GetDrainer().SetRateLimit(std::chrono::milliseconds(1000));
+        rtlog::GetDrainer().SetSink([this](const rtlog::Site& site, rtlog::Drainer::Clock::time_point,
+                                           std::string_view message) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_captured.push_back({site.level, std::string(message)});
+        });
+    }
+
+    void TearDown() override {
+        rtlog::GetDrainer().Stop();
+        rtlog::SetLevel(spdlog::level::info);
+    }
+
+    std::vector<EmittedLine> Messages() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_captured;
+    }
+
+    std::mutex m_mutex;
+    std::vector<EmittedLine> m_captured;
+};
+
+enum class Stage { Input = 3 };
+
+} // namespace
+
+TEST_F(RtLogTest, FormatsOnlyWhenDrained) {
+    rtlog::RegisterThread("test");
+    RT_LOG_WARN("Underflow {} at {:.2f}ms, ok={}, stage={}, frames={}", -3, 1.2345, true, Stage::Input, 256u);
+    EXPECT_TRUE(Messages().empty());
+
+    rtlog::GetDrainer().Drain();
+    const auto captured = Messages();
+    ASSERT_EQ(captured.size(), 1u);
+    EXPECT_EQ(captured[0].level, spdlog::level::warn);
+    EXPECT_EQ(captured[0].message, "[test] Underflow -3 at 1.23ms, ok=true, stage=3, frames=256");
+}
+
+TEST_F(RtLogTest, FiltersBelowLevelAtTheCallSite) {
+    rtlog::SetLevel(spdlog::level::warn);
+    RT_LOG_DEBUG("Filtered {}", 1);
+    RT_LOG_ERROR("Kept {}", 2);
+    rtlog::GetDrainer().Drain();
+    const auto captured = Messages();
+    ASSERT_EQ(captured.size(), 1u);
+    EXPECT_NE(captured[0].message.find("Kept 2"), std::string::npos);
+}
+
+TEST_F(RtLogTest, CoalescesRepeatsWithinTheWindow) {
+    for (int i = 0; i < 100; ++i) {
+        RT_LOG_WARN("XRun {}", i);
+    }
+    RT_LOG_INFO("Other site");
+    rtlog::GetDrainer().Drain();
+
+    auto captured = Messages();
+    ASSERT_EQ(captured.size(), 2u);
+    EXPECT_NE(captured[0].message.find("XRun 0"), std::string::npos);
+    EXPECT_NE(captured[1].message.find("Other site"), std::string::npos);
+
+    // The summary carries the latest values and the number folded into it
+    rtlog::GetDrainer().Drain(true);
+    captured = Messages();
+    ASSERT_EQ(captured.size(), 3u);
+    EXPECT_NE(captured[2].message.find("XRun 99 (repeated 99 times)"), std::string::npos) << captured[2].message;
+}
+
+TEST_F(RtLogTest, ReportsRecordsDroppedOnOverflow) {
+    rtlog::GetDrainer().SetRateLimit(std::chrono::milliseconds(0));
+    for (size_t i = 0; i < rtlog::CHANNEL_CAPACITY + 10; ++i) {
+        RT_LOG_INFO("Record {}", i);
+    }
+    rtlog::GetDrainer().Drain();
+
+    const auto captured = Messages();
+    ASSERT_EQ(captured.size(), rtlog::CHANNEL_CAPACITY + 1);
+    EXPECT_NE(captured.back().message.find("dropped 10 records"), std::string::npos) << captured.back().message;
+}
+
+TEST_F(RtLogTest, ProducerNeverBlocksOnTheDrainThread) {
+    rtlog::GetDrainer().SetRateLimit(std::chrono::milliseconds(0));
+    std::atomic<size_t> emitted{0};
+    rtlog::GetDrainer().Start([&](const rtlog::Site& site, rtlog::Drainer::Clock::time_point, std::string_view) {
+        if (site.level == spdlog::level::debug) {
+            emitted++;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(20));     // A slow sink
+    });
+
+    std::atomic<size_t> dropped{0};
+    std::thread producer([&] {
+        rtlog::RegisterThread("producer");
+        for (int i = 0; i < 20000; ++i) {
+            RT_LOG_DEBUG("Block {}", i);
+        }
+    });
+    producer.join();
+    rtlog::GetDrainer().Stop();
+
+    // Every record is either emitted or counted as dropped; none are lost silently
+    for (const auto& channel : rtlog::g_channels) {
+        if (std::string(channel.GetName()) == "producer") {
+            dropped = channel.GetDropped();
+        }
+    }
+    EXPECT_EQ(emitted + dropped, 20000u);
+    EXPECT_GT(emitted.load(), 0u);
+}
@@ -0,0 +1,263 @@
+// shared_output_tests.cpp - Shared-memory binaural output bus
+// Writer and reader in one process share the segment exactly as separate processes do;
+// the fork test checks that a second process actually sees it
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "shared_output.h"
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+using namespace vrb;
+
+namespace {
+
+// Unique per process so parallel ctest runs never share a segment
+std::string TestName(const char* suffix) {
+#ifdef _WIN32
+    return std::string("vrb_test_") + suffix;
+#else
+    return "/vrb_test_" + std::to_string(getpid()) + "_" + suffix;
+#endif
+}
+
+// Frame n carries (n, -n) so any reordering or loss is visible
+std::vector<float> Ramp(uint64_t start, size_t frames) {
+    std::vector<float> block(frames * 2);
+    for (size_t i = 0; i < frames; ++i) {
+        block[i * 2] = static_cast<float>(start + i);
+        block[i * 2 + 1] = -static_cast<float>(start + i);
+    }
+    return block;
+}
+
+} // anonymous namespace
+
+TEST(SharedOutputTest, ReaderSeesFramesWrittenAfterAttach) {
+    const std::string name = TestName("roundtrip");
+    SharedOutputWriter writer;
+    std::string error;
+    ASSERT_TRUE(writer.Open(name, 48000, 1000, error)) << error;
+    EXPECT_EQ(writer.GetCapacity(), 1024u);
+
+    // Frames published before a reader attaches are not replayed to it
+    writer.Write(Ramp(0, 100).data(), 100);
+
+    SharedOutputReader reader;
+    ASSERT_TRUE(reader.Attach(name, error)) << error;
+    EXPECT_EQ(reader.GetSampleRate(), 48000);
+    EXPECT_EQ(reader.GetChannels(), 2);
+    EXPECT_EQ(writer.GetReaderCount(), 1u);
+    EXPECT_EQ(reader.Available(), 0u);
+
+    // Planar and interleaved writes land identically, across the ring's wrap point
+    for (uint64_t start = 100; start < 3000; start += 300) {
+        const auto block = Ramp(start, 300);
+        if (start % 600 == 100) {
+            writer.Write(block.data(), 300);
+        } else {
+            std::vector<float> left(300), right(300);
+            for (size_t i = 0; i < 300; ++i) {
+                left[i] = block[i * 2];
+                right[i] = block[i * 2 + 1];
+            }
+            writer.WritePlanar(left.data(), right.data(), 300);
+        }
+
+        std::vector<float> out(300 * 2);
+        ASSERT_EQ(reader.Read(out.data(), 300), 300u);
+        EXPECT_EQ(out, block) << "block at frame " << start;
+    }
+    EXPECT_EQ(reader.GetOverrunFrames(), 0u);
+    EXPECT_EQ(reader.GetPosition(), writer.GetFramesWritten());
+
+    writer.AddSourceXruns(3);
+    EXPECT_EQ(reader.GetSourceXruns(), 3u);
+
+    reader.Detach();
+    EXPECT_EQ(writer.GetReaderCount(), 0u);
+}
+
+TEST(SharedOutputTest, LappedReaderSkipsAheadAndCountsTheLoss) {
+    const std::string name = TestName("lapped");
+    SharedOutputWriter writer;
+    std::string error;
+    ASSERT_TRUE(writer.Open(name, 48000, 256, error)) << error;
+    SharedOutputReader reader;
+    ASSERT_TRUE(reader.Attach(name, error)) << error;
+
+    // A stalled reader never holds the producer up: it loses the oldest frames instead
+    for (uint64_t start = 0; start < 1000; start += 100) {
+        writer.Write(Ramp(start, 100).data(), 100);
+    }
+    EXPECT_EQ(reader.Available(), writer.GetCapacity());
+
+    std::vector<float> out(writer.GetCapacity() * 2);
+    const size_t read = reader.Read(out.data(), writer.GetCapacity());
+    const uint64_t first = 1000 - writer.GetCapacity() / 2;
+    ASSERT_EQ(read, writer.GetCapacity() / 2);
+    EXPECT_EQ(out[0], static_cast<float>(first));
+    EXPECT_EQ(out[(read - 1) * 2 + 1], -999.0f);
+    EXPECT_EQ(reader.GetOverrunFrames(), first);
+
+    // Blocks larger than the ring keep their newest frames
+    writer.Write(Ramp(1000, 1000).data(), 1000);
+    EXPECT_EQ(writer.GetFramesWritten(), 2000u);
+}
+
+TEST(SharedOutputTest, WaitWakesOnPublish) {
+    const std::string name = TestName("wake");
+    SharedOutputWriter writer;
+    std::string error;
+    ASSERT_TRUE(writer.Open(name, 48000, 4096, error)) << error;
+    SharedOutputReader reader;
+    ASSERT_TRUE(reader.Attach(name, error)) << error;
+
+    EXPECT_EQ(reader.Wait(std::chrono::milliseconds(20)), 0u);
+
+    std::thread producer([&writer] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        writer.Write(Ramp(0, 64).data(), 64);
+    });
+    const auto start = std::chrono::steady_clock::now();
+    const size_t available = reader.Wait(std::chrono::seconds(5));
+    const auto waited = std::chrono::steady_clock::now() - start;
+    producer.join();
+
+    EXPECT_EQ(available, 64u);
+    EXPECT_LT(waited, std::chrono::seconds(2)) << "reader slept through the publish";
+}
+
+TEST(SharedOutputTest, ReaderNoticesProducerRestart) {
+    const std::string name = TestName("restart");
+    SharedOutputReader reader;
+    std::string error;
+    EXPECT_FALSE(reader.Attach(name, error));
+    EXPECT_FALSE(error.empty());
+
+    SharedOutputWriter writer;
+    ASSERT_TRUE(writer.Open(name, 48000, 1024, error)) << error;
+    ASSERT_TRUE(reader.Attach(name, error)) << error;
+    EXPECT_FALSE(reader.IsProducerGone());
+
+    // A new stream at another rate replaces the segment; the old reader must re-attach
+    ASSERT_TRUE(writer.Open(name, 44100, 1024, error)) << error;
+    EXPECT_TRUE(reader.IsProducerGone());
+    writer.Write(Ramp(0, 32).data(), 32);
+    std::vector<float> out(64);
+    EXPECT_EQ(reader.Read(out.data(), 32), 0u);
+
+    ASSERT_TRUE(reader.Attach(name, error)) << error;
+    EXPECT_EQ(reader.GetSampleRate(), 44100);
+
+    writer.Close();
+    EXPECT_TRUE(reader.IsProducerGone());
+    EXPECT_FALSE(reader.Attach(name, error));
+}
+
+#ifdef __linux__
+TEST(SharedOutputTest, ReaderOneRingBehindSkipsTheBlockInFlight) {
+    const std::string name = TestName("inflight");
+    SharedOutputWriter writer;
+    std::string error;
+    ASSERT_TRUE(writer.Open(name, 48000, 1024, error)) << error;
+    const size_t capacity = writer.GetCapacity();
+    SharedOutputReader reader;
+    ASSERT_TRUE(reader.Attach(name, error)) << error;
+
+    // Exactly one ring behind with the producer idle: every frame is still there
+    for (uint64_t start = 0; start < capacity; start += 128) {
+        writer.Write(Ramp(start, 128).data(), 128);
+    }
+    std::vector<float> out(capacity * 2);
+    ASSERT_EQ(reader.Read(out.data(), capacity), capacity);
+    EXPECT_EQ(out, Ramp(0, capacity));
+    EXPECT_EQ(reader.GetOverrunFrames(), 0u);
+
+    for (uint64_t start = capacity; start < 2 * capacity; start += 128) {
+        writer.Write(Ramp(start, 128).data(), 128);
+    }
+
+    // Stop the producer between copying its next block in and publishing it, through a second mapping
+    const int fd = shm_open(name.c_str(), O_RDWR, 0);
+    ASSERT_GE(fd, 0);
+    const size_t bytes = SharedOutputFormat::HEADER_BYTES + capacity * 2 * sizeof(float);
+    void* view = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    ASSERT_NE(view, MAP_FAILED);
+    auto* header = static_cast<SharedOutputHeader*>(view);
+    auto* ring = reinterpret_cast<float*>(static_cast<uint8_t*>(view) + SharedOutputFormat::HEADER_BYTES);
+    const uint64_t written = header->writeFrames.load();
+    header->writingFrames.store(written + 128);
+    const auto next = Ramp(written, 128);
+    std::copy(next.begin(), next.end(), ring);
+
+    // The reader's oldest frames are being overwritten, so it must not hand them out
+    const size_t read = reader.Read(out.data(), capacity);
+    const uint64_t first = written + 128 - capacity / 2;
+    ASSERT_EQ(read, written - first);
+    for (size_t i = 0; i < read; ++i) {
+        ASSERT_EQ(out[i * 2], static_cast<float>(first + i)) << "frame " << i;
+    }
+    EXPECT_EQ(reader.GetOverrunFrames(), first - capacity);
+    munmap(view, bytes);
+}
+
+TEST(SharedOutputTest, SecondProcessReadsTheStream) {
+    const std::string name = TestName("fork");
+    SharedOutputWriter writer;
+    std::string error;
+    ASSERT_TRUE(writer.Open(name, 48000, 8192, error)) << error;
+
+    const pid_t child = fork();
+    ASSERT_GE(child, 0);
+    if (child == 0) {
+        // Exit code 0 only if every frame arrived in order
+        SharedOutputReader reader;
+        std::string childError;
+        if (!reader.Attach(name, childError)) {
+            _exit(10);
+        }
+        uint64_t expected = reader.GetPosition();
+        std::vector<float> out(256 * 2);
+        while (expected < 4096) {
+            if (reader.Wait(std::chrono::seconds(5)) == 0) {
+                _exit(11);
+            }
+            const size_t got = reader.Read(out.data(), 256);
+            for (size_t i = 0; i < got; ++i, ++expected) {
+                if (out[i * 2] != static_cast<float>(expected) || out[i * 2 + 1] != -static_cast<float>(expected)) {
+                    _exit(12);
+                }
+            }
+        }
+        _exit(reader.GetOverrunFrames() == 0 ? 0 : 13);
+    }
+
+    // Publish in device-sized blocks once the child is following
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (writer.GetReaderCount() == 0 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ASSERT_EQ(writer.GetReaderCount(), 1u);
+    for (uint64_t start = 0; start < 4096; start += 128) {
+        writer.Write(Ramp(start, 128).data(), 128);
+        std::this_thread::sleep_for(std::chrono::microseconds(500));
+    }
+
+    int status = 0;
+    ASSERT_EQ(waitpid(child, &status, 0), child);
+    ASSERT_TRUE(WIFEXITED(status));
+    EXPECT_EQ(WEXITSTATUS(status), 0);
+}
+#endif
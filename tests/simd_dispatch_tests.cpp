@@ -0,0 +1,281 @@
+// simd_dispatch_tests.cpp - SIMD kernel dispatch tests
+// Every variant built for this CPU must match the scalar reference kernels
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "simd/audio_simd.h"
+#include "simd/simd_dispatch.h"
+
+using namespace vrb;
+
+class SIMDDispatchTest : public ::testing::Test {
+protected:
+    // Odd sizes exercise both the vector body and the scalar tail
+    static constexpr size_t SIZE = 1037;
+
+    void SetUp() override {
+        std::mt19937 rng(1234);
+        std::uniform_real_distribution<float> dist(-1.2f, 1.2f);
+        for (auto* buffer : {&m_a, &m_b, &m_c}) {
+            buffer->resize(2 * SIZE + 4);
+            for (auto& v : *buffer) v = dist(rng);
+        }
+        // Full-scale edges and exact halves for the conversion rounding checks
+        m_a[0] = 1.0f;
+        m_a[1] = -1.0f;
+        m_a[2] = 0.5f / 32767.0f;
+        m_a[3] = 1.5f / 32767.0f;
+    }
+
+    void TearDown() override {
+        simd::initialize("auto");
+    }
+
+    // Tables that are built and runnable on this CPU, excluding the scalar reference
+    static std::vector<const simd::KernelTable*> VectorTables() {
+        std::vector<const simd::KernelTable*> tables;
+        const simd::Level detected = simd::detectLevel();
+        for (const auto* table : {simd::sse2Kernels(), simd::avx2Kernels(), simd::avx512Kernels()}) {
+            if (table && table->level <= detected) tables.push_back(table);
+        }
+        return tables;
+    }
+
+    static void ExpectNear(const std::vector<float>& expected, const std::vector<float>& actual,
+                           float tolerance, const char* kernel, const simd::KernelTable* table) {
+        ASSERT_EQ(expected.size(), actual.size());
+        for (size_t i = 0; i < expected.size(); ++i) {
+            ASSERT_NEAR(expected[i], actual[i], tolerance)
+                << kernel << " (" << simd::levelName(table->level) << ") differs at " << i;
+        }
+    }
+
+    std::vector<float> m_a, m_b, m_c;
+};
+
+TEST_F(SIMDDispatchTest, FloatKernelsMatchScalarReference) {
+    const simd::KernelTable& ref = *simd::scalarKernels();
+
+    for (const auto* table : VectorTables()) {
+        EXPECT_NEAR(ref.calculateRMS(m_a.data(), SIZE), table->calculateRMS(m_a.data(), SIZE), 1e-5f);
+        EXPECT_EQ(ref.calculatePeak(m_a.data(), SIZE), table->calculatePeak(m_a.data(), SIZE));
+
+        std::vector<float> expected(m_b.begin(), m_b.begin() + SIZE), actual = expected;
+        ref.mixBuffers(expected.data(), m_a.data(), SIZE, 0.7f);
+        table->mixBuffers(actual.data(), m_a.data(), SIZE, 0.7f);
+        ExpectNear(expected, actual, 1e-6f, "mixBuffers", table);
+
+        expected.assign(m_a.begin(), m_a.begin() + SIZE);
+        actual = expected;
+        ref.applyGainWithFade(expected.data(), SIZE, 0.2f, 0.9f);
+        table->applyGainWithFade(actual.data(), SIZE, 0.2f, 0.9f);
+        ExpectNear(expected, actual, 1e-6f, "applyGainWithFade", table);
+
+        ref.weightedSum3(expected.data(), m_a.data(), m_b.data(), m_c.data(), 0.5f, 0.3f, 0.2f, SIZE);
+        table->weightedSum3(actual.data(), m_a.data(), m_b.data(), m_c.data(), 0.5f, 0.3f, 0.2f, SIZE);
+        ExpectNear(expected, actual, 1e-6f, "weightedSum3", table);
+
+        const float coefficients[4] = {-0.0625f, 0.5625f, 0.5625f, -0.0625f};
+        ref.applyFIR4(expected.data(), m_a.data(), coefficients, SIZE);
+        table->applyFIR4(actual.data(), m_a.data(), coefficients, SIZE);
+        ExpectNear(expected, actual, 1e-6f, "applyFIR4", table);
+
+        EXPECT_NEAR(ref.dotProduct(m_a.data(), m_b.data(), SIZE), table->dotProduct(m_a.data(), m_b.data(), SIZE), 1e-3f)
+            << "dotProduct (" << simd::levelName(table->level) << ")";
+        EXPECT_NEAR(ref.dotProduct(m_a.data(), m_b.data(), 13), table->dotProduct(m_a.data(), m_b.data(), 13), 1e-5f)
+            << "dotProduct (" << simd::levelName(table->level) << ")";
+
+        std::vector<float> stereoExpected(2 * SIZE), stereoActual(2 * SIZE);
+        ref.monoToStereo(m_a.data(), stereoExpected.data(), SIZE);
+        table->monoToStereo(m_a.data(), stereoActual.data(), SIZE);
+        ExpectNear(stereoExpected, stereoActual, 0.0f, "monoToStereo", table);
+    }
+}
+
+TEST_F(SIMDDispatchTest, ComplexKernelsMatchScalarReference) {
+    const simd::KernelTable& ref = *simd::scalarKernels();
+
+    for (const auto* table : VectorTables()) {
+        std::vector<float> expected(2 * SIZE), actual(2 * SIZE);
+        ref.complexMultiply(m_a.data(), m_b.data(), expected.data(), SIZE);
+        table->complexMultiply(m_a.data(), m_b.data(), actual.data(), SIZE);
+        ExpectNear(expected, actual, 1e-6f, "complexMultiply", table);
+
+        expected.assign(m_c.begin(), m_c.begin() + 2 * SIZE);
+        actual = expected;
+        ref.complexMultiplyAccumulate(m_a.data(), m_b.data(), expected.data(), SIZE);
+        table->complexMultiplyAccumulate(m_a.data(), m_b.data(), actual.data(), SIZE);
+        ExpectNear(expected, actual, 1e-6f, "complexMultiplyAccumulate", table);
+    }
+}
+
+TEST_F(SIMDDispatchTest, ConversionsMatchScalarReferenceExactly) {
+    const simd::KernelTable& ref = *simd::scalarKernels();
+
+    std::vector<int16_t> int16In(SIZE);
+    std::vector<int32_t> int32In(SIZE);
+    std::vector<uint8_t> int24In(3 * SIZE);
+    for (size_t i = 0; i < SIZE; ++i) {
+        int16In[i] = static_cast<int16_t>(static_cast<int32_t>(i * 2654435761u) >> 16);
+        int32In[i] = static_cast<int32_t>(i * 2654435761u);
+    }
+    for (size_t i = 0; i < int24In.size(); ++i) {
+        int24In[i] = static_cast<uint8_t>((i * 2654435761u) >> 24);
+    }
+    int16In[0] = INT16_MIN;
+    int32In[0] = INT32_MIN;
+    int32In[1] = INT32_MAX;
+
+    for (const auto* table : VectorTables()) {
+        std::vector<int16_t> int16Expected(SIZE), int16Actual(SIZE);
+        ref.convertFloatToInt16(m_a.data(), int16Expected.data(), SIZE);
+        table->convertFloatToInt16(m_a.data(), int16Actual.data(), SIZE);
+        EXPECT_EQ(int16Expected, int16Actual) << simd::levelName(table->level);
+
+        std::vector<int32_t> int32Expected(SIZE), int32Actual(SIZE);
+        ref.convertFloatToInt32(m_a.data(), int32Expected.data(), SIZE);
+        table->convertFloatToInt32(m_a.data(), int32Actual.data(), SIZE);
+        EXPECT_EQ(int32Expected, int32Actual) << simd::levelName(table->level);
+
+        std::vector<float> floatExpected(SIZE), floatActual(SIZE);
+        ref.convertInt16ToFloat(int16In.data(), floatExpected.data(), SIZE);
+        table->convertInt16ToFloat(int16In.data(), floatActual.data(), SIZE);
+        EXPECT_EQ(floatExpected, floatActual) << simd::levelName(table->level);
+
+        ref.convertInt32ToFloat(int32In.data(), floatExpected.data(), SIZE);
+        table->convertInt32ToFloat(int32In.data(), floatActual.data(), SIZE);
+        EXPECT_EQ(floatExpected, floatActual) << simd::levelName(table->level);
+
+        // Packed 24-bit; the guard byte past the end must survive every store
+        std::vector<uint8_t> int24Expected(3 * SIZE + 1, 0xAB), int24Actual(3 * SIZE + 1, 0xAB);
+        ref.convertFloatToInt24(m_a.data(), int24Expected.data(), SIZE);
+        table->convertFloatToInt24(m_a.data(), int24Actual.data(), SIZE);
+        EXPECT_EQ(int24Expected, int24Actual) << simd::levelName(table->level);
+        EXPECT_EQ(int24Actual.back(), 0xAB);
+
+        ref.convertInt24ToFloat(int24In.data(), floatExpected.data(), SIZE);
+        table->convertInt24ToFloat(int24In.data(), floatActual.data(), SIZE);
+        EXPECT_EQ(floatExpected, floatActual) << simd::levelName(table->level);
+    }
+}
+
+TEST_F(SIMDDispatchTest, DitheredConversionsFollowTheScalarSequence) {
+    const simd::KernelTable& ref = *simd::scalarKernels();
+
+    for (const auto* table : VectorTables()) {
+        // Same seed, same lane sequence; FMA contraction may move a rounding by one LSB
+        simd::DitherState expectedState(77), actualState(77);
+        std::vector<int16_t> int16Expected(SIZE), int16Actual(SIZE);
+        for (int block = 0; block < 3; ++block) {
+            ref.convertFloatToInt16Dithered(m_a.data(), int16Expected.data(), SIZE, expectedState);
+            table->convertFloatToInt16Dithered(m_a.data(), int16Actual.data(), SIZE, actualState);
+            for (size_t i = 0; i < SIZE; ++i) {
+                ASSERT_NEAR(int16Expected[i], int16Actual[i], 1) << simd::levelName(table->level) << " at " << i;
+            }
+        }
+        EXPECT_TRUE(std::equal(std::begin(expectedState.lanes), std::end(expectedState.lanes), actualState.lanes));
+
+        std::vector<uint8_t> int24Expected(3 * SIZE), int24Actual(3 * SIZE);
+        ref.convertFloatToInt24Dithered(m_b.data(), int24Expected.data(), SIZE, expectedState);
+        table->convertFloatToInt24Dithered(m_b.data(), int24Actual.data(), SIZE, actualState);
+        std::vector<float> floatExpected(SIZE), floatActual(SIZE);
+        ref.convertInt24ToFloat(int24Expected.data(), floatExpected.data(), SIZE);
+        ref.convertInt24ToFloat(int24Actual.data(), floatActual.data(), SIZE);
+        ExpectNear(floatExpected, floatActual, 1.0f / 8388608.0f, "convertFloatToInt24Dithered", table);
+        EXPECT_TRUE(std::equal(std::begin(expectedState.lanes), std::end(expectedState.lanes), actualState.lanes));
+    }
+}
+
+TEST_F(SIMDDispatchTest, DitherIsTriangularWithinOneLSB) {
+    // Silence dithers to -1, 0 or +1 with probabilities 1/8, 3/4, 1/8 and no offset
+    simd::DitherState dither;
+    std::vector<float> silence(4096, 0.0f);
+    std::vector<int16_t> output(silence.size());
+    int counts[3] = {0, 0, 0};
+    for (int block = 0; block < 16; ++block) {
+        simd::convertFloatToInt16Dithered(silence.data(), output.data(), silence.size(), dither);
+        for (int16_t value : output) {
+            ASSERT_GE(value, -1);
+            ASSERT_LE(value, 1);
+            counts[value + 1]++;
+        }
+    }
+    const double total = 16.0 * silence.size();
+    EXPECT_NEAR(counts[0] / total, 0.125, 0.01);
+    EXPECT_NEAR(counts[1] / total, 0.75, 0.01);
+    EXPECT_NEAR(counts[2] / total, 0.125, 0.01);
+
+    // A level between two codes averages out to it instead of truncating
+    std::vector<float> level(4096, 0.25f / 32767.0f);
+    simd::convertFloatToInt16Dithered(level.data(), output.data(), level.size(), dither);
+    double sum = 0.0;
+    for (int16_t value : output) sum += value;
+    EXPECT_NEAR(sum / output.size(), 0.25, 0.03);
+}
+
+TEST_F(SIMDDispatchTest, ConversionsSaturateAndRoundToNearest) {
+    const float input[4] = {1.5f, -1.5f, 1.0f, 0.5f / 32767.0f};
+    int16_t int16Out[4];
+    int32_t int32Out[4];
+
+    simd::convertFloatToInt16(input, int16Out, 4);
+    EXPECT_EQ(int16Out[0], 32767);
+    EXPECT_EQ(int16Out[1], -32768);
+    EXPECT_EQ(int16Out[2], 32767);
+    EXPECT_EQ(int16Out[3], 0);  // Exact half rounds to even
+
+    // Full scale must not wrap to INT32_MIN
+    simd::convertFloatToInt32(input, int32Out, 4);
+    EXPECT_GT(int32Out[0], 2147483000);
+    EXPECT_EQ(int32Out[1], INT32_MIN);
+    EXPECT_GT(int32Out[2], 2147483000);
+
+    // Packed 24-bit is little-endian and sign-extends on the way back
+    uint8_t int24Out[12];
+    float roundTrip[4];
+    simd::convertFloatToInt24(input, int24Out, 4);
+    EXPECT_EQ(int24Out[0], 0xFF);
+    EXPECT_EQ(int24Out[1], 0xFF);
+    EXPECT_EQ(int24Out[2], 0x7F);
+    EXPECT_EQ(int24Out[5], 0x80);
+    simd::convertInt24ToFloat(int24Out, roundTrip, 4);
+    EXPECT_FLOAT_EQ(roundTrip[0], 8388607.0f / 8388608.0f);
+    EXPECT_EQ(roundTrip[1], -1.0f);
+}
+
+TEST_F(SIMDDispatchTest, SingleSampleFadeAppliesStartGain) {
+    float sample = 1.0f;
+    simd::applyGainWithFade(&sample, 1, 0.25f, 1.0f);
+    EXPECT_FLOAT_EQ(sample, 0.25f);
+}
+
+TEST_F(SIMDDispatchTest, ParseLevelAcceptsKnownNames) {
+    simd::Level level = simd::Level::Scalar;
+    bool automatic = false;
+
+    EXPECT_TRUE(simd::parseLevel("AVX2", level, automatic));
+    EXPECT_EQ(level, simd::Level::AVX2);
+    EXPECT_FALSE(automatic);
+
+    EXPECT_TRUE(simd::parseLevel("auto", level, automatic));
+    EXPECT_EQ(level, simd::detectLevel());
+    EXPECT_TRUE(automatic);
+
+    EXPECT_FALSE(simd::parseLevel("neon", level, automatic));
+}
+
+TEST_F(SIMDDispatchTest, InitializeSelectsAndCapsLevel) {
+    EXPECT_EQ(simd::initialize("scalar"), simd::Level::Scalar);
+    EXPECT_EQ(&simd::kernels(), simd::scalarKernels());
+    EXPECT_NE(simd::describeKernels().find("rms=scalar"), std::string::npos);
+
+    // Requests above the CPU are capped, unknown names fall back to auto
+    EXPECT_LE(simd::initialize("avx512"), simd::detectLevel());
+    EXPECT_EQ(simd::initialize("bogus"), simd::initialize("auto"));
+    EXPECT_EQ(simd::kernels().level, simd::initialize("auto"));
+}
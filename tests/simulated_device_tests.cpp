@@ -0,0 +1,187 @@
+// simulated_device_tests.cpp - Virtual-clock device behind the mock backend
+// Schedules are compared callback by callback; only the two pacing tests look at the wall clock
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <vector>
+#include <gtest/gtest.h>
+#include "simulated_device.h"
+
+using namespace vrb;
+
+namespace {
+
+SimulatedDeviceOptions FaultyOptions(uint64_t seed) {
+    SimulatedDeviceOptions options;
+    options.clock = SimulatedClock::Free;
+    options.seed = seed;
+    options.jitterMicros = 500.0;
+    options.lateProbability = 0.01;
+    options.lateMicros = 4000.0;
+    options.dropProbability = 0.005;
+    return options;
+}
+
+struct SimulatedRun {
+    std::vector<SimulatedCallback> callbacks;
+    std::vector<float> input;
+};
+
+SimulatedRun Simulate(const SimulatedDeviceOptions& options, size_t blocks) {
+    SimulatedDevice device;
+    device.Reset(options);
+    SimulatedRun run;
+    std::vector<float> block(options.blockFrames * options.inputChannels);
+    for (size_t i = 0; i < blocks; ++i) {
+        run.callbacks.push_back(device.Next());
+        device.GenerateInput(block.data());
+        run.input.insert(run.input.end(), block.begin(), block.end());
+    }
+    return run;
+}
+
+bool SameSchedule(const SimulatedRun& a, const SimulatedRun& b) {
+    for (size_t i = 0; i < a.callbacks.size(); ++i) {
+        if (a.callbacks[i].lateness != b.callbacks[i].lateness || a.callbacks[i].dropped != b.callbacks[i].dropped) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // anonymous namespace
+
+TEST(SimulatedDeviceTest, SameSeedReplaysTheSameRun) {
+    const SimulatedRun first = Simulate(FaultyOptions(7), 4000);
+    const SimulatedRun second = Simulate(FaultyOptions(7), 4000);
+    EXPECT_TRUE(SameSchedule(first, second));
+    EXPECT_EQ(first.input, second.input);
+
+    const SimulatedRun other = Simulate(FaultyOptions(8), 4000);
+    EXPECT_FALSE(SameSchedule(first, other));
+    EXPECT_NE(first.input, other.input);
+}
+
+TEST(SimulatedDeviceTest, FaultsNeverChangeTheInput) {
+    SimulatedDeviceOptions clean;
+    clean.clock = SimulatedClock::Free;
+    clean.seed = 7;
+    clean.inputChannels = 2;
+    SimulatedDeviceOptions faulty = FaultyOptions(7);
+    faulty.inputChannels = 2;
+
+    const SimulatedRun a = Simulate(clean, 2000);
+    const SimulatedRun b = Simulate(faulty, 2000);
+    EXPECT_EQ(a.input, b.input);
+
+    // The tone is there, over noise well below it
+    float peak = 0.0f;
+    for (float sample : a.input) {
+        peak = std::max(peak, std::abs(sample));
+    }
+    EXPECT_GT(peak, 0.09f);
+    EXPECT_LT(peak, 0.11f);
+}
+
+TEST(SimulatedDeviceTest, ScriptedFaultsLandOnTheirPeriods) {
+    SimulatedDeviceOptions options;
+    options.clock = SimulatedClock::Free;
+    options.maxBlocks = 40;
+    options.faults = {{20, SimulatedFault::Kind::Late, 6000.0}, {10, SimulatedFault::Kind::Drop, 0.0}};
+
+    SimulatedDevice device;
+    device.Reset(options);
+    const auto period = device.GetPeriod();
+    EXPECT_EQ(period, std::chrono::nanoseconds(2666667));
+
+    std::vector<SimulatedCallback> callbacks;
+    while (!device.Finished()) {
+        callbacks.push_back(device.Next());
+    }
+    ASSERT_EQ(callbacks.size(), 40u);
+    EXPECT_EQ(device.GetBlocks(), 40u);
+    EXPECT_EQ(device.GetDroppedBlocks(), 1u);
+    EXPECT_EQ(device.GetLateBlocks(), 2u);
+
+    EXPECT_TRUE(callbacks[10].dropped);
+    EXPECT_EQ(callbacks[20].lateness, std::chrono::microseconds(6000));
+    EXPECT_EQ(callbacks[20].slot, period * 20);
+
+    // The next callback queues up behind the late one; the one after is back on its slot
+    EXPECT_EQ(callbacks[21].slot + callbacks[21].lateness, callbacks[20].slot + callbacks[20].lateness);
+    EXPECT_EQ(callbacks[23].lateness, std::chrono::nanoseconds(0));
+}
+
+TEST(SimulatedDeviceTest, ArrivalsStayInOrderUnderJitter) {
+    const SimulatedRun run = Simulate(FaultyOptions(3), 20000);
+    std::chrono::nanoseconds last{0};
+    size_t late = 0;
+    size_t dropped = 0;
+    for (const auto& callback : run.callbacks) {
+        if (callback.dropped) {
+            ++dropped;
+            continue;
+        }
+        const auto arrival = callback.slot + callback.lateness;
+        ASSERT_GE(arrival, last) << "period " << callback.block;
+        last = arrival;
+        late += callback.lateness >= std::chrono::microseconds(4000) ? 1 : 0;   // Not the ones queued behind
+    }
+
+    // Roughly the configured rates: 1% late and 0.5% dropped of 20000
+    EXPECT_GT(late, 130u);
+    EXPECT_LT(late, 280u);
+    EXPECT_GT(dropped, 50u);
+    EXPECT_LT(dropped, 160u);
+}
+
+TEST(SimulatedDeviceTest, FreeClockOutrunsTheWallClock) {
+    SimulatedDeviceOptions options;
+    options.clock = SimulatedClock::Free;
+    options.maxBlocks = 3750;    // Ten seconds at 128 frames, 48 kHz
+
+    SimulatedDevice device;
+    device.Reset(options);
+    std::vector<float> input(options.blockFrames);
+    const auto start = std::chrono::steady_clock::now();
+    while (!device.Finished()) {
+        const auto callback = device.Next();
+        device.WaitFor(callback);
+        device.GenerateInput(input.data());
+        device.ConsumeOutput(input.data(), input.size());
+    }
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(2));
+}
+
+TEST(SimulatedDeviceTest, RealtimeClockKeepsPace) {
+    SimulatedDeviceOptions options;
+    options.maxBlocks = 20;      // 53 ms
+
+    SimulatedDevice device;
+    device.Reset(options);
+    const auto start = std::chrono::steady_clock::now();
+    while (!device.Finished()) {
+        device.WaitFor(device.Next());
+    }
+    EXPECT_GE(std::chrono::steady_clock::now() - start, device.GetPeriod() * 19);
+}
+
+TEST(SimulatedDeviceTest, ChecksumCoversEverySample) {
+    SimulatedDevice a;
+    SimulatedDevice b;
+    a.Reset(SimulatedDeviceOptions{});
+    b.Reset(SimulatedDeviceOptions{});
+    EXPECT_EQ(a.GetOutputChecksum(), b.GetOutputChecksum());
+
+    std::vector<float> block(256, 0.25f);
+    a.ConsumeOutput(block.data(), block.size());
+    b.ConsumeOutput(block.data(), block.size());
+    EXPECT_EQ(a.GetOutputChecksum(), b.GetOutputChecksum());
+
+    block[100] = 0.2500001f;
+    a.ConsumeOutput(block.data(), block.size());
+    block[100] = 0.25f;
+    b.ConsumeOutput(block.data(), block.size());
+    EXPECT_NE(a.GetOutputChecksum(), b.GetOutputChecksum());
+}
@@ -0,0 +1,247 @@
+// spatial_handoff_tests.cpp - Pose and source handoff to the audio thread
+// Checks the snapshot channel for torn or stale reads, and the HRTF processor under concurrent updates
+
+#define _USE_MATH_DEFINES
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include <json/json.h>
+#include "config.h"
+#include "hrtf_processor.h"
+#include "realtime_check.h"
+#include "snapshot_channel.h"
+#include "vr_types.h"
+
+using namespace vrb;
+
+namespace {
+
+// Fields derived from one counter, so a mix of two publications is detectable
+struct Stamp {
+    uint64_t counter{0};
+    uint64_t doubled{0};
+    uint64_t inverted{~uint64_t(0)};
+    float angle{0.0f};
+};
+
+Stamp MakeStamp(uint64_t counter) {
+    Stamp stamp;
+    stamp.counter = counter;
+    stamp.doubled = counter * 2;
+    stamp.inverted = ~counter;
+    stamp.angle = static_cast<float>(counter % 360);
+    return stamp;
+}
+
+} // namespace
+
+TEST(SnapshotChannelTest, ReportsOnlyNewSnapshots) {
+    SnapshotChannel<Stamp> channel;
+    channel.reset(MakeStamp(0));
+    EXPECT_FALSE(channel.acquire());
+    EXPECT_EQ(channel.front().counter, 0u);
+
+    channel.back() = MakeStamp(1);
+    channel.publish();
+    channel.back() = MakeStamp(2);
+    channel.publish();
+
+    // Only the latest survives; older unread snapshots are dropped
+    EXPECT_TRUE(channel.acquire());
+    EXPECT_EQ(channel.front().counter, 2u);
+    EXPECT_FALSE(channel.acquire());
+    EXPECT_EQ(channel.front().counter, 2u);
+}
+
+TEST(SnapshotChannelTest, ReaderNeverSeesTornOrOlderSnapshots) {
+    constexpr uint64_t PUBLICATIONS = 500000;
+    SnapshotChannel<Stamp> channel;
+    channel.reset(MakeStamp(0));
+
+    std::atomic<bool> done{false};
+    std::thread writer([&] {
+        for (uint64_t i = 1; i <= PUBLICATIONS; ++i) {
+            channel.back() = MakeStamp(i);
+            channel.publish();
+        }
+        done = true;
+    });
+
+    uint64_t last = 0, torn = 0, backwards = 0, reads = 0;
+    while (!done.load()) {
+        channel.acquire();
+        const Stamp& stamp = channel.front();
+        torn += (stamp.doubled != stamp.counter * 2 || stamp.inverted != ~stamp.counter ||
+                 stamp.angle != static_cast<float>(stamp.counter % 360)) ? 1 : 0;
+        backwards += stamp.counter < last ? 1 : 0;
+        last = stamp.counter;
+        ++reads;
+    }
+    writer.join();
+    channel.acquire();
+
+    EXPECT_EQ(torn, 0u);
+    EXPECT_EQ(backwards, 0u);
+    EXPECT_EQ(channel.front().counter, PUBLICATIONS);
+    EXPECT_GT(reads, 0u);
+}
+
+class SpatialHandoffTest : public ::testing::Test {
+protected:
+    void TearDown() override {
+        std::filesystem::remove(m_configPath);
+    }
+
+    std::unique_ptr<HRTFProcessor> CreateProcessor() {
+        Json::Value root;
+        root["hrtf"]["dataPath"] = "";
+        root["hrtf"]["maxSources"] = 8;
+        root["logging"]["level"] = "warn";
+
+        std::ofstream file(m_configPath);
+        Json::StreamWriterBuilder builder;
+        std::unique_ptr<Json::StreamWriter> writer(builder.newStreamWriter());
+        writer->write(root, &file);
+        file.close();
+
+        Config config(m_configPath);
+        auto processor = std::make_unique<HRTFProcessor>();
+        if (!processor->Initialize(config)) {
+            return nullptr;
+        }
+        return processor;
+    }
+
+    static VRPose MakePose(float x, float y, float z) {
+        VRPose pose;
+        pose.position = {x, y, z};
+        pose.orientation = {0.0f, 0.0f, 0.0f, 1.0f};
+        pose.isValid = true;
+        return pose;
+    }
+
+    std::string m_configPath{"spatial_handoff_test.json"};
+};
+
+TEST_F(SpatialHandoffTest, StatsReportOneCompletePose) {
+    auto processor = CreateProcessor();
+    ASSERT_NE(processor, nullptr);
+
+    // Straight right of the head at 2 m: every field comes from the same update
+    processor->UpdateSpatialPosition(MakePose(0.0f, 1.7f, 0.0f), {MakePose(2.0f, 1.7f, 0.0f)});
+    const auto stats = processor->GetStats();
+    EXPECT_NEAR(stats.azimuth, 90.0f, 0.01f);
+    EXPECT_NEAR(stats.elevation, 0.0f, 0.01f);
+    EXPECT_NEAR(stats.distance, 2.0f, 1e-4f);
+    EXPECT_GE(stats.hrtfIndex, 0);
+
+    processor->Reset();
+    EXPECT_EQ(processor->GetStats().distance, 1.0f);
+}
+
+TEST_F(SpatialHandoffTest, AudioThreadRendersThroughConcurrentUpdates) {
+    auto processor = CreateProcessor();
+    ASSERT_NE(processor, nullptr);
+    processor->SetMaxBlockSize(256);
+
+    constexpr size_t FRAMES = 256;
+    std::vector<float> input(FRAMES);
+    std::mt19937 rng(9);
+    std::uniform_real_distribution<float> dist(-0.5f, 0.5f);
+    for (auto& sample : input) {
+        sample = dist(rng);
+    }
+
+    // The tracker churns poses, source positions and the source set while audio runs
+    std::atomic<bool> running{true};
+    std::thread tracker([&] {
+        std::vector<int> ids;
+        for (int update = 0; running.load(); ++update) {
+            const float angle = static_cast<float>(update) * 0.05f;
+            processor->UpdateSpatialPosition(MakePose(0.0f, 1.7f, 0.0f),
+                                             {MakePose(std::sin(angle), 1.5f, -std::cos(angle))});
+            for (int id : ids) {
+                processor->SetSourcePosition(id, Vec3(std::cos(angle), 0.0f, std::sin(angle)));
+            }
+            if (update % 8 == 0) {
+                if (ids.size() < 6) {
+                    const int id = processor->AddSource(Vec3(1.0f, 0.0f, 0.0f));
+                    if (id >= 0) ids.push_back(id);
+                } else {
+                    processor->RemoveSource(ids.front());
+                    ids.erase(ids.begin());
+                }
+            }
+        }
+    });
+
+    std::vector<float> output(FRAMES * 2);
+    std::vector<const float*> sources(processor->GetSourceCapacity(), input.data());
+    bool finite = true;
+    for (int block = 0; block < 600; ++block) {
+        processor->Process(input.data(), output.data(), FRAMES, 1);
+        for (float sample : output) finite = finite && std::isfinite(sample);
+        processor->ProcessSources(sources.data(), output.data(), FRAMES);
+        for (float sample : output) finite = finite && std::isfinite(sample);
+    }
+    running = false;
+    tracker.join();
+
+    EXPECT_TRUE(finite);
+    if (realtime::checksEnabled()) {
+        EXPECT_EQ(realtime::violationCount(), 0u);
+    }
+}
+
+TEST_F(SpatialHandoffTest, AutomationKeepsItsValuesUntilTheControlSideChangesThem) {
+    auto processor = CreateProcessor();
+    ASSERT_NE(processor, nullptr);
+    processor->SetMaxBlockSize(256);
+
+    constexpr size_t FRAMES = 256;
+    const std::vector<float> input(FRAMES, 0.25f);
+    std::vector<float> output(FRAMES * 2);
+    std::vector<const float*> sources(processor->GetSourceCapacity(), nullptr);
+
+    // Peak of the last of a few blocks, once the gain ramps have settled
+    auto settledPeak = [&] {
+        float peak = 0.0f;
+        for (int block = 0; block < 40; ++block) {
+            processor->ProcessSources(sources.data(), output.data(), FRAMES);
+        }
+        for (float sample : output) peak = std::max(peak, std::abs(sample));
+        return peak;
+    };
+
+    const int automated = processor->AddSource(Vec3(1.0f, 0.0f, 0.0f));
+    ASSERT_GE(automated, 0);
+    sources[automated] = input.data();
+    EXPECT_GT(settledPeak(), 0.01f);
+
+    // Applied on the rendering thread, as automation playback does between sub-blocks
+    EXPECT_TRUE(processor->AutomateSourceGain(automated, 0.0f));
+    EXPECT_TRUE(processor->AutomateSourcePosition(automated, Vec3(0.0f, 0.0f, -2.0f)));
+    EXPECT_LT(settledPeak(), 1e-6f);
+
+    // Republishing the table for another source leaves the automated values alone
+    const int other = processor->AddSource(Vec3(-1.0f, 0.0f, 0.0f));
+    ASSERT_GE(other, 0);
+    processor->SetSourcePosition(other, Vec3(0.0f, 1.0f, -1.0f));
+    EXPECT_LT(settledPeak(), 1e-6f);
+
+    // A control-side change of the same value wins again
+    processor->SetSourceGain(automated, 1.0f);
+    EXPECT_GT(settledPeak(), 0.01f);
+
+    EXPECT_FALSE(processor->AutomateSourceGain(static_cast<int>(processor->GetSourceCapacity()), 1.0f));
+    processor->RemoveSource(other);
+    EXPECT_FALSE(processor->AutomateSourceGain(other, 1.0f));
+}
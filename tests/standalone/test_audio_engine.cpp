@@ -78,7 +78,8 @@ int main() {
     std::cout << "  Overruns: " << stats.overruns << "\n";
     std::cout << "  Peak Input Level: " << stats.peakInputLevel << "\n";
     std::cout << "  Peak Output Level: " << stats.peakOutputLevel << "\n";
-    std::cout << "  Callback Duration: " << stats.callbackDuration.count() << "μs\n";
+    std::cout << "  Callback Duration: " << stats.callbackDuration.count() << "μs"
+              << " (p99 " << stats.callbackP99.count() << "μs, max " << stats.callbackMax.count() << "μs)\n";
 
     // Get stream info
     auto streamInfo = audioEngine.GetStreamInfo();
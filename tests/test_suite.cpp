@@ -18,6 +18,7 @@ int main(int argc, char** argv) {
 #include "hrtf_processor.h"
 #include <thread>
 #include <chrono>
+#include <filesystem>
 
 namespace vrb {
 
@@ -101,6 +102,316 @@ TEST_F(AudioEngineTest, ConfigurationUpdate) {
     engine->Stop();
 }
 
+TEST_F(AudioEngineTest, CallbackPercentilesAreOrdered) {
+    ASSERT_TRUE(engine->Initialize(*config, hrtf.get()));
+    ASSERT_TRUE(engine->Start());
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    auto stats = engine->GetStats();
+
+    // While running, the audio thread clears its own histograms at the next callback
+    engine->ResetStats();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    const auto afterReset = engine->GetStats();
+    engine->Stop();
+
+    ASSERT_GT(stats.callbackCount, 0);
+    EXPECT_LT(afterReset.callbackCount, stats.callbackCount);
+    EXPECT_LE(stats.callbackP50.count(), stats.callbackP90.count());
+    EXPECT_LE(stats.callbackP90.count(), stats.callbackP99.count());
+    EXPECT_LE(stats.callbackP99.count(), stats.callbackP999.count());
+    EXPECT_LE(stats.callbackP999.count(), stats.callbackMax.count());
+
+    // Margins run the other way: the rarer the percentile, the less time was left
+    EXPECT_GE(stats.deadlineMarginP50.count(), stats.deadlineMarginP10.count());
+    EXPECT_GE(stats.deadlineMarginP10.count(), stats.deadlineMarginP1.count());
+    EXPECT_GE(stats.deadlineMarginP1.count(), stats.deadlineMarginP01.count());
+    EXPECT_LE(stats.deadlineMisses, stats.callbackCount);
+
+    engine->ResetStats();
+    EXPECT_EQ(engine->GetStats().callbackCount, 0);
+}
+
+TEST_F(AudioEngineTest, WorkerPipelineRendersAhead) {
+    ASSERT_TRUE(engine->Initialize(*config, hrtf.get()));
+    if (!engine->IsMockBackend()) {
+        GTEST_SKIP() << "Needs the mock backend to drive the pipeline deterministically";
+    }
+
+    ASSERT_TRUE(engine->SetPipelineMode(AudioEngine::PipelineMode::Worker, 3));
+    ASSERT_TRUE(engine->Start());
+    EXPECT_FALSE(engine->SetPipelineMode(AudioEngine::PipelineMode::Inline, 1));
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+
+    auto stats = engine->GetStats();
+    EXPECT_EQ(stats.pipelineMode, AudioEngine::PipelineMode::Worker);
+    EXPECT_EQ(stats.lookaheadBlocks, 3);
+    EXPECT_NEAR(stats.pipelineLatency, 3.0 * 128 / 48000, 1e-9);
+    EXPECT_GT(stats.framesProcessed, 0);
+    EXPECT_GT(stats.dspStageDuration.count(), 0.0f);
+    EXPECT_GE(stats.maxDspStageDuration.count(), stats.dspStageDuration.count());
+    EXPECT_GT(stats.peakOutputLevel, 0.0f);
+
+    // Captures are only queued once a rendered block is taken, so the ready audio never exceeds the lookahead
+    EXPECT_LE(stats.pipelineFramesReady, 3 * 128);
+    engine->Stop();
+
+    ASSERT_TRUE(engine->SetPipelineMode(AudioEngine::PipelineMode::Inline, 3));
+    ASSERT_TRUE(engine->Start());
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    stats = engine->GetStats();
+    EXPECT_EQ(stats.lookaheadBlocks, 0);
+    EXPECT_EQ(stats.pipelineLatency, 0.0);
+    EXPECT_EQ(stats.pipelineUnderruns, 0);
+    engine->Stop();
+}
+
+TEST_F(AudioEngineTest, AdaptiveLatencyKeepsTheDeviceBuffer) {
+    ASSERT_TRUE(engine->Initialize(*config, hrtf.get()));
+    if (!engine->IsMockBackend()) {
+        GTEST_SKIP() << "Needs the mock backend to drive the pipeline deterministically";
+    }
+
+    ASSERT_TRUE(engine->SetPipelineMode(AudioEngine::PipelineMode::Worker, 2));
+    ASSERT_TRUE(engine->Start());
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+
+    // The queue ahead of the device carries the latency; the device block never changes
+    auto info = engine->GetStreamInfo();
+    EXPECT_EQ(info.bufferSize, 128);
+    EXPECT_GE(info.targetLatency, 128.0 / 48000);
+    EXPECT_LE(info.targetLatency, 8 * 128.0 / 48000);
+    EXPECT_GT(info.addedLatency, 0.0);
+    EXPECT_NEAR(engine->GetStats().pipelineLatency, info.targetLatency, 1e-9);
+
+    engine->SetAdaptiveBuffering(false);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    info = engine->GetStreamInfo();
+    EXPECT_EQ(info.bufferSize, 128);
+    EXPECT_GT(info.addedLatency, 0.0);
+    engine->Stop();
+
+    EXPECT_EQ(engine->GetStreamInfo().addedLatency, 0.0);
+}
+
+TEST_F(AudioEngineTest, ResamplesBetweenDeviceAndProcessingRates) {
+    ASSERT_TRUE(engine->Initialize(*config, hrtf.get()));
+    if (!engine->IsMockBackend()) {
+        GTEST_SKIP() << "Needs the mock backend's 48 kHz device rate";
+    }
+
+    // 48 kHz device into a 44.1 kHz pipeline, in both pipeline modes
+    ASSERT_TRUE(engine->SetAudioFormat(AudioEngine::AudioFormat::Float32, 44100));
+    ASSERT_TRUE(engine->SetResamplerQuality(ResamplerQuality::Fast));
+    for (auto mode : {AudioEngine::PipelineMode::Inline, AudioEngine::PipelineMode::Worker}) {
+        ASSERT_TRUE(engine->SetPipelineMode(mode, 2));
+        ASSERT_TRUE(engine->Start());
+        EXPECT_FALSE(engine->SetResamplerQuality(ResamplerQuality::High));
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+        const auto stats = engine->GetStats();
+        EXPECT_EQ(stats.processingSampleRate, 44100);
+        EXPECT_GT(stats.resamplerLatency, 0.0);
+        EXPECT_LT(stats.resamplerLatency, 0.002);
+        EXPECT_GT(stats.framesProcessed, 0);
+        EXPECT_GT(stats.peakOutputLevel, 0.0f);
+        EXPECT_EQ(stats.bufferUnderruns, 0);
+        engine->Stop();
+    }
+
+    ASSERT_TRUE(engine->SetAudioFormat(AudioEngine::AudioFormat::Float32, 48000));
+    ASSERT_TRUE(engine->Start());
+    EXPECT_EQ(engine->GetStats().resamplerLatency, 0.0);
+    engine->Stop();
+}
+
+TEST_F(AudioEngineTest, RecordsOutputToDisk) {
+    ASSERT_TRUE(engine->Initialize(*config, hrtf.get()));
+    if (!engine->IsMockBackend()) {
+        GTEST_SKIP() << "Needs the mock backend to produce output without a device";
+    }
+
+    const std::string path = (std::filesystem::temp_directory_path() / "vrb_engine_recording.wav").string();
+    ASSERT_TRUE(engine->Start());
+    ASSERT_TRUE(engine->StartRecording(path));
+    EXPECT_FALSE(engine->StartRecording(path));
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    EXPECT_TRUE(engine->GetStats().recording);
+    ASSERT_TRUE(engine->StopRecording());
+    EXPECT_FALSE(engine->StopRecording());
+    engine->Stop();
+
+    const auto stats = engine->GetRecordingStats();
+    EXPECT_GT(stats.binaural.framesWritten, 0u);
+    EXPECT_EQ(stats.binaural.framesWritten, stats.binaural.framesPushed);
+    EXPECT_EQ(engine->GetStats().recordingOverflowFrames, 0);
+
+    WavReader reader;
+    std::string error;
+    ASSERT_TRUE(reader.Open(path, error)) << error;
+    EXPECT_EQ(reader.GetInfo().frames, stats.binaural.framesWritten);
+    EXPECT_EQ(reader.GetInfo().channels, 2);
+    EXPECT_EQ(reader.GetInfo().sampleRate, 48000);
+    reader.Close();
+
+    // The dry input sits next to it, frame for frame
+    const auto paths = RecordingSession::MakePaths(path);
+    ASSERT_TRUE(stats.dryTrack);
+    ASSERT_TRUE(reader.Open(paths.dry, error)) << error;
+    EXPECT_EQ(reader.GetInfo().frames, stats.binaural.framesWritten);
+    reader.Close();
+    EXPECT_TRUE(std::filesystem::exists(paths.poses));
+    for (const auto& file : {paths.binaural, paths.dry, paths.poses}) {
+        std::filesystem::remove(file);
+    }
+}
+
+TEST_F(AudioEngineTest, RecordsAndPlaysAutomation) {
+    ASSERT_TRUE(engine->Initialize(*config, hrtf.get()));
+    if (!engine->IsMockBackend()) {
+        GTEST_SKIP() << "Needs the mock backend to advance the stream clock without a device";
+    }
+
+    const auto dir = std::filesystem::temp_directory_path() / "vrb_engine_automation";
+    const std::string path = (dir / "take.vrba").string();
+    ASSERT_TRUE(engine->Start());
+    ASSERT_TRUE(engine->StartAutomationRecording(path));
+    EXPECT_TRUE(engine->IsRecordingAutomation());
+
+    // The mic swings from the right of the head to the left
+    VRPose hmd;
+    hmd.position = Vec3(0.0f, 1.6f, 0.0f);
+    hmd.isValid = true;
+    VRPose mic;
+    mic.position = Vec3(1.0f, 1.6f, 0.0f);
+    mic.isValid = true;
+    engine->RecordPose(hmd, {mic});
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    mic.position = Vec3(-1.0f, 1.6f, 0.0f);
+    engine->RecordPose(hmd, {mic});
+    ASSERT_TRUE(engine->StopAutomationRecording());
+
+    AutomationPlayer player;
+    std::string error;
+    ASSERT_TRUE(player.Open(path, error)) << error;
+    ASSERT_EQ(player.GetEventCount(), 2u);
+    EXPECT_GT(player.GetDuration(), 0u);
+    player.Close();
+
+    ASSERT_TRUE(engine->StartAutomationPlayback(path, false));
+    EXPECT_TRUE(engine->IsPlayingAutomation());
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    EXPECT_NEAR(hrtf->GetStats().azimuth, -90.0f, 1.0f);
+    engine->StopAutomationPlayback();
+    EXPECT_FALSE(engine->IsPlayingAutomation());
+    engine->Stop();
+    std::filesystem::remove_all(dir);
+}
+
+TEST_F(AudioEngineTest, JackBackendRendersIntoItsPorts) {
+    ASSERT_TRUE(engine->Initialize(*config, hrtf.get()));
+    if (!engine->IsJackBackend()) {
+        GTEST_SKIP() << "No JACK server running (audio.backend \"auto\" fell back)";
+    }
+
+    // The client is the only device and the pipeline always renders in the process callback
+    const auto devices = engine->GetInputDevices();
+    ASSERT_EQ(devices.size(), 1u);
+    EXPECT_EQ(devices[0].hostAPI, AudioEngine::HostAPI::Jack);
+    EXPECT_FALSE(engine->SetPipelineMode(AudioEngine::PipelineMode::Worker, 2));
+
+    ASSERT_TRUE(engine->Start());
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    const auto stats = engine->GetStats();
+    EXPECT_GT(stats.framesProcessed, 0);
+    EXPECT_GT(stats.callbackCount, 0);
+    EXPECT_EQ(stats.pipelineMode, AudioEngine::PipelineMode::Inline);
+    EXPECT_TRUE(engine->GetStreamInfo().isActive);
+    engine->Stop();
+    EXPECT_FALSE(engine->GetStreamInfo().isActive);
+}
+
+TEST_F(AudioEngineTest, PublishesOutputToSharedMemory) {
+    config->Set("audio.sharedOutput.enabled", true);
+    config->Set("audio.sharedOutput.name", "/vrb_engine_shared_output_test");
+    ASSERT_TRUE(engine->Initialize(*config, hrtf.get()));
+    if (!engine->IsMockBackend()) {
+        GTEST_SKIP() << "Needs the mock backend to produce output without a device";
+    }
+
+    ASSERT_TRUE(engine->Start());
+    ASSERT_TRUE(engine->IsSharedOutputOpen());
+    SharedOutputReader reader;
+    std::string error;
+    ASSERT_TRUE(reader.Attach(engine->GetSharedOutputName(), error)) << error;
+    EXPECT_EQ(reader.GetSampleRate(), 48000);
+    EXPECT_EQ(engine->GetStats().sharedOutputReaders, 1);
+
+    std::vector<float> block(4096 * 2);
+    size_t received = 0;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (received < 4096 && std::chrono::steady_clock::now() < deadline) {
+        reader.Wait(std::chrono::milliseconds(100));
+        received += reader.Read(block.data(), 4096 - received);
+    }
+    EXPECT_GE(received, 4096u);
+    EXPECT_EQ(reader.GetOverrunFrames(), 0u);
+
+    // A restart at the same rate keeps the segment, so attached readers carry on
+    engine->Stop();
+    ASSERT_TRUE(engine->Start());
+    EXPECT_FALSE(reader.IsProducerGone());
+
+    engine->Shutdown();
+    EXPECT_FALSE(engine->IsSharedOutputOpen());
+    EXPECT_TRUE(reader.IsProducerGone());
+}
+
+TEST_F(AudioEngineTest, SimulatedClockReplaysRunsExactly) {
+    config->Set("audio.backend", "simulated");
+
+    // A fresh engine and spatializer per run, so no filter history carries over
+    auto run = [this](AudioEngine::PipelineMode mode, uint64_t seed) {
+        HRTFProcessor processor;
+        processor.Initialize("./test_hrtf_data");
+        AudioEngine simulated;
+        EXPECT_TRUE(simulated.Initialize(*config, &processor));
+        EXPECT_TRUE(simulated.IsMockBackend());
+
+        SimulatedDeviceOptions options;
+        options.clock = SimulatedClock::Free;
+        options.seed = seed;
+        options.jitterMicros = 300.0;
+        options.maxBlocks = 1500;
+        options.faults = {{400, SimulatedFault::Kind::Late, 4000.0}, {900, SimulatedFault::Kind::Drop, 0.0}};
+        EXPECT_TRUE(simulated.SetPipelineMode(mode, 2));
+        EXPECT_TRUE(simulated.SetSimulation(options));
+        EXPECT_TRUE(simulated.Start());
+        EXPECT_FALSE(simulated.SetSimulation(options));
+        EXPECT_TRUE(simulated.WaitForSimulation(std::chrono::seconds(60)));
+
+        const auto stats = simulated.GetStats();
+        const auto simulation = simulated.GetSimulationStats();
+        simulated.Stop();
+
+        // The late callback and the dropped period are the device's xruns; the worker never falls behind
+        EXPECT_EQ(simulation.blocks, 1500u);
+        EXPECT_EQ(simulation.droppedBlocks, 1u);
+        EXPECT_EQ(simulation.lateBlocks, 1u);
+        EXPECT_NEAR(simulation.virtualSeconds, 1500 * 128.0 / 48000, 1e-9);
+        EXPECT_EQ(stats.underruns, 1);
+        EXPECT_EQ(stats.overruns, 1);
+        EXPECT_EQ(stats.pipelineUnderruns, 0);
+        EXPECT_GE(stats.deadlineMisses, 1);
+        return simulation.outputChecksum;
+    };
+
+    for (auto mode : {AudioEngine::PipelineMode::Inline, AudioEngine::PipelineMode::Worker}) {
+        const uint64_t checksum = run(mode, 11);
+        EXPECT_EQ(run(mode, 11), checksum);
+        EXPECT_NE(run(mode, 12), checksum);
+    }
+}
+
 } // namespace vrb
 
 // test_hrtf_processor.cpp - HRTF Processor Tests